@@ -0,0 +1,265 @@
+/*
+    Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+/* Normally provided by the TinyUSB osal.h before the custom OSAL.*/
+#define OSAL_TIMEOUT_NOTIMEOUT     (0)
+#define OSAL_TIMEOUT_NORMAL        (10)
+#define OSAL_TIMEOUT_WAIT_FOREVER  (UINT32_MAX)
+
+/* Returns instead of blocking forever so that a lost wakeup is detected.*/
+#define OSAL_CHIBIOS_QUEUE_TIMEOUT TIME_MS2I(1000)
+
+#include "tusb_os_custom.h"
+
+/*===========================================================================*/
+/* Queue stress test related.                                                */
+/*===========================================================================*/
+
+#define TEST_DURATION_S     10
+
+#define QUEUE_DEPTH         16
+
+/* Largest burst of events posted by the simulated USB interrupt.*/
+#define ISR_BURST_MAX       (QUEUE_DEPTH + 4)
+
+/* Burst of events posted by the thread producer before sleeping.*/
+#define THD_BURST           (QUEUE_DEPTH / 2)
+
+#define PRODUCER_STACK_SIZE 4096
+#define CONSUMER_STACK_SIZE 4096
+
+#define PRODUCER_PRIORITY   (NORMALPRIO + 2)
+#define CONSUMER_PRIORITY   (NORMALPRIO + 1)
+
+#define PRODUCER_ISR        0
+#define PRODUCER_THD        1
+#define NUM_PRODUCERS       2
+
+/* Same size and layout class as dcd_event_t.*/
+typedef struct {
+  uint8_t  rhport;
+  uint8_t  event_id;
+  uint32_t seq;
+  uint32_t check;
+} test_event_t;
+
+typedef struct {
+  uint32_t sent;
+  uint32_t rejected;
+  uint32_t received;
+} producer_stats_t;
+
+OSAL_QUEUE_DEF(0, test_queue_def, QUEUE_DEPTH, test_event_t)
+
+static osal_queue_t test_queue;
+static virtual_timer_t isr_vt;
+
+/* Written by the producers only.*/
+static producer_stats_t stats[NUM_PRODUCERS];
+static uint32_t isr_wakeups;
+
+/* Written by the consumer only.*/
+static uint32_t consumer_batches;
+
+static uint32_t check_value(uint8_t producer, uint32_t seq) {
+
+  return (seq * 2654435761U) ^ producer;
+}
+
+/*
+ * Simulated USB interrupt, posts a random sized burst of events constructed
+ * in place, the consumer is signalled once for the whole burst.
+ */
+static void isr_vt_cb(virtual_timer_t *vtp, void *arg) {
+  unsigned n = (unsigned)(rand() % ISR_BURST_MAX) + 1U;
+  producer_stats_t *sp = &stats[PRODUCER_ISR];
+  bool wakeup = false;
+
+  (void)arg;
+
+  while (n-- > 0U) {
+    test_event_t *ev = osal_queue_send_begin(test_queue);
+
+    if (ev == NULL) {
+      sp->rejected++;
+      continue;
+    }
+    ev->rhport   = PRODUCER_ISR;
+    ev->event_id = 0;
+    ev->seq      = sp->sent;
+    ev->check    = check_value(PRODUCER_ISR, sp->sent);
+    sp->sent++;
+    wakeup |= osal_queue_send_commit(test_queue);
+  }
+
+  chSysLockFromISR();
+  if (wakeup) {
+    chBSemSignalI(&test_queue->sem);
+    isr_wakeups++;
+  }
+  chVTSetI(vtp, TIME_MS2I(1), isr_vt_cb, NULL);
+  chSysUnlockFromISR();
+}
+
+/*
+ * Thread producer, uses the copying send as the TinyUSB class drivers do.
+ */
+static THD_WORKING_AREA(producer_wa, PRODUCER_STACK_SIZE);
+static THD_FUNCTION(producer_thread, arg) {
+  producer_stats_t *sp = &stats[PRODUCER_THD];
+  test_event_t ev;
+  unsigned i;
+
+  (void)arg;
+
+  chRegSetThreadName("producer_thread");
+  for (;;) {
+    for (i = 0; i < THD_BURST; i++) {
+      ev.rhport   = PRODUCER_THD;
+      ev.event_id = 1;
+      ev.seq      = sp->sent;
+      ev.check    = check_value(PRODUCER_THD, sp->sent);
+      if (osal_queue_send(test_queue, &ev, false))
+        sp->sent++;
+      else
+        sp->rejected++;
+    }
+    chThdSleep((rand() % 3) + 1);
+  }
+}
+
+/*
+ * Consumer, checks that the events of each producer arrive complete and in
+ * order. It stalls now and then so that the queue fills up.
+ */
+static THD_WORKING_AREA(consumer_wa, CONSUMER_STACK_SIZE);
+static THD_FUNCTION(consumer_thread, arg) {
+  uint32_t expected[NUM_PRODUCERS] = {0};
+  test_event_t ev;
+
+  (void)arg;
+
+  chRegSetThreadName("consumer_thread");
+  for (;;) {
+    if (osal_queue_empty(test_queue))
+      consumer_batches++;
+
+    if (!osal_queue_receive(test_queue, &ev))
+      chSysHalt("ERROR: consumer timed out, lost wakeup");
+
+    if (ev.rhport >= NUM_PRODUCERS)
+      chSysHalt("ERROR: corrupted event");
+    if (ev.check != check_value(ev.rhport, ev.seq))
+      chSysHalt("ERROR: torn event");
+    if (ev.seq != expected[ev.rhport]) {
+      fprintf(stderr, "producer %u: expected %u, got %u\n",
+              (unsigned)ev.rhport, (unsigned)expected[ev.rhport],
+              (unsigned)ev.seq);
+      chSysHalt("ERROR: event lost or out of order");
+    }
+    expected[ev.rhport]++;
+    stats[ev.rhport].received++;
+
+    if ((rand() % 256) == 0)
+      chThdSleep(2);
+  }
+}
+
+/*===========================================================================*/
+/* Initialization and main thread.                                           */
+/*===========================================================================*/
+
+/*
+ * Simulator main.
+ */
+int main(void) {
+  unsigned s, i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  test_queue = osal_queue_create(&test_queue_def);
+
+  chThdCreateStatic(consumer_wa, sizeof(consumer_wa),
+                    CONSUMER_PRIORITY, consumer_thread, NULL);
+  chThdCreateStatic(producer_wa, sizeof(producer_wa),
+                    PRODUCER_PRIORITY, producer_thread, NULL);
+  chVTSet(&isr_vt, TIME_MS2I(1), isr_vt_cb, NULL);
+
+  /*
+   * Once per second the events sent and not yet received must be exactly
+   * the ones in the queue.
+   */
+  for (s = 1; s <= TEST_DURATION_S; s++) {
+    uint32_t sent = 0, received = 0, queued;
+
+    chThdSleepMilliseconds(1000);
+
+    chSysLock();
+    for (i = 0; i < NUM_PRODUCERS; i++) {
+      sent     += stats[i].sent;
+      received += stats[i].received;
+    }
+    queued = test_queue->wr_idx - test_queue->rd_idx;
+    chSysUnlock();
+
+    if (sent - received != queued)
+      chSysHalt("ERROR: events lost");
+
+    printf("%2us: isr %u/%u rejected %u, thd %u/%u rejected %u, "
+           "batches %u, isr wakeups %u\n", s,
+           (unsigned)stats[PRODUCER_ISR].received,
+           (unsigned)stats[PRODUCER_ISR].sent,
+           (unsigned)stats[PRODUCER_ISR].rejected,
+           (unsigned)stats[PRODUCER_THD].received,
+           (unsigned)stats[PRODUCER_THD].sent,
+           (unsigned)stats[PRODUCER_THD].rejected,
+           (unsigned)consumer_batches, (unsigned)isr_wakeups);
+  }
+
+  chVTReset(&isr_vt);
+  printf("PASSED\n");
+  fflush(stdout);
+  exit(0);
+
+  return 0;
+}
+
+/*
+ * Critical error function.
+ */
+void halt(const char *reason) {
+
+  fflush(stdout);
+  fputs("\n", stdout);
+  fputs(reason, stderr);
+  fflush(stderr);
+  exit(1);
+}
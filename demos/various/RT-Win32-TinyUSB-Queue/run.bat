@@ -0,0 +1,2 @@
+ch.exe
+PAUSE
@@ -0,0 +1,196 @@
+/*
+    Copyright (C) 2015 Andrea Zoppi
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "hal.h"
+#include "tribuf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if (TRIBUF_USE_LOCKFREE != TRUE) || (TRIBUF_USE_WAIT != TRUE)
+#error "this demo requires TRIBUF_USE_LOCKFREE and TRIBUF_USE_WAIT"
+#endif
+
+/*===========================================================================*/
+/* TriBuf related.                                                           */
+/*===========================================================================*/
+
+#define TEST_DURATION_S     10
+
+/* Words per frame, written and checked one at a time.*/
+#define FRAME_WORDS         256
+
+/* Words between two yields of the writer and of the reader.*/
+#define WRITER_CHUNK        16
+#define READER_CHUNK        24
+
+#define WRITER_STACK_SIZE   4096
+#define READER_STACK_SIZE   4096
+
+/* Same priority, the yields interleave the frame copies.*/
+#define WRITER_PRIORITY     (NORMALPRIO + 1)
+#define READER_PRIORITY     (NORMALPRIO + 1)
+
+static tribuf_t tribuf;
+static uint32_t buffers[3][FRAME_WORDS];
+
+/* Written by the writer only.*/
+static uint32_t frames_written;
+
+/* Written by the reader only.*/
+static uint32_t frames_read;
+static uint32_t frames_skipped;
+
+/*
+ * Frame word, depends on the frame sequence number and the word position so
+ * that both a torn frame and a misplaced word are detected.
+ */
+static uint32_t frame_word(uint32_t seq, unsigned i) {
+
+  return (seq * 2654435761U) ^ (uint32_t)i;
+}
+
+/*
+ * Fills the back buffer with a new frame and swaps it, yielding now and then
+ * so that the reader runs in the middle of the frame.
+ */
+static THD_WORKING_AREA(writer_wa, WRITER_STACK_SIZE);
+static THD_FUNCTION(writer_thread, arg) {
+
+  uint32_t *back;
+  uint32_t seq;
+  unsigned i;
+
+  (void)arg;
+
+  chRegSetThreadName("writer_thread");
+  for (seq = 1; ; seq++) {
+    back = (uint32_t *)tribufGetBack(&tribuf);
+    back[0] = seq;
+    for (i = 1; i < FRAME_WORDS; ++i) {
+      back[i] = frame_word(seq, i);
+      if ((i % WRITER_CHUNK) == 0)
+        chThdYield();
+    }
+    tribufSwapBack(&tribuf);
+    frames_written = seq;
+
+    if ((rand() % 64) == 0)
+      chThdSleepMilliseconds(1);
+  }
+}
+
+/*
+ * Waits for the new front buffers and checks them, yielding now and then so
+ * that the writer runs in the middle of the frame.
+ */
+static THD_WORKING_AREA(reader_wa, READER_STACK_SIZE);
+static THD_FUNCTION(reader_thread, arg) {
+
+  const uint32_t *front;
+  uint32_t seq, last = 0;
+  unsigned i;
+
+  (void)arg;
+
+  chRegSetThreadName("reader_thread");
+  for (;;) {
+    if (tribufWaitReadyTimeout(&tribuf, TIME_MS2I(1000)) == MSG_TIMEOUT)
+      chSysHalt("ERROR: reader timed out");
+
+    tribufSwapFront(&tribuf);
+    front = (const uint32_t *)tribufGetFront(&tribuf);
+
+    seq = front[0];
+    if (seq <= last)
+      chSysHalt("ERROR: stale or reordered frame");
+    for (i = 1; i < FRAME_WORDS; ++i) {
+      if (front[i] != frame_word(seq, i)) {
+        fprintf(stderr, "frame %u word %u: 0x%08x\n",
+                (unsigned)seq, i, (unsigned)front[i]);
+        chSysHalt("ERROR: torn frame");
+      }
+      if ((i % READER_CHUNK) == 0)
+        chThdYield();
+    }
+
+    frames_skipped += seq - last - 1U;
+    frames_read++;
+    last = seq;
+  }
+}
+
+/*===========================================================================*/
+/* Initialization and main thread.                                           */
+/*===========================================================================*/
+
+/*
+ * Simulator main.
+ */
+int main(void) {
+
+  unsigned s;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Writer and reader threads started for the lock-free triple buffer test.
+   */
+  tribufObjectInit(&tribuf, buffers[0], buffers[1], buffers[2]);
+
+  chThdCreateStatic(reader_wa, sizeof(reader_wa),
+                    READER_PRIORITY, reader_thread, NULL);
+
+  chThdCreateStatic(writer_wa, sizeof(writer_wa),
+                    WRITER_PRIORITY, writer_thread, NULL);
+
+  /*
+   * Let the threads process data.
+   */
+  for (s = 1; s <= TEST_DURATION_S; s++) {
+    chThdSleepMilliseconds(1000);
+    printf("%2us: written %u, read %u, skipped %u\n", s,
+           (unsigned)frames_written, (unsigned)frames_read,
+           (unsigned)frames_skipped);
+  }
+
+  printf("PASSED\n");
+  fflush(stdout);
+  exit(0);
+
+  return 0;
+}
+
+/*
+ * Critical error function.
+ */
+void halt(const char *reason) {
+
+  fflush(stdout);
+  fputs("\n", stdout);
+  fputs(reason, stderr);
+  fflush(stderr);
+  exit(1);
+}
@@ -34,6 +34,9 @@ endif
 ifneq ($(findstring HAL_USE_CRC TRUE,$(HALCONF)),)
 HALSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/src/hal_crc.c
 endif
+ifneq ($(findstring HAL_USE_DMACH TRUE,$(HALCONF)),)
+HALSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/src/hal_dmach.c
+endif
 ifneq ($(findstring HAL_USE_RNG TRUE,$(HALCONF)),)
 HALSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/src/hal_rng.c
 endif
@@ -58,6 +61,12 @@ endif
 ifneq ($(findstring HAL_USBH_USE_UVC TRUE,$(HALCONF)),)
 HALSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/src/usbh/hal_usbh_uvc.c
 endif
+ifneq ($(findstring HAL_USBH_USE_CDC_ACM TRUE,$(HALCONF)),)
+HALSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/src/usbh/hal_usbh_cdc_acm.c
+endif
+ifneq ($(findstring HAL_USBH_USE_CDC_NCM TRUE,$(HALCONF)),)
+HALSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/src/usbh/hal_usbh_cdc_ncm.c
+endif
 ifneq ($(findstring HAL_USE_EEPROM TRUE,$(HALCONF)),)
 HALSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/src/hal_eeprom.c
 ifneq ($(findstring EEPROM_USE_EE25XX TRUE,$(HALCONF)),)
@@ -79,6 +88,9 @@ endif
 ifneq ($(findstring HAL_USE_USB_MSD TRUE,$(HALCONF)),)
 HALSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/src/hal_usb_msd.c
 endif
+ifneq ($(findstring HAL_USE_USB_UAS TRUE,$(HALCONF)),)
+HALSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/src/hal_usb_uas.c
+endif
 ifneq ($(findstring HAL_USE_COMP TRUE,$(HALCONF)),)
 HALSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/src/hal_comp.c
 endif
@@ -94,6 +106,7 @@ HALSRC_CONTRIB := ${CHIBIOS_CONTRIB}/os/hal/src/hal_community.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_onewire.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_eicu.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_crc.c \
+                  ${CHIBIOS_CONTRIB}/os/hal/src/hal_dmach.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_rng.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_usbh.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/usbh/hal_usbh_debug.c \
@@ -104,6 +117,8 @@ HALSRC_CONTRIB := ${CHIBIOS_CONTRIB}/os/hal/src/hal_community.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/usbh/hal_usbh_aoa.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/usbh/hal_usbh_hid.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/usbh/hal_usbh_uvc.c \
+                  ${CHIBIOS_CONTRIB}/os/hal/src/usbh/hal_usbh_cdc_acm.c \
+                  ${CHIBIOS_CONTRIB}/os/hal/src/usbh/hal_usbh_cdc_ncm.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_ee24xx.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_ee25xx.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_eeprom.c \
@@ -111,6 +126,7 @@ HALSRC_CONTRIB := ${CHIBIOS_CONTRIB}/os/hal/src/hal_community.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_qei.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_usb_hid.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_usb_msd.c \
+                  ${CHIBIOS_CONTRIB}/os/hal/src/hal_usb_uas.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_comp.c \
                   ${CHIBIOS_CONTRIB}/os/hal/src/hal_opamp.c
 endif
@@ -35,6 +35,10 @@
 #define HAL_USE_CRC                         FALSE
 #endif
 
+#if !defined(HAL_USE_DMACH)
+#define HAL_USE_DMACH                       FALSE
+#endif
+
 #if !defined(HAL_USE_EEPROM)
 #define HAL_USE_EEPROM                      FALSE
 #endif
@@ -83,6 +87,10 @@
 #define HAL_USE_USB_MSD                     FALSE
 #endif
 
+#if !defined(HAL_USE_USB_UAS)
+#define HAL_USE_USB_UAS                     FALSE
+#endif
+
 #if !defined(HAL_USE_SDRAM)
 #define HAL_USE_SDRAM                       FALSE
 #endif
@@ -97,6 +105,7 @@
 
 /* Normal drivers.*/
 #include "hal_eicu.h"
+#include "hal_dmach.h"
 #include "hal_rng.h"
 #include "hal_usbh.h"
 #include "hal_timcap.h"
@@ -111,6 +120,7 @@
 #include "hal_eeprom.h"
 #include "hal_usb_hid.h"
 #include "hal_usb_msd.h"
+#include "hal_usb_uas.h"
 #include "hal_nand.h"
 #include "hal_sram.h"
 #include "hal_sdram.h"
@@ -49,6 +49,24 @@
 #define CRC_USE_MUTUAL_EXCLUSION        TRUE
 #endif
 
+/**
+ * @brief   Enables the scatter-gather APIs.
+ * @details A CRC is computed over a list of non-contiguous segments as if
+ *          they were a single buffer, with DMA the segments are chained
+ *          without returning to the caller.
+ */
+#if !defined(CRC_USE_SCATTER_GATHER) || defined(__DOXYGEN__)
+#define CRC_USE_SCATTER_GATHER          FALSE
+#endif
+
+/**
+ * @brief   Enables the throughput statistics.
+ */
+#if !defined(CRC_USE_STATISTICS) || defined(__DOXYGEN__)
+#define CRC_USE_STATISTICS              FALSE
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -72,6 +90,51 @@ typedef enum {
   CRC_COMPLETE               /* Asynchronous operation complete.           */
 } crcstate_t;
 
+/**
+ * @brief   Scatter-gather list segment.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the segment data.
+   */
+  const void                *buf;
+  /**
+   * @brief   Segment size in bytes, must not be zero.
+   */
+  size_t                    n;
+} crcsegment_t;
+
+#if (CRC_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#if (defined(HAL_IMPLEMENTS_COUNTERS) && (HAL_IMPLEMENTS_COUNTERS == TRUE)) || \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Type of a busy time stamp.
+ */
+typedef halrtcnt_t crctime_t;
+#else
+typedef systime_t crctime_t;
+#endif
+
+/**
+ * @brief   CRC unit statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Completed operations.
+   */
+  uint32_t                  operations;
+  /**
+   * @brief   Bytes processed by the completed operations.
+   */
+  uint64_t                  bytes;
+  /**
+   * @brief   Time spent by the completed operations, from their start to
+   *          their completion, in @p crcTimeFrequency() ticks.
+   */
+  uint64_t                  busy;
+} crcstats_t;
+#endif /* CRC_USE_STATISTICS == TRUE */
+
 #if STM32_CRC_USE_CRC1 == TRUE
 #include "hal_crc_lld.h"
 #endif
@@ -84,11 +147,58 @@ typedef enum {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+#if (CRC_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#if (defined(HAL_IMPLEMENTS_COUNTERS) && (HAL_IMPLEMENTS_COUNTERS == TRUE)) || \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Frequency of the busy time ticks.
+ *
+ * @xclass
+ */
+#define crcTimeFrequency() halGetCounterFrequency()
+#define crc_time_now() halGetCounterValue()
+#else
+#define crcTimeFrequency() OSAL_ST_FREQUENCY
+#define crc_time_now() osalOsGetSystemTimeX()
+#endif
+#endif /* CRC_USE_STATISTICS == TRUE */
+
 /**
  * @name    Low level driver helper macros
  * @{
  */
 
+#if (CRC_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Marks the start of an operation.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] n         number of bytes of the operation
+ *
+ * @notapi
+ */
+#define _crc_stats_start(crcp, n) {                                         \
+  (crcp)->size = (n);                                                       \
+  (crcp)->start = crc_time_now();                                           \
+}
+
+/**
+ * @brief   Accounts the completion of the current operation.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+#define _crc_stats_end(crcp) {                                              \
+  (crcp)->stats.operations++;                                               \
+  (crcp)->stats.bytes += (crcp)->size;                                      \
+  (crcp)->stats.busy += (crctime_t)(crc_time_now() - (crcp)->start);        \
+}
+#else
+#define _crc_stats_start(crcp, n)
+#define _crc_stats_end(crcp)
+#endif
+
 /**
  * @brief   Wakes up the waiting thread.
  *
@@ -117,6 +227,7 @@ typedef enum {
  * @notapi
  */
 #define _crc_isr_code(crcp, crc) {                                          \
+  _crc_stats_end(crcp);                                                     \
   if ((crcp)->config->end_cb) {                                             \
     (crcp)->state = CRC_COMPLETE;                                           \
     (crcp)->config->end_cb(crcp, crc);                                      \
@@ -147,6 +258,19 @@ extern "C" {
   void crcStartCalc(CRCDriver *crcp, size_t n, const void *buf);
   void crcStartCalcI(CRCDriver *crcp, size_t n, const void *buf);
 #endif
+#if CRC_USE_SCATTER_GATHER == TRUE
+  uint32_t crcCalcSG(CRCDriver *crcp, const crcsegment_t *segs, size_t nsegs);
+  uint32_t crcCalcSGI(CRCDriver *crcp, const crcsegment_t *segs, size_t nsegs);
+#if CRC_USE_DMA == TRUE
+  void crcStartCalcSG(CRCDriver *crcp, const crcsegment_t *segs, size_t nsegs);
+  void crcStartCalcSGI(CRCDriver *crcp, const crcsegment_t *segs, size_t nsegs);
+#endif
+#endif
+#if CRC_USE_STATISTICS == TRUE
+  void crcGetStats(CRCDriver *crcp, crcstats_t *stats);
+  void crcResetStats(CRCDriver *crcp);
+  uint32_t crcGetBytesPerSecond(CRCDriver *crcp);
+#endif
 #if CRC_USE_MUTUAL_EXCLUSION == TRUE
   void crcAcquireUnit(CRCDriver *crcp);
   void crcReleaseUnit(CRCDriver *crcp);
@@ -0,0 +1,336 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_dmach.h
+ * @brief   DMA channels Driver macros and structures.
+ *
+ * @addtogroup DMACH
+ * @details Portable layer over the DMA helpers of the ports. Channels are
+ *          allocated from a pool, transfers are described by arrays of
+ *          descriptors executed as linked or circular chains, completion
+ *          is reported by callback or by waking a thread.
+ * @{
+ */
+
+#ifndef HAL_DMACH_H
+#define HAL_DMACH_H
+
+#if (HAL_USE_DMACH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Channel identifier to be passed to @p dmachAlloc() for any free
+ *          channel.
+ */
+#define DMACH_ID_ANY                0xFFFFFFFFU
+
+/**
+ * @name    Descriptor mode flags
+ * @{
+ */
+#define DMACH_MODE_WIDTH_MASK       (3U << 0)
+#define DMACH_MODE_WIDTH_8          (0U << 0)   /**< @brief Byte items.     */
+#define DMACH_MODE_WIDTH_16         (1U << 0)   /**< @brief Half-word items.*/
+#define DMACH_MODE_WIDTH_32         (2U << 0)   /**< @brief Word items.     */
+#define DMACH_MODE_SRC_INC          (1U << 2)   /**< @brief Source address
+                                                     incremented.           */
+#define DMACH_MODE_DST_INC          (1U << 3)   /**< @brief Destination
+                                                     address incremented.   */
+#define DMACH_MODE_CB               (1U << 4)   /**< @brief Callback when the
+                                                     descriptor completes.  */
+#define DMACH_MODE_MEMORY           (1U << 5)   /**< @brief Not paced by a
+                                                     peripheral request.    */
+/** @} */
+
+/**
+ * @name    Callback flags
+ * @{
+ */
+#define DMACH_FLAG_DONE             (1U << 0)   /**< @brief A descriptor with
+                                                     @p DMACH_MODE_CB done. */
+#define DMACH_FLAG_END              (1U << 1)   /**< @brief Chain ended.    */
+#define DMACH_FLAG_ERROR            (1U << 2)   /**< @brief Bus error, the
+                                                     channel is stopped.    */
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    DMACH configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the @p dmachWaitCompletion() and @p dmaMemcpy() APIs.
+ */
+#if !defined(DMACH_USE_WAIT) || defined(__DOXYGEN__)
+#define DMACH_USE_WAIT              TRUE
+#endif
+
+/**
+ * @brief   Enables the per-channel transfer statistics.
+ * @note    Busy time is measured with the realtime counter when the port
+ *          implements it, with the system time otherwise.
+ */
+#if !defined(DMACH_USE_STATISTICS) || defined(__DOXYGEN__)
+#define DMACH_USE_STATISTICS        TRUE
+#endif
+
+/**
+ * @brief   Descriptors embedded in each channel for @p dmaMemcpyAsync().
+ * @note    Bounds the largest copy to this value multiplied by the maximum
+ *          items of a descriptor of the port.
+ */
+#if !defined(DMACH_MEMCPY_DESCRIPTORS) || defined(__DOXYGEN__)
+#define DMACH_MEMCPY_DESCRIPTORS    4
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if DMACH_MEMCPY_DESCRIPTORS < 1
+#error "DMACH_MEMCPY_DESCRIPTORS must be at least 1"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Channel state machine possible states.
+ */
+typedef enum {
+  DMACH_UNINIT = 0,                 /**< Not initialized.                   */
+  DMACH_STOP = 1,                   /**< Not allocated.                     */
+  DMACH_READY = 2,                  /**< Allocated, idle.                   */
+  DMACH_ACTIVE = 3                  /**< Chain in progress.                 */
+} dmachstate_t;
+
+/**
+ * @brief   Type of a structure representing a DMA channel.
+ */
+typedef struct DMAChannel DMAChannel;
+
+/**
+ * @brief   Channel callback type.
+ * @note    Invoked from ISR context, the channel is already @p DMACH_READY
+ *          when @p DMACH_FLAG_END or @p DMACH_FLAG_ERROR is reported so a
+ *          new chain can be started from there using @p dmachStartI().
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] flags     @p DMACH_FLAG_DONE, @p DMACH_FLAG_END and
+ *                      @p DMACH_FLAG_ERROR
+ */
+typedef void (*dmachcb_t)(DMAChannel *dchp, uint32_t flags);
+
+#if (DMACH_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#if (defined(HAL_IMPLEMENTS_COUNTERS) && (HAL_IMPLEMENTS_COUNTERS == TRUE)) || \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Type of a busy time stamp.
+ */
+typedef halrtcnt_t dmachtime_t;
+#else
+typedef systime_t dmachtime_t;
+#endif
+
+/**
+ * @brief   Channel statistics.
+ * @note    The bytes of a circular chain are not accounted, its busy time
+ *          is accounted when it is stopped.
+ */
+typedef struct {
+  /**
+   * @brief   Chains ended without errors.
+   */
+  uint32_t                  transfers;
+  /**
+   * @brief   Chains ended on a bus error.
+   */
+  uint32_t                  errors;
+  /**
+   * @brief   Bytes moved by the ended chains.
+   */
+  uint64_t                  bytes;
+  /**
+   * @brief   Time spent active, in @p dmachTimeFrequency() ticks.
+   */
+  uint64_t                  busy;
+} dmachstats_t;
+#endif
+
+#include "hal_dmach_lld.h"
+
+/**
+ * @brief   Structure representing a DMA channel.
+ */
+struct DMAChannel {
+  /**
+   * @brief   Channel state.
+   */
+  volatile dmachstate_t     state;
+  /**
+   * @brief   Callback, can be @p NULL.
+   */
+  dmachcb_t                 callback;
+  /**
+   * @brief   User parameter, see @p dmachGetParam().
+   */
+  void                      *param;
+#if (DMACH_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Waiting thread.
+   */
+  thread_reference_t        thread;
+#endif
+#if (DMACH_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Accumulated statistics.
+   */
+  dmachstats_t              stats;
+  /**
+   * @brief   Start time of the running chain.
+   */
+  dmachtime_t               start;
+  /**
+   * @brief   Bytes of the running chain, zero if circular.
+   */
+  size_t                    size;
+#endif
+  /**
+   * @brief   Destination invalidated from the data cache at the end of a
+   *          @p dmaMemcpyAsync(), @p NULL otherwise.
+   */
+  void                      *invp;
+  /**
+   * @brief   Size of the @p invp buffer.
+   */
+  size_t                    invn;
+  /**
+   * @brief   Descriptors of @p dmaMemcpyAsync().
+   */
+  dmach_desc_t              mcdesc[DMACH_MEMCPY_DESCRIPTORS];
+  /* End of the mandatory fields.*/
+  dmach_lld_channel_fields;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the user parameter of a channel.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @xclass
+ */
+#define dmachGetParam(dchp) ((dchp)->param)
+
+/**
+ * @brief   Checks whether a chain is in progress.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @xclass
+ */
+#define dmachIsActiveX(dchp) ((bool)((dchp)->state == DMACH_ACTIVE))
+
+/**
+ * @brief   Returns the size in bytes of the items of a mode.
+ *
+ * @param[in] mode      descriptor mode flags
+ *
+ * @xclass
+ */
+#define dmachModeWidth(mode) (1U << ((mode) & DMACH_MODE_WIDTH_MASK))
+
+#if (DMACH_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#if (defined(HAL_IMPLEMENTS_COUNTERS) && (HAL_IMPLEMENTS_COUNTERS == TRUE)) || \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Frequency of the busy time ticks.
+ *
+ * @xclass
+ */
+#define dmachTimeFrequency() halGetCounterFrequency()
+#define dmach_time_now() halGetCounterValue()
+#else
+#define dmachTimeFrequency() OSAL_ST_FREQUENCY
+#define dmach_time_now() osalOsGetSystemTimeX()
+#endif
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dmachInit(void);
+  void dmachObjectInit(DMAChannel *dchp);
+  DMAChannel *dmachAllocI(uint32_t id, uint32_t priority,
+                          dmachcb_t callback, void *param);
+  DMAChannel *dmachAlloc(uint32_t id, uint32_t priority,
+                         dmachcb_t callback, void *param);
+  void dmachFreeI(DMAChannel *dchp);
+  void dmachFree(DMAChannel *dchp);
+  void dmachSetTrigger(DMAChannel *dchp, dmachtrigger_t trigger);
+  void dmachDescSetup(dmach_desc_t *descp, void *dst, const void *src,
+                      size_t n, uint32_t mode);
+  void dmachStartI(DMAChannel *dchp, dmach_desc_t *descs, unsigned len,
+                   bool circular);
+  void dmachStart(DMAChannel *dchp, dmach_desc_t *descs, unsigned len,
+                  bool circular);
+  void dmachStopI(DMAChannel *dchp);
+  void dmachStop(DMAChannel *dchp);
+#if DMACH_USE_WAIT == TRUE
+  msg_t dmachWaitCompletion(DMAChannel *dchp, sysinterval_t timeout);
+#endif
+#if DMACH_USE_STATISTICS == TRUE
+  void dmachGetStats(DMAChannel *dchp, dmachstats_t *statsp);
+  void dmachResetStats(DMAChannel *dchp);
+#endif
+  bool dmaMemcpyAsyncI(DMAChannel *dchp, void *dst, const void *src,
+                       size_t n);
+  bool dmaMemcpyAsync(DMAChannel *dchp, void *dst, const void *src,
+                      size_t n);
+#if DMACH_USE_WAIT == TRUE
+  msg_t dmaMemcpy(DMAChannel *dchp, void *dst, const void *src, size_t n);
+#endif
+  void _dmach_isr_code(DMAChannel *dchp, uint32_t flags);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_DMACH == TRUE */
+
+#endif /* HAL_DMACH_H */
+
+/** @} */
@@ -435,6 +435,30 @@
 #if !defined(USB_HID_BUFFERS_NUMBER) || defined(__DOXYGEN__)
 #define USB_HID_BUFFERS_NUMBER      2
 #endif
+
+/**
+ * @brief   Enables the report FIFO mode.
+ * @details Drivers configured with a non-zero @p report_size send fixed
+ *          size reports enqueued by @p hidEnqueueReportX() or
+ *          @p hidEnqueueReportI() instead of the output buffers queue.
+ */
+#if !defined(USB_HID_USE_REPORT_FIFO) || defined(__DOXYGEN__)
+#define USB_HID_USE_REPORT_FIFO     FALSE
+#endif
+
+/**
+ * @brief   Number of reports in the FIFO, must be a power of two.
+ */
+#if !defined(USB_HID_REPORT_FIFO_LENGTH) || defined(__DOXYGEN__)
+#define USB_HID_REPORT_FIFO_LENGTH  16
+#endif
+
+/**
+ * @brief   Maximum size of the reports of the FIFO.
+ */
+#if !defined(USB_HID_REPORT_FIFO_SIZE) || defined(__DOXYGEN__)
+#define USB_HID_REPORT_FIFO_SIZE    64
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -445,6 +469,17 @@
 #error "USB HID Driver requires HAL_USE_USB"
 #endif
 
+#if USB_HID_USE_REPORT_FIFO == TRUE
+#if (USB_HID_REPORT_FIFO_LENGTH < 2) ||                                     \
+    ((USB_HID_REPORT_FIFO_LENGTH & (USB_HID_REPORT_FIFO_LENGTH - 1)) != 0)
+#error "USB_HID_REPORT_FIFO_LENGTH must be a power of two"
+#endif
+
+#if USB_HID_REPORT_FIFO_SIZE < 1
+#error "USB_HID_REPORT_FIFO_SIZE must be at least 1"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -481,8 +516,85 @@ typedef struct {
    * @brief   Interrupt OUT endpoint used for incoming data transfer.
    */
   usbep_t                   int_out;
+#if (USB_HID_USE_REPORT_FIFO == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Size of the reports of the FIFO, zero to use the output
+   *          buffers queue instead.
+   */
+  size_t                    report_size;
+  /**
+   * @brief   Maximum number of reports sent in one transfer, zero means
+   *          one.
+   * @note    Batching only makes sense when @p report_size is the maximum
+   *          packet size of the endpoint, each packet then carries one
+   *          report. High-bandwidth high-speed endpoints move up to three
+   *          packets per microframe.
+   */
+  size_t                    report_batch;
+#endif
 } USBHIDConfig;
 
+#if (USB_HID_USE_REPORT_FIFO == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Report FIFO statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Reports transmitted.
+   */
+  uint32_t                  sent;
+  /**
+   * @brief   Reports dropped because the FIFO was full or the device
+   *          disconnected.
+   */
+  uint32_t                  dropped;
+  /**
+   * @brief   Reports transmitted in the same transfer as a previous one.
+   */
+  uint32_t                  coalesced;
+} hidfifostats_t;
+
+/**
+ * @brief   Report FIFO.
+ * @details Producers reserve slots with an atomic increment of @p head and
+ *          publish them through @p seq, the IN endpoint drains them from
+ *          the callback and releases them by advancing @p tail.
+ */
+typedef struct {
+  /**
+   * @brief   Next slot to be reserved.
+   */
+  volatile uint32_t         head;
+  /**
+   * @brief   Oldest slot not yet released.
+   */
+  volatile uint32_t         tail;
+  /**
+   * @brief   Reports of the transfer in progress.
+   */
+  uint32_t                  inflight;
+  /**
+   * @brief   Per slot publication counters.
+   */
+  volatile uint32_t         seq[USB_HID_REPORT_FIFO_LENGTH];
+  /**
+   * @brief   Statistics.
+   */
+  hidfifostats_t            stats;
+  /**
+   * @brief   Reports, packed so that consecutive slots are contiguous.
+   */
+  uint8_t                   buf[USB_HID_REPORT_FIFO_LENGTH *
+                                USB_HID_REPORT_FIFO_SIZE];
+} hidreportfifo_t;
+
+#define _usb_hid_driver_fifo_data                                           \
+  /* Report FIFO.*/                                                         \
+  hidreportfifo_t           fifo;
+#else
+#define _usb_hid_driver_fifo_data
+#endif
+
 /**
  * @brief   @p USBHIDDriver specific data.
  */
@@ -502,7 +614,8 @@ typedef struct {
                                               USB_HID_BUFFERS_SIZE)];       \
   /* End of the mandatory fields.*/                                         \
   /* Current configuration data.*/                                          \
-  const USBHIDConfig        *config;
+  const USBHIDConfig        *config;                                        \
+  _usb_hid_driver_fifo_data
 
 /**
  * @brief   @p USBHIDDriver specific methods.
@@ -560,6 +673,12 @@ extern "C" {
   size_t hidWriteReportt(USBHIDDriver *uhdp, uint8_t *bp, size_t n, systime_t timeout);
   size_t hidReadReport(USBHIDDriver *uhdp, uint8_t *bp, size_t n);
   size_t hidReadReportt(USBHIDDriver *uhdp, uint8_t *bp, size_t n, systime_t timeout);
+#if USB_HID_USE_REPORT_FIFO == TRUE
+  bool hidEnqueueReportX(USBHIDDriver *uhdp, const uint8_t *report);
+  bool hidEnqueueReportI(USBHIDDriver *uhdp, const uint8_t *report);
+  void hidFlushReportsI(USBHIDDriver *uhdp);
+  void hidGetReportFifoStats(USBHIDDriver *uhdp, hidfifostats_t *statsp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -53,6 +53,33 @@
 #define MSD_THD_PRIO                    NORMALPRIO
 #endif
 
+/**
+ * @brief   Maximum number of logical units.
+ * @details Each logical unit is backed by its own @p BaseBlockDevice, see
+ *          @p msdSetLun().
+ */
+#if !defined(USB_MSD_MAX_LUNS) || defined(__DOXYGEN__)
+#define USB_MSD_MAX_LUNS                1
+#endif
+
+/**
+ * @brief   Enables the per-command latency statistics.
+ * @note    Latency is measured with the realtime counter when the port
+ *          implements it, with the system time otherwise.
+ */
+#if !defined(USB_MSD_USE_STATISTICS) || defined(__DOXYGEN__)
+#define USB_MSD_USE_STATISTICS          FALSE
+#endif
+
+/**
+ * @brief   Number of buckets of the latency histograms.
+ * @details Bucket @p n counts the commands that took less than 2^(n+1)
+ *          ticks, the last bucket counts everything above.
+ */
+#if !defined(USB_MSD_LATENCY_BUCKETS) || defined(__DOXYGEN__)
+#define USB_MSD_LATENCY_BUCKETS         24
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -65,6 +92,14 @@
 #error "Mass storage Driver requires USB_USE_WAIT"
 #endif
 
+#if (USB_MSD_MAX_LUNS < 1) || (USB_MSD_MAX_LUNS > 16)
+#error "USB_MSD_MAX_LUNS must be in the range 1..16"
+#endif
+
+#if (USB_MSD_LATENCY_BUCKETS < 1) || (USB_MSD_LATENCY_BUCKETS > 32)
+#error "USB_MSD_LATENCY_BUCKETS must be in the range 1..32"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -122,6 +157,93 @@ typedef struct {
   usbep_t   ep;
 } usb_scsi_transport_handler_t;
 
+/**
+ * @brief   Logical unit.
+ */
+typedef struct {
+  /**
+   * @brief   SCSI target driver structure.
+   */
+  SCSITarget                    scsi_target;
+  /**
+   * @brief   SCSI target configuration structure, the unit is not
+   *          configured while @p blkdev is @p NULL.
+   */
+  SCSITargetConfig              scsi_config;
+} usb_msd_lun_t;
+
+#if (USB_MSD_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#if (defined(HAL_IMPLEMENTS_COUNTERS) && (HAL_IMPLEMENTS_COUNTERS == TRUE)) || \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Type of a latency time stamp.
+ */
+typedef halrtcnt_t msdtime_t;
+#else
+typedef systime_t msdtime_t;
+#endif
+
+/**
+ * @brief   Command classes of the latency statistics.
+ */
+typedef enum {
+  USB_MSD_CMD_READ = 0,             /**< READ (10).                         */
+  USB_MSD_CMD_WRITE = 1,            /**< WRITE (10).                        */
+  USB_MSD_CMD_OTHER = 2,            /**< Every other command.               */
+  USB_MSD_CMD_CLASSES = 3
+} usbmsdcmdclass_t;
+
+/**
+ * @brief   Latency of a command class.
+ * @details Latency is the time between the CBW reception and the CSW
+ *          submission, data phase included, in @p msdTimeFrequency() ticks.
+ */
+typedef struct {
+  /**
+   * @brief   Commands executed.
+   */
+  uint32_t                      count;
+  /**
+   * @brief   Commands reported as failed in their CSW.
+   */
+  uint32_t                      failed;
+  /**
+   * @brief   Shortest latency.
+   */
+  uint32_t                      min;
+  /**
+   * @brief   Longest latency.
+   */
+  uint32_t                      max;
+  /**
+   * @brief   Accumulated latency.
+   */
+  uint64_t                      total;
+  /**
+   * @brief   Logarithmic latency histogram.
+   */
+  uint32_t                      histogram[USB_MSD_LATENCY_BUCKETS];
+} usb_msd_latency_t;
+
+/**
+ * @brief   Driver statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Latencies by command class.
+   */
+  usb_msd_latency_t             cmd[USB_MSD_CMD_CLASSES];
+  /**
+   * @brief   Invalid or not meaningful CBWs, silently ignored.
+   */
+  uint32_t                      invalid_cbw;
+  /**
+   * @brief   Transfers aborted by a bus reset or a disconnection.
+   */
+  uint32_t                      resets;
+} usb_msd_stats_t;
+#endif
+
 
 /**
  * @brief   Structure representing an USB mass storage driver.
@@ -152,13 +274,14 @@ struct USBMassStorageDriver {
    */
   thread_reference_t            worker;
   /**
-   * @brief   SCSI target driver structure.
+   * @brief   Logical units.
    */
-  SCSITarget                    scsi_target;
+  usb_msd_lun_t                 luns[USB_MSD_MAX_LUNS];
   /**
-   * @brief   SCSI target configuration structure.
+   * @brief   Highest configured logical unit number, answered to the
+   *          Get Max LUN request.
    */
-  SCSITargetConfig              scsi_config;
+  uint8_t                       max_lun;
   /**
    * @brief   SCSI transport structure.
    */
@@ -167,6 +290,12 @@ struct USBMassStorageDriver {
    * @brief   SCSI over USB transport handler structure.
    */
   usb_scsi_transport_handler_t  usb_scsi_transport_handler;
+#if (USB_MSD_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Accumulated statistics.
+   */
+  usb_msd_stats_t               stats;
+#endif
 };
 
 
@@ -174,6 +303,22 @@ struct USBMassStorageDriver {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+#if (USB_MSD_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#if (defined(HAL_IMPLEMENTS_COUNTERS) && (HAL_IMPLEMENTS_COUNTERS == TRUE)) || \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Frequency of the latency ticks.
+ *
+ * @xclass
+ */
+#define msdTimeFrequency() halGetCounterFrequency()
+#define msd_time_now() halGetCounterValue()
+#else
+#define msdTimeFrequency() OSAL_ST_FREQUENCY
+#define msd_time_now() osalOsGetSystemTimeX()
+#endif
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -188,8 +333,16 @@ extern "C" {
                 BaseBlockDevice *blkdev, uint8_t *blkbuf,
                 const scsi_inquiry_response_t *scsi_inquiry_response,
                 const scsi_unit_serial_number_inquiry_response_t *serialInquiry);
+  void msdSetLun(USBMassStorageDriver *msdp, uint8_t lun,
+                 BaseBlockDevice *blkdev, uint8_t *blkbuf,
+                 const scsi_inquiry_response_t *scsi_inquiry_response,
+                 const scsi_unit_serial_number_inquiry_response_t *serialInquiry);
   void msdStop(USBMassStorageDriver *msdp);
   bool msd_request_hook(USBDriver *usbp);
+#if USB_MSD_USE_STATISTICS == TRUE
+  void msdGetStats(USBMassStorageDriver *msdp, usb_msd_stats_t *statsp);
+  void msdResetStats(USBMassStorageDriver *msdp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,339 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_usb_uas.h
+ * @brief   USB Attached SCSI device macros and structures.
+ *
+ * @addtogroup usb_uas
+ * @details USB Attached SCSI (UAS) function driver. Commands are received on
+ *          the command pipe while previous ones are still executing, up to
+ *          @p USB_UAS_MAX_COMMANDS of them are queued and executed by the
+ *          SCSI layer in the order chosen by the driver. Data is moved on
+ *          the data pipes after a READ READY or WRITE READY IU announcing
+ *          the tag of the command, as required on high-speed links without
+ *          bulk streams.
+ * @{
+ */
+
+#ifndef HAL_USB_UAS_H
+#define HAL_USB_UAS_H
+
+#if (HAL_USE_USB_UAS == TRUE) || defined(__DOXYGEN__)
+
+#include "lib_scsi.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Interface and descriptor constants
+ * @{
+ */
+#define USB_UAS_INTERFACE_CLASS         0x08    /**< Mass storage.          */
+#define USB_UAS_INTERFACE_SUBCLASS      0x06    /**< SCSI transparent.      */
+#define USB_UAS_INTERFACE_PROTOCOL      0x62    /**< UAS.                   */
+#define USB_UAS_DESCRIPTOR_PIPE_USAGE   0x24
+#define USB_UAS_PIPE_ID_COMMAND         0x01
+#define USB_UAS_PIPE_ID_STATUS          0x02
+#define USB_UAS_PIPE_ID_DATA_IN         0x03
+#define USB_UAS_PIPE_ID_DATA_OUT        0x04
+/** @} */
+
+/**
+ * @name    Information unit identifiers
+ * @{
+ */
+#define UAS_IU_COMMAND                  0x01
+#define UAS_IU_SENSE                    0x03
+#define UAS_IU_RESPONSE                 0x04
+#define UAS_IU_TASK_MANAGEMENT          0x05
+#define UAS_IU_READ_READY               0x06
+#define UAS_IU_WRITE_READY              0x07
+/** @} */
+
+/**
+ * @brief   Size of the command and task management IUs buffers.
+ * @note    Additional CDB bytes are not supported.
+ */
+#define UAS_IU_SIZE                     32U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the UAS worker thread's stack working area.
+ */
+#if !defined(USB_UAS_THREAD_WA_SIZE) || defined(__DOXYGEN__)
+#define USB_UAS_THREAD_WA_SIZE          384
+#endif
+
+/**
+ * @brief   Priority of the UAS worker thread.
+ */
+#if !defined(USB_UAS_THD_PRIO) || defined(__DOXYGEN__)
+#define USB_UAS_THD_PRIO                NORMALPRIO
+#endif
+
+/**
+ * @brief   Maximum number of logical units.
+ */
+#if !defined(USB_UAS_MAX_LUNS) || defined(__DOXYGEN__)
+#define USB_UAS_MAX_LUNS                1
+#endif
+
+/**
+ * @brief   Depth of the command queue.
+ * @details The command pipe is NAKed while the queue is full.
+ */
+#if !defined(USB_UAS_MAX_COMMANDS) || defined(__DOXYGEN__)
+#define USB_UAS_MAX_COMMANDS            8
+#endif
+
+/**
+ * @brief   Number of times a queued command can be overtaken.
+ * @details Bounds the reordering of the media access commands, a command
+ *          overtaken that many times is executed next.
+ */
+#if !defined(USB_UAS_MAX_BYPASS) || defined(__DOXYGEN__)
+#define USB_UAS_MAX_BYPASS              (2 * USB_UAS_MAX_COMMANDS)
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !HAL_USE_USB
+#error "UAS driver requires HAL_USE_USB"
+#endif
+
+#if !USB_USE_WAIT
+#error "UAS driver requires USB_USE_WAIT"
+#endif
+
+#if (USB_UAS_MAX_LUNS < 1) || (USB_UAS_MAX_LUNS > 32)
+#error "USB_UAS_MAX_LUNS must be in the range 1..32"
+#endif
+
+#if (USB_UAS_MAX_COMMANDS < 1) || (USB_UAS_MAX_COMMANDS > 32)
+#error "USB_UAS_MAX_COMMANDS must be in the range 1..32"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  UAS_UNINIT = 0,                   /**< Not initialized.                   */
+  UAS_STOP = 1,                     /**< Stopped.                           */
+  UAS_READY = 2                     /**< Ready.                             */
+} usbuasstate_t;
+
+/**
+ * @brief   Command slot possible states.
+ */
+typedef enum {
+  UAS_CMD_FREE = 0,                 /**< Unused.                            */
+  UAS_CMD_RECEIVING = 1,            /**< Target of the command pipe.        */
+  UAS_CMD_QUEUED = 2,               /**< Waiting for execution.             */
+  UAS_CMD_RUNNING = 3               /**< Being executed.                    */
+} usbuascmdstate_t;
+
+/**
+ * @brief   Command slot.
+ */
+typedef struct {
+  /**
+   * @brief   Received IU.
+   */
+  uint8_t                       iu[UAS_IU_SIZE];
+  /**
+   * @brief   Slot state.
+   */
+  usbuascmdstate_t              state;
+  /**
+   * @brief   Received IU size.
+   */
+  size_t                        size;
+  /**
+   * @brief   Reception order.
+   */
+  uint32_t                      seq;
+  /**
+   * @brief   Number of times the command was overtaken.
+   */
+  uint32_t                      bypassed;
+  /**
+   * @brief   The READ READY or WRITE READY IU has been sent.
+   */
+  bool                          ready;
+} usb_uas_cmd_t;
+
+/**
+ * @brief   Logical unit.
+ */
+typedef struct {
+  /**
+   * @brief   SCSI target driver structure.
+   */
+  SCSITarget                    scsi_target;
+  /**
+   * @brief   SCSI target configuration structure, the unit is not
+   *          configured while @p blkdev is @p NULL.
+   */
+  SCSITargetConfig              scsi_config;
+  /**
+   * @brief   Block following the last media access, for the scheduling.
+   */
+  uint32_t                      next_lba;
+} usb_uas_lun_t;
+
+/**
+ * @brief   UAS driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   USB driver to use.
+   */
+  USBDriver                     *usbp;
+  /**
+   * @brief   Bulk OUT endpoint of the command pipe.
+   */
+  usbep_t                       cmd_out;
+  /**
+   * @brief   Bulk IN endpoint of the status pipe.
+   */
+  usbep_t                       status_in;
+  /**
+   * @brief   Bulk IN endpoint of the data-in pipe.
+   */
+  usbep_t                       data_in;
+  /**
+   * @brief   Bulk OUT endpoint of the data-out pipe.
+   */
+  usbep_t                       data_out;
+} USBUASConfig;
+
+/**
+ * @brief   Structure representing an USB Attached SCSI driver.
+ */
+typedef struct {
+  /**
+   * @brief   Driver state.
+   */
+  usbuasstate_t                 state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const USBUASConfig            *config;
+  /**
+   * @brief   The USB device is configured.
+   */
+  bool                          configured;
+  /**
+   * @brief   Command slots.
+   */
+  usb_uas_cmd_t                 cmds[USB_UAS_MAX_COMMANDS];
+  /**
+   * @brief   Slot receiving on the command pipe, @p NULL if the pipe is
+   *          idle.
+   */
+  usb_uas_cmd_t                 *receiving;
+  /**
+   * @brief   Command being executed.
+   */
+  usb_uas_cmd_t                 *current;
+  /**
+   * @brief   Sequence number of the next received IU.
+   */
+  uint32_t                      seq;
+  /**
+   * @brief   Logical units.
+   */
+  usb_uas_lun_t                 luns[USB_UAS_MAX_LUNS];
+  /**
+   * @brief   Number of configured logical units.
+   */
+  uint8_t                       num_luns;
+  /**
+   * @brief   SCSI transport structure, shared by the logical units.
+   */
+  SCSITransport                 scsi_transport;
+  /**
+   * @brief   IU sent on the status pipe.
+   */
+  uint8_t                       status_iu[16 + sizeof(scsi_sense_response_t)];
+  /**
+   * @brief   Worker waiting for commands.
+   */
+  thread_reference_t            wait;
+  /**
+   * @brief   Worker thread.
+   */
+  thread_reference_t            worker;
+  /**
+   * @brief   Worker thread working area.
+   */
+  THD_WORKING_AREA(             wa_worker, USB_UAS_THREAD_WA_SIZE);
+} USBUASDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Pipe usage descriptor, follows each endpoint descriptor of the
+ *          UAS alternate setting.
+ *
+ * @param[in] id        @p USB_UAS_PIPE_ID_* value
+ */
+#define USB_UAS_DESC_PIPE_USAGE(id)                                         \
+  USB_DESC_BYTE(4),                                                         \
+  USB_DESC_BYTE(USB_UAS_DESCRIPTOR_PIPE_USAGE),                             \
+  USB_DESC_BYTE(id),                                                        \
+  USB_DESC_BYTE(0)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void uasObjectInit(USBUASDriver *uasp);
+  void uasSetLun(USBUASDriver *uasp, uint8_t lun,
+                 BaseBlockDevice *blkdev, uint8_t *blkbuf,
+                 const scsi_inquiry_response_t *inquiry,
+                 const scsi_unit_serial_number_inquiry_response_t *serialInquiry);
+  void uasStart(USBUASDriver *uasp, const USBUASConfig *config);
+  void uasStop(USBUASDriver *uasp);
+  void uasDisconnectI(USBUASDriver *uasp);
+  void uasConfigureHookI(USBUASDriver *uasp);
+  void uasCommandReceived(USBDriver *usbp, usbep_t ep);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_USB_UAS */
+
+#endif /* HAL_USB_UAS_H */
+
+/** @} */
@@ -48,12 +48,24 @@
 #define HAL_USBH_USE_HID FALSE
 #endif
 
+#ifndef HAL_USBH_USE_CDC_ACM
+#define HAL_USBH_USE_CDC_ACM FALSE
+#endif
+
+#ifndef HAL_USBH_USE_CDC_NCM
+#define HAL_USBH_USE_CDC_NCM FALSE
+#endif
+
 #ifndef HAL_USBH_USE_ADDITIONAL_CLASS_DRIVERS
 #define HAL_USBH_USE_ADDITIONAL_CLASS_DRIVERS	FALSE
 #endif
 
 #ifndef HAL_USBH_USE_IAD
-#define HAL_USBH_USE_IAD     HAL_USBH_USE_UVC
+#define HAL_USBH_USE_IAD     (HAL_USBH_USE_UVC || HAL_USBH_USE_CDC_ACM || HAL_USBH_USE_CDC_NCM)
+#endif
+
+#ifndef HAL_USBH_USE_SERVICE_THREAD
+#define HAL_USBH_USE_SERVICE_THREAD	FALSE
 #endif
 
 #if (HAL_USE_USBH == TRUE) || defined(__DOXYGEN__)
@@ -66,12 +78,136 @@
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if HAL_USBH_USE_SERVICE_THREAD
+/* stack of the service thread; enumeration and the class drivers load()
+ * functions run on it */
+#ifndef HAL_USBH_SERVICE_THREAD_WA_SIZE
+#define HAL_USBH_SERVICE_THREAD_WA_SIZE		1024
+#endif
+
+#ifndef HAL_USBH_SERVICE_THREAD_PRIORITY
+#define HAL_USBH_SERVICE_THREAD_PRIORITY	NORMALPRIO
+#endif
+
+/* fallback polling period of the service thread; all the status changes
+ * are signaled by events so no polling is needed by default */
+#ifndef HAL_USBH_SERVICE_POLL_INTERVAL
+#define HAL_USBH_SERVICE_POLL_INTERVAL		TIME_INFINITE
+#endif
+
+/* usbhStop() joins the service thread */
+#if CH_CFG_USE_WAITEXIT != TRUE
+#error "HAL_USBH_USE_SERVICE_THREAD requires CH_CFG_USE_WAITEXIT"
+#endif
+#endif
+
+#if USBH_DEBUG_ENABLE
+/* binary trace: the debug macros only store the format string pointer, the
+ * time, the frame number and the raw arguments into a lock-free ring; the
+ * debug thread formats the entries or, with USBH_DEBUG_BINARY_RAW, outputs
+ * them unformatted for tools/usbh_trace_decode.py to decode on the host.
+ * Only int/pointer sized arguments are supported and the %s arguments must
+ * point to persistent storage (see _usbh_dbgs for the transient strings) */
+#ifndef USBH_DEBUG_BINARY
+#define USBH_DEBUG_BINARY				FALSE
+#endif
+
+#ifndef USBH_DEBUG_BINARY_RAW
+#define USBH_DEBUG_BINARY_RAW			FALSE
+#endif
+
+/* ring entries, must be a power of 2; the oldest entries are overwritten */
+#ifndef USBH_DEBUG_BINARY_ENTRIES
+#define USBH_DEBUG_BINARY_ENTRIES		128
+#endif
+
+/* arguments stored per entry, the extra ones are dropped */
+#ifndef USBH_DEBUG_BINARY_MAX_ARGS
+#define USBH_DEBUG_BINARY_MAX_ARGS		8
+#endif
+
+/* the producers never wake the debug thread up, it polls the ring with this
+ * period when it finds it empty */
+#ifndef USBH_DEBUG_BINARY_POLL_INTERVAL
+#define USBH_DEBUG_BINARY_POLL_INTERVAL	OSAL_MS2I(10)
+#endif
+
+#if USBH_DEBUG_BINARY
+#if (USBH_DEBUG_BINARY_ENTRIES & (USBH_DEBUG_BINARY_ENTRIES - 1)) != 0
+#error "USBH_DEBUG_BINARY_ENTRIES must be a power of 2"
+#endif
+#if (USBH_DEBUG_BINARY_MAX_ARGS < 1) || (USBH_DEBUG_BINARY_MAX_ARGS > 8)
+#error "USBH_DEBUG_BINARY_MAX_ARGS must be between 1 and 8"
+#endif
+#endif
+#endif
+
+/* Events processed by the main loop */
+#define USBH_EVENT_ROOTHUB		(1 << 0)	/* root hub port status change */
+#define USBH_EVENT_HUB			(1 << 1)	/* hub status change URB */
+#define USBH_EVENT_POLL			(1 << 2)	/* explicit poll request */
+
 #if !HAL_USBH_USE_HUB
 #define USBH_MAX_ADDRESSES				1
 #else
 #define USBH_MAX_ADDRESSES				(HAL_USBHHUB_MAX_PORTS + 1)
 #endif
 
+/* size of the per-device slots of the configuration descriptor arena; the
+ * full configuration descriptor of each device is read into the slot of its
+ * address instead of being allocated from the heap, only a larger one is
+ * allocated from the heap */
+#ifndef HAL_USBH_CFGDESC_SLOT_SIZE
+#if HAL_USBH_USE_UVC
+#define HAL_USBH_CFGDESC_SLOT_SIZE		4096
+#else
+#define HAL_USBH_CFGDESC_SLOT_SIZE		1024
+#endif
+#endif
+
+/* delay between the attempts to read the full configuration descriptor */
+#ifndef HAL_USBH_CFGDESC_RETRY_DELAY
+#define HAL_USBH_CFGDESC_RETRY_DELAY	OSAL_MS2I(20)
+#endif
+
+/* sizes of the per-device tables of pre-parsed interface (alternate settings
+ * included) and endpoint descriptors; for a device exceeding them only the
+ * alternate settings 0 are tabulated, then the exceeding interfaces are left
+ * out */
+#ifndef HAL_USBH_DEVICE_MAX_INTERFACES
+#if HAL_USBH_USE_UVC
+#define HAL_USBH_DEVICE_MAX_INTERFACES	48
+#else
+#define HAL_USBH_DEVICE_MAX_INTERFACES	16
+#endif
+#endif
+
+#ifndef HAL_USBH_DEVICE_MAX_ENDPOINTS
+#if HAL_USBH_USE_UVC
+#define HAL_USBH_DEVICE_MAX_ENDPOINTS	64
+#else
+#define HAL_USBH_DEVICE_MAX_ENDPOINTS	32
+#endif
+#endif
+
+#if HAL_USBH_DEVICE_MAX_INTERFACES > 255
+#error "HAL_USBH_DEVICE_MAX_INTERFACES must not exceed 255"
+#endif
+
+#if HAL_USBH_DEVICE_MAX_ENDPOINTS > 255
+#error "HAL_USBH_DEVICE_MAX_ENDPOINTS must not exceed 255"
+#endif
+
+/* size of the class driver match index, built from the match tables of the
+ * class drivers; a class driver without match table takes one entry */
+#ifndef HAL_USBH_CLASSDRIVER_MATCH_ENTRIES
+#define HAL_USBH_CLASSDRIVER_MATCH_ENTRIES	32
+#endif
+
+#if HAL_USBH_CLASSDRIVER_MATCH_ENTRIES > 255
+#error "HAL_USBH_CLASSDRIVER_MATCH_ENTRIES must not exceed 255"
+#endif
+
 enum usbh_status {
 	USBH_STATUS_STOPPED = 0,
 	USBH_STATUS_STARTED,
@@ -197,6 +333,20 @@ struct usbh_ep {
 	_usbh_ep_ll_data
 };
 
+/* pre-parsed interface descriptor; the offsets are relative to the full
+ * configuration descriptor */
+typedef struct usbh_ifinfo {
+	uint16_t offset;			/* interface descriptor */
+	uint16_t iad_offset;		/* IAD the interface belongs to, 0 if none */
+	uint8_t bInterfaceNumber;
+	uint8_t bAlternateSetting;
+	uint8_t bInterfaceClass;
+	uint8_t bInterfaceSubClass;
+	uint8_t bInterfaceProtocol;
+	uint8_t ep_first;			/* first entry in usbh_device.ep_offsets */
+	uint8_t ep_count;
+} usbh_ifinfo_t;
+
 struct usbh_device {
 	USBHDriver *host;	/* shortcut to host */
 
@@ -213,8 +363,18 @@ struct usbh_device {
 	USBH_DECLARE_STRUCT_MEMBER(usbh_device_descriptor_t devDesc);
 	USBH_DECLARE_STRUCT_MEMBER(usbh_config_descriptor_t basicConfigDesc);
 
+	/* slot of the host's descriptor arena, or heap block if it doesn't fit,
+	 * valid while the device is configured; keepFullCfgDesc is kept for
+	 * compatibility only */
 	uint8_t *fullConfigurationDescriptor;
 	uint8_t keepFullCfgDesc;
+	uint8_t fullCfgDescOnHeap;
+
+	/* interface and endpoint tables of the configuration */
+	usbh_ifinfo_t ifs[HAL_USBH_DEVICE_MAX_INTERFACES];
+	uint16_t ep_offsets[HAL_USBH_DEVICE_MAX_ENDPOINTS];
+	uint8_t num_ifs;
+	uint8_t num_eps;
 
 	uint8_t address;
 	uint8_t bConfiguration;
@@ -255,18 +415,59 @@ struct usbh_dq {
 
 typedef struct usbh_dq usbh_dq_t;
 
+#if USBH_DEBUG_BINARY
+/* entry flags */
+#define USBH_DBG_ENTRY_PUTS		(1 << 0)	/* fmt is printed verbatim */
+#define USBH_DBG_ENTRY_TEXT		(1 << 1)	/* single %s argument copied in text */
+
+typedef struct usbh_dbg_entry {
+	volatile uint32_t seq;	/* slot index + 1 once written, 0 while writing */
+	const char *fmt;
+	systime_t time;
+	uint32_t hfnum;
+	uint16_t hfir;
+	uint8_t nargs;
+	uint8_t flags;
+	union {
+		uint32_t args[USBH_DEBUG_BINARY_MAX_ARGS];
+		char text[USBH_DEBUG_BINARY_MAX_ARGS * 4];
+	} u;
+} usbh_dbg_entry_t;
+#endif
+
 struct usbh_debug_helper {
+#if USBH_DEBUG_BINARY
+	usbh_dbg_entry_t ring[USBH_DEBUG_BINARY_ENTRIES];
+	volatile uint32_t head;		/* next slot to be reserved */
+	uint32_t tail;				/* next slot to be output */
+	uint32_t lost;
+#else
 	uint8_t buff[USBH_DEBUG_BUFFER];
+#endif
 	THD_WORKING_AREA(thd_wa, 512);
+#if !USBH_DEBUG_BINARY
 	usbh_dq_t dq;
+#endif
 	systime_t first;
 	systime_t last;
 	bool ena;
 	bool on;
+#if !USBH_DEBUG_BINARY
 	thread_reference_t tr;
+#endif
 };
 #endif
 
+/* configuration phase of the enumeration: full configuration descriptor read
+ * and parsed, class drivers loaded */
+typedef struct usbh_enum_stats {
+	uint32_t count;
+	sysinterval_t last;
+	sysinterval_t min;
+	sysinterval_t max;
+	sysinterval_t total;
+} usbh_enum_stats_t;
+
 struct USBHDriver {
 	usbh_status_t status;
 	uint8_t address_bitmap[(USBH_MAX_ADDRESSES + 7) / 8];
@@ -277,6 +478,22 @@ struct USBHDriver {
 	struct list_head hubs;
 #endif
 
+	/* hot-plug events */
+	eventflags_t events;
+	systime_t event_time;		/* first ROOTHUB/HUB event not yet processed */
+	systime_t process_time;		/* event time of the running main loop pass */
+	sysinterval_t attach_latency;	/* from status change to drivers loaded */
+	usbh_enum_stats_t enum_stats;
+
+#if HAL_USBH_USE_SERVICE_THREAD
+	thread_reference_t svc_thread;
+	thread_t *svc_tp;		/* NULL while not running */
+	THD_WORKING_AREA(svc_wa, HAL_USBH_SERVICE_THREAD_WA_SIZE);
+#endif
+
+	/* full configuration descriptors, one slot per device address */
+	USBH_DECLARE_STRUCT_MEMBER(uint8_t cfgdesc_arena[USBH_MAX_ADDRESSES][HAL_USBH_CFGDESC_SLOT_SIZE]);
+
 	/* Low level part */
 	_usbhdriver_ll_data
 
@@ -326,6 +543,29 @@ extern "C" {
 		return container_of(dev, usbh_port_t, device);
 	}
 
+	/* Pre-parsed configuration */
+	const usbh_ifinfo_t *usbhDeviceGetInterface(usbh_device_t *dev,
+			uint8_t bInterfaceNumber, uint8_t bAlternateSetting);
+	const usbh_ifinfo_t *usbhDeviceMatchInterface(usbh_device_t *dev,
+			const usbh_ifinfo_t *prev, int16_t _class, int16_t subclass, int16_t protocol);
+	const usbh_ifinfo_t *usbhDeviceInterfaceOf(usbh_device_t *dev,
+			const uint8_t *descriptor);
+	static inline const usbh_interface_descriptor_t *usbhIfDescriptor(
+			const usbh_device_t *dev, const usbh_ifinfo_t *ifi) {
+		return (const usbh_interface_descriptor_t *)
+				(dev->fullConfigurationDescriptor + ifi->offset);
+	}
+	static inline const usbh_endpoint_descriptor_t *usbhIfEndpoint(
+			const usbh_device_t *dev, const usbh_ifinfo_t *ifi, uint8_t i) {
+		osalDbgCheck(i < ifi->ep_count);
+		return (const usbh_endpoint_descriptor_t *)
+				(dev->fullConfigurationDescriptor + dev->ep_offsets[ifi->ep_first + i]);
+	}
+	static inline uint16_t usbhIfRemaining(const usbh_device_t *dev,
+			const usbh_ifinfo_t *ifi) {
+		return dev->basicConfigDesc.wTotalLength - ifi->offset;
+	}
+
 	/* Synchronous API */
 	usbh_urbstatus_t usbhSynchronousTransfer(usbh_ep_t *ep,
 			void *data,
@@ -441,6 +681,14 @@ extern "C" {
 
 	/* Main loop */
 	void usbhMainLoop(USBHDriver *usbh);
+	static inline sysinterval_t usbhGetAttachLatency(USBHDriver *usbh) {
+		return usbh->attach_latency;
+	}
+	static inline void usbhGetEnumerationStats(USBHDriver *usbh, usbh_enum_stats_t *stats) {
+		osalSysLock();
+		*stats = usbh->enum_stats;
+		osalSysUnlock();
+	}
 
 #ifdef __cplusplus
 }
@@ -459,11 +707,66 @@ struct usbh_classdriver_vmt {
 	/* TODO: add power control, suspend, etc */
 };
 
+/* fields compared by a match table entry */
+#define USBH_MATCH_VENDOR		(1 << 0)
+#define USBH_MATCH_PRODUCT		(1 << 1)
+#define USBH_MATCH_CLASS		(1 << 2)
+#define USBH_MATCH_SUBCLASS		(1 << 3)
+#define USBH_MATCH_PROTOCOL		(1 << 4)
+
+/* match table entry; the class, subclass and protocol are taken from the
+ * descriptor offered to the driver (device, IF collection or interface), the
+ * VID and PID from the device descriptor; type 0 matches any descriptor */
+typedef struct usbh_classdriver_match usbh_classdriver_match_t;
+struct usbh_classdriver_match {
+	uint8_t flags;
+	uint8_t type;
+	uint8_t bClass;
+	uint8_t bSubClass;
+	uint8_t bProtocol;
+	uint16_t idVendor;
+	uint16_t idProduct;
+};
+
+/* match table entry initializers, -1 stands for any value */
+#define USBH_MATCH(type, vid, pid, _class, subclass, protocol) {			\
+	(uint8_t)((((vid) >= 0) ? USBH_MATCH_VENDOR : 0)						\
+		| (((pid) >= 0) ? USBH_MATCH_PRODUCT : 0)							\
+		| (((_class) >= 0) ? USBH_MATCH_CLASS : 0)							\
+		| (((subclass) >= 0) ? USBH_MATCH_SUBCLASS : 0)						\
+		| (((protocol) >= 0) ? USBH_MATCH_PROTOCOL : 0)),					\
+	(uint8_t)(((type) >= 0) ? (type) : 0),									\
+	(uint8_t)(_class), (uint8_t)(subclass), (uint8_t)(protocol),			\
+	(uint16_t)(vid), (uint16_t)(pid)										\
+}
+#define USBH_MATCH_INFO(type, _class, subclass, protocol)					\
+	USBH_MATCH(type, -1, -1, _class, subclass, protocol)
+
 struct usbh_classdriverinfo {
 	const char *name;
 	const usbh_classdriver_vmt_t *vmt;
+	/* load() is called only for the descriptors matching one of the entries;
+	 * without match table it is called for every descriptor */
+	const usbh_classdriver_match_t *matches;
+	uint8_t num_matches;
+};
+
+/* node of the list of the dynamically registered class drivers; a node is
+ * registered once, with all the hosts stopped (before usbhStart()) */
+typedef struct usbh_classdriverreg usbh_classdriverreg_t;
+struct usbh_classdriverreg {
+	const usbh_classdriverinfo_t *info;
+	usbh_classdriverreg_t *next;
 };
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+	void usbhRegisterClassDriver(usbh_classdriverreg_t *reg);
+#ifdef __cplusplus
+}
+#endif
+
 #define _usbh_base_classdriver_data		\
 	const usbh_classdriverinfo_t *info;	\
 	usbh_device_t *dev;					\
@@ -32,6 +32,10 @@
 	void usbDbgPrintf(USBHDriver *host, const char *fmt, ...);
 	void usbDbgPuts(USBHDriver *host, const char *s);
 	void usbDbgInit(USBHDriver *host);
+#if USBH_DEBUG_BINARY
+	void usbDbgTrace(USBHDriver *host, const char *fmt, unsigned nargs, ...);
+	void usbDbgTraceString(USBHDriver *host, const char *fmt, const char *s);
+#endif
 #else
 	/* output callback */
 	void USBH_DEBUG_OUTPUT_CALLBACK(const uint8_t *buff, size_t len);
@@ -40,6 +44,10 @@
 	void usbDbgPrintf(const char *fmt, ...);
 	void usbDbgPuts(const char *s);
 	void usbDbgInit(void);
+#if USBH_DEBUG_BINARY
+	void usbDbgTrace(const char *fmt, unsigned nargs, ...);
+	void usbDbgTraceString(const char *fmt, const char *s);
+#endif
 #endif
 
 	void usbDbgReset(void);
@@ -57,15 +65,37 @@
 #	define usbDbgReset() do {} while(0)
 #endif
 
+#if USBH_DEBUG_ENABLE && USBH_DEBUG_BINARY
+/* number of variadic arguments (up to 12), computed at compile time so that
+ * the trace functions don't need to parse the format string */
+#define _USBH_DBG_NARGS(...) _USBH_DBG_NARGS_(0, ##__VA_ARGS__, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define _USBH_DBG_NARGS_(z, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, n, ...) n
+
 #if USBH_DEBUG_MULTI_HOST
 #define _usbh_dbg(host, s) usbDbgPuts(host, s)
+#define _usbh_dbgf(host, f, ...) usbDbgTrace(host, f, _USBH_DBG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define _usbh_dbgs(host, f, s) usbDbgTraceString(host, f, s)
+#define _usbh_ldbg(host, lvl, n, s) do {if (lvl >= n) usbDbgPuts(host, s); } while(0)
+#define _usbh_ldbgf(host, lvl, n, f, ...) do {if (lvl >= n) usbDbgTrace(host, f, _USBH_DBG_NARGS(__VA_ARGS__), ##__VA_ARGS__); } while(0)
+#else
+#define _usbh_dbg(host, s) usbDbgPuts(s)
+#define _usbh_dbgf(host, f, ...) usbDbgTrace(f, _USBH_DBG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define _usbh_dbgs(host, f, s) usbDbgTraceString(f, s)
+#define _usbh_ldbg(host, lvl, n, s) do {if (lvl >= n) usbDbgPuts(s); } while(0)
+#define _usbh_ldbgf(host, lvl, n, f, ...) do {if (lvl >= n) usbDbgTrace(f, _USBH_DBG_NARGS(__VA_ARGS__), ##__VA_ARGS__); } while(0)
+#endif
+
+#elif USBH_DEBUG_MULTI_HOST
+#define _usbh_dbg(host, s) usbDbgPuts(host, s)
 #define _usbh_dbgf(host, f, ...) usbDbgPrintf(host, f, ##__VA_ARGS__)
+#define _usbh_dbgs(host, f, s) usbDbgPrintf(host, f, s)
 #define _usbh_ldbg(host, lvl, n, s) do {if (lvl >= n) usbDbgPuts(host, s); } while(0)
 #define _usbh_ldbgf(host, lvl, n, f, ...) do {if (lvl >= n) usbDbgPrintf(host, f, ##__VA_ARGS__); } while(0)
 #else
 
 #define _usbh_dbg(host, s) usbDbgPuts(s)
 #define _usbh_dbgf(host, f, ...) usbDbgPrintf(f, ##__VA_ARGS__)
+#define _usbh_dbgs(host, f, s) usbDbgPrintf(f, s)
 #define _usbh_ldbg(host, lvl, n, s) do {if (lvl >= n) usbDbgPuts(s); } while(0)
 #define _usbh_ldbgf(host, lvl, n, f, ...) do {if (lvl >= n) usbDbgPrintf(f, ##__VA_ARGS__); } while(0)
 
@@ -24,6 +24,7 @@
 #define _usbh_dbgf_host(f, ...) _usbh_dbgf(host, f, ##__VA_ARGS__)
 #define _usbh_dbgf_port(f, ...) _usbh_dbgf(port->device.host, f, ##__VA_ARGS__)
 #define _usbh_dbgf_dev(f, ...)  _usbh_dbgf(dev->host, f, ##__VA_ARGS__)
+#define _usbh_dbgs_dev(f, s)  _usbh_dbgs(dev->host, f, s)
 #define _usbh_dbgf_ep(f, lvl, ...) _usbh_ldbgf(ep->device->host, ep->trace_level, lvl, "\t%s: " f, ep->name, ##__VA_ARGS__)
 #define _usbh_dbgf_urb(f, lvl, ...) _usbh_ldbgf(urb->ep->device->host, urb->ep->trace_level, lvl, "\t%s: " f, urb->ep->name, ##__VA_ARGS__)
 
@@ -67,6 +68,7 @@
 #define uinfof(f, ...) _usbh_dbgf_host(f, ##__VA_ARGS__)
 #define uportinfof(f, ...) _usbh_dbgf_port(f, ##__VA_ARGS__)
 #define udevinfof(f, ...) _usbh_dbgf_dev(f, ##__VA_ARGS__)
+#define udevinfos(f, s) _usbh_dbgs_dev(f, s)
 #define uepinfof(f, ...) _usbh_dbgf_ep(f, 3, ##__VA_ARGS__)
 #define uurbinfof(f, ...) _usbh_dbgf_urb(f, 3, ##__VA_ARGS__)
 #else
@@ -78,6 +80,7 @@
 #define uinfof(f, ...) _usbh_dbg_dummy
 #define uportinfof(f, ...) _usbh_dbg_dummy
 #define udevinfof(f, ...) _usbh_dbg_dummy
+#define udevinfos(f, s) _usbh_dbg_dummy
 #define uepinfof(f, ...) _usbh_dbg_dummy
 #define uurbinfof(f, ...) _usbh_dbg_dummy
 #endif
@@ -58,6 +58,17 @@ static inline const usbh_endpoint_descriptor_t *ep_get(generic_iterator_t *iep)
 	return (const usbh_endpoint_descriptor_t *)iep->curr;
 }
 
+/* class-specific descriptors of a pre-parsed interface */
+static inline void ifinfo_cs_iter_init(generic_iterator_t *ics,
+		const usbh_device_t *dev, const usbh_ifinfo_t *ifi) {
+	const generic_iterator_t iif = {
+		.curr = (const uint8_t *)usbhIfDescriptor(dev, ifi),
+		.rem = usbhIfRemaining(dev, ifi),
+		.valid = true
+	};
+	cs_iter_init(ics, &iif);
+}
+
 #endif
 
 #endif /* USBH_DESCITER_H_ */
@@ -0,0 +1,82 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+              Copyright (C) 2015..2019 Diego Ismirlian, (dismirlian(at)google's mail)
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef USBH_CDC_H_
+#define USBH_CDC_H_
+
+#include "hal_usbh.h"
+
+#if HAL_USE_USBH && (HAL_USBH_USE_CDC_ACM || HAL_USBH_USE_CDC_NCM)
+
+/*===========================================================================*/
+/* Definitions shared by the CDC class drivers.                              */
+/*===========================================================================*/
+
+/* Interface classes and Communications Class subclasses */
+#define USBH_CDC_CLASS_COMM						0x02
+#define USBH_CDC_CLASS_DATA						0x0A
+#define USBH_CDC_SUBCLASS_ACM					0x02
+#define USBH_CDC_SUBCLASS_NCM					0x0D
+
+/* Functional descriptors */
+#define USBH_CDC_DT_CS_INTERFACE				0x24
+#define USBH_CDC_FD_HEADER						0x00
+#define USBH_CDC_FD_CALL_MANAGEMENT				0x01
+#define USBH_CDC_FD_ACM							0x02
+#define USBH_CDC_FD_UNION						0x06
+#define USBH_CDC_FD_ETHERNET					0x0F
+#define USBH_CDC_FD_NCM							0x1A
+
+/* Class requests */
+#define USBH_CDC_REQ_SET_LINE_CODING			0x20
+#define USBH_CDC_REQ_GET_LINE_CODING			0x21
+#define USBH_CDC_REQ_SET_CONTROL_LINE_STATE		0x22
+#define USBH_CDC_REQ_SEND_BREAK					0x23
+#define USBH_CDC_REQ_SET_ETHERNET_PACKET_FILTER	0x43
+#define USBH_CDC_REQ_GET_NTB_PARAMETERS			0x80
+#define USBH_CDC_REQ_GET_NTB_INPUT_SIZE			0x85
+#define USBH_CDC_REQ_SET_NTB_INPUT_SIZE			0x86
+
+/* Notifications */
+#define USBH_CDC_NOTIFY_NETWORK_CONNECTION		0x00
+#define USBH_CDC_NOTIFY_RESPONSE_AVAILABLE		0x01
+#define USBH_CDC_NOTIFY_SERIAL_STATE			0x20
+#define USBH_CDC_NOTIFY_SPEED_CHANGE			0x2A
+
+/* SET_CONTROL_LINE_STATE bits */
+#define USBH_CDC_CONTROL_LINE_DTR				(1 << 0)
+#define USBH_CDC_CONTROL_LINE_RTS				(1 << 1)
+
+typedef __PACKED_STRUCT {
+	uint8_t bmRequestType;
+	uint8_t bNotification;
+	uint16_t wValue;
+	uint16_t wIndex;
+	uint16_t wLength;
+} usbh_cdc_notification_t;
+
+typedef __PACKED_STRUCT {
+	uint8_t bFunctionLength;
+	uint8_t bDescriptorType;
+	uint8_t bDescriptorSubtype;
+	uint8_t bControlInterface;
+	uint8_t bSubordinateInterface0;
+} usbh_cdc_union_descriptor_t;
+
+#endif
+
+#endif /* USBH_CDC_H_ */
@@ -0,0 +1,206 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+              Copyright (C) 2015..2019 Diego Ismirlian, (dismirlian(at)google's mail)
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef USBH_CDC_ACM_H_
+#define USBH_CDC_ACM_H_
+
+#include "hal_usbh.h"
+
+#if HAL_USE_USBH && HAL_USBH_USE_CDC_ACM
+
+#include "usbh/dev/cdc.h"
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+#ifndef HAL_USBHCDCACM_MAX_INSTANCES
+#define HAL_USBHCDCACM_MAX_INSTANCES		1
+#endif
+
+/* URBs in flight per direction */
+#ifndef HAL_USBHCDCACM_IN_URBS
+#define HAL_USBHCDCACM_IN_URBS				2
+#endif
+
+#ifndef HAL_USBHCDCACM_OUT_URBS
+#define HAL_USBHCDCACM_OUT_URBS				2
+#endif
+
+/* transfer size of each URB, a multiple of the bulk packet size */
+#ifndef HAL_USBHCDCACM_IN_URB_SIZE
+#define HAL_USBHCDCACM_IN_URB_SIZE			512
+#endif
+
+#ifndef HAL_USBHCDCACM_OUT_URB_SIZE
+#define HAL_USBHCDCACM_OUT_URB_SIZE			512
+#endif
+
+/* period after which a partially filled OUT URB is sent */
+#ifndef HAL_USBHCDCACM_FLUSH_INTERVAL
+#define HAL_USBHCDCACM_FLUSH_INTERVAL		OSAL_MS2I(4)
+#endif
+
+#ifndef HAL_USBHCDCACM_DEFAULT_SPEED
+#define HAL_USBHCDCACM_DEFAULT_SPEED		115200
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (HAL_USBHCDCACM_IN_URBS < 1) || (HAL_USBHCDCACM_IN_URBS > 255)
+#error "HAL_USBHCDCACM_IN_URBS must be in the 1..255 range"
+#endif
+
+#if (HAL_USBHCDCACM_OUT_URBS < 1) || (HAL_USBHCDCACM_OUT_URBS > 255)
+#error "HAL_USBHCDCACM_OUT_URBS must be in the 1..255 range"
+#endif
+
+#if (HAL_USBHCDCACM_IN_URB_SIZE < 64) || (HAL_USBHCDCACM_IN_URB_SIZE % 64)
+#error "HAL_USBHCDCACM_IN_URB_SIZE must be a multiple of 64"
+#endif
+
+#if (HAL_USBHCDCACM_OUT_URB_SIZE < 64) || (HAL_USBHCDCACM_OUT_URB_SIZE % 64)
+#error "HAL_USBHCDCACM_OUT_URB_SIZE must be a multiple of 64"
+#endif
+
+#define USBHCDCACM_STOP_BITS_1				0
+#define USBHCDCACM_STOP_BITS_15				1
+#define USBHCDCACM_STOP_BITS_2				2
+
+#define USBHCDCACM_PARITY_NONE				0
+#define USBHCDCACM_PARITY_ODD				1
+#define USBHCDCACM_PARITY_EVEN				2
+#define USBHCDCACM_PARITY_MARK				3
+#define USBHCDCACM_PARITY_SPACE				4
+
+/* SERIAL_STATE notification bits */
+#define USBHCDCACM_SERIAL_STATE_DCD			(1 << 0)
+#define USBHCDCACM_SERIAL_STATE_DSR			(1 << 1)
+#define USBHCDCACM_SERIAL_STATE_BREAK		(1 << 2)
+#define USBHCDCACM_SERIAL_STATE_RING		(1 << 3)
+#define USBHCDCACM_SERIAL_STATE_FRAMING		(1 << 4)
+#define USBHCDCACM_SERIAL_STATE_PARITY		(1 << 5)
+#define USBHCDCACM_SERIAL_STATE_OVERRUN		(1 << 6)
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+	uint32_t speed;
+	uint8_t stop_bits;
+	uint8_t parity;
+	uint8_t data_bits;
+	uint8_t control_lines;		/* USBH_CDC_CONTROL_LINE_DTR / _RTS */
+} USBHCDCACMConfig;
+
+typedef enum {
+	USBHCDCACM_STATE_UNINIT = 0,
+	USBHCDCACM_STATE_STOP = 1,
+	USBHCDCACM_STATE_ACTIVE = 2,
+	USBHCDCACM_STATE_READY = 3
+} usbhcdcacm_state_t;
+
+#define _cdcacm_driver_methods                                           \
+  _base_asynchronous_channel_methods
+
+struct CDCACMDriverVMT {
+	_cdcacm_driver_methods
+};
+
+typedef struct {
+	usbh_urb_t urb;
+	uint32_t counter;		/* received bytes not read yet */
+	uint8_t *ptr;
+	USBH_DECLARE_STRUCT_MEMBER(uint8_t buff[HAL_USBHCDCACM_IN_URB_SIZE]);
+} usbhcdcacm_in_urb_t;
+
+typedef struct {
+	usbh_urb_t urb;
+	uint32_t counter;		/* bytes written */
+	USBH_DECLARE_STRUCT_MEMBER(uint8_t buff[HAL_USBHCDCACM_OUT_URB_SIZE]);
+} usbhcdcacm_out_urb_t;
+
+typedef struct {
+	/* inherited from abstract asyncrhonous channel driver */
+	const struct CDCACMDriverVMT *vmt;
+	_base_asynchronous_channel_data
+
+	/* IN URBs complete in ring order, iq_head is the next one to be read */
+	usbh_ep_t epin;
+	usbhcdcacm_in_urb_t iq[HAL_USBHCDCACM_IN_URBS];
+	threads_queue_t	iq_waiting;
+	uint8_t iq_head;
+
+	/* OUT URBs are submitted in ring order, oq_head is the one being filled */
+	usbh_ep_t epout;
+	usbhcdcacm_out_urb_t oq[HAL_USBHCDCACM_OUT_URBS];
+	threads_queue_t	oq_waiting;
+	uint8_t oq_head;
+	bool oq_filling;
+
+	virtual_timer_t vt;
+} USBHCDCACMChannel;
+
+typedef struct USBHCDCACMDriver {
+	/* inherited from abstract class driver */
+	_usbh_base_classdriver_data
+
+	usbhcdcacm_state_t state;
+
+	uint8_t ifnum;
+
+	/* serial state notifications, optional */
+	usbh_ep_t epint;
+	usbh_urb_t int_urb;
+	USBH_DECLARE_STRUCT_MEMBER(uint8_t int_buff[16]);
+	volatile uint16_t serial_state;
+
+	USBHCDCACMChannel channel;
+
+	mutex_t mtx;
+} USBHCDCACMDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+#define usbhcdcacmGetState(acmp) ((acmp)->state)
+#define usbhcdcacmGetHost(acmp) ((acmp)->dev->host)
+#define usbhcdcacmGetSerialState(acmp) ((acmp)->serial_state)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+extern USBHCDCACMDriver USBHCDCACMD[HAL_USBHCDCACM_MAX_INSTANCES];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/* CDC-ACM driver */
+	void usbhcdcacmStart(USBHCDCACMDriver *acmp, const USBHCDCACMConfig *config);
+	void usbhcdcacmStop(USBHCDCACMDriver *acmp);
+	bool usbhcdcacmSetControlLines(USBHCDCACMDriver *acmp, uint8_t lines);
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
+
+#endif /* USBH_CDC_ACM_H_ */
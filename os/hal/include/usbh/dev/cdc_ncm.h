@@ -0,0 +1,256 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+              Copyright (C) 2015..2019 Diego Ismirlian, (dismirlian(at)google's mail)
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef USBH_CDC_NCM_H_
+#define USBH_CDC_NCM_H_
+
+#include "hal_usbh.h"
+
+#if HAL_USE_USBH && HAL_USBH_USE_CDC_NCM
+
+#include "usbh/dev/cdc.h"
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+#ifndef HAL_USBHCDCNCM_MAX_INSTANCES
+#define HAL_USBHCDCNCM_MAX_INSTANCES		1
+#endif
+
+/* NTBs in flight per direction, each one takes an URB */
+#ifndef HAL_USBHCDCNCM_IN_NTBS
+#define HAL_USBHCDCNCM_IN_NTBS				2
+#endif
+
+#ifndef HAL_USBHCDCNCM_OUT_NTBS
+#define HAL_USBHCDCNCM_OUT_NTBS				2
+#endif
+
+/* NTB sizes; the IN size is requested to the device if it is smaller than
+ * the device's own, the OUT size is capped by the device's */
+#ifndef HAL_USBHCDCNCM_IN_NTB_SIZE
+#define HAL_USBHCDCNCM_IN_NTB_SIZE			2048
+#endif
+
+#ifndef HAL_USBHCDCNCM_OUT_NTB_SIZE
+#define HAL_USBHCDCNCM_OUT_NTB_SIZE			2048
+#endif
+
+/* maximum number of frames packed in an OUT NTB */
+#ifndef HAL_USBHCDCNCM_OUT_MAX_DATAGRAMS
+#define HAL_USBHCDCNCM_OUT_MAX_DATAGRAMS	8
+#endif
+
+/* period after which a partially filled OUT NTB is sent */
+#ifndef HAL_USBHCDCNCM_FLUSH_INTERVAL
+#define HAL_USBHCDCNCM_FLUSH_INTERVAL		OSAL_MS2I(1)
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (HAL_USBHCDCNCM_IN_NTBS < 1) || (HAL_USBHCDCNCM_IN_NTBS > 255)
+#error "HAL_USBHCDCNCM_IN_NTBS must be in the 1..255 range"
+#endif
+
+#if (HAL_USBHCDCNCM_OUT_NTBS < 1) || (HAL_USBHCDCNCM_OUT_NTBS > 255)
+#error "HAL_USBHCDCNCM_OUT_NTBS must be in the 1..255 range"
+#endif
+
+/* NTB16 limits */
+#if (HAL_USBHCDCNCM_IN_NTB_SIZE < 2048) || (HAL_USBHCDCNCM_IN_NTB_SIZE > 65535) \
+		|| (HAL_USBHCDCNCM_IN_NTB_SIZE % 64)
+#error "HAL_USBHCDCNCM_IN_NTB_SIZE must be a multiple of 64 in the 2048..65535 range"
+#endif
+
+#if (HAL_USBHCDCNCM_OUT_NTB_SIZE < 2048) || (HAL_USBHCDCNCM_OUT_NTB_SIZE > 65535)
+#error "HAL_USBHCDCNCM_OUT_NTB_SIZE must be in the 2048..65535 range"
+#endif
+
+#if (HAL_USBHCDCNCM_OUT_MAX_DATAGRAMS < 1) || (HAL_USBHCDCNCM_OUT_MAX_DATAGRAMS > 255)
+#error "HAL_USBHCDCNCM_OUT_MAX_DATAGRAMS must be in the 1..255 range"
+#endif
+
+/* SET_ETHERNET_PACKET_FILTER bits */
+#define USBHCDCNCM_FILTER_PROMISCUOUS		(1 << 0)
+#define USBHCDCNCM_FILTER_ALL_MULTICAST		(1 << 1)
+#define USBHCDCNCM_FILTER_DIRECTED			(1 << 2)
+#define USBHCDCNCM_FILTER_BROADCAST			(1 << 3)
+#define USBHCDCNCM_FILTER_MULTICAST			(1 << 4)
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+typedef __PACKED_STRUCT {
+	uint16_t wLength;
+	uint16_t bmNtbFormatsSupported;
+	uint32_t dwNtbInMaxSize;
+	uint16_t wNdpInDivisor;
+	uint16_t wNdpInPayloadRemainder;
+	uint16_t wNdpInAlignment;
+	uint16_t wReserved;
+	uint32_t dwNtbOutMaxSize;
+	uint16_t wNdpOutDivisor;
+	uint16_t wNdpOutPayloadRemainder;
+	uint16_t wNdpOutAlignment;
+	uint16_t wNtbOutMaxDatagrams;
+} usbh_cdc_ntb_parameters_t;
+
+typedef struct {
+	uint16_t packet_filter;		/* USBHCDCNCM_FILTER_* */
+} USBHCDCNCMConfig;
+
+typedef enum {
+	USBHCDCNCM_STATE_UNINIT = 0,
+	USBHCDCNCM_STATE_STOP = 1,
+	USBHCDCNCM_STATE_ACTIVE = 2,
+	USBHCDCNCM_STATE_READY = 3
+} usbhcdcncm_state_t;
+
+typedef enum {
+	USBHCDCNCM_IN_IDLE = 0,		/* free, to be submitted */
+	USBHCDCNCM_IN_BUSY,			/* submitted */
+	USBHCDCNCM_IN_FULL,			/* holds an NTB being unpacked */
+	USBHCDCNCM_IN_DONE			/* unpacked, frames still held by the user */
+} usbhcdcncm_in_state_t;
+
+typedef struct {
+	usbh_urb_t urb;
+	usbhcdcncm_in_state_t state;
+	uint16_t len;			/* NTB block length, 0 if invalid */
+	uint16_t ndp;			/* offset of the NDP being walked */
+	uint16_t dg;			/* next entry of that NDP */
+	uint8_t pending;		/* receive descriptors not released yet */
+	USBH_DECLARE_STRUCT_MEMBER(uint8_t buff[HAL_USBHCDCNCM_IN_NTB_SIZE]);
+} usbhcdcncm_in_ntb_t;
+
+typedef struct {
+	usbh_urb_t urb;
+	uint16_t counter;		/* end of the last datagram */
+	uint8_t n;				/* datagrams */
+	uint8_t pending;		/* transmit descriptors not released yet */
+	bool closed;			/* no more datagrams, sent when pending is 0 */
+	uint16_t dg[HAL_USBHCDCNCM_OUT_MAX_DATAGRAMS][2];
+	USBH_DECLARE_STRUCT_MEMBER(uint8_t buff[HAL_USBHCDCNCM_OUT_NTB_SIZE]);
+} usbhcdcncm_out_ntb_t;
+
+typedef struct {
+	usbhcdcncm_out_ntb_t *ntb;
+	uint8_t dg;
+	uint8_t *buf;			/* frame storage inside the NTB */
+	size_t size;			/* reserved size */
+} usbhcdcncm_tx_descriptor_t;
+
+typedef struct {
+	usbhcdcncm_in_ntb_t *ntb;
+	const uint8_t *buf;		/* frame inside the NTB */
+	size_t size;
+} usbhcdcncm_rx_descriptor_t;
+
+typedef struct USBHCDCNCMDriver {
+	/* inherited from abstract class driver */
+	_usbh_base_classdriver_data
+
+	usbhcdcncm_state_t state;
+
+	uint8_t ifnum;
+	uint8_t data_ifnum;
+	uint8_t mac_index;
+	uint8_t mac_address[6];
+
+	/* NTB parameters */
+	uint16_t out_max;
+	uint16_t out_divisor;
+	uint16_t out_remainder;
+	uint16_t out_alignment;
+	uint8_t out_max_datagrams;
+	uint16_t seq;
+
+	/* notifications */
+	usbh_ep_t epint;
+	usbh_urb_t int_urb;
+	USBH_DECLARE_STRUCT_MEMBER(uint8_t int_buff[16]);
+	volatile bool link_up;
+	volatile uint32_t downlink_speed;
+	volatile uint32_t uplink_speed;
+
+	/* IN NTBs are unpacked in submission order, iq_head is the one being
+	 * unpacked and iq_tail the next one to be submitted */
+	usbh_ep_t epin;
+	usbhcdcncm_in_ntb_t iq[HAL_USBHCDCNCM_IN_NTBS];
+	threads_queue_t iq_waiting;
+	uint8_t iq_head;
+	uint8_t iq_tail;
+
+	/* OUT NTBs are filled and sent in ring order, oq_head is the one being
+	 * filled */
+	usbh_ep_t epout;
+	usbhcdcncm_out_ntb_t oq[HAL_USBHCDCNCM_OUT_NTBS];
+	threads_queue_t oq_waiting;
+	uint8_t oq_head;
+
+	virtual_timer_t vt;
+
+	mutex_t mtx;
+} USBHCDCNCMDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+#define usbhcdcncmGetState(ncmp) ((ncmp)->state)
+#define usbhcdcncmGetHost(ncmp) ((ncmp)->dev->host)
+#define usbhcdcncmGetLinkStatus(ncmp) ((ncmp)->link_up)
+#define usbhcdcncmGetMACAddress(ncmp) ((const uint8_t *)(ncmp)->mac_address)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+extern USBHCDCNCMDriver USBHCDCNCMD[HAL_USBHCDCNCM_MAX_INSTANCES];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/* CDC-NCM driver */
+	void usbhcdcncmStart(USBHCDCNCMDriver *ncmp, const USBHCDCNCMConfig *config);
+	void usbhcdcncmStop(USBHCDCNCMDriver *ncmp);
+
+	/* zero-copy frame interface */
+	msg_t usbhcdcncmWaitTransmitDescriptor(USBHCDCNCMDriver *ncmp,
+			usbhcdcncm_tx_descriptor_t *tdp, size_t size, systime_t timeout);
+	void usbhcdcncmReleaseTransmitDescriptor(USBHCDCNCMDriver *ncmp,
+			usbhcdcncm_tx_descriptor_t *tdp, size_t len);
+	msg_t usbhcdcncmWaitReceiveDescriptor(USBHCDCNCMDriver *ncmp,
+			usbhcdcncm_rx_descriptor_t *rdp, systime_t timeout);
+	void usbhcdcncmReleaseReceiveDescriptor(USBHCDCNCMDriver *ncmp,
+			usbhcdcncm_rx_descriptor_t *rdp);
+
+	/* copying wrappers */
+	msg_t usbhcdcncmSend(USBHCDCNCMDriver *ncmp, const uint8_t *frame,
+			size_t len, systime_t timeout);
+	msg_t usbhcdcncmReceive(USBHCDCNCMDriver *ncmp, uint8_t *frame,
+			size_t *lenp, systime_t timeout);
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
+
+#endif /* USBH_CDC_NCM_H_ */
@@ -26,9 +26,54 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/* URBs in flight per direction */
+#ifndef HAL_USBHFTDI_IN_URBS
+#define HAL_USBHFTDI_IN_URBS			2
+#endif
+
+#ifndef HAL_USBHFTDI_OUT_URBS
+#define HAL_USBHFTDI_OUT_URBS			2
+#endif
+
+/* transfer size of each URB, a multiple of the bulk packet size (64 bytes
+ * for full speed chips, 512 bytes for high speed chips) */
+#ifndef HAL_USBHFTDI_IN_URB_SIZE
+#define HAL_USBHFTDI_IN_URB_SIZE		512
+#endif
+
+#ifndef HAL_USBHFTDI_OUT_URB_SIZE
+#define HAL_USBHFTDI_OUT_URB_SIZE		512
+#endif
+
+/* chip latency timer in ms, also the period after which partially filled
+ * OUT URBs are sent */
+#ifndef HAL_USBHFTDI_DEFAULT_LATENCY_TIMER
+#define HAL_USBHFTDI_DEFAULT_LATENCY_TIMER	16
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
+#if (HAL_USBHFTDI_IN_URBS < 1) || (HAL_USBHFTDI_IN_URBS > 255)
+#error "HAL_USBHFTDI_IN_URBS must be in the 1..255 range"
+#endif
+
+#if (HAL_USBHFTDI_OUT_URBS < 1) || (HAL_USBHFTDI_OUT_URBS > 255)
+#error "HAL_USBHFTDI_OUT_URBS must be in the 1..255 range"
+#endif
+
+#if (HAL_USBHFTDI_IN_URB_SIZE < 64) || (HAL_USBHFTDI_IN_URB_SIZE % 64)
+#error "HAL_USBHFTDI_IN_URB_SIZE must be a multiple of 64"
+#endif
+
+#if (HAL_USBHFTDI_OUT_URB_SIZE < 64) || (HAL_USBHFTDI_OUT_URB_SIZE % 64)
+#error "HAL_USBHFTDI_OUT_URB_SIZE must be a multiple of 64"
+#endif
+
+#if (HAL_USBHFTDI_DEFAULT_LATENCY_TIMER < 1) || (HAL_USBHFTDI_DEFAULT_LATENCY_TIMER > 255)
+#error "HAL_USBHFTDI_DEFAULT_LATENCY_TIMER must be in the 1..255 range"
+#endif
+
 #define USBHFTDI_FRAMING_DATABITS_7    (0x7 << 0)
 #define USBHFTDI_FRAMING_DATABITS_8    (0x8 << 0)
 #define USBHFTDI_FRAMING_PARITY_NONE   (0x0 << 8)
@@ -57,6 +102,7 @@ typedef struct {
   uint8_t   handshake;
   uint8_t   xon_character;
   uint8_t	xoff_character;
+  uint8_t   latency_timer;	/* ms, 0 for HAL_USBHFTDI_DEFAULT_LATENCY_TIMER */
 } USBHFTDIPortConfig;
 
 typedef enum {
@@ -83,6 +129,19 @@ struct FTDIPortDriverVMT {
 typedef struct USBHFTDIPortDriver USBHFTDIPortDriver;
 typedef struct USBHFTDIDriver USBHFTDIDriver;
 
+typedef struct {
+	usbh_urb_t urb;
+	uint32_t counter;		/* received bytes not read yet */
+	uint8_t *ptr;
+	USBH_DECLARE_STRUCT_MEMBER(uint8_t buff[HAL_USBHFTDI_IN_URB_SIZE]);
+} usbhftdi_in_urb_t;
+
+typedef struct {
+	usbh_urb_t urb;
+	uint32_t counter;		/* bytes written */
+	USBH_DECLARE_STRUCT_MEMBER(uint8_t buff[HAL_USBHFTDI_OUT_URB_SIZE]);
+} usbhftdi_out_urb_t;
+
 struct USBHFTDIPortDriver {
 	/* inherited from abstract asyncrhonous channel driver */
 	const struct FTDIPortDriverVMT *vmt;
@@ -92,22 +151,21 @@ struct USBHFTDIPortDriver {
 
 	usbhftdip_state_t state;
 
+	/* IN URBs complete in ring order, iq_head is the next one to be read */
 	usbh_ep_t epin;
-	usbh_urb_t iq_urb;
+	usbhftdi_in_urb_t iq[HAL_USBHFTDI_IN_URBS];
 	threads_queue_t	iq_waiting;
-	uint32_t iq_counter;
-	USBH_DECLARE_STRUCT_MEMBER(uint8_t iq_buff[64]);
-	uint8_t *iq_ptr;
-
+	uint8_t iq_head;
 
+	/* OUT URBs are submitted in ring order, oq_head is the one being filled */
 	usbh_ep_t epout;
-	usbh_urb_t oq_urb;
+	usbhftdi_out_urb_t oq[HAL_USBHFTDI_OUT_URBS];
 	threads_queue_t	oq_waiting;
-	uint32_t oq_counter;
-	USBH_DECLARE_STRUCT_MEMBER(uint8_t oq_buff[64]);
-	uint8_t *oq_ptr;
+	uint8_t oq_head;
+	bool oq_filling;
 
 	virtual_timer_t vt;
+	sysinterval_t flush_interval;
 	uint8_t ifnum;
 
 	USBHFTDIPortDriver *next;
@@ -41,6 +41,12 @@ extern const usbh_classdriverinfo_t usbhhidClassDriverInfo;
 #if HAL_USBH_USE_UVC
 extern const usbh_classdriverinfo_t usbhuvcClassDriverInfo;
 #endif
+#if HAL_USBH_USE_CDC_ACM
+extern const usbh_classdriverinfo_t usbhcdcacmClassDriverInfo;
+#endif
+#if HAL_USBH_USE_CDC_NCM
+extern const usbh_classdriverinfo_t usbhcdcncmClassDriverInfo;
+#endif
 #if HAL_USBH_USE_HUB
 extern const usbh_classdriverinfo_t usbhhubClassDriverInfo;
 void _usbhub_port_object_init(usbh_port_t *port, USBHDriver *usbh,
@@ -50,6 +56,7 @@ void _usbhub_port_object_init(usbh_port_t *port, USBHDriver *usbh, uint8_t numbe
 #endif
 
 void _usbh_port_disconnected(usbh_port_t *port);
+void _usbh_signal_eventI(USBHDriver *usbh, eventflags_t events);
 void _usbh_urb_completeI(usbh_urb_t *urb, usbh_urbstatus_t status);
 bool _usbh_urb_abortI(usbh_urb_t *urb, usbh_urbstatus_t status);
 void _usbh_urb_abort_and_waitS(usbh_urb_t *urb, usbh_urbstatus_t status);
@@ -101,6 +101,23 @@
 #define MMC_ERR_CSD_OVERWRITE           (1U << 16)
 #define MMC_ERR_AKE_SEQ                 (1U << 3)
 
+/* SD application specific command, pre-erase hint for multi-block writes. */
+#define SD_ACMD_SET_WR_BLK_ERASE_COUNT  23U
+
+/* ADMA2 descriptor attributes, see the SD Host Controller specification. */
+#define ADMA2_ATTR_VALID                (1U << 0)
+#define ADMA2_ATTR_END                  (1U << 1)
+#define ADMA2_ATTR_INT                  (1U << 2)
+#define ADMA2_ATTR_ACT_TRAN             (2U << 4)
+#define ADMA2_ATTR_LENGTH(n)            ((uint32_t)(n) << 16)
+
+/* Biggest word-aligned length a single ADMA2 descriptor can move. */
+#define ADMA2_MAX_LENGTH                0xFFFCU
+
+/* Value of the PROCTL DMAS field selecting each DMA mode. */
+#define SDHC_PROCTL_DMAS_SDMA           (0U << SDHC_PROCTL_DMAS_SHIFT)
+#define SDHC_PROCTL_DMAS_ADMA2          (2U << SDHC_PROCTL_DMAS_SHIFT)
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -124,7 +141,7 @@ SDCDriver SDCD1;
 
 static void recover_after_botched_transfer(SDCDriver *);
 static msg_t wait_interrupt(SDCDriver *, uint32_t);
-static bool sdc_lld_transfer(SDCDriver *, uint32_t, uintptr_t, uint32_t, uint32_t);
+static bool sdc_lld_transfer(SDCDriver *, uint32_t, uint32_t, uint32_t);
 
 /**
  * Compute the SDCLKFS and DVS values for a given SDCLK divisor.
@@ -484,18 +501,133 @@ static void recover_after_botched_transfer(SDCDriver *sdcp) {
   SDHC->SYSCTL |= SDHC_SYSCTL_RSTD;
 }
 
+/**
+ * @brief Set up the simple DMA engine for a contiguous buffer.
+ */
+static void dma_setup_simple(uintptr_t buf) {
+
+  osalDbgCheck((buf & 0x03) == 0);  /* Must be 32-bit aligned */
+
+  SDHC->PROCTL = (SDHC->PROCTL & ~SDHC_PROCTL_DMAS_MASK) | SDHC_PROCTL_DMAS_SDMA;
+
+  /* Store the DMA start address */
+  SDHC->DSADDR = buf;
+}
+
+#if (KINETIS_SDHC_USE_ADMA2 == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief Fill the ADMA2 descriptor table from a scatter/gather list.
+ *
+ * Segments bigger than a single descriptor can move are split over
+ * several descriptors.
+ *
+ * @return            The number of blocks described by the list, zero if
+ *                    the list does not fit the table or is not a whole
+ *                    number of blocks.
+ */
+static uint32_t dma_setup_adma2(SDCDriver *sdcp,
+                                const sdcsgentry_t *sg, uint32_t count) {
+  unsigned i = 0;
+  size_t total = 0;
+
+  while (count-- > 0U) {
+    uintptr_t addr = (uintptr_t)sg->buf;
+    size_t size = sg->size;
+
+    /* ADMA2 moves whole words */
+    osalDbgCheck(((addr & 0x03) == 0) && ((size & 0x03) == 0));
+
+    while (size > 0U) {
+      size_t len = (size > ADMA2_MAX_LENGTH) ? ADMA2_MAX_LENGTH : size;
+
+      if (i >= KINETIS_SDHC_ADMA2_DESCRIPTORS)
+        return 0;
+
+      sdcp->adma2[i].attr = ADMA2_ATTR_LENGTH(len) | ADMA2_ATTR_ACT_TRAN |
+                            ADMA2_ATTR_VALID;
+      sdcp->adma2[i].addr = (uint32_t)addr;
+      i++;
+      addr  += len;
+      size  -= len;
+      total += len;
+    }
+    sg++;
+  }
+
+  if ((i == 0) || ((total % MMCSD_BLOCK_SIZE) != 0))
+    return 0;
+
+  /* The engine stops after the last descriptor */
+  sdcp->adma2[i - 1].attr |= ADMA2_ATTR_END;
+
+  SDHC->PROCTL = (SDHC->PROCTL & ~SDHC_PROCTL_DMAS_MASK) | SDHC_PROCTL_DMAS_ADMA2;
+  SDHC->ADSADDR = (uint32_t)sdcp->adma2;
+
+  return (uint32_t)(total / MMCSD_BLOCK_SIZE);
+}
+#endif /* KINETIS_SDHC_USE_ADMA2 == TRUE */
+
+/**
+ * @brief Set up the DMA engine for a contiguous run of blocks.
+ *
+ * With ADMA2 enabled the run is described by the descriptor table, runs
+ * too long for the table fall back to the simple DMA engine.
+ */
+static void dma_setup_blocks(SDCDriver *sdcp, const uint8_t *buf,
+                             uint32_t n) {
+#if KINETIS_SDHC_USE_ADMA2 == TRUE
+  sdcsgentry_t sg = {(uint8_t *)buf, (size_t)n * MMCSD_BLOCK_SIZE};
+
+  if (dma_setup_adma2(sdcp, &sg, 1U) == n)
+    return;
+#else
+  (void)sdcp;
+  (void)n;
+#endif
+
+  dma_setup_simple((uintptr_t)buf);
+}
+
+/**
+ * @brief Send a pre-erase hint ahead of a multi-block write.
+ *
+ * ACMD23 tells an SD card how many blocks the following CMD25 is going
+ * to write, so that it can erase them in advance. MMC cards do not
+ * implement it and small writes do not benefit from it.
+ */
+static bool send_pre_erase(SDCDriver *sdcp, uint32_t n) {
+  uint32_t resp;
+
+  if ((KINETIS_SDHC_PRE_ERASE_THRESHOLD == 0) ||
+      (n < KINETIS_SDHC_PRE_ERASE_THRESHOLD) ||
+      ((sdcp->cardmode & SDC_MODE_CARDTYPE_MASK) == SDC_MODE_CARDTYPE_MMC))
+    return HAL_SUCCESS;
+
+  if ((sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_APP_CMD,
+                                  sdcp->rca, &resp) != HAL_SUCCESS) ||
+      (sdc_lld_send_cmd_short_crc(sdcp, SD_ACMD_SET_WR_BLK_ERASE_COUNT,
+                                  n, &resp) != HAL_SUCCESS))
+    return HAL_FAILED;
+
+  if (resp & MMCSD_R1_ERROR_MASK) {
+    sdcp->errors |= translate_mmcsd_error(resp);
+    return HAL_FAILED;
+  }
+
+  return HAL_SUCCESS;
+}
+
 /**
  * @brief Perform one data transfer command
  *
  * Sends a command to the card and waits for the corresponding data transfer
- * (either a read or write) to complete.
+ * (either a read or write) to complete. The DMA engine must have been set
+ * up by the caller.
  */
 static bool sdc_lld_transfer(SDCDriver *sdcp, uint32_t startblk,
-			     uintptr_t buf, uint32_t n,
-			     uint32_t cmdx) {
+                             uint32_t n, uint32_t cmdx) {
 
   osalDbgCheck(n > 0);
-  osalDbgCheck((buf & 0x03) == 0);  /* Must be 32-bit aligned */
 
   osalDbgAssert((SDHC->PRSSTAT & (SDHC_PRSSTAT_DLA|SDHC_PRSSTAT_CDIHB|SDHC_PRSSTAT_CIHB)) == 0,
 		"SDHC interface not ready");
@@ -511,9 +643,6 @@ static bool sdc_lld_transfer(SDCDriver *sdcp, uint32_t startblk,
     SDHC->CMDARG = startblk * MMCSD_BLOCK_SIZE;
   }
 
-  /* Store the DMA start address */
-  SDHC->DSADDR = buf;
-
   uint32_t xfer;
   /* For data transfers, we need to set some extra bits in XFERTYP according to the
      transfer we're starting:
@@ -902,7 +1031,9 @@ bool sdc_lld_read(SDCDriver *sdcp, uint32_t startblk,
     SDHC_XFERTYP_CMDINX(MMCSD_CMD_READ_MULTIPLE_BLOCK);
   cmdx |= SDHC_XFERTYP_DTDSEL;
 
-  return sdc_lld_transfer(sdcp, startblk, (uintptr_t)buf, n, cmdx);
+  dma_setup_blocks(sdcp, buf, n);
+
+  return sdc_lld_transfer(sdcp, startblk, n, cmdx);
 }
 
 /**
@@ -925,8 +1056,100 @@ bool sdc_lld_write(SDCDriver *sdcp, uint32_t startblk,
     SDHC_XFERTYP_CMDINX(MMCSD_CMD_WRITE_BLOCK) :
     SDHC_XFERTYP_CMDINX(MMCSD_CMD_WRITE_MULTIPLE_BLOCK);
 
-  return sdc_lld_transfer(sdcp, startblk, (uintptr_t)buf, n, cmdx);
+  if ((n > 1) && (send_pre_erase(sdcp, n) != HAL_SUCCESS))
+    return HAL_FAILED;
+
+  dma_setup_blocks(sdcp, buf, n);
+
+  return sdc_lld_transfer(sdcp, startblk, n, cmdx);
+}
+
+#if (KINETIS_SDHC_USE_ADMA2 == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reads one or more blocks into a scatter/gather list.
+ * @details The blocks are read with a single (multi-block) command, the
+ *          ADMA2 engine distributes them over the list segments.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to read
+ * @param[in] sg        pointer to the scatter/gather list
+ * @param[in] count     number of entries in the list
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool sdc_lld_read_sg(SDCDriver *sdcp, uint32_t startblk,
+                     const sdcsgentry_t *sg, uint32_t count) {
+  uint32_t n;
+  bool status;
+
+  osalDbgCheck((sdcp != NULL) && (sg != NULL) && (count > 0U));
+  osalDbgAssert(sdcp->state == BLK_READY, "invalid state");
+
+  n = dma_setup_adma2(sdcp, sg, count);
+  if ((n == 0U) || ((startblk + n) > sdcp->capacity)) {
+    sdcp->errors |= SDC_OVERFLOW_ERROR;
+    return HAL_FAILED;
+  }
+
+  sdcp->state = BLK_READING;
+  status = sdc_lld_transfer(sdcp, startblk, n,
+                            SDHC_XFERTYP_DTDSEL |
+                            ((n == 1U) ?
+                             SDHC_XFERTYP_CMDINX(MMCSD_CMD_READ_SINGLE_BLOCK) :
+                             SDHC_XFERTYP_CMDINX(MMCSD_CMD_READ_MULTIPLE_BLOCK)));
+  sdcp->state = BLK_READY;
+
+  return status;
+}
+
+/**
+ * @brief   Writes one or more blocks from a scatter/gather list.
+ * @details The blocks are written with a single (multi-block) command,
+ *          the ADMA2 engine gathers them from the list segments.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to write
+ * @param[in] sg        pointer to the scatter/gather list
+ * @param[in] count     number of entries in the list
+ *
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  operation succeeded.
+ * @retval HAL_FAILED   operation failed.
+ *
+ * @api
+ */
+bool sdc_lld_write_sg(SDCDriver *sdcp, uint32_t startblk,
+                      const sdcsgentry_t *sg, uint32_t count) {
+  uint32_t n;
+  bool status;
+
+  osalDbgCheck((sdcp != NULL) && (sg != NULL) && (count > 0U));
+  osalDbgAssert(sdcp->state == BLK_READY, "invalid state");
+
+  n = dma_setup_adma2(sdcp, sg, count);
+  if ((n == 0U) || ((startblk + n) > sdcp->capacity)) {
+    sdcp->errors |= SDC_OVERFLOW_ERROR;
+    return HAL_FAILED;
+  }
+
+  sdcp->state = BLK_WRITING;
+  if ((n > 1U) && (send_pre_erase(sdcp, n) != HAL_SUCCESS)) {
+    sdcp->state = BLK_READY;
+    return HAL_FAILED;
+  }
+  status = sdc_lld_transfer(sdcp, startblk, n,
+                            (n == 1U) ?
+                            SDHC_XFERTYP_CMDINX(MMCSD_CMD_WRITE_BLOCK) :
+                            SDHC_XFERTYP_CMDINX(MMCSD_CMD_WRITE_MULTIPLE_BLOCK));
+  sdcp->state = BLK_READY;
+
+  return status;
 }
+#endif /* KINETIS_SDHC_USE_ADMA2 == TRUE */
 
 /**
  * @brief   Waits for card idle condition.
@@ -961,7 +1184,7 @@ bool sdc_lld_read_special(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
 
   /* Store the cmd argument and DMA start address */
   SDHC->CMDARG = argument;
-  SDHC->DSADDR = bufaddr;
+  dma_setup_simple(bufaddr);
 
   /* We're reading one block, of a (possibly) nonstandard size */
   SDHC->BLKATTR = SDHC_BLKATTR_BLKSIZE(bytes);
@@ -62,12 +62,48 @@
 #if !defined(PLATFORM_SDC_USE_SDC1) || defined(__DOXYGEN__)
 #define PLATFORM_SDC_USE_SDC1                  TRUE
 #endif
+
+/**
+ * @brief   Use ADMA2 descriptor tables for data transfers.
+ * @details If set to @p TRUE data transfers are described by an ADMA2
+ *          descriptor table. @p sdcRead() and @p sdcWrite() go through it
+ *          and @p sdc_lld_read_sg() and @p sdc_lld_write_sg() become
+ *          available, these scatter/gather a single multi-block command
+ *          across several buffers.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(KINETIS_SDHC_USE_ADMA2) || defined(__DOXYGEN__)
+#define KINETIS_SDHC_USE_ADMA2                 FALSE
+#endif
+
+/**
+ * @brief   Number of entries in the ADMA2 descriptor table.
+ * @note    Segments bigger than 64kB use more than one descriptor.
+ */
+#if !defined(KINETIS_SDHC_ADMA2_DESCRIPTORS) || defined(__DOXYGEN__)
+#define KINETIS_SDHC_ADMA2_DESCRIPTORS         8
+#endif
+
+/**
+ * @brief   Minimum number of blocks for a pre-erase hint.
+ * @details Multi-block writes of at least this many blocks to SD cards
+ *          are preceded by ACMD23 (SET_WR_BLK_ERASE_COUNT) so that the
+ *          card can erase the whole range in advance. Zero disables the
+ *          hint.
+ */
+#if !defined(KINETIS_SDHC_PRE_ERASE_THRESHOLD) || defined(__DOXYGEN__)
+#define KINETIS_SDHC_PRE_ERASE_THRESHOLD       8
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (KINETIS_SDHC_USE_ADMA2 == TRUE) && (KINETIS_SDHC_ADMA2_DESCRIPTORS < 1)
+#error "KINETIS_SDHC_ADMA2_DESCRIPTORS must be at least 1"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -87,6 +123,38 @@ typedef uint32_t sdcflags_t;
  */
 typedef struct SDCDriver SDCDriver;
 
+#if (KINETIS_SDHC_USE_ADMA2 == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Scatter/gather list entry.
+ * @note    Buffers must be 32-bit aligned and sizes multiple of four,
+ *          the total size must be a multiple of @p MMCSD_BLOCK_SIZE.
+ */
+typedef struct {
+  /**
+   * @brief   Segment buffer.
+   */
+  uint8_t       *buf;
+  /**
+   * @brief   Segment size in bytes.
+   */
+  size_t        size;
+} sdcsgentry_t;
+
+/**
+ * @brief   ADMA2 descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Attributes and length.
+   */
+  uint32_t      attr;
+  /**
+   * @brief   Data buffer address.
+   */
+  uint32_t      addr;
+} sdcadma2desc_t;
+#endif
+
 /**
  * @brief   Driver configuration structure.
  * @note    It could be empty on some architectures.
@@ -151,6 +219,12 @@ struct SDCDriver {
 
   /* Platform specific fields */
   thread_reference_t        thread;
+#if (KINETIS_SDHC_USE_ADMA2 == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief ADMA2 descriptor table.
+   */
+  sdcadma2desc_t            adma2[KINETIS_SDHC_ADMA2_DESCRIPTORS];
+#endif
 };
 
 /*===========================================================================*/
@@ -189,6 +263,12 @@ extern "C" {
   bool sdc_lld_write(SDCDriver *sdcp, uint32_t startblk,
                      const uint8_t *buf, uint32_t n);
   bool sdc_lld_sync(SDCDriver *sdcp);
+#if KINETIS_SDHC_USE_ADMA2 == TRUE
+  bool sdc_lld_read_sg(SDCDriver *sdcp, uint32_t startblk,
+                       const sdcsgentry_t *sg, uint32_t count);
+  bool sdc_lld_write_sg(SDCDriver *sdcp, uint32_t startblk,
+                        const sdcsgentry_t *sg, uint32_t count);
+#endif
   bool sdc_lld_is_card_inserted(SDCDriver *sdcp);
   bool sdc_lld_is_write_protected(SDCDriver *sdcp);
 #ifdef __cplusplus
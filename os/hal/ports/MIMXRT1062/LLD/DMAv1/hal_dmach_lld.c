@@ -0,0 +1,270 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    DMAv1/hal_dmach_lld.c
+ * @brief   MIMXRT1062 DMA channels subsystem low level driver source.
+ *
+ * @addtogroup DMACH
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_DMACH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Channels pool, indexed by eDMA channel number.
+ */
+static DMAChannel dmach_channels[DMACH_LLD_CHANNELS];
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   eDMA channel callback.
+ * @note    The DONE bit is only left set by the last TCD of a linear chain,
+ *          the ones loaded by scatter-gather have it cleared.
+ *
+ * @param[in] p         pointer to the @p DMAChannel object
+ * @param[in] flags     eDMA callback flags
+ */
+static void dmach_lld_serve_interrupt(void *p, uint32_t flags) {
+  DMAChannel *dchp = (DMAChannel *)p;
+  uint32_t f = 0U;
+
+  if ((flags & MIMXRT1062_EDMA_FLAG_ERROR) != 0U) {
+    f |= DMACH_FLAG_ERROR;
+  }
+  if ((flags & MIMXRT1062_EDMA_FLAG_COMPLETE) != 0U) {
+    f |= DMACH_FLAG_DONE;
+    if ((DMA0->TCD[dchp->edmachp->channel].CSR &
+         MIMXRT1062_EDMA_TCD_CSR_DONE) != 0U) {
+      f |= DMACH_FLAG_END;
+    }
+  }
+
+  _dmach_isr_code(dchp, f);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level DMACH driver initialization.
+ *
+ * @notapi
+ */
+void dmach_lld_init(void) {
+  unsigned i;
+
+  for (i = 0U; i < DMACH_LLD_CHANNELS; i++) {
+    dmachObjectInit(&dmach_channels[i]);
+    dmach_channels[i].edmachp = NULL;
+  }
+}
+
+/**
+ * @brief   Allocates a channel of the pool.
+ * @note    The eDMA serves the channels by number, the highest first.
+ *
+ * @param[in] id        eDMA channel number or @p DMACH_ID_ANY
+ * @param[in] priority  IRQ priority of the channel
+ * @return              The allocated channel.
+ * @retval NULL         if a/the channel is not available.
+ *
+ * @notapi
+ */
+DMAChannel *dmach_lld_alloc(uint32_t id, uint32_t priority) {
+  uint32_t i, startid, endid;
+
+  if (id < DMACH_LLD_CHANNELS) {
+    startid = id;
+    endid   = id;
+  }
+  else {
+    startid = 0U;
+    endid   = DMACH_LLD_CHANNELS - 1U;
+  }
+
+  for (i = startid; i <= endid; i++) {
+    DMAChannel *dchp = &dmach_channels[i];
+
+    dchp->edmachp = edmaChannelAllocI(i, priority,
+                                      dmach_lld_serve_interrupt,
+                                      (void *)dchp);
+    if (dchp->edmachp != NULL) {
+      return dchp;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Releases a channel of the pool.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @notapi
+ */
+void dmach_lld_free(DMAChannel *dchp) {
+
+  edmaChannelFreeI(dchp->edmachp);
+  dchp->edmachp = NULL;
+}
+
+/**
+ * @brief   Selects the request pacing the next chains.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] trigger   DMAMUX request source
+ *
+ * @notapi
+ */
+void dmach_lld_set_trigger(DMAChannel *dchp, dmachtrigger_t trigger) {
+
+  dchp->trigger = trigger;
+}
+
+/**
+ * @brief   Initializes a transfer descriptor.
+ * @details A @p DMACH_MODE_MEMORY descriptor is a single minor loop started
+ *          when loaded, otherwise each request moves one item.
+ *
+ * @param[out] descp    pointer to the descriptor
+ * @param[in] dst       destination address
+ * @param[in] src       source address
+ * @param[in] n         number of items
+ * @param[in] mode      descriptor mode flags
+ *
+ * @notapi
+ */
+void dmach_lld_desc_setup(dmach_desc_t *descp, void *dst, const void *src,
+                          size_t n, uint32_t mode) {
+  uint32_t size = mode & DMACH_MODE_WIDTH_MASK;
+  uint32_t w = dmachModeWidth(mode);
+
+  descp->saddr     = (uint32_t)src;
+  descp->soff      = ((mode & DMACH_MODE_SRC_INC) != 0U) ? (int16_t)w : 0;
+  descp->attr      = MIMXRT1062_EDMA_TCD_ATTR(size, size);
+  descp->slast     = 0;
+  descp->daddr     = (uint32_t)dst;
+  descp->doff      = ((mode & DMACH_MODE_DST_INC) != 0U) ? (int16_t)w : 0;
+  descp->dlast_sga = 0U;
+  if ((mode & DMACH_MODE_MEMORY) != 0U) {
+    descp->nbytes  = (uint32_t)n * w;
+    descp->citer   = 1U;
+    descp->biter   = 1U;
+    descp->csr     = MIMXRT1062_EDMA_TCD_CSR_START;
+  }
+  else {
+    descp->nbytes  = w;
+    descp->citer   = (uint16_t)n;
+    descp->biter   = (uint16_t)n;
+    descp->csr     = 0U;
+  }
+  if ((mode & DMACH_MODE_CB) != 0U) {
+    descp->csr    |= MIMXRT1062_EDMA_TCD_CSR_INTMAJOR;
+  }
+}
+
+/**
+ * @brief   Starts a chain of descriptors.
+ * @details The descriptors are linked by scatter-gather and written back
+ *          from the data cache. The last descriptor of a linear chain
+ *          disables the channel requests.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] descs     array of descriptors
+ * @param[in] len       number of descriptors
+ * @param[in] circular  the last descriptor is linked to the first one
+ *
+ * @notapi
+ */
+void dmach_lld_start(DMAChannel *dchp, dmach_desc_t *descs, unsigned len,
+                     bool circular) {
+  dmach_desc_t *lastp = &descs[len - 1U];
+  unsigned i;
+
+  for (i = 0U; i + 1U < len; i++) {
+    descs[i].dlast_sga = (uint32_t)&descs[i + 1U];
+    descs[i].csr      |= MIMXRT1062_EDMA_TCD_CSR_ESG;
+  }
+  lastp->csr |= MIMXRT1062_EDMA_TCD_CSR_INTMAJOR;
+  if (circular) {
+    lastp->dlast_sga = (uint32_t)&descs[0];
+    lastp->csr      |= MIMXRT1062_EDMA_TCD_CSR_ESG;
+  }
+  else {
+    lastp->dlast_sga = 0U;
+    lastp->csr      |= MIMXRT1062_EDMA_TCD_CSR_DREQ;
+  }
+  cacheBufferFlush(descs, len * sizeof (dmach_desc_t));
+
+  if (dchp->trigger == DMACH_TRIGGER_SOFTWARE) {
+    DMAMUX->CHCFG[dchp->edmachp->channel] = 0U;
+    edmaChannelLoadTCD(dchp->edmachp, &descs[0]);
+  }
+  else {
+    edmaChannelSetSource(dchp->edmachp, dchp->trigger);
+    edmaChannelLoadTCD(dchp->edmachp, &descs[0]);
+    edmaChannelEnable(dchp->edmachp);
+  }
+}
+
+/**
+ * @brief   Stops the channel.
+ * @details The requests are disabled, the chain is broken and the minor
+ *          loop in progress, if any, is completed.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @notapi
+ */
+void dmach_lld_stop(DMAChannel *dchp) {
+  uint32_t ch = dchp->edmachp->channel;
+
+  edmaChannelDisable(dchp->edmachp);
+  DMA0->TCD[ch].CSR &= (uint16_t)~(MIMXRT1062_EDMA_TCD_CSR_ESG |
+                                   MIMXRT1062_EDMA_TCD_CSR_INTMAJOR |
+                                   MIMXRT1062_EDMA_TCD_CSR_START);
+  while ((DMA0->TCD[ch].CSR & MIMXRT1062_EDMA_TCD_CSR_ACTIVE) != 0U)
+    ;
+  DMA0->CINT = (uint8_t)ch;
+}
+
+#endif /* HAL_USE_DMACH == TRUE */
+
+/** @} */
@@ -0,0 +1,132 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    DMAv1/hal_dmach_lld.h
+ * @brief   MIMXRT1062 DMA channels subsystem low level driver header.
+ *
+ * @addtogroup DMACH
+ * @{
+ */
+
+#ifndef HAL_DMACH_LLD_H
+#define HAL_DMACH_LLD_H
+
+#if (HAL_USE_DMACH == TRUE) || defined(__DOXYGEN__)
+
+#include "mimxrt1062_edma.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of channels of the pool.
+ */
+#define DMACH_LLD_CHANNELS          MIMXRT1062_EDMA_CHANNELS
+
+/**
+ * @brief   Largest number of items of a descriptor.
+ */
+#define DMACH_LLD_DESC_MAX_ITEMS    MIMXRT1062_EDMA_MAX_ITER
+
+/**
+ * @brief   Circular chains support.
+ */
+#define DMACH_LLD_SUPPORTS_CIRCULAR TRUE
+
+/**
+ * @brief   Trigger starting the chains on @p dmachStart().
+ * @note    The DMAMUX slot of the channel is disabled.
+ */
+#define DMACH_TRIGGER_SOFTWARE      0U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(MIMXRT1062_EDMA_REQUIRED)
+#define MIMXRT1062_EDMA_REQUIRED
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a transfer descriptor.
+ * @note    Aligned to a cache line, chains are written back from the data
+ *          cache when started.
+ */
+typedef mimxrt1062_edma_tcd_t dmach_desc_t __attribute__((aligned(32)));
+
+/**
+ * @brief   Type of a channel trigger, a @p kDmaRequestMux request source.
+ */
+typedef uint32_t dmachtrigger_t;
+
+/**
+ * @brief   Low level fields of the channel structure.
+ */
+#define dmach_lld_channel_fields                                            \
+  /* Allocated eDMA channel, NULL if free.*/                                \
+  const mimxrt1062_edma_channel_t *edmachp;                                 \
+  /* Trigger source.*/                                                      \
+  dmachtrigger_t            trigger
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the bytes moved by a descriptor.
+ *
+ * @param[in] descp     pointer to the descriptor
+ *
+ * @notapi
+ */
+#define dmach_lld_desc_get_size(descp)                                      \
+  ((size_t)(descp)->nbytes * (size_t)(descp)->biter)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dmach_lld_init(void);
+  DMAChannel *dmach_lld_alloc(uint32_t id, uint32_t priority);
+  void dmach_lld_free(DMAChannel *dchp);
+  void dmach_lld_set_trigger(DMAChannel *dchp, dmachtrigger_t trigger);
+  void dmach_lld_desc_setup(dmach_desc_t *descp, void *dst, const void *src,
+                            size_t n, uint32_t mode);
+  void dmach_lld_start(DMAChannel *dchp, dmach_desc_t *descs, unsigned len,
+                       bool circular);
+  void dmach_lld_stop(DMAChannel *dchp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_DMACH == TRUE */
+
+#endif /* HAL_DMACH_LLD_H */
+
+/** @} */
@@ -0,0 +1,453 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    DMAv1/mimxrt1062_edma.c
+ * @brief   eDMA helper driver code.
+ *
+ * @addtogroup MIMXRT1062_EDMA
+ * @details eDMA sharing helper driver. In the i.MX RT 1060 the channels
+ *          n and n + 16 share the same IRQ vector, the vector is enabled as
+ *          long as one of the two has a callback installed.
+ * @{
+ */
+
+#include "hal.h"
+
+/* The following macro is only defined if some driver requiring eDMA services
+   has been enabled.*/
+#if defined(MIMXRT1062_EDMA_REQUIRED) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define EDMA_ERROR_IRQn             16U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   eDMA channels descriptors.
+ */
+static const mimxrt1062_edma_channel_t _edma_channels[MIMXRT1062_EDMA_CHANNELS] = {
+  { 0,  0}, { 1,  1}, { 2,  2}, { 3,  3}, { 4,  4}, { 5,  5}, { 6,  6}, { 7,  7},
+  { 8,  8}, { 9,  9}, {10, 10}, {11, 11}, {12, 12}, {13, 13}, {14, 14}, {15, 15},
+  {16,  0}, {17,  1}, {18,  2}, {19,  3}, {20,  4}, {21,  5}, {22,  6}, {23,  7},
+  {24,  8}, {25,  9}, {26, 10}, {27, 11}, {28, 12}, {29, 13}, {30, 14}, {31, 15}
+};
+
+/**
+ * @brief   Global eDMA state.
+ */
+static struct {
+  /**
+   * @brief   Mask of the allocated channels.
+   */
+  uint32_t              allocated_mask;
+  /**
+   * @brief   Mask of the channels with a callback installed.
+   */
+  uint32_t              isr_mask;
+  /**
+   * @brief   Callbacks of the channels.
+   */
+  struct {
+    mimxrt1062_edmaisr_t  func;
+    void                  *param;
+  } channels[MIMXRT1062_EDMA_CHANNELS];
+} edma;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static void edma_serve_channel(uint32_t ch) {
+
+  if ((DMA0->INT & (1U << ch)) != 0U) {
+    DMA0->CINT = (uint8_t)ch;
+    if (edma.channels[ch].func != NULL) {
+      edma.channels[ch].func(edma.channels[ch].param,
+                             MIMXRT1062_EDMA_FLAG_COMPLETE);
+    }
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+#define EDMA_IRQ_HANDLER(n)                                                 \
+OSAL_IRQ_HANDLER(MIMXRT1062_DMA##n##_IRQ_VECTOR) {                          \
+                                                                            \
+  OSAL_IRQ_PROLOGUE();                                                      \
+                                                                            \
+  edma_serve_channel(n);                                                    \
+  edma_serve_channel(n + 16U);                                              \
+                                                                            \
+  OSAL_IRQ_EPILOGUE();                                                      \
+}
+
+/**
+ * @brief   eDMA channels 0 and 16 interrupt handler.
+ *
+ * @isr
+ */
+EDMA_IRQ_HANDLER(0)
+EDMA_IRQ_HANDLER(1)
+EDMA_IRQ_HANDLER(2)
+EDMA_IRQ_HANDLER(3)
+EDMA_IRQ_HANDLER(4)
+EDMA_IRQ_HANDLER(5)
+EDMA_IRQ_HANDLER(6)
+EDMA_IRQ_HANDLER(7)
+EDMA_IRQ_HANDLER(8)
+EDMA_IRQ_HANDLER(9)
+EDMA_IRQ_HANDLER(10)
+EDMA_IRQ_HANDLER(11)
+EDMA_IRQ_HANDLER(12)
+EDMA_IRQ_HANDLER(13)
+EDMA_IRQ_HANDLER(14)
+EDMA_IRQ_HANDLER(15)
+
+/**
+ * @brief   eDMA error interrupt handler.
+ * @note    The failed channel is stopped before its callback is invoked.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(MIMXRT1062_DMA_ERROR_IRQ_VECTOR) {
+  uint32_t err;
+
+  OSAL_IRQ_PROLOGUE();
+
+  err = DMA0->ERR;
+  while (err != 0U) {
+    uint32_t ch = (uint32_t)__builtin_ctz(err);
+
+    err &= ~(1U << ch);
+    DMA0->CERQ = (uint8_t)ch;
+    DMA0->CERR = (uint8_t)ch;
+    if (edma.channels[ch].func != NULL) {
+      edma.channels[ch].func(edma.channels[ch].param,
+                             MIMXRT1062_EDMA_FLAG_ERROR);
+    }
+  }
+
+  OSAL_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   eDMA initialization.
+ *
+ * @init
+ */
+void edmaInit(void) {
+  unsigned i;
+
+  edma.allocated_mask = 0U;
+  edma.isr_mask       = 0U;
+  for (i = 0; i < MIMXRT1062_EDMA_CHANNELS; i++) {
+    edma.channels[i].func = NULL;
+    DMAMUX->CHCFG[i] = 0U;
+  }
+
+  CLOCK_EnableClock(kCLOCK_Dma);
+  DMA0->CR   = 0U;
+  DMA0->ERQ  = 0U;
+  DMA0->INT  = 0xFFFFFFFFU;
+  DMA0->ERR  = 0xFFFFFFFFU;
+  DMA0->EEI  = 0xFFFFFFFFU;
+  nvicEnableVector(EDMA_ERROR_IRQn, MIMXRT1062_EDMA_ERROR_IRQ_PRIORITY);
+}
+
+/**
+ * @brief   Allocates an eDMA channel.
+ * @details The function also enables the IRQ vector associated to the
+ *          channel and initializes its priority.
+ * @note    The vector is shared with the channel 16 apart, the priority of
+ *          the first allocation is kept.
+ *
+ * @param[in] id        channel number or @p MIMXRT1062_EDMA_CHANNEL_ID_ANY
+ * @param[in] priority  IRQ priority for the channel
+ * @param[in] func      handling function pointer, can be @p NULL
+ * @param[in] param     a parameter to be passed to the handling function
+ * @return              Pointer to the allocated channel.
+ * @retval NULL         if a/the channel is not available.
+ *
+ * @iclass
+ */
+const mimxrt1062_edma_channel_t *edmaChannelAllocI(uint32_t id,
+                                                   uint32_t priority,
+                                                   mimxrt1062_edmaisr_t func,
+                                                   void *param) {
+  uint32_t i, startid, endid;
+
+  osalDbgCheckClassI();
+
+  if (id < MIMXRT1062_EDMA_CHANNELS) {
+    startid = id;
+    endid   = id;
+  }
+  else if (id == MIMXRT1062_EDMA_CHANNEL_ID_ANY) {
+    startid = 0U;
+    endid   = MIMXRT1062_EDMA_CHANNELS - 1U;
+  }
+  else {
+    osalDbgCheck(false);
+    return NULL;
+  }
+
+  for (i = startid; i <= endid; i++) {
+    uint32_t mask = (1U << i);
+
+    if ((edma.allocated_mask & mask) == 0U) {
+      const mimxrt1062_edma_channel_t *chp = &_edma_channels[i];
+      uint32_t shared = mask | (1U << (i ^ 16U));
+
+      edma.channels[i].func  = func;
+      edma.channels[i].param = param;
+      edma.allocated_mask   |= mask;
+
+      if (func != NULL) {
+        if ((edma.isr_mask & shared) == 0U) {
+          nvicEnableVector(chp->vector, priority);
+        }
+        edma.isr_mask |= mask;
+      }
+
+      /* Putting the channel in a known state.*/
+      DMA0->CERQ = (uint8_t)i;
+      DMA0->CINT = (uint8_t)i;
+      DMA0->CERR = (uint8_t)i;
+      DMA0->CDNE = (uint8_t)i;
+      DMA0->TCD[i].CSR = 0U;
+
+      return chp;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Allocates an eDMA channel.
+ * @details The function also enables the IRQ vector associated to the
+ *          channel and initializes its priority.
+ *
+ * @param[in] id        channel number or @p MIMXRT1062_EDMA_CHANNEL_ID_ANY
+ * @param[in] priority  IRQ priority for the channel
+ * @param[in] func      handling function pointer, can be @p NULL
+ * @param[in] param     a parameter to be passed to the handling function
+ * @return              Pointer to the allocated channel.
+ * @retval NULL         if a/the channel is not available.
+ *
+ * @api
+ */
+const mimxrt1062_edma_channel_t *edmaChannelAlloc(uint32_t id,
+                                                  uint32_t priority,
+                                                  mimxrt1062_edmaisr_t func,
+                                                  void *param) {
+  const mimxrt1062_edma_channel_t *chp;
+
+  osalSysLock();
+  chp = edmaChannelAllocI(id, priority, func, param);
+  osalSysUnlock();
+
+  return chp;
+}
+
+/**
+ * @brief   Releases an eDMA channel.
+ * @details The channel is stopped and its request source disconnected.
+ *
+ * @param[in] chp       pointer to a mimxrt1062_edma_channel_t structure
+ *
+ * @iclass
+ */
+void edmaChannelFreeI(const mimxrt1062_edma_channel_t *chp) {
+  uint32_t ch = chp->channel;
+  uint32_t mask = (1U << ch);
+
+  osalDbgCheckClassI();
+  osalDbgAssert((edma.allocated_mask & mask) != 0U,
+                "releasing not allocated channel");
+
+  DMA0->CERQ = (uint8_t)ch;
+  DMAMUX->CHCFG[ch] = 0U;
+
+  edma.allocated_mask &= ~mask;
+  if ((edma.isr_mask & mask) != 0U) {
+    edma.isr_mask &= ~mask;
+    if ((edma.isr_mask & (1U << (ch ^ 16U))) == 0U) {
+      nvicDisableVector(chp->vector);
+    }
+  }
+  edma.channels[ch].func = NULL;
+}
+
+/**
+ * @brief   Releases an eDMA channel.
+ *
+ * @param[in] chp       pointer to a mimxrt1062_edma_channel_t structure
+ *
+ * @api
+ */
+void edmaChannelFree(const mimxrt1062_edma_channel_t *chp) {
+
+  osalSysLock();
+  edmaChannelFreeI(chp);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Loads a TCD into a channel.
+ * @pre     The channel must be idle, its requests disabled.
+ *
+ * @param[in] chp       pointer to a mimxrt1062_edma_channel_t structure
+ * @param[in] tcdp      descriptor to be loaded, a scatter-gather chain
+ *                      is followed by the engine from there
+ *
+ * @special
+ */
+void edmaChannelLoadTCD(const mimxrt1062_edma_channel_t *chp,
+                        const mimxrt1062_edma_tcd_t *tcdp) {
+  uint32_t ch = chp->channel;
+
+  /* DONE must be cleared before a CSR with ESG set is written.*/
+  DMA0->TCD[ch].CSR = 0U;
+  DMA0->CDNE = (uint8_t)ch;
+
+  DMA0->TCD[ch].SADDR         = tcdp->saddr;
+  DMA0->TCD[ch].SOFF          = (uint16_t)tcdp->soff;
+  DMA0->TCD[ch].ATTR          = tcdp->attr;
+  DMA0->TCD[ch].NBYTES_MLNO   = tcdp->nbytes;
+  DMA0->TCD[ch].SLAST         = (uint32_t)tcdp->slast;
+  DMA0->TCD[ch].DADDR         = tcdp->daddr;
+  DMA0->TCD[ch].DOFF          = (uint16_t)tcdp->doff;
+  DMA0->TCD[ch].CITER_ELINKNO = tcdp->citer;
+  DMA0->TCD[ch].DLAST_SGA     = tcdp->dlast_sga;
+  DMA0->TCD[ch].BITER_ELINKNO = tcdp->biter;
+  DMA0->TCD[ch].CSR           = tcdp->csr;
+}
+
+/**
+ * @brief   Builds a scatter-gather chain.
+ * @details A transfer of @p n minor loops is split in descriptors of at most
+ *          @p MIMXRT1062_EDMA_MAX_ITER iterations, each one linked to the
+ *          next. The last one disables the channel requests and gets the
+ *          CSR flags of the template. The chain is written back from the
+ *          data cache so the engine can fetch it.
+ *
+ * @param[out] chain    array of descriptors, see
+ *                      @p MIMXRT1062_EDMA_TCD_CHAIN()
+ * @param[in] len       number of descriptors in @p chain
+ * @param[in] tmpl      template providing the addresses, offsets, attributes,
+ *                      minor loop size of the transfer and the CSR flags of
+ *                      the last descriptor
+ * @param[in] n         number of minor loops
+ * @return              The number of descriptors used.
+ * @retval 0            if @p n is zero or the chain is too short.
+ *
+ * @special
+ */
+unsigned edmaChainInit(mimxrt1062_edma_tcd_t *chain, unsigned len,
+                       const mimxrt1062_edma_tcd_t *tmpl, size_t n) {
+  uint32_t saddr = tmpl->saddr;
+  uint32_t daddr = tmpl->daddr;
+  unsigned i = 0;
+
+  if ((n == 0U) || (n > (size_t)len * MIMXRT1062_EDMA_MAX_ITER))
+    return 0U;
+
+  while (n > 0U) {
+    uint16_t iter = (n > MIMXRT1062_EDMA_MAX_ITER) ?
+                    (uint16_t)MIMXRT1062_EDMA_MAX_ITER : (uint16_t)n;
+
+    chain[i]        = *tmpl;
+    chain[i].saddr  = saddr;
+    chain[i].daddr  = daddr;
+    chain[i].slast  = 0;
+    chain[i].citer  = iter;
+    chain[i].biter  = iter;
+    n -= iter;
+    if (n > 0U) {
+      chain[i].dlast_sga = (uint32_t)&chain[i + 1U];
+      chain[i].csr       = MIMXRT1062_EDMA_TCD_CSR_ESG;
+    }
+    else {
+      chain[i].dlast_sga = 0U;
+      chain[i].csr       = tmpl->csr | MIMXRT1062_EDMA_TCD_CSR_DREQ;
+    }
+
+    saddr += (uint32_t)((int32_t)tmpl->soff * iter);
+    daddr += (uint32_t)((int32_t)tmpl->doff * iter);
+    i++;
+  }
+
+  cacheBufferFlush(chain, i * sizeof (mimxrt1062_edma_tcd_t));
+
+  return i;
+}
+
+/**
+ * @brief   Returns the minor loops not yet executed of a chain.
+ * @pre     The channel requests should be disabled.
+ *
+ * @param[in] chp       pointer to a mimxrt1062_edma_channel_t structure
+ * @param[in] chain     chain loaded in the channel
+ * @param[in] len       number of descriptors used in @p chain
+ * @return              The number of remaining minor loops.
+ *
+ * @special
+ */
+size_t edmaChainGetRemaining(const mimxrt1062_edma_channel_t *chp,
+                             const mimxrt1062_edma_tcd_t *chain,
+                             unsigned len) {
+  uint32_t sga = DMA0->TCD[chp->channel].DLAST_SGA;
+  size_t n;
+  unsigned i;
+
+  /* The descriptor in execution is found from its link to the next one,
+     the last one has no link.*/
+  for (i = 0; i + 1U < len; i++) {
+    if (sga == (uint32_t)&chain[i + 1U])
+      break;
+  }
+
+  if (((DMA0->TCD[chp->channel].CSR & MIMXRT1062_EDMA_TCD_CSR_DONE) != 0U) &&
+      (i + 1U >= len))
+    return 0U;
+
+  n = edmaChannelGetIter(chp);
+  for (i = i + 1U; i < len; i++)
+    n += chain[i].biter;
+
+  return n;
+}
+
+#endif /* MIMXRT1062_EDMA_REQUIRED */
+
+/** @} */
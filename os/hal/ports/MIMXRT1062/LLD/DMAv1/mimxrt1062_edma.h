@@ -0,0 +1,247 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    DMAv1/mimxrt1062_edma.h
+ * @brief   eDMA helper driver header.
+ * @note    This driver uses the eDMA engine and the DMAMUX of the i.MX RT
+ *          1060, chapters 5 and 6 of the reference manual.
+ *
+ * @addtogroup MIMXRT1062_EDMA
+ * @details eDMA sharing helper driver. Channels are allocated by the
+ *          peripheral drivers, a DMAMUX request source is routed to them
+ *          and transfers are described by TCDs, possibly linked in
+ *          scatter-gather chains.
+ * @{
+ */
+
+#ifndef MIMXRT1062_EDMA_H
+#define MIMXRT1062_EDMA_H
+
+#include "fsl_clock.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Total number of eDMA channels.
+ */
+#define MIMXRT1062_EDMA_CHANNELS            32U
+
+/**
+ * @brief   Channel identifier to be passed to @p edmaChannelAlloc() for any
+ *          free channel.
+ */
+#define MIMXRT1062_EDMA_CHANNEL_ID_ANY      MIMXRT1062_EDMA_CHANNELS
+
+/**
+ * @brief   Largest major loop count of a TCD.
+ * @note    Channel linking is not used so the whole 15 bits are available.
+ */
+#define MIMXRT1062_EDMA_MAX_ITER            0x7FFFU
+
+/**
+ * @name    Callback flags
+ * @{
+ */
+#define MIMXRT1062_EDMA_FLAG_COMPLETE       (1U << 0)
+#define MIMXRT1062_EDMA_FLAG_ERROR          (1U << 1)
+/** @} */
+
+/**
+ * @name    TCD transfer sizes
+ * @{
+ */
+#define MIMXRT1062_EDMA_SIZE_8BITS          0U
+#define MIMXRT1062_EDMA_SIZE_16BITS         1U
+#define MIMXRT1062_EDMA_SIZE_32BITS         2U
+/** @} */
+
+/**
+ * @name    TCD fields
+ * @{
+ */
+#define MIMXRT1062_EDMA_TCD_ATTR(ssize, dsize)                              \
+  ((uint16_t)(((ssize) << 8) | (dsize)))
+#define MIMXRT1062_EDMA_TCD_CSR_START       (1U << 0)
+#define MIMXRT1062_EDMA_TCD_CSR_INTMAJOR    (1U << 1)
+#define MIMXRT1062_EDMA_TCD_CSR_INTHALF     (1U << 2)
+#define MIMXRT1062_EDMA_TCD_CSR_DREQ        (1U << 3)
+#define MIMXRT1062_EDMA_TCD_CSR_ESG         (1U << 4)
+#define MIMXRT1062_EDMA_TCD_CSR_ACTIVE      (1U << 6)
+#define MIMXRT1062_EDMA_TCD_CSR_DONE        (1U << 7)
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   eDMA error interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_EDMA_ERROR_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_EDMA_ERROR_IRQ_PRIORITY  12
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_EDMA_ERROR_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to the eDMA error interrupt"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of an eDMA callback.
+ *
+ * @param[in] p         parameter for the registered function
+ * @param[in] flags     @p MIMXRT1062_EDMA_FLAG_COMPLETE or
+ *                      @p MIMXRT1062_EDMA_FLAG_ERROR
+ */
+typedef void (*mimxrt1062_edmaisr_t)(void *p, uint32_t flags);
+
+/**
+ * @brief   Transfer control descriptor.
+ * @details Same layout as the channel TCD registers. A TCD loaded by the
+ *          engine through scatter-gather must be 32 bytes aligned.
+ */
+typedef struct {
+  uint32_t              saddr;
+  int16_t               soff;
+  uint16_t              attr;
+  uint32_t              nbytes;
+  int32_t               slast;
+  uint32_t              daddr;
+  int16_t               doff;
+  uint16_t              citer;
+  uint32_t              dlast_sga;
+  uint16_t              csr;
+  uint16_t              biter;
+} mimxrt1062_edma_tcd_t;
+
+/**
+ * @brief   eDMA channel descriptor structure.
+ */
+typedef struct {
+  uint8_t               channel;        /**< @brief Channel number.         */
+  uint8_t               vector;         /**< @brief IRQ number, shared with
+                                             the channel 16 apart.          */
+} mimxrt1062_edma_channel_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Declares a TCD chain.
+ * @note    The descriptors are read by the engine, they are aligned so
+ *          that cache maintenance does not touch other data.
+ *
+ * @param[in] name      name of the array
+ * @param[in] n         number of descriptors
+ */
+#define MIMXRT1062_EDMA_TCD_CHAIN(name, n)                                  \
+  mimxrt1062_edma_tcd_t name[n] __attribute__((aligned(32)))
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Routes a DMAMUX request source to a channel.
+ * @pre     The channel must have been allocated using
+ *          @p edmaChannelAlloc().
+ *
+ * @param[in] chp       pointer to a mimxrt1062_edma_channel_t structure
+ * @param[in] source    request source, one of the @p kDmaRequestMux values
+ *
+ * @special
+ */
+#define edmaChannelSetSource(chp, source) do {                              \
+  DMAMUX->CHCFG[(chp)->channel] = 0U;                                       \
+  DMAMUX->CHCFG[(chp)->channel] = DMAMUX_CHCFG_SOURCE(source) |             \
+                                  DMAMUX_CHCFG_ENBL_MASK;                   \
+} while (false)
+
+/**
+ * @brief   Enables the hardware requests of a channel.
+ * @pre     A TCD must have been loaded using @p edmaChannelLoadTCD().
+ *
+ * @param[in] chp       pointer to a mimxrt1062_edma_channel_t structure
+ *
+ * @special
+ */
+#define edmaChannelEnable(chp) (DMA0->SERQ = (chp)->channel)
+
+/**
+ * @brief   Disables the hardware requests of a channel.
+ * @note    A minor loop in progress is completed.
+ *
+ * @param[in] chp       pointer to a mimxrt1062_edma_channel_t structure
+ *
+ * @special
+ */
+#define edmaChannelDisable(chp) (DMA0->CERQ = (chp)->channel)
+
+/**
+ * @brief   Returns the major loop iterations left in the current TCD.
+ *
+ * @param[in] chp       pointer to a mimxrt1062_edma_channel_t structure
+ *
+ * @special
+ */
+#define edmaChannelGetIter(chp)                                             \
+  ((size_t)(DMA0->TCD[(chp)->channel].CITER_ELINKNO &                       \
+            DMA_CITER_ELINKNO_CITER_MASK))
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void edmaInit(void);
+  const mimxrt1062_edma_channel_t *edmaChannelAllocI(uint32_t id,
+                                                     uint32_t priority,
+                                                     mimxrt1062_edmaisr_t func,
+                                                     void *param);
+  const mimxrt1062_edma_channel_t *edmaChannelAlloc(uint32_t id,
+                                                    uint32_t priority,
+                                                    mimxrt1062_edmaisr_t func,
+                                                    void *param);
+  void edmaChannelFreeI(const mimxrt1062_edma_channel_t *chp);
+  void edmaChannelFree(const mimxrt1062_edma_channel_t *chp);
+  void edmaChannelLoadTCD(const mimxrt1062_edma_channel_t *chp,
+                          const mimxrt1062_edma_tcd_t *tcdp);
+  unsigned edmaChainInit(mimxrt1062_edma_tcd_t *chain, unsigned len,
+                         const mimxrt1062_edma_tcd_t *tmpl, size_t n);
+  size_t edmaChainGetRemaining(const mimxrt1062_edma_channel_t *chp,
+                               const mimxrt1062_edma_tcd_t *chain,
+                               unsigned len);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MIMXRT1062_EDMA_H */
+
+/** @} */
@@ -0,0 +1,512 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LPSPIv1/hal_spi_v2_lld.c
+ * @brief   MIMXRT1062 LPSPI subsystem low level driver source.
+ * @note    Transfers run on two eDMA channels, the receive channel ends
+ *          the operation. The LPSPI stalls when its receive FIFO is full
+ *          so the transmit channel cannot overrun it.
+ * @note    Buffers in cacheable memory must be aligned and padded to the
+ *          cache line size, the receive buffer is invalidated before and
+ *          after the transfer.
+ *
+ * @addtogroup SPI
+ * @{
+ */
+
+#include "hal.h"
+
+#if HAL_USE_SPI || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief SPI1 driver identifier.*/
+#if MIMXRT1062_SPI_USE_SPI0 || defined(__DOXYGEN__)
+SPIDriver SPID1;
+#endif
+
+/** @brief SPI2 driver identifier.*/
+#if MIMXRT1062_SPI_USE_SPI1 || defined(__DOXYGEN__)
+SPIDriver SPID2;
+#endif
+
+/** @brief SPI3 driver identifier.*/
+#if MIMXRT1062_SPI_USE_SPI2 || defined(__DOXYGEN__)
+SPIDriver SPID3;
+#endif
+
+/** @brief SPI4 driver identifier.*/
+#if MIMXRT1062_SPI_USE_SPI3 || defined(__DOXYGEN__)
+SPIDriver SPID4;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Stops the DMA channels and the LPSPI requests.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ */
+static void spi_lld_stop_dma(SPIDriver *spip) {
+
+  spip->lpspi->DER = 0U;
+  edmaChannelDisable(spip->dmatx);
+  edmaChannelDisable(spip->dmarx);
+}
+
+/**
+ * @brief   Shared end-of-rx service routine.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] flags     eDMA callback flags
+ */
+static void spi_lld_serve_rx_interrupt(SPIDriver *spip, uint32_t flags) {
+
+  spi_lld_stop_dma(spip);
+
+  if ((flags & MIMXRT1062_EDMA_FLAG_ERROR) != 0U) {
+    __spi_isr_error_code(spip, HAL_RET_HW_FAILURE);
+    return;
+  }
+
+  if (spip->rxbuf != NULL)
+    cacheBufferInvalidate(spip->rxbuf, spip->rxsize);
+
+  __spi_isr_complete_code(spip);
+}
+
+/**
+ * @brief   Shared transmit DMA service routine, errors only.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] flags     eDMA callback flags
+ */
+static void spi_lld_serve_tx_interrupt(SPIDriver *spip, uint32_t flags) {
+
+  if ((flags & MIMXRT1062_EDMA_FLAG_ERROR) != 0U) {
+    spi_lld_stop_dma(spip);
+    __spi_isr_error_code(spip, HAL_RET_HW_FAILURE);
+  }
+}
+
+/**
+ * @brief   Allocates the DMA channels of a driver.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] rxid      receive channel number or any
+ * @param[in] txid      transmit channel number or any
+ * @param[in] priority  IRQ priority of the channels
+ * @return              The operation status.
+ */
+static msg_t spi_lld_get_dma(SPIDriver *spip, uint32_t rxid, uint32_t txid,
+                             uint32_t priority) {
+
+  spip->dmarx = edmaChannelAllocI(rxid, priority,
+                                  (mimxrt1062_edmaisr_t)spi_lld_serve_rx_interrupt,
+                                  (void *)spip);
+  if (spip->dmarx == NULL)
+    return HAL_RET_NO_RESOURCE;
+
+  spip->dmatx = edmaChannelAllocI(txid, priority,
+                                  (mimxrt1062_edmaisr_t)spi_lld_serve_tx_interrupt,
+                                  (void *)spip);
+  if (spip->dmatx == NULL) {
+    edmaChannelFreeI(spip->dmarx);
+    return HAL_RET_NO_RESOURCE;
+  }
+
+  edmaChannelSetSource(spip->dmarx, spip->rxsource);
+  edmaChannelSetSource(spip->dmatx, spip->txsource);
+
+  return HAL_RET_SUCCESS;
+}
+
+/**
+ * @brief   Starts a DMA transfer.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames
+ * @param[in] txbuf     transmit buffer or @p NULL for idle frames
+ * @param[out] rxbuf    receive buffer or @p NULL to discard
+ * @return              The operation status.
+ */
+static msg_t spi_lld_start_dma(SPIDriver *spip, size_t n,
+                               const void *txbuf, void *rxbuf) {
+  mimxrt1062_edma_tcd_t tmpl;
+  uint32_t size = MIMXRT1062_EDMA_SIZE_8BITS;
+  unsigned ntx;
+
+  if (spip->fsize == 2U)
+    size = MIMXRT1062_EDMA_SIZE_16BITS;
+  else if (spip->fsize == 4U)
+    size = MIMXRT1062_EDMA_SIZE_32BITS;
+
+  /* Receive chain, it raises the completion interrupt.*/
+  tmpl.saddr     = (uint32_t)&spip->lpspi->RDR;
+  tmpl.soff      = 0;
+  tmpl.attr      = MIMXRT1062_EDMA_TCD_ATTR(size, size);
+  tmpl.nbytes    = spip->fsize;
+  tmpl.daddr     = (rxbuf != NULL) ? (uint32_t)rxbuf :
+                                     (uint32_t)&spip->rxdummy;
+  tmpl.doff      = (rxbuf != NULL) ? (int16_t)spip->fsize : 0;
+  tmpl.csr       = MIMXRT1062_EDMA_TCD_CSR_INTMAJOR;
+  spip->ntcd     = (uint8_t)edmaChainInit(spip->rxchain,
+                                          MIMXRT1062_SPI_DMA_CHAIN_LENGTH,
+                                          &tmpl, n);
+
+  /* Transmit chain.*/
+  tmpl.saddr     = (txbuf != NULL) ? (uint32_t)txbuf :
+                                     (uint32_t)&spip->txdummy;
+  tmpl.soff      = (txbuf != NULL) ? (int16_t)spip->fsize : 0;
+  tmpl.daddr     = (uint32_t)&spip->lpspi->TDR;
+  tmpl.doff      = 0;
+  tmpl.csr       = 0U;
+  ntx = edmaChainInit(spip->txchain, MIMXRT1062_SPI_DMA_CHAIN_LENGTH,
+                      &tmpl, n);
+
+  if ((spip->ntcd == 0U) || (ntx == 0U))
+    return HAL_RET_CONFIG_ERROR;
+
+  spip->rxbuf  = rxbuf;
+  spip->rxsize = n * spip->fsize;
+  if (txbuf != NULL)
+    cacheBufferFlush(txbuf, n * spip->fsize);
+  if (rxbuf != NULL)
+    cacheBufferInvalidate(rxbuf, spip->rxsize);
+
+  edmaChannelLoadTCD(spip->dmarx, &spip->rxchain[0]);
+  edmaChannelLoadTCD(spip->dmatx, &spip->txchain[0]);
+  edmaChannelEnable(spip->dmarx);
+  edmaChannelEnable(spip->dmatx);
+  spip->lpspi->DER = LPSPI_DER_RDDE_MASK | LPSPI_DER_TDDE_MASK;
+
+  return HAL_RET_SUCCESS;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level SPI driver initialization.
+ *
+ * @notapi
+ */
+void spi_lld_init(void) {
+
+#if MIMXRT1062_SPI_USE_SPI0
+  spiObjectInit(&SPID1);
+  SPID1.lpspi    = LPSPI1;
+  SPID1.rxsource = (uint8_t)kDmaRequestMuxLPSPI1Rx;
+  SPID1.txsource = (uint8_t)kDmaRequestMuxLPSPI1Tx;
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI1
+  spiObjectInit(&SPID2);
+  SPID2.lpspi    = LPSPI2;
+  SPID2.rxsource = (uint8_t)kDmaRequestMuxLPSPI2Rx;
+  SPID2.txsource = (uint8_t)kDmaRequestMuxLPSPI2Tx;
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI2
+  spiObjectInit(&SPID3);
+  SPID3.lpspi    = LPSPI3;
+  SPID3.rxsource = (uint8_t)kDmaRequestMuxLPSPI3Rx;
+  SPID3.txsource = (uint8_t)kDmaRequestMuxLPSPI3Tx;
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI3
+  spiObjectInit(&SPID4);
+  SPID4.lpspi    = LPSPI4;
+  SPID4.rxsource = (uint8_t)kDmaRequestMuxLPSPI4Rx;
+  SPID4.txsource = (uint8_t)kDmaRequestMuxLPSPI4Tx;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the SPI peripheral.
+ * @note    The LPSPI functional clock comes from the board clock setup,
+ *          the @p ccr dividers and the @p tcr prescaler divide it.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+msg_t spi_lld_start(SPIDriver *spip) {
+  uint32_t framesz;
+
+  /* If in stopped state then enables the LPSPI clock and allocates the DMA
+     channels.*/
+  if (spip->state == SPI_STOP) {
+    msg_t msg;
+
+#if MIMXRT1062_SPI_USE_SPI0
+    if (&SPID1 == spip) {
+      msg = spi_lld_get_dma(spip, MIMXRT1062_SPI_SPI0_RX_DMA_CHANNEL,
+                            MIMXRT1062_SPI_SPI0_TX_DMA_CHANNEL,
+                            MIMXRT1062_SPI_SPI0_DMA_IRQ_PRIORITY);
+      if (msg != HAL_RET_SUCCESS)
+        return msg;
+      CLOCK_EnableClock(kCLOCK_Lpspi1);
+    }
+#endif
+#if MIMXRT1062_SPI_USE_SPI1
+    if (&SPID2 == spip) {
+      msg = spi_lld_get_dma(spip, MIMXRT1062_SPI_SPI1_RX_DMA_CHANNEL,
+                            MIMXRT1062_SPI_SPI1_TX_DMA_CHANNEL,
+                            MIMXRT1062_SPI_SPI1_DMA_IRQ_PRIORITY);
+      if (msg != HAL_RET_SUCCESS)
+        return msg;
+      CLOCK_EnableClock(kCLOCK_Lpspi2);
+    }
+#endif
+#if MIMXRT1062_SPI_USE_SPI2
+    if (&SPID3 == spip) {
+      msg = spi_lld_get_dma(spip, MIMXRT1062_SPI_SPI2_RX_DMA_CHANNEL,
+                            MIMXRT1062_SPI_SPI2_TX_DMA_CHANNEL,
+                            MIMXRT1062_SPI_SPI2_DMA_IRQ_PRIORITY);
+      if (msg != HAL_RET_SUCCESS)
+        return msg;
+      CLOCK_EnableClock(kCLOCK_Lpspi3);
+    }
+#endif
+#if MIMXRT1062_SPI_USE_SPI3
+    if (&SPID4 == spip) {
+      msg = spi_lld_get_dma(spip, MIMXRT1062_SPI_SPI3_RX_DMA_CHANNEL,
+                            MIMXRT1062_SPI_SPI3_TX_DMA_CHANNEL,
+                            MIMXRT1062_SPI_SPI3_DMA_IRQ_PRIORITY);
+      if (msg != HAL_RET_SUCCESS)
+        return msg;
+      CLOCK_EnableClock(kCLOCK_Lpspi4);
+    }
+#endif
+    (void)msg;
+  }
+
+  /* Module reset, then master mode with the FIFO watermarks at their
+     lowest so that every frame raises a DMA request.*/
+  spip->lpspi->CR    = LPSPI_CR_RST_MASK;
+  spip->lpspi->CR    = 0U;
+  spip->lpspi->CFGR1 = LPSPI_CFGR1_MASTER_MASK;
+  spip->lpspi->CCR   = spip->config->ccr;
+  spip->lpspi->FCR   = LPSPI_FCR_TXWATER(0) | LPSPI_FCR_RXWATER(0);
+  spip->lpspi->DER   = 0U;
+  spip->lpspi->IER   = 0U;
+  spip->lpspi->CR    = LPSPI_CR_MEN_MASK;
+  spip->lpspi->TCR   = spip->config->tcr;
+
+  framesz = ((spip->config->tcr & LPSPI_TCR_FRAMESZ_MASK) >>
+             LPSPI_TCR_FRAMESZ_SHIFT) + 1U;
+  osalDbgAssert(framesz >= 8U, "invalid frame size");
+  if (framesz <= 8U)
+    spip->fsize = 1U;
+  else if (framesz <= 16U)
+    spip->fsize = 2U;
+  else
+    spip->fsize = 4U;
+
+  /* Idle frames are sent as ones.*/
+  spip->txdummy = 0xFFFFFFFFU;
+  cacheBufferFlush(&spip->txdummy, sizeof (spip->txdummy));
+
+  return HAL_RET_SUCCESS;
+}
+
+/**
+ * @brief   Deactivates the SPI peripheral.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_stop(SPIDriver *spip) {
+
+  /* If in ready state then disables the LPSPI clock.*/
+  if (spip->state == SPI_READY) {
+    spi_lld_stop_dma(spip);
+    spip->lpspi->CR = 0U;
+
+    edmaChannelFreeI(spip->dmarx);
+    edmaChannelFreeI(spip->dmatx);
+    spip->dmarx = NULL;
+    spip->dmatx = NULL;
+
+#if MIMXRT1062_SPI_USE_SPI0
+    if (&SPID1 == spip) {
+      CLOCK_DisableClock(kCLOCK_Lpspi1);
+    }
+#endif
+#if MIMXRT1062_SPI_USE_SPI1
+    if (&SPID2 == spip) {
+      CLOCK_DisableClock(kCLOCK_Lpspi2);
+    }
+#endif
+#if MIMXRT1062_SPI_USE_SPI2
+    if (&SPID3 == spip) {
+      CLOCK_DisableClock(kCLOCK_Lpspi3);
+    }
+#endif
+#if MIMXRT1062_SPI_USE_SPI3
+    if (&SPID4 == spip) {
+      CLOCK_DisableClock(kCLOCK_Lpspi4);
+    }
+#endif
+  }
+}
+
+/**
+ * @brief   Ignores data on the SPI bus.
+ * @details This asynchronous function starts the transmission of a series of
+ *          idle words on the SPI bus and ignores the received data.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to be ignored
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+msg_t spi_lld_ignore(SPIDriver *spip, size_t n) {
+
+  return spi_lld_start_dma(spip, n, NULL, NULL);
+}
+
+/**
+ * @brief   Exchanges data on the SPI bus.
+ * @details This asynchronous function starts a simultaneous transmit/receive
+ *          operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ * @note    The buffers are organized as uint8_t arrays for frames up to 8
+ *          bits, uint16_t arrays up to 16 bits and uint32_t arrays above.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to be exchanged
+ * @param[in] txbuf     the pointer to the transmit buffer
+ * @param[out] rxbuf    the pointer to the receive buffer
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+msg_t spi_lld_exchange(SPIDriver *spip, size_t n,
+                       const void *txbuf, void *rxbuf) {
+
+  return spi_lld_start_dma(spip, n, txbuf, rxbuf);
+}
+
+/**
+ * @brief   Sends data over the SPI bus.
+ * @details This asynchronous function starts a transmit operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+msg_t spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
+
+  return spi_lld_start_dma(spip, n, txbuf, NULL);
+}
+
+/**
+ * @brief   Receives data from the SPI bus.
+ * @details This asynchronous function starts a receive operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to receive
+ * @param[out] rxbuf    the pointer to the receive buffer
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+msg_t spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
+
+  return spi_lld_start_dma(spip, n, NULL, rxbuf);
+}
+
+/**
+ * @brief   Aborts the ongoing SPI operation, if any.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[out] sizep    pointer to the counter of frames not yet transferred
+ *                      or @p NULL
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+msg_t spi_lld_stop_transfer(SPIDriver *spip, size_t *sizep) {
+
+  spi_lld_stop_dma(spip);
+
+  if (sizep != NULL)
+    *sizep = edmaChainGetRemaining(spip->dmarx, spip->rxchain, spip->ntcd);
+
+  /* Frames left in the FIFOs are dropped, the TCR command with them.*/
+  spip->lpspi->CR |= LPSPI_CR_RTF_MASK | LPSPI_CR_RRF_MASK;
+  spip->lpspi->TCR = spip->config->tcr;
+
+  if (spip->rxbuf != NULL)
+    cacheBufferInvalidate(spip->rxbuf, spip->rxsize);
+
+  return HAL_RET_SUCCESS;
+}
+
+/**
+ * @brief   Exchanges one frame using a polled wait.
+ * @details This synchronous function exchanges one frame using a polled
+ *          synchronization method. This function is useful when exchanging
+ *          small amount of data on high speed channels, usually in this
+ *          situation is much more efficient just wait for completion using
+ *          polling than suspending the thread waiting for an interrupt.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] frame     the data frame to send over the SPI bus
+ * @return              The received data frame from the SPI bus.
+ *
+ * @notapi
+ */
+uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame) {
+
+  spip->lpspi->TDR = frame;
+  while ((spip->lpspi->RSR & LPSPI_RSR_RXEMPTY_MASK) != 0U)
+    ;
+  return (uint16_t)spip->lpspi->RDR;
+}
+
+#endif /* HAL_USE_SPI */
+
+/** @} */
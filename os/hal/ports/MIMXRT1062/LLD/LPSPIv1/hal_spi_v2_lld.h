@@ -0,0 +1,305 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LPSPIv1/hal_spi_v2_lld.h
+ * @brief   MIMXRT1062 LPSPI subsystem low level driver header.
+ *
+ * @addtogroup SPI
+ * @{
+ */
+
+#ifndef HAL_SPI_V2_LLD_H
+#define HAL_SPI_V2_LLD_H
+
+#if HAL_USE_SPI || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Circular mode support flag.
+ */
+#define SPI_SUPPORTS_CIRCULAR                   FALSE
+
+/**
+ * @brief   Slave mode support flag.
+ */
+#define SPI_SUPPORTS_SLAVE_MODE                 FALSE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   SPID1 driver enable switch.
+ * @details If set to @p TRUE the support for LPSPI1 is included.
+ */
+#if !defined(MIMXRT1062_SPI_USE_SPI0) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_USE_SPI0               FALSE
+#endif
+
+/**
+ * @brief   SPID2 driver enable switch.
+ * @details If set to @p TRUE the support for LPSPI2 is included.
+ */
+#if !defined(MIMXRT1062_SPI_USE_SPI1) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_USE_SPI1               FALSE
+#endif
+
+/**
+ * @brief   SPID3 driver enable switch.
+ * @details If set to @p TRUE the support for LPSPI3 is included.
+ */
+#if !defined(MIMXRT1062_SPI_USE_SPI2) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_USE_SPI2               FALSE
+#endif
+
+/**
+ * @brief   SPID4 driver enable switch.
+ * @details If set to @p TRUE the support for LPSPI4 is included.
+ */
+#if !defined(MIMXRT1062_SPI_USE_SPI3) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_USE_SPI3               FALSE
+#endif
+
+/**
+ * @brief   SPID1 DMA interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_SPI_SPI0_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI0_DMA_IRQ_PRIORITY  10
+#endif
+
+/**
+ * @brief   SPID2 DMA interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_SPI_SPI1_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI1_DMA_IRQ_PRIORITY  10
+#endif
+
+/**
+ * @brief   SPID3 DMA interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_SPI_SPI2_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI2_DMA_IRQ_PRIORITY  10
+#endif
+
+/**
+ * @brief   SPID4 DMA interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_SPI_SPI3_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI3_DMA_IRQ_PRIORITY  10
+#endif
+
+/**
+ * @brief   SPID1 DMA channels.
+ */
+#if !defined(MIMXRT1062_SPI_SPI0_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI0_RX_DMA_CHANNEL    MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+#if !defined(MIMXRT1062_SPI_SPI0_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI0_TX_DMA_CHANNEL    MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+
+/**
+ * @brief   SPID2 DMA channels.
+ */
+#if !defined(MIMXRT1062_SPI_SPI1_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI1_RX_DMA_CHANNEL    MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+#if !defined(MIMXRT1062_SPI_SPI1_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI1_TX_DMA_CHANNEL    MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+
+/**
+ * @brief   SPID3 DMA channels.
+ */
+#if !defined(MIMXRT1062_SPI_SPI2_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI2_RX_DMA_CHANNEL    MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+#if !defined(MIMXRT1062_SPI_SPI2_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI2_TX_DMA_CHANNEL    MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+
+/**
+ * @brief   SPID4 DMA channels.
+ */
+#if !defined(MIMXRT1062_SPI_SPI3_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI3_RX_DMA_CHANNEL    MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+#if !defined(MIMXRT1062_SPI_SPI3_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_SPI3_TX_DMA_CHANNEL    MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+
+/**
+ * @brief   Length of the TCD chains of a driver.
+ * @details A chain of N descriptors moves up to N * 32767 frames, longer
+ *          transfers are rejected.
+ */
+#if !defined(MIMXRT1062_SPI_DMA_CHAIN_LENGTH) || defined(__DOXYGEN__)
+#define MIMXRT1062_SPI_DMA_CHAIN_LENGTH         2
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if MIMXRT1062_SPI_USE_SPI0 && !MIMXRT1062_HAS_SPI0
+#error "LPSPI1 not present in the selected device"
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI1 && !MIMXRT1062_HAS_SPI1
+#error "LPSPI2 not present in the selected device"
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI2 && !MIMXRT1062_HAS_SPI2
+#error "LPSPI3 not present in the selected device"
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI3 && !MIMXRT1062_HAS_SPI3
+#error "LPSPI4 not present in the selected device"
+#endif
+
+#if !(MIMXRT1062_SPI_USE_SPI0 || MIMXRT1062_SPI_USE_SPI1 ||              \
+      MIMXRT1062_SPI_USE_SPI2 || MIMXRT1062_SPI_USE_SPI3)
+#error "SPI driver activated but no LPSPI peripheral assigned"
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI0 &&                                            \
+    !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_SPI_SPI0_DMA_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to LPSPI1 DMA"
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI1 &&                                            \
+    !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_SPI_SPI1_DMA_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to LPSPI2 DMA"
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI2 &&                                            \
+    !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_SPI_SPI2_DMA_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to LPSPI3 DMA"
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI3 &&                                            \
+    !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_SPI_SPI3_DMA_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to LPSPI4 DMA"
+#endif
+
+#if MIMXRT1062_SPI_DMA_CHAIN_LENGTH < 1
+#error "invalid MIMXRT1062_SPI_DMA_CHAIN_LENGTH setting"
+#endif
+
+#if SPI_SELECT_MODE == SPI_SELECT_MODE_LLD
+#error "SPI_SELECT_MODE_LLD not supported by this driver"
+#endif
+
+#if !defined(MIMXRT1062_EDMA_REQUIRED)
+#define MIMXRT1062_EDMA_REQUIRED
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the SPI driver structure.
+ */
+#define spi_lld_driver_fields                                               \
+  /* Pointer to the LPSPI registers block.*/                                \
+  LPSPI_Type                *lpspi;                                         \
+  /* DMAMUX request sources.*/                                              \
+  uint8_t                   rxsource;                                       \
+  uint8_t                   txsource;                                       \
+  /* Receive DMA channel.*/                                                 \
+  const mimxrt1062_edma_channel_t *dmarx;                                   \
+  /* Transmit DMA channel.*/                                                \
+  const mimxrt1062_edma_channel_t *dmatx;                                   \
+  /* Bytes per frame, 1, 2 or 4.*/                                          \
+  uint8_t                   fsize;                                          \
+  /* Descriptors used by the current transfer.*/                            \
+  uint8_t                   ntcd;                                           \
+  /* Receive buffer of the current transfer, invalidated at the end.*/      \
+  void                      *rxbuf;                                         \
+  size_t                    rxsize;                                         \
+  /* Sink and source of the ignored frames.*/                               \
+  uint32_t                  rxdummy;                                        \
+  uint32_t                  txdummy;                                        \
+  /* Scatter-gather chains.*/                                               \
+  MIMXRT1062_EDMA_TCD_CHAIN(rxchain, MIMXRT1062_SPI_DMA_CHAIN_LENGTH);      \
+  MIMXRT1062_EDMA_TCD_CHAIN(txchain, MIMXRT1062_SPI_DMA_CHAIN_LENGTH)
+
+/**
+ * @brief   Low level fields of the SPI configuration structure.
+ */
+#define spi_lld_config_fields                                               \
+  /* Initialization value of the CCR register, SCK dividers and delays.*/   \
+  uint32_t                  ccr;                                            \
+  /* Initialization value of the TCR register, mode, prescaler, PCS and     \
+     frame size.*/                                                          \
+  uint32_t                  tcr
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if MIMXRT1062_SPI_USE_SPI0 && !defined(__DOXYGEN__)
+extern SPIDriver SPID1;
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI1 && !defined(__DOXYGEN__)
+extern SPIDriver SPID2;
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI2 && !defined(__DOXYGEN__)
+extern SPIDriver SPID3;
+#endif
+
+#if MIMXRT1062_SPI_USE_SPI3 && !defined(__DOXYGEN__)
+extern SPIDriver SPID4;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void spi_lld_init(void);
+  msg_t spi_lld_start(SPIDriver *spip);
+  void spi_lld_stop(SPIDriver *spip);
+  msg_t spi_lld_ignore(SPIDriver *spip, size_t n);
+  msg_t spi_lld_exchange(SPIDriver *spip, size_t n,
+                         const void *txbuf, void *rxbuf);
+  msg_t spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf);
+  msg_t spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf);
+  msg_t spi_lld_stop_transfer(SPIDriver *spip, size_t *sizep);
+  uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SPI */
+
+#endif /* HAL_SPI_V2_LLD_H */
+
+/** @} */
@@ -1,13 +1,20 @@
-UARTSRC = ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/UARTv1/hal_serial_lld.c \
-          ${CHIBIOS_CONTRIB}/ext/mcux-sdk/drivers/lpuart/fsl_lpuart.c \
-          ${CHIBIOS_CONTRIB}/ext/mcux-sdk/devices/MIMXRT1062/drivers/fsl_clock.c
+LPUARTSRC = ${CHIBIOS_CONTRIB}/ext/mcux-sdk/drivers/lpuart/fsl_lpuart.c \
+            ${CHIBIOS_CONTRIB}/ext/mcux-sdk/devices/MIMXRT1062/drivers/fsl_clock.c
 
 ifeq ($(USE_SMART_BUILD),yes)
 ifneq ($(findstring HAL_USE_SERIAL TRUE,$(HALCONF)),)
-PLATFORMSRC_CONTRIB += $(UARTSRC)
+PLATFORMSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/UARTv1/hal_serial_lld.c
+UARTSRC = $(LPUARTSRC)
+endif
+ifneq ($(findstring HAL_USE_UART TRUE,$(HALCONF)),)
+PLATFORMSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/UARTv1/hal_uart_lld.c
+UARTSRC = $(LPUARTSRC)
 endif
-else
 PLATFORMSRC_CONTRIB += $(UARTSRC)
+else
+PLATFORMSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/UARTv1/hal_serial_lld.c \
+                       ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/UARTv1/hal_uart_lld.c \
+                       $(LPUARTSRC)
 endif
 
 PLATFORMINC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/UARTv1 \
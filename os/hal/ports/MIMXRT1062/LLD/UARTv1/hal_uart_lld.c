@@ -0,0 +1,617 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    UARTv1/hal_uart_lld.c
+ * @brief   MIMXRT1062 LPUART DMA UART subsystem low level driver source.
+ * @note    Both directions run on eDMA channels, the CPU is interrupted
+ *          once per buffer. Characters received out of a receive operation
+ *          are served by the LPUART interrupt.
+ * @note    Buffers in cacheable memory must be aligned and padded to the
+ *          cache line size, the receive buffer is invalidated before and
+ *          after the operation.
+ *
+ * @addtogroup UART
+ * @{
+ */
+
+#include "hal.h"
+
+#if HAL_USE_UART || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define LPUART_STAT_ERRORS          (LPUART_STAT_OR_MASK | LPUART_STAT_NF_MASK | \
+                                     LPUART_STAT_FE_MASK | LPUART_STAT_PF_MASK)
+
+#define LPUART_CTRL_ERRORS          (LPUART_CTRL_ORIE_MASK |                \
+                                     LPUART_CTRL_NEIE_MASK |                \
+                                     LPUART_CTRL_FEIE_MASK |                \
+                                     LPUART_CTRL_PEIE_MASK)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief UART0 UART driver identifier.*/
+#if MIMXRT1062_UART_USE_UART0 || defined(__DOXYGEN__)
+UARTDriver UARTD1;
+#endif
+
+/** @brief UART1 UART driver identifier.*/
+#if MIMXRT1062_UART_USE_UART1 || defined(__DOXYGEN__)
+UARTDriver UARTD2;
+#endif
+
+/** @brief UART2 UART driver identifier.*/
+#if MIMXRT1062_UART_USE_UART2 || defined(__DOXYGEN__)
+UARTDriver UARTD3;
+#endif
+
+/** @brief UART3 UART driver identifier.*/
+#if MIMXRT1062_UART_USE_UART3 || defined(__DOXYGEN__)
+UARTDriver UARTD4;
+#endif
+
+/** @brief UART4 UART driver identifier.*/
+#if MIMXRT1062_UART_USE_UART4 || defined(__DOXYGEN__)
+UARTDriver UARTD5;
+#endif
+
+/** @brief UART5 UART driver identifier.*/
+#if MIMXRT1062_UART_USE_UART5 || defined(__DOXYGEN__)
+UARTDriver UARTD6;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+// See also:
+// https://github.com/adafruit/circuitpython/blob/main/ports/mimxrt10xx/supervisor/serial.c
+static uint32_t UartSrcFreq(void) {
+    uint32_t freq;
+
+    /* To make it simple, we assume default PLL and divider settings, and the only variable
+         from application is use PLL3 source or OSC source */
+    /* PLL3 div6 80M */
+    if (CLOCK_GetMux(kCLOCK_UartMux) == 0) {
+        freq = (CLOCK_GetPllFreq(kCLOCK_PllUsb1) / 6U) / (CLOCK_GetDiv(kCLOCK_UartDiv) + 1U);
+    } else {
+        freq = CLOCK_GetOscFreq() / (CLOCK_GetDiv(kCLOCK_UartDiv) + 1U);
+    }
+
+    return freq;
+}
+
+/**
+ * @brief   Status bits translation.
+ *
+ * @param[in] stat      LPUART STAT register value
+ * @return              The error flags.
+ */
+static uartflags_t translate_errors(uint32_t stat) {
+  uartflags_t sts = 0;
+
+  if ((stat & LPUART_STAT_OR_MASK) != 0U)
+    sts |= UART_OVERRUN_ERROR;
+  if ((stat & LPUART_STAT_PF_MASK) != 0U)
+    sts |= UART_PARITY_ERROR;
+  if ((stat & LPUART_STAT_FE_MASK) != 0U)
+    sts |= UART_FRAMING_ERROR;
+  if ((stat & LPUART_STAT_NF_MASK) != 0U)
+    sts |= UART_NOISE_ERROR;
+  return sts;
+}
+
+/**
+ * @brief   Puts the receiver in the UART_RX_IDLE state.
+ * @details Characters are received one at a time by the LPUART interrupt
+ *          and passed to the @p rxchar_cb callback.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+static void uart_enter_rx_idle_loop(UARTDriver *uartp) {
+
+  uartp->lpuart->BAUD &= ~LPUART_BAUD_RDMAE_MASK;
+  uartp->lpuart->CTRL |= LPUART_CTRL_RIE_MASK;
+}
+
+/**
+ * @brief   Starts a DMA chain between a buffer and the data register.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] chp       channel
+ * @param[out] chain    descriptors
+ * @param[in] n         number of bytes
+ * @param[in] tx        transmit direction
+ * @param[in] buf       buffer
+ * @return              The number of descriptors used.
+ */
+static unsigned uart_start_dma(UARTDriver *uartp,
+                               const mimxrt1062_edma_channel_t *chp,
+                               mimxrt1062_edma_tcd_t *chain,
+                               size_t n, bool tx, void *buf) {
+  mimxrt1062_edma_tcd_t tmpl;
+  uint32_t data = (uint32_t)&uartp->lpuart->DATA;
+  unsigned ntcd;
+
+  tmpl.saddr  = tx ? (uint32_t)buf : data;
+  tmpl.soff   = tx ? 1 : 0;
+  tmpl.attr   = MIMXRT1062_EDMA_TCD_ATTR(MIMXRT1062_EDMA_SIZE_8BITS,
+                                         MIMXRT1062_EDMA_SIZE_8BITS);
+  tmpl.nbytes = 1U;
+  tmpl.daddr  = tx ? data : (uint32_t)buf;
+  tmpl.doff   = tx ? 0 : 1;
+  tmpl.csr    = MIMXRT1062_EDMA_TCD_CSR_INTMAJOR;
+  ntcd = edmaChainInit(chain, MIMXRT1062_UART_DMA_CHAIN_LENGTH, &tmpl, n);
+  osalDbgAssert(ntcd > 0U, "buffer too large");
+
+  edmaChannelLoadTCD(chp, &chain[0]);
+  edmaChannelEnable(chp);
+
+  return ntcd;
+}
+
+/**
+ * @brief   RX DMA common service routine.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] flags     eDMA callback flags
+ */
+static void uart_lld_serve_rx_end_irq(UARTDriver *uartp, uint32_t flags) {
+
+  uartp->lpuart->BAUD &= ~LPUART_BAUD_RDMAE_MASK;
+  cacheBufferInvalidate(uartp->rxdmabuf, uartp->rxdmasize);
+
+  if ((flags & MIMXRT1062_EDMA_FLAG_ERROR) != 0U) {
+    uart_enter_rx_idle_loop(uartp);
+    _uart_rx_error_isr_code(uartp, UART_OVERRUN_ERROR);
+    return;
+  }
+
+  _uart_rx_complete_isr_code(uartp);
+
+  /* The callback could have started a new receive operation.*/
+  if (uartp->rxstate == UART_RX_IDLE)
+    uart_enter_rx_idle_loop(uartp);
+}
+
+/**
+ * @brief   TX DMA common service routine.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] flags     eDMA callback flags
+ */
+static void uart_lld_serve_tx_end_irq(UARTDriver *uartp, uint32_t flags) {
+
+  (void)flags;
+
+  uartp->lpuart->BAUD &= ~LPUART_BAUD_TDMAE_MASK;
+
+  /* A callback is generated, if enabled, after a completed transfer.*/
+  uartp->lpuart->CTRL |= LPUART_CTRL_TCIE_MASK;
+  _uart_tx1_isr_code(uartp);
+}
+
+/**
+ * @brief   LPUART common service routine.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+static void serve_lpuart_irq(UARTDriver *uartp) {
+  LPUART_Type *u = uartp->lpuart;
+  uint32_t ctrl = u->CTRL;
+  uint32_t stat = u->STAT;
+
+  /* Clearing the write-one-to-clear flags read.*/
+  u->STAT = stat;
+
+  if ((stat & LPUART_STAT_ERRORS) != 0U) {
+    _uart_rx_error_isr_code(uartp, translate_errors(stat));
+  }
+
+  if ((ctrl & LPUART_CTRL_RIE_MASK) != 0U) {
+    while ((u->WATER & LPUART_WATER_RXCOUNT_MASK) != 0U) {
+      uartp->rxbuf = (uint16_t)(u->DATA & 0x3FFU);
+      _uart_rx_idle_code(uartp);
+    }
+  }
+
+  if (((stat & LPUART_STAT_IDLE_MASK) != 0U) &&
+      ((ctrl & LPUART_CTRL_ILIE_MASK) != 0U)) {
+    _uart_timeout_isr_code(uartp);
+  }
+
+  if (((stat & LPUART_STAT_TC_MASK) != 0U) &&
+      ((ctrl & LPUART_CTRL_TCIE_MASK) != 0U)) {
+    u->CTRL &= ~LPUART_CTRL_TCIE_MASK;
+    _uart_tx2_isr_code(uartp);
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+#if MIMXRT1062_UART_USE_UART0 || defined(__DOXYGEN__)
+/**
+ * @brief   LPUART1 IRQ handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(MIMXRT1062_SERIAL0_IRQ_VECTOR) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  serve_lpuart_irq(&UARTD1);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif
+
+#if MIMXRT1062_UART_USE_UART1 || defined(__DOXYGEN__)
+/**
+ * @brief   LPUART2 IRQ handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(MIMXRT1062_SERIAL1_IRQ_VECTOR) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  serve_lpuart_irq(&UARTD2);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif
+
+#if MIMXRT1062_UART_USE_UART2 || defined(__DOXYGEN__)
+/**
+ * @brief   LPUART3 IRQ handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(MIMXRT1062_SERIAL2_IRQ_VECTOR) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  serve_lpuart_irq(&UARTD3);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif
+
+#if MIMXRT1062_UART_USE_UART3 || defined(__DOXYGEN__)
+/**
+ * @brief   LPUART4 IRQ handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(MIMXRT1062_SERIAL3_IRQ_VECTOR) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  serve_lpuart_irq(&UARTD4);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif
+
+#if MIMXRT1062_UART_USE_UART4 || defined(__DOXYGEN__)
+/**
+ * @brief   LPUART5 IRQ handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(MIMXRT1062_SERIAL4_IRQ_VECTOR) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  serve_lpuart_irq(&UARTD5);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif
+
+#if MIMXRT1062_UART_USE_UART5 || defined(__DOXYGEN__)
+/**
+ * @brief   LPUART6 IRQ handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(MIMXRT1062_SERIAL5_IRQ_VECTOR) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  serve_lpuart_irq(&UARTD6);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level UART driver initialization.
+ *
+ * @notapi
+ */
+void uart_lld_init(void) {
+
+#if MIMXRT1062_UART_USE_UART0
+  uartObjectInit(&UARTD1);
+  UARTD1.lpuart   = LPUART1;
+  UARTD1.irq      = LPUART1_IRQn;
+  UARTD1.rxsource = (uint8_t)kDmaRequestMuxLPUART1Rx;
+  UARTD1.txsource = (uint8_t)kDmaRequestMuxLPUART1Tx;
+#endif
+
+#if MIMXRT1062_UART_USE_UART1
+  uartObjectInit(&UARTD2);
+  UARTD2.lpuart   = LPUART2;
+  UARTD2.irq      = LPUART2_IRQn;
+  UARTD2.rxsource = (uint8_t)kDmaRequestMuxLPUART2Rx;
+  UARTD2.txsource = (uint8_t)kDmaRequestMuxLPUART2Tx;
+#endif
+
+#if MIMXRT1062_UART_USE_UART2
+  uartObjectInit(&UARTD3);
+  UARTD3.lpuart   = LPUART3;
+  UARTD3.irq      = LPUART3_IRQn;
+  UARTD3.rxsource = (uint8_t)kDmaRequestMuxLPUART3Rx;
+  UARTD3.txsource = (uint8_t)kDmaRequestMuxLPUART3Tx;
+#endif
+
+#if MIMXRT1062_UART_USE_UART3
+  uartObjectInit(&UARTD4);
+  UARTD4.lpuart   = LPUART4;
+  UARTD4.irq      = LPUART4_IRQn;
+  UARTD4.rxsource = (uint8_t)kDmaRequestMuxLPUART4Rx;
+  UARTD4.txsource = (uint8_t)kDmaRequestMuxLPUART4Tx;
+#endif
+
+#if MIMXRT1062_UART_USE_UART4
+  uartObjectInit(&UARTD5);
+  UARTD5.lpuart   = LPUART5;
+  UARTD5.irq      = LPUART5_IRQn;
+  UARTD5.rxsource = (uint8_t)kDmaRequestMuxLPUART5Rx;
+  UARTD5.txsource = (uint8_t)kDmaRequestMuxLPUART5Tx;
+#endif
+
+#if MIMXRT1062_UART_USE_UART5
+  uartObjectInit(&UARTD6);
+  UARTD6.lpuart   = LPUART6;
+  UARTD6.irq      = LPUART6_IRQn;
+  UARTD6.rxsource = (uint8_t)kDmaRequestMuxLPUART6Rx;
+  UARTD6.txsource = (uint8_t)kDmaRequestMuxLPUART6Tx;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the UART peripheral.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @notapi
+ */
+void uart_lld_start(UARTDriver *uartp) {
+  lpuart_config_t uconfig;
+  uint32_t prio = 0U, dmaprio = 0U, rxid = 0U, txid = 0U;
+
+  if (uartp->state == UART_STOP) {
+#if MIMXRT1062_UART_USE_UART0
+    if (&UARTD1 == uartp) {
+      IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_12] = 2; // Arduino pin 24
+      IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_13] = 2; // Arduino pin 25
+      prio    = MIMXRT1062_UART_UART0_IRQ_PRIORITY;
+      dmaprio = MIMXRT1062_UART_UART0_DMA_IRQ_PRIORITY;
+      rxid    = MIMXRT1062_UART_UART0_RX_DMA_CHANNEL;
+      txid    = MIMXRT1062_UART_UART0_TX_DMA_CHANNEL;
+    }
+#endif
+#if MIMXRT1062_UART_USE_UART1
+    if (&UARTD2 == uartp) {
+      prio    = MIMXRT1062_UART_UART1_IRQ_PRIORITY;
+      dmaprio = MIMXRT1062_UART_UART1_DMA_IRQ_PRIORITY;
+      rxid    = MIMXRT1062_UART_UART1_RX_DMA_CHANNEL;
+      txid    = MIMXRT1062_UART_UART1_TX_DMA_CHANNEL;
+    }
+#endif
+#if MIMXRT1062_UART_USE_UART2
+    if (&UARTD3 == uartp) {
+      IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B1_06] = 2; // Arduino pin 17
+      prio    = MIMXRT1062_UART_UART2_IRQ_PRIORITY;
+      dmaprio = MIMXRT1062_UART_UART2_DMA_IRQ_PRIORITY;
+      rxid    = MIMXRT1062_UART_UART2_RX_DMA_CHANNEL;
+      txid    = MIMXRT1062_UART_UART2_TX_DMA_CHANNEL;
+    }
+#endif
+#if MIMXRT1062_UART_USE_UART3
+    if (&UARTD4 == uartp) {
+      prio    = MIMXRT1062_UART_UART3_IRQ_PRIORITY;
+      dmaprio = MIMXRT1062_UART_UART3_DMA_IRQ_PRIORITY;
+      rxid    = MIMXRT1062_UART_UART3_RX_DMA_CHANNEL;
+      txid    = MIMXRT1062_UART_UART3_TX_DMA_CHANNEL;
+    }
+#endif
+#if MIMXRT1062_UART_USE_UART4
+    if (&UARTD5 == uartp) {
+      prio    = MIMXRT1062_UART_UART4_IRQ_PRIORITY;
+      dmaprio = MIMXRT1062_UART_UART4_DMA_IRQ_PRIORITY;
+      rxid    = MIMXRT1062_UART_UART4_RX_DMA_CHANNEL;
+      txid    = MIMXRT1062_UART_UART4_TX_DMA_CHANNEL;
+    }
+#endif
+#if MIMXRT1062_UART_USE_UART5
+    if (&UARTD6 == uartp) {
+      prio    = MIMXRT1062_UART_UART5_IRQ_PRIORITY;
+      dmaprio = MIMXRT1062_UART_UART5_DMA_IRQ_PRIORITY;
+      rxid    = MIMXRT1062_UART_UART5_RX_DMA_CHANNEL;
+      txid    = MIMXRT1062_UART_UART5_TX_DMA_CHANNEL;
+    }
+#endif
+    uartp->dmarx = edmaChannelAllocI(rxid, dmaprio,
+                                     (mimxrt1062_edmaisr_t)uart_lld_serve_rx_end_irq,
+                                     (void *)uartp);
+    osalDbgAssert(uartp->dmarx != NULL, "unable to allocate channel");
+    uartp->dmatx = edmaChannelAllocI(txid, dmaprio,
+                                     (mimxrt1062_edmaisr_t)uart_lld_serve_tx_end_irq,
+                                     (void *)uartp);
+    osalDbgAssert(uartp->dmatx != NULL, "unable to allocate channel");
+    edmaChannelSetSource(uartp->dmarx, uartp->rxsource);
+    edmaChannelSetSource(uartp->dmatx, uartp->txsource);
+
+    nvicEnableVector(uartp->irq, prio);
+  }
+
+  /* The FIFOs are enabled by the SDK, a request is raised for every byte
+     with the default watermarks.*/
+  LPUART_GetDefaultConfig(&uconfig);
+  uconfig.baudRate_Bps = uartp->config->speed;
+  uconfig.parityMode   = uartp->config->parity;
+  uconfig.stopBitCount = uartp->config->stopbits;
+  uconfig.enableTx     = true;
+  uconfig.enableRx     = true;
+  LPUART_Init(uartp->lpuart, &uconfig, UartSrcFreq());
+
+  uartp->lpuart->CTRL |= LPUART_CTRL_ERRORS;
+  if (uartp->config->timeout_cb != NULL)
+    uartp->lpuart->CTRL |= LPUART_CTRL_ILIE_MASK;
+
+  uartp->rxbuf = 0U;
+  uart_enter_rx_idle_loop(uartp);
+}
+
+/**
+ * @brief   Deactivates the UART peripheral.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @notapi
+ */
+void uart_lld_stop(UARTDriver *uartp) {
+
+  if (uartp->state == UART_READY) {
+    edmaChannelDisable(uartp->dmarx);
+    edmaChannelDisable(uartp->dmatx);
+    edmaChannelFreeI(uartp->dmarx);
+    edmaChannelFreeI(uartp->dmatx);
+    uartp->dmarx = NULL;
+    uartp->dmatx = NULL;
+
+    nvicDisableVector(uartp->irq);
+    LPUART_Deinit(uartp->lpuart);
+  }
+}
+
+/**
+ * @brief   Starts a transmission on the UART peripheral.
+ * @note    The buffers are organized as uint8_t arrays, 9 bits data is not
+ *          supported.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         number of data frames to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ *
+ * @notapi
+ */
+void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf) {
+
+  cacheBufferFlush(txbuf, n);
+  uartp->ntxtcd = (uint8_t)uart_start_dma(uartp, uartp->dmatx,
+                                          uartp->txchain, n, true,
+                                          (void *)txbuf);
+  uartp->lpuart->BAUD |= LPUART_BAUD_TDMAE_MASK;
+}
+
+/**
+ * @brief   Stops any ongoing transmission.
+ * @note    Stopping a transmission also suppresses the transmission callbacks.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @return              The number of data frames not transmitted by the
+ *                      stopped transmit operation.
+ *
+ * @notapi
+ */
+size_t uart_lld_stop_send(UARTDriver *uartp) {
+
+  uartp->lpuart->BAUD &= ~LPUART_BAUD_TDMAE_MASK;
+  uartp->lpuart->CTRL &= ~LPUART_CTRL_TCIE_MASK;
+  edmaChannelDisable(uartp->dmatx);
+
+  return edmaChainGetRemaining(uartp->dmatx, uartp->txchain, uartp->ntxtcd);
+}
+
+/**
+ * @brief   Starts a receive operation on the UART peripheral.
+ * @note    The buffers are organized as uint8_t arrays, 9 bits data is not
+ *          supported.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         number of data frames to receive
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf) {
+
+  uartp->lpuart->CTRL &= ~LPUART_CTRL_RIE_MASK;
+
+  uartp->rxdmabuf  = rxbuf;
+  uartp->rxdmasize = n;
+  cacheBufferInvalidate(rxbuf, n);
+  uartp->nrxtcd = (uint8_t)uart_start_dma(uartp, uartp->dmarx,
+                                          uartp->rxchain, n, false, rxbuf);
+  uartp->lpuart->BAUD |= LPUART_BAUD_RDMAE_MASK;
+}
+
+/**
+ * @brief   Stops any ongoing receive operation.
+ * @note    Stopping a receive operation also suppresses the receive callbacks.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @return              The number of data frames not received by the
+ *                      stopped receive operation.
+ *
+ * @notapi
+ */
+size_t uart_lld_stop_receive(UARTDriver *uartp) {
+  size_t n;
+
+  uartp->lpuart->BAUD &= ~LPUART_BAUD_RDMAE_MASK;
+  edmaChannelDisable(uartp->dmarx);
+  n = edmaChainGetRemaining(uartp->dmarx, uartp->rxchain, uartp->nrxtcd);
+  cacheBufferInvalidate(uartp->rxdmabuf, uartp->rxdmasize);
+  uart_enter_rx_idle_loop(uartp);
+
+  return n;
+}
+
+#endif /* HAL_USE_UART */
+
+/** @} */
@@ -0,0 +1,560 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    UARTv1/hal_uart_lld.h
+ * @brief   MIMXRT1062 LPUART DMA UART subsystem low level driver header.
+ *
+ * @addtogroup UART
+ * @{
+ */
+
+#ifndef HAL_UART_LLD_H
+#define HAL_UART_LLD_H
+
+#if HAL_USE_UART || defined(__DOXYGEN__)
+
+#include "fsl_lpuart.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   UARTD1 driver enable switch.
+ * @details If set to @p TRUE the support for LPUART1 is included.
+ */
+#if !defined(MIMXRT1062_UART_USE_UART0) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_USE_UART0             FALSE
+#endif
+
+/**
+ * @brief   UARTD2 driver enable switch.
+ * @details If set to @p TRUE the support for LPUART2 is included.
+ */
+#if !defined(MIMXRT1062_UART_USE_UART1) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_USE_UART1             FALSE
+#endif
+
+/**
+ * @brief   UARTD3 driver enable switch.
+ * @details If set to @p TRUE the support for LPUART3 is included.
+ */
+#if !defined(MIMXRT1062_UART_USE_UART2) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_USE_UART2             FALSE
+#endif
+
+/**
+ * @brief   UARTD4 driver enable switch.
+ * @details If set to @p TRUE the support for LPUART4 is included.
+ */
+#if !defined(MIMXRT1062_UART_USE_UART3) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_USE_UART3             FALSE
+#endif
+
+/**
+ * @brief   UARTD5 driver enable switch.
+ * @details If set to @p TRUE the support for LPUART5 is included.
+ */
+#if !defined(MIMXRT1062_UART_USE_UART4) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_USE_UART4             FALSE
+#endif
+
+/**
+ * @brief   UARTD6 driver enable switch.
+ * @details If set to @p TRUE the support for LPUART6 is included.
+ */
+#if !defined(MIMXRT1062_UART_USE_UART5) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_USE_UART5             FALSE
+#endif
+
+/**
+ * @brief   UART0 interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART0_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART0_IRQ_PRIORITY    12
+#endif
+
+/**
+ * @brief   UART1 interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART1_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART1_IRQ_PRIORITY    12
+#endif
+
+/**
+ * @brief   UART2 interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART2_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART2_IRQ_PRIORITY    12
+#endif
+
+/**
+ * @brief   UART3 interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART3_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART3_IRQ_PRIORITY    12
+#endif
+
+/**
+ * @brief   UART4 interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART4_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART4_IRQ_PRIORITY    12
+#endif
+
+/**
+ * @brief   UART5 interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART5_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART5_IRQ_PRIORITY    12
+#endif
+
+/**
+ * @brief   UART0 DMA interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART0_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART0_DMA_IRQ_PRIORITY 12
+#endif
+
+/**
+ * @brief   UART1 DMA interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART1_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART1_DMA_IRQ_PRIORITY 12
+#endif
+
+/**
+ * @brief   UART2 DMA interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART2_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART2_DMA_IRQ_PRIORITY 12
+#endif
+
+/**
+ * @brief   UART3 DMA interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART3_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART3_DMA_IRQ_PRIORITY 12
+#endif
+
+/**
+ * @brief   UART4 DMA interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART4_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART4_DMA_IRQ_PRIORITY 12
+#endif
+
+/**
+ * @brief   UART5 DMA interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_UART_UART5_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART5_DMA_IRQ_PRIORITY 12
+#endif
+
+/**
+ * @brief   UART0 DMA channels.
+ */
+#if !defined(MIMXRT1062_UART_UART0_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART0_RX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+#if !defined(MIMXRT1062_UART_UART0_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART0_TX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+
+/**
+ * @brief   UART1 DMA channels.
+ */
+#if !defined(MIMXRT1062_UART_UART1_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART1_RX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+#if !defined(MIMXRT1062_UART_UART1_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART1_TX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+
+/**
+ * @brief   UART2 DMA channels.
+ */
+#if !defined(MIMXRT1062_UART_UART2_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART2_RX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+#if !defined(MIMXRT1062_UART_UART2_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART2_TX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+
+/**
+ * @brief   UART3 DMA channels.
+ */
+#if !defined(MIMXRT1062_UART_UART3_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART3_RX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+#if !defined(MIMXRT1062_UART_UART3_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART3_TX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+
+/**
+ * @brief   UART4 DMA channels.
+ */
+#if !defined(MIMXRT1062_UART_UART4_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART4_RX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+#if !defined(MIMXRT1062_UART_UART4_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART4_TX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+
+/**
+ * @brief   UART5 DMA channels.
+ */
+#if !defined(MIMXRT1062_UART_UART5_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART5_RX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+#if !defined(MIMXRT1062_UART_UART5_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_UART5_TX_DMA_CHANNEL  MIMXRT1062_EDMA_CHANNEL_ID_ANY
+#endif
+
+/**
+ * @brief   Length of the TCD chains of a driver.
+ * @details A chain of N descriptors moves up to N * 32767 bytes, longer
+ *          buffers are rejected.
+ */
+#if !defined(MIMXRT1062_UART_DMA_CHAIN_LENGTH) || defined(__DOXYGEN__)
+#define MIMXRT1062_UART_DMA_CHAIN_LENGTH        2
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if MIMXRT1062_UART_USE_UART0 && !MIMXRT1062_HAS_SERIAL0
+#error "UART0 not present in the selected device"
+#endif
+
+#if MIMXRT1062_UART_USE_UART1 && !MIMXRT1062_HAS_SERIAL1
+#error "UART1 not present in the selected device"
+#endif
+
+#if MIMXRT1062_UART_USE_UART2 && !MIMXRT1062_HAS_SERIAL2
+#error "UART2 not present in the selected device"
+#endif
+
+#if MIMXRT1062_UART_USE_UART3 && !MIMXRT1062_HAS_SERIAL3
+#error "UART3 not present in the selected device"
+#endif
+
+#if MIMXRT1062_UART_USE_UART4 && !MIMXRT1062_HAS_SERIAL4
+#error "UART4 not present in the selected device"
+#endif
+
+#if MIMXRT1062_UART_USE_UART5 && !MIMXRT1062_HAS_SERIAL5
+#error "UART5 not present in the selected device"
+#endif
+
+#if !(MIMXRT1062_UART_USE_UART0 || MIMXRT1062_UART_USE_UART1 ||            \
+      MIMXRT1062_UART_USE_UART2 || MIMXRT1062_UART_USE_UART3 ||            \
+      MIMXRT1062_UART_USE_UART4 || MIMXRT1062_UART_USE_UART5)
+#error "UART driver activated but no LPUART peripheral assigned"
+#endif
+
+#if MIMXRT1062_UART_USE_UART0 && HAL_USE_SERIAL && MIMXRT1062_SERIAL_USE_UART0
+#error "UART0 already in use by the serial driver"
+#endif
+
+#if MIMXRT1062_UART_USE_UART1 && HAL_USE_SERIAL && MIMXRT1062_SERIAL_USE_UART1
+#error "UART1 already in use by the serial driver"
+#endif
+
+#if MIMXRT1062_UART_USE_UART2 && HAL_USE_SERIAL && MIMXRT1062_SERIAL_USE_UART2
+#error "UART2 already in use by the serial driver"
+#endif
+
+#if MIMXRT1062_UART_USE_UART3 && HAL_USE_SERIAL && MIMXRT1062_SERIAL_USE_UART3
+#error "UART3 already in use by the serial driver"
+#endif
+
+#if MIMXRT1062_UART_USE_UART4 && HAL_USE_SERIAL && MIMXRT1062_SERIAL_USE_UART4
+#error "UART4 already in use by the serial driver"
+#endif
+
+#if MIMXRT1062_UART_USE_UART5 && HAL_USE_SERIAL && MIMXRT1062_SERIAL_USE_UART5
+#error "UART5 already in use by the serial driver"
+#endif
+
+#if MIMXRT1062_UART_USE_UART0 &&                                          \
+    !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_UART_UART0_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to UART0"
+#endif
+
+#if MIMXRT1062_UART_USE_UART1 &&                                          \
+    !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_UART_UART1_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to UART1"
+#endif
+
+#if MIMXRT1062_UART_USE_UART2 &&                                          \
+    !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_UART_UART2_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to UART2"
+#endif
+
+#if MIMXRT1062_UART_USE_UART3 &&                                          \
+    !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_UART_UART3_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to UART3"
+#endif
+
+#if MIMXRT1062_UART_USE_UART4 &&                                          \
+    !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_UART_UART4_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to UART4"
+#endif
+
+#if MIMXRT1062_UART_USE_UART5 &&                                          \
+    !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_UART_UART5_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to UART5"
+#endif
+
+#if MIMXRT1062_UART_DMA_CHAIN_LENGTH < 1
+#error "invalid MIMXRT1062_UART_DMA_CHAIN_LENGTH setting"
+#endif
+
+#if !defined(MIMXRT1062_EDMA_REQUIRED)
+#define MIMXRT1062_EDMA_REQUIRED
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   UART driver condition flags type.
+ */
+typedef uint32_t uartflags_t;
+
+/**
+ * @brief   Type of an UART driver.
+ */
+typedef struct hal_uart_driver UARTDriver;
+
+/**
+ * @brief   Generic UART notification callback type.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+typedef void (*uartcb_t)(UARTDriver *uartp);
+
+/**
+ * @brief   Character received UART notification callback type.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] c         received character
+ */
+typedef void (*uartccb_t)(UARTDriver *uartp, uint16_t c);
+
+/**
+ * @brief   Receive error UART notification callback type.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] e         receive error mask
+ */
+typedef void (*uartecb_t)(UARTDriver *uartp, uartflags_t e);
+
+/**
+ * @brief   Type of an UART configuration structure.
+ */
+typedef struct hal_uart_config {
+  /**
+   * @brief End of transmission buffer callback.
+   */
+  uartcb_t                  txend1_cb;
+  /**
+   * @brief Physical end of transmission callback.
+   */
+  uartcb_t                  txend2_cb;
+  /**
+   * @brief Receive buffer filled callback.
+   */
+  uartcb_t                  rxend_cb;
+  /**
+   * @brief Character received while out if the @p UART_RECEIVE state.
+   */
+  uartccb_t                 rxchar_cb;
+  /**
+   * @brief Receive error callback.
+   */
+  uartecb_t                 rxerr_cb;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Receiver timeout callback.
+   * @details Invoked on the idle line interrupt, the interrupt is enabled
+   *          only if the callback is set.
+   */
+  uartcb_t                  timeout_cb;
+  /**
+   * @brief Bit rate.
+   */
+  uint32_t                  speed;
+  /**
+   * @brief Parity mode.
+   */
+  lpuart_parity_mode_t      parity;
+  /**
+   * @brief Number of stop bits.
+   */
+  lpuart_stop_bit_count_t   stopbits;
+} UARTConfig;
+
+/**
+ * @brief   Structure representing an UART driver.
+ */
+struct hal_uart_driver {
+  /**
+   * @brief Driver state.
+   */
+  uartstate_t               state;
+  /**
+   * @brief Transmitter state.
+   */
+  uarttxstate_t             txstate;
+  /**
+   * @brief Receiver state.
+   */
+  uartrxstate_t             rxstate;
+  /**
+   * @brief Current configuration data.
+   */
+  const UARTConfig          *config;
+#if (UART_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Synchronization flag for transmit operations.
+   */
+  bool                      early;
+  /**
+   * @brief   Waiting thread on RX.
+   */
+  thread_reference_t        threadrx;
+  /**
+   * @brief   Waiting thread on TX.
+   */
+  thread_reference_t        threadtx;
+#endif /* UART_USE_WAIT */
+#if (UART_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the peripheral.
+   */
+  mutex_t                   mutex;
+#endif /* UART_USE_MUTUAL_EXCLUSION */
+#if defined(UART_DRIVER_EXT_FIELDS)
+  UART_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Pointer to the LPUART registers block.
+   */
+  LPUART_Type               *lpuart;
+  /**
+   * @brief LPUART IRQ number.
+   */
+  IRQn_Type                 irq;
+  /**
+   * @brief DMAMUX request sources.
+   */
+  uint8_t                   rxsource;
+  uint8_t                   txsource;
+  /**
+   * @brief Receive DMA channel.
+   */
+  const mimxrt1062_edma_channel_t *dmarx;
+  /**
+   * @brief Transmit DMA channel.
+   */
+  const mimxrt1062_edma_channel_t *dmatx;
+  /**
+   * @brief Descriptors used by the current operations.
+   */
+  uint8_t                   nrxtcd;
+  uint8_t                   ntxtcd;
+  /**
+   * @brief Buffer of the current receive operation.
+   */
+  void                      *rxdmabuf;
+  size_t                    rxdmasize;
+  /**
+   * @brief Last character received while into @p UART_RX_IDLE state.
+   */
+  volatile uint16_t         rxbuf;
+  /**
+   * @brief Scatter-gather chains.
+   */
+  MIMXRT1062_EDMA_TCD_CHAIN(rxchain, MIMXRT1062_UART_DMA_CHAIN_LENGTH);
+  MIMXRT1062_EDMA_TCD_CHAIN(txchain, MIMXRT1062_UART_DMA_CHAIN_LENGTH);
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if MIMXRT1062_UART_USE_UART0 && !defined(__DOXYGEN__)
+extern UARTDriver UARTD1;
+#endif
+
+#if MIMXRT1062_UART_USE_UART1 && !defined(__DOXYGEN__)
+extern UARTDriver UARTD2;
+#endif
+
+#if MIMXRT1062_UART_USE_UART2 && !defined(__DOXYGEN__)
+extern UARTDriver UARTD3;
+#endif
+
+#if MIMXRT1062_UART_USE_UART3 && !defined(__DOXYGEN__)
+extern UARTDriver UARTD4;
+#endif
+
+#if MIMXRT1062_UART_USE_UART4 && !defined(__DOXYGEN__)
+extern UARTDriver UARTD5;
+#endif
+
+#if MIMXRT1062_UART_USE_UART5 && !defined(__DOXYGEN__)
+extern UARTDriver UARTD6;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void uart_lld_init(void);
+  void uart_lld_start(UARTDriver *uartp);
+  void uart_lld_stop(UARTDriver *uartp);
+  void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf);
+  size_t uart_lld_stop_send(UARTDriver *uartp);
+  void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf);
+  size_t uart_lld_stop_receive(UARTDriver *uartp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_UART */
+
+#endif /* HAL_UART_LLD_H */
+
+/** @} */
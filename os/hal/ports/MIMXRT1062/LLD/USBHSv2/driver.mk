@@ -0,0 +1,16 @@
+HAL_USB_SRC = ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/USBHSv2/hal_usb_lld.c \
+              ${CHIBIOS_CONTRIB}/ext/nxp-middleware-usb/phy/usb_phy.c
+
+ifeq ($(USE_SMART_BUILD),yes)
+ifneq ($(findstring HAL_USE_USB TRUE,$(HALCONF)),)
+PLATFORMSRC_CONTRIB += ${HAL_USB_SRC}
+endif
+else
+PLATFORMSRC_CONTRIB += ${HAL_USB_SRC}
+endif
+
+PLATFORMINC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/USBHSv2 \
+                       ${CHIBIOS_CONTRIB}/ext/nxp-middleware-usb/include \
+                       ${CHIBIOS_CONTRIB}/ext/nxp-middleware-usb/phy \
+                       ${CHIBIOS_CONTRIB}/ext/mcux-sdk/components/osa \
+                       ${CHIBIOS_CONTRIB}/ext/mcux-sdk/components/lists
@@ -0,0 +1,777 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    USBHSv2/hal_usb_lld.c
+ * @brief   MIMXRT1062 native EHCI USB device low level driver source.
+ * @note    Chapter 42 "Universal Serial Bus Controller (USB)" of the i.MX RT
+ *          1060 reference manual, device data structures and operational
+ *          model.
+ *
+ * @addtogroup USB
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#include "usb.h"
+#include "usb_phy.h"
+#include "fsl_clock.h"
+
+#if HAL_USE_USB || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define EP_DIR_OUT                  0U
+#define EP_DIR_IN                   1U
+
+/* Bit of an endpoint in ENDPTPRIME, ENDPTFLUSH, ENDPTSTAT, ENDPTCOMPLETE.*/
+#define EP_BIT(ep, dir)             (1U << ((ep) + ((dir) == EP_DIR_IN ? 16U : 0U)))
+
+/* Terminate bit of the dTD link pointers.*/
+#define DTD_TERMINATE               (1U << 0)
+
+/* dTD token.*/
+#define DTD_TOKEN_ACTIVE            (1U << 7)
+#define DTD_TOKEN_HALTED            (1U << 6)
+#define DTD_TOKEN_BUFERR            (1U << 5)
+#define DTD_TOKEN_XACTERR           (1U << 3)
+#define DTD_TOKEN_ERRORS            (DTD_TOKEN_HALTED | DTD_TOKEN_BUFERR |  \
+                                     DTD_TOKEN_XACTERR)
+#define DTD_TOKEN_IOC               (1U << 15)
+#define DTD_TOKEN_TOTAL(n)          ((uint32_t)(n) << 16)
+#define DTD_TOKEN_GET_TOTAL(t)      (((t) >> 16) & 0x7FFFU)
+
+/* dQH capabilities.*/
+#define DQH_CAP_IOS                 (1U << 15)
+#define DQH_CAP_MAXPKT(n)           ((uint32_t)(n) << 16)
+#define DQH_CAP_ZLT_OFF             (1U << 29)
+#define DQH_CAP_MULT(n)             ((uint32_t)(n) << 30)
+
+#ifndef BOARD_USB_PHY_D_CAL
+#define BOARD_USB_PHY_D_CAL         (0x0CU)
+#endif
+#ifndef BOARD_USB_PHY_TXCAL45DP
+#define BOARD_USB_PHY_TXCAL45DP     (0x06U)
+#endif
+#ifndef BOARD_USB_PHY_TXCAL45DM
+#define BOARD_USB_PHY_TXCAL45DM     (0x06U)
+#endif
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief USB1 driver identifier.*/
+#if MIMXRT1062_USB_USE_USB1 || defined(__DOXYGEN__)
+USBDriver USBD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Device transfer descriptor, one cache line.
+ */
+typedef struct {
+  volatile uint32_t             next;
+  volatile uint32_t             token;
+  volatile uint32_t             buf[5];
+  /* Not used by the controller, bytes queued in this dTD.*/
+  uint32_t                      length;
+} ehci_dtd_t;
+
+/**
+ * @brief   Device queue head, two cache lines.
+ */
+typedef struct {
+  volatile uint32_t             cap;
+  volatile uint32_t             current;
+  /* Transfer overlay.*/
+  volatile uint32_t             next;
+  volatile uint32_t             token;
+  volatile uint32_t             buf[5];
+  uint32_t                      reserved;
+  volatile uint8_t              setup[8];
+  uint32_t                      unused[4];
+} ehci_dqh_t;
+
+/**
+ * @brief   Transfer in progress on an endpoint direction.
+ */
+typedef struct {
+  uint8_t                       *buf;
+  size_t                        size;
+  /* Bytes transferred by the retired dTDs.*/
+  size_t                        done;
+  /* dTDs of the current chain and the ones already retired.*/
+  uint8_t                       ndtd;
+  uint8_t                       retired;
+} ehci_xfer_t;
+
+/**
+ * @brief   Queue heads, OUT and IN of each endpoint.
+ * @note    The list must be 2kB aligned.
+ */
+static ehci_dqh_t dqh[USB_MAX_ENDPOINTS + 1][2] __attribute__((aligned(2048)));
+
+/**
+ * @brief   Transfer descriptors, one chain per endpoint direction.
+ */
+static ehci_dtd_t dtd[USB_MAX_ENDPOINTS + 1][2][MIMXRT1062_USB_DTD_PER_EP]
+    __attribute__((aligned(32)));
+
+static ehci_xfer_t xfer[USB_MAX_ENDPOINTS + 1][2];
+
+/**
+ * @brief   IN EP0 state.
+ */
+static USBInEndpointState ep0in;
+
+/**
+ * @brief   OUT EP0 state.
+ */
+static USBOutEndpointState ep0out;
+
+/**
+ * @brief   Last setup packet, read by @p usb_lld_read_setup().
+ */
+static uint8_t ep0setup_buffer[8];
+
+/**
+ * @brief   EP0 initialization structure.
+ */
+static const USBEndpointConfig ep0config = {
+  USB_EP_MODE_TYPE_CTRL,
+  _usb_ep0setup,
+  _usb_ep0in,
+  _usb_ep0out,
+  64,
+  64,
+  &ep0in,
+  &ep0out,
+  1,
+  ep0setup_buffer
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static volatile uint32_t *ep_ctrl(usbep_t ep) {
+
+  return (ep == 0U) ? &USB1->ENDPTCTRL0 : &USB1->ENDPTCTRL[ep - 1U];
+}
+
+/**
+ * @brief   Cancels the dTDs primed on an endpoint direction.
+ */
+static void ep_flush(uint32_t bits) {
+
+  do {
+    USB1->ENDPTFLUSH = bits;
+    while ((USB1->ENDPTFLUSH & bits) != 0U)
+      ;
+  } while ((USB1->ENDPTSTAT & bits) != 0U);
+}
+
+/**
+ * @brief   Sets up an endpoint direction queue head.
+ */
+static void ep_setup_dqh(usbep_t ep, unsigned dir, uint32_t type,
+                         uint16_t maxsize) {
+  ehci_dqh_t *qhp = &dqh[ep][dir];
+
+  memset(qhp, 0, sizeof(ehci_dqh_t));
+  qhp->cap = DQH_CAP_MAXPKT(maxsize) | DQH_CAP_ZLT_OFF;
+  if ((ep == 0U) && (dir == EP_DIR_OUT))
+    qhp->cap |= DQH_CAP_IOS;
+  if (type == USB_EP_MODE_TYPE_ISOC)
+    qhp->cap |= DQH_CAP_MULT(1);
+  qhp->next = DTD_TERMINATE;
+  cacheBufferFlush(qhp, sizeof(ehci_dqh_t));
+
+  xfer[ep][dir].ndtd = 0;
+}
+
+/**
+ * @brief   Queues the next chain of dTDs of a transfer and primes it.
+ * @details The transfer is split in dTDs of at most
+ *          @p MIMXRT1062_USB_DTD_MAX_SIZE bytes. IN chains interrupt on the
+ *          last dTD only. OUT chains interrupt on every dTD because a short
+ *          packet ends the transfer in the middle of the chain.
+ */
+static void ep_start(usbep_t ep, unsigned dir) {
+  ehci_xfer_t *xp = &xfer[ep][dir];
+  ehci_dqh_t *qhp = &dqh[ep][dir];
+  ehci_dtd_t *tdp = dtd[ep][dir];
+  uint32_t addr = (uint32_t)xp->buf + xp->done;
+  size_t n = xp->size - xp->done;
+  unsigned i = 0;
+
+  do {
+    size_t len = (n > MIMXRT1062_USB_DTD_MAX_SIZE) ?
+                 MIMXRT1062_USB_DTD_MAX_SIZE : n;
+    unsigned k;
+
+    tdp[i].next   = DTD_TERMINATE;
+    tdp[i].token  = DTD_TOKEN_TOTAL(len) | DTD_TOKEN_ACTIVE |
+                    ((dir == EP_DIR_OUT) ? DTD_TOKEN_IOC : 0U);
+    tdp[i].buf[0] = addr;
+    for (k = 1; k < 5; k++)
+      tdp[i].buf[k] = (addr & ~0xFFFU) + (k * 0x1000U);
+    tdp[i].length = len;
+    if (i > 0U)
+      tdp[i - 1U].next = (uint32_t)&tdp[i];
+
+    addr += len;
+    n -= len;
+    i++;
+  } while ((n > 0U) && (i < MIMXRT1062_USB_DTD_PER_EP));
+  tdp[i - 1U].token |= DTD_TOKEN_IOC;
+
+  xp->ndtd    = (uint8_t)i;
+  xp->retired = 0;
+  cacheBufferFlush(tdp, i * sizeof(ehci_dtd_t));
+
+  /* The endpoint is idle, the overlay is pointed to the new chain.*/
+  qhp->next  = (uint32_t)&tdp[0];
+  qhp->token = 0;
+  cacheBufferFlush(qhp, sizeof(ehci_dqh_t));
+
+  USB1->ENDPTPRIME = EP_BIT(ep, dir);
+}
+
+/**
+ * @brief   Retires the completed dTDs of an endpoint direction.
+ * @details Queues the next chain if the transfer is longer than one chain,
+ *          invokes the endpoint callback once the transfer is over.
+ */
+static void ep_complete(USBDriver *usbp, usbep_t ep, unsigned dir) {
+  ehci_xfer_t *xp = &xfer[ep][dir];
+  const USBEndpointConfig *epc = usbp->epc[ep];
+  bool ended = false;
+
+  if ((xp->ndtd == 0U) || (epc == NULL))
+    return;
+
+  while (xp->retired < xp->ndtd) {
+    ehci_dtd_t *tdp = &dtd[ep][dir][xp->retired];
+    uint32_t token, left;
+
+    cacheBufferInvalidate(tdp, sizeof(ehci_dtd_t));
+    token = tdp->token;
+    if ((token & DTD_TOKEN_ACTIVE) != 0U)
+      return;
+
+    left = DTD_TOKEN_GET_TOTAL(token);
+    xp->done += tdp->length - left;
+    xp->retired++;
+
+    /* Short packet or error, the transfer is over.*/
+    if ((left != 0U) || ((token & DTD_TOKEN_ERRORS) != 0U)) {
+      ended = true;
+      break;
+    }
+  }
+
+  if (!ended && (xp->done < xp->size)) {
+    ep_start(ep, dir);
+    return;
+  }
+
+  /* Drops the dTDs left after a short packet.*/
+  if (xp->retired < xp->ndtd)
+    ep_flush(EP_BIT(ep, dir));
+  xp->ndtd = 0;
+
+  if (dir == EP_DIR_OUT) {
+    epc->out_state->rxcnt = xp->done;
+    cacheBufferInvalidate(xp->buf, xp->done);
+    _usb_isr_invoke_out_cb(usbp, ep);
+  }
+  else {
+    epc->in_state->txcnt = xp->done;
+    _usb_isr_invoke_in_cb(usbp, ep);
+  }
+}
+
+/**
+ * @brief   Reads a setup packet and hands it to the upper layer.
+ */
+static void ep0_setup(USBDriver *usbp) {
+  ehci_dqh_t *qhp = &dqh[0][EP_DIR_OUT];
+
+  USB1->ENDPTSETUPSTAT = 1U;
+
+  /* The setup tripwire guards against a new setup packet overwriting the
+     buffer while it is read.*/
+  do {
+    USB1->USBCMD |= EHCI_USBCMD_SUTW;
+    cacheBufferInvalidate(qhp, sizeof(ehci_dqh_t));
+    memcpy(ep0setup_buffer, (const void *)qhp->setup, 8);
+  } while ((USB1->USBCMD & EHCI_USBCMD_SUTW) == 0U);
+  USB1->USBCMD &= ~EHCI_USBCMD_SUTW;
+
+  /* A setup packet aborts any transfer of the previous control request.*/
+  ep_flush(EP_BIT(0, EP_DIR_OUT) | EP_BIT(0, EP_DIR_IN));
+  xfer[0][EP_DIR_OUT].ndtd = 0;
+  xfer[0][EP_DIR_IN].ndtd  = 0;
+  usbp->receiving    &= ~1U;
+  usbp->transmitting &= ~1U;
+
+  _usb_isr_invoke_setup_cb(usbp, 0);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+#if MIMXRT1062_USB_USE_USB1 || defined(__DOXYGEN__)
+
+/**
+ * @brief   USB interrupt handler.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(MIMXRT1062_USB_OTG1_IRQ_VECTOR) {
+  USBDriver *usbp = &USBD1;
+  uint32_t sts;
+
+  OSAL_IRQ_PROLOGUE();
+
+  sts = USB1->USBSTS & USB1->USBINTR;
+  USB1->USBSTS = sts;
+
+  /* Bus reset, all the primed transfers are cancelled.*/
+  if ((sts & EHCI_USBSTS_URI) != 0U) {
+    USB1->ENDPTSETUPSTAT = USB1->ENDPTSETUPSTAT;
+    USB1->ENDPTCOMPLETE  = USB1->ENDPTCOMPLETE;
+    while (USB1->ENDPTPRIME != 0U)
+      ;
+    USB1->ENDPTFLUSH = 0xFFFFFFFFU;
+    _usb_reset(usbp);
+  }
+
+  if ((sts & EHCI_USBSTS_SLI) != 0U)
+    _usb_suspend(usbp);
+
+  if ((sts & EHCI_USBSTS_PCI) != 0U) {
+    if ((usbp->state == USB_SUSPENDED) &&
+        ((USB1->PORTSC1 & EHCI_PORTSC1_SUSP) == 0U))
+      _usb_wakeup(usbp);
+  }
+
+  if ((sts & (EHCI_USBSTS_UI | EHCI_USBSTS_UEI)) != 0U) {
+    uint32_t complete = USB1->ENDPTCOMPLETE;
+    usbep_t ep;
+
+    USB1->ENDPTCOMPLETE = complete;
+    for (ep = 0; ep <= USB_MAX_ENDPOINTS; ep++) {
+      if ((complete & EP_BIT(ep, EP_DIR_OUT)) != 0U)
+        ep_complete(usbp, ep, EP_DIR_OUT);
+      if ((complete & EP_BIT(ep, EP_DIR_IN)) != 0U)
+        ep_complete(usbp, ep, EP_DIR_IN);
+    }
+
+    if ((USB1->ENDPTSETUPSTAT & 1U) != 0U)
+      ep0_setup(usbp);
+  }
+
+  if ((sts & EHCI_USBSTS_SRI) != 0U)
+    _usb_isr_invoke_sof_cb(usbp);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif /* MIMXRT1062_USB_USE_USB1 */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level USB driver initialization.
+ *
+ * @notapi
+ */
+void usb_lld_init(void) {
+
+#if MIMXRT1062_USB_USE_USB1
+  /* Driver initialization.*/
+  usbObjectInit(&USBD1);
+#endif /* MIMXRT1062_USB_USE_USB1 */
+}
+
+/**
+ * @brief   Configures and activates the USB peripheral.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_start(USBDriver *usbp) {
+
+  if (usbp->state == USB_STOP) {
+#if MIMXRT1062_USB_USE_USB1
+    if (&USBD1 == usbp) {
+      usb_phy_config_struct_t phyConfig = {
+        BOARD_USB_PHY_D_CAL, BOARD_USB_PHY_TXCAL45DP, BOARD_USB_PHY_TXCAL45DM,
+      };
+
+      CLOCK_EnableUsbhs0PhyPllClock(kCLOCK_Usbphy480M, 480000000U);
+      CLOCK_EnableUsbhs0Clock(kCLOCK_Usb480M, 480000000U);
+      USB_EhciPhyInit(kUSB_ControllerEhci0, 0U, &phyConfig);
+
+      /* Controller reset, then device mode with the setup lockout off as
+         the setup tripwire is used.*/
+      USB1->USBCMD |= EHCI_USBCMD_RST;
+      while ((USB1->USBCMD & EHCI_USBCMD_RST) != 0U)
+        ;
+      USB1->USBMODE = EHCI_USBMODE_CM_DEVICE | EHCI_USBMODE_SLOM;
+#if MIMXRT1062_USB_USE_HS == FALSE
+      USB1->PORTSC1 |= EHCI_PORTSC1_PFSC;
+#endif
+
+      /* Interrupts are not delayed, one per completed chain.*/
+      USB1->USBCMD &= ~EHCI_USBCMD_ITC_MASK;
+
+      memset(dqh, 0, sizeof(dqh));
+      cacheBufferFlush(dqh, sizeof(dqh));
+      USB1->ENDPTLISTADDR = (uint32_t)dqh;
+
+      USB1->USBINTR = EHCI_USBINTR_UE | EHCI_USBINTR_UEE | EHCI_USBINTR_PCE |
+                      EHCI_USBINTR_URE | EHCI_USBINTR_SLE;
+      if (usbp->config->sof_cb != NULL)
+        USB1->USBINTR |= EHCI_USBINTR_SRE;
+
+      nvicEnableVector(USB_OTG1_IRQn, MIMXRT1062_USB_USB1_IRQ_PRIORITY);
+    }
+#endif /* MIMXRT1062_USB_USE_USB1 */
+  }
+}
+
+/**
+ * @brief   Deactivates the USB peripheral.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_stop(USBDriver *usbp) {
+
+  if (usbp->state != USB_STOP) {
+#if MIMXRT1062_USB_USE_USB1
+    if (&USBD1 == usbp) {
+      nvicDisableVector(USB_OTG1_IRQn);
+      USB1->USBINTR = 0;
+      USB1->USBCMD &= ~EHCI_USBCMD_RS;
+      ep_flush(0xFFFFFFFFU);
+      USB_EhciPhyDeinit(kUSB_ControllerEhci0);
+    }
+#endif /* MIMXRT1062_USB_USE_USB1 */
+  }
+}
+
+/**
+ * @brief   USB low level reset routine.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_reset(USBDriver *usbp) {
+  usbep_t ep;
+
+  USB1->DEVICEADDR = 0;
+
+  for (ep = 1; ep <= USB_MAX_ENDPOINTS; ep++) {
+    *ep_ctrl(ep) = 0;
+    xfer[ep][EP_DIR_OUT].ndtd = 0;
+    xfer[ep][EP_DIR_IN].ndtd  = 0;
+  }
+
+  /* EP0 initialization.*/
+  usbp->epc[0] = &ep0config;
+  ep_setup_dqh(0, EP_DIR_OUT, USB_EP_MODE_TYPE_CTRL, ep0config.out_maxsize);
+  ep_setup_dqh(0, EP_DIR_IN, USB_EP_MODE_TYPE_CTRL, ep0config.in_maxsize);
+}
+
+/**
+ * @brief   Sets the USB address.
+ * @note    The controller switches to the new address after the status
+ *          stage of the request.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_set_address(USBDriver *usbp) {
+
+  USB1->DEVICEADDR = EHCI_DEVICEADDR_USBADR(usbp->address) |
+                     EHCI_DEVICEADDR_USBADRA;
+}
+
+/**
+ * @brief   Enables an endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep) {
+  const USBEndpointConfig *epc = usbp->epc[ep];
+  uint32_t type = epc->ep_mode & USB_EP_MODE_TYPE;
+  uint32_t ctrl;
+
+  osalDbgAssert(ep <= USB_MAX_ENDPOINTS, "invalid endpoint");
+
+  if (ep == 0U)
+    return;
+
+  /* An unused direction must not be left as a control endpoint.*/
+  ctrl = EHCI_ENDPTCTRL_RXT(USB_EP_MODE_TYPE_BULK) |
+         EHCI_ENDPTCTRL_TXT(USB_EP_MODE_TYPE_BULK);
+
+  if (epc->out_state != NULL) {
+    ep_setup_dqh(ep, EP_DIR_OUT, type, epc->out_maxsize);
+    ctrl = (ctrl & ~EHCI_ENDPTCTRL_RXT(3U)) | EHCI_ENDPTCTRL_RXT(type) |
+           EHCI_ENDPTCTRL_RXR | EHCI_ENDPTCTRL_RXE;
+  }
+
+  if (epc->in_state != NULL) {
+    ep_setup_dqh(ep, EP_DIR_IN, type, epc->in_maxsize);
+    ctrl = (ctrl & ~EHCI_ENDPTCTRL_TXT(3U)) | EHCI_ENDPTCTRL_TXT(type) |
+           EHCI_ENDPTCTRL_TXR | EHCI_ENDPTCTRL_TXE;
+  }
+
+  *ep_ctrl(ep) = ctrl;
+}
+
+/**
+ * @brief   Disables all the active endpoints except the endpoint zero.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_disable_endpoints(USBDriver *usbp) {
+  usbep_t ep;
+
+  (void)usbp;
+
+  /* All but the EP0 bits.*/
+  ep_flush(0xFFFEFFFEU);
+  for (ep = 1; ep <= USB_MAX_ENDPOINTS; ep++) {
+    *ep_ctrl(ep) = 0;
+    xfer[ep][EP_DIR_OUT].ndtd = 0;
+    xfer[ep][EP_DIR_IN].ndtd  = 0;
+  }
+}
+
+/**
+ * @brief   Returns the status of an OUT endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The endpoint status.
+ * @retval EP_STATUS_DISABLED The endpoint is not active.
+ * @retval EP_STATUS_STALLED  The endpoint is stalled.
+ * @retval EP_STATUS_ACTIVE   The endpoint is active.
+ *
+ * @notapi
+ */
+usbepstatus_t usb_lld_get_status_out(USBDriver *usbp, usbep_t ep) {
+  uint32_t ctrl;
+
+  (void)usbp;
+
+  if (ep > USB_MAX_ENDPOINTS)
+    return EP_STATUS_DISABLED;
+
+  ctrl = *ep_ctrl(ep);
+  if ((ep != 0U) && ((ctrl & EHCI_ENDPTCTRL_RXE) == 0U))
+    return EP_STATUS_DISABLED;
+  if ((ctrl & EHCI_ENDPTCTRL_RXS) != 0U)
+    return EP_STATUS_STALLED;
+  return EP_STATUS_ACTIVE;
+}
+
+/**
+ * @brief   Returns the status of an IN endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The endpoint status.
+ * @retval EP_STATUS_DISABLED The endpoint is not active.
+ * @retval EP_STATUS_STALLED  The endpoint is stalled.
+ * @retval EP_STATUS_ACTIVE   The endpoint is active.
+ *
+ * @notapi
+ */
+usbepstatus_t usb_lld_get_status_in(USBDriver *usbp, usbep_t ep) {
+  uint32_t ctrl;
+
+  (void)usbp;
+
+  if (ep > USB_MAX_ENDPOINTS)
+    return EP_STATUS_DISABLED;
+
+  ctrl = *ep_ctrl(ep);
+  if ((ep != 0U) && ((ctrl & EHCI_ENDPTCTRL_TXE) == 0U))
+    return EP_STATUS_DISABLED;
+  if ((ctrl & EHCI_ENDPTCTRL_TXS) != 0U)
+    return EP_STATUS_STALLED;
+  return EP_STATUS_ACTIVE;
+}
+
+/**
+ * @brief   Reads a setup packet from the dedicated packet buffer.
+ * @details This function must be invoked in the context of the @p setup_cb
+ *          callback in order to read the received setup packet.
+ * @pre     In order to use this function the endpoint must have been
+ *          initialized as a control endpoint.
+ * @post    The endpoint is ready to accept another packet.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @param[out] buf      buffer where to copy the packet data
+ *
+ * @notapi
+ */
+void usb_lld_read_setup(USBDriver *usbp, usbep_t ep, uint8_t *buf) {
+
+  (void)usbp;
+  (void)ep;
+
+  memcpy(buf, ep0setup_buffer, 8);
+}
+
+/**
+ * @brief   Starts a receive operation on an OUT endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_start_out(USBDriver *usbp, usbep_t ep) {
+  USBOutEndpointState *osp = usbp->epc[ep]->out_state;
+  ehci_xfer_t *xp = &xfer[ep][EP_DIR_OUT];
+
+  xp->buf  = osp->rxbuf;
+  xp->size = osp->rxsize;
+  xp->done = 0;
+
+  /* No dirty line may be written back over the received data.*/
+  if (osp->rxsize > 0U)
+    cacheBufferFlush(osp->rxbuf, osp->rxsize);
+
+  ep_start(ep, EP_DIR_OUT);
+}
+
+/**
+ * @brief   Starts a transmit operation on an IN endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_start_in(USBDriver *usbp, usbep_t ep) {
+  USBInEndpointState *isp = usbp->epc[ep]->in_state;
+  ehci_xfer_t *xp = &xfer[ep][EP_DIR_IN];
+
+  xp->buf  = (uint8_t *)isp->txbuf;
+  xp->size = isp->txsize;
+  xp->done = 0;
+
+  if (isp->txsize > 0U)
+    cacheBufferFlush(isp->txbuf, isp->txsize);
+
+  ep_start(ep, EP_DIR_IN);
+}
+
+/**
+ * @brief   Brings an OUT endpoint in the stalled state.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_stall_out(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+
+  *ep_ctrl(ep) |= EHCI_ENDPTCTRL_RXS;
+}
+
+/**
+ * @brief   Brings an IN endpoint in the stalled state.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_stall_in(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+
+  *ep_ctrl(ep) |= EHCI_ENDPTCTRL_TXS;
+}
+
+/**
+ * @brief   Brings an OUT endpoint in the active state.
+ * @note    The data toggle is reset as required after a halt.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_clear_out(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+
+  *ep_ctrl(ep) = (*ep_ctrl(ep) & ~EHCI_ENDPTCTRL_RXS) | EHCI_ENDPTCTRL_RXR;
+}
+
+/**
+ * @brief   Brings an IN endpoint in the active state.
+ * @note    The data toggle is reset as required after a halt.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_clear_in(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+
+  *ep_ctrl(ep) = (*ep_ctrl(ep) & ~EHCI_ENDPTCTRL_TXS) | EHCI_ENDPTCTRL_TXR;
+}
+
+#endif /* HAL_USE_USB */
+
+/** @} */
@@ -0,0 +1,506 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    USBHSv2/hal_usb_lld.h
+ * @brief   MIMXRT1062 native EHCI USB device low level driver header.
+ *
+ * @addtogroup USB
+ * @{
+ */
+
+#ifndef HAL_USB_LLD_H_
+#define HAL_USB_LLD_H_
+
+#if HAL_USE_USB || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum endpoint address.
+ */
+#define USB_MAX_ENDPOINTS                   7
+
+/**
+ * @brief   Status stage handling method.
+ */
+#define USB_EP0_STATUS_STAGE                USB_EP0_STATUS_STAGE_SW
+
+/**
+ * @brief   Address ack handling
+ */
+#define USB_SET_ADDRESS_ACK_HANDLING        USB_SET_ADDRESS_ACK_SW
+
+/**
+ * @brief   The address is written early, the controller applies it after
+ *          the status stage (DEVICEADDR.USBADRA).
+ */
+#define USB_SET_ADDRESS_MODE                USB_EARLY_SET_ADDRESS
+
+/**
+ * @brief   Largest transfer described by one dTD.
+ * @note    A multiple of every packet size so that no packet straddles
+ *          two dTDs, it always fits the five 4kB pages of a dTD.
+ */
+#define MIMXRT1062_USB_DTD_MAX_SIZE         16384U
+
+/**
+ * @name    EHCI device controller register bits
+ * @{
+ */
+#define EHCI_USBCMD_RS                      (1U << 0)
+#define EHCI_USBCMD_RST                     (1U << 1)
+#define EHCI_USBCMD_SUTW                    (1U << 13)
+#define EHCI_USBCMD_ATDTW                   (1U << 14)
+#define EHCI_USBCMD_ITC_MASK                (0xFFU << 16)
+
+#define EHCI_USBSTS_UI                      (1U << 0)
+#define EHCI_USBSTS_UEI                     (1U << 1)
+#define EHCI_USBSTS_PCI                     (1U << 2)
+#define EHCI_USBSTS_URI                     (1U << 6)
+#define EHCI_USBSTS_SRI                     (1U << 7)
+#define EHCI_USBSTS_SLI                     (1U << 8)
+
+#define EHCI_USBINTR_UE                     (1U << 0)
+#define EHCI_USBINTR_UEE                    (1U << 1)
+#define EHCI_USBINTR_PCE                    (1U << 2)
+#define EHCI_USBINTR_URE                    (1U << 6)
+#define EHCI_USBINTR_SRE                    (1U << 7)
+#define EHCI_USBINTR_SLE                    (1U << 8)
+
+#define EHCI_DEVICEADDR_USBADRA             (1U << 24)
+#define EHCI_DEVICEADDR_USBADR(n)           ((uint32_t)(n) << 25)
+
+#define EHCI_PORTSC1_FPR                    (1U << 6)
+#define EHCI_PORTSC1_SUSP                   (1U << 7)
+#define EHCI_PORTSC1_PR                     (1U << 8)
+#define EHCI_PORTSC1_HSP                    (1U << 9)
+#define EHCI_PORTSC1_PFSC                   (1U << 24)
+
+#define EHCI_USBMODE_CM_DEVICE              (2U << 0)
+#define EHCI_USBMODE_SLOM                   (1U << 3)
+
+#define EHCI_ENDPTCTRL_RXS                  (1U << 0)
+#define EHCI_ENDPTCTRL_RXT(t)               ((uint32_t)(t) << 2)
+#define EHCI_ENDPTCTRL_RXR                  (1U << 6)
+#define EHCI_ENDPTCTRL_RXE                  (1U << 7)
+#define EHCI_ENDPTCTRL_TXS                  (1U << 16)
+#define EHCI_ENDPTCTRL_TXT(t)               ((uint32_t)(t) << 18)
+#define EHCI_ENDPTCTRL_TXR                  (1U << 22)
+#define EHCI_ENDPTCTRL_TXE                  (1U << 23)
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   USB1 driver enable switch.
+ * @details If set to @p TRUE the support for USB1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(MIMXRT1062_USB_USE_USB1) || defined(__DOXYGEN__)
+#define MIMXRT1062_USB_USE_USB1             TRUE
+#endif
+
+/**
+ * @brief   USB1 interrupt priority level setting.
+ */
+#if !defined(MIMXRT1062_USB_USB1_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define MIMXRT1062_USB_USB1_IRQ_PRIORITY    3
+#endif
+
+/**
+ * @brief   Number of dTDs chained per endpoint direction.
+ * @details A transfer up to @p MIMXRT1062_USB_DTD_MAX_SIZE times this value
+ *          is queued as a single descriptor chain, longer transfers are
+ *          queued again chain by chain.
+ */
+#if !defined(MIMXRT1062_USB_DTD_PER_EP) || defined(__DOXYGEN__)
+#define MIMXRT1062_USB_DTD_PER_EP           4
+#endif
+
+/**
+ * @brief   High speed enable switch.
+ * @details If set to @p FALSE the controller is forced to full speed.
+ */
+#if !defined(MIMXRT1062_USB_USE_HS) || defined(__DOXYGEN__)
+#define MIMXRT1062_USB_USE_HS               TRUE
+#endif
+
+/**
+ * @brief   Host wake-up procedure duration.
+ */
+#if !defined(USB_HOST_WAKEUP_DURATION) || defined(__DOXYGEN__)
+#define USB_HOST_WAKEUP_DURATION            2
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if MIMXRT1062_USB_USE_USB1 && !MIMXRT1062_HAS_USB
+#error "USB not present in the selected device"
+#endif
+
+#if !MIMXRT1062_USB_USE_USB1
+#error "USB driver activated but no USB peripheral assigned"
+#endif
+
+#if MIMXRT1062_USB_USE_USB1 &&                                              \
+    !OSAL_IRQ_IS_VALID_PRIORITY(MIMXRT1062_USB_USB1_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to MIMXRT1062_USB_USB1_IRQ_PRIORITY"
+#endif
+
+#if !defined(MIMXRT1062_USB_OTG1_IRQ_VECTOR)
+#error "MIMXRT1062_USB_OTG1_IRQ_VECTOR not defined"
+#endif
+
+#if (MIMXRT1062_USB_DTD_PER_EP < 1) || (MIMXRT1062_USB_DTD_PER_EP > 255)
+#error "invalid MIMXRT1062_USB_DTD_PER_EP setting"
+#endif
+
+#if (USB_HOST_WAKEUP_DURATION < 2) || (USB_HOST_WAKEUP_DURATION > 15)
+#error "invalid USB_HOST_WAKEUP_DURATION setting, it must be between 2 and 15"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of an IN endpoint state structure.
+ */
+typedef struct {
+  /**
+   * @brief   Requested transmit transfer size.
+   */
+  size_t                        txsize;
+  /**
+   * @brief   Transmitted bytes so far.
+   */
+  size_t                        txcnt;
+  /**
+   * @brief   Pointer to the transmission linear buffer.
+   */
+  const uint8_t                 *txbuf;
+#if (USB_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Waiting thread.
+   */
+  thread_reference_t            thread;
+#endif
+} USBInEndpointState;
+
+/**
+ * @brief   Type of an OUT endpoint state structure.
+ */
+typedef struct {
+  /**
+   * @brief   Requested receive transfer size.
+   */
+  size_t                        rxsize;
+  /**
+   * @brief   Received bytes so far.
+   */
+  size_t                        rxcnt;
+  /**
+   * @brief   Pointer to the receive linear buffer.
+   * @note    With the data cache enabled the buffer should be aligned to
+   *          and sized in cache lines, it is invalidated on completion.
+   */
+  uint8_t                       *rxbuf;
+#if (USB_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Waiting thread.
+   */
+  thread_reference_t            thread;
+#endif
+  /* End of the mandatory fields.*/
+} USBOutEndpointState;
+
+/**
+ * @brief   Type of an USB endpoint configuration structure.
+ * @note    Platform specific restrictions may apply to endpoints.
+ */
+typedef struct {
+  /**
+   * @brief   Type and mode of the endpoint.
+   */
+  uint32_t                      ep_mode;
+  /**
+   * @brief   Setup packet notification callback.
+   * @details This callback is invoked when a setup packet has been
+   *          received.
+   * @post    The application must immediately call @p usbReadPacket() in
+   *          order to access the received packet.
+   * @note    This field is only valid for @p USB_EP_MODE_TYPE_CTRL
+   *          endpoints, it should be set to @p NULL for other endpoint
+   *          types.
+   */
+  usbepcallback_t               setup_cb;
+  /**
+   * @brief   IN endpoint notification callback.
+   * @details This field must be set to @p NULL if callback is not required.
+   */
+  usbepcallback_t               in_cb;
+  /**
+   * @brief   OUT endpoint notification callback.
+   * @details This field must be set to @p NULL if callback is not required.
+   */
+  usbepcallback_t               out_cb;
+  /**
+   * @brief   IN endpoint maximum packet size.
+   * @details This field must be set to zero if the IN endpoint is not used.
+   */
+  uint16_t                      in_maxsize;
+  /**
+   * @brief   OUT endpoint maximum packet size.
+   * @details This field must be set to zero if the OUT endpoint is not used.
+   */
+  uint16_t                      out_maxsize;
+  /**
+   * @brief   @p USBEndpointState associated to the IN endpoint.
+   * @details This field must be set to @p NULL if the IN endpoint is not
+   *          used.
+   */
+  USBInEndpointState            *in_state;
+  /**
+   * @brief   @p USBEndpointState associated to the OUT endpoint.
+   * @details This field must be set to @p NULL if the OUT endpoint is not
+   *          used.
+   */
+  USBOutEndpointState           *out_state;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Reserved field, not currently used.
+   * @note    Initialize this field to 1 in order to be forward compatible.
+   */
+  uint16_t                      ep_buffers;
+  /**
+   * @brief   Pointer to a buffer for setup packets.
+   * @details Setup packets require a dedicated 8-bytes buffer, set this
+   *          field to @p NULL for non-control endpoints.
+   */
+  uint8_t                       *setup_buf;
+} USBEndpointConfig;
+
+/**
+ * @brief   Type of an USB driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   USB events callback.
+   * @details This callback is invoked when an USB driver event is registered.
+   */
+  usbeventcb_t                  event_cb;
+  /**
+   * @brief   Device GET_DESCRIPTOR request callback.
+   * @note    This callback is mandatory and cannot be set to @p NULL.
+   */
+  usbgetdescriptor_t            get_descriptor_cb;
+  /**
+   * @brief   Requests hook callback.
+   * @details This hook allows to be notified of standard requests or to
+   *          handle non standard requests.
+   */
+  usbreqhandler_t               requests_hook_cb;
+  /**
+   * @brief   Start Of Frame callback.
+   */
+  usbcallback_t                 sof_cb;
+  /* End of the mandatory fields.*/
+} USBConfig;
+
+/**
+ * @brief   Structure representing an USB driver.
+ */
+struct USBDriver {
+  /**
+   * @brief   Driver state.
+   */
+  usbstate_t                    state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const USBConfig               *config;
+  /**
+   * @brief   Bit map of the transmitting IN endpoints.
+   */
+  uint16_t                      transmitting;
+  /**
+   * @brief   Bit map of the receiving OUT endpoints.
+   */
+  uint16_t                      receiving;
+  /**
+   * @brief   Active endpoints configurations.
+   */
+  const USBEndpointConfig       *epc[USB_MAX_ENDPOINTS + 1];
+  /**
+   * @brief   Fields available to user, it can be used to associate an
+   *          application-defined handler to an IN endpoint.
+   * @note    The base index is one, the endpoint zero does not have a
+   *          reserved element in this array.
+   */
+  void                          *in_params[USB_MAX_ENDPOINTS];
+  /**
+   * @brief   Fields available to user, it can be used to associate an
+   *          application-defined handler to an OUT endpoint.
+   * @note    The base index is one, the endpoint zero does not have a
+   *          reserved element in this array.
+   */
+  void                          *out_params[USB_MAX_ENDPOINTS];
+  /**
+   * @brief   Endpoint 0 state.
+   */
+  usbep0state_t                 ep0state;
+  /**
+   * @brief   Next position in the buffer to be transferred through endpoint 0.
+   */
+  uint8_t                       *ep0next;
+  /**
+   * @brief   Number of bytes yet to be transferred through endpoint 0.
+   */
+  size_t                        ep0n;
+  /**
+   * @brief   Endpoint 0 end transaction callback.
+   */
+  usbcallback_t                 ep0endcb;
+  /**
+   * @brief   Setup packet buffer.
+   */
+  uint8_t                       setup[8];
+  /**
+   * @brief   Current USB device status.
+   */
+  uint16_t                      status;
+  /**
+   * @brief   Assigned USB address.
+   */
+  uint8_t                       address;
+  /**
+   * @brief   Current USB device configuration.
+   */
+  uint8_t                       configuration;
+  /**
+   * @brief   State of the driver when a suspend happened.
+   */
+  usbstate_t                    saved_state;
+#if defined(USB_DRIVER_EXT_FIELDS)
+  USB_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the current frame number.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @return              The current frame number.
+ *
+ * @notapi
+ */
+#define usb_lld_get_frame_number(usbp) ((USB1->FRINDEX >> 3) & 0x7FFU)
+
+/**
+ * @brief   Returns the exact size of a receive transaction.
+ * @details The received size can be different from the size specified in
+ *          @p usbStartReceiveI() because the last packet could have a size
+ *          different from the expected one.
+ * @pre     The OUT endpoint must have been configured in transaction mode
+ *          in order to use this function.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              Received data size.
+ *
+ * @notapi
+ */
+#define usb_lld_get_transaction_size(usbp, ep)                              \
+  ((usbp)->epc[ep]->out_state->rxcnt)
+
+/**
+ * @brief   Connects the USB device.
+ *
+ * @api
+ */
+#if !defined(usb_lld_connect_bus)
+#define usb_lld_connect_bus(usbp) (USB1->USBCMD |= EHCI_USBCMD_RS)
+#endif
+
+/**
+ * @brief   Disconnect the USB device.
+ *
+ * @api
+ */
+#if !defined(usb_lld_disconnect_bus)
+#define usb_lld_disconnect_bus(usbp) (USB1->USBCMD &= ~EHCI_USBCMD_RS)
+#endif
+
+/**
+ * @brief   Start of host wake-up procedure.
+ *
+ * @notapi
+ */
+#define usb_lld_wakeup_host(usbp)                                           \
+  do {                                                                      \
+    USB1->PORTSC1 |= EHCI_PORTSC1_FPR;                                      \
+    osalThreadSleepMilliseconds(USB_HOST_WAKEUP_DURATION);                  \
+    USB1->PORTSC1 &= ~EHCI_PORTSC1_FPR;                                     \
+  } while (false)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if MIMXRT1062_USB_USE_USB1 && !defined(__DOXYGEN__)
+extern USBDriver USBD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void usb_lld_init(void);
+  void usb_lld_start(USBDriver *usbp);
+  void usb_lld_stop(USBDriver *usbp);
+  void usb_lld_reset(USBDriver *usbp);
+  void usb_lld_set_address(USBDriver *usbp);
+  void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep);
+  void usb_lld_disable_endpoints(USBDriver *usbp);
+  usbepstatus_t usb_lld_get_status_in(USBDriver *usbp, usbep_t ep);
+  usbepstatus_t usb_lld_get_status_out(USBDriver *usbp, usbep_t ep);
+  void usb_lld_read_setup(USBDriver *usbp, usbep_t ep, uint8_t *buf);
+  void usb_lld_start_out(USBDriver *usbp, usbep_t ep);
+  void usb_lld_start_in(USBDriver *usbp, usbep_t ep);
+  void usb_lld_stall_out(USBDriver *usbp, usbep_t ep);
+  void usb_lld_stall_in(USBDriver *usbp, usbep_t ep);
+  void usb_lld_clear_out(USBDriver *usbp, usbep_t ep);
+  void usb_lld_clear_in(USBDriver *usbp, usbep_t ep);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_USB */
+
+#endif /* HAL_USB_LLD_H_ */
+
+/** @} */
@@ -112,6 +112,10 @@ const uint8_t _cfm[0x10] = {
  * @notapi
  */
 void hal_lld_init(void) {
+
+#if defined(MIMXRT1062_EDMA_REQUIRED)
+  edmaInit();
+#endif
 }
 
 
@@ -97,6 +97,7 @@ typedef uint32_t halrtcnt_t;
 /*===========================================================================*/
 
 #include "nvic.h"
+#include "mimxrt1062_edma.h"
 
 #ifdef __cplusplus
 extern "C" {
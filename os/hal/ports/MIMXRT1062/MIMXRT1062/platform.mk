@@ -21,10 +21,15 @@ HALCONF := $(strip $(shell cat $(CONFDIR)/halconf.h $(CONFDIR)/halconf_community
 
 endif
 
+include ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/DMAv1/driver.mk
 include ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/GPIOv1/driver.mk
 include ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/UARTv1/driver.mk
 include ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/PITv1/driver.mk
-include ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/USBHSv1/driver.mk
+include ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/LPSPIv1/driver.mk
+# USB device driver, USBHSv1 wraps the MCUXpresso SDK device stack, USBHSv2
+# drives the EHCI queue heads directly.
+MIMXRT1062_USB_DRIVER ?= USBHSv1
+include ${CHIBIOS_CONTRIB}/os/hal/ports/MIMXRT1062/LLD/$(MIMXRT1062_USB_DRIVER)/driver.mk
 
 # Shared variables
 ALLCSRC += $(PLATFORMSRC_CONTRIB)
@@ -70,6 +70,151 @@ static uartflags_t translate_errors(uint32_t sr) {
   return sts;
 }
 
+#if (NRF5_UART_USE_RX_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reports the streamed bytes of the current buffer.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] upto      offset in the current buffer up to which data
+ *                      has been received
+ */
+static void uart_rx_stream_report(UARTDriver *uartp, size_t upto) {
+
+  if (upto > uartp->rxsoff) {
+    size_t n = upto - uartp->rxsoff;
+
+    uartp->config->rxstream_cb(uartp,
+                               &uartp->rxsbuf[uartp->rxscur][uartp->rxsoff],
+                               n);
+    uartp->rxsoff   = upto;
+    uartp->rxsdone += (uint32_t)n;
+  }
+}
+
+/**
+ * @brief   Flushes the bytes counted by TIMER3 and not yet reported.
+ * @note    Only the current buffer is flushed, the remaining bytes are
+ *          reported once its ENDRX event has been served.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+static void uart_rx_stream_flush(UARTDriver *uartp) {
+  uint32_t pending;
+  size_t avail;
+
+  NRF_TIMER3->TASKS_CAPTURE[0] = 1;
+  pending = NRF_TIMER3->CC[0] - uartp->rxsdone;
+  avail = NRF5_UART_RX_STREAM_BUFSIZE - uartp->rxsoff;
+  if (pending < avail)
+    avail = pending;
+
+  uart_rx_stream_report(uartp, uartp->rxsoff + avail);
+}
+
+/**
+ * @brief   Starts the streaming receive mode.
+ * @details RXDRDY is routed through PPI to the TIMER3 counter and to
+ *          the TIMER4 idle timer, which is restarted on each received
+ *          byte and stops itself once the line has been idle for
+ *          @p rxidle_us microseconds.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+static void uart_rx_stream_start(UARTDriver *uartp) {
+  NRF_UARTE_Type *u = uartp->uart;
+
+  osalDbgAssert(uartp->config->rxidle_us > 0U, "invalid idle time");
+
+  /* Byte counter.*/
+  NRF_TIMER3->TASKS_STOP  = 1;
+  NRF_TIMER3->MODE        = TIMER_MODE_MODE_LowPowerCounter;
+  NRF_TIMER3->BITMODE     = TIMER_BITMODE_BITMODE_32Bit;
+  NRF_TIMER3->TASKS_CLEAR = 1;
+  NRF_TIMER3->TASKS_START = 1;
+
+  /* Idle timer, 1MHz.*/
+  NRF_TIMER4->TASKS_STOP  = 1;
+  NRF_TIMER4->MODE        = TIMER_MODE_MODE_Timer;
+  NRF_TIMER4->BITMODE     = TIMER_BITMODE_BITMODE_32Bit;
+  NRF_TIMER4->PRESCALER   = 4;
+  NRF_TIMER4->CC[0]       = uartp->config->rxidle_us;
+  NRF_TIMER4->SHORTS      = TIMER_SHORTS_COMPARE0_STOP_Msk |
+                            TIMER_SHORTS_COMPARE0_CLEAR_Msk;
+  NRF_TIMER4->TASKS_CLEAR = 1;
+  NRF_TIMER4->EVENTS_COMPARE[0] = 0;
+#if CORTEX_MODEL >= 4
+  (void)NRF_TIMER4->EVENTS_COMPARE[0];
+#endif
+  NRF_TIMER4->INTENSET    = TIMER_INTENSET_COMPARE0_Msk;
+
+  /* PPI routing of the received bytes.*/
+  NRF_PPI->CH[NRF5_UART_RX_STREAM_PPI_COUNT].EEP  = (uint32_t)&u->EVENTS_RXDRDY;
+  NRF_PPI->CH[NRF5_UART_RX_STREAM_PPI_COUNT].TEP  = (uint32_t)&NRF_TIMER3->TASKS_COUNT;
+  NRF_PPI->FORK[NRF5_UART_RX_STREAM_PPI_COUNT].TEP = (uint32_t)&NRF_TIMER4->TASKS_CLEAR;
+  NRF_PPI->CH[NRF5_UART_RX_STREAM_PPI_IDLE].EEP   = (uint32_t)&u->EVENTS_RXDRDY;
+  NRF_PPI->CH[NRF5_UART_RX_STREAM_PPI_IDLE].TEP   = (uint32_t)&NRF_TIMER4->TASKS_START;
+  NRF_PPI->CHENSET = (1U << NRF5_UART_RX_STREAM_PPI_COUNT) |
+                     (1U << NRF5_UART_RX_STREAM_PPI_IDLE);
+
+  uartp->rxscur    = 0;
+  uartp->rxsoff    = 0;
+  uartp->rxsdone   = 0;
+  uartp->rxsactive = true;
+
+  /* The next buffer is armed on RXSTARTED, the short restarts the
+     reception on it as soon as the current one is full.*/
+  u->SHORTS = UARTE_SHORTS_ENDRX_STARTRX_Msk;
+  u->RXD.PTR = (uint32_t)uartp->rxsbuf[0];
+  u->RXD.MAXCNT = NRF5_UART_RX_STREAM_BUFSIZE;
+
+  u->EVENTS_ENDRX = 0;
+  u->EVENTS_RXSTARTED = 0;
+#if CORTEX_MODEL >= 4
+  (void)u->EVENTS_ENDRX;
+  (void)u->EVENTS_RXSTARTED;
+#endif
+  u->INTENSET = UARTE_INTENSET_ENDRX_Msk | UARTE_INTENSET_RXSTARTED_Msk;
+
+  u->TASKS_STARTRX = 1;
+}
+
+/**
+ * @brief   Stops the streaming receive mode.
+ * @details The bytes already counted are reported before stopping.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+static void uart_rx_stream_stop(UARTDriver *uartp) {
+  NRF_UARTE_Type *u = uartp->uart;
+
+  if (!uartp->rxsactive)
+    return;
+
+  uart_rx_stream_flush(uartp);
+  uartp->rxsactive = false;
+
+  u->INTENCLR = UARTE_INTENCLR_RXSTARTED_Msk;
+  u->SHORTS = 0;
+  u->TASKS_STOPRX = 1;
+
+  /* No stale RX event must survive into the next reception.*/
+  u->EVENTS_ENDRX = 0;
+  u->EVENTS_RXSTARTED = 0;
+  u->EVENTS_RXTO = 0;
+#if CORTEX_MODEL >= 4
+  (void)u->EVENTS_ENDRX;
+  (void)u->EVENTS_RXSTARTED;
+  (void)u->EVENTS_RXTO;
+#endif
+
+  NRF_PPI->CHENCLR = (1U << NRF5_UART_RX_STREAM_PPI_COUNT) |
+                     (1U << NRF5_UART_RX_STREAM_PPI_IDLE);
+  NRF_TIMER4->INTENCLR   = TIMER_INTENCLR_COMPARE0_Msk;
+  NRF_TIMER4->TASKS_STOP = 1;
+  NRF_TIMER3->TASKS_STOP = 1;
+}
+#endif /* NRF5_UART_USE_RX_STREAM == TRUE */
+
 /**
  * @brief   Puts the receiver in the UART_RX_IDLE state.
  *
@@ -77,7 +222,14 @@ static uartflags_t translate_errors(uint32_t sr) {
  */
 static void uart_enter_rx_idle_loop(UARTDriver *uartp) {
   NRF_UARTE_Type *u = uartp->uart;
-  
+
+#if NRF5_UART_USE_RX_STREAM == TRUE
+  if (uartp->config->rxstream_cb != NULL) {
+    uart_rx_stream_start(uartp);
+    return;
+  }
+#endif
+
   /* RX DMA channel preparation, if the char callback is defined then the
      interrupt is enabled too.*/
   if (uartp->config->rxchar_cb == NULL)
@@ -213,6 +365,10 @@ static void configure_uart(UARTDriver *uartp, const UARTConfig *config)
 static void uart_stop(UARTDriver *uartp) {
   NRF_UARTE_Type *u = uartp->uart;
 
+#if NRF5_UART_USE_RX_STREAM == TRUE
+  uart_rx_stream_stop(uartp);
+#endif
+
   /* Stops RX and TX.*/
   u->TASKS_STOPRX = 1;
   u->TASKS_STOPTX = 1;
@@ -244,6 +400,17 @@ static void uart_lld_serve_rx_end_irq(UARTDriver *uartp, uint32_t flags) {
   (void)flags;
   NRF_UARTE_Type *u = uartp->uart;
 
+#if NRF5_UART_USE_RX_STREAM == TRUE
+  if (uartp->rxsactive) {
+    /* Streaming buffer filled, the remaining bytes are reported and the
+       reception already continues on the other buffer.*/
+    uart_rx_stream_report(uartp, u->RXD.AMOUNT);
+    uartp->rxscur ^= 1U;
+    uartp->rxsoff  = 0;
+    return;
+  }
+#endif
+
   if (uartp->rxstate == UART_RX_IDLE) {
     /* Receiver in idle state, a callback is generated, if enabled, for each
        received character and then the driver stays in the same state.*/
@@ -256,6 +423,13 @@ static void uart_lld_serve_rx_end_irq(UARTDriver *uartp, uint32_t flags) {
        a completed transfer.*/
 	u->TASKS_STOPRX = 1;
     _uart_rx_complete_isr_code(uartp);
+#if NRF5_UART_USE_RX_STREAM == TRUE
+    /* Back to idle with no new receive started from the callback, the
+       streaming mode is resumed.*/
+    if ((uartp->rxstate == UART_RX_IDLE) &&
+        (uartp->config->rxstream_cb != NULL))
+      uart_rx_stream_start(uartp);
+#endif
   }
 }
 
@@ -329,8 +503,40 @@ static void serve_uart_irq(UARTDriver *uartp) {
     /* End of reception, a callback is generated.*/
     uart_lld_serve_rx_end_irq(uartp, isr);
   }
+
+#if NRF5_UART_USE_RX_STREAM == TRUE
+  /* Served after ENDRX so that the buffer index is already updated.*/
+  if (u->EVENTS_RXSTARTED && isr & UARTE_INTENSET_RXSTARTED_Msk) {
+    u->EVENTS_RXSTARTED = 0;
+#if CORTEX_MODEL >= 4
+    (void)u->EVENTS_RXSTARTED;
+#endif
+
+    /* Arming the next buffer, it is latched by the ENDRX_STARTRX short.*/
+    u->RXD.PTR = (uint32_t)uartp->rxsbuf[uartp->rxscur ^ 1U];
+  }
+#endif
 }
 
+#if (NRF5_UART_USE_RX_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Streaming receive idle timeout service routine.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ */
+static void serve_uart_idle_irq(UARTDriver *uartp) {
+
+  if (!uartp->rxsactive)
+    return;
+
+  /* A buffer end could be pending, the UART IRQ has the same priority
+     so it is served here first.*/
+  serve_uart_irq(uartp);
+
+  uart_rx_stream_flush(uartp);
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -349,6 +555,27 @@ OSAL_IRQ_HANDLER(Vector48) {
   OSAL_IRQ_EPILOGUE();
 }
 
+#if NRF5_UART_USE_RX_STREAM == TRUE
+/**
+ * @brief   TIMER4 IRQ handler, streaming receive idle timeout.
+ *
+ * @isr
+ */
+OSAL_IRQ_HANDLER(VectorAC) {
+
+  OSAL_IRQ_PROLOGUE();
+
+  NRF_TIMER4->EVENTS_COMPARE[0] = 0;
+#if CORTEX_MODEL >= 4
+  (void)NRF_TIMER4->EVENTS_COMPARE[0];
+#endif
+
+  serve_uart_idle_irq(&UARTD1);
+
+  OSAL_IRQ_EPILOGUE();
+}
+#endif
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -391,6 +618,10 @@ void uart_lld_start(UARTDriver *uartp) {
       }
 
       nvicEnableVector(UARTE0_UART0_IRQn, NRF5_UART_UART0_IRQ_PRIORITY);
+#if NRF5_UART_USE_RX_STREAM == TRUE
+      /* Same priority as the UART so that the two never preempt.*/
+      nvicEnableVector(TIMER4_IRQn, NRF5_UART_UART0_IRQ_PRIORITY);
+#endif
   }
 
   uartp->rxstate = UART_RX_IDLE;
@@ -413,6 +644,9 @@ void uart_lld_stop(UARTDriver *uartp) {
 
     if (&UARTD1 == uartp) {
       nvicDisableVector(UARTE0_UART0_IRQn);
+#if NRF5_UART_USE_RX_STREAM == TRUE
+      nvicDisableVector(TIMER4_IRQn);
+#endif
       u->ENABLE = UARTE_ENABLE_ENABLE_Disabled;
     }
   }
@@ -500,6 +734,9 @@ void uart_lld_start_receive(UARTDriver *uartp, uint8_t n, void *rxbuf) {
   NRF_UARTE_Type *u=uartp->uart;
 
   /* Stopping previous activity (idle state).*/
+#if NRF5_UART_USE_RX_STREAM == TRUE
+  uart_rx_stream_stop(uartp);
+#endif
   u->TASKS_STOPRX = 1;
   u->SHORTS = 0;
 
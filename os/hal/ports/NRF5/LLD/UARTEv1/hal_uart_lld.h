@@ -65,6 +65,42 @@
 #define NRF5_UART_UART0_IRQ_PRIORITY      3
 #endif
 
+/**
+ * @brief   UART driver streaming receive mode switch.
+ * @details If set to @p TRUE the idle-line DMA receive mode is included,
+ *          it is activated by setting @p rxstream_cb in the configuration.
+ *          Reception ping-pongs between two EasyDMA buffers, TIMER3 counts
+ *          received bytes through PPI and TIMER4 measures the line idle
+ *          time in order to flush partially filled buffers.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(NRF5_UART_USE_RX_STREAM) || defined(__DOXYGEN__)
+#define NRF5_UART_USE_RX_STREAM           FALSE
+#endif
+
+/**
+ * @brief   Size of each of the two streaming receive buffers.
+ * @note    Limited by the width of the RXD.MAXCNT register.
+ */
+#if !defined(NRF5_UART_RX_STREAM_BUFSIZE) || defined(__DOXYGEN__)
+#define NRF5_UART_RX_STREAM_BUFSIZE       255
+#endif
+
+/**
+ * @brief   PPI channel routing RXDRDY to the byte counter.
+ * @note    The channel fork is used to clear the idle timer.
+ */
+#if !defined(NRF5_UART_RX_STREAM_PPI_COUNT) || defined(__DOXYGEN__)
+#define NRF5_UART_RX_STREAM_PPI_COUNT     18
+#endif
+
+/**
+ * @brief   PPI channel routing RXDRDY to the idle timer start task.
+ */
+#if !defined(NRF5_UART_RX_STREAM_PPI_IDLE) || defined(__DOXYGEN__)
+#define NRF5_UART_RX_STREAM_PPI_IDLE      19
+#endif
+
 /* Value indicating that no pad is connected to this UART register. */
 #define  NRF5_UART_PAD_DISCONNECTED 0xFFFFFFFFU
 #define  NRF5_UART_INVALID_BAUDRATE 0xFFFFFFFFU
@@ -85,6 +121,31 @@
 #error "Invalid IRQ priority assigned to UART0"
 #endif
 
+#if NRF5_UART_USE_RX_STREAM
+#if defined(NRF5_GPT_USE_TIMER3) && NRF5_GPT_USE_TIMER3
+#error "UART streaming receive requires TIMER3, already used by GPT"
+#endif
+#if defined(NRF5_GPT_USE_TIMER4) && NRF5_GPT_USE_TIMER4
+#error "UART streaming receive requires TIMER4, already used by GPT"
+#endif
+#if defined(NRF5_ICU_USE_TIMER3) && NRF5_ICU_USE_TIMER3
+#error "UART streaming receive requires TIMER3, already used by ICU"
+#endif
+#if defined(NRF5_ICU_USE_TIMER4) && NRF5_ICU_USE_TIMER4
+#error "UART streaming receive requires TIMER4, already used by ICU"
+#endif
+#if (NRF5_UART_RX_STREAM_BUFSIZE < 2) ||                                    \
+    (NRF5_UART_RX_STREAM_BUFSIZE > UARTE_RXD_MAXCNT_MAXCNT_Msk)
+#error "NRF5_UART_RX_STREAM_BUFSIZE exceeds RXD.MAXCNT"
+#endif
+#if (NRF5_UART_RX_STREAM_PPI_COUNT > 19) || (NRF5_UART_RX_STREAM_PPI_IDLE > 19)
+#error "only PPI channels 0..19 are programmable"
+#endif
+#if NRF5_UART_RX_STREAM_PPI_COUNT == NRF5_UART_RX_STREAM_PPI_IDLE
+#error "UART streaming receive requires two distinct PPI channels"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -122,6 +183,19 @@ typedef void (*uartccb_t)(UARTDriver *uartp, uint16_t c);
  */
 typedef void (*uartecb_t)(UARTDriver *uartp, uartflags_t e);
 
+#if (NRF5_UART_USE_RX_STREAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Streaming receive UART notification callback type.
+ * @note    The data is only valid during the callback, it is invoked
+ *          from ISR context.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] buf       pointer to the received data
+ * @param[in] n         number of received bytes
+ */
+typedef void (*uartscb_t)(UARTDriver *uartp, const uint8_t *buf, size_t n);
+#endif
+
 /**
  * @brief   Driver configuration structure.
  * @note    It could be empty on some architectures.
@@ -170,6 +244,19 @@ typedef struct {
    */
   uint32_t                  cts_pad;
 #endif
+#if (NRF5_UART_USE_RX_STREAM == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Data received while out of the @p UART_RECEIVE state.
+   * @note  If not @p NULL it replaces @p rxchar_cb and the receiver
+   *        uses the streaming mode while idle.
+   */
+  uartscb_t                 rxstream_cb;
+  /**
+   * @brief Line idle time, in microseconds, after which a partially
+   *        filled streaming buffer is flushed.
+   */
+  uint32_t                  rxidle_us;
+#endif
 } UARTConfig;
 
 /**
@@ -224,6 +311,28 @@ struct UARTDriver {
    * @brief Default receive buffer while into @p UART_RX_IDLE state.
    */
   volatile uint32_t         rxbuf;
+#if (NRF5_UART_USE_RX_STREAM == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Streaming receive ping-pong buffers.
+   */
+  uint8_t                   rxsbuf[2][NRF5_UART_RX_STREAM_BUFSIZE];
+  /**
+   * @brief Index of the buffer currently filled by EasyDMA.
+   */
+  uint8_t                   rxscur;
+  /**
+   * @brief Bytes of the current buffer already reported.
+   */
+  size_t                    rxsoff;
+  /**
+   * @brief Total bytes reported, compared against the TIMER3 counter.
+   */
+  uint32_t                  rxsdone;
+  /**
+   * @brief Streaming mode active flag.
+   */
+  bool                      rxsactive;
+#endif
 };
 
 /*===========================================================================*/
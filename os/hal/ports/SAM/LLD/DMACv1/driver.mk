@@ -1,2 +1,9 @@
 PLATFORMSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/ports/SAM/LLD/DMACv1/sam_dmac.c
+ifeq ($(USE_SMART_BUILD),yes)
+ifneq ($(findstring HAL_USE_DMACH TRUE,$(HALCONF)),)
+PLATFORMSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/ports/SAM/LLD/DMACv1/hal_dmach_lld.c
+endif
+else
+PLATFORMSRC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/ports/SAM/LLD/DMACv1/hal_dmach_lld.c
+endif
 PLATFORMINC_CONTRIB += ${CHIBIOS_CONTRIB}/os/hal/ports/SAM/LLD/DMACv1
@@ -0,0 +1,239 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    DMACv1/hal_dmach_lld.c
+ * @brief   SAM DMA channels subsystem low level driver source.
+ *
+ * @addtogroup DMACH
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_DMACH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief Channels pool, indexed by DMAC channel number
+ */
+static DMAChannel dmach_channels[DMACH_LLD_CHANNELS];
+
+static const uint16_t dmach_beatsize[3] = {
+  DMAC_BTCTRL_BEATSIZE_BYTE,
+  DMAC_BTCTRL_BEATSIZE_HWORD,
+  DMAC_BTCTRL_BEATSIZE_WORD
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief DMAC channel callback
+ * The channel disables itself after the last block of a linear chain
+ *
+ * @param p pointer to the @p DMAChannel object
+ * @param flags TCMPL and TERR flags of the channel
+ */
+static void dmach_serve_interrupt(void *p, uint8_t flags)
+{
+  DMAChannel *dchp = (DMAChannel *)p;
+  uint32_t f = 0U;
+
+  if ((flags & DMAC_CHINTFLAG_TERR_Msk) != 0U)
+  {
+    f |= DMACH_FLAG_ERROR;
+  }
+  if ((flags & DMAC_CHINTFLAG_TCMPL_Msk) != 0U)
+  {
+    f |= DMACH_FLAG_DONE;
+    DMAC_REGS->DMAC_CHID = dchp->id;
+    if ((DMAC_REGS->DMAC_CHCTRLA & DMAC_CHCTRLA_ENABLE_Msk) == 0U)
+    {
+      f |= DMACH_FLAG_END;
+    }
+  }
+  _dmach_isr_code(dchp, f);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief Low level DMACH driver initialization
+ */
+void dmach_lld_init(void)
+{
+  unsigned i;
+
+  for (i = 0U; i < DMACH_LLD_CHANNELS; i++)
+  {
+    dmachObjectInit(&dmach_channels[i]);
+    dmach_channels[i].id = (uint8_t)i;
+  }
+}
+
+/**
+ * @brief Allocates a channel of the pool
+ *
+ * @param id DMAC channel or @p DMACH_ID_ANY
+ * @param priority DMAC priority level, from 0 to 2
+ * @return DMAChannel* the allocated channel, @p NULL if none is available
+ */
+DMAChannel *dmach_lld_alloc(uint32_t id, uint32_t priority)
+{
+  uint32_t i, startid, endid;
+
+  if (id < DMACH_LLD_CHANNELS)
+  {
+    startid = id;
+    endid = id;
+  }
+  else
+  {
+    startid = 0U;
+    endid = DMACH_LLD_CHANNELS - 1U;
+  }
+
+  for (i = startid; i <= endid; i++)
+  {
+    if (dmacChnlAllocI((uint8_t)i, (uint8_t)priority,
+                       dmach_serve_interrupt, &dmach_channels[i]) >= 0)
+    {
+      return &dmach_channels[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Releases a channel of the pool
+ *
+ * @param dchp pointer to the @p DMAChannel object
+ */
+void dmach_lld_free(DMAChannel *dchp)
+{
+  dmacChnlFreeI(dchp->id);
+}
+
+/**
+ * @brief Selects the trigger source of the next chains
+ *
+ * @param dchp pointer to the @p DMAChannel object
+ * @param trigger DMAC trigger source
+ */
+void dmach_lld_set_trigger(DMAChannel *dchp, dmachtrigger_t trigger)
+{
+  dchp->trigger = trigger;
+}
+
+/**
+ * @brief Setup a transfer descriptor
+ * A block interrupt is requested for @p DMACH_MODE_CB, the pacing depends
+ * on the channel trigger so @p DMACH_MODE_MEMORY is not used
+ *
+ * @param descp descriptor to be initialized
+ * @param dst destination address
+ * @param src source address
+ * @param n number of beats
+ * @param mode descriptor mode flags
+ */
+void dmach_lld_desc_setup(dmach_desc_t *descp, void *dst, const void *src,
+                          size_t n, uint32_t mode)
+{
+  uint16_t btctrl = dmach_beatsize[mode & DMACH_MODE_WIDTH_MASK];
+
+  if ((mode & DMACH_MODE_SRC_INC) != 0U)
+  {
+    btctrl |= DMAC_BTCTRL_SRCINC_Msk;
+  }
+  if ((mode & DMACH_MODE_DST_INC) != 0U)
+  {
+    btctrl |= DMAC_BTCTRL_DSTINC_Msk;
+  }
+  btctrl |= ((mode & DMACH_MODE_CB) != 0U) ? DMAC_BTCTRL_BLOCKACT_INT :
+                                             DMAC_BTCTRL_BLOCKACT_NOACT;
+  dmacDescSetup(descp, btctrl, (uint32_t)dst, (uint32_t)src, (uint16_t)n);
+}
+
+/**
+ * @brief Starts a chain of descriptors
+ * The last descriptor always raises the block interrupt
+ *
+ * @param dchp pointer to the @p DMAChannel object
+ * @param descs array of descriptors
+ * @param len number of descriptors
+ * @param circular the last descriptor is linked to the first one
+ */
+void dmach_lld_start(DMAChannel *dchp, dmach_desc_t *descs, unsigned len,
+                     bool circular)
+{
+  unsigned i;
+
+  for (i = 0U; i + 1U < len; i++)
+  {
+    dmacDescLink(&descs[i], &descs[i + 1U]);
+  }
+  descs[len - 1U].DMAC_BTCTRL |= DMAC_BTCTRL_BLOCKACT_INT;
+  dmacDescLink(&descs[len - 1U], circular ? &descs[0] : NULL);
+
+  dmacChnlSetLinked(dchp->id, &descs[0]);
+  dmacChnlSetTrigSrc(dchp->id, dchp->trigger);
+  dmacChnlSetTrigAct(dchp->id, dchp->trigger == DMACH_TRIGGER_SOFTWARE ?
+                               TRANSACTION : BEAT);
+  dmacChnlEnableIRQn(dchp->id);
+  dmacChnlEnable(dchp->id);
+  if (dchp->trigger == DMACH_TRIGGER_SOFTWARE)
+  {
+    DMAC_REGS->DMAC_SWTRIGCTRL |= (1U << dchp->id);
+  }
+}
+
+/**
+ * @brief Stops the channel and clears its pending flags
+ *
+ * @param dchp pointer to the @p DMAChannel object
+ */
+void dmach_lld_stop(DMAChannel *dchp)
+{
+  dmacChnlDisableIRQn(dchp->id);
+  dmacChnlDisable(dchp->id);
+  while ((DMAC_REGS->DMAC_CHCTRLA & DMAC_CHCTRLA_ENABLE_Msk) != 0U)
+    ;
+  DMAC_REGS->DMAC_CHINTFLAG = (uint8_t)(DMAC_CHINTFLAG_TCMPL_Msk |
+                                        DMAC_CHINTFLAG_TERR_Msk);
+}
+
+#endif /* HAL_USE_DMACH == TRUE */
+
+/** @} */
@@ -0,0 +1,138 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    DMACv1/hal_dmach_lld.h
+ * @brief   SAM DMA channels subsystem low level driver header.
+ *
+ * @addtogroup DMACH
+ * @{
+ */
+
+#ifndef HAL_DMACH_LLD_H
+#define HAL_DMACH_LLD_H
+
+#if (HAL_USE_DMACH == TRUE) || defined(__DOXYGEN__)
+
+#include "sam_dmac.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of channels of the pool.
+ */
+#define DMACH_LLD_CHANNELS          SAM_DMAC_CHAN_NUM
+
+/**
+ * @brief   Largest number of items of a descriptor.
+ */
+#define DMACH_LLD_DESC_MAX_ITEMS    0xFFFFU
+
+/**
+ * @brief   Circular chains support.
+ */
+#define DMACH_LLD_SUPPORTS_CIRCULAR TRUE
+
+/**
+ * @brief   Trigger starting the chains on @p dmachStart().
+ */
+#define DMACH_TRIGGER_SOFTWARE      DISABLE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief DMACH Driver requires DMAC to be enabled
+ *
+ */
+#if !defined(SAM_DMAC_REQUIRED)
+#define SAM_DMAC_REQUIRED
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a transfer descriptor.
+ */
+typedef sam_dmac_desc_t dmach_desc_t SAM_DMAC_DESC_ALIGN;
+
+/**
+ * @brief   Type of a channel trigger, the DMAC trigger source.
+ * @note    Peripheral triggers move one beat per request, the software
+ *          trigger moves the whole chain.
+ */
+typedef dmac_trigsrc_t dmachtrigger_t;
+
+/**
+ * @brief   Low level fields of the channel structure.
+ */
+#define dmach_lld_channel_fields                                            \
+  /* DMAC channel number.*/                                                 \
+  uint8_t                   id;                                             \
+  /* Trigger source.*/                                                      \
+  dmachtrigger_t            trigger
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the bytes moved by a descriptor.
+ *
+ * @param[in] descp     pointer to the descriptor
+ *
+ * @notapi
+ */
+#define dmach_lld_desc_get_size(descp)                                      \
+  ((size_t)(descp)->DMAC_BTCNT <<                                           \
+   (((descp)->DMAC_BTCTRL & DMAC_BTCTRL_BEATSIZE_Msk) >>                    \
+    DMAC_BTCTRL_BEATSIZE_Pos))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+  void dmach_lld_init(void);
+  DMAChannel *dmach_lld_alloc(uint32_t id, uint32_t priority);
+  void dmach_lld_free(DMAChannel *dchp);
+  void dmach_lld_set_trigger(DMAChannel *dchp, dmachtrigger_t trigger);
+  void dmach_lld_desc_setup(dmach_desc_t *descp, void *dst, const void *src,
+                            size_t n, uint32_t mode);
+  void dmach_lld_start(DMAChannel *dchp, dmach_desc_t *descs, unsigned len,
+                       bool circular);
+  void dmach_lld_stop(DMAChannel *dchp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_DMACH == TRUE */
+
+#endif /* HAL_DMACH_LLD_H */
+
+/** @} */
@@ -149,6 +149,34 @@ void dmacChnlFree(uint8_t id)
   osalSysUnlock();
 }
 
+/**
+ * @brief Read the progress of a DMAC Channel
+ * The channel is suspended for the time needed to update its write-back
+ * descriptor, then it is resumed
+ *
+ * @param id DMAC Channel
+ * @param descaddr address of the next descriptor of the chain, can be NULL
+ * @return uint16_t beats remaining in the current block
+ */
+uint16_t dmacChnlGetProgressI(uint8_t id, uint32_t *descaddr)
+{
+  osalDbgCheckClassI();
+  DMAC_REGS->DMAC_CHID = id;
+  if ((DMAC_REGS->DMAC_CHCTRLA & DMAC_CHCTRLA_ENABLE_Msk) != 0U)
+  {
+    DMAC_REGS->DMAC_CHCTRLB = (DMAC_REGS->DMAC_CHCTRLB & ~DMAC_CHCTRLB_CMD_Msk) | DMAC_CHCTRLB_CMD_SUSPEND;
+    while ((DMAC_REGS->DMAC_CHINTFLAG & DMAC_CHINTFLAG_SUSP_Msk) == 0U)
+      ;
+    DMAC_REGS->DMAC_CHINTFLAG = (uint8_t)DMAC_CHINTFLAG_SUSP_Msk;
+    DMAC_REGS->DMAC_CHCTRLB = (DMAC_REGS->DMAC_CHCTRLB & ~DMAC_CHCTRLB_CMD_Msk) | DMAC_CHCTRLB_CMD_RESUME;
+  }
+  if (descaddr != NULL)
+  {
+    *descaddr = _sam_dmac_chnl[id].wb->DMAC_DESCADDR;
+  }
+  return _sam_dmac_chnl[id].wb->DMAC_BTCNT;
+}
+
 OSAL_IRQ_HANDLER(DMAC_HANDLER)
 {
   OSAL_IRQ_PROLOGUE();
@@ -156,8 +184,15 @@ OSAL_IRQ_HANDLER(DMAC_HANDLER)
   uint8_t chanIntFlagStatus = 0U;
   channel = (uint8_t)((uint32_t)DMAC_REGS->DMAC_INTPEND & DMAC_INTPEND_ID_Msk);
   DMAC_REGS->DMAC_CHID = channel;
-  chanIntFlagStatus = (uint8_t)DMAC_REGS->DMAC_CHINTFLAG;
-  dmacChnlDisableIRQn(channel);
+  chanIntFlagStatus = (uint8_t)DMAC_REGS->DMAC_CHINTFLAG &
+                      (uint8_t)(DMAC_CHINTFLAG_TCMPL_Msk | DMAC_CHINTFLAG_TERR_Msk);
+  DMAC_REGS->DMAC_CHINTFLAG = chanIntFlagStatus;
+  /* A chain of linked descriptors keeps the channel enabled and raises an
+     interrupt for each block, the IRQ is kept enabled until the end.*/
+  if ((DMAC_REGS->DMAC_CHCTRLA & DMAC_CHCTRLA_ENABLE_Msk) == 0U)
+  {
+    dmacChnlDisableIRQn(channel);
+  }
   if (dmac.channel[channel].func != NULL)
   {
     dmac.channel[channel].func(dmac.channel[channel].param, chanIntFlagStatus);
@@ -94,10 +94,22 @@ typedef struct
   dmac_descriptor_registers_t *wb;
 } sam_dmac_chnl_t;
 
+/**
+ * @brief   Type of a DMAC transfer descriptor.
+ * @note    Linked descriptors must be aligned to 128 bits, declare them
+ *          using @p SAM_DMAC_DESC_ALIGN.
+ */
+typedef dmac_descriptor_registers_t sam_dmac_desc_t;
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Alignment attribute of the linked descriptors.
+ */
+#define SAM_DMAC_DESC_ALIGN __ALIGNED(16)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -120,6 +132,7 @@ extern "C"
                        void *param);
   void dmacChnlFree(uint8_t id);
   void dmacChnlFreeI(uint8_t id);
+  uint16_t dmacChnlGetProgressI(uint8_t id, uint32_t *descaddr);
 #ifdef __cplusplus
 }
 #endif
@@ -307,17 +320,79 @@ static inline void dmacChnlSetDir(uint8_t id, uint32_t dstAddr, uint32_t srcAddr
   }
 }
 
-// TODO: fix this function
-//  static inline void dmacChnlSetCircular(uint8_t id, uint8_t isCircular)
-//  {
-//    dmac_descriptor_registers_t *dmacDescReg = _sam_dmac_chnl[id].desc;
-//    if(isCircular) {
-//      dmacDescReg->DMAC_DESCADDR = ((uint32_t)dmacDescReg);
-//    }
-//    else {
-//      dmacDescReg->DMAC_DESCADDR = 0U;
-//    }
-//  }
+/**
+ * @brief Make the channel descriptor loop on itself
+ * The channel then restarts the same block until it is disabled
+ *
+ * @param id DMAC Channel
+ * @param isCircular true for a circular transfer
+ */
+static inline void dmacChnlSetCircular(uint8_t id, uint8_t isCircular)
+{
+  dmac_descriptor_registers_t *dmacDescReg = _sam_dmac_chnl[id].desc;
+  if (isCircular)
+  {
+    dmacDescReg->DMAC_DESCADDR = (uint32_t)dmacDescReg;
+  }
+  else
+  {
+    dmacDescReg->DMAC_DESCADDR = 0U;
+  }
+}
+
+/**
+ * @brief Setup a transfer descriptor
+ * The addresses are the start of the buffers, they are converted to the
+ * end addresses the DMAC expects for the incrementing sides
+ *
+ * @param descp descriptor to be initialized
+ * @param btctrl block transfer control
+ * @param dstAddr Destination Address
+ * @param srcAddr Source Address
+ * @param size number of beats in the block
+ */
+static inline void dmacDescSetup(sam_dmac_desc_t *descp, uint16_t btctrl,
+                                 uint32_t dstAddr, uint32_t srcAddr, uint16_t size)
+{
+  uint32_t bytes = (uint32_t)size << ((btctrl & DMAC_BTCTRL_BEATSIZE_Msk) >> DMAC_BTCTRL_BEATSIZE_Pos);
+  descp->DMAC_BTCTRL = btctrl | DMAC_BTCTRL_VALID_Msk;
+  descp->DMAC_BTCNT = size;
+  descp->DMAC_DSTADDR = ((btctrl & DMAC_BTCTRL_DSTINC_Msk) != 0U) ? dstAddr + bytes : dstAddr;
+  descp->DMAC_SRCADDR = ((btctrl & DMAC_BTCTRL_SRCINC_Msk) != 0U) ? srcAddr + bytes : srcAddr;
+  descp->DMAC_DESCADDR = 0U;
+}
+
+/**
+ * @brief Link a descriptor to the next one
+ *
+ * @param descp descriptor
+ * @param next next descriptor, NULL ends the transfer after @p descp
+ */
+static inline void dmacDescLink(sam_dmac_desc_t *descp, const sam_dmac_desc_t *next)
+{
+  descp->DMAC_DESCADDR = (uint32_t)next;
+}
+
+/**
+ * @brief Load a chain of descriptors into the DMAC Channel
+ * The first descriptor is copied into the channel descriptor, so a
+ * circular chain must link its last descriptor back to @p descp
+ * Can only run when the channel is not enabled
+ *
+ * @param id DMAC Channel
+ * @param descp first descriptor of the chain
+ */
+static inline void dmacChnlSetLinked(uint8_t id, const sam_dmac_desc_t *descp)
+{
+  dmac_descriptor_registers_t *dmacDescReg = _sam_dmac_chnl[id].desc;
+  dmacDescReg->DMAC_BTCTRL = descp->DMAC_BTCTRL;
+  dmacDescReg->DMAC_BTCNT = descp->DMAC_BTCNT;
+  dmacDescReg->DMAC_SRCADDR = descp->DMAC_SRCADDR;
+  dmacDescReg->DMAC_DSTADDR = descp->DMAC_DSTADDR;
+  dmacDescReg->DMAC_DESCADDR = descp->DMAC_DESCADDR;
+  /* No progress until the channel fetches the descriptor.*/
+  _sam_dmac_chnl[id].wb->DMAC_DESCADDR = 0U;
+}
 
 /**
  * @brief Get Destination address
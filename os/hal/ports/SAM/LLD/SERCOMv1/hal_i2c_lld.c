@@ -181,10 +181,93 @@ static void i2c_lld_set_address(I2CDriver *i2cp, i2caddr_t addr, bool dir)
   /* Wait for synchronization */
   sam_i2c_busy_wait(i2cp);
 }
+
+static void i2c_lld_dma_stop(I2CDriver *i2cp)
+{
+  dmacChnlDisable(i2cp->dmaTxId);
+  dmacChnlDisable(i2cp->dmaRxId);
+}
+
+static void i2c_lld_end_error(I2CDriver *i2cp)
+{
+  sercom_i2cm_registers_t *dp = i2cp->i2c;
+  i2c_lld_dma_stop(i2cp);
+  dp->SERCOM_CTRLB |= SERCOM_I2CM_CTRLB_CMD(3UL);
+  sam_i2c_busy_wait(i2cp);
+  dp->SERCOM_INTENCLR = SERCOM_I2CM_INTENCLR_Msk;
+  _i2c_wakeup_error_isr(i2cp);
+}
+
+/**
+ * @brief Hand the TX phase over to the DMAC
+ * Called with the current byte not yet written, the DMAC moves all the
+ * following bytes then the MB interrupt is enabled again for the last one
+ *
+ * @param i2cp pointer to the @p I2CDriver object
+ */
+static void i2c_lld_dma_tx(I2CDriver *i2cp)
+{
+  osalDbgAssert(i2cp->txbytes - 1U <= 0xFFFFU, "transfer too large");
+  dmacChnlSetBtCtrl(i2cp->dmaTxId, DMAC_BTCTRL_BLOCKACT_INT | DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_SRCINC_Msk | DMAC_BTCTRL_VALID_Msk);
+  dmacChnlSetDir(i2cp->dmaTxId, (uint32_t)&i2cp->i2c->SERCOM_DATA, (uint32_t)(i2cp->txptr + 1), (uint16_t)(i2cp->txbytes - 1U));
+  i2cp->i2c->SERCOM_INTENCLR = SERCOM_I2CM_INTENCLR_MB_Msk;
+  dmacChnlEnableIRQn(i2cp->dmaTxId);
+  dmacChnlEnable(i2cp->dmaTxId);
+}
+
+/**
+ * @brief Hand the RX phase over to the DMAC
+ * Called with the current byte not yet read, the DMAC reads all the
+ * following bytes but the last one, which has to be NACKed by the CPU
+ *
+ * @param i2cp pointer to the @p I2CDriver object
+ */
+static void i2c_lld_dma_rx(I2CDriver *i2cp)
+{
+  osalDbgAssert(i2cp->rxbytes - 2U <= 0xFFFFU, "transfer too large");
+  dmacChnlSetBtCtrl(i2cp->dmaRxId, DMAC_BTCTRL_BLOCKACT_INT | DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_DSTINC_Msk | DMAC_BTCTRL_VALID_Msk);
+  dmacChnlSetDir(i2cp->dmaRxId, (uint32_t)(i2cp->rxptr + 1), (uint32_t)&i2cp->i2c->SERCOM_DATA, (uint16_t)(i2cp->rxbytes - 2U));
+  i2cp->i2c->SERCOM_INTENCLR = SERCOM_I2CM_INTENCLR_SB_Msk;
+  dmacChnlEnableIRQn(i2cp->dmaRxId);
+  dmacChnlEnable(i2cp->dmaRxId);
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
 
+static void i2c_lld_serve_dma_tx_interrupt(I2CDriver *i2cp, uint8_t flag)
+{
+  if (flag & DMAC_CHINTFLAG_TERR_Msk)
+  {
+    i2cp->errors |= I2C_BUS_ERROR;
+    i2c_lld_end_error(i2cp);
+  }
+  else if (flag & DMAC_CHINTFLAG_TCMPL_Msk)
+  {
+    /* A NACK in the middle of the phase is reported here, on the MB of
+       the last byte.*/
+    i2cp->txptr += i2cp->txbytes;
+    i2cp->txbytes = 0U;
+    i2cp->i2c->SERCOM_INTENSET = SERCOM_I2CM_INTENSET_MB_Msk;
+  }
+}
+
+static void i2c_lld_serve_dma_rx_interrupt(I2CDriver *i2cp, uint8_t flag)
+{
+  if (flag & DMAC_CHINTFLAG_TERR_Msk)
+  {
+    i2cp->errors |= I2C_BUS_ERROR;
+    i2c_lld_end_error(i2cp);
+  }
+  else if (flag & DMAC_CHINTFLAG_TCMPL_Msk)
+  {
+    i2cp->rxptr += i2cp->rxbytes - 1U;
+    i2cp->rxbytes = 1U;
+    i2cp->i2c->SERCOM_INTENSET = SERCOM_I2CM_INTENSET_SB_Msk;
+  }
+}
+
 static void i2c_lld_serve_interrupt(I2CDriver *i2cp)
 {
   sercom_i2cm_registers_t *dp = i2cp->i2c;
@@ -211,10 +294,7 @@ static void i2c_lld_serve_interrupt(I2CDriver *i2cp)
     }
     if (i2cp->errors)
     {
-      dp->SERCOM_CTRLB |= SERCOM_I2CM_CTRLB_CMD(3UL);
-      sam_i2c_busy_wait(i2cp);
-      dp->SERCOM_INTENCLR = SERCOM_I2CM_INTENCLR_Msk;
-      _i2c_wakeup_error_isr(i2cp);
+      i2c_lld_end_error(i2cp);
     }
     else
     {
@@ -233,6 +313,10 @@ static void i2c_lld_serve_interrupt(I2CDriver *i2cp)
         }
         else {        
           dp->SERCOM_INTFLAG |= SERCOM_I2CM_INTFLAG_MB_Msk;
+          if (i2cp->txbytes >= SAM_I2C_DMA_THRESHOLD)
+          {
+            i2c_lld_dma_tx(i2cp);
+          }
           uint8_t data = (uint8_t)*i2cp->txptr;
           i2cp->txptr++;
           i2cp->txbytes--;
@@ -249,6 +333,10 @@ static void i2c_lld_serve_interrupt(I2CDriver *i2cp)
           sam_i2c_busy_wait(i2cp);
           isFinished = true;
         }
+        else if (i2cp->rxbytes >= SAM_I2C_DMA_THRESHOLD)
+        {
+          i2c_lld_dma_rx(i2cp);
+        }
         *i2cp->rxptr = dp->SERCOM_DATA;
         i2cp->rxptr++;
         i2cp->rxbytes--;
@@ -321,6 +409,38 @@ OSAL_IRQ_HANDLER(SERCOM5_HANDLER)
 }
 #endif
 
+/**
+ * @brief DMAC channels allocation
+ *
+ * @param i2cp pointer to the @p I2CDriver object
+ * @param rxstream channel to be allocated for RX
+ * @param txstream channel to be allocated for TX
+ * @param priority channels priority
+ * @param rxsrc RX trigger source
+ * @param txsrc TX trigger source
+ */
+static void i2c_lld_get_dma(I2CDriver *i2cp, uint8_t rxstream,
+                            uint8_t txstream, uint8_t priority,
+                            dmac_trigsrc_t rxsrc, dmac_trigsrc_t txsrc)
+{
+  int8_t dmacId = dmacChnlAllocI(rxstream, priority,
+                                 (sam_dmaisr_t)i2c_lld_serve_dma_rx_interrupt,
+                                 (void *)i2cp);
+  osalDbgAssert(dmacId >= 0, "unable to allocate DMAC channel");
+  i2cp->dmaRxId = (uint8_t)dmacId;
+
+  dmacId = dmacChnlAllocI(txstream, priority,
+                          (sam_dmaisr_t)i2c_lld_serve_dma_tx_interrupt,
+                          (void *)i2cp);
+  osalDbgAssert(dmacId >= 0, "unable to allocate DMAC channel");
+  i2cp->dmaTxId = (uint8_t)dmacId;
+
+  dmacChnlSetTrigSrc(i2cp->dmaTxId, txsrc);
+  dmacChnlSetTrigAct(i2cp->dmaTxId, BEAT);
+  dmacChnlSetTrigSrc(i2cp->dmaRxId, rxsrc);
+  dmacChnlSetTrigAct(i2cp->dmaRxId, BEAT);
+}
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -390,6 +510,8 @@ void i2c_lld_start(I2CDriver *i2cp)
     {
       sam_gclk_mux(SAM_SERCOM0_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM0_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM0_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM0_CORE_Val, 1);
+      i2c_lld_get_dma(i2cp, SAM_I2C0_DMARX_CHANNEL, SAM_I2C0_DMATX_CHANNEL,
+                      SAM_I2C0_DMA_PRIO, SERCOM0_RX, SERCOM0_TX);
       nvicEnableVector(SERCOM0_IRQn, SAM_SERCOM0_IRQ_PRIORITY);
     }
 #endif
@@ -399,6 +521,8 @@ void i2c_lld_start(I2CDriver *i2cp)
     {
       sam_gclk_mux(SAM_SERCOM1_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM1_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM1_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM1_CORE_Val, 1);
+      i2c_lld_get_dma(i2cp, SAM_I2C1_DMARX_CHANNEL, SAM_I2C1_DMATX_CHANNEL,
+                      SAM_I2C1_DMA_PRIO, SERCOM1_RX, SERCOM1_TX);
       nvicEnableVector(SERCOM1_IRQn, SAM_SERCOM1_IRQ_PRIORITY);
     }
 #endif
@@ -408,6 +532,8 @@ void i2c_lld_start(I2CDriver *i2cp)
     {
       sam_gclk_mux(SAM_SERCOM2_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM2_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM2_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM2_CORE_Val, 1);
+      i2c_lld_get_dma(i2cp, SAM_I2C2_DMARX_CHANNEL, SAM_I2C2_DMATX_CHANNEL,
+                      SAM_I2C2_DMA_PRIO, SERCOM2_RX, SERCOM2_TX);
       nvicEnableVector(SERCOM2_IRQn, SAM_SERCOM1_IRQ_PRIORITY);
     }
 #endif
@@ -417,6 +543,8 @@ void i2c_lld_start(I2CDriver *i2cp)
     {
       sam_gclk_mux(SAM_SERCOM3_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM3_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM3_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM3_CORE_Val, 1);
+      i2c_lld_get_dma(i2cp, SAM_I2C3_DMARX_CHANNEL, SAM_I2C3_DMATX_CHANNEL,
+                      SAM_I2C3_DMA_PRIO, SERCOM3_RX, SERCOM3_TX);
       nvicEnableVector(SERCOM3_IRQn, SAM_SERCOM3_IRQ_PRIORITY);
     }
 #endif
@@ -426,6 +554,8 @@ void i2c_lld_start(I2CDriver *i2cp)
     {
       sam_gclk_mux(SAM_SERCOM4_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM4_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM4_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM4_CORE_Val, 1);
+      i2c_lld_get_dma(i2cp, SAM_I2C4_DMARX_CHANNEL, SAM_I2C4_DMATX_CHANNEL,
+                      SAM_I2C4_DMA_PRIO, SERCOM4_RX, SERCOM4_TX);
       nvicEnableVector(SERCOM4_IRQn, SAM_SERCOM4_IRQ_PRIORITY);
     }
 #endif
@@ -435,6 +565,8 @@ void i2c_lld_start(I2CDriver *i2cp)
     {
       sam_gclk_mux(SAM_SERCOM5_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM5_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM5_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM5_CORE_Val, 1);
+      i2c_lld_get_dma(i2cp, SAM_I2C5_DMARX_CHANNEL, SAM_I2C5_DMATX_CHANNEL,
+                      SAM_I2C5_DMA_PRIO, SERCOM5_RX, SERCOM5_TX);
       nvicEnableVector(SERCOM5_IRQn, SAM_SERCOM5_IRQ_PRIORITY);
     }
 #endif
@@ -467,7 +599,10 @@ void i2c_lld_stop(I2CDriver *i2cp)
 {
   if (i2cp->state != I2C_STOP)
   {
+    i2c_lld_dma_stop(i2cp);
     i2c_lld_abort_operation(i2cp);
+    dmacChnlFreeI(i2cp->dmaRxId);
+    dmacChnlFreeI(i2cp->dmaTxId);
     /* Disables the peripheral.*/
 #if SAM_I2C_USE_SERCOM1 == TRUE
     if (&I2CD2 == i2cp)
@@ -538,6 +673,7 @@ msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
   msg = osalThreadSuspendTimeoutS(&i2cp->thread, timeout);
   if (msg == MSG_TIMEOUT)
   {
+    i2c_lld_dma_stop(i2cp);
     dp->SERCOM_CTRLB |= SERCOM_I2CM_CTRLB_CMD(3UL);
     sam_i2c_busy_wait(i2cp);
   }
@@ -609,6 +745,7 @@ msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
   msg = osalThreadSuspendTimeoutS(&i2cp->thread, timeout);
   if (msg == MSG_TIMEOUT)
   {
+    i2c_lld_dma_stop(i2cp);
     dp->SERCOM_CTRLB |= SERCOM_I2CM_CTRLB_CMD(3UL);
     sam_i2c_busy_wait(i2cp);
   }
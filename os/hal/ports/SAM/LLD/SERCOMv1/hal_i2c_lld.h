@@ -100,12 +100,107 @@
 #define SAM_I2C_BUSY_TIMEOUT 50
 #endif
 
+/**
+ * @brief   Minimum length of a transfer phase served by the DMAC.
+ * @details Shorter phases are served by the SERCOM interrupt, one byte
+ *          at time.
+ * @note    The first and the last byte of each phase are always handled
+ *          by the CPU, the minimum value is 3.
+ */
+#if !defined(SAM_I2C_DMA_THRESHOLD) || defined(__DOXYGEN__)
+#define SAM_I2C_DMA_THRESHOLD 4
+#endif
+
+#if !defined(SAM_I2C0_DMATX_CHANNEL)
+#define SAM_I2C0_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C0_DMARX_CHANNEL)
+#define SAM_I2C0_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C0_DMA_PRIO)
+#define SAM_I2C0_DMA_PRIO 1
+#endif
+
+#if !defined(SAM_I2C1_DMATX_CHANNEL)
+#define SAM_I2C1_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C1_DMARX_CHANNEL)
+#define SAM_I2C1_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C1_DMA_PRIO)
+#define SAM_I2C1_DMA_PRIO 1
+#endif
+
+#if !defined(SAM_I2C2_DMATX_CHANNEL)
+#define SAM_I2C2_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C2_DMARX_CHANNEL)
+#define SAM_I2C2_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C2_DMA_PRIO)
+#define SAM_I2C2_DMA_PRIO 1
+#endif
+
+#if !defined(SAM_I2C3_DMATX_CHANNEL)
+#define SAM_I2C3_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C3_DMARX_CHANNEL)
+#define SAM_I2C3_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C3_DMA_PRIO)
+#define SAM_I2C3_DMA_PRIO 1
+#endif
+
+#if !defined(SAM_I2C4_DMATX_CHANNEL)
+#define SAM_I2C4_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C4_DMARX_CHANNEL)
+#define SAM_I2C4_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C4_DMA_PRIO)
+#define SAM_I2C4_DMA_PRIO 1
+#endif
+
+#if !defined(SAM_I2C5_DMATX_CHANNEL)
+#define SAM_I2C5_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C5_DMARX_CHANNEL)
+#define SAM_I2C5_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_I2C5_DMA_PRIO)
+#define SAM_I2C5_DMA_PRIO 1
+#endif
+
+/**
+ * @brief I2C Driver requires DMAC to be enabled
+ *
+ */
+#if !defined(SAM_DMAC_REQUIRED)
+#define SAM_DMAC_REQUIRED
+#endif
+
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if SAM_I2C_DMA_THRESHOLD < 3
+#error "invalid SAM_I2C_DMA_THRESHOLD value"
+#endif
+
 #if SAM_I2C_USE_SERCOM0 == TRUE
 #if SAM_SIO_USE_SERCOM0 == TRUE || SAM_SPI_USE_SERCOM0 == TRUE
 #error "SERCOM0: Can only configured as one function only"
@@ -225,6 +320,14 @@ struct hal_i2c_driver
   size_t rxbytes;
   sercom_i2cm_registers_t *i2c;
   i2caddr_t addr;
+  /**
+   * @brief     DMAC channel used in the TX phase.
+   */
+  uint8_t dmaTxId;
+  /**
+   * @brief     DMAC channel used in the RX phase.
+   */
+  uint8_t dmaRxId;
   /* End of the mandatory fields.*/
 };
 
@@ -36,6 +36,15 @@
                                      SERCOM_USART_INT_CTRLA_RXPO_Msk)
 
 #define SERCOM_UART_CTRLB_FORBIDDEN (SERCOM_USART_INT_CTRLB_ENC_Msk)
+
+#define SIO_DMA_RX_SEGMENT_SIZE (SAM_SIO_DMA_RX_BUFFER_SIZE / SAM_SIO_DMA_RX_SEGMENTS)
+
+#define SIO_DMA_RX_BTCTRL (DMAC_BTCTRL_BLOCKACT_INT |  \
+                           DMAC_BTCTRL_BEATSIZE_BYTE | \
+                           DMAC_BTCTRL_DSTINC_Msk)
+
+#define SIO_DMA_TX_BTCTRL (DMAC_BTCTRL_BEATSIZE_BYTE | \
+                           DMAC_BTCTRL_SRCINC_Msk)
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -148,10 +157,297 @@ static inline void usart_enable_tx_end_irq(SIODriver *siop)
   }
 }
 
+#if (SAM_SIO_USE_DMA == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief Index of the next frame written by the RX DMAC channel
+ *
+ * @param siop pointer to the @p SIODriver object
+ * @return size_t write index into the circular RX buffer
+ */
+static size_t usart_dma_rx_wridx(SIODriver *siop)
+{
+  syssts_t sts;
+  uint32_t next;
+  uint16_t remaining;
+  size_t seg;
+
+  sts = osalSysGetStatusAndLockX();
+  remaining = dmacChnlGetProgressI(siop->dmaRxId, &next);
+  osalSysRestoreStatusX(sts);
+
+  /* Nothing received since the channel has been started.*/
+  if (next == 0U)
+  {
+    return 0U;
+  }
+
+  /* The write-back descriptor links to the segment after the one being
+     filled.*/
+  seg = (size_t)(next - (uint32_t)&siop->rxdesc[0]) / sizeof(sam_dmac_desc_t);
+  seg = (seg + SAM_SIO_DMA_RX_SEGMENTS - 1U) % SAM_SIO_DMA_RX_SEGMENTS;
+
+  return (seg * SIO_DMA_RX_SEGMENT_SIZE + SIO_DMA_RX_SEGMENT_SIZE - remaining) %
+         SAM_SIO_DMA_RX_BUFFER_SIZE;
+}
+
+/**
+ * @brief Program the TX DMAC channel with the queued frames
+ * The frames are sent by one descriptor or, when they wrap around the end
+ * of the buffer, by two linked descriptors
+ * Must be called with the lock held and the TX channel idle
+ *
+ * @param siop pointer to the @p SIODriver object
+ */
+static void usart_dma_tx_kick(SIODriver *siop)
+{
+  size_t n1, n2;
+
+  if (siop->txcnt == 0U)
+  {
+    return;
+  }
+
+  n1 = siop->txcnt;
+  n2 = 0U;
+  if (siop->txrdidx + n1 > SAM_SIO_DMA_TX_BUFFER_SIZE)
+  {
+    n1 = SAM_SIO_DMA_TX_BUFFER_SIZE - siop->txrdidx;
+    n2 = siop->txcnt - n1;
+  }
+
+  dmacDescSetup(&siop->txdesc[0], SIO_DMA_TX_BTCTRL,
+                (uint32_t)&siop->usart->SERCOM_DATA,
+                (uint32_t)&siop->txbuf[siop->txrdidx], (uint16_t)n1);
+  if (n2 > 0U)
+  {
+    dmacDescSetup(&siop->txdesc[1], SIO_DMA_TX_BTCTRL | DMAC_BTCTRL_BLOCKACT_INT,
+                  (uint32_t)&siop->usart->SERCOM_DATA,
+                  (uint32_t)&siop->txbuf[0], (uint16_t)n2);
+    dmacDescLink(&siop->txdesc[0], &siop->txdesc[1]);
+  }
+  else
+  {
+    siop->txdesc[0].DMAC_BTCTRL |= DMAC_BTCTRL_BLOCKACT_INT;
+  }
+
+  siop->txdmacnt = n1 + n2;
+  dmacChnlSetLinked(siop->dmaTxId, &siop->txdesc[0]);
+  dmacChnlEnableIRQn(siop->dmaTxId);
+  dmacChnlEnable(siop->dmaTxId);
+}
+
+/**
+ * @brief Start the circular reception
+ * The RX buffer is filled by a ring of linked descriptors, one for each
+ * segment
+ *
+ * @param siop pointer to the @p SIODriver object
+ */
+static void usart_dma_rx_start(SIODriver *siop)
+{
+  unsigned i;
+
+  dmacChnlDisable(siop->dmaRxId);
+  dmacChnlDisable(siop->dmaTxId);
+
+  for (i = 0U; i < SAM_SIO_DMA_RX_SEGMENTS; i++)
+  {
+    dmacDescSetup(&siop->rxdesc[i], SIO_DMA_RX_BTCTRL,
+                  (uint32_t)&siop->rxbuf[i * SIO_DMA_RX_SEGMENT_SIZE],
+                  (uint32_t)&siop->usart->SERCOM_DATA, SIO_DMA_RX_SEGMENT_SIZE);
+    dmacDescLink(&siop->rxdesc[i], &siop->rxdesc[(i + 1U) % SAM_SIO_DMA_RX_SEGMENTS]);
+  }
+  siop->rxrdidx = 0U;
+  siop->txrdidx = 0U;
+  siop->txcnt = 0U;
+  siop->txdmacnt = 0U;
+
+  dmacChnlSetLinked(siop->dmaRxId, &siop->rxdesc[0]);
+  dmacChnlEnableIRQn(siop->dmaRxId);
+  dmacChnlEnable(siop->dmaRxId);
+}
+
+/**
+ * @brief Copy frames out of the circular RX buffer
+ *
+ * @param siop pointer to the @p SIODriver object
+ * @param buffer pointer to the buffer for read frames
+ * @param n maximum number of frames to be read
+ * @return size_t number of frames read
+ */
+static size_t usart_dma_read(SIODriver *siop, uint8_t *buffer, size_t n)
+{
+  size_t wridx = usart_dma_rx_wridx(siop);
+  size_t rd = 0U;
+
+  while ((rd < n) && (siop->rxrdidx != wridx))
+  {
+    *buffer++ = siop->rxbuf[siop->rxrdidx];
+    siop->rxrdidx = (siop->rxrdidx + 1U) % SAM_SIO_DMA_RX_BUFFER_SIZE;
+    rd++;
+  }
+
+  /* If the RX buffer has been emptied then the interrupt is enabled again.*/
+  if (siop->rxrdidx == wridx)
+  {
+    usart_enable_rx_irq(siop);
+  }
+
+  return rd;
+}
+
+/**
+ * @brief Queue frames into the circular TX buffer
+ * The TX DMAC channel is started if idle
+ *
+ * @param siop pointer to the @p SIODriver object
+ * @param buffer pointer to the frames to be written
+ * @param n maximum number of frames to be written
+ * @return size_t number of frames queued
+ */
+static size_t usart_dma_write(SIODriver *siop, const uint8_t *buffer, size_t n)
+{
+  syssts_t sts;
+  size_t wridx, wr, i;
+
+  sts = osalSysGetStatusAndLockX();
+
+  wr = SAM_SIO_DMA_TX_BUFFER_SIZE - siop->txcnt;
+  if (wr > n)
+  {
+    wr = n;
+  }
+
+  wridx = (siop->txrdidx + siop->txcnt) % SAM_SIO_DMA_TX_BUFFER_SIZE;
+  for (i = 0U; i < wr; i++)
+  {
+    siop->txbuf[wridx] = *buffer++;
+    wridx = (wridx + 1U) % SAM_SIO_DMA_TX_BUFFER_SIZE;
+  }
+  siop->txcnt += wr;
+
+  if (siop->txdmacnt == 0U)
+  {
+    usart_dma_tx_kick(siop);
+  }
+
+  osalSysRestoreStatusX(sts);
+
+  return wr;
+}
+#endif /* SAM_SIO_USE_DMA == TRUE */
+
+/**
+ * @brief Replace the RXC and DRE flags with the state of the DMA buffers
+ *
+ * @param siop pointer to the @p SIODriver object
+ * @param irq_status SERCOM INTFLAG register value
+ * @return uint8_t INTFLAG value as seen by the events translation
+ */
+static inline uint8_t usart_data_flags(SIODriver *siop, uint8_t irq_status)
+{
+#if SAM_SIO_USE_DMA == TRUE
+  irq_status &= (uint8_t)~(SERCOM_USART_INT_INTFLAG_RXC_Msk |
+                           SERCOM_USART_INT_INTFLAG_DRE_Msk);
+  if (!sio_lld_is_rx_empty(siop))
+  {
+    irq_status |= SERCOM_USART_INT_INTFLAG_RXC_Msk;
+  }
+  if (!sio_lld_is_tx_full(siop))
+  {
+    irq_status |= SERCOM_USART_INT_INTFLAG_DRE_Msk;
+  }
+#else
+  (void)siop;
+#endif
+  return irq_status;
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
 
+#if (SAM_SIO_USE_DMA == TRUE) || defined(__DOXYGEN__)
+static void usart_serve_dma_rx_interrupt(SIODriver *siop, uint8_t flag)
+{
+  osalDbgAssert((flag & DMAC_CHINTFLAG_TERR_Msk) == 0U, "DMAC transfer error");
+
+  /* A segment has been filled.*/
+  if ((siop->enabled & SIO_EV_RXNOTEMPY) != 0U)
+  {
+    __sio_wakeup_rx(siop);
+    __sio_callback(siop);
+  }
+}
+
+static void usart_serve_dma_tx_interrupt(SIODriver *siop, uint8_t flag)
+{
+  osalDbgAssert((flag & DMAC_CHINTFLAG_TERR_Msk) == 0U, "DMAC transfer error");
+
+  osalSysLockFromISR();
+  siop->txrdidx = (siop->txrdidx + siop->txdmacnt) % SAM_SIO_DMA_TX_BUFFER_SIZE;
+  siop->txcnt -= siop->txdmacnt;
+  siop->txdmacnt = 0U;
+
+  /* Frames queued meanwhile are sent right away, the transmission end is
+     only notified once the buffer has been drained.*/
+  usart_dma_tx_kick(siop);
+  if (siop->txcnt == 0U)
+  {
+    usart_enable_tx_end_irq(siop);
+  }
+  osalSysUnlockFromISR();
+
+  if ((siop->enabled & SIO_EV_TXNOTFULL) != 0U)
+  {
+    __sio_wakeup_tx(siop);
+    __sio_callback(siop);
+  }
+}
+
+/**
+ * @brief DMAC channels allocation
+ *
+ * @param siop pointer to the @p SIODriver object
+ * @param rxstream channel to be allocated for RX
+ * @param txstream channel to be allocated for TX
+ * @param priority channels priority
+ * @param rxsrc RX trigger source
+ * @param txsrc TX trigger source
+ * @return msg_t the operation status
+ */
+static msg_t usart_get_dma(SIODriver *siop, uint8_t rxstream,
+                           uint8_t txstream, uint8_t priority,
+                           dmac_trigsrc_t rxsrc, dmac_trigsrc_t txsrc)
+{
+  int8_t dmacId = dmacChnlAllocI(rxstream, priority,
+                                 (sam_dmaisr_t)usart_serve_dma_rx_interrupt,
+                                 (void *)siop);
+  if (dmacId < 0)
+  {
+    return HAL_RET_NO_RESOURCE;
+  }
+  siop->dmaRxId = (uint8_t)dmacId;
+
+  dmacId = dmacChnlAllocI(txstream, priority,
+                          (sam_dmaisr_t)usart_serve_dma_tx_interrupt,
+                          (void *)siop);
+  if (dmacId < 0)
+  {
+    dmacChnlFreeI(siop->dmaRxId);
+    return HAL_RET_NO_RESOURCE;
+  }
+  siop->dmaTxId = (uint8_t)dmacId;
+
+  dmacChnlSetTrigSrc(siop->dmaTxId, txsrc);
+  dmacChnlSetTrigAct(siop->dmaTxId, BEAT);
+  dmacChnlSetTrigSrc(siop->dmaRxId, rxsrc);
+  dmacChnlSetTrigAct(siop->dmaRxId, BEAT);
+
+  return HAL_RET_SUCCESS;
+}
+#endif /* SAM_SIO_USE_DMA == TRUE */
+
 #if SAM_SIO_USE_SERCOM0 == TRUE
 OSAL_IRQ_HANDLER(SERCOM0_HANDLER)
 {
@@ -286,6 +582,17 @@ msg_t sio_lld_start(SIODriver *siop)
       sam_gclk_mux(SAM_SERCOM0_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM0_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM0_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM0_CORE_Val, 1);
       usart_reset(&SIOD1);
+#if SAM_SIO_USE_DMA == TRUE
+      msg_t msg = usart_get_dma(siop,
+                                SAM_SIO0_DMARX_CHANNEL,
+                                SAM_SIO0_DMATX_CHANNEL,
+                                SAM_SIO0_DMA_PRIO,
+                                SERCOM0_RX, SERCOM0_TX);
+      if (msg != HAL_RET_SUCCESS)
+      {
+        return msg;
+      }
+#endif
       nvicEnableVector(SERCOM0_IRQn, SAM_SERCOM0_IRQ_PRIORITY);
     }
 #endif
@@ -296,6 +603,17 @@ msg_t sio_lld_start(SIODriver *siop)
       sam_gclk_mux(SAM_SERCOM1_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM1_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM1_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM1_CORE_Val, 1);
       usart_reset(&SIOD2);
+#if SAM_SIO_USE_DMA == TRUE
+      msg_t msg = usart_get_dma(siop,
+                                SAM_SIO1_DMARX_CHANNEL,
+                                SAM_SIO1_DMATX_CHANNEL,
+                                SAM_SIO1_DMA_PRIO,
+                                SERCOM1_RX, SERCOM1_TX);
+      if (msg != HAL_RET_SUCCESS)
+      {
+        return msg;
+      }
+#endif
       nvicEnableVector(SERCOM1_IRQn, SAM_SERCOM1_IRQ_PRIORITY);
     }
 #endif
@@ -306,6 +624,17 @@ msg_t sio_lld_start(SIODriver *siop)
       sam_gclk_mux(SAM_SERCOM2_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM2_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM2_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM2_CORE_Val, 1);
       usart_reset(&SIOD3);
+#if SAM_SIO_USE_DMA == TRUE
+      msg_t msg = usart_get_dma(siop,
+                                SAM_SIO2_DMARX_CHANNEL,
+                                SAM_SIO2_DMATX_CHANNEL,
+                                SAM_SIO2_DMA_PRIO,
+                                SERCOM2_RX, SERCOM2_TX);
+      if (msg != HAL_RET_SUCCESS)
+      {
+        return msg;
+      }
+#endif
       nvicEnableVector(SERCOM2_IRQn, SAM_SERCOM2_IRQ_PRIORITY);
     }
 #endif
@@ -316,6 +645,17 @@ msg_t sio_lld_start(SIODriver *siop)
       sam_gclk_mux(SAM_SERCOM3_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM3_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM3_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM3_CORE_Val, 1);
       usart_reset(&SIOD4);
+#if SAM_SIO_USE_DMA == TRUE
+      msg_t msg = usart_get_dma(siop,
+                                SAM_SIO3_DMARX_CHANNEL,
+                                SAM_SIO3_DMATX_CHANNEL,
+                                SAM_SIO3_DMA_PRIO,
+                                SERCOM3_RX, SERCOM3_TX);
+      if (msg != HAL_RET_SUCCESS)
+      {
+        return msg;
+      }
+#endif
       nvicEnableVector(SERCOM3_IRQn, SAM_SERCOM3_IRQ_PRIORITY);
     }
 #endif
@@ -326,6 +666,17 @@ msg_t sio_lld_start(SIODriver *siop)
       sam_gclk_mux(SAM_SERCOM4_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM4_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM4_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM4_CORE_Val, 1);
       usart_reset(&SIOD5);
+#if SAM_SIO_USE_DMA == TRUE
+      msg_t msg = usart_get_dma(siop,
+                                SAM_SIO4_DMARX_CHANNEL,
+                                SAM_SIO4_DMATX_CHANNEL,
+                                SAM_SIO4_DMA_PRIO,
+                                SERCOM4_RX, SERCOM4_TX);
+      if (msg != HAL_RET_SUCCESS)
+      {
+        return msg;
+      }
+#endif
       nvicEnableVector(SERCOM4_IRQn, SAM_SERCOM4_IRQ_PRIORITY);
     }
 #endif
@@ -336,12 +687,26 @@ msg_t sio_lld_start(SIODriver *siop)
       sam_gclk_mux(SAM_SERCOM5_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM5_CORE_Val, 0);
       sam_gclk_mux(SAM_SERCOM5_GCLK_SRC_ID, GCLK_CLKCTRL_ID_SERCOM5_CORE_Val, 1);
       usart_reset(&SIOD6);
+#if SAM_SIO_USE_DMA == TRUE
+      msg_t msg = usart_get_dma(siop,
+                                SAM_SIO5_DMARX_CHANNEL,
+                                SAM_SIO5_DMATX_CHANNEL,
+                                SAM_SIO5_DMA_PRIO,
+                                SERCOM5_RX, SERCOM5_TX);
+      if (msg != HAL_RET_SUCCESS)
+      {
+        return msg;
+      }
+#endif
       nvicEnableVector(SERCOM5_IRQn, SAM_SERCOM5_IRQ_PRIORITY);
     }
 #endif
   }
   /* Configures the peripheral.*/
   usart_init(siop);
+#if SAM_SIO_USE_DMA == TRUE
+  usart_dma_rx_start(siop);
+#endif
   return HAL_RET_SUCCESS;
 }
 
@@ -359,6 +724,10 @@ void sio_lld_stop(SIODriver *siop)
   {
     /* Resets the peripheral.*/
     siop->usart->SERCOM_INTENCLR = SERCOM_USART_INT_INTENCLR_Msk;
+#if SAM_SIO_USE_DMA == TRUE
+    dmacChnlFreeI(siop->dmaRxId);
+    dmacChnlFreeI(siop->dmaTxId);
+#endif
     // disable sercom
     siop->usart->SERCOM_CTRLA &= ~SERCOM_USART_INT_CTRLA_ENABLE_Msk;
     while ((siop->usart->SERCOM_SYNCBUSY & SERCOM_USART_INT_SYNCBUSY_ENABLE_Msk) != 0U)
@@ -439,6 +808,13 @@ void sio_lld_update_enable_flags(SIODriver *siop)
              __sio_reloc_field(siop->enabled, SIO_EV_FRAMING_ERR, SIO_EV_FRAMING_ERR_POS, SERCOM_USART_INT_INTENSET_ERROR_Pos) |
              __sio_reloc_field(siop->enabled, SIO_EV_TXDONE, SIO_EV_TXDONE_POS, SERCOM_USART_INT_INTENSET_TXC_Pos);
 
+#if SAM_SIO_USE_DMA == TRUE
+  /* The data interrupts are only armed when the DMA buffers are found
+     empty or full.*/
+  intenset &= (uint8_t)~(SERCOM_USART_INT_INTENSET_RXC_Msk |
+                         SERCOM_USART_INT_INTENSET_DRE_Msk);
+#endif
+
   /* Setting up the operation.*/
   siop->usart->SERCOM_INTENSET = intenset;
 }
@@ -482,7 +858,7 @@ sioevents_t sio_lld_get_and_clear_events(SIODriver *siop)
   uint8_t status = 0;
   uint8_t irq_status = 0;
   status = (uint8_t)(siop->usart->SERCOM_STATUS);
-  irq_status = (uint8_t)(siop->usart->SERCOM_INTFLAG);
+  irq_status = usart_data_flags(siop, (uint8_t)(siop->usart->SERCOM_INTFLAG));
   // clear both status and intflag
   siop->usart->SERCOM_STATUS = SERCOM_USART_INT_STATUS_Msk;
   siop->usart->SERCOM_INTFLAG = SERCOM_USART_INT_INTFLAG_Msk;
@@ -512,7 +888,7 @@ sioevents_t sio_lld_get_events(SIODriver *siop)
   uint8_t status = 0;
   uint8_t irq_status = 0;
   status = (uint8_t)(siop->usart->SERCOM_STATUS);
-  irq_status = (uint8_t)(siop->usart->SERCOM_INTFLAG);
+  irq_status = usart_data_flags(siop, (uint8_t)(siop->usart->SERCOM_INTFLAG));
   events |= __sio_reloc_field(irq_status, SERCOM_USART_INT_INTFLAG_RXC_Msk, SERCOM_USART_INT_INTFLAG_RXC_Pos, SIO_EV_RXNOTEMPY_POS) |
             __sio_reloc_field(irq_status, SERCOM_USART_INT_INTFLAG_DRE_Msk, SERCOM_USART_INT_INTFLAG_DRE_Pos, SIO_EV_TXNOTFULL_POS) |
             __sio_reloc_field(irq_status, SERCOM_USART_INT_INTFLAG_TXC_Msk, SERCOM_USART_INT_INTFLAG_TXC_Pos, SIO_EV_TXDONE_POS) |
@@ -520,6 +896,8 @@ sioevents_t sio_lld_get_events(SIODriver *siop)
             __sio_reloc_field(status, SERCOM_USART_INT_STATUS_BUFOVF_Msk, SERCOM_USART_INT_STATUS_BUFOVF_Pos, SIO_EV_OVERRUN_ERR_POS) |
             __sio_reloc_field(status, SERCOM_USART_INT_STATUS_FERR_Msk, SERCOM_USART_INT_STATUS_FERR_Pos, SIO_EV_FRAMING_ERR_POS) |
             __sio_reloc_field(status, SERCOM_USART_INT_STATUS_PERR_Msk, SERCOM_USART_INT_STATUS_PERR_Pos, SIO_EV_PARITY_ERR_POS);
+
+  return events;
 }
 
 /**
@@ -535,7 +913,9 @@ sioevents_t sio_lld_get_events(SIODriver *siop)
  */
 size_t sio_lld_read(SIODriver *siop, uint8_t *buffer, size_t n)
 {
-
+#if SAM_SIO_USE_DMA == TRUE
+  return usart_dma_read(siop, buffer, n);
+#else
   size_t rd;
 
   rd = 0U;
@@ -560,6 +940,7 @@ size_t sio_lld_read(SIODriver *siop, uint8_t *buffer, size_t n)
   }
 
   return rd;
+#endif
 }
 
 /**
@@ -575,7 +956,9 @@ size_t sio_lld_read(SIODriver *siop, uint8_t *buffer, size_t n)
  */
 size_t sio_lld_write(SIODriver *siop, const uint8_t *buffer, size_t n)
 {
-
+#if SAM_SIO_USE_DMA == TRUE
+  return usart_dma_write(siop, buffer, n);
+#else
   size_t wr;
 
   wr = 0U;
@@ -603,6 +986,7 @@ size_t sio_lld_write(SIODriver *siop, const uint8_t *buffer, size_t n)
   usart_enable_tx_end_irq(siop);
 
   return wr;
+#endif
 }
 
 /**
@@ -618,6 +1002,11 @@ msg_t sio_lld_get(SIODriver *siop)
 {
   msg_t msg;
 
+#if SAM_SIO_USE_DMA == TRUE
+  uint8_t data = 0U;
+  (void)usart_dma_read(siop, &data, 1U);
+  msg = data;
+#else
   msg = (uint8_t)(siop->usart->SERCOM_DATA);
 
   /* If the RX FIFO has been emptied then the interrupt is enabled again.*/
@@ -625,6 +1014,7 @@ msg_t sio_lld_get(SIODriver *siop)
   {
     usart_enable_rx_irq(siop);
   }
+#endif
 
   return msg;
 }
@@ -640,7 +1030,10 @@ msg_t sio_lld_get(SIODriver *siop)
  */
 void sio_lld_put(SIODriver *siop, uint_fast16_t data)
 {
-
+#if SAM_SIO_USE_DMA == TRUE
+  uint8_t frame = (uint8_t)data;
+  (void)usart_dma_write(siop, &frame, 1U);
+#else
   siop->usart->SERCOM_DATA = (uint8_t)data;
 
   /* If the TX FIFO has been filled then the interrupt is enabled again.*/
@@ -651,6 +1044,7 @@ void sio_lld_put(SIODriver *siop, uint_fast16_t data)
 
   /* The transmit complete interrupt is always re-enabled on write.*/
   usart_enable_tx_end_irq(siop);
+#endif
 }
 
 /**
@@ -677,6 +1071,64 @@ msg_t sio_lld_control(SIODriver *siop, unsigned int operation, void *arg)
   return MSG_OK;
 }
 
+#if (SAM_SIO_USE_DMA == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Determines the state of the RX buffer.
+ * @note    The RX interrupt is armed when the buffer is found empty.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @return              The RX buffer state.
+ * @retval false        if RX buffer is not empty
+ * @retval true         if RX buffer is empty
+ *
+ * @notapi
+ */
+bool sio_lld_is_rx_empty(SIODriver *siop)
+{
+  bool empty = siop->rxrdidx == usart_dma_rx_wridx(siop);
+
+  if (empty)
+  {
+    usart_enable_rx_irq(siop);
+  }
+
+  return empty;
+}
+
+/**
+ * @brief   Determines the state of the TX buffer.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @return              The TX buffer state.
+ * @retval false        if TX buffer is not full
+ * @retval true         if TX buffer is full
+ *
+ * @notapi
+ */
+bool sio_lld_is_tx_full(SIODriver *siop)
+{
+
+  return siop->txcnt >= SAM_SIO_DMA_TX_BUFFER_SIZE;
+}
+
+/**
+ * @brief   Determines the transmission state.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @return              The TX state.
+ * @retval false        if transmission is idle
+ * @retval true         if transmission is ongoing
+ *
+ * @notapi
+ */
+bool sio_lld_is_tx_ongoing(SIODriver *siop)
+{
+
+  return (siop->txcnt != 0U) ||
+         ((siop->usart->SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_TXC_Msk) == 0U);
+}
+#endif /* SAM_SIO_USE_DMA == TRUE */
+
 /**
  * @brief   Serves an UART interrupt.
  *
@@ -693,6 +1145,13 @@ void sio_lld_serve_interrupt(SIODriver *siop)
   uint8_t evtmask = intflag & (SERCOM_USART_INT_INTFLAG_ERROR_Msk |
                                SERCOM_USART_INT_INTFLAG_RXBRK_Msk);
   siop->usart->SERCOM_INTFLAG = SERCOM_USART_INT_INTFLAG_Msk;
+#if SAM_SIO_USE_DMA == TRUE
+  /* The DMAC may have read the frame already, an enabled RXC interrupt is
+     taken as the notification of RX activity.*/
+  intflag &= (uint8_t)~(SERCOM_USART_INT_INTFLAG_RXC_Msk |
+                        SERCOM_USART_INT_INTFLAG_DRE_Msk);
+  intflag |= intenset & SERCOM_USART_INT_INTENSET_RXC_Msk;
+#endif
   if (evtmask != 0)
   {
     __sio_wakeup_errors(siop);
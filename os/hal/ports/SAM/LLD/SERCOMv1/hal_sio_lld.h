@@ -92,11 +92,135 @@
 #if !defined(SAM_SIO_USE_SERCOM5) || defined(__DOXYGEN__)
 #define SAM_SIO_USE_SERCOM5 FALSE
 #endif
+
+/**
+ * @brief   Data moved by the DMAC switch.
+ * @details If set to @p TRUE the frames are moved between the SERCOM and
+ *          circular buffers in the driver by the DMAC, the CPU is only
+ *          interrupted once per buffer segment instead of once per frame.
+ */
+#if !defined(SAM_SIO_USE_DMA) || defined(__DOXYGEN__)
+#define SAM_SIO_USE_DMA TRUE
+#endif
+
+/**
+ * @brief   Size of the circular RX buffer.
+ */
+#if !defined(SAM_SIO_DMA_RX_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define SAM_SIO_DMA_RX_BUFFER_SIZE 64
+#endif
+
+/**
+ * @brief   Number of linked descriptors filling the RX buffer.
+ * @details An interrupt is raised each time a segment is filled.
+ */
+#if !defined(SAM_SIO_DMA_RX_SEGMENTS) || defined(__DOXYGEN__)
+#define SAM_SIO_DMA_RX_SEGMENTS 4
+#endif
+
+/**
+ * @brief   Size of the circular TX buffer.
+ */
+#if !defined(SAM_SIO_DMA_TX_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define SAM_SIO_DMA_TX_BUFFER_SIZE 64
+#endif
+
+#if !defined(SAM_SIO0_DMATX_CHANNEL)
+#define SAM_SIO0_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO0_DMARX_CHANNEL)
+#define SAM_SIO0_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO0_DMA_PRIO)
+#define SAM_SIO0_DMA_PRIO 1
+#endif
+
+#if !defined(SAM_SIO1_DMATX_CHANNEL)
+#define SAM_SIO1_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO1_DMARX_CHANNEL)
+#define SAM_SIO1_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO1_DMA_PRIO)
+#define SAM_SIO1_DMA_PRIO 1
+#endif
+
+#if !defined(SAM_SIO2_DMATX_CHANNEL)
+#define SAM_SIO2_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO2_DMARX_CHANNEL)
+#define SAM_SIO2_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO2_DMA_PRIO)
+#define SAM_SIO2_DMA_PRIO 1
+#endif
+
+#if !defined(SAM_SIO3_DMATX_CHANNEL)
+#define SAM_SIO3_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO3_DMARX_CHANNEL)
+#define SAM_SIO3_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO3_DMA_PRIO)
+#define SAM_SIO3_DMA_PRIO 1
+#endif
+
+#if !defined(SAM_SIO4_DMATX_CHANNEL)
+#define SAM_SIO4_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO4_DMARX_CHANNEL)
+#define SAM_SIO4_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO4_DMA_PRIO)
+#define SAM_SIO4_DMA_PRIO 1
+#endif
+
+#if !defined(SAM_SIO5_DMATX_CHANNEL)
+#define SAM_SIO5_DMATX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO5_DMARX_CHANNEL)
+#define SAM_SIO5_DMARX_CHANNEL SAM_DMAC_NUM_MAX
+#endif
+
+#if !defined(SAM_SIO5_DMA_PRIO)
+#define SAM_SIO5_DMA_PRIO 1
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
+#if SAM_SIO_USE_DMA == TRUE
+#if (SAM_SIO_DMA_RX_SEGMENTS < 2) ||                                         \
+    ((SAM_SIO_DMA_RX_BUFFER_SIZE % SAM_SIO_DMA_RX_SEGMENTS) != 0) ||         \
+    ((SAM_SIO_DMA_RX_BUFFER_SIZE / SAM_SIO_DMA_RX_SEGMENTS) > 0xFFFF)
+#error "invalid SAM_SIO_DMA_RX_BUFFER_SIZE or SAM_SIO_DMA_RX_SEGMENTS value"
+#endif
+
+#if (SAM_SIO_DMA_TX_BUFFER_SIZE < 1) || (SAM_SIO_DMA_TX_BUFFER_SIZE > 0xFFFF)
+#error "invalid SAM_SIO_DMA_TX_BUFFER_SIZE value"
+#endif
+
+/**
+ * @brief SIO Driver requires DMAC to be enabled
+ *
+ */
+#if !defined(SAM_DMAC_REQUIRED)
+#define SAM_DMAC_REQUIRED
+#endif
+#endif
+
 #if SAM_SIO_USE_SERCOM0 == TRUE
 #if SAM_SPI_USE_SERCOM0 == TRUE || SAM_I2C_USE_SERCOM0 == TRUE
 #error "SERCOM0: Can only configured as one function only"
@@ -144,9 +268,25 @@
 /**
  * @brief   Low level fields of the SIO driver structure.
  */
+#if (SAM_SIO_USE_DMA == TRUE) || defined(__DOXYGEN__)
+#define sio_lld_driver_fields                                          \
+  sercom_usart_int_registers_t *usart;                                 \
+  uint32_t clock;                                                      \
+  uint8_t dmaTxId;                                                     \
+  uint8_t dmaRxId;                                                     \
+  sam_dmac_desc_t rxdesc[SAM_SIO_DMA_RX_SEGMENTS] SAM_DMAC_DESC_ALIGN; \
+  sam_dmac_desc_t txdesc[2] SAM_DMAC_DESC_ALIGN;                       \
+  uint8_t rxbuf[SAM_SIO_DMA_RX_BUFFER_SIZE];                           \
+  size_t rxrdidx;                                                      \
+  uint8_t txbuf[SAM_SIO_DMA_TX_BUFFER_SIZE];                           \
+  size_t txrdidx;                                                      \
+  size_t txcnt;                                                        \
+  size_t txdmacnt;
+#else
 #define sio_lld_driver_fields          \
   sercom_usart_int_registers_t *usart; \
   uint32_t clock;
+#endif
 
 /**
  * @brief   Low level fields of the SIO configuration structure.
@@ -164,6 +304,7 @@
 
 #define SERCOM_CTRLB_DEFAULT (0)
 
+#if (SAM_SIO_USE_DMA == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Determines the state of the RX FIFO.
  *
@@ -176,6 +317,7 @@
  */
 #define sio_lld_is_rx_empty(siop) !((siop->usart->SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_RXC_Msk) == \
                                     SERCOM_USART_INT_INTFLAG_RXC_Msk)
+#endif
 
 /**
  * @brief   Determines the activity state of the receiver.
@@ -206,6 +348,7 @@
                                                                     SERCOM_USART_INT_STATUS_PERR_Msk) != 0) | \
                                      (siop->usart->SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_RXBRK_Msk) != 0)
 
+#if (SAM_SIO_USE_DMA == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Determines the state of the TX FIFO.
  *
@@ -231,6 +374,7 @@
  */
 #define sio_lld_is_tx_ongoing(siop) !((siop->usart->SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_TXC_Msk) == \
                                       SERCOM_USART_INT_INTFLAG_TXC_Msk)
+#endif
 
 /*===========================================================================*/
 /* External declarations.                                                    */
@@ -277,6 +421,11 @@ extern "C"
   void sio_lld_put(SIODriver *siop, uint_fast16_t data);
   msg_t sio_lld_control(SIODriver *siop, unsigned int operation, void *arg);
   void sio_lld_serve_interrupt(SIODriver *siop);
+#if SAM_SIO_USE_DMA == TRUE
+  bool sio_lld_is_rx_empty(SIODriver *siop);
+  bool sio_lld_is_tx_full(SIODriver *siop);
+  bool sio_lld_is_tx_ongoing(SIODriver *siop);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -16,7 +16,13 @@
 
 /**
  * @file    hal_adc_lld.c
- * @brief   PLATFORM ADC subsystem low level driver source.
+ * @brief   EFR32 IADC subsystem low level driver source.
+ * @details Conversions run in scan mode, the scan FIFO is emptied by an
+ *          LDMA stream into the samples buffer. The CPU is only interrupted
+ *          on half and full buffer so the system can stay in EM1 for the
+ *          whole conversion.
+ * @note    The analog bus allocation of the input pins is not managed by
+ *          this driver.
  *
  * @addtogroup ADC
  * @{
@@ -30,6 +36,35 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   CTRL word of the DMA descriptors.
+ */
+#define ADC_DMA_CTRL                (EFR32_DMA_CH_CTRL_STRUCTTYPE_TRANSFER | \
+                                     EFR32_DMA_CH_CTRL_BLOCKSIZE_UNIT1     | \
+                                     EFR32_DMA_CH_CTRL_REQMODE_BLOCK       | \
+                                     EFR32_DMA_CH_CTRL_SIZE_HALFWORD       | \
+                                     EFR32_DMA_CH_CTRL_SRCINC_NONE         | \
+                                     EFR32_DMA_CH_CTRL_DSTINC_ONE          | \
+                                     EFR32_DMA_CH_CTRL_DONEIEN)
+
+/**
+ * @brief   IADC error flags checked on each DMA interrupt.
+ */
+#define ADC_IF_ERRORS               (IADC_IF_SCANFIFOOF     | \
+                                     IADC_IF_PORTALLOCERR   | \
+                                     IADC_IF_POLARITYERR    | \
+                                     IADC_IF_EM23ABORTERROR)
+
+/**
+ * @brief   IADC timebase, HSCLK cycles in one microsecond minus one.
+ */
+#define ADC_TIMEBASE                (((EFR32_ADC_HSCLK + 999999U) / 1000000U) - 1U)
+
+/**
+ * @brief   ADC_CLK prescaler, the clock is kept within 10MHz.
+ */
+#define ADC_PRESCALE                (((EFR32_ADC_HSCLK + 9999999U) / 10000000U) - 1U)
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -37,7 +72,7 @@
 /**
  * @brief   ADC1 driver identifier.
  */
-#if (PLATFORM_ADC_USE_ADC1 == TRUE) || defined(__DOXYGEN__)
+#if (EFR32_ADC_USE_ADC1 == TRUE) || defined(__DOXYGEN__)
 ADCDriver ADCD1;
 #endif
 
@@ -49,6 +84,59 @@ ADCDriver ADCD1;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Stops the scan and empties the scan FIFO.
+ *
+ * @param[in] iadc      pointer to the IADC registers block
+ */
+static void adc_lld_scan_stop(IADC_TypeDef *iadc) {
+
+  iadc->CMD = IADC_CMD_SCANSTOP | IADC_CMD_TIMERSTOP;
+  while ((iadc->STATUS & (IADC_STATUS_CONVERTING |
+                          IADC_STATUS_SCANQUEUEPENDING)) != 0U) {
+  }
+  while ((iadc->SCANFIFOSTAT & _IADC_SCANFIFOSTAT_FIFOREADCNT_MASK) != 0U) {
+    (void)iadc->SCANFIFODATA;
+  }
+}
+
+/**
+ * @brief   Shared end-of-transfer service routine.
+ *
+ * @param[in] p         pointer to the @p ADCDriver object
+ * @param[in] flags     DMA ISR flags
+ */
+static void adc_lld_serve_dma_interrupt(void *p, uint32_t flags) {
+  ADCDriver *adcp = (ADCDriver *)p;
+  uint32_t ifr;
+
+  /* Converter errors are sampled here, the IADC interrupt is not used.*/
+  ifr = adcp->iadc->IF & ADC_IF_ERRORS;
+  adcp->iadc->IF_CLR = ifr;
+
+  if ((flags & EFR32_DMA_ISR_ERROR_MASK) != 0U) {
+    /* DMA errors are handled by the error callback.*/
+    _adc_isr_error_code(adcp, ADC_ERR_DMAFAILURE);
+  }
+  else if (ifr != 0U) {
+    /* Samples have been lost or the scan table is not valid.*/
+    _adc_isr_error_code(adcp, ADC_ERR_OVERFLOW);
+  }
+  else if (adcp->grpp != NULL) {
+    unsigned idx = adcp->dmaidx;
+
+    adcp->dmaidx = (idx + 1U) % adcp->dmandesc;
+    if (idx + 1U < adcp->dmandesc) {
+      /* Half transfer processing.*/
+      _adc_isr_half_code(adcp);
+    }
+    else {
+      /* Transfer complete processing.*/
+      _adc_isr_full_code(adcp);
+    }
+  }
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -64,9 +152,11 @@ ADCDriver ADCD1;
  */
 void adc_lld_init(void) {
 
-#if PLATFORM_ADC_USE_ADC1 == TRUE
+#if EFR32_ADC_USE_ADC1 == TRUE
   /* Driver initialization.*/
   adcObjectInit(&ADCD1);
+  ADCD1.iadc   = IADC0;
+  ADCD1.dmastp = NULL;
 #endif
 }
 
@@ -78,17 +168,47 @@ void adc_lld_init(void) {
  * @notapi
  */
 void adc_lld_start(ADCDriver *adcp) {
+  IADC_TypeDef *iadc = adcp->iadc;
 
   if (adcp->state == ADC_STOP) {
     /* Enables the peripheral.*/
-#if PLATFORM_ADC_USE_ADC1 == TRUE
+#if EFR32_ADC_USE_ADC1 == TRUE
     if (&ADCD1 == adcp) {
+      adcp->dmastp = dmaStreamAllocI(EFR32_ADC_ADC1_DMA_STREAM,
+                                     EFR32_ADC_ADC1_DMA_IRQ_PRIORITY,
+                                     adc_lld_serve_dma_interrupt,
+                                     (void *)adcp);
+      osalDbgAssert(adcp->dmastp != NULL, "unable to allocate stream");
+      dmaStreamSetSource(adcp->dmastp,
+                         LDMAXBAR_CH_REQSEL_SOURCESEL_IADC0 |
+                         LDMAXBAR_CH_REQSEL_SIGSEL_IADC0IADC_SCAN);
 
+      CMU->CLKEN0_SET = CMU_CLKEN0_IADC0;
+      CMU->IADCCLKCTRL = CMU_IADCCLKCTRL_CLKSEL_FSRCO;
     }
 #endif
   }
-  /* Configures the peripheral.*/
 
+  /* Configures the peripheral, the configuration registers can only be
+     written while the IADC is disabled.*/
+  iadc->EN_CLR = IADC_EN_EN;
+  while ((iadc->EN & IADC_EN_DISABLING) != 0U) {
+  }
+
+  iadc->CTRL = IADC_CTRL_WARMUPMODE_NORMAL |
+               IADC_CTRL_HSCLKRATE_DIV1 |
+               (ADC_TIMEBASE << _IADC_CTRL_TIMEBASE_SHIFT);
+  iadc->CFG[0].CFG = adcp->config->cfg;
+  if (adcp->config->scale != 0U) {
+    iadc->CFG[0].SCALE = adcp->config->scale;
+  }
+  iadc->CFG[0].SCHED = ADC_PRESCALE << _IADC_SCHED_PRESCALE_SHIFT;
+
+  /* A DMA request for each sample in the scan FIFO.*/
+  iadc->SCANFIFOCFG = IADC_SCANFIFOCFG_ALIGNMENT_RIGHT12 |
+                      IADC_SCANFIFOCFG_DVL_VALID1;
+  iadc->IEN = 0U;
+  iadc->IF_CLR = _IADC_IF_MASK;
 }
 
 /**
@@ -102,11 +222,15 @@ void adc_lld_stop(ADCDriver *adcp) {
 
   if (adcp->state == ADC_READY) {
     /* Resets the peripheral.*/
+    adcp->iadc->EN_CLR = IADC_EN_EN;
+
+    dmaStreamFreeI(adcp->dmastp);
+    adcp->dmastp = NULL;
 
     /* Disables the peripheral.*/
-#if PLATFORM_ADC_USE_ADC1 == TRUE
+#if EFR32_ADC_USE_ADC1 == TRUE
     if (&ADCD1 == adcp) {
-
+      CMU->CLKEN0_CLR = CMU_CLKEN0_IADC0;
     }
 #endif
   }
@@ -114,14 +238,83 @@ void adc_lld_stop(ADCDriver *adcp) {
 
 /**
  * @brief   Starts an ADC conversion.
+ * @details The samples buffer is split in two halves, each one filled by
+ *          a DMA descriptor. In circular mode the two descriptors are
+ *          linked in a ring.
  *
  * @param[in] adcp      pointer to the @p ADCDriver object
  *
  * @notapi
  */
 void adc_lld_start_conversion(ADCDriver *adcp) {
+  IADC_TypeDef *iadc = adcp->iadc;
+  const ADCConversionGroup *grpp = adcp->grpp;
+  size_t n1, n2;
+  unsigned i;
 
-  (void)adcp;
+  osalDbgAssert(grpp->num_channels <= EFR32_ADC_MAX_CHANNELS,
+                "too many channels");
+
+  n1 = (size_t)grpp->num_channels * (adcp->depth / 2U);
+  n2 = (size_t)grpp->num_channels * adcp->depth - n1;
+  osalDbgAssert(n2 <= EFR32_ADC_MAX_DMA_XFER, "buffer too large");
+
+  /* Trigger, the scan is repeated back to back or paced by the timer.*/
+  iadc->EN_CLR = IADC_EN_EN;
+  while ((iadc->EN & IADC_EN_DISABLING) != 0U) {
+  }
+  if (grpp->timer == 0U) {
+    iadc->TRIGGER = IADC_TRIGGER_SCANTRIGSEL_IMMEDIATE |
+                    IADC_TRIGGER_SCANTRIGACTION_CONTINUOUS;
+  }
+  else {
+    iadc->TRIGGER = IADC_TRIGGER_SCANTRIGSEL_TIMER |
+                    IADC_TRIGGER_SCANTRIGACTION_ONCE;
+    iadc->TIMER = grpp->timer << _IADC_TIMER_TIMER_SHIFT;
+  }
+  iadc->EN_SET = IADC_EN_EN;
+
+  /* Scan table.*/
+  for (i = 0U; i < grpp->num_channels; i++) {
+    iadc->SCANTABLE[i].SCAN = grpp->scan[i];
+  }
+  iadc->MASKREQ = (1U << grpp->num_channels) - 1U;
+  adc_lld_scan_stop(iadc);
+  iadc->IF_CLR = _IADC_IF_MASK;
+
+  /* DMA setup, a single descriptor if the buffer has depth one.*/
+  adcp->dmaidx = 0U;
+  if (n1 == 0U) {
+    adcp->dmandesc = 1U;
+    adcp->dmadesc[0].ctrl = ADC_DMA_CTRL | EFR32_DMA_CH_CTRL_XFERCNT(n2);
+    adcp->dmadesc[0].src  = (uint32_t)&iadc->SCANFIFODATA;
+    adcp->dmadesc[0].dst  = (uint32_t)adcp->samples;
+    adcp->dmadesc[0].link = grpp->circular ?
+                            EFR32_DMA_DESC_LINK(&adcp->dmadesc[0]) :
+                            EFR32_DMA_DESC_LINK_NONE;
+  }
+  else {
+    adcp->dmandesc = 2U;
+    adcp->dmadesc[0].ctrl = ADC_DMA_CTRL | EFR32_DMA_CH_CTRL_XFERCNT(n1);
+    adcp->dmadesc[0].src  = (uint32_t)&iadc->SCANFIFODATA;
+    adcp->dmadesc[0].dst  = (uint32_t)adcp->samples;
+    adcp->dmadesc[0].link = EFR32_DMA_DESC_LINK(&adcp->dmadesc[1]);
+    adcp->dmadesc[1].ctrl = ADC_DMA_CTRL | EFR32_DMA_CH_CTRL_XFERCNT(n2);
+    adcp->dmadesc[1].src  = (uint32_t)&iadc->SCANFIFODATA;
+    adcp->dmadesc[1].dst  = (uint32_t)&adcp->samples[n1];
+    adcp->dmadesc[1].link = grpp->circular ?
+                            EFR32_DMA_DESC_LINK(&adcp->dmadesc[0]) :
+                            EFR32_DMA_DESC_LINK_NONE;
+  }
+  dmaStreamStartLinked(adcp->dmastp, &adcp->dmadesc[0]);
+
+  /* Starting conversion.*/
+  if (grpp->timer == 0U) {
+    iadc->CMD = IADC_CMD_SCANSTART;
+  }
+  else {
+    iadc->CMD = IADC_CMD_SCANSTART | IADC_CMD_TIMERSTART;
+  }
 }
 
 /**
@@ -133,7 +326,8 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
  */
 void adc_lld_stop_conversion(ADCDriver *adcp) {
 
-  (void)adcp;
+  dmaStreamDisable(adcp->dmastp);
+  adc_lld_scan_stop(adcp->iadc);
 }
 
 #endif /* HAL_USE_ADC == TRUE */
@@ -16,7 +16,7 @@
 
 /**
  * @file    hal_adc_lld.h
- * @brief   PLATFORM ADC subsystem low level driver header.
+ * @brief   EFR32 IADC subsystem low level driver header.
  *
  * @addtogroup ADC
  * @{
@@ -40,21 +40,62 @@
 #define ADC_ERR_AWD             4U  /**< Watchdog triggered.                */
 /** @} */
 
+/**
+ * @brief   Number of entries of the IADC scan table.
+ */
+#define EFR32_ADC_MAX_CHANNELS  16U
+
+/**
+ * @brief   Largest number of samples moved by a single DMA descriptor.
+ */
+#define EFR32_ADC_MAX_DMA_XFER  2048U
+
+/**
+ * @brief   IADC HSCLK frequency, the IADC is clocked by FSRCO.
+ */
+#define EFR32_ADC_HSCLK         EFR32_FSRCOCLK
+
+/**
+ * @brief   Scan table entry of a single ended conversion against ground.
+ *
+ * @param[in] port      positive input port, one of the IADC_SCAN_PORTPOS_*
+ *                      values shifted down
+ * @param[in] pin       positive input pin number
+ */
+#define EFR32_ADC_SCAN_SINGLE_ENDED(port, pin)                              \
+  ((((uint32_t)(port) << _IADC_SCAN_PORTPOS_SHIFT) & _IADC_SCAN_PORTPOS_MASK) | \
+   (((uint32_t)(pin)  << _IADC_SCAN_PINPOS_SHIFT)  & _IADC_SCAN_PINPOS_MASK)  | \
+   IADC_SCAN_PORTNEG_GND)
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
 /**
- * @name    PLATFORM configuration options
+ * @name    Configuration options
  * @{
  */
 /**
  * @brief   ADC1 driver enable switch.
- * @details If set to @p TRUE the support for ADC1 is included.
+ * @details If set to @p TRUE the support for IADC0 is included.
  * @note    The default is @p FALSE.
  */
-#if !defined(PLATFORM_ADC_USE_ADC1) || defined(__DOXYGEN__)
-#define PLATFORM_ADC_USE_ADC1                  FALSE
+#if !defined(EFR32_ADC_USE_ADC1) || defined(__DOXYGEN__)
+#define EFR32_ADC_USE_ADC1                  FALSE
+#endif
+
+/**
+ * @brief   ADC1 DMA stream.
+ */
+#if !defined(EFR32_ADC_ADC1_DMA_STREAM) || defined(__DOXYGEN__)
+#define EFR32_ADC_ADC1_DMA_STREAM           EFR32_DMA_STREAM_ID_ANY
+#endif
+
+/**
+ * @brief   ADC1 DMA interrupt priority level setting.
+ */
+#if !defined(EFR32_ADC_ADC1_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define EFR32_ADC_ADC1_DMA_IRQ_PRIORITY     4
 #endif
 /** @} */
 
@@ -62,6 +103,12 @@
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if EFR32_ADC_USE_ADC1
+#if !defined(EFR32_DMA_REQUIRED)
+#define EFR32_DMA_REQUIRED
+#endif
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -89,28 +136,40 @@ typedef uint32_t adcerror_t;
  * @brief   Low level fields of the ADC driver structure.
  */
 #define adc_lld_driver_fields                                               \
-  /* Dummy field, it is not needed.*/                                       \
-  uint32_t                  dummy
+  /* Pointer to the IADCx registers block.*/                                \
+  IADC_TypeDef              *iadc;                                          \
+  /* Pointer to associated DMA stream.*/                                    \
+  const efr32_dma_stream_t  *dmastp;                                        \
+  /* DMA descriptors, each one fills half buffer.*/                         \
+  efr32_dma_descriptor_t    dmadesc[2];                                     \
+  /* Index of the descriptor the next DMA interrupt belongs to.*/           \
+  unsigned                  dmaidx;                                         \
+  /* Number of descriptors of the current conversion.*/                     \
+  unsigned                  dmandesc
 
 /**
  * @brief   Low level fields of the ADC configuration structure.
  */
 #define adc_lld_config_fields                                               \
-  /* Dummy configuration, it is not needed.*/                               \
-  uint32_t                  dummy
+  /* IADC CFG register of configuration 0: mode, OSR, gain, reference.*/    \
+  uint32_t                  cfg;                                            \
+  /* IADC SCALE register of configuration 0, zero keeps the default.*/      \
+  uint32_t                  scale
 
 /**
  * @brief   Low level fields of the ADC configuration structure.
  */
 #define adc_lld_configuration_group_fields                                  \
-  /* Dummy configuration, it is not needed.*/                               \
-  uint32_t                  dummy
+  /* IADC local timer period in HSCLK cycles, zero converts back to back.*/ \
+  uint32_t                  timer;                                          \
+  /* Scan table, one entry per channel.*/                                   \
+  uint32_t                  scan[EFR32_ADC_MAX_CHANNELS]
 
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
 
-#if (PLATFORM_ADC_USE_ADC1 == TRUE) && !defined(__DOXYGEN__)
+#if (EFR32_ADC_USE_ADC1 == TRUE) && !defined(__DOXYGEN__)
 extern ADCDriver ADCD1;
 #endif
 
@@ -1,3 +1,13 @@
 PLATFORMSRC_CONTRIB += $(CHIBIOS_CONTRIB)/os/hal/ports/SILABS/LLD/EFR32FG23/DMAv1/efr32_dma.c
 
+ifeq ($(USE_SMART_BUILD),yes)
+
+ifneq ($(findstring HAL_USE_DMACH TRUE,$(HALCONF)),)
+PLATFORMSRC_CONTRIB += $(CHIBIOS_CONTRIB)/os/hal/ports/SILABS/LLD/EFR32FG23/DMAv1/hal_dmach_lld.c
+endif
+
+else
+PLATFORMSRC_CONTRIB += $(CHIBIOS_CONTRIB)/os/hal/ports/SILABS/LLD/EFR32FG23/DMAv1/hal_dmach_lld.c
+endif
+
 PLATFORMINC_CONTRIB += $(CHIBIOS_CONTRIB)/os/hal/ports/SILABS/LLD/EFR32FG23/DMAv1
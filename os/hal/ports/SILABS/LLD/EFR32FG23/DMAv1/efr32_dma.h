@@ -125,6 +125,7 @@
                                            
 #define EFR32_DMA_CH_CTRL_DONEIEN           (1U << 20)
                                            
+#define EFR32_DMA_CH_CTRL_BLOCKSIZE_UNIT1   (0U << 16)
 #define EFR32_DMA_CH_CTRL_BLOCKSIZE_ALL     (15U << 16)
                                            
 #define EFR32_DMA_CH_CTRL_BYTESWAP          (1U << 15)
@@ -138,6 +139,20 @@
 #define EFR32_DMA_CH_CTRL_STRUCTTYPE_WRITE       (2U << 0)
 /** @} */
 
+/**
+ * @name    Descriptor LINK word constants
+ * @{
+ */
+#define EFR32_DMA_DESC_LINK_NONE            0U
+#define EFR32_DMA_DESC_LINK_ABSOLUTE        (1U << 1)
+
+/**
+ * @brief   LINK word of a descriptor linked to the descriptor @p descp.
+ */
+#define EFR32_DMA_DESC_LINK(descp)          (((uint32_t)(descp) & ~3U) |    \
+                                             EFR32_DMA_DESC_LINK_ABSOLUTE)
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -171,6 +186,19 @@ typedef struct {
   uint8_t               selfindex;  /**< @brief Index to self in array. */
 } efr32_dma_stream_t;
 
+/**
+ * @brief   EFR32 DMA transfer descriptor.
+ * @details Descriptors are loaded by the LDMA from memory, a chain of
+ *          linked descriptors is executed without CPU intervention.
+ * @note    The structure must be word aligned.
+ */
+typedef struct {
+  volatile uint32_t     ctrl;       /**< @brief CTRL register value.    */
+  volatile uint32_t     src;        /**< @brief Source address.         */
+  volatile uint32_t     dst;        /**< @brief Destination address.    */
+  volatile uint32_t     link;       /**< @brief Next descriptor link.   */
+} efr32_dma_descriptor_t;
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -224,6 +252,55 @@ typedef struct {
   (dmastp)->stream->CTRL = mode;                                            \
 }
 
+/**
+ * @brief   Selects the peripheral request of a DMA stream.
+ * @note    This function can be invoked in both ISR or thread context.
+ * @pre     The stream must have been allocated using @p dmaStreamAlloc().
+ * @post    After use the stream can be released using @p dmaStreamFree().
+ *
+ * @param[in] dmastp    pointer to a efr32_dma_stream_t structure
+ * @param[in] reqsel    value to be written in the LDMAXBAR REQSEL register
+ *
+ * @special
+ */
+#define dmaStreamSetSource(dmastp, reqsel) {                                \
+  *(dmastp)->reqsel = (uint32_t)(reqsel);                                   \
+}
+
+/**
+ * @brief   Returns the current destination address of a DMA stream.
+ * @note    This function can be invoked in both ISR or thread context.
+ * @pre     The stream must have been allocated using @p dmaStreamAlloc().
+ *
+ * @param[in] dmastp    pointer to a efr32_dma_stream_t structure
+ * @return              The address the next data unit is written to.
+ *
+ * @special
+ */
+#define dmaStreamGetDestination(dmastp) ((dmastp)->stream->DST)
+
+/**
+ * @brief   Starts a DMA stream from a chain of descriptors in memory.
+ * @details The first descriptor is loaded and the transfer is then paced
+ *          by the peripheral request selected with @p dmaStreamSetSource().
+ * @note    This function can be invoked in both ISR or thread context.
+ * @pre     The stream must have been allocated using @p dmaStreamAlloc().
+ * @post    After use the stream can be released using @p dmaStreamFree().
+ *
+ * @param[in] dmastp    pointer to a efr32_dma_stream_t structure
+ * @param[in] descp     pointer to the first efr32_dma_descriptor_t
+ *
+ * @special
+ */
+#define dmaStreamStartLinked(dmastp, descp) {                               \
+  (dmastp)->stream->LINK = (uint32_t)(descp) & _LDMA_CH_LINK_LINKADDR_MASK; \
+  dmaStreamClearInterrupt(dmastp);                                          \
+  LDMA->IEN_SET = (1U << (dmastp)->selfindex);                              \
+  LDMA->CHDONE_CLR = (1U << (dmastp)->selfindex);                           \
+  LDMA->LINKLOAD = (1U << (dmastp)->selfindex);                             \
+  LDMA->CHEN_SET = (1U << (dmastp)->selfindex);                             \
+}
+
 /**
  * @brief   DMA stream enable.
  * @note    This function can be invoked in both ISR or thread context.
@@ -0,0 +1,253 @@
+/*
+    ChibiOS - Copyright (C) 2024 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    DMAv1/hal_dmach_lld.c
+ * @brief   EFR32 DMA channels subsystem low level driver source.
+ *
+ * @addtogroup DMACH
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_DMACH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Channels pool, indexed by stream number.
+ */
+static DMAChannel dmach_channels[DMACH_LLD_CHANNELS];
+
+/**
+ * @brief   CTRL item size for each @p DMACH_MODE_WIDTH_x.
+ */
+static const uint32_t dmach_size[3] = {
+  EFR32_DMA_CH_CTRL_SIZE_BYTE,
+  EFR32_DMA_CH_CTRL_SIZE_HALFWORD,
+  EFR32_DMA_CH_CTRL_SIZE_WORD
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   DMA stream callback.
+ * @note    The stream disables itself after the last descriptor of a linear
+ *          chain.
+ *
+ * @param[in] p         pointer to the @p DMAChannel object
+ * @param[in] flags     DMA ISR flags
+ */
+static void dmach_lld_serve_interrupt(void *p, uint32_t flags) {
+  DMAChannel *dchp = (DMAChannel *)p;
+  uint32_t mask = 1U << dchp->dmastp->selfindex;
+  uint32_t f = 0U;
+
+  if ((flags & EFR32_DMA_ISR_ERROR_MASK) != 0U) {
+    f |= DMACH_FLAG_ERROR;
+  }
+  if ((flags & mask) != 0U) {
+    f |= DMACH_FLAG_DONE;
+    if ((LDMA->CHEN & mask) == 0U) {
+      f |= DMACH_FLAG_END;
+    }
+  }
+
+  _dmach_isr_code(dchp, f);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level DMACH driver initialization.
+ *
+ * @notapi
+ */
+void dmach_lld_init(void) {
+  unsigned i;
+
+  for (i = 0U; i < DMACH_LLD_CHANNELS; i++) {
+    dmachObjectInit(&dmach_channels[i]);
+    dmach_channels[i].dmastp = NULL;
+  }
+}
+
+/**
+ * @brief   Allocates a channel of the pool.
+ *
+ * @param[in] id        stream number or @p DMACH_ID_ANY
+ * @param[in] priority  IRQ priority of the LDMA
+ * @return              The allocated channel.
+ * @retval NULL         if a/the channel is not available.
+ *
+ * @notapi
+ */
+DMAChannel *dmach_lld_alloc(uint32_t id, uint32_t priority) {
+  uint32_t i, startid, endid;
+
+  if (id < DMACH_LLD_CHANNELS) {
+    startid = id;
+    endid   = id;
+  }
+  else {
+    startid = 0U;
+    endid   = DMACH_LLD_CHANNELS - 1U;
+  }
+
+  for (i = startid; i <= endid; i++) {
+    DMAChannel *dchp = &dmach_channels[i];
+
+    dchp->dmastp = dmaStreamAllocI(i, priority,
+                                   dmach_lld_serve_interrupt, (void *)dchp);
+    if (dchp->dmastp != NULL) {
+      return dchp;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Releases a channel of the pool.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @notapi
+ */
+void dmach_lld_free(DMAChannel *dchp) {
+
+  dmaStreamFreeI(dchp->dmastp);
+  dchp->dmastp = NULL;
+}
+
+/**
+ * @brief   Selects the request pacing the next chains.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] trigger   LDMAXBAR REQSEL value
+ *
+ * @notapi
+ */
+void dmach_lld_set_trigger(DMAChannel *dchp, dmachtrigger_t trigger) {
+
+  dchp->trigger = trigger;
+}
+
+/**
+ * @brief   Initializes a transfer descriptor.
+ * @details A @p DMACH_MODE_MEMORY descriptor moves all its items as soon
+ *          as it is loaded, otherwise each request moves one item.
+ *
+ * @param[out] descp    pointer to the descriptor
+ * @param[in] dst       destination address
+ * @param[in] src       source address
+ * @param[in] n         number of items
+ * @param[in] mode      descriptor mode flags
+ *
+ * @notapi
+ */
+void dmach_lld_desc_setup(dmach_desc_t *descp, void *dst, const void *src,
+                          size_t n, uint32_t mode) {
+  uint32_t ctrl;
+
+  ctrl = EFR32_DMA_CH_CTRL_STRUCTTYPE_TRANSFER |
+         EFR32_DMA_CH_CTRL_DSTMODE_ABSOLUTE    |
+         EFR32_DMA_CH_CTRL_SRCMODE_ABSOLUTE    |
+         dmach_size[mode & DMACH_MODE_WIDTH_MASK] |
+         EFR32_DMA_CH_CTRL_XFERCNT(n);
+  ctrl |= ((mode & DMACH_MODE_SRC_INC) != 0U) ?
+          EFR32_DMA_CH_CTRL_SRCINC_ONE : EFR32_DMA_CH_CTRL_SRCINC_NONE;
+  ctrl |= ((mode & DMACH_MODE_DST_INC) != 0U) ?
+          EFR32_DMA_CH_CTRL_DSTINC_ONE : EFR32_DMA_CH_CTRL_DSTINC_NONE;
+  if ((mode & DMACH_MODE_MEMORY) != 0U) {
+    ctrl |= EFR32_DMA_CH_CTRL_STRUCTREQ     |
+            EFR32_DMA_CH_CTRL_REQMODE_ALL   |
+            EFR32_DMA_CH_CTRL_BLOCKSIZE_ALL;
+  }
+  else {
+    ctrl |= EFR32_DMA_CH_CTRL_REQMODE_BLOCK |
+            EFR32_DMA_CH_CTRL_BLOCKSIZE_UNIT1;
+  }
+  if ((mode & DMACH_MODE_CB) != 0U) {
+    ctrl |= EFR32_DMA_CH_CTRL_DONEIEN;
+  }
+
+  descp->ctrl = ctrl;
+  descp->src  = (uint32_t)src;
+  descp->dst  = (uint32_t)dst;
+  descp->link = EFR32_DMA_DESC_LINK_NONE;
+}
+
+/**
+ * @brief   Starts a chain of descriptors.
+ * @note    The last descriptor always raises the done interrupt.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] descs     array of descriptors
+ * @param[in] len       number of descriptors
+ * @param[in] circular  the last descriptor is linked to the first one
+ *
+ * @notapi
+ */
+void dmach_lld_start(DMAChannel *dchp, dmach_desc_t *descs, unsigned len,
+                     bool circular) {
+  unsigned i;
+
+  for (i = 0U; i + 1U < len; i++) {
+    descs[i].link = EFR32_DMA_DESC_LINK(&descs[i + 1U]);
+  }
+  descs[len - 1U].ctrl |= EFR32_DMA_CH_CTRL_DONEIEN;
+  descs[len - 1U].link  = circular ? EFR32_DMA_DESC_LINK(&descs[0]) :
+                                     EFR32_DMA_DESC_LINK_NONE;
+
+  dmaStreamSetSource(dchp->dmastp, dchp->trigger);
+  dmaStreamStartLinked(dchp->dmastp, &descs[0]);
+}
+
+/**
+ * @brief   Stops the channel.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @notapi
+ */
+void dmach_lld_stop(DMAChannel *dchp) {
+
+  dmaStreamDisable(dchp->dmastp);
+}
+
+#endif /* HAL_USE_DMACH == TRUE */
+
+/** @} */
@@ -0,0 +1,128 @@
+/*
+    ChibiOS - Copyright (C) 2024 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    DMAv1/hal_dmach_lld.h
+ * @brief   EFR32 DMA channels subsystem low level driver header.
+ *
+ * @addtogroup DMACH
+ * @{
+ */
+
+#ifndef HAL_DMACH_LLD_H
+#define HAL_DMACH_LLD_H
+
+#if (HAL_USE_DMACH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of channels of the pool.
+ */
+#define DMACH_LLD_CHANNELS          EFR32_DMA_STREAMS
+
+/**
+ * @brief   Largest number of items of a descriptor.
+ */
+#define DMACH_LLD_DESC_MAX_ITEMS    2048U
+
+/**
+ * @brief   Circular chains support.
+ */
+#define DMACH_LLD_SUPPORTS_CIRCULAR TRUE
+
+/**
+ * @brief   Trigger starting the chains on @p dmachStart().
+ */
+#define DMACH_TRIGGER_SOFTWARE      LDMAXBAR_CH_REQSEL_SOURCESEL_NONE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(EFR32_DMA_REQUIRED)
+#define EFR32_DMA_REQUIRED
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a transfer descriptor.
+ */
+typedef efr32_dma_descriptor_t dmach_desc_t;
+
+/**
+ * @brief   Type of a channel trigger, the LDMAXBAR REQSEL value.
+ */
+typedef uint32_t dmachtrigger_t;
+
+/**
+ * @brief   Low level fields of the channel structure.
+ */
+#define dmach_lld_channel_fields                                            \
+  /* Allocated DMA stream, NULL if free.*/                                  \
+  const efr32_dma_stream_t  *dmastp;                                        \
+  /* Trigger source.*/                                                      \
+  dmachtrigger_t            trigger
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the bytes moved by a descriptor.
+ *
+ * @param[in] descp     pointer to the descriptor
+ *
+ * @notapi
+ */
+#define dmach_lld_desc_get_size(descp)                                      \
+  ((size_t)((((descp)->ctrl >> 4) & 0x7FFU) + 1U) <<                        \
+   (((descp)->ctrl >> 26) & 3U))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dmach_lld_init(void);
+  DMAChannel *dmach_lld_alloc(uint32_t id, uint32_t priority);
+  void dmach_lld_free(DMAChannel *dchp);
+  void dmach_lld_set_trigger(DMAChannel *dchp, dmachtrigger_t trigger);
+  void dmach_lld_desc_setup(dmach_desc_t *descp, void *dst, const void *src,
+                            size_t n, uint32_t mode);
+  void dmach_lld_start(DMAChannel *dchp, dmach_desc_t *descs, unsigned len,
+                       bool circular);
+  void dmach_lld_stop(DMAChannel *dchp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_DMACH == TRUE */
+
+#endif /* HAL_DMACH_LLD_H */
+
+/** @} */
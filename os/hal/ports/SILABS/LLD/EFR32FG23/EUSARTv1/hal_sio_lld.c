@@ -61,6 +61,29 @@
                                              USART_IF_RXFULL                     | \
                                              USART_IF_RX_ERRORS)
 
+#if (EFR32_SIO_USE_DMA == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   CTRL word of the circular RX descriptors.
+ */
+#define SIO_DMA_RX_CTRL                     (EFR32_DMA_CH_CTRL_STRUCTTYPE_TRANSFER | \
+                                             EFR32_DMA_CH_CTRL_BLOCKSIZE_UNIT1     | \
+                                             EFR32_DMA_CH_CTRL_REQMODE_BLOCK       | \
+                                             EFR32_DMA_CH_CTRL_SIZE_BYTE           | \
+                                             EFR32_DMA_CH_CTRL_SRCINC_NONE         | \
+                                             EFR32_DMA_CH_CTRL_DSTINC_ONE          | \
+                                             EFR32_DMA_CH_CTRL_DONEIEN)
+
+/**
+ * @brief   CTRL word of the TX descriptors.
+ */
+#define SIO_DMA_TX_CTRL                     (EFR32_DMA_CH_CTRL_STRUCTTYPE_TRANSFER | \
+                                             EFR32_DMA_CH_CTRL_BLOCKSIZE_UNIT1     | \
+                                             EFR32_DMA_CH_CTRL_REQMODE_BLOCK       | \
+                                             EFR32_DMA_CH_CTRL_SIZE_BYTE           | \
+                                             EFR32_DMA_CH_CTRL_SRCINC_ONE          | \
+                                             EFR32_DMA_CH_CTRL_DSTINC_NONE)
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -115,6 +138,272 @@ __STATIC_INLINE bool _sio_lld_is_usart(SIODriver* siop) {
   return false;
 }
 
+__STATIC_INLINE bool _sio_lld_uses_dma(SIODriver* siop) {
+
+#if EFR32_SIO_USE_DMA == TRUE
+  return siop->dmarx != NULL;
+#else
+  (void)siop;
+
+  return false;
+#endif
+}
+
+#if (EFR32_SIO_USE_DMA == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the index of the next frame written by the RX DMA.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @return              The write index into the circular RX buffer.
+ */
+__STATIC_INLINE size_t _sio_lld_dma_rx_wridx(SIODriver* siop) {
+
+  return (size_t)(dmaStreamGetDestination(siop->dmarx) -
+                  (uint32_t)siop->rxbuf) % EFR32_SIO_DMA_RX_BUFFER_SIZE;
+}
+
+__STATIC_INLINE bool _sio_lld_dma_is_rx_empty(SIODriver* siop) {
+
+  return siop->rxrdidx == _sio_lld_dma_rx_wridx(siop);
+}
+
+/**
+ * @brief   Programs the TX DMA stream with the queued frames.
+ * @details The queued frames are sent by a single descriptor or, if they
+ *          wrap around the end of the buffer, by two linked descriptors.
+ * @note    Must be invoked with the lock held and the TX stream idle.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ */
+static void _sio_lld_dma_tx_kick(SIODriver* siop) {
+
+  EUSART_TypeDef* usart = siop->usart;
+  size_t n1, n2;
+
+  if (siop->txcnt == 0U) {
+    return;
+  }
+
+  n1 = siop->txcnt;
+  n2 = 0U;
+  if (siop->txrdidx + n1 > EFR32_SIO_DMA_TX_BUFFER_SIZE) {
+    n1 = EFR32_SIO_DMA_TX_BUFFER_SIZE - siop->txrdidx;
+    n2 = siop->txcnt - n1;
+  }
+
+  siop->txdesc[0].ctrl = SIO_DMA_TX_CTRL | EFR32_DMA_CH_CTRL_XFERCNT(n1);
+  siop->txdesc[0].src  = (uint32_t)&siop->txbuf[siop->txrdidx];
+  siop->txdesc[0].dst  = (uint32_t)&usart->TXDATA;
+  if (n2 > 0U) {
+    siop->txdesc[0].link = EFR32_DMA_DESC_LINK(&siop->txdesc[1]);
+    siop->txdesc[1].ctrl = SIO_DMA_TX_CTRL | EFR32_DMA_CH_CTRL_XFERCNT(n2) |
+                           EFR32_DMA_CH_CTRL_DONEIEN;
+    siop->txdesc[1].src  = (uint32_t)&siop->txbuf[0];
+    siop->txdesc[1].dst  = (uint32_t)&usart->TXDATA;
+    siop->txdesc[1].link = EFR32_DMA_DESC_LINK_NONE;
+  }
+  else {
+    siop->txdesc[0].ctrl |= EFR32_DMA_CH_CTRL_DONEIEN;
+    siop->txdesc[0].link = EFR32_DMA_DESC_LINK_NONE;
+  }
+
+  siop->txdmacnt = n1 + n2;
+  dmaStreamStartLinked(siop->dmatx, &siop->txdesc[0]);
+}
+
+/**
+ * @brief   RX DMA stream callback, invoked on each half buffer filled.
+ *
+ * @param[in] p         pointer to the @p SIODriver object
+ * @param[in] flags     DMA ISR flags
+ */
+static void _sio_lld_serve_rx_dma(void* p, uint32_t flags) {
+
+  SIODriver* siop = (SIODriver*)p;
+
+  if ((flags & EFR32_DMA_ISR_ERROR_MASK) != 0U) {
+    EFR32_SIO_DMA_ERROR_HOOK(siop);
+  }
+
+  if (((siop->enabled & SIO_EV_RXNOTEMPY) != 0U) &&
+      !_sio_lld_dma_is_rx_empty(siop)) {
+    __sio_wakeup_rx(siop);
+    __sio_callback(siop);
+  }
+}
+
+/**
+ * @brief   TX DMA stream callback, invoked when the queued frames have been
+ *          moved into the TX FIFO.
+ *
+ * @param[in] p         pointer to the @p SIODriver object
+ * @param[in] flags     DMA ISR flags
+ */
+static void _sio_lld_serve_tx_dma(void* p, uint32_t flags) {
+
+  SIODriver* siop = (SIODriver*)p;
+
+  if ((flags & EFR32_DMA_ISR_ERROR_MASK) != 0U) {
+    EFR32_SIO_DMA_ERROR_HOOK(siop);
+  }
+
+  osalSysLockFromISR();
+  siop->txrdidx = (siop->txrdidx + siop->txdmacnt) % EFR32_SIO_DMA_TX_BUFFER_SIZE;
+  siop->txcnt  -= siop->txdmacnt;
+  siop->txdmacnt = 0U;
+
+  /* Frames queued meanwhile are sent right away.*/
+  _sio_lld_dma_tx_kick(siop);
+  osalSysUnlockFromISR();
+
+  if ((siop->enabled & SIO_EV_TXNOTFULL) != 0U) {
+    __sio_wakeup_tx(siop);
+    __sio_callback(siop);
+  }
+}
+
+/**
+ * @brief   Allocates the DMA streams and starts the circular reception.
+ * @note    Invoked with the lock held.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[in] rxid      RX DMA stream identifier
+ * @param[in] txid      TX DMA stream identifier
+ * @param[in] priority  DMA IRQ priority
+ * @param[in] rxreq     RX LDMAXBAR request selection
+ * @param[in] txreq     TX LDMAXBAR request selection
+ */
+static void _sio_lld_dma_start(SIODriver* siop, uint32_t rxid, uint32_t txid,
+                               uint32_t priority,
+                               uint32_t rxreq, uint32_t txreq) {
+
+  EUSART_TypeDef* usart = siop->usart;
+  unsigned i;
+
+  siop->dmarx = dmaStreamAllocI(rxid, priority, _sio_lld_serve_rx_dma, siop);
+  osalDbgAssert(siop->dmarx != NULL, "unable to allocate stream");
+  siop->dmatx = dmaStreamAllocI(txid, priority, _sio_lld_serve_tx_dma, siop);
+  osalDbgAssert(siop->dmatx != NULL, "unable to allocate stream");
+
+  siop->rxrdidx  = 0U;
+  siop->txrdidx  = 0U;
+  siop->txcnt    = 0U;
+  siop->txdmacnt = 0U;
+
+  /* Two descriptors linked in a ring, each one fills half buffer.*/
+  for (i = 0U; i < 2U; i++) {
+    siop->rxdesc[i].ctrl = SIO_DMA_RX_CTRL |
+                           EFR32_DMA_CH_CTRL_XFERCNT(EFR32_SIO_DMA_RX_BUFFER_SIZE / 2U);
+    siop->rxdesc[i].src  = (uint32_t)&usart->RXDATA;
+    siop->rxdesc[i].dst  = (uint32_t)&siop->rxbuf[i * (EFR32_SIO_DMA_RX_BUFFER_SIZE / 2U)];
+    siop->rxdesc[i].link = EFR32_DMA_DESC_LINK(&siop->rxdesc[i ^ 1U]);
+  }
+
+  dmaStreamSetSource(siop->dmarx, rxreq);
+  dmaStreamSetSource(siop->dmatx, txreq);
+  dmaStreamStartLinked(siop->dmarx, &siop->rxdesc[0]);
+}
+
+/**
+ * @brief   Stops and releases the DMA streams.
+ * @note    Invoked with the lock held.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ */
+static void _sio_lld_dma_stop(SIODriver* siop) {
+
+  dmaStreamDisable(siop->dmarx);
+  dmaStreamDisable(siop->dmatx);
+  dmaStreamFreeI(siop->dmarx);
+  dmaStreamFreeI(siop->dmatx);
+  siop->dmarx = NULL;
+  siop->dmatx = NULL;
+}
+
+/**
+ * @brief   Copies frames out of the circular RX buffer.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[out] buffer   pointer to the buffer for read frames
+ * @param[in] n         maximum number of frames to be read
+ * @return              The number of frames read.
+ */
+static size_t _sio_lld_dma_read(SIODriver* siop, uint8_t* buffer, size_t n) {
+
+  size_t wridx = _sio_lld_dma_rx_wridx(siop);
+  size_t rd = 0U;
+
+  while ((rd < n) && (siop->rxrdidx != wridx)) {
+    *buffer++ = siop->rxbuf[siop->rxrdidx];
+    siop->rxrdidx = (siop->rxrdidx + 1U) % EFR32_SIO_DMA_RX_BUFFER_SIZE;
+    rd++;
+  }
+
+  return rd;
+}
+
+/**
+ * @brief   Queues frames into the TX buffer, the TX DMA is started if idle.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[in] buffer    pointer to the frames to be written
+ * @param[in] n         maximum number of frames to be written
+ * @return              The number of frames queued.
+ */
+static size_t _sio_lld_dma_write(SIODriver* siop, const uint8_t* buffer,
+                                 size_t n) {
+
+  syssts_t sts;
+  size_t wridx, wr;
+
+  sts = osalSysGetStatusAndLockX();
+
+  wr = EFR32_SIO_DMA_TX_BUFFER_SIZE - siop->txcnt;
+  if (wr > n) {
+    wr = n;
+  }
+
+  wridx = (siop->txrdidx + siop->txcnt) % EFR32_SIO_DMA_TX_BUFFER_SIZE;
+  for (n = 0U; n < wr; n++) {
+    siop->txbuf[wridx] = *buffer++;
+    wridx = (wridx + 1U) % EFR32_SIO_DMA_TX_BUFFER_SIZE;
+  }
+  siop->txcnt += wr;
+
+  if (siop->txdmacnt == 0U) {
+    _sio_lld_dma_tx_kick(siop);
+  }
+
+  osalSysRestoreStatusX(sts);
+
+  return wr;
+}
+#endif /* EFR32_SIO_USE_DMA == TRUE */
+
+/**
+ * @brief   Replaces the FIFO level flags with the DMA buffers state.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[in] isr       EUSART IF register value
+ * @return              The IF value as seen by the SIO events translation.
+ */
+__STATIC_INLINE uint32_t _sio_lld_dma_data_flags(SIODriver* siop, uint32_t isr) {
+
+#if EFR32_SIO_USE_DMA == TRUE
+  isr &= ~(EUSART_IF_RXFL | EUSART_IF_RXTO | EUSART_IF_TXFL);
+  if (!_sio_lld_dma_is_rx_empty(siop)) {
+    isr |= EUSART_IF_RXFL;
+  }
+  if (siop->txcnt < EFR32_SIO_DMA_TX_BUFFER_SIZE) {
+    isr |= EUSART_IF_TXFL;
+  }
+#else
+  (void)siop;
+#endif
+
+  return isr;
+}
+
 __STATIC_INLINE uint32_t _sio_lld_get_clkdiv(uint32_t clock, uint32_t ovs, uint32_t bitrate) {
 
   uint32_t clkdiv;
@@ -173,6 +462,12 @@ __STATIC_INLINE void _sio_lld_start_eusart(SIODriver* siop) {
 
   _sio_lld_reg_masked_write(&(usart->FRAMECFG), _EUSART_FRAMECFG_MASK, config->framecfg);
 
+#if EFR32_SIO_USE_DMA == TRUE
+  /* The RX timeout signals an idle line while the DMA drains the FIFO.*/
+  _sio_lld_reg_masked_write(&(usart->CFG1), _EUSART_CFG1_RXTIMEOUT_MASK,
+                            (uint32_t)EFR32_SIO_DMA_RX_TIMEOUT << _EUSART_CFG1_RXTIMEOUT_SHIFT);
+#endif
+
   /* Enable module before writing into CLKDIV register. */
   usart->EN_SET = EUSART_EN_EN;
 
@@ -243,6 +538,9 @@ __STATIC_INLINE void usart_enable_rx_irq(SIODriver* siop) {
     if (_sio_lld_is_usart(siop)) {
       USART_TypeDef* usart = siop->usart;
       usart->IEN_SET = USART_IEN_RXFULL;
+    } else if (_sio_lld_uses_dma(siop)) {
+      EUSART_TypeDef* usart = siop->usart;
+      usart->IEN_SET = EUSART_IEN_RXTO;
     } else {
       USART_TypeDef* usart = siop->usart;
       usart->IEN_SET = EUSART_IEN_RXFL;
@@ -287,6 +585,8 @@ __STATIC_INLINE void usart_enable_tx_irq(SIODriver* siop) {
     if (_sio_lld_is_usart(siop)) {
       USART_TypeDef* usart = siop->usart;
       usart->IEN_SET = USART_IEN_TXBL;
+    } else if (_sio_lld_uses_dma(siop)) {
+      /* Notified by the TX DMA callback.*/
     } else {
       EUSART_TypeDef* usart = siop->usart;
       usart->IEN_SET = EUSART_IEN_TXFL;
@@ -430,24 +730,40 @@ void sio_lld_init(void) {
   sioObjectInit(&SIOD1);
   SIOD1.usart = EUSART0;
   SIOD1.clock = EFR32_EUSART1CLK;
+#if EFR32_SIO_USE_DMA == TRUE
+  SIOD1.dmarx = NULL;
+  SIOD1.dmatx = NULL;
+#endif
 #endif
 
 #if EFR32_SIO_USE_EUSART2 == TRUE
   sioObjectInit(&SIOD2);
   SIOD2.usart = EUSART1;
   SIOD2.clock = EFR32_EUSART23CLK;
+#if EFR32_SIO_USE_DMA == TRUE
+  SIOD2.dmarx = NULL;
+  SIOD2.dmatx = NULL;
+#endif
 #endif
 
 #if EFR32_SIO_USE_EUSART3 == TRUE
   sioObjectInit(&SIOD3);
   SIOD3.usart = EUSART2;
   SIOD3.clock = EFR32_EUSART23CLK;
+#if EFR32_SIO_USE_DMA == TRUE
+  SIOD3.dmarx = NULL;
+  SIOD3.dmatx = NULL;
+#endif
 #endif
 
 #if EFR32_SIO_USE_USART1 == TRUE
   sioObjectInit(&SIOD4);
   SIOD4.usart = USART0;
   SIOD4.clock = EFR32_USART1CLK;
+#if EFR32_SIO_USE_DMA == TRUE
+  SIOD4.dmarx = NULL;
+  SIOD4.dmatx = NULL;
+#endif
 #endif
 }
 
@@ -472,6 +788,17 @@ msg_t sio_lld_start(SIODriver* siop) {
 
       _sio_lld_start_eusart(siop);
 
+#if EFR32_SIO_USE_DMA == TRUE
+      _sio_lld_dma_start(siop,
+                         EFR32_SIO_EUSART1_RX_DMA_STREAM,
+                         EFR32_SIO_EUSART1_TX_DMA_STREAM,
+                         EFR32_EUSART1_RX_IRQ_PRIORITY,
+                         LDMAXBAR_CH_REQSEL_SOURCESEL_EUSART0 |
+                         LDMAXBAR_CH_REQSEL_SIGSEL_EUSART0RXFL,
+                         LDMAXBAR_CH_REQSEL_SOURCESEL_EUSART0 |
+                         LDMAXBAR_CH_REQSEL_SIGSEL_EUSART0TXFL);
+#endif
+
       nvicEnableVector(EFR32_EUSART1_RX_NUMBER, EFR32_EUSART1_RX_IRQ_PRIORITY);
       nvicEnableVector(EFR32_EUSART1_TX_NUMBER, EFR32_EUSART1_TX_IRQ_PRIORITY);
     }
@@ -483,6 +810,17 @@ msg_t sio_lld_start(SIODriver* siop) {
 
       _sio_lld_start_eusart(siop);
 
+#if EFR32_SIO_USE_DMA == TRUE
+      _sio_lld_dma_start(siop,
+                         EFR32_SIO_EUSART2_RX_DMA_STREAM,
+                         EFR32_SIO_EUSART2_TX_DMA_STREAM,
+                         EFR32_EUSART2_RX_IRQ_PRIORITY,
+                         LDMAXBAR_CH_REQSEL_SOURCESEL_EUSART1 |
+                         LDMAXBAR_CH_REQSEL_SIGSEL_EUSART1RXFL,
+                         LDMAXBAR_CH_REQSEL_SOURCESEL_EUSART1 |
+                         LDMAXBAR_CH_REQSEL_SIGSEL_EUSART1TXFL);
+#endif
+
       nvicEnableVector(EFR32_EUSART2_RX_NUMBER, EFR32_EUSART2_RX_IRQ_PRIORITY);
       nvicEnableVector(EFR32_EUSART2_TX_NUMBER, EFR32_EUSART2_TX_IRQ_PRIORITY);
     }
@@ -494,6 +832,17 @@ msg_t sio_lld_start(SIODriver* siop) {
 
       _sio_lld_start_eusart(siop);
 
+#if EFR32_SIO_USE_DMA == TRUE
+      _sio_lld_dma_start(siop,
+                         EFR32_SIO_EUSART3_RX_DMA_STREAM,
+                         EFR32_SIO_EUSART3_TX_DMA_STREAM,
+                         EFR32_EUSART3_RX_IRQ_PRIORITY,
+                         LDMAXBAR_CH_REQSEL_SOURCESEL_EUSART2 |
+                         LDMAXBAR_CH_REQSEL_SIGSEL_EUSART2RXFL,
+                         LDMAXBAR_CH_REQSEL_SOURCESEL_EUSART2 |
+                         LDMAXBAR_CH_REQSEL_SIGSEL_EUSART2TXFL);
+#endif
+
       nvicEnableVector(EFR32_EUSART3_RX_NUMBER, EFR32_EUSART3_RX_IRQ_PRIORITY);
       nvicEnableVector(EFR32_EUSART3_TX_NUMBER, EFR32_EUSART3_TX_IRQ_PRIORITY);
     }
@@ -528,6 +877,9 @@ void sio_lld_stop(SIODriver* siop) {
     /* Disables the peripheral.*/
 #if EFR32_SIO_USE_EUSART1 == TRUE
     if (&SIOD1 == siop) {
+#if EFR32_SIO_USE_DMA == TRUE
+      _sio_lld_dma_stop(siop);
+#endif
       _sio_lld_stop_eusart(siop);
       CMU->CLKEN1_CLR = CMU_CLKEN1_EUSART0;
     }
@@ -535,6 +887,9 @@ void sio_lld_stop(SIODriver* siop) {
 
 #if EFR32_SIO_USE_EUSART2 == TRUE
     if (&SIOD2 == siop) {
+#if EFR32_SIO_USE_DMA == TRUE
+      _sio_lld_dma_stop(siop);
+#endif
       _sio_lld_stop_eusart(siop);
       CMU->CLKEN1_CLR = CMU_CLKEN1_EUSART1;
     }
@@ -542,6 +897,9 @@ void sio_lld_stop(SIODriver* siop) {
 
 #if EFR32_SIO_USE_EUSART3 == TRUE
     if (&SIOD3 == siop) {
+#if EFR32_SIO_USE_DMA == TRUE
+      _sio_lld_dma_stop(siop);
+#endif
       _sio_lld_stop_eusart(siop);
       CMU->CLKEN1_CLR = CMU_CLKEN1_EUSART2;
     }
@@ -591,9 +949,15 @@ void sio_lld_update_enable_flags(SIODriver* siop) {
     ien |= __sio_reloc_field(siop->enabled, SIO_EV_FRAMING_ERR, SIO_EV_FRAMING_ERR_POS, _EUSART_IEN_FERR_SHIFT);
     ien |= __sio_reloc_field(siop->enabled, SIO_EV_PARITY_ERR,  SIO_EV_PARITY_ERR_POS,  _EUSART_IEN_PERR_SHIFT);
     ien |= __sio_reloc_field(siop->enabled, SIO_EV_OVERRUN_ERR, SIO_EV_OVERRUN_ERR_POS, _EUSART_IEN_RXOF_SHIFT);
-    ien |= __sio_reloc_field(siop->enabled, SIO_EV_RXNOTEMPY,   SIO_EV_RXNOTEMPY_POS,   _EUSART_IEN_RXFL_SHIFT);
-    ien |= __sio_reloc_field(siop->enabled, SIO_EV_TXNOTFULL,   SIO_EV_TXNOTFULL_POS,   _EUSART_IEN_TXFL_SHIFT);
     ien |= __sio_reloc_field(siop->enabled, SIO_EV_TXDONE,      SIO_EV_TXDONE_POS,      _EUSART_IEN_TXC_SHIFT);
+    if (_sio_lld_uses_dma(siop)) {
+      /* Data events come from the DMA callbacks and the RX timeout.*/
+      ien &= ~EUSART_IEN_RXTO;
+      ien |= __sio_reloc_field(siop->enabled, SIO_EV_RXNOTEMPY, SIO_EV_RXNOTEMPY_POS, _EUSART_IEN_RXTO_SHIFT);
+    } else {
+      ien |= __sio_reloc_field(siop->enabled, SIO_EV_RXNOTEMPY, SIO_EV_RXNOTEMPY_POS, _EUSART_IEN_RXFL_SHIFT);
+      ien |= __sio_reloc_field(siop->enabled, SIO_EV_TXNOTFULL, SIO_EV_TXNOTFULL_POS, _EUSART_IEN_TXFL_SHIFT);
+    }
 
     /* Setting up the operation.*/
     usart->IEN = ien;
@@ -695,6 +1059,7 @@ sioevents_t sio_lld_get_and_clear_events(SIODriver* siop) {
     /* Getting all ISR flags.*/
     isr = usart->IF & (EUSART_IF_RX_ERRORS  |
                        EUSART_IF_RXFL       |
+                       EUSART_IF_RXTO       |
                        EUSART_IF_TXFL       |
                        EUSART_IF_TXC);
 
@@ -703,6 +1068,10 @@ sioevents_t sio_lld_get_and_clear_events(SIODriver* siop) {
     /* Clearing captured events.*/
     usart->IF_CLR = isr;
 
+    if (_sio_lld_uses_dma(siop)) {
+      isr = _sio_lld_dma_data_flags(siop, isr);
+    }
+
     /* Status flags cleared, now the RX-related interrupts can be
        enabled again.*/
     usart_enable_rx_irq(siop);
@@ -761,6 +1130,10 @@ sioevents_t sio_lld_get_events(SIODriver* siop) {
 
     status = usart->STATUS & EUSART_STATUS_RXIDLE;
 
+    if (_sio_lld_uses_dma(siop)) {
+      isr = _sio_lld_dma_data_flags(siop, isr);
+    }
+
     /* Translating the status flags in SIO events.*/
     events = __sio_reloc_field(isr, _EUSART_IF_FERR_MASK, _EUSART_IF_FERR_SHIFT, SIO_EV_FRAMING_ERR_POS) |
              __sio_reloc_field(isr, _EUSART_IF_PERR_MASK, _EUSART_IF_PERR_SHIFT, SIO_EV_PARITY_ERR_POS) |
@@ -781,7 +1154,13 @@ bool _sio_lld_is_rx_empty(SIODriver* siop) {
   if (_sio_lld_is_usart(siop)) {
     USART_TypeDef* usart = siop->usart;
     rv = (usart->IF & USART_IF_RXDATAV) == 0U;
-  } else {
+  }
+#if EFR32_SIO_USE_DMA == TRUE
+  else if (_sio_lld_uses_dma(siop)) {
+    rv = _sio_lld_dma_is_rx_empty(siop);
+  }
+#endif
+  else {
     EUSART_TypeDef* usart = siop->usart;
     rv = (usart->IF & EUSART_IF_RXFL) == 0U;
   }
@@ -827,7 +1206,13 @@ bool _sio_lld_is_tx_full(SIODriver* siop) {
   if (_sio_lld_is_usart(siop)) {
     USART_TypeDef* usart = siop->usart;
     rv = (usart->IF & USART_IF_TXBL) == 0U;
-  } else {
+  }
+#if EFR32_SIO_USE_DMA == TRUE
+  else if (_sio_lld_uses_dma(siop)) {
+    rv = siop->txcnt >= EFR32_SIO_DMA_TX_BUFFER_SIZE;
+  }
+#endif
+  else {
     EUSART_TypeDef* usart = siop->usart;
     rv = (usart->IF & EUSART_IF_TXFL) == 0U;
   }
@@ -845,6 +1230,11 @@ bool _sio_lld_is_tx_ongoing(SIODriver* siop) {
   } else {
     EUSART_TypeDef* usart = siop->usart;
     rv = (usart->IF & EUSART_IF_TXC) == 0U;
+#if EFR32_SIO_USE_DMA == TRUE
+    if (_sio_lld_uses_dma(siop) && (siop->txcnt > 0U)) {
+      rv = true;
+    }
+#endif
   }
 
   return rv;
@@ -891,6 +1281,19 @@ size_t sio_lld_read(SIODriver* siop, uint8_t* buffer, size_t n) {
 
   size_t rd;
 
+#if EFR32_SIO_USE_DMA == TRUE
+  if (_sio_lld_uses_dma(siop)) {
+    rd = _sio_lld_dma_read(siop, buffer, n);
+
+    /* Buffer emptied, the RX timeout interrupt is enabled again.*/
+    if (sio_lld_is_rx_empty(siop)) {
+      usart_enable_rx_irq(siop);
+    }
+
+    return rd;
+  }
+#endif
+
   rd = 0U;
   while (true) {
 
@@ -928,6 +1331,17 @@ size_t sio_lld_write(SIODriver* siop, const uint8_t* buffer, size_t n) {
 
   size_t wr;
 
+#if EFR32_SIO_USE_DMA == TRUE
+  if (_sio_lld_uses_dma(siop)) {
+    wr = _sio_lld_dma_write(siop, buffer, n);
+
+    /* The transmit complete interrupt is always re-enabled on write.*/
+    usart_enable_tx_end_irq(siop);
+
+    return wr;
+  }
+#endif
+
   wr = 0U;
   while (true) {
 
@@ -966,6 +1380,19 @@ msg_t sio_lld_get(SIODriver* siop) {
 
   msg_t msg;
 
+#if EFR32_SIO_USE_DMA == TRUE
+  if (_sio_lld_uses_dma(siop)) {
+    uint8_t data;
+
+    if (_sio_lld_dma_read(siop, &data, 1U) == 0U) {
+      usart_enable_rx_irq(siop);
+      return MSG_TIMEOUT;
+    }
+
+    return (msg_t)data;
+  }
+#endif
+
   /* If the RX FIFO has been emptied then the interrupt is enabled again.*/
   if (sio_lld_is_rx_empty(siop)) {
     usart_enable_rx_irq(siop);
@@ -988,6 +1415,16 @@ msg_t sio_lld_get(SIODriver* siop) {
  */
 void sio_lld_put(SIODriver* siop, uint_fast16_t data) {
 
+#if EFR32_SIO_USE_DMA == TRUE
+  if (_sio_lld_uses_dma(siop)) {
+    uint8_t b = (uint8_t)data;
+
+    (void)_sio_lld_dma_write(siop, &b, 1U);
+    usart_enable_tx_end_irq(siop);
+    return;
+  }
+#endif
+
   _sio_lld_write(siop, data);
 
   /* If the TX FIFO has been filled then the interrupt is enabled again.*/
@@ -1039,6 +1476,12 @@ __STATIC_INLINE void sio_lld_serve_interrupt_eusart(SIODriver* siop) {
 
   osalDbgAssert(siop->state == SIO_READY, "invalid state");
 
+  if (_sio_lld_uses_dma(siop)) {
+    /* The RX timeout is only a wakeup source, data is in the RX buffer.*/
+    u->IF_CLR = EUSART_IF_RXTO;
+    ifr &= ~EUSART_IF_RXTO;
+  }
+
   /* Events to be processed.*/
   events = sio_lld_get_events(siop) & siop->enabled;
   if (events != 0U) {
@@ -1046,10 +1489,10 @@ __STATIC_INLINE void sio_lld_serve_interrupt_eusart(SIODriver* siop) {
     /* Error events handled as a group.*/
     if ((events & SIO_EV_ALL_ERRORS) != 0U) {
 
-      ifr &= ~(EUSART_IF_RXFL | EUSART_IF_RX_ERRORS);
+      ifr &= ~(EUSART_IF_RXFL | EUSART_IF_RXTO | EUSART_IF_RX_ERRORS);
 
       /* All RX-related interrupt sources disabled.*/
-      ien &= ~(EUSART_IEN_RXFL | EUSART_IEN_RX_ERRORS);
+      ien &= ~(EUSART_IEN_RXFL | EUSART_IEN_RXTO | EUSART_IEN_RX_ERRORS);
 
       /* Waiting thread woken, if any.*/
       __sio_wakeup_errors(siop);
@@ -1068,10 +1511,10 @@ __STATIC_INLINE void sio_lld_serve_interrupt_eusart(SIODriver* siop) {
       /* RX FIFO is non-empty.*/
       if ((events & SIO_EV_RXNOTEMPY) != 0U) {
 
-        ifr &= ~(EUSART_IF_RXFL);
+        ifr &= ~(EUSART_IF_RXFL | EUSART_IF_RXTO);
 
         /* Interrupt source disabled.*/
-        ien &= ~(EUSART_IEN_RXFL);
+        ien &= ~(EUSART_IEN_RXFL | EUSART_IEN_RXTO);
 
         /* Waiting thread woken, if any.*/
         __sio_wakeup_rx(siop);
@@ -1108,7 +1551,9 @@ __STATIC_INLINE void sio_lld_serve_interrupt_eusart(SIODriver* siop) {
     /* The callback is invoked.*/
     __sio_callback(siop);
   } else {
-    osalDbgAssert(false, "spurious interrupt");
+    /* In DMA mode the RX timeout can race with a reader emptying the
+       buffer.*/
+    osalDbgAssert(_sio_lld_uses_dma(siop), "spurious interrupt");
   }
 }
 
@@ -143,6 +143,79 @@
 #define EFR32_SIO_USE_USART1              FALSE
 #endif
 
+/**
+ * @brief   EUSART DMA mode switch.
+ * @details If set to @p TRUE the EUSART drivers move data through LDMA
+ *          streams: reception goes into a circular buffer and transmission
+ *          is served from a buffer by linked descriptors, the CPU is not
+ *          woken per frame. The USART driver is not affected.
+ */
+#if !defined(EFR32_SIO_USE_DMA) || defined(__DOXYGEN__)
+#define EFR32_SIO_USE_DMA                 TRUE
+#endif
+
+/**
+ * @brief   Size of the DMA circular RX buffer of each EUSART driver.
+ * @note    The buffer must be large enough to hold the data received
+ *          between two reads, older data is overwritten otherwise.
+ */
+#if !defined(EFR32_SIO_DMA_RX_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define EFR32_SIO_DMA_RX_BUFFER_SIZE      64
+#endif
+
+/**
+ * @brief   Size of the DMA TX buffer of each EUSART driver.
+ */
+#if !defined(EFR32_SIO_DMA_TX_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define EFR32_SIO_DMA_TX_BUFFER_SIZE      64
+#endif
+
+/**
+ * @brief   RX idle timeout in DMA mode, in frame times.
+ * @details The EUSART RX timeout interrupt wakes the reader when the line
+ *          stays idle after a burst shorter than half RX buffer.
+ */
+#if !defined(EFR32_SIO_DMA_RX_TIMEOUT) || defined(__DOXYGEN__)
+#define EFR32_SIO_DMA_RX_TIMEOUT          2
+#endif
+
+/**
+ * @brief   EUSART1 DMA streams.
+ */
+#if !defined(EFR32_SIO_EUSART1_RX_DMA_STREAM) || defined(__DOXYGEN__)
+#define EFR32_SIO_EUSART1_RX_DMA_STREAM   EFR32_DMA_STREAM_ID_ANY
+#endif
+#if !defined(EFR32_SIO_EUSART1_TX_DMA_STREAM) || defined(__DOXYGEN__)
+#define EFR32_SIO_EUSART1_TX_DMA_STREAM   EFR32_DMA_STREAM_ID_ANY
+#endif
+
+/**
+ * @brief   EUSART2 DMA streams.
+ */
+#if !defined(EFR32_SIO_EUSART2_RX_DMA_STREAM) || defined(__DOXYGEN__)
+#define EFR32_SIO_EUSART2_RX_DMA_STREAM   EFR32_DMA_STREAM_ID_ANY
+#endif
+#if !defined(EFR32_SIO_EUSART2_TX_DMA_STREAM) || defined(__DOXYGEN__)
+#define EFR32_SIO_EUSART2_TX_DMA_STREAM   EFR32_DMA_STREAM_ID_ANY
+#endif
+
+/**
+ * @brief   EUSART3 DMA streams.
+ */
+#if !defined(EFR32_SIO_EUSART3_RX_DMA_STREAM) || defined(__DOXYGEN__)
+#define EFR32_SIO_EUSART3_RX_DMA_STREAM   EFR32_DMA_STREAM_ID_ANY
+#endif
+#if !defined(EFR32_SIO_EUSART3_TX_DMA_STREAM) || defined(__DOXYGEN__)
+#define EFR32_SIO_EUSART3_TX_DMA_STREAM   EFR32_DMA_STREAM_ID_ANY
+#endif
+
+/**
+ * @brief   SIO DMA error hook.
+ */
+#if !defined(EFR32_SIO_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define EFR32_SIO_DMA_ERROR_HOOK(siop)    osalSysHalt("DMA failure")
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -163,6 +236,28 @@
 #error "USART1 not present in the selected device"
 #endif
 
+#if EFR32_SIO_USE_DMA == TRUE
+#if ((EFR32_SIO_DMA_RX_BUFFER_SIZE & 1) != 0) ||                           \
+    (EFR32_SIO_DMA_RX_BUFFER_SIZE < 2) ||                                   \
+    (EFR32_SIO_DMA_RX_BUFFER_SIZE > 4096)
+#error "EFR32_SIO_DMA_RX_BUFFER_SIZE must be even and within 2...4096"
+#endif
+
+#if (EFR32_SIO_DMA_TX_BUFFER_SIZE < 1) || (EFR32_SIO_DMA_TX_BUFFER_SIZE > 2048)
+#error "EFR32_SIO_DMA_TX_BUFFER_SIZE must be within 1...2048"
+#endif
+
+#if (EFR32_SIO_DMA_RX_TIMEOUT < 1) || (EFR32_SIO_DMA_RX_TIMEOUT > 7)
+#error "EFR32_SIO_DMA_RX_TIMEOUT must be within 1...7"
+#endif
+
+#if EFR32_SIO_USE_EUSART1 || EFR32_SIO_USE_EUSART2 || EFR32_SIO_USE_EUSART3
+#if !defined(EFR32_DMA_REQUIRED)
+#define EFR32_DMA_REQUIRED
+#endif
+#endif
+#endif /* EFR32_SIO_USE_DMA == TRUE */
+
 
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
@@ -175,11 +270,34 @@
 /**
  * @brief   Low level fields of the SIO driver structure.
  */
+#if (EFR32_SIO_USE_DMA == TRUE) || defined(__DOXYGEN__)
+#define sio_lld_driver_fields                                               \
+  /* Pointer to the EUSARTx or USARTx registers block.*/                    \
+  void *usart;                                                              \
+/* Clock frequency for the associated USART/UART.*/                         \
+  uint32_t clock;                                                           \
+  /* RX and TX DMA streams, NULL if the driver is not in DMA mode.*/        \
+  const efr32_dma_stream_t *dmarx;                                          \
+  const efr32_dma_stream_t *dmatx;                                          \
+  /* Circular RX buffer descriptors, one per half buffer.*/                 \
+  efr32_dma_descriptor_t rxdesc[2];                                         \
+  /* TX descriptors, the second one is used on buffer wrap.*/               \
+  efr32_dma_descriptor_t txdesc[2];                                         \
+  /* Circular RX buffer and read index.*/                                   \
+  uint8_t rxbuf[EFR32_SIO_DMA_RX_BUFFER_SIZE];                              \
+  size_t rxrdidx;                                                           \
+  /* TX buffer, oldest frame index, frames queued and frames in flight.*/   \
+  uint8_t txbuf[EFR32_SIO_DMA_TX_BUFFER_SIZE];                              \
+  size_t txrdidx;                                                           \
+  size_t txcnt;                                                             \
+  size_t txdmacnt
+#else
 #define sio_lld_driver_fields                                               \
   /* Pointer to the EUSARTx or USARTx registers block.*/                    \
   void *usart;                                                              \
 /* Clock frequency for the associated USART/UART.*/                         \
   uint32_t clock
+#endif
 
 /**
  * @brief   Low level fields of the SIO configuration structure.
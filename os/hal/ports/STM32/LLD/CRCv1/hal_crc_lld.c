@@ -125,7 +125,16 @@ static void crc_lld_serve_interrupt(CRCDriver *crcp, uint32_t flags) {
     /* Start DMA follow up transfer for next data chunk */
     crc_lld_start_calc(crcp, crcp->rem_data_size,
       (const void *)crcp->dmastp->channel->CPAR+0xffff);
-  } else {
+  }
+#if CRC_USE_SCATTER_GATHER == TRUE
+  else if (crcp->nsegs > 0U) {
+    /* Chaining the next segment of the list.*/
+    const crcsegment_t *segp = crcp->segs++;
+    crcp->nsegs--;
+    crc_lld_start_calc(crcp, segp->n, segp->buf);
+  }
+#endif
+  else {
     /* Portable CRC ISR code defined in the high level driver, note, it is a macro.*/
     _crc_isr_code(crcp, crcp->crc->DR ^ crcp->config->final_val);
   }
@@ -144,6 +153,9 @@ static void crc_lld_serve_interrupt(CRCDriver *crcp, uint32_t flags) {
 void crc_lld_init(void) {
   crcObjectInit(&CRCD1);
   CRCD1.crc    = CRC;
+#if (CRC_USE_DMA == TRUE) && (CRC_USE_SCATTER_GATHER == TRUE)
+  CRCD1.nsegs  = 0U;
+#endif
 }
 
 /**
@@ -336,6 +348,43 @@ void crc_lld_start_calc(CRCDriver *crcp, size_t n, const void *buf) {
 
   dmaStreamEnable(crcp->dmastp);
 }
+
+#if (CRC_USE_SCATTER_GATHER == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the CRC of a scatter-gather list.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] segs      pointer to the segments array
+ * @param[in] nsegs     number of segments
+ *
+ * @notapi
+ */
+uint32_t crc_lld_calc_sg(CRCDriver *crcp, const crcsegment_t *segs,
+                         size_t nsegs) {
+  crc_lld_start_calc_sg(crcp, segs, nsegs);
+  (void) osalThreadSuspendS(&crcp->thread);
+  return crcp->crc->DR ^ crcp->config->final_val;
+}
+
+/**
+ * @brief   Starts the DMA transfer of a scatter-gather list.
+ * @details The DMA controller has no linked descriptors, the next segment
+ *          is started from the transfer complete interrupt of the previous
+ *          one.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] segs      pointer to the segments array
+ * @param[in] nsegs     number of segments
+ *
+ * @notapi
+ */
+void crc_lld_start_calc_sg(CRCDriver *crcp, const crcsegment_t *segs,
+                           size_t nsegs) {
+  crcp->segs  = &segs[1];
+  crcp->nsegs = nsegs - 1U;
+  crc_lld_start_calc(crcp, segs[0].n, segs[0].buf);
+}
+#endif
 #endif
 
 #endif /* CRCSW_USE_CRC1 */
@@ -188,6 +188,20 @@ struct CRCDriver {
    */
   mutex_t                   mutex;
 #endif /* CRC_USE_MUTUAL_EXCLUSION */
+#if (CRC_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Unit statistics.
+   */
+  crcstats_t                stats;
+  /**
+   * @brief   Start time of the current operation.
+   */
+  crctime_t                 start;
+  /**
+   * @brief   Size of the current operation.
+   */
+  size_t                    size;
+#endif /* CRC_USE_STATISTICS */
 #if defined(CRC_DRIVER_EXT_FIELDS)
   CRC_DRIVER_EXT_FIELDS
 #endif
@@ -216,6 +230,16 @@ struct CRCDriver {
    * @brief DMA mode bit mask.
    */
   uint32_t                  dmamode;
+#if (CRC_USE_SCATTER_GATHER == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Segments of the current list not yet transferred.
+   */
+  const crcsegment_t        *segs;
+  /**
+   * @brief   Number of segments not yet transferred.
+   */
+  size_t                    nsegs;
+#endif
 #endif
 };
 
@@ -241,6 +265,12 @@ extern "C" {
   uint32_t crc_lld_calc(CRCDriver *crcp, size_t n, const void *buf);
 #if CRC_USE_DMA
   void crc_lld_start_calc(CRCDriver *crcp, size_t n, const void *buf);
+#if CRC_USE_SCATTER_GATHER == TRUE
+  uint32_t crc_lld_calc_sg(CRCDriver *crcp, const crcsegment_t *segs,
+                           size_t nsegs);
+  void crc_lld_start_calc_sg(CRCDriver *crcp, const crcsegment_t *segs,
+                             size_t nsegs);
+#endif
 #endif
 #ifdef __cplusplus
 }
@@ -1397,6 +1397,8 @@ static void usb_lld_serve_interrupt(USBHDriver *host) {
 
 	otg->GINTSTS = gintsts;
 
+	const usbh_portcstatus_t c_status = host->rootport.lld_c_status;
+
 	if (gintsts & GINTSTS_SOF)
 		_sof_int(host);
 	if (gintsts & GINTSTS_RXFLVL)
@@ -1414,6 +1416,10 @@ static void usb_lld_serve_interrupt(USBHDriver *host) {
 	if (gintsts & GINTSTS_IPXFR) {
 		uerr("IPXFRM");
 	}
+
+	/* wake up the main loop on root hub port status changes */
+	if (host->rootport.lld_c_status != c_status)
+		_usbh_signal_eventI(host, USBH_EVENT_ROOTHUB);
 }
 
 
@@ -212,6 +212,47 @@ static void mac_lld_set_address(const uint8_t *p)
   HWREG(EMAC0_BASE + EMAC_O_HASHTBLL) = 0;
 }
 
+#if TIVA_MAC_USE_ATTACHED_BUFFERS || defined(__DOXYGEN__)
+/**
+ * @brief   Reclaims the transmit descriptors released by the DMA.
+ * @details The static buffers are restored into the descriptors and the
+ *          attached buffers are returned to their owners.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+static void mac_lld_reclaim_transmit_descriptors(MACDriver *macp)
+{
+  tiva_eth_tx_descriptor_t *tdes;
+  void *ref;
+
+  while (true) {
+    osalSysLock();
+
+    /* Descriptors are reclaimed in ring order, stopping at the first one
+       still owned by the DMA or being filled.*/
+    tdes = macp->txdirty;
+    if ((macp->txbusy == 0) || (tdes->tdes0 & TIVA_TDES0_OWN) ||
+        (tdes->locked)) {
+      osalSysUnlock();
+      return;
+    }
+
+    ref           = tdes->ref;
+    tdes->ref     = NULL;
+    tdes->tdes2   = (uint32_t)tb[tdes - td];
+    macp->txdirty = (tiva_eth_tx_descriptor_t *)tdes->tdes3;
+    macp->txbusy--;
+
+    osalSysUnlock();
+
+    if ((ref != NULL) && (macp->config->txrelease != NULL))
+      macp->config->txrelease(macp, ref);
+  }
+}
+#endif /* TIVA_MAC_USE_ATTACHED_BUFFERS */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -264,7 +305,13 @@ void mac_lld_init(void)
   /* Descriptor tables are initialized in chained mode, note that the first
      word is not initialized here but in mac_lld_start().*/
   for (i = 0; i < TIVA_MAC_RECEIVE_BUFFERS; i++) {
+#if TIVA_MAC_RX_WATCHDOG > 0
+    /* Completion interrupts left to the receive watchdog.*/
+    rd[i].rdes1 = TIVA_RDES1_DIC | TIVA_RDES1_RCH |
+                  TIVA_RDES1_RBS1(TIVA_MAC_BUFFERS_SIZE);
+#else
     rd[i].rdes1 = TIVA_RDES1_RCH | TIVA_RDES1_RBS1(TIVA_MAC_BUFFERS_SIZE);
+#endif
     rd[i].rdes2 = (uint32_t)rb[i];
     rd[i].rdes3 = (uint32_t)&rd[(i + 1) % TIVA_MAC_RECEIVE_BUFFERS];
   }
@@ -370,8 +417,16 @@ void mac_lld_start(MACDriver *macp)
   for (i = 0; i < TIVA_MAC_TRANSMIT_BUFFERS; i++) {
     td[i].tdes0 = TIVA_TDES0_TCH;
     td[i].locked = 0;
+#if TIVA_MAC_USE_ATTACHED_BUFFERS
+    td[i].tdes2 = (uint32_t)tb[i];
+    td[i].ref = NULL;
+#endif
   }
   macp->txptr = (tiva_eth_tx_descriptor_t *)td;
+#if TIVA_MAC_USE_ATTACHED_BUFFERS
+  macp->txdirty = (tiva_eth_tx_descriptor_t *)td;
+  macp->txbusy = 0;
+#endif
 
   /* Enable MAC clock */
   HWREG(SYSCTL_RCGCEMAC) = 1;
@@ -416,6 +471,10 @@ void mac_lld_start(MACDriver *macp)
   HWREG(EMAC0_BASE + EMAC_O_RXDLADDR) = (uint32_t)rd;
   HWREG(EMAC0_BASE + EMAC_O_TXDLADDR) = (uint32_t)td;
 
+  /* Receive interrupt watchdog, only used if the descriptors have the
+     completion interrupt disabled.*/
+  HWREG(EMAC0_BASE + EMAC_O_RXINTWDT) = TIVA_MAC_RX_WATCHDOG;
+
   /* Enabling required interrupt sources.*/
   HWREG(EMAC0_BASE + EMAC_O_DMARIS) &= 0xFFFF;
   HWREG(EMAC0_BASE + EMAC_O_DMAIM) = (1 << 16) | (1 << 6) | (1 << 0);
@@ -452,6 +511,7 @@ void mac_lld_stop(MACDriver *macp)
     HWREG(EMAC0_BASE + EMAC_O_CFG) = 0;
     HWREG(EMAC0_BASE + EMAC_O_DMAOPMODE) = 0;
     HWREG(EMAC0_BASE + EMAC_O_DMAIM) = 0;
+    HWREG(EMAC0_BASE + EMAC_O_RXINTWDT) = 0;
     HWREG(EMAC0_BASE + EMAC_O_DMARIS) &= 0xFFFF;
 
     /* MAC clocks stopped.*/
@@ -486,6 +546,11 @@ msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
   if (!macp->link_up)
     return MSG_TIMEOUT;
 
+#if TIVA_MAC_USE_ATTACHED_BUFFERS
+  /* Descriptors sent since the last call are made available again.*/
+  mac_lld_reclaim_transmit_descriptors(macp);
+#endif
+
   osalSysLock();
 
   /* Get Current TX descriptor.*/
@@ -493,13 +558,20 @@ msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
 
   /* Ensure that descriptor isn't owned by the Ethernet DMA or locked by
      another thread.*/
-  if (tdes->tdes0 & (TIVA_TDES0_OWN) || (tdes->locked)) {
+  if (tdes->tdes0 & (TIVA_TDES0_OWN) || (tdes->locked)
+#if TIVA_MAC_USE_ATTACHED_BUFFERS
+      || (macp->txbusy >= TIVA_MAC_TRANSMIT_BUFFERS)
+#endif
+      ) {
     osalSysUnlock();
     return MSG_TIMEOUT;
   }
 
   /* Marks the current descriptor as locked.*/
   tdes->locked = 1;
+#if TIVA_MAC_USE_ATTACHED_BUFFERS
+  macp->txbusy++;
+#endif
 
   /* Next TX descriptor to use.*/
   macp->txptr = (tiva_eth_tx_descriptor_t *)tdes->tdes3;
@@ -510,6 +582,10 @@ msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
   tdp->offset   = 0;
   tdp->size     = TIVA_MAC_BUFFERS_SIZE;
   tdp->physdesc = tdes;
+#if TIVA_MAC_USE_ATTACHED_BUFFERS
+  tdp->macp     = macp;
+  tdp->lastdesc = NULL;
+#endif
 
   return MSG_OK;
 }
@@ -529,12 +605,39 @@ void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp)
 
   osalSysLock();
 
-  /* Unlocks the descriptor and returns it to the DMA engine.*/
-  tdp->physdesc->tdes1 = tdp->offset;
-  tdp->physdesc->tdes0 = TIVA_TDES0_CIC(TIVA_MAC_IP_CHECKSUM_OFFLOAD) |
-                         TIVA_TDES0_IC | TIVA_TDES0_LS | TIVA_TDES0_FS |
-                         TIVA_TDES0_TCH | TIVA_TDES0_OWN;
-  tdp->physdesc->locked = 0;
+#if TIVA_MAC_USE_ATTACHED_BUFFERS
+  if ((tdp->lastdesc != NULL) && (tdp->lastdesc != tdp->physdesc)) {
+    tiva_eth_tx_descriptor_t *tdes = tdp->physdesc;
+
+    /* Frame spanning several descriptors, the following ones are returned
+       to the DMA engine before the first so that the DMA never sees a
+       partial frame.*/
+    do {
+      tdes = (tiva_eth_tx_descriptor_t *)tdes->tdes3;
+      tdes->tdes0 = TIVA_TDES0_CIC(TIVA_MAC_IP_CHECKSUM_OFFLOAD) |
+                    TIVA_TDES0_TCH | TIVA_TDES0_OWN;
+      tdes->locked = 0;
+    } while (tdes != tdp->lastdesc);
+    tdes->tdes0 |= TIVA_TDES0_IC | TIVA_TDES0_LS;
+
+    tdp->physdesc->tdes0 = TIVA_TDES0_CIC(TIVA_MAC_IP_CHECKSUM_OFFLOAD) |
+                           TIVA_TDES0_FS | TIVA_TDES0_TCH | TIVA_TDES0_OWN;
+    tdp->physdesc->locked = 0;
+  }
+  else
+#endif
+  {
+    /* Unlocks the descriptor and returns it to the DMA engine, the size
+       is already set if a buffer has been attached.*/
+#if TIVA_MAC_USE_ATTACHED_BUFFERS
+    if (tdp->lastdesc == NULL)
+#endif
+      tdp->physdesc->tdes1 = tdp->offset;
+    tdp->physdesc->tdes0 = TIVA_TDES0_CIC(TIVA_MAC_IP_CHECKSUM_OFFLOAD) |
+                           TIVA_TDES0_IC | TIVA_TDES0_LS | TIVA_TDES0_FS |
+                           TIVA_TDES0_TCH | TIVA_TDES0_OWN;
+    tdp->physdesc->locked = 0;
+  }
 
   /* If the DMA engine is stalled then a restart request is issued.*/
   if ((HWREG(EMAC0_BASE + EMAC_O_DMARIS) & (0x7 << 20)) == (6 << 20)) {
@@ -781,7 +884,11 @@ uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
                                           size_t size,
                                           size_t *sizep)
 {
+#if TIVA_MAC_USE_ATTACHED_BUFFERS
+  if ((tdp->offset == 0) && (tdp->lastdesc == NULL)) {
+#else
   if (tdp->offset == 0) {
+#endif
     *sizep      = tdp->size;
     tdp->offset = size;
     return (uint8_t *)tdp->physdesc->tdes2;
@@ -818,6 +925,129 @@ const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
 }
 #endif /* MAC_USE_ZERO_COPY */
 
+#if TIVA_MAC_USE_ATTACHED_BUFFERS || defined(__DOXYGEN__)
+/**
+ * @brief   Appends a caller buffer to a transmit frame without copying.
+ * @details The buffer is attached to the next descriptor of the chain, the
+ *          data already written in the descriptor's stream becomes the head
+ *          of the frame and no more data can be written to the stream.
+ *          If no descriptor is available the buffer data is copied into
+ *          the last descriptor of the frame instead.
+ * @note    The buffer must stay valid until it is returned through the
+ *          @p txrelease callback of the configuration.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] buf       pointer to the buffer to be appended
+ * @param[in] size      size of the buffer
+ * @param[in] ref       reference passed to the @p txrelease callback
+ * @return              The attachment status.
+ * @retval true         the buffer has been attached, @p ref will be passed
+ *                      to the @p txrelease callback.
+ * @retval false        the buffer has been copied, it is immediately
+ *                      available to the caller again.
+ *
+ * @notapi
+ */
+bool mac_lld_attach_transmit_buffer(MACTransmitDescriptor *tdp,
+                                    const uint8_t *buf,
+                                    size_t size,
+                                    void *ref)
+{
+  MACDriver *macp = tdp->macp;
+  tiva_eth_tx_descriptor_t *tdes;
+  uint8_t *sbuf;
+
+  osalDbgAssert(!(tdp->physdesc->tdes0 & TIVA_TDES0_OWN),
+              "attempt to write descriptor already owned by DMA");
+
+  if (tdp->lastdesc == NULL) {
+    /* First attachment, the stream is closed.*/
+    tdp->size     = tdp->offset;
+    tdp->lastdesc = tdp->physdesc;
+    if (tdp->offset == 0) {
+      /* Nothing written, the buffer goes in the first descriptor.*/
+      tdp->physdesc->tdes1 = size;
+      tdp->physdesc->tdes2 = (uint32_t)buf;
+      tdp->physdesc->ref   = ref;
+      return true;
+    }
+    tdp->physdesc->tdes1 = tdp->offset;
+  }
+
+  osalSysLock();
+
+  /* The next descriptor must follow the frame in the chain, it cannot if
+     another thread took it meanwhile.*/
+  tdes = macp->txptr;
+  if ((tdes == (tiva_eth_tx_descriptor_t *)tdp->lastdesc->tdes3) &&
+      (macp->txbusy < TIVA_MAC_TRANSMIT_BUFFERS)) {
+    tdes->locked  = 1;
+    macp->txptr   = (tiva_eth_tx_descriptor_t *)tdes->tdes3;
+    macp->txbusy++;
+
+    osalSysUnlock();
+
+    tdes->tdes1   = size;
+    tdes->tdes2   = (uint32_t)buf;
+    tdes->ref     = ref;
+    tdp->lastdesc = tdes;
+    return true;
+  }
+
+  osalSysUnlock();
+
+  /* Fall back on copying into the static buffer of the last descriptor,
+     moving there the attached data first.*/
+  tdes = tdp->lastdesc;
+  sbuf = (uint8_t *)tb[tdes - td];
+  osalDbgAssert(tdes->tdes1 + size <= TIVA_MAC_BUFFERS_SIZE,
+              "frame too large");
+  if (tdes->tdes2 != (uint32_t)sbuf) {
+    memcpy(sbuf, (const uint8_t *)tdes->tdes2, tdes->tdes1);
+    tdes->tdes2 = (uint32_t)sbuf;
+  }
+  memcpy(sbuf + tdes->tdes1, buf, size);
+  tdes->tdes1 += size;
+
+  return false;
+}
+
+/**
+ * @brief   Exchanges the buffer of a received frame with a caller buffer.
+ * @details The buffer containing the frame is handed to the caller and the
+ *          caller buffer takes its place in the descriptor, the frame is
+ *          no longer readable from the descriptor's stream.
+ * @note    The caller buffer must be word aligned and at least
+ *          @p TIVA_MAC_BUFFERS_SIZE bytes large.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[in] buf       pointer to the replacement buffer
+ * @param[out] sizep    pointer to variable receiving the frame size
+ * @return              Pointer to the buffer containing the frame.
+ *
+ * @notapi
+ */
+uint8_t *mac_lld_exchange_receive_buffer(MACReceiveDescriptor *rdp,
+                                         uint8_t *buf,
+                                         size_t *sizep)
+{
+  uint8_t *p;
+
+  osalDbgAssert(!(rdp->physdesc->rdes0 & TIVA_RDES0_OWN),
+              "attempt to read descriptor already owned by DMA");
+  osalDbgAssert(((uint32_t)buf & 3U) == 0U, "unaligned buffer");
+
+  p = (uint8_t *)rdp->physdesc->rdes2;
+  rdp->physdesc->rdes2 = (uint32_t)buf;
+
+  *sizep      = rdp->size;
+  rdp->offset = 0;
+  rdp->size   = 0;
+
+  return p;
+}
+#endif /* TIVA_MAC_USE_ATTACHED_BUFFERS */
+
 #endif /* HAL_USE_MAC */
 
 /** @} */
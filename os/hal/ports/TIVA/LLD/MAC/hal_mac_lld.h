@@ -243,6 +243,31 @@
 #if !defined(TIVA_MAC_IP_CHECKSUM_OFFLOAD) || defined(__DOXYGEN__)
 #define TIVA_MAC_IP_CHECKSUM_OFFLOAD        0
 #endif
+
+/**
+ * @brief   Receive interrupt watchdog.
+ * @details When non-zero the receive descriptors do not raise an interrupt
+ *          on completion, the interrupt is raised by the receive watchdog
+ *          instead, this many times 256 system clock cycles after the
+ *          first frame is received. Frames arriving back to back are then
+ *          served by a single interrupt. A zero value disables the
+ *          coalescing.
+ */
+#if !defined(TIVA_MAC_RX_WATCHDOG) || defined(__DOXYGEN__)
+#define TIVA_MAC_RX_WATCHDOG                0
+#endif
+
+/**
+ * @brief   Enables the attached buffers API.
+ * @details Transmit frames can be built from several memory areas owned by
+ *          the caller, each one attached to its own DMA descriptor without
+ *          copying, and the receive buffers can be exchanged with caller
+ *          buffers.
+ * @note    Requires @p MAC_USE_ZERO_COPY.
+ */
+#if !defined(TIVA_MAC_USE_ATTACHED_BUFFERS) || defined(__DOXYGEN__)
+#define TIVA_MAC_USE_ATTACHED_BUFFERS       FALSE
+#endif
 /** @} */
 
 #ifndef EMAC_PHY_CONFIG
@@ -266,6 +291,14 @@
 #error "Invalid IRQ priority assigned to MAC"
 #endif
 
+#if (TIVA_MAC_RX_WATCHDOG < 0) || (TIVA_MAC_RX_WATCHDOG > 255)
+#error "TIVA_MAC_RX_WATCHDOG out of range (0...255)"
+#endif
+
+#if TIVA_MAC_USE_ATTACHED_BUFFERS && !MAC_USE_ZERO_COPY
+#error "TIVA_MAC_USE_ATTACHED_BUFFERS requires MAC_USE_ZERO_COPY"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -291,6 +324,12 @@ typedef struct
   volatile uint32_t     tdes2;
   volatile uint32_t     tdes3;
   volatile uint32_t     locked;
+#if TIVA_MAC_USE_ATTACHED_BUFFERS || defined(__DOXYGEN__)
+  /**
+   * @brief Reference to the attached buffer owner, NULL if none.
+   */
+  void                  *ref;
+#endif
 } tiva_eth_tx_descriptor_t;
 
 /**
@@ -303,6 +342,17 @@ typedef struct
    */
   uint8_t               *mac_address;
   /* End of the mandatory fields.*/
+#if TIVA_MAC_USE_ATTACHED_BUFFERS || defined(__DOXYGEN__)
+  /**
+   * @brief Attached transmit buffer release callback, can be NULL.
+   * @details Invoked in thread context with the reference passed to
+   *          @p mac_lld_attach_transmit_buffer() once the DMA no longer
+   *          accesses the buffer. Completed descriptors are reclaimed when
+   *          a new transmit descriptor is requested, buffers still queued
+   *          when the driver is stopped are not returned.
+   */
+  void                  (*txrelease)(MACDriver *macp, void *ref);
+#endif
 } MACConfig;
 
 /**
@@ -349,6 +399,16 @@ struct MACDriver
    * @brief Transmit next frame pointer.
    */
   tiva_eth_tx_descriptor_t *txptr;
+#if TIVA_MAC_USE_ATTACHED_BUFFERS || defined(__DOXYGEN__)
+  /**
+   * @brief Oldest transmit descriptor not yet reclaimed.
+   */
+  tiva_eth_tx_descriptor_t *txdirty;
+  /**
+   * @brief Number of transmit descriptors taken and not yet reclaimed.
+   */
+  uint32_t              txbusy;
+#endif
 };
 
 /**
@@ -369,6 +429,17 @@ typedef struct
    * @brief Pointer to the physical descriptor.
    */
   tiva_eth_tx_descriptor_t *physdesc;
+#if TIVA_MAC_USE_ATTACHED_BUFFERS || defined(__DOXYGEN__)
+  /**
+   * @brief Pointer to the owner driver.
+   */
+  MACDriver                 *macp;
+  /**
+   * @brief Pointer to the last physical descriptor of the frame, NULL if
+   *        no buffer has been attached.
+   */
+  tiva_eth_tx_descriptor_t *lastdesc;
+#endif
 } MACTransmitDescriptor;
 
 /**
@@ -427,6 +498,15 @@ extern "C" {
   const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
                                                  size_t *sizep);
 #endif /* MAC_USE_ZERO_COPY */
+#if TIVA_MAC_USE_ATTACHED_BUFFERS
+  bool mac_lld_attach_transmit_buffer(MACTransmitDescriptor *tdp,
+                                      const uint8_t *buf,
+                                      size_t size,
+                                      void *ref);
+  uint8_t *mac_lld_exchange_receive_buffer(MACReceiveDescriptor *rdp,
+                                           uint8_t *buf,
+                                           size_t *sizep);
+#endif /* TIVA_MAC_USE_ATTACHED_BUFFERS */
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,276 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    uDMA/hal_dmach_lld.c
+ * @brief   TM4C123x DMA channels subsystem low level driver source.
+ *
+ * @addtogroup DMACH
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_DMACH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Control word of the primary structure copying a task list.
+ */
+#define DMACH_SG_CHCTL      (UDMA_CHCTL_DSTINC_32 | UDMA_CHCTL_DSTSIZE_32 |  \
+                             UDMA_CHCTL_SRCINC_32 | UDMA_CHCTL_SRCSIZE_32 |  \
+                             UDMA_CHCTL_ARBSIZE_4)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Channels pool.
+ */
+static DMAChannel dmach_channels[DMACH_LLD_CHANNELS];
+
+/**
+ * @brief   CHCTL increments and sizes for each @p DMACH_MODE_WIDTH_x.
+ */
+static const uint32_t dmach_srcinc[3] = {
+  UDMA_CHCTL_SRCINC_8, UDMA_CHCTL_SRCINC_16, UDMA_CHCTL_SRCINC_32
+};
+static const uint32_t dmach_dstinc[3] = {
+  UDMA_CHCTL_DSTINC_8, UDMA_CHCTL_DSTINC_16, UDMA_CHCTL_DSTINC_32
+};
+static const uint32_t dmach_size[3] = {
+  UDMA_CHCTL_SRCSIZE_8 | UDMA_CHCTL_DSTSIZE_8,
+  UDMA_CHCTL_SRCSIZE_16 | UDMA_CHCTL_DSTSIZE_16,
+  UDMA_CHCTL_SRCSIZE_32 | UDMA_CHCTL_DSTSIZE_32
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   UDMA channel handler.
+ * @note    The software channel only interrupts at the end of the chain.
+ *
+ * @param[in] p         pointer to the @p DMAChannel object
+ * @param[in] flags     UDMA handler flags
+ */
+static void dmach_lld_serve_interrupt(void *p, uint32_t flags)
+{
+  DMAChannel *dchp = (DMAChannel *)p;
+
+  if ((flags & TIVA_UDMA_FLAG_ERROR) != 0U) {
+    _dmach_isr_code(dchp, DMACH_FLAG_ERROR);
+  }
+  else {
+    _dmach_isr_code(dchp, DMACH_FLAG_DONE | DMACH_FLAG_END);
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level DMACH driver initialization.
+ *
+ * @notapi
+ */
+void dmach_lld_init(void)
+{
+  dmachObjectInit(&dmach_channels[0]);
+  dmach_channels[0].dmanr = TIVA_DMACH_SW_CHANNEL;
+}
+
+/**
+ * @brief   Allocates the software channel.
+ *
+ * @param[in] id        zero or @p DMACH_ID_ANY
+ * @param[in] priority  non zero for the UDMA high priority level
+ * @return              The allocated channel.
+ * @retval NULL         if the channel is not available.
+ *
+ * @notapi
+ */
+DMAChannel *dmach_lld_alloc(uint32_t id, uint32_t priority)
+{
+  DMAChannel *dchp = &dmach_channels[0];
+
+  (void)id;
+
+  if (udmaChannelAllocate(dchp->dmanr)) {
+    return NULL;
+  }
+
+  udmaChannelSetHandler(dchp->dmanr, dmach_lld_serve_interrupt, dchp);
+  if (priority != 0U) {
+    dmaChannelPriorityHigh(dchp->dmanr);
+  }
+  else {
+    dmaChannelPriorityDefault(dchp->dmanr);
+  }
+  dmaChannelSingleBurst(dchp->dmanr);
+  dmaChannelPrimary(dchp->dmanr);
+
+  return dchp;
+}
+
+/**
+ * @brief   Releases the software channel.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @notapi
+ */
+void dmach_lld_free(DMAChannel *dchp)
+{
+  udmaChannelRelease(dchp->dmanr);
+}
+
+/**
+ * @brief   Selects the request pacing the next chains.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] trigger   only @p DMACH_TRIGGER_SOFTWARE
+ *
+ * @notapi
+ */
+void dmach_lld_set_trigger(DMAChannel *dchp, dmachtrigger_t trigger)
+{
+  (void)dchp;
+
+  osalDbgAssert(trigger == DMACH_TRIGGER_SOFTWARE, "invalid trigger");
+}
+
+/**
+ * @brief   Initializes a transfer descriptor.
+ * @note    @p DMACH_MODE_CB is not supported, the descriptors are memory
+ *          to memory tasks.
+ *
+ * @param[out] descp    pointer to the descriptor
+ * @param[in] dst       destination address
+ * @param[in] src       source address
+ * @param[in] n         number of items
+ * @param[in] mode      descriptor mode flags
+ *
+ * @notapi
+ */
+void dmach_lld_desc_setup(dmach_desc_t *descp, void *dst, const void *src,
+                          size_t n, uint32_t mode)
+{
+  uint32_t w = mode & DMACH_MODE_WIDTH_MASK;
+  uint32_t last = (uint32_t)(n - 1U) << w;
+  uint32_t chctl;
+
+  chctl = dmach_size[w] | UDMA_CHCTL_ARBSIZE_8 | UDMA_CHCTL_XFERSIZE(n) |
+          UDMA_CHCTL_XFERMODE_MEM_SGA;
+  if ((mode & DMACH_MODE_SRC_INC) != 0U) {
+    chctl |= dmach_srcinc[w];
+    descp->srcendp = (void *)((const uint8_t *)src + last);
+  }
+  else {
+    chctl |= UDMA_CHCTL_SRCINC_NONE;
+    descp->srcendp = (void *)src;
+  }
+  if ((mode & DMACH_MODE_DST_INC) != 0U) {
+    chctl |= dmach_dstinc[w];
+    descp->dstendp = (uint8_t *)dst + last;
+  }
+  else {
+    chctl |= UDMA_CHCTL_DSTINC_NONE;
+    descp->dstendp = dst;
+  }
+  descp->chctl  = chctl;
+  descp->unused = 0U;
+}
+
+/**
+ * @brief   Starts a chain of descriptors.
+ * @details A single descriptor is executed in auto mode from the primary
+ *          structure. Longer chains are copied to the alternate structure
+ *          by the primary one in memory scatter-gather mode, the last task
+ *          is executed in auto mode.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] descs     array of descriptors
+ * @param[in] len       number of descriptors, at most 256
+ * @param[in] circular  not supported
+ *
+ * @notapi
+ */
+void dmach_lld_start(DMAChannel *dchp, dmach_desc_t *descs, unsigned len,
+                     bool circular)
+{
+  tiva_udma_table_entry_t *primary = &udmaControlTable.primary[dchp->dmanr];
+  dmach_desc_t *lastp = &descs[len - 1U];
+  unsigned i;
+
+  (void)circular;
+
+  osalDbgAssert(len <= 256U, "too many descriptors");
+
+  for (i = 0U; i + 1U < len; i++) {
+    descs[i].chctl = (descs[i].chctl & ~UDMA_CHCTL_XFERMODE_M) |
+                     UDMA_CHCTL_XFERMODE_MEM_SGA;
+  }
+  lastp->chctl = (lastp->chctl & ~UDMA_CHCTL_XFERMODE_M) |
+                 UDMA_CHCTL_XFERMODE_AUTO;
+
+  if (len == 1U) {
+    primary->srcendp = lastp->srcendp;
+    primary->dstendp = lastp->dstendp;
+    primary->chctl   = lastp->chctl;
+  }
+  else {
+    primary->srcendp = &lastp->unused;
+    primary->dstendp = &udmaControlTable.alternate[dchp->dmanr].unused;
+    primary->chctl   = DMACH_SG_CHCTL | UDMA_CHCTL_XFERSIZE(len * 4U) |
+                       UDMA_CHCTL_XFERMODE_MEM_SG;
+  }
+
+  dmaChannelPrimary(dchp->dmanr);
+  dmaChannelEnable(dchp->dmanr);
+  HWREG(UDMA_SWREQ) = (1 << dchp->dmanr);
+}
+
+/**
+ * @brief   Stops the channel.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @notapi
+ */
+void dmach_lld_stop(DMAChannel *dchp)
+{
+  dmaChannelDisable(dchp->dmanr);
+  HWREG(UDMA_CHIS) = (1 << dchp->dmanr);
+}
+
+#endif /* HAL_USE_DMACH == TRUE */
+
+/** @} */
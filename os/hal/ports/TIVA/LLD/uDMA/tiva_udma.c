@@ -44,6 +44,19 @@ udmaControlTable_t udmaControlTable;
 
 static uint32_t udma_channel_mask;
 
+/**
+ * @brief   Mask of the channels with a handler installed.
+ */
+static uint32_t udma_handler_mask;
+
+/**
+ * @brief   Channel handlers.
+ */
+static struct {
+  tiva_udmaisr_t    func;
+  void              *param;
+} udma_handlers[32];
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -62,9 +75,20 @@ static uint32_t udma_channel_mask;
  */
 OSAL_IRQ_HANDLER(TIVA_UDMA_SW_HANDLER)
 {
+  uint32_t chis;
+
   OSAL_IRQ_PROLOGUE();
 
-  /* TODO Process software transfer interrupts.*/
+  /* Peripheral channels are served by their drivers.*/
+  chis = HWREG(UDMA_CHIS) & udma_handler_mask;
+  HWREG(UDMA_CHIS) = chis;
+
+  while (chis != 0U) {
+    uint32_t ch = (uint32_t)__builtin_ctz(chis);
+
+    chis &= ~(1U << ch);
+    udma_handlers[ch].func(udma_handlers[ch].param, TIVA_UDMA_FLAG_COMPLETE);
+  }
 
   OSAL_IRQ_EPILOGUE();
 }
@@ -79,12 +103,22 @@ OSAL_IRQ_HANDLER(TIVA_UDMA_SW_HANDLER)
  */
 OSAL_IRQ_HANDLER(TIVA_UDMA_ERR_HANDLER)
 {
-  OSAL_IRQ_PROLOGUE();
+  uint32_t mask;
 
-  /* TODO Do we need to halt the system on a DMA error?*/
+  OSAL_IRQ_PROLOGUE();
 
   if (HWREG(UDMA_ERRCLR)) {
     HWREG(UDMA_ERRCLR) = 1;
+
+    /* The failing channel is not reported by the controller, it is among
+       the channels that have been disabled. Each handler is notified.*/
+    mask = udma_handler_mask;
+    while (mask != 0U) {
+      uint32_t ch = (uint32_t)__builtin_ctz(mask);
+
+      mask &= ~(1U << ch);
+      udma_handlers[ch].func(udma_handlers[ch].param, TIVA_UDMA_FLAG_ERROR);
+    }
   }
 
   OSAL_IRQ_EPILOGUE();
@@ -102,6 +136,7 @@ OSAL_IRQ_HANDLER(TIVA_UDMA_ERR_HANDLER)
 void udmaInit(void)
 {
   udma_channel_mask = 0;
+  udma_handler_mask = 0;
 
   /* Enable UDMA module.*/
   HWREG(SYSCTL_RCGCDMA) = 1;
@@ -144,6 +179,29 @@ void udmaChannelRelease(uint8_t dmach)
 {
   /* Marks the channel as not used.*/
   udma_channel_mask &= ~(1 << dmach);
+  udma_handler_mask &= ~(1 << dmach);
+}
+
+/**
+ * @brief   Installs the handler of a channel.
+ * @note    The handler is removed when the channel is released.
+ *
+ * @param[in] dmach     channel number
+ * @param[in] func      handling function pointer, @p NULL removes it
+ * @param[in] param     a parameter to be passed to the handling function
+ *
+ * @special
+ */
+void udmaChannelSetHandler(uint8_t dmach, tiva_udmaisr_t func, void *param)
+{
+  udma_handlers[dmach].func  = func;
+  udma_handlers[dmach].param = param;
+  if (func != NULL) {
+    udma_handler_mask |= (1 << dmach);
+  }
+  else {
+    udma_handler_mask &= ~(1 << dmach);
+  }
 }
 
 #endif
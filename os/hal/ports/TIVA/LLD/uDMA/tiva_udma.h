@@ -34,6 +34,14 @@
  */
 #define UDMA_CHCTL_XFERSIZE(n)          (((n)-1) << 4)
 
+/**
+ * @name    Handler flags
+ * @{
+ */
+#define TIVA_UDMA_FLAG_COMPLETE         (1U << 0)
+#define TIVA_UDMA_FLAG_ERROR            (1U << 1)
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -60,6 +68,18 @@
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of a channel handler.
+ * @note    Only software channels report their completion through the
+ *          UDMA software interrupt, peripheral channels complete in the
+ *          peripheral interrupt.
+ *
+ * @param[in] p         parameter for the registered function
+ * @param[in] flags     @p TIVA_UDMA_FLAG_COMPLETE or
+ *                      @p TIVA_UDMA_FLAG_ERROR
+ */
+typedef void (*tiva_udmaisr_t)(void *p, uint32_t flags);
+
 /**
  * @brief   A structure that defines an entry in the channel control table.
  * @note    These fields are used by the uDMA controller and normally it is not
@@ -153,6 +173,8 @@ extern "C" {
   void udmaInit(void);
   bool udmaChannelAllocate(uint8_t dmach);
   void udmaChannelRelease(uint8_t dmach);
+  void udmaChannelSetHandler(uint8_t dmach, tiva_udmaisr_t func,
+                             void *param);
 #ifdef __cplusplus
 }
 #endif
@@ -53,6 +53,10 @@
  */
 void halCommunityInit(void) {
 
+#if HAL_USE_DMACH || defined(__DOXYGEN__)
+  dmachInit();
+#endif
+
 #if HAL_USE_NAND || defined(__DOXYGEN__)
   nandInit();
 #endif
@@ -66,6 +66,11 @@ void crcObjectInit(CRCDriver *crcp) {
 #if CRC_USE_MUTUAL_EXCLUSION == TRUE
   osalMutexObjectInit(&crcp->mutex);
 #endif
+#if CRC_USE_STATISTICS == TRUE
+  crcp->stats.operations = 0U;
+  crcp->stats.bytes      = 0U;
+  crcp->stats.busy       = 0U;
+#endif
 #if defined(CRC_DRIVER_EXT_INIT_HOOK)
   CRC_DRIVER_EXT_INIT_HOOK(crcp);
 #endif
@@ -180,8 +185,16 @@ uint32_t crcCalcI(CRCDriver *crcp, size_t n, const void *buf) {
 #if CRC_USE_DMA
   osalDbgAssert(crcp->config->end_cb == NULL, "callback defined");
   (crcp)->state = CRC_ACTIVE;
-#endif
+  _crc_stats_start(crcp, n);
   return crc_lld_calc(crcp, n, buf);
+#else
+  uint32_t crc;
+
+  _crc_stats_start(crcp, n);
+  crc = crc_lld_calc(crcp, n, buf);
+  _crc_stats_end(crcp);
+  return crc;
+#endif
 }
 
 #if CRC_USE_DMA == TRUE
@@ -223,10 +236,202 @@ void crcStartCalcI(CRCDriver *crcp, size_t n, const void *buf) {
   osalDbgAssert(crcp->state == CRC_READY, "not ready");
   osalDbgAssert(crcp->config->end_cb != NULL, "callback not defined");
   (crcp)->state = CRC_ACTIVE;
+  _crc_stats_start(crcp, n);
   crc_lld_start_calc(crcp, n, buf);
 }
 #endif
 
+#if (CRC_USE_SCATTER_GATHER == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Performs a CRC calculation over a scatter-gather list.
+ * @details This synchronous function computes the CRC of the concatenation
+ *          of the segments, the result is the same as a @p crcCalc() over
+ *          a buffer holding all of them.
+ * @pre     In order to use this function the driver must have been configured
+ *          without callbacks (@p end_cb = @p NULL).
+ * @note    With DMA the segments are chained by the low level driver, the
+ *          calling thread is woken up once, after the last one.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] segs      pointer to the segments array
+ * @param[in] nsegs     number of segments
+ * @return              The computed CRC.
+ *
+ * @api
+ */
+uint32_t crcCalcSG(CRCDriver *crcp, const crcsegment_t *segs, size_t nsegs) {
+  uint32_t crc;
+#if CRC_USE_DMA
+  osalSysLock();
+#endif
+  crc = crcCalcSGI(crcp, segs, nsegs);
+#if CRC_USE_DMA
+  osalSysUnlock();
+#endif
+  return crc;
+}
+
+/**
+ * @brief   Performs a CRC calculation over a scatter-gather list.
+ * @details This synchronous function computes the CRC of the concatenation
+ *          of the segments.
+ * @pre     In order to use this function the driver must have been configured
+ *          without callbacks (@p end_cb = @p NULL).
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] segs      pointer to the segments array
+ * @param[in] nsegs     number of segments
+ * @return              The computed CRC.
+ *
+ * @iclass
+ */
+uint32_t crcCalcSGI(CRCDriver *crcp, const crcsegment_t *segs, size_t nsegs) {
+  uint32_t crc = 0U;
+  size_t i, n = 0U;
+
+  osalDbgCheck((crcp != NULL) && (segs != NULL) && (nsegs > 0U));
+  osalDbgAssert(crcp->state == CRC_READY, "not ready");
+
+  for (i = 0U; i < nsegs; i++) {
+    osalDbgCheck((segs[i].n > 0U) && (segs[i].buf != NULL));
+    n += segs[i].n;
+  }
+  (void)n;
+
+#if CRC_USE_DMA
+  osalDbgAssert(crcp->config->end_cb == NULL, "callback defined");
+  crcp->state = CRC_ACTIVE;
+  _crc_stats_start(crcp, n);
+  crc = crc_lld_calc_sg(crcp, segs, nsegs);
+#else
+  _crc_stats_start(crcp, n);
+  for (i = 0U; i < nsegs; i++) {
+    crc = crc_lld_calc(crcp, segs[i].n, segs[i].buf);
+  }
+  _crc_stats_end(crcp);
+#endif
+
+  return crc;
+}
+
+#if CRC_USE_DMA == TRUE
+/**
+ * @brief   Starts a CRC calculation over a scatter-gather list.
+ * @details This asynchronous function starts the computation of the CRC of
+ *          the concatenation of the segments, the segments array must stay
+ *          valid until the callback is invoked.
+ * @pre     In order to use this function the driver must have been configured
+ *          with callbacks (@p end_cb != @p NULL).
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] segs      pointer to the segments array
+ * @param[in] nsegs     number of segments
+ *
+ * @api
+ */
+void crcStartCalcSG(CRCDriver *crcp, const crcsegment_t *segs, size_t nsegs) {
+  osalSysLock();
+  crcStartCalcSGI(crcp, segs, nsegs);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Starts a CRC calculation over a scatter-gather list.
+ * @details This asynchronous function starts the computation of the CRC of
+ *          the concatenation of the segments, the segments array must stay
+ *          valid until the callback is invoked.
+ * @pre     In order to use this function the driver must have been configured
+ *          with callbacks (@p end_cb != @p NULL).
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] segs      pointer to the segments array
+ * @param[in] nsegs     number of segments
+ *
+ * @iclass
+ */
+void crcStartCalcSGI(CRCDriver *crcp, const crcsegment_t *segs, size_t nsegs) {
+  size_t i, n = 0U;
+
+  osalDbgCheck((crcp != NULL) && (segs != NULL) && (nsegs > 0U));
+  osalDbgAssert(crcp->state == CRC_READY, "not ready");
+  osalDbgAssert(crcp->config->end_cb != NULL, "callback not defined");
+
+  for (i = 0U; i < nsegs; i++) {
+    osalDbgCheck((segs[i].n > 0U) && (segs[i].buf != NULL));
+    n += segs[i].n;
+  }
+  (void)n;
+
+  crcp->state = CRC_ACTIVE;
+  _crc_stats_start(crcp, n);
+  crc_lld_start_calc_sg(crcp, segs, nsegs);
+}
+#endif /* CRC_USE_DMA == TRUE */
+#endif /* CRC_USE_SCATTER_GATHER == TRUE */
+
+#if (CRC_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a snapshot of the unit statistics.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[out] stats    pointer to the statistics structure to be filled
+ *
+ * @api
+ */
+void crcGetStats(CRCDriver *crcp, crcstats_t *stats) {
+
+  osalDbgCheck((crcp != NULL) && (stats != NULL));
+
+  osalSysLock();
+  *stats = crcp->stats;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Clears the unit statistics.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @api
+ */
+void crcResetStats(CRCDriver *crcp) {
+
+  osalDbgCheck(crcp != NULL);
+
+  osalSysLock();
+  crcp->stats.operations = 0U;
+  crcp->stats.bytes      = 0U;
+  crcp->stats.busy       = 0U;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns the throughput of the completed operations.
+ * @details The throughput is computed over the busy time only, the time
+ *          between operations is not accounted.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The throughput in bytes per second, zero if no
+ *                      measurable operation has been completed.
+ *
+ * @api
+ */
+uint32_t crcGetBytesPerSecond(CRCDriver *crcp) {
+  crcstats_t stats;
+  uint64_t bps;
+
+  crcGetStats(crcp, &stats);
+  if (stats.busy == 0U) {
+    return 0U;
+  }
+  bps = (stats.bytes * (uint64_t)crcTimeFrequency()) / stats.busy;
+
+  return bps > 0xFFFFFFFFU ? 0xFFFFFFFFU : (uint32_t)bps;
+}
+#endif /* CRC_USE_STATISTICS == TRUE */
+
 #if (CRC_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Gains exclusive access to the CRC unit.
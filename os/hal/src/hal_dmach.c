@@ -0,0 +1,605 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_dmach.c
+ * @brief   DMA channels Driver code.
+ *
+ * @addtogroup DMACH
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_DMACH == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Ends the running chain.
+ * @note    Invoked with the lock held.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] ok        the chain completed
+ */
+static void dmach_end(DMAChannel *dchp, bool ok) {
+
+#if DMACH_USE_STATISTICS == TRUE
+  dchp->stats.busy += (uint64_t)(dmachtime_t)(dmach_time_now() - dchp->start);
+  if (ok) {
+    dchp->stats.transfers++;
+    dchp->stats.bytes += dchp->size;
+  }
+  else {
+    dchp->stats.errors++;
+  }
+#else
+  (void)ok;
+#endif
+
+  if (dchp->invp != NULL) {
+    cacheBufferInvalidate(dchp->invp, dchp->invn);
+    dchp->invp = NULL;
+  }
+  dchp->state = DMACH_READY;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   DMACH Driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void dmachInit(void) {
+
+  dmach_lld_init();
+}
+
+/**
+ * @brief   Initializes the standard part of a @p DMAChannel structure.
+ * @note    Invoked by the low level driver on each channel of its pool.
+ *
+ * @param[out] dchp     pointer to the @p DMAChannel object
+ *
+ * @init
+ */
+void dmachObjectInit(DMAChannel *dchp) {
+
+  dchp->state    = DMACH_STOP;
+  dchp->callback = NULL;
+  dchp->param    = NULL;
+#if DMACH_USE_WAIT == TRUE
+  dchp->thread   = NULL;
+#endif
+#if DMACH_USE_STATISTICS == TRUE
+  dchp->stats.transfers = 0U;
+  dchp->stats.errors    = 0U;
+  dchp->stats.bytes     = 0U;
+  dchp->stats.busy      = 0U;
+  dchp->size            = 0U;
+#endif
+  dchp->invp     = NULL;
+  dchp->invn     = 0U;
+}
+
+/**
+ * @brief   Allocates a DMA channel.
+ * @details The trigger of the channel is set to @p DMACH_TRIGGER_SOFTWARE.
+ *
+ * @param[in] id        port channel number or @p DMACH_ID_ANY
+ * @param[in] priority  channel priority, the meaning is port specific
+ * @param[in] callback  callback function, can be @p NULL
+ * @param[in] param     user parameter, see @p dmachGetParam()
+ * @return              Pointer to the allocated channel.
+ * @retval NULL         if a/the channel is not available.
+ *
+ * @iclass
+ */
+DMAChannel *dmachAllocI(uint32_t id, uint32_t priority,
+                        dmachcb_t callback, void *param) {
+  DMAChannel *dchp;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((id < DMACH_LLD_CHANNELS) || (id == DMACH_ID_ANY));
+
+  dchp = dmach_lld_alloc(id, priority);
+  if (dchp != NULL) {
+    osalDbgAssert(dchp->state == DMACH_STOP, "invalid state");
+    dchp->callback = callback;
+    dchp->param    = param;
+    dchp->invp     = NULL;
+    dmach_lld_set_trigger(dchp, DMACH_TRIGGER_SOFTWARE);
+    dchp->state    = DMACH_READY;
+  }
+
+  return dchp;
+}
+
+/**
+ * @brief   Allocates a DMA channel.
+ * @details The trigger of the channel is set to @p DMACH_TRIGGER_SOFTWARE.
+ *
+ * @param[in] id        port channel number or @p DMACH_ID_ANY
+ * @param[in] priority  channel priority, the meaning is port specific
+ * @param[in] callback  callback function, can be @p NULL
+ * @param[in] param     user parameter, see @p dmachGetParam()
+ * @return              Pointer to the allocated channel.
+ * @retval NULL         if a/the channel is not available.
+ *
+ * @api
+ */
+DMAChannel *dmachAlloc(uint32_t id, uint32_t priority,
+                       dmachcb_t callback, void *param) {
+  DMAChannel *dchp;
+
+  osalSysLock();
+  dchp = dmachAllocI(id, priority, callback, param);
+  osalSysUnlock();
+
+  return dchp;
+}
+
+/**
+ * @brief   Releases a DMA channel.
+ * @details A chain in progress is stopped.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @iclass
+ */
+void dmachFreeI(DMAChannel *dchp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(dchp != NULL);
+  osalDbgAssert(dchp->state != DMACH_STOP, "not allocated");
+
+  dmachStopI(dchp);
+  dmach_lld_free(dchp);
+  dchp->callback = NULL;
+  dchp->param    = NULL;
+  dchp->state    = DMACH_STOP;
+}
+
+/**
+ * @brief   Releases a DMA channel.
+ * @details A chain in progress is stopped.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @api
+ */
+void dmachFree(DMAChannel *dchp) {
+
+  osalSysLock();
+  dmachFreeI(dchp);
+  osalSchRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Selects the request pacing the channel.
+ * @details The trigger is applied to the chains started afterward,
+ *          @p DMACH_TRIGGER_SOFTWARE starts them immediately.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] trigger   port specific request source
+ *
+ * @xclass
+ */
+void dmachSetTrigger(DMAChannel *dchp, dmachtrigger_t trigger) {
+
+  osalDbgCheck(dchp != NULL);
+  osalDbgAssert(dchp->state == DMACH_READY, "not ready");
+
+  dmach_lld_set_trigger(dchp, trigger);
+}
+
+/**
+ * @brief   Initializes a transfer descriptor.
+ * @note    Descriptors are read by the DMA, they must not be allocated on
+ *          the stack of a thread that does not wait the end of the chain.
+ *
+ * @param[out] descp    pointer to the descriptor
+ * @param[in] dst       destination address
+ * @param[in] src       source address
+ * @param[in] n         number of items, at most
+ *                      @p DMACH_LLD_DESC_MAX_ITEMS
+ * @param[in] mode      descriptor mode flags
+ *
+ * @xclass
+ */
+void dmachDescSetup(dmach_desc_t *descp, void *dst, const void *src,
+                    size_t n, uint32_t mode) {
+
+  osalDbgCheck((descp != NULL) && (n > 0U) &&
+               (n <= (size_t)DMACH_LLD_DESC_MAX_ITEMS));
+
+  dmach_lld_desc_setup(descp, dst, src, n, mode);
+}
+
+/**
+ * @brief   Starts a chain of descriptors.
+ * @details The descriptors are linked in array order, the last one is
+ *          linked to the first one when @p circular is @p true. The
+ *          callback is always invoked at the end of a linear chain.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] descs     array of descriptors
+ * @param[in] len       number of descriptors
+ * @param[in] circular  the chain restarts until @p dmachStopI()
+ *
+ * @iclass
+ */
+void dmachStartI(DMAChannel *dchp, dmach_desc_t *descs, unsigned len,
+                 bool circular) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((dchp != NULL) && (descs != NULL) && (len > 0U));
+  osalDbgAssert(dchp->state == DMACH_READY, "not ready");
+  osalDbgAssert(!circular || (DMACH_LLD_SUPPORTS_CIRCULAR == TRUE),
+                "circular chains not supported");
+
+#if DMACH_USE_STATISTICS == TRUE
+  dchp->size = 0U;
+  if (!circular) {
+    unsigned i;
+
+    for (i = 0U; i < len; i++)
+      dchp->size += dmach_lld_desc_get_size(&descs[i]);
+  }
+  dchp->start = dmach_time_now();
+#endif
+
+  dchp->state = DMACH_ACTIVE;
+  dmach_lld_start(dchp, descs, len, circular);
+}
+
+/**
+ * @brief   Starts a chain of descriptors.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] descs     array of descriptors
+ * @param[in] len       number of descriptors
+ * @param[in] circular  the chain restarts until @p dmachStop()
+ *
+ * @api
+ */
+void dmachStart(DMAChannel *dchp, dmach_desc_t *descs, unsigned len,
+                bool circular) {
+
+  osalSysLock();
+  dmachStartI(dchp, descs, len, circular);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops the chain in progress, if any.
+ * @details A waiting thread is woken up with @p MSG_RESET, the callback is
+ *          not invoked.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @iclass
+ */
+void dmachStopI(DMAChannel *dchp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(dchp != NULL);
+
+  if (dchp->state == DMACH_ACTIVE) {
+    dmach_lld_stop(dchp);
+#if DMACH_USE_STATISTICS == TRUE
+    /* Only the busy time of an interrupted chain is accounted.*/
+    dchp->stats.busy += (uint64_t)(dmachtime_t)(dmach_time_now() -
+                                                dchp->start);
+#endif
+    dchp->invp  = NULL;
+    dchp->state = DMACH_READY;
+#if DMACH_USE_WAIT == TRUE
+    osalThreadResumeI(&dchp->thread, MSG_RESET);
+#endif
+  }
+}
+
+/**
+ * @brief   Stops the chain in progress, if any.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @api
+ */
+void dmachStop(DMAChannel *dchp) {
+
+  osalSysLock();
+  dmachStopI(dchp);
+  osalSchRescheduleS();
+  osalSysUnlock();
+}
+
+#if (DMACH_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for the end of the chain in progress.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The wait result.
+ * @retval MSG_OK       if the chain ended or no chain was in progress.
+ * @retval MSG_RESET    if the chain was stopped or failed.
+ * @retval MSG_TIMEOUT  if the chain is still in progress.
+ *
+ * @api
+ */
+msg_t dmachWaitCompletion(DMAChannel *dchp, sysinterval_t timeout) {
+  msg_t msg = MSG_OK;
+
+  osalDbgCheck(dchp != NULL);
+
+  osalSysLock();
+  if (dchp->state == DMACH_ACTIVE) {
+    msg = osalThreadSuspendTimeoutS(&dchp->thread, timeout);
+  }
+  osalSysUnlock();
+
+  return msg;
+}
+#endif
+
+#if (DMACH_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a snapshot of the channel statistics.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[out] statsp   pointer to the statistics
+ *
+ * @api
+ */
+void dmachGetStats(DMAChannel *dchp, dmachstats_t *statsp) {
+
+  osalDbgCheck((dchp != NULL) && (statsp != NULL));
+
+  osalSysLock();
+  *statsp = dchp->stats;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Clears the channel statistics.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ *
+ * @api
+ */
+void dmachResetStats(DMAChannel *dchp) {
+
+  osalDbgCheck(dchp != NULL);
+
+  osalSysLock();
+  dchp->stats.transfers = 0U;
+  dchp->stats.errors    = 0U;
+  dchp->stats.bytes     = 0U;
+  dchp->stats.busy      = 0U;
+  osalSysUnlock();
+}
+#endif
+
+/**
+ * @brief   Starts a memory to memory copy.
+ * @details The copy uses the widest items allowed by the alignment of the
+ *          addresses and of the size, it is split over the descriptors
+ *          embedded in the channel. The source and destination buffers
+ *          are written back from the data cache and the destination is
+ *          invalidated at the end of the copy.
+ * @note    On cached memory the destination should be aligned to cache
+ *          lines, data sharing a line with it may be lost.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[out] dst      destination buffer
+ * @param[in] src       source buffer
+ * @param[in] n         number of bytes
+ * @return              The operation status.
+ * @retval true         if the copy has been started.
+ * @retval false        if the channel is busy or the copy is too large,
+ *                      nothing has been done.
+ *
+ * @iclass
+ */
+bool dmaMemcpyAsyncI(DMAChannel *dchp, void *dst, const void *src,
+                     size_t n) {
+  uint32_t mode = DMACH_MODE_MEMORY | DMACH_MODE_SRC_INC | DMACH_MODE_DST_INC;
+  uintptr_t align = (uintptr_t)dst | (uintptr_t)src | (uintptr_t)n;
+  uint8_t *dp = (uint8_t *)dst;
+  const uint8_t *sp = (const uint8_t *)src;
+  size_t items;
+  unsigned i;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((dchp != NULL) && (dst != NULL) && (src != NULL) && (n > 0U));
+
+  if (dchp->state != DMACH_READY) {
+    return false;
+  }
+
+  if ((align & 3U) == 0U) {
+    mode |= DMACH_MODE_WIDTH_32;
+  }
+  else if ((align & 1U) == 0U) {
+    mode |= DMACH_MODE_WIDTH_16;
+  }
+  else {
+    mode |= DMACH_MODE_WIDTH_8;
+  }
+
+  items = n / dmachModeWidth(mode);
+  if (items > (size_t)DMACH_MEMCPY_DESCRIPTORS * DMACH_LLD_DESC_MAX_ITEMS) {
+    return false;
+  }
+
+  for (i = 0U; items > 0U; i++) {
+    size_t k = items > (size_t)DMACH_LLD_DESC_MAX_ITEMS ?
+               (size_t)DMACH_LLD_DESC_MAX_ITEMS : items;
+
+    dmach_lld_desc_setup(&dchp->mcdesc[i], dp, sp, k, mode);
+    dp    += k * dmachModeWidth(mode);
+    sp    += k * dmachModeWidth(mode);
+    items -= k;
+  }
+
+  cacheBufferFlush(src, n);
+  cacheBufferFlush(dst, n);
+  dchp->invp = dst;
+  dchp->invn = n;
+
+  dmach_lld_set_trigger(dchp, DMACH_TRIGGER_SOFTWARE);
+  dmachStartI(dchp, dchp->mcdesc, i, false);
+
+  return true;
+}
+
+/**
+ * @brief   Starts a memory to memory copy.
+ * @details The end of the copy is reported by the channel callback with
+ *          @p DMACH_FLAG_END or awaited with @p dmachWaitCompletion().
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[out] dst      destination buffer
+ * @param[in] src       source buffer
+ * @param[in] n         number of bytes
+ * @return              The operation status.
+ * @retval true         if the copy has been started.
+ * @retval false        if the channel is busy or the copy is too large,
+ *                      nothing has been done.
+ *
+ * @api
+ */
+bool dmaMemcpyAsync(DMAChannel *dchp, void *dst, const void *src,
+                    size_t n) {
+  bool started;
+
+  osalSysLock();
+  started = dmaMemcpyAsyncI(dchp, dst, src, n);
+  osalSysUnlock();
+
+  return started;
+}
+
+#if (DMACH_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Copies a memory buffer.
+ * @details The copy is performed by the CPU if it cannot be started on
+ *          the channel, the channel can also be @p NULL.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object or @p NULL
+ * @param[out] dst      destination buffer
+ * @param[in] src       source buffer
+ * @param[in] n         number of bytes
+ * @return              The operation status.
+ * @retval MSG_OK       if the copy has been performed.
+ * @retval MSG_RESET    if the copy has been stopped or failed.
+ *
+ * @api
+ */
+msg_t dmaMemcpy(DMAChannel *dchp, void *dst, const void *src, size_t n) {
+  msg_t msg = MSG_OK;
+
+  if ((dchp != NULL) && (n > 0U)) {
+    osalSysLock();
+    if (dmaMemcpyAsyncI(dchp, dst, src, n)) {
+      msg = osalThreadSuspendS(&dchp->thread);
+      osalSysUnlock();
+      return msg;
+    }
+    osalSysUnlock();
+  }
+
+  memcpy(dst, src, n);
+
+  return msg;
+}
+#endif
+
+/**
+ * @brief   Common ISR code.
+ * @details Invoked by the low level driver on the channel events:
+ *          - Statistics update and driver state transitions.
+ *          - Callback invocation.
+ *          - Waiting thread wakeup, if any.
+ *          .
+ * @note    A channel stopped in the meantime does not report its events.
+ *
+ * @param[in] dchp      pointer to the @p DMAChannel object
+ * @param[in] flags     @p DMACH_FLAG_DONE, @p DMACH_FLAG_END and
+ *                      @p DMACH_FLAG_ERROR
+ *
+ * @notapi
+ */
+void _dmach_isr_code(DMAChannel *dchp, uint32_t flags) {
+
+  osalSysLockFromISR();
+  if (dchp->state != DMACH_ACTIVE) {
+    osalSysUnlockFromISR();
+    return;
+  }
+  if ((flags & DMACH_FLAG_ERROR) != 0U) {
+    dmach_lld_stop(dchp);
+    flags |= DMACH_FLAG_END;
+  }
+  if ((flags & DMACH_FLAG_END) != 0U) {
+    dmach_end(dchp, (flags & DMACH_FLAG_ERROR) == 0U);
+  }
+  osalSysUnlockFromISR();
+
+  if (dchp->callback != NULL) {
+    dchp->callback(dchp, flags);
+  }
+
+#if DMACH_USE_WAIT == TRUE
+  if ((flags & DMACH_FLAG_END) != 0U) {
+    osalSysLockFromISR();
+    osalThreadResumeI(&dchp->thread,
+                      (flags & DMACH_FLAG_ERROR) != 0U ? MSG_RESET : MSG_OK);
+    osalSysUnlockFromISR();
+  }
+#endif
+}
+
+#endif /* HAL_USE_DMACH == TRUE */
+
+/** @} */
@@ -26,10 +26,26 @@
 
 #if (HAL_USE_USB_HID == TRUE) || defined(__DOXYGEN__)
 
+#include <string.h>
+
 /*===========================================================================*/
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#if USB_HID_USE_REPORT_FIFO == TRUE
+/* Cores without exclusive access instructions (ARMv6-M) have no native
+   compare-and-swap, the FIFO reservation takes the kernel lock there.*/
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
+#define HID_FIFO_LOCK_FREE          TRUE
+#else
+#define HID_FIFO_LOCK_FREE          FALSE
+#endif
+
+#define HID_FIFO_MASK               (USB_HID_REPORT_FIFO_LENGTH - 1U)
+
+#define hid_fifo_mode(uhdp)         ((uhdp)->config->report_size > 0U)
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -190,6 +206,13 @@ static void obnotify(io_buffers_queue_t *bqp) {
     return;
   }
 
+#if USB_HID_USE_REPORT_FIFO == TRUE
+  /* The IN endpoint belongs to the report FIFO.*/
+  if (hid_fifo_mode(uhdp)) {
+    return;
+  }
+#endif
+
   /* Checking if there is already a transaction ongoing on the endpoint.*/
   if (!usbGetTransmitStatusI(uhdp->config->usbp, uhdp->config->int_in)) {
     /* Trying to get a full buffer.*/
@@ -201,6 +224,77 @@ static void obnotify(io_buffers_queue_t *bqp) {
   }
 }
 
+#if (USB_HID_USE_REPORT_FIFO == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Accounts dropped reports.
+ *
+ * @param[in] fp        pointer to the @p hidreportfifo_t object
+ * @param[in] n         number of reports
+ */
+static void fifo_count_dropped(hidreportfifo_t *fp, uint32_t n) {
+
+#if HID_FIFO_LOCK_FREE == TRUE
+  (void)__atomic_fetch_add(&fp->stats.dropped, n, __ATOMIC_RELAXED);
+#else
+  fp->stats.dropped += n;
+#endif
+}
+
+/**
+ * @brief   Drops the reports not yet transmitted.
+ *
+ * @param[in] uhdp      pointer to a @p USBHIDDriver object
+ */
+static void fifo_reset_i(USBHIDDriver *uhdp) {
+  hidreportfifo_t *fp = &uhdp->fifo;
+  uint32_t head = __atomic_load_n(&fp->head, __ATOMIC_ACQUIRE);
+
+  fifo_count_dropped(fp, head - fp->tail);
+  fp->inflight = 0;
+  __atomic_store_n(&fp->tail, head, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief   Starts the transmission of the published reports.
+ * @details Consecutive reports are sent in one transfer, up to
+ *          @p report_batch of them, as long as they do not wrap around
+ *          the FIFO.
+ *
+ * @param[in] uhdp      pointer to a @p USBHIDDriver object
+ */
+static void fifo_start_i(USBHIDDriver *uhdp) {
+  hidreportfifo_t *fp = &uhdp->fifo;
+  USBDriver *usbp = uhdp->config->usbp;
+  const size_t size = uhdp->config->report_size;
+  const uint32_t batch = (uhdp->config->report_batch > 0U) ?
+                         (uint32_t)uhdp->config->report_batch : 1U;
+  const uint32_t tail = fp->tail;
+  uint32_t n = 0;
+
+  if ((usbGetDriverStateI(usbp) != USB_ACTIVE) ||
+      (uhdp->state != HID_READY) ||
+      usbGetTransmitStatusI(usbp, uhdp->config->int_in)) {
+    return;
+  }
+
+  while ((n < batch) &&
+         (__atomic_load_n(&fp->seq[(tail + n) & HID_FIFO_MASK],
+                          __ATOMIC_ACQUIRE) == tail + n + 1U)) {
+    n++;
+    if (((tail + n) & HID_FIFO_MASK) == 0U) {
+      break;
+    }
+  }
+
+  if (n > 0U) {
+    fp->inflight = n;
+    fp->stats.coalesced += n - 1U;
+    usbStartTransmitI(usbp, uhdp->config->int_in,
+                      &fp->buf[(tail & HID_FIFO_MASK) * size], n * size);
+  }
+}
+#endif /* USB_HID_USE_REPORT_FIFO == TRUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -235,6 +329,9 @@ void hidObjectInit(USBHIDDriver *uhdp) {
   obqObjectInit(&uhdp->obqueue, true, uhdp->ob,
                 USB_HID_BUFFERS_SIZE, USB_HID_BUFFERS_NUMBER,
                 obnotify, uhdp);
+#if USB_HID_USE_REPORT_FIFO == TRUE
+  memset(&uhdp->fifo, 0, sizeof(uhdp->fifo));
+#endif
 }
 
 /**
@@ -249,6 +346,9 @@ void hidStart(USBHIDDriver *uhdp, const USBHIDConfig *config) {
   USBDriver *usbp = config->usbp;
 
   osalDbgCheck(uhdp != NULL);
+#if USB_HID_USE_REPORT_FIFO == TRUE
+  osalDbgCheck(config->report_size <= USB_HID_REPORT_FIFO_SIZE);
+#endif
 
   osalSysLock();
   osalDbgAssert((uhdp->state == HID_STOP) || (uhdp->state == HID_READY),
@@ -304,6 +404,11 @@ void hidDisconnectI(USBHIDDriver *uhdp) {
   chnAddFlagsI(uhdp, CHN_DISCONNECTED);
   ibqResetI(&uhdp->ibqueue);
   obqResetI(&uhdp->obqueue);
+#if USB_HID_USE_REPORT_FIFO == TRUE
+  if (hid_fifo_mode(uhdp)) {
+    fifo_reset_i(uhdp);
+  }
+#endif
 }
 
 /**
@@ -318,6 +423,11 @@ void hidConfigureHookI(USBHIDDriver *uhdp) {
 
   ibqResetI(&uhdp->ibqueue);
   obqResetI(&uhdp->obqueue);
+#if USB_HID_USE_REPORT_FIFO == TRUE
+  if (hid_fifo_mode(uhdp)) {
+    fifo_reset_i(uhdp);
+  }
+#endif
   chnAddFlagsI(uhdp, CHN_CONNECTED);
 
   /* Starts the first OUT transaction immediately.*/
@@ -413,6 +523,21 @@ void hidDataTransmitted(USBDriver *usbp, usbep_t ep) {
   /* Signaling that space is available in the output queue.*/
   chnAddFlagsI(uhdp, CHN_OUTPUT_EMPTY);
 
+#if USB_HID_USE_REPORT_FIFO == TRUE
+  if (hid_fifo_mode(uhdp)) {
+    hidreportfifo_t *fp = &uhdp->fifo;
+
+    /* Releasing the reports just transmitted and sending the next ones.*/
+    fp->stats.sent += fp->inflight;
+    __atomic_store_n(&fp->tail, fp->tail + fp->inflight, __ATOMIC_RELEASE);
+    fp->inflight = 0;
+    fifo_start_i(uhdp);
+
+    osalSysUnlockFromISR();
+    return;
+  }
+#endif
+
   /* Freeing the buffer just transmitted, if it was not a zero size packet.*/
   if (usbp->epc[ep]->in_state->txsize > 0U) {
     obqReleaseEmptyBufferI(&uhdp->obqueue);
@@ -584,6 +709,117 @@ size_t hidReadReportt(USBHIDDriver *uhdp, uint8_t *bp, size_t n, systime_t timeo
   return uhdp->vmt->readt(uhdp, bp, n, timeout);
 }
 
+#if (USB_HID_USE_REPORT_FIFO == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Enqueues a report in the FIFO.
+ * @details Lock-free, can be called from any context including interrupts
+ *          above the kernel priority. The transmission is not started if
+ *          the endpoint is idle, see @p hidFlushReportsI().
+ * @note    On cores without a native compare-and-swap the reservation is
+ *          done under the kernel lock, fast interrupts must not call it.
+ *
+ * @param[in] uhdp      pointer to the @p USBHIDDriver object
+ * @param[in] report    report data, @p report_size bytes
+ * @return              The operation status.
+ * @retval true         report enqueued.
+ * @retval false        FIFO full, the report is dropped.
+ *
+ * @xclass
+ */
+bool hidEnqueueReportX(USBHIDDriver *uhdp, const uint8_t *report) {
+  hidreportfifo_t *fp = &uhdp->fifo;
+  const size_t size = uhdp->config->report_size;
+  uint32_t head;
+
+  osalDbgCheck(size > 0U);
+
+#if HID_FIFO_LOCK_FREE == TRUE
+  head = __atomic_load_n(&fp->head, __ATOMIC_RELAXED);
+  do {
+    if (head - __atomic_load_n(&fp->tail, __ATOMIC_ACQUIRE) >=
+        USB_HID_REPORT_FIFO_LENGTH) {
+      fifo_count_dropped(fp, 1U);
+      return false;
+    }
+  } while (!__atomic_compare_exchange_n(&fp->head, &head, head + 1U, true,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+#else
+  syssts_t sts = osalSysGetStatusAndLockX();
+  head = fp->head;
+  if (head - fp->tail >= USB_HID_REPORT_FIFO_LENGTH) {
+    fifo_count_dropped(fp, 1U);
+    osalSysRestoreStatusX(sts);
+    return false;
+  }
+  fp->head = head + 1U;
+  osalSysRestoreStatusX(sts);
+#endif
+
+  memcpy(&fp->buf[(head & HID_FIFO_MASK) * size], report, size);
+  __atomic_store_n(&fp->seq[head & HID_FIFO_MASK], head + 1U,
+                   __ATOMIC_RELEASE);
+
+  return true;
+}
+
+/**
+ * @brief   Enqueues a report in the FIFO and starts the transmission.
+ *
+ * @param[in] uhdp      pointer to the @p USBHIDDriver object
+ * @param[in] report    report data, @p report_size bytes
+ * @return              The operation status.
+ * @retval true         report enqueued.
+ * @retval false        FIFO full, the report is dropped.
+ *
+ * @iclass
+ */
+bool hidEnqueueReportI(USBHIDDriver *uhdp, const uint8_t *report) {
+  bool ret;
+
+  osalDbgCheckClassI();
+
+  ret = hidEnqueueReportX(uhdp, report);
+  fifo_start_i(uhdp);
+
+  return ret;
+}
+
+/**
+ * @brief   Starts the transmission of the enqueued reports.
+ * @details To be called periodically, e.g. from the SOF callback, when the
+ *          reports are enqueued by @p hidEnqueueReportX().
+ *
+ * @param[in] uhdp      pointer to the @p USBHIDDriver object
+ *
+ * @iclass
+ */
+void hidFlushReportsI(USBHIDDriver *uhdp) {
+
+  osalDbgCheckClassI();
+
+  fifo_start_i(uhdp);
+}
+
+/**
+ * @brief   Returns the report FIFO statistics.
+ *
+ * @param[in] uhdp      pointer to the @p USBHIDDriver object
+ * @param[out] statsp   pointer to the @p hidfifostats_t object
+ *
+ * @api
+ */
+void hidGetReportFifoStats(USBHIDDriver *uhdp, hidfifostats_t *statsp) {
+
+  osalDbgCheck((uhdp != NULL) && (statsp != NULL));
+
+  osalSysLock();
+  *statsp = uhdp->fifo.stats;
+  statsp->dropped = __atomic_load_n(&uhdp->fifo.stats.dropped,
+                                    __ATOMIC_RELAXED);
+  osalSysUnlock();
+}
+#endif /* USB_HID_USE_REPORT_FIFO == TRUE */
+
 #endif /* HAL_USE_USB_HID == TRUE */
 
 /** @} */
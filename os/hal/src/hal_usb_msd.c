@@ -132,6 +132,7 @@ static bool cbw_valid(const msd_cbw_t *cbw, msg_t recvd) {
  *          • and both bCBWCBLength and the content of the CBWCB are in
  *            accordance with bInterfaceSubClass.
  *
+ * @param[in] msdp      pointer to the @p USBMassStorageDriver object
  * @param[in] cbw       pointer to the @p msd_cbw_t object
  *
  * @return              Operation status.
@@ -140,10 +141,12 @@ static bool cbw_valid(const msd_cbw_t *cbw, msg_t recvd) {
  *
  * @notapi
  */
-static bool cbw_meaningful(const msd_cbw_t *cbw) {
+static bool cbw_meaningful(const USBMassStorageDriver *msdp,
+                           const msd_cbw_t *cbw) {
   if (((cbw->cmd_len & CBW_CMD_LEN_RESERVED_MASK) != 0)
       || ((cbw->flags & CBW_FLAGS_RESERVED_MASK) != 0)
-      || (cbw->lun != 0)) {
+      || ((cbw->lun & CBW_LUN_RESERVED_MASK) != 0)
+      || (cbw->lun > msdp->max_lun)) {
     return false;
   }
   else {
@@ -151,6 +154,32 @@ static bool cbw_meaningful(const msd_cbw_t *cbw) {
   }
 }
 
+/**
+ * @brief   Waits for the end of the transmission on an endpoint.
+ * @details The CSW is sent asynchronously, it may still be in flight when
+ *          the data phase of the next command begins.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       the endpoint is idle.
+ * @retval MSG_RESET    the transmission was aborted.
+ *
+ * @notapi
+ */
+static msg_t wait_transmit_idle(USBDriver *usbp, usbep_t ep) {
+  msg_t msg = MSG_OK;
+
+  osalSysLock();
+  if (usbGetTransmitStatusI(usbp, ep)) {
+    msg = osalThreadSuspendS(&usbp->epc[ep]->in_state->thread);
+  }
+  osalSysUnlock();
+
+  return msg;
+}
+
 /**
  * @brief   SCSI transport transmit function.
  *
@@ -166,7 +195,9 @@ static uint32_t scsi_transport_transmit(const SCSITransport *transport,
                                         const uint8_t *data, size_t len) {
 
   usb_scsi_transport_handler_t *trp = transport->handler;
-  msg_t status = usbTransmit(trp->usbp, trp->ep, data, len);
+  msg_t status = wait_transmit_idle(trp->usbp, trp->ep);
+  if (MSG_OK == status)
+    status = usbTransmit(trp->usbp, trp->ep, data, len);
   if (MSG_OK == status)
     return len;
   else
@@ -196,7 +227,9 @@ static uint32_t scsi_transport_receive(const SCSITransport *transport,
 }
 
 /**
- * @brief   Fills and sends CSW message.
+ * @brief   Fills the CSW message.
+ * @details The CSW is sent by the worker together with the reception of
+ *          the next CBW.
  *
  * @param[in] msdp      pointer to the @p USBMassStorageDriver object
  * @param[in] status    status returned by SCSI layer
@@ -204,20 +237,63 @@ static uint32_t scsi_transport_receive(const SCSITransport *transport,
  *
  * @notapi
  */
-static void send_csw(USBMassStorageDriver *msdp, uint8_t status,
-                     uint32_t residue) {
+static void prepare_csw(USBMassStorageDriver *msdp, uint8_t status,
+                        uint32_t residue) {
 
   msdp->csw.signature = MSD_CSW_SIGNATURE;
   msdp->csw.data_residue = residue;
   msdp->csw.tag = msdp->cbw.tag;
   msdp->csw.status = status;
+}
 
-  usbTransmit(msdp->usbp, USB_MSD_DATA_EP, (uint8_t *)&msdp->csw,
-      sizeof(msd_csw_t));
+#if (USB_MSD_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Accounts the latency of a command.
+ *
+ * @param[in] msdp      pointer to the @p USBMassStorageDriver object
+ * @param[in] opcode    SCSI operation code of the command
+ * @param[in] failed    @p true if the command failed
+ * @param[in] latency   latency in @p msdTimeFrequency() ticks
+ *
+ * @notapi
+ */
+static void stats_account(USBMassStorageDriver *msdp, uint8_t opcode,
+                          bool failed, uint32_t latency) {
+  usb_msd_latency_t *lp;
+  unsigned bucket = 0;
+  uint32_t v;
+
+  if (SCSI_CMD_READ_10 == opcode)
+    lp = &msdp->stats.cmd[USB_MSD_CMD_READ];
+  else if (SCSI_CMD_WRITE_10 == opcode)
+    lp = &msdp->stats.cmd[USB_MSD_CMD_WRITE];
+  else
+    lp = &msdp->stats.cmd[USB_MSD_CMD_OTHER];
+
+  for (v = latency >> 1; (v != 0U) && (bucket < USB_MSD_LATENCY_BUCKETS - 1U);
+       v >>= 1)
+    bucket++;
+
+  osalSysLock();
+  if ((lp->count == 0U) || (latency < lp->min))
+    lp->min = latency;
+  if (latency > lp->max)
+    lp->max = latency;
+  lp->count++;
+  if (failed)
+    lp->failed++;
+  lp->total += latency;
+  lp->histogram[bucket]++;
+  osalSysUnlock();
 }
+#endif
 
 /**
  * @brief   Mass storage worker thread.
+ * @details The transmission of the CSW and the reception of the next CBW
+ *          are started together, the OUT endpoint is armed again while the
+ *          CSW is still in flight so that the next CBW is not NAKed while
+ *          the worker is rescheduled.
  *
  * @param[in] arg     pointer to the @p USBMassStorageDriver object
  *
@@ -225,24 +301,60 @@ static void send_csw(USBMassStorageDriver *msdp, uint8_t status,
  */
 static THD_FUNCTION(usb_msd_worker, arg) {
   USBMassStorageDriver *msdp = arg;
+  USBDriver *usbp = msdp->usbp;
+  bool csw_ready = false;
   chRegSetThreadName("usb_msd_worker");
 
   while(! chThdShouldTerminateX()) {
-    const msg_t status = usbReceive(msdp->usbp, USB_MSD_DATA_EP,
-                                   (uint8_t *)&msdp->cbw, sizeof(msd_cbw_t));
+    msg_t status;
+
+    /* CSW of the previous command and CBW of the next one.*/
+    osalSysLock();
+    if (usbGetDriverStateI(usbp) != USB_ACTIVE) {
+      status = MSG_RESET;
+    }
+    else {
+      if (csw_ready) {
+        usbStartTransmitI(usbp, USB_MSD_DATA_EP, (uint8_t *)&msdp->csw,
+                          sizeof(msd_csw_t));
+      }
+      usbStartReceiveI(usbp, USB_MSD_DATA_EP, (uint8_t *)&msdp->cbw,
+                       sizeof(msd_cbw_t));
+      status = osalThreadSuspendS(&usbp->epc[USB_MSD_DATA_EP]->out_state->thread);
+    }
+    osalSysUnlock();
+    csw_ready = false;
+
     if (MSG_RESET == status) {
+#if USB_MSD_USE_STATISTICS == TRUE
+      msdp->stats.resets++;
+#endif
       osalThreadSleepMilliseconds(50);
     }
-    else if (cbw_valid(&msdp->cbw, status) && cbw_meaningful(&msdp->cbw)) {
-      if (SCSI_SUCCESS == scsiExecCmd(&msdp->scsi_target, msdp->cbw.cmd_data)) {
-        send_csw(msdp, CSW_STATUS_PASSED, 0);
+    else if (cbw_valid(&msdp->cbw, status) && cbw_meaningful(msdp, &msdp->cbw)) {
+      SCSITarget *scsip = &msdp->luns[msdp->cbw.lun].scsi_target;
+#if USB_MSD_USE_STATISTICS == TRUE
+      const msdtime_t start = msd_time_now();
+#endif
+      const bool failed = (SCSI_SUCCESS != scsiExecCmd(scsip, msdp->cbw.cmd_data));
+
+      if (!failed) {
+        prepare_csw(msdp, CSW_STATUS_PASSED, 0);
       }
       else {
-        send_csw(msdp, CSW_STATUS_FAILED, scsiResidue(&msdp->scsi_target));
+        prepare_csw(msdp, CSW_STATUS_FAILED, scsiResidue(scsip));
       }
+      csw_ready = true;
+#if USB_MSD_USE_STATISTICS == TRUE
+      stats_account(msdp, msdp->cbw.cmd_data[0], failed,
+                    (uint32_t)(msdtime_t)(msd_time_now() - start));
+#endif
     }
     else {
-      ; /* do NOT send CSW here. Incorrect CBW must be silently ignored */
+      /* do NOT send CSW here. Incorrect CBW must be silently ignored */
+#if USB_MSD_USE_STATISTICS == TRUE
+      msdp->stats.invalid_cbw++;
+#endif
     }
   }
 
@@ -261,8 +373,10 @@ static THD_FUNCTION(usb_msd_worker, arg) {
  * @notapi
  */
 bool msd_request_hook(USBDriver *usbp) {
-  /* check that the request is for interface 0.*/
-  if (MSD_SETUP_INDEX(usbp->setup) != 0)
+  USBMassStorageDriver *msdp = usbp->in_params[USB_MSD_DATA_EP - 1U];
+
+  /* check that the request is for interface 0 of a started driver.*/
+  if ((MSD_SETUP_INDEX(usbp->setup) != 0) || (msdp == NULL))
     return false;
 
   if (usbp->setup[0] == (USB_RTYPE_TYPE_CLASS | USB_RTYPE_RECIPIENT_INTERFACE | USB_RTYPE_DIR_HOST2DEV)
@@ -282,8 +396,7 @@ bool msd_request_hook(USBDriver *usbp) {
   } else if (usbp->setup[0] == (USB_RTYPE_TYPE_CLASS | USB_RTYPE_RECIPIENT_INTERFACE | USB_RTYPE_DIR_DEV2HOST)
     && usbp->setup[1] == MSD_REQ_GET_MAX_LUN) {
     /* Return the maximum supported LUN. */
-    static uint8_t zero = 0;
-    usbSetupTransfer(usbp, &zero, 1, NULL);
+    usbSetupTransfer(usbp, &msdp->max_lun, 1, NULL);
     return true;
     /* OR */
     /* Return false to stall to indicate that we don't support LUN */
@@ -306,8 +419,64 @@ void msdObjectInit(USBMassStorageDriver *msdp) {
   msdp->state = USB_MSD_STOP;
   msdp->usbp = NULL;
   msdp->worker = NULL;
+  msdp->max_lun = 0;
+
+  for (unsigned i = 0; i < USB_MSD_MAX_LUNS; i++) {
+    msdp->luns[i].scsi_config.blkdev = NULL;
+    scsiObjectInit(&msdp->luns[i].scsi_target);
+  }
+
+#if USB_MSD_USE_STATISTICS == TRUE
+  memset(&msdp->stats, 0, sizeof(msdp->stats));
+#endif
+}
+
+/**
+ * @brief   Configures a logical unit.
+ * @details Logical unit 0 is configured by @p msdStart(), the others must
+ *          be configured before it. Units must be numbered contiguously.
+ * @note    The same @p blkbuf can be shared by all the units, the commands
+ *          are executed one at a time.
+ *
+ * @param[in] msdp      pointer to the @p USBMassStorageDriver object
+ * @param[in] lun       logical unit number
+ * @param[in] blkdev    pointer to the @p BaseBlockDevice object
+ * @param[in] blkbuf    pointer to the working area buffer, must be allocated
+ *                      by user, must be big enough to store 1 data block
+ * @param[in] inquiry   pointer to the SCSI inquiry response structure,
+ *                      set it to @p NULL to use default hardcoded value.
+ * @param[in] serialInquiry pointer to the SCSI unit serial number inquiry
+ *                      response structure, set it to @p NULL to use default
+ *                      hardcoded value.
+ *
+ * @api
+ */
+void msdSetLun(USBMassStorageDriver *msdp, uint8_t lun,
+               BaseBlockDevice *blkdev, uint8_t *blkbuf,
+               const scsi_inquiry_response_t *inquiry,
+               const scsi_unit_serial_number_inquiry_response_t *serialInquiry) {
+  SCSITargetConfig *cfgp;
+
+  osalDbgCheck((msdp != NULL) && (lun < USB_MSD_MAX_LUNS)
+              && (blkdev != NULL) && (blkbuf != NULL));
+  osalDbgAssert((msdp->state == USB_MSD_STOP), "invalid state");
 
-  scsiObjectInit(&msdp->scsi_target);
+  cfgp = &msdp->luns[lun].scsi_config;
+  if (NULL == inquiry) {
+    cfgp->inquiry_response = &default_scsi_inquiry_response;
+  }
+  else {
+    cfgp->inquiry_response = inquiry;
+  }
+  if (NULL == serialInquiry) {
+    cfgp->unit_serial_number_inquiry_response = &default_scsi_unit_serial_number_inquiry_response;
+  }
+  else {
+    cfgp->unit_serial_number_inquiry_response = serialInquiry;
+  }
+  cfgp->blkbuf = blkbuf;
+  cfgp->blkdev = blkdev;
+  cfgp->transport = &msdp->scsi_transport;
 }
 
 /**
@@ -325,7 +494,12 @@ void msdStop(USBMassStorageDriver *msdp) {
   chThdTerminate(msdp->worker);
   chThdWait(msdp->worker);
 
-  scsiStop(&msdp->scsi_target);
+  for (unsigned i = 0; i <= msdp->max_lun; i++) {
+    scsiStop(&msdp->luns[i].scsi_target);
+  }
+
+  msdp->usbp->in_params[USB_MSD_DATA_EP - 1U]  = NULL;
+  msdp->usbp->out_params[USB_MSD_DATA_EP - 1U] = NULL;
 
   msdp->worker = NULL;
   msdp->state = USB_MSD_STOP;
@@ -334,6 +508,8 @@ void msdStop(USBMassStorageDriver *msdp) {
 
 /**
  * @brief   Configures and activates the USB mass storage driver.
+ * @details The parameters configure logical unit 0, the other units are
+ *          configured by @p msdSetLun() beforehand.
  *
  * @param[in] msdp      pointer to the @p USBMassStorageDriver object
  * @param[in] usbp      pointer to the @p USBDriver object
@@ -349,6 +525,7 @@ void msdStart(USBMassStorageDriver *msdp, USBDriver *usbp,
               BaseBlockDevice *blkdev, uint8_t *blkbuf,
               const scsi_inquiry_response_t *inquiry,
               const scsi_unit_serial_number_inquiry_response_t *serialInquiry) {
+  unsigned i;
 
   osalDbgCheck((msdp != NULL) && (usbp != NULL)
               && (blkdev != NULL) && (blkbuf != NULL));
@@ -356,35 +533,71 @@ void msdStart(USBMassStorageDriver *msdp, USBDriver *usbp,
 
   msdp->usbp = usbp;
 
+  /* Driver instance bound to the endpoint, the request hook gets it
+     from there.*/
+  usbp->in_params[USB_MSD_DATA_EP - 1U]  = msdp;
+  usbp->out_params[USB_MSD_DATA_EP - 1U] = msdp;
+
   msdp->usb_scsi_transport_handler.usbp = msdp->usbp;
   msdp->usb_scsi_transport_handler.ep   = USB_MSD_DATA_EP;
   msdp->scsi_transport.handler  = &msdp->usb_scsi_transport_handler;
   msdp->scsi_transport.transmit = scsi_transport_transmit;
   msdp->scsi_transport.receive  = scsi_transport_receive;
 
-  if (NULL == inquiry) {
-    msdp->scsi_config.inquiry_response = &default_scsi_inquiry_response;
-  }
-  else {
-    msdp->scsi_config.inquiry_response = inquiry;
-  }
-  if (NULL == serialInquiry) {
-    msdp->scsi_config.unit_serial_number_inquiry_response = &default_scsi_unit_serial_number_inquiry_response;
+  msdSetLun(msdp, 0, blkdev, blkbuf, inquiry, serialInquiry);
+
+  for (i = 0; (i < USB_MSD_MAX_LUNS)
+              && (msdp->luns[i].scsi_config.blkdev != NULL); i++) {
+    scsiStart(&msdp->luns[i].scsi_target, &msdp->luns[i].scsi_config);
   }
-  else {
-    msdp->scsi_config.unit_serial_number_inquiry_response = serialInquiry;
+  msdp->max_lun = (uint8_t)(i - 1U);
+#if USB_MSD_MAX_LUNS > 1
+  for (; i < USB_MSD_MAX_LUNS; i++) {
+    osalDbgAssert(msdp->luns[i].scsi_config.blkdev == NULL,
+                  "logical units not contiguous");
   }
-  msdp->scsi_config.blkbuf = blkbuf;
-  msdp->scsi_config.blkdev = blkdev;
-  msdp->scsi_config.transport = &msdp->scsi_transport;
-
-  scsiStart(&msdp->scsi_target, &msdp->scsi_config);
+#endif
 
   msdp->state = USB_MSD_READY;
   msdp->worker = chThdCreateStatic(msdp->waMSDWorker, sizeof(msdp->waMSDWorker),
                                    MSD_THD_PRIO, usb_msd_worker, msdp);
 }
 
+#if (USB_MSD_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a snapshot of the statistics.
+ *
+ * @param[in] msdp      pointer to the @p USBMassStorageDriver object
+ * @param[out] statsp   pointer to the @p usb_msd_stats_t object
+ *
+ * @api
+ */
+void msdGetStats(USBMassStorageDriver *msdp, usb_msd_stats_t *statsp) {
+
+  osalDbgCheck((msdp != NULL) && (statsp != NULL));
+
+  osalSysLock();
+  *statsp = msdp->stats;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Clears the statistics.
+ *
+ * @param[in] msdp      pointer to the @p USBMassStorageDriver object
+ *
+ * @api
+ */
+void msdResetStats(USBMassStorageDriver *msdp) {
+
+  osalDbgCheck(msdp != NULL);
+
+  osalSysLock();
+  memset(&msdp->stats, 0, sizeof(msdp->stats));
+  osalSysUnlock();
+}
+#endif /* USB_MSD_USE_STATISTICS == TRUE */
+
 #endif /* HAL_USE_USB_MSD */
 
 /** @} */
@@ -0,0 +1,775 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_usb_uas.c
+ * @brief   USB Attached SCSI device code.
+ *
+ * @addtogroup usb_uas
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_USB_UAS == TRUE) || defined(__DOXYGEN__)
+
+#include <string.h>
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define UAS_TASK_ATTR_MASK              0x07
+#define UAS_TASK_SIMPLE                 0x00
+#define UAS_TASK_HEAD_OF_QUEUE          0x01
+#define UAS_TASK_ORDERED                0x02
+
+#define UAS_TMF_ABORT_TASK              0x01
+#define UAS_TMF_ABORT_TASK_SET          0x02
+#define UAS_TMF_CLEAR_TASK_SET          0x04
+#define UAS_TMF_LOGICAL_UNIT_RESET      0x08
+#define UAS_TMF_IT_NEXUS_RESET          0x10
+#define UAS_TMF_QUERY_TASK              0x80
+
+#define UAS_RC_TMF_COMPLETE             0x00
+#define UAS_RC_INVALID_IU               0x02
+#define UAS_RC_TMF_NOT_SUPPORTED        0x04
+#define UAS_RC_TMF_SUCCEEDED            0x08
+#define UAS_RC_INCORRECT_LUN            0x09
+
+#define UAS_TM_IU_SIZE                  16U
+#define UAS_RESPONSE_IU_SIZE            8U
+#define UAS_SENSE_IU_SIZE               16U
+#define UAS_READY_IU_SIZE               4U
+
+#define UAS_CMD_CDB_OFFSET              16U
+
+#define SCSI_STATUS_GOOD                0x00
+#define SCSI_STATUS_CHECK_CONDITION     0x02
+
+#define UAS_IU_TAG(iu)  (uint16_t)(((uint16_t)(iu)[2] << 8) | (iu)[3])
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Default SCSI inquiry response structure.
+ */
+static const scsi_inquiry_response_t default_scsi_inquiry_response = {
+    0x00,           /* direct access block device     */
+    0x80,           /* removable                      */
+    0x06,           /* SPC-4                          */
+    0x02,           /* response data format           */
+    0x20,           /* response has 0x20 + 4 bytes    */
+    0x00,
+    0x00,
+    0x02,           /* command queuing                */
+    "Chibios",
+    "UAS Storage",
+    {'v',CH_KERNEL_MAJOR+'0','.',CH_KERNEL_MINOR+'0'}
+};
+
+/**
+ * @brief   Default SCSI unit serial number inquiry response structure.
+ */
+static const scsi_unit_serial_number_inquiry_response_t default_scsi_unit_serial_number_inquiry_response = {
+    0x00,
+    0x80,
+    0x00,
+    0x08,
+    "00000000"
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Decodes the LUN field of an IU.
+ * @details Only single level LUNs with peripheral device addressing are
+ *          supported.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ * @param[in] iu        command or task management IU
+ *
+ * @return              The logical unit number.
+ * @retval -1           invalid or not configured unit.
+ *
+ * @notapi
+ */
+static int iu_lun(const USBUASDriver *uasp, const uint8_t *iu) {
+  unsigned i;
+
+  if (iu[8] != 0U)
+    return -1;
+  for (i = 10U; i < 16U; i++) {
+    if (iu[i] != 0U)
+      return -1;
+  }
+  if (iu[9] >= uasp->num_luns)
+    return -1;
+
+  return (int)iu[9];
+}
+
+/**
+ * @brief   Arms the command pipe on a free slot.
+ * @details The pipe stays idle, and is NAKed, while all the slots are busy.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ *
+ * @iclass
+ */
+static void start_command_pipe_i(USBUASDriver *uasp) {
+  unsigned i;
+
+  if (!uasp->configured || (uasp->receiving != NULL))
+    return;
+
+  for (i = 0; i < USB_UAS_MAX_COMMANDS; i++) {
+    usb_uas_cmd_t *cmdp = &uasp->cmds[i];
+    if (cmdp->state == UAS_CMD_FREE) {
+      cmdp->state = UAS_CMD_RECEIVING;
+      uasp->receiving = cmdp;
+      usbStartReceiveI(uasp->config->usbp, uasp->config->cmd_out,
+                       cmdp->iu, UAS_IU_SIZE);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief   Drops the queued commands.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ * @param[in] lun       logical unit, -1 for all of them
+ * @param[in] tag       tag of the command, -1 for all of them
+ *
+ * @return              Number of dropped commands.
+ *
+ * @iclass
+ */
+static unsigned drop_commands_i(USBUASDriver *uasp, int lun, int tag) {
+  unsigned i, n = 0;
+
+  for (i = 0; i < USB_UAS_MAX_COMMANDS; i++) {
+    usb_uas_cmd_t *cmdp = &uasp->cmds[i];
+    if ((cmdp->state != UAS_CMD_QUEUED) || (cmdp->iu[0] != UAS_IU_COMMAND))
+      continue;
+    if ((lun >= 0) && (iu_lun(uasp, cmdp->iu) != lun))
+      continue;
+    if ((tag >= 0) && (UAS_IU_TAG(cmdp->iu) != (uint16_t)tag))
+      continue;
+    cmdp->state = UAS_CMD_FREE;
+    n++;
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Selects the next command to be executed.
+ * @details Task management IUs and HEAD OF QUEUE commands go first, then
+ *          the commands not accessing the medium, then the media accesses
+ *          in ascending block order from the last accessed block of their
+ *          unit. ORDERED commands are barriers, a command overtaken
+ *          @p USB_UAS_MAX_BYPASS times is not overtaken anymore.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ *
+ * @return              The selected command.
+ * @retval NULL         nothing is queued.
+ *
+ * @iclass
+ */
+static usb_uas_cmd_t *select_command_i(USBUASDriver *uasp) {
+  usb_uas_cmd_t *oldest = NULL, *barrier = NULL, *best = NULL;
+  uint32_t best_cost = 0;
+  unsigned i;
+
+  for (i = 0; i < USB_UAS_MAX_COMMANDS; i++) {
+    usb_uas_cmd_t *cmdp = &uasp->cmds[i];
+    uint8_t attr;
+
+    if (cmdp->state != UAS_CMD_QUEUED)
+      continue;
+    if (cmdp->iu[0] != UAS_IU_COMMAND)
+      return cmdp;
+    attr = cmdp->iu[4] & UAS_TASK_ATTR_MASK;
+    if (attr == UAS_TASK_HEAD_OF_QUEUE)
+      return cmdp;
+    if ((oldest == NULL) || ((int32_t)(cmdp->seq - oldest->seq) < 0))
+      oldest = cmdp;
+    if ((attr == UAS_TASK_ORDERED)
+        && ((barrier == NULL) || ((int32_t)(cmdp->seq - barrier->seq) < 0)))
+      barrier = cmdp;
+  }
+
+  if ((oldest == NULL) || (oldest == barrier)
+      || (oldest->bypassed >= USB_UAS_MAX_BYPASS))
+    return oldest;
+
+  for (i = 0; i < USB_UAS_MAX_COMMANDS; i++) {
+    usb_uas_cmd_t *cmdp = &uasp->cmds[i];
+    uint32_t cost, lba, blocks;
+    int lun;
+
+    if ((cmdp->state != UAS_CMD_QUEUED)
+        || ((barrier != NULL) && ((int32_t)(cmdp->seq - barrier->seq) >= 0)))
+      continue;
+
+    lun = iu_lun(uasp, cmdp->iu);
+    if ((lun < 0) || !scsiGetDataRequest(&cmdp->iu[UAS_CMD_CDB_OFFSET],
+                                         &lba, &blocks)) {
+      cost = 0;
+    }
+    else {
+      /* Distance in the ascending direction, wrapping around.*/
+      cost = 1U + (lba - uasp->luns[lun].next_lba);
+      if (cost == 0U)
+        cost--;
+    }
+    if ((best == NULL) || (cost < best_cost)
+        || ((cost == best_cost) && ((int32_t)(cmdp->seq - best->seq) < 0))) {
+      best = cmdp;
+      best_cost = cost;
+    }
+  }
+
+  /* Accounts the older commands being overtaken.*/
+  for (i = 0; i < USB_UAS_MAX_COMMANDS; i++) {
+    usb_uas_cmd_t *cmdp = &uasp->cmds[i];
+    if ((cmdp->state == UAS_CMD_QUEUED)
+        && ((int32_t)(cmdp->seq - best->seq) < 0))
+      cmdp->bypassed++;
+  }
+
+  return best;
+}
+
+/**
+ * @brief   Sends the IU prepared in @p status_iu on the status pipe.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ * @param[in] cmdp      command the IU refers to
+ * @param[in] id        IU identifier
+ * @param[in] n         IU size
+ *
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static msg_t send_status(USBUASDriver *uasp, const usb_uas_cmd_t *cmdp,
+                         uint8_t id, size_t n) {
+
+  uasp->status_iu[0] = id;
+  uasp->status_iu[1] = 0;
+  uasp->status_iu[2] = cmdp->iu[2];
+  uasp->status_iu[3] = cmdp->iu[3];
+
+  return usbTransmit(uasp->config->usbp, uasp->config->status_in,
+                     uasp->status_iu, n);
+}
+
+/**
+ * @brief   Sends a response IU.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ * @param[in] cmdp      command or task management IU
+ * @param[in] code      response code
+ *
+ * @notapi
+ */
+static void send_response(USBUASDriver *uasp, const usb_uas_cmd_t *cmdp,
+                          uint8_t code) {
+
+  memset(&uasp->status_iu[4], 0, 3);
+  uasp->status_iu[7] = code;
+  (void) send_status(uasp, cmdp, UAS_IU_RESPONSE, UAS_RESPONSE_IU_SIZE);
+}
+
+/**
+ * @brief   Sends a sense IU.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ * @param[in] cmdp      command
+ * @param[in] sense     sense data, @p NULL for the GOOD status
+ *
+ * @notapi
+ */
+static void send_sense(USBUASDriver *uasp, const usb_uas_cmd_t *cmdp,
+                       const scsi_sense_response_t *sense) {
+  size_t n = 0;
+
+  memset(&uasp->status_iu[4], 0, UAS_SENSE_IU_SIZE - 4U);
+  if (sense != NULL) {
+    n = sizeof(scsi_sense_response_t);
+    uasp->status_iu[6] = SCSI_STATUS_CHECK_CONDITION;
+    uasp->status_iu[15] = (uint8_t)n;
+    memcpy(&uasp->status_iu[UAS_SENSE_IU_SIZE], sense, n);
+  }
+  else {
+    uasp->status_iu[6] = SCSI_STATUS_GOOD;
+  }
+  (void) send_status(uasp, cmdp, UAS_IU_SENSE, UAS_SENSE_IU_SIZE + n);
+}
+
+/**
+ * @brief   Announces the data phase of the current command.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ * @param[in] id        @p UAS_IU_READ_READY or @p UAS_IU_WRITE_READY
+ *
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static msg_t send_ready(USBUASDriver *uasp, uint8_t id) {
+  usb_uas_cmd_t *cmdp = uasp->current;
+  msg_t msg = MSG_OK;
+
+  if (!cmdp->ready) {
+    msg = send_status(uasp, cmdp, id, UAS_READY_IU_SIZE);
+    cmdp->ready = true;
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   SCSI transport transmit function.
+ *
+ * @param[in] transport pointer to the @p SCSITransport object
+ * @param[in] data      payload
+ * @param[in] len       number of bytes to be transmitted
+ *
+ * @return              Number of successfully transmitted bytes.
+ *
+ * @notapi
+ */
+static uint32_t scsi_transport_transmit(const SCSITransport *transport,
+                                        const uint8_t *data, size_t len) {
+
+  USBUASDriver *uasp = transport->handler;
+  msg_t status = send_ready(uasp, UAS_IU_READ_READY);
+  if (MSG_OK == status)
+    status = usbTransmit(uasp->config->usbp, uasp->config->data_in, data, len);
+  if (MSG_OK == status)
+    return len;
+  else
+    return 0;
+}
+
+/**
+ * @brief   SCSI transport receive function.
+ *
+ * @param[in] transport pointer to the @p SCSITransport object
+ * @param[in] data      payload
+ * @param[in] len       number bytes to be received
+ *
+ * @return              Number of successfully received bytes.
+ *
+ * @notapi
+ */
+static uint32_t scsi_transport_receive(const SCSITransport *transport,
+                                       uint8_t *data, size_t len) {
+
+  USBUASDriver *uasp = transport->handler;
+  msg_t status = send_ready(uasp, UAS_IU_WRITE_READY);
+  if (MSG_OK == status)
+    status = usbReceive(uasp->config->usbp, uasp->config->data_out, data, len);
+  if (MSG_RESET != status)
+    return len;
+  else
+    return 0;
+}
+
+/**
+ * @brief   REPORT LUNS command handler.
+ * @details Handled here as the SCSI targets only know their own unit, the
+ *          list is built in the block buffer of unit 0.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ * @param[in] cmd       pointer to SCSI command data
+ *
+ * @notapi
+ */
+static void report_luns(USBUASDriver *uasp, const uint8_t *cmd) {
+  uint8_t *buf = uasp->luns[0].scsi_config.blkbuf;
+  uint32_t alloc = ((uint32_t)cmd[6] << 24) | ((uint32_t)cmd[7] << 16) |
+                   ((uint32_t)cmd[8] << 8) | cmd[9];
+  uint32_t len = 8U * uasp->num_luns;
+  uint32_t n = 8U + len;
+  unsigned i;
+
+  /* LUN list length, big endian.*/
+  memset(buf, 0, n);
+  buf[0] = (uint8_t)(len >> 24);
+  buf[1] = (uint8_t)(len >> 16);
+  buf[2] = (uint8_t)(len >> 8);
+  buf[3] = (uint8_t)len;
+  for (i = 0; i < uasp->num_luns; i++) {
+    buf[8U + 8U * i + 1U] = (uint8_t)i;
+  }
+
+  (void) uasp->scsi_transport.transmit(&uasp->scsi_transport, buf,
+                                       (alloc < n) ? alloc : n);
+}
+
+/**
+ * @brief   Executes a command IU.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ * @param[in] cmdp      command
+ *
+ * @notapi
+ */
+static void execute_command(USBUASDriver *uasp, usb_uas_cmd_t *cmdp) {
+  const uint8_t *cdb = &cmdp->iu[UAS_CMD_CDB_OFFSET];
+  const int lun = iu_lun(uasp, cmdp->iu);
+  uint32_t lba, blocks;
+  SCSITarget *scsip;
+  bool failed;
+
+  if ((cmdp->size < UAS_IU_SIZE) || ((cmdp->iu[6] & 0xFC) != 0)) {
+    send_response(uasp, cmdp, UAS_RC_INVALID_IU);
+    return;
+  }
+  if (lun < 0) {
+    send_response(uasp, cmdp, UAS_RC_INCORRECT_LUN);
+    return;
+  }
+
+  uasp->current = cmdp;
+  if (cdb[0] == SCSI_CMD_REPORT_LUNS) {
+    report_luns(uasp, cdb);
+    send_sense(uasp, cmdp, NULL);
+  }
+  else {
+    scsip = &uasp->luns[lun].scsi_target;
+    failed = (SCSI_SUCCESS != scsiExecCmd(scsip, cdb));
+    if (scsiGetDataRequest(cdb, &lba, &blocks))
+      uasp->luns[lun].next_lba = lba + blocks;
+    send_sense(uasp, cmdp, failed ? &scsip->sense : NULL);
+  }
+  uasp->current = NULL;
+}
+
+/**
+ * @brief   Executes a task management IU.
+ * @details The queued commands are aborted, the running command is left
+ *          to complete.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ * @param[in] cmdp      task management IU
+ *
+ * @notapi
+ */
+static void execute_task_management(USBUASDriver *uasp, usb_uas_cmd_t *cmdp) {
+  const int lun = iu_lun(uasp, cmdp->iu);
+  const int tag = ((int)cmdp->iu[6] << 8) | cmdp->iu[7];
+  uint8_t code = UAS_RC_TMF_COMPLETE;
+  unsigned i;
+
+  if (cmdp->size < UAS_TM_IU_SIZE) {
+    send_response(uasp, cmdp, UAS_RC_INVALID_IU);
+    return;
+  }
+  if (lun < 0) {
+    send_response(uasp, cmdp, UAS_RC_INCORRECT_LUN);
+    return;
+  }
+
+  osalSysLock();
+  switch (cmdp->iu[4]) {
+  case UAS_TMF_ABORT_TASK:
+    (void) drop_commands_i(uasp, lun, tag);
+    break;
+  case UAS_TMF_ABORT_TASK_SET:
+  case UAS_TMF_CLEAR_TASK_SET:
+  case UAS_TMF_LOGICAL_UNIT_RESET:
+    (void) drop_commands_i(uasp, lun, -1);
+    break;
+  case UAS_TMF_IT_NEXUS_RESET:
+    (void) drop_commands_i(uasp, -1, -1);
+    break;
+  case UAS_TMF_QUERY_TASK:
+    for (i = 0; i < USB_UAS_MAX_COMMANDS; i++) {
+      usb_uas_cmd_t *p = &uasp->cmds[i];
+      if ((p != cmdp) && (p->iu[0] == UAS_IU_COMMAND)
+          && ((p->state == UAS_CMD_QUEUED) || (p->state == UAS_CMD_RUNNING))
+          && (UAS_IU_TAG(p->iu) == (uint16_t)tag)
+          && (iu_lun(uasp, p->iu) == lun))
+        code = UAS_RC_TMF_SUCCEEDED;
+    }
+    break;
+  default:
+    code = UAS_RC_TMF_NOT_SUPPORTED;
+    break;
+  }
+  start_command_pipe_i(uasp);
+  osalSysUnlock();
+
+  send_response(uasp, cmdp, code);
+}
+
+/**
+ * @brief   UAS worker thread.
+ *
+ * @param[in] arg     pointer to the @p USBUASDriver object
+ *
+ * @notapi
+ */
+static THD_FUNCTION(usb_uas_worker, arg) {
+  USBUASDriver *uasp = arg;
+  chRegSetThreadName("usb_uas_worker");
+
+  while (true) {
+    usb_uas_cmd_t *cmdp;
+
+    osalSysLock();
+    while (((cmdp = select_command_i(uasp)) == NULL)
+           && !chThdShouldTerminateX()) {
+      (void) osalThreadSuspendS(&uasp->wait);
+    }
+    if (cmdp == NULL) {
+      osalSysUnlock();
+      break;
+    }
+    cmdp->state = UAS_CMD_RUNNING;
+    cmdp->ready = false;
+    osalSysUnlock();
+
+    if (cmdp->iu[0] == UAS_IU_COMMAND)
+      execute_command(uasp, cmdp);
+    else if (cmdp->iu[0] == UAS_IU_TASK_MANAGEMENT)
+      execute_task_management(uasp, cmdp);
+    else
+      send_response(uasp, cmdp, UAS_RC_INVALID_IU);
+
+    osalSysLock();
+    cmdp->state = UAS_CMD_FREE;
+    start_command_pipe_i(uasp);
+    osalSysUnlock();
+  }
+
+  chThdExit(MSG_OK);
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes the standard part of a @p USBUASDriver structure.
+ *
+ * @param[out] uasp     pointer to the @p USBUASDriver object
+ *
+ * @init
+ */
+void uasObjectInit(USBUASDriver *uasp) {
+  unsigned i;
+
+  memset(uasp, 0, sizeof(USBUASDriver));
+  uasp->state = UAS_STOP;
+  for (i = 0; i < USB_UAS_MAX_LUNS; i++) {
+    scsiObjectInit(&uasp->luns[i].scsi_target);
+  }
+}
+
+/**
+ * @brief   Configures a logical unit.
+ * @details Must be called before @p uasStart(), units must be numbered
+ *          contiguously from 0.
+ * @note    The same @p blkbuf can be shared by all the units, the commands
+ *          are executed one at a time.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ * @param[in] lun       logical unit number
+ * @param[in] blkdev    pointer to the @p BaseBlockDevice object
+ * @param[in] blkbuf    pointer to the working area buffer, must be allocated
+ *                      by user, must be big enough to store 1 data block
+ * @param[in] inquiry   pointer to the SCSI inquiry response structure,
+ *                      set it to @p NULL to use default hardcoded value.
+ * @param[in] serialInquiry pointer to the SCSI unit serial number inquiry
+ *                      response structure, set it to @p NULL to use default
+ *                      hardcoded value.
+ *
+ * @api
+ */
+void uasSetLun(USBUASDriver *uasp, uint8_t lun,
+               BaseBlockDevice *blkdev, uint8_t *blkbuf,
+               const scsi_inquiry_response_t *inquiry,
+               const scsi_unit_serial_number_inquiry_response_t *serialInquiry) {
+  SCSITargetConfig *cfgp;
+
+  osalDbgCheck((uasp != NULL) && (lun < USB_UAS_MAX_LUNS)
+              && (blkdev != NULL) && (blkbuf != NULL));
+  osalDbgAssert((uasp->state == UAS_STOP), "invalid state");
+
+  cfgp = &uasp->luns[lun].scsi_config;
+  cfgp->inquiry_response = (inquiry != NULL) ? inquiry :
+                           &default_scsi_inquiry_response;
+  cfgp->unit_serial_number_inquiry_response = (serialInquiry != NULL) ?
+      serialInquiry : &default_scsi_unit_serial_number_inquiry_response;
+  cfgp->blkbuf = blkbuf;
+  cfgp->blkdev = blkdev;
+  cfgp->transport = &uasp->scsi_transport;
+}
+
+/**
+ * @brief   Configures and starts the driver.
+ * @details The command pipe is armed by @p uasConfigureHookI().
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ * @param[in] config    the UAS driver configuration
+ *
+ * @api
+ */
+void uasStart(USBUASDriver *uasp, const USBUASConfig *config) {
+  unsigned i;
+
+  osalDbgCheck((uasp != NULL) && (config != NULL));
+  osalDbgAssert((uasp->state == UAS_STOP), "invalid state");
+  osalDbgAssert(uasp->luns[0].scsi_config.blkdev != NULL, "no logical unit");
+
+  uasp->config = config;
+  uasp->scsi_transport.handler  = uasp;
+  uasp->scsi_transport.transmit = scsi_transport_transmit;
+  uasp->scsi_transport.receive  = scsi_transport_receive;
+
+  for (i = 0; (i < USB_UAS_MAX_LUNS)
+              && (uasp->luns[i].scsi_config.blkdev != NULL); i++) {
+    scsiStart(&uasp->luns[i].scsi_target, &uasp->luns[i].scsi_config);
+    uasp->luns[i].next_lba = 0;
+  }
+  uasp->num_luns = (uint8_t)i;
+
+  osalSysLock();
+  config->usbp->out_params[config->cmd_out - 1U] = uasp;
+  uasp->state = UAS_READY;
+  osalSysUnlock();
+
+  uasp->worker = chThdCreateStatic(uasp->wa_worker, sizeof(uasp->wa_worker),
+                                   USB_UAS_THD_PRIO, usb_uas_worker, uasp);
+}
+
+/**
+ * @brief   Stops the driver.
+ * @note    The worker completes the running command first, the USB driver
+ *          should be disconnected or stopped beforehand.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ *
+ * @api
+ */
+void uasStop(USBUASDriver *uasp) {
+  unsigned i;
+
+  osalDbgCheck(uasp != NULL);
+  osalDbgAssert((uasp->state == UAS_READY), "invalid state");
+
+  chThdTerminate(uasp->worker);
+  osalSysLock();
+  uasp->config->usbp->out_params[uasp->config->cmd_out - 1U] = NULL;
+  uasDisconnectI(uasp);
+  osalThreadResumeS(&uasp->wait, MSG_RESET);
+  osalSysUnlock();
+  chThdWait(uasp->worker);
+
+  for (i = 0; i < uasp->num_luns; i++) {
+    scsiStop(&uasp->luns[i].scsi_target);
+  }
+
+  uasp->worker = NULL;
+  uasp->state = UAS_STOP;
+}
+
+/**
+ * @brief   USB device disconnection handler.
+ * @details Drops the queued commands, the running one is terminated by the
+ *          USB driver.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ *
+ * @iclass
+ */
+void uasDisconnectI(USBUASDriver *uasp) {
+  unsigned i;
+
+  uasp->configured = false;
+  uasp->receiving = NULL;
+  for (i = 0; i < USB_UAS_MAX_COMMANDS; i++) {
+    if (uasp->cmds[i].state != UAS_CMD_RUNNING)
+      uasp->cmds[i].state = UAS_CMD_FREE;
+  }
+}
+
+/**
+ * @brief   USB device configured handler.
+ * @details To be called when the UAS alternate setting is selected, after
+ *          the endpoints have been initialized.
+ *
+ * @param[in] uasp      pointer to the @p USBUASDriver object
+ *
+ * @iclass
+ */
+void uasConfigureHookI(USBUASDriver *uasp) {
+
+  uasDisconnectI(uasp);
+  uasp->configured = true;
+  start_command_pipe_i(uasp);
+}
+
+/**
+ * @brief   Command pipe OUT callback.
+ * @details Queues the received IU and arms the pipe again on the next free
+ *          slot.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        OUT endpoint number
+ *
+ * @notapi
+ */
+void uasCommandReceived(USBDriver *usbp, usbep_t ep) {
+  USBUASDriver *uasp = usbp->out_params[ep - 1U];
+  usb_uas_cmd_t *cmdp;
+
+  if (uasp == NULL)
+    return;
+
+  osalSysLockFromISR();
+  cmdp = uasp->receiving;
+  uasp->receiving = NULL;
+  if (cmdp != NULL) {
+    cmdp->size = usbGetReceiveTransactionSizeX(usbp, ep);
+    cmdp->seq = uasp->seq++;
+    cmdp->bypassed = 0;
+    cmdp->state = UAS_CMD_QUEUED;
+    osalThreadResumeI(&uasp->wait, MSG_OK);
+  }
+  start_command_pipe_i(uasp);
+  osalSysUnlockFromISR();
+}
+
+#endif /* HAL_USE_USB_UAS */
+
+/** @} */
@@ -36,6 +36,10 @@ struct usbh_debug_helper usbh_debug;
 
 static void _classdriver_process_device(usbh_device_t *dev);
 static bool _classdriver_load(usbh_device_t *dev, uint8_t *descbuff, uint16_t rem);
+#if HAL_USBH_USE_SERVICE_THREAD
+static void _service_thread_start(USBHDriver *usbh);
+static void _service_thread_stop(USBHDriver *usbh);
+#endif
 
 #if HAL_USBH_USE_ADDITIONAL_CLASS_DRIVERS
 #include "usbh_additional_class_drivers.h"
@@ -82,6 +86,9 @@ void usbhObjectInit(USBHDriver *usbh) {
 #endif
 }
 
+/* number of started hosts, the class drivers can be registered while zero */
+static uint8_t usbh_hosts_started;
+
 void usbhStart(USBHDriver *usbh) {
 #if USBH_DEBUG_MULTI_HOST
 	usbDbgInit(usbh);
@@ -93,15 +100,26 @@ void usbhStart(USBHDriver *usbh) {
 	osalDbgAssert((usbh->status == USBH_STATUS_STOPPED), "invalid state");
 	usbh_lld_start(usbh);
 	usbh->status = USBH_STATUS_STARTED;
+	usbh_hosts_started++;
 	osalSysUnlock();
+
+#if HAL_USBH_USE_SERVICE_THREAD
+	_service_thread_start(usbh);
+#endif
 }
 
 void usbhStop(USBHDriver *usbh) {
 
+#if HAL_USBH_USE_SERVICE_THREAD
+	/* the thread finishes its current pass before the driver is stopped */
+	_service_thread_stop(usbh);
+#endif
+
 	osalSysLock();
 	osalDbgAssert((usbh->status == USBH_STATUS_STARTED), "invalid state");
 	usbh_lld_stop(usbh);
 	usbh->status = USBH_STATUS_STOPPED;
+	usbh_hosts_started--;
 	osalSysUnlock();
 }
 void usbhSuspend(USBHDriver *usbh) {
@@ -520,6 +538,10 @@ static void _device_initialize(usbh_device_t *dev, usbh_devspeed_t speed) {
 	dev->status = USBH_DEVSTATUS_DEFAULT;
 	dev->langID0 = 0;
 	dev->keepFullCfgDesc = 0;
+	dev->fullConfigurationDescriptor = NULL;
+	dev->fullCfgDescOnHeap = 0;
+	dev->num_ifs = 0;
+	dev->num_eps = 0;
 	_ep0_object_init(dev, 64);
 }
 
@@ -542,41 +564,168 @@ static inline bool _device_read_basic_cfgdesc(usbh_device_t *dev, uint8_t bConfi
 			sizeof(dev->basicConfigDesc), (uint8_t *)&dev->basicConfigDesc);
 }
 
-static void _device_read_full_cfgdesc(usbh_device_t *dev, uint8_t bConfiguration) {
-	_check_dev(dev);
+/* fills the interface and endpoint tables; with alt0_only set the alternate
+ * settings other than 0 are left out and so are the interfaces which don't
+ * fit, otherwise HAL_FAILED is returned if the tables are too small */
+static bool _device_parse_cfgdesc(usbh_device_t *dev, bool alt0_only) {
+	const uint8_t *const base = dev->fullConfigurationDescriptor;
+	generic_iterator_t iep, icfg;
+	if_iterator_t iif;
 
-	uint8_t i;
+	dev->num_ifs = 0;
+	dev->num_eps = 0;
+
+	cfg_iter_init(&icfg, base, dev->basicConfigDesc.wTotalLength);
+	if (!icfg.valid)
+		return HAL_FAILED;
+
+	for (if_iter_init(&iif, &icfg); iif.valid; if_iter_next(&iif)) {
+		const usbh_interface_descriptor_t *const ifdesc = if_get(&iif);
+
+		if (alt0_only && (ifdesc->bAlternateSetting != 0))
+			continue;
+
+		if (dev->num_ifs == HAL_USBH_DEVICE_MAX_INTERFACES) {
+			if (!alt0_only)
+				return HAL_FAILED;
+			udevwarnf("Interface table full (HAL_USBH_DEVICE_MAX_INTERFACES=%d), ignoring the remaining interfaces",
+					HAL_USBH_DEVICE_MAX_INTERFACES);
+			break;
+		}
+
+		usbh_ifinfo_t *const ifi = &dev->ifs[dev->num_ifs++];
+		ifi->offset = (const uint8_t *)ifdesc - base;
+		ifi->iad_offset = iif.iad ? (const uint8_t *)iif.iad - base : 0;
+		ifi->bInterfaceNumber = ifdesc->bInterfaceNumber;
+		ifi->bAlternateSetting = ifdesc->bAlternateSetting;
+		ifi->bInterfaceClass = ifdesc->bInterfaceClass;
+		ifi->bInterfaceSubClass = ifdesc->bInterfaceSubClass;
+		ifi->bInterfaceProtocol = ifdesc->bInterfaceProtocol;
+		ifi->ep_first = dev->num_eps;
+		ifi->ep_count = 0;
+
+		for (ep_iter_init(&iep, &iif); iep.valid; ep_iter_next(&iep)) {
+			if (dev->num_eps == HAL_USBH_DEVICE_MAX_ENDPOINTS)
+				break;
+			dev->ep_offsets[dev->num_eps++] = iep.curr - base;
+			ifi->ep_count++;
+		}
+
+		if (iep.valid) {
+			/* don't leave an interface with part of its endpoints */
+			dev->num_ifs--;
+			dev->num_eps = ifi->ep_first;
+			if (!alt0_only)
+				return HAL_FAILED;
+			udevwarnf("Endpoint table full (HAL_USBH_DEVICE_MAX_ENDPOINTS=%d), ignoring the remaining interfaces",
+					HAL_USBH_DEVICE_MAX_ENDPOINTS);
+			break;
+		}
+	}
+
+	return HAL_SUCCESS;
+}
 
-	if (dev->fullConfigurationDescriptor != NULL) {
+static void _device_free_full_cfgdesc(usbh_device_t *dev) {
+	osalDbgCheck(dev);
+	if (dev->fullCfgDescOnHeap) {
 		chHeapFree(dev->fullConfigurationDescriptor);
+		dev->fullCfgDescOnHeap = 0;
 	}
+	dev->fullConfigurationDescriptor = NULL;
+	dev->num_ifs = 0;
+	dev->num_eps = 0;
+}
 
-	dev->fullConfigurationDescriptor =
-			(uint8_t *)chHeapAlloc(0, dev->basicConfigDesc.wTotalLength);
+static void _device_read_full_cfgdesc(usbh_device_t *dev, uint8_t bConfiguration) {
+	_check_dev(dev);
+
+	const uint16_t len = dev->basicConfigDesc.wTotalLength;
+	uint8_t *buff;
+	uint8_t i;
+
+	_device_free_full_cfgdesc(dev);
 
-	if (!dev->fullConfigurationDescriptor)
+	if ((dev->address == 0) || (dev->address > USBH_MAX_ADDRESSES)) {
+		udeverrf("No configuration descriptor slot for address %d", dev->address);
 		return;
+	}
+
+	if (len <= HAL_USBH_CFGDESC_SLOT_SIZE) {
+		buff = dev->host->cfgdesc_arena[dev->address - 1];
+	} else {
+		udevwarnf("Configuration descriptor larger than its slot (%d bytes, HAL_USBH_CFGDESC_SLOT_SIZE=%d), using the heap",
+				len, HAL_USBH_CFGDESC_SLOT_SIZE);
+		buff = (uint8_t *)chHeapAlloc(0, len);
+		if (buff == NULL)
+			return;
+		dev->fullCfgDescOnHeap = 1;
+	}
 
 	for (i = 0; i < 3; i++) {
 		if (usbhStdReqGetConfigurationDescriptor(dev, bConfiguration,
-				dev->basicConfigDesc.wTotalLength,
-				dev->fullConfigurationDescriptor) == HAL_SUCCESS) {
+				len, buff) == HAL_SUCCESS) {
+			generic_iterator_t icfg;
+			cfg_iter_init(&icfg, buff, len);
+			if (!icfg.valid) {
+				udeverr("Invalid configuration descriptor.");
+				break;
+			}
+			dev->fullConfigurationDescriptor = buff;
+			if (_device_parse_cfgdesc(dev, false) == HAL_SUCCESS)
+				return;
+			udevwarnf("Interface/endpoint tables too small (HAL_USBH_DEVICE_MAX_INTERFACES=%d, HAL_USBH_DEVICE_MAX_ENDPOINTS=%d), leaving out the alternate settings",
+					HAL_USBH_DEVICE_MAX_INTERFACES, HAL_USBH_DEVICE_MAX_ENDPOINTS);
+			(void)_device_parse_cfgdesc(dev, true);
 			return;
 		}
-		osalThreadSleepMilliseconds(200);
+		osalThreadSleep(HAL_USBH_CFGDESC_RETRY_DELAY);
 	}
 
 	/* error */
-	chHeapFree(dev->fullConfigurationDescriptor);
-	dev->fullConfigurationDescriptor = NULL;
+	dev->fullConfigurationDescriptor = buff;
+	_device_free_full_cfgdesc(dev);
 }
 
-static void _device_free_full_cfgdesc(usbh_device_t *dev) {
-	osalDbgCheck(dev);
-	if (dev->fullConfigurationDescriptor != NULL) {
-		chHeapFree(dev->fullConfigurationDescriptor);
-		dev->fullConfigurationDescriptor = NULL;
+const usbh_ifinfo_t *usbhDeviceGetInterface(usbh_device_t *dev,
+		uint8_t bInterfaceNumber, uint8_t bAlternateSetting) {
+	uint8_t i;
+	for (i = 0; i < dev->num_ifs; i++) {
+		const usbh_ifinfo_t *const ifi = &dev->ifs[i];
+		if ((ifi->bInterfaceNumber == bInterfaceNumber)
+				&& (ifi->bAlternateSetting == bAlternateSetting))
+			return ifi;
+	}
+	return NULL;
+}
+
+const usbh_ifinfo_t *usbhDeviceMatchInterface(usbh_device_t *dev,
+		const usbh_ifinfo_t *prev, int16_t _class, int16_t subclass, int16_t protocol) {
+	const usbh_ifinfo_t *ifi = prev ? prev + 1 : dev->ifs;
+	for (; ifi < &dev->ifs[dev->num_ifs]; ifi++) {
+		if (((_class < 0) || (_class == ifi->bInterfaceClass))
+			&& ((subclass < 0) || (subclass == ifi->bInterfaceSubClass))
+			&& ((protocol < 0) || (protocol == ifi->bInterfaceProtocol)))
+			return ifi;
+	}
+	return NULL;
+}
+
+const usbh_ifinfo_t *usbhDeviceInterfaceOf(usbh_device_t *dev,
+		const uint8_t *descriptor) {
+	/* an interface descriptor, or the first interface following an IAD */
+	uint8_t i;
+	const uint8_t *const base = dev->fullConfigurationDescriptor;
+	if ((base == NULL) || (descriptor <= base)
+			|| (descriptor >= base + dev->basicConfigDesc.wTotalLength))
+		return NULL;
+	const uint16_t offset = descriptor - base;
+	for (i = 0; i < dev->num_ifs; i++) {
+		const usbh_ifinfo_t *const ifi = &dev->ifs[i];
+		if ((ifi->offset == offset) || (ifi->iad_offset == offset))
+			return ifi;
 	}
+	return NULL;
 }
 
 static bool _device_set_configuration(usbh_device_t *dev, uint8_t configuration) {
@@ -700,11 +849,11 @@ void usbhDevicePrintInfo(usbh_device_t *dev) {
 
 	if (dev->langID0) {
 		usbhDeviceReadString(dev, str, sizeof(str), desc->iManufacturer, dev->langID0);
-		udevinfof("\tManufacturer: %s", str);
+		udevinfos("\tManufacturer: %s", str);
 		usbhDeviceReadString(dev, str, sizeof(str), desc->iProduct, dev->langID0);
-		udevinfof("\tProduct: %s", str);
+		udevinfos("\tProduct: %s", str);
 		usbhDeviceReadString(dev, str, sizeof(str), desc->iSerialNumber, dev->langID0);
-		udevinfof("\tSerial Number: %s", str);
+		udevinfos("\tSerial Number: %s", str);
 	}
 
 	if (dev->status == USBH_DEVSTATUS_CONFIGURED) {
@@ -721,7 +870,7 @@ void usbhDevicePrintInfo(usbh_device_t *dev) {
 				cfg->bmAttributes & 0x20 ? 1 : 0);
 		if (dev->langID0) {
 			usbhDeviceReadString(dev, str, sizeof(str), cfg->iConfiguration, dev->langID0);
-			udevinfof("\tName: %s", str);
+			udevinfos("\tName: %s", str);
 		}
 	}
 
@@ -1011,6 +1160,11 @@ reset_success:
 	}
 
 	_classdriver_process_device(&port->device);
+
+	port->device.host->attach_latency = osalTimeDiffX(port->device.host->process_time,
+			osalOsGetSystemTimeX());
+	uportinfof("Port %d: drivers loaded %dms after the status change", port->number,
+			(int)OSAL_I2MS(port->device.host->attach_latency));
 	return;
 
 abort:
@@ -1150,7 +1304,32 @@ static void _hub_process(USBHDriver *host) {
 /*===========================================================================*/
 /* Main processing loop (enumeration, loading/unloading drivers, etc).       */
 /*===========================================================================*/
-void usbhMainLoop(USBHDriver *usbh) {
+
+/* Called by the LLD on root hub port status changes and by the HUB driver on
+ * status change URBs, the time of the first unprocessed change is kept for
+ * the attach latency measurement. */
+void _usbh_signal_eventI(USBHDriver *usbh, eventflags_t events) {
+	osalDbgCheckClassI();
+
+	const eventflags_t stamped = USBH_EVENT_ROOTHUB | USBH_EVENT_HUB;
+	if (((usbh->events & stamped) == 0) && ((events & stamped) != 0))
+		usbh->event_time = osalOsGetSystemTimeX();
+	usbh->events |= events;
+
+#if HAL_USBH_USE_SERVICE_THREAD
+	osalThreadResumeI(&usbh->svc_thread, MSG_OK);
+#endif
+}
+
+static void _main_loop(USBHDriver *usbh) {
+
+	osalSysLock();
+	if (usbh->events & (USBH_EVENT_ROOTHUB | USBH_EVENT_HUB))
+		usbh->process_time = usbh->event_time;
+	else
+		usbh->process_time = osalOsGetSystemTimeX();
+	usbh->events = 0;
+	osalSysUnlock();
 
 	if (usbh->status == USBH_STATUS_STOPPED)
 		return;
@@ -1170,6 +1349,76 @@ void usbhMainLoop(USBHDriver *usbh) {
 #endif
 }
 
+#if HAL_USBH_USE_SERVICE_THREAD
+static THD_FUNCTION(_service_thread, arg) {
+	USBHDriver *const usbh = (USBHDriver *)arg;
+
+	chRegSetThreadName("USBH");
+	while (true) {
+		osalSysLock();
+		if (chThdShouldTerminateX()) {
+			osalSysUnlock();
+			break;
+		}
+		if (usbh->events == 0)
+			osalThreadSuspendTimeoutS(&usbh->svc_thread, HAL_USBH_SERVICE_POLL_INTERVAL);
+		osalSysUnlock();
+
+		if (chThdShouldTerminateX())
+			break;
+
+		_main_loop(usbh);
+	}
+}
+
+static void _service_thread_start(USBHDriver *usbh) {
+	if (usbh->svc_tp == NULL) {
+		usbh->svc_tp = chThdCreateStatic(usbh->svc_wa, sizeof(usbh->svc_wa),
+				HAL_USBH_SERVICE_THREAD_PRIORITY, _service_thread, usbh);
+	}
+
+	/* pick up the state of the ports at start */
+	osalSysLock();
+	_usbh_signal_eventI(usbh, USBH_EVENT_POLL);
+	osalOsRescheduleS();
+	osalSysUnlock();
+}
+
+/* must not be called from the service thread itself, i.e. from the class
+ * drivers load() or unload() functions */
+static void _service_thread_stop(USBHDriver *usbh) {
+	thread_t *tp = usbh->svc_tp;
+
+	if (tp == NULL)
+		return;
+
+	osalDbgAssert(tp != chThdGetSelfX(), "called from the service thread");
+
+	chThdTerminate(tp);
+	osalSysLock();
+	osalThreadResumeI(&usbh->svc_thread, MSG_OK);
+	osalOsRescheduleS();
+	osalSysUnlock();
+
+	chThdWait(tp);
+	usbh->svc_tp = NULL;
+}
+#endif
+
+/* Processes the pending status changes. With HAL_USBH_USE_SERVICE_THREAD the
+ * service thread does it on events and this function only requests a poll,
+ * otherwise it must be called periodically by the application. */
+void usbhMainLoop(USBHDriver *usbh) {
+#if HAL_USBH_USE_SERVICE_THREAD
+	osalSysLock();
+	_usbh_signal_eventI(usbh, USBH_EVENT_POLL);
+	osalOsRescheduleS();
+	osalSysUnlock();
+#else
+	_main_loop(usbh);
+#endif
+}
+
 /*===========================================================================*/
 /* Class driver loader.                                                      */
 /*===========================================================================*/
@@ -1182,48 +1431,57 @@ bool _usbh_match_vid_pid(usbh_device_t *dev, int32_t vid, int32_t pid) {
 	return HAL_FAILED;
 }
 
-bool _usbh_match_descriptor(const uint8_t *descriptor, uint16_t rem,
-		int16_t type, int16_t _class, int16_t subclass, int16_t protocol) {
-
-	int16_t dclass, dsubclass, dprotocol;
+static bool _descriptor_info(const uint8_t *descriptor, uint16_t rem,
+		uint8_t *dtype, uint8_t *dclass, uint8_t *dsubclass, uint8_t *dprotocol) {
 
 	if ((rem < descriptor[0]) || (rem < 2))
 		return HAL_FAILED;
 
-	uint8_t dtype = descriptor[1];
-
-	if ((type >= 0) && (type != dtype))
-		return HAL_FAILED;
+	*dtype = descriptor[1];
 
-	switch (dtype) {
+	switch (*dtype) {
 	case USBH_DT_DEVICE: {
 		if (rem < USBH_DT_DEVICE_SIZE)
 			return HAL_FAILED;
 		const usbh_device_descriptor_t *const desc = (const usbh_device_descriptor_t *)descriptor;
-		dclass = desc->bDeviceClass;
-		dsubclass = desc->bDeviceSubClass;
-		dprotocol = desc->bDeviceProtocol;
+		*dclass = desc->bDeviceClass;
+		*dsubclass = desc->bDeviceSubClass;
+		*dprotocol = desc->bDeviceProtocol;
 	}	break;
 	case USBH_DT_INTERFACE: {
 		if (rem < USBH_DT_INTERFACE_SIZE)
 			return HAL_FAILED;
 		const usbh_interface_descriptor_t *const desc = (const usbh_interface_descriptor_t *)descriptor;
-		dclass = desc->bInterfaceClass;
-		dsubclass = desc->bInterfaceSubClass;
-		dprotocol = desc->bInterfaceProtocol;
+		*dclass = desc->bInterfaceClass;
+		*dsubclass = desc->bInterfaceSubClass;
+		*dprotocol = desc->bInterfaceProtocol;
 	}	break;
 	case USBH_DT_INTERFACE_ASSOCIATION: {
 		if (rem < USBH_DT_INTERFACE_ASSOCIATION_SIZE)
 			return HAL_FAILED;
 		const usbh_ia_descriptor_t *const desc = (const usbh_ia_descriptor_t *)descriptor;
-		dclass = desc->bFunctionClass;
-		dsubclass = desc->bFunctionSubClass;
-		dprotocol = desc->bFunctionProtocol;
+		*dclass = desc->bFunctionClass;
+		*dsubclass = desc->bFunctionSubClass;
+		*dprotocol = desc->bFunctionProtocol;
 	}	break;
 	default:
 		return HAL_FAILED;
 	}
 
+	return HAL_SUCCESS;
+}
+
+bool _usbh_match_descriptor(const uint8_t *descriptor, uint16_t rem,
+		int16_t type, int16_t _class, int16_t subclass, int16_t protocol) {
+
+	uint8_t dtype, dclass, dsubclass, dprotocol;
+
+	if (_descriptor_info(descriptor, rem, &dtype, &dclass, &dsubclass, &dprotocol) != HAL_SUCCESS)
+		return HAL_FAILED;
+
+	if ((type >= 0) && (type != dtype))
+		return HAL_FAILED;
+
 	if (((_class < 0) || (_class == dclass))
 		&& ((subclass < 0) || (subclass == dsubclass))
 		&& ((protocol < 0) || (protocol == dprotocol)))
@@ -1255,19 +1513,185 @@ static const usbh_classdriverinfo_t *usbh_classdrivers_lookup[] = {
 #if HAL_USBH_USE_UVC
 	&usbhuvcClassDriverInfo,
 #endif
+#if HAL_USBH_USE_CDC_ACM
+	&usbhcdcacmClassDriverInfo,
+#endif
+#if HAL_USBH_USE_CDC_NCM
+	&usbhcdcncmClassDriverInfo,
+#endif
 #if HAL_USBH_USE_AOA
 	&usbhaoaClassDriverInfo,	/* Leave always last */
 #endif
 };
 
-static bool _classdriver_load(usbh_device_t *dev, uint8_t *descbuff, uint16_t rem) {
+/* Match index: one entry per match table entry of each class driver, the
+ * entries comparing the class sorted by class followed by the entries
+ * accepting any class. Within each range the entries keep the priority order
+ * of the drivers: the registered ones, last registered first, then the ones of
+ * usbh_classdrivers_lookup. */
+#define USBH_MATCH_KEY_ANY		0x100
+
+typedef struct {
+	const usbh_classdriver_match_t *match;	/* NULL: any descriptor */
+	const usbh_classdriverinfo_t *info;
+	uint16_t key;
+	uint8_t prio;
+} usbh_matchentry_t;
+
+static usbh_matchentry_t usbh_match_index[HAL_USBH_CLASSDRIVER_MATCH_ENTRIES];
+static uint8_t usbh_match_count;
+static uint8_t usbh_match_any;
+static usbh_classdriverreg_t *usbh_classdrivers_registered;
+
+static void _match_index_add(const usbh_classdriverinfo_t *info, uint8_t prio,
+		const usbh_classdriver_match_t *match) {
+	uint16_t key = USBH_MATCH_KEY_ANY;
+	uint8_t i;
+
+	if (usbh_match_count >= HAL_USBH_CLASSDRIVER_MATCH_ENTRIES) {
+		osalDbgAssert(false, "match index full");
+		return;
+	}
+
+	if ((match != NULL) && (match->flags & USBH_MATCH_CLASS))
+		key = match->bClass;
+
+	/* entries are added in priority order, keep it among the equal keys */
+	i = usbh_match_count++;
+	while ((i > 0) && (usbh_match_index[i - 1].key > key)) {
+		usbh_match_index[i] = usbh_match_index[i - 1];
+		i--;
+	}
+	usbh_match_index[i].match = match;
+	usbh_match_index[i].info = info;
+	usbh_match_index[i].key = key;
+	usbh_match_index[i].prio = prio;
+}
+
+static void _match_index_add_driver(const usbh_classdriverinfo_t *info, uint8_t prio) {
 	uint8_t i;
+
+	/* a driver is indexed once, with its highest priority */
+	for (i = 0; i < usbh_match_count; i++) {
+		if (usbh_match_index[i].info == info)
+			return;
+	}
+
+	if (info->matches == NULL) {
+		_match_index_add(info, prio, NULL);
+		return;
+	}
+
+	for (i = 0; i < info->num_matches; i++)
+		_match_index_add(info, prio, &info->matches[i]);
+}
+
+static void _match_index_build(void) {
+	const usbh_classdriverreg_t *reg;
+	uint8_t prio = 0;
+	uint8_t i;
+
+	usbh_match_count = 0;
+	for (reg = usbh_classdrivers_registered; reg != NULL; reg = reg->next)
+		_match_index_add_driver(reg->info, prio++);
+	for (i = 0; i < sizeof_array(usbh_classdrivers_lookup); i++)
+		_match_index_add_driver(usbh_classdrivers_lookup[i], prio++);
+
+	for (i = 0; i < usbh_match_count; i++) {
+		if (usbh_match_index[i].key == USBH_MATCH_KEY_ANY)
+			break;
+	}
+	usbh_match_any = i;
+}
+
+static bool _match_entry(const usbh_classdriver_match_t *match,
+		const usbh_device_t *dev, uint8_t dtype, uint8_t dsubclass, uint8_t dprotocol) {
+
+	/* the class has been compared by the index lookup */
+	if (match == NULL)
+		return true;
+	if (match->type && (match->type != dtype))
+		return false;
+	if ((match->flags & USBH_MATCH_VENDOR) && (match->idVendor != dev->devDesc.idVendor))
+		return false;
+	if ((match->flags & USBH_MATCH_PRODUCT) && (match->idProduct != dev->devDesc.idProduct))
+		return false;
+	if ((match->flags & USBH_MATCH_SUBCLASS) && (match->bSubClass != dsubclass))
+		return false;
+	if ((match->flags & USBH_MATCH_PROTOCOL) && (match->bProtocol != dprotocol))
+		return false;
+	return true;
+}
+
+/* the index is rebuilt in place: the hosts must be stopped, so that no
+ * enumeration runs meanwhile */
+void usbhRegisterClassDriver(usbh_classdriverreg_t *reg) {
+	const usbh_classdriverreg_t *p;
+
+	osalDbgCheck((reg != NULL) && (reg->info != NULL));
+
+	osalSysLock();
+	osalDbgAssert(usbh_hosts_started == 0, "hosts started");
+	osalSysUnlock();
+
+	for (p = usbh_classdrivers_registered; p != NULL; p = p->next) {
+		if (p == reg) {
+			osalDbgAssert(false, "already registered");
+			return;
+		}
+	}
+
+	if (reg->info->vmt->init)
+		reg->info->vmt->init();
+
+	reg->next = usbh_classdrivers_registered;
+	usbh_classdrivers_registered = reg;
+	_match_index_build();
+}
+
+static bool _classdriver_load(usbh_device_t *dev, uint8_t *descbuff, uint16_t rem) {
+	const usbh_classdriverinfo_t *tried = NULL;
 	usbh_baseclassdriver_t *drv = NULL;
-	for (i = 0; i < sizeof_array(usbh_classdrivers_lookup); i++) {
-		const usbh_classdriverinfo_t *const info = usbh_classdrivers_lookup[i];
+	uint8_t dtype, dclass, dsubclass, dprotocol;
+	uint8_t a, a_end, b, mid;
+
+	if (_descriptor_info(descbuff, rem, &dtype, &dclass, &dsubclass, &dprotocol) != HAL_SUCCESS)
+		return HAL_FAILED;
 
-		udevinfof("Try load driver %s", info->name);
-		drv = info->vmt->load(dev, descbuff, rem);
+	/* range of the entries for this class */
+	a = 0;
+	a_end = usbh_match_any;
+	while (a < a_end) {
+		mid = (a + a_end) / 2;
+		if (usbh_match_index[mid].key < dclass)
+			a = mid + 1;
+		else
+			a_end = mid;
+	}
+	a_end = a;
+	while ((a_end < usbh_match_any) && (usbh_match_index[a_end].key == dclass))
+		a_end++;
+
+	/* merge it with the any class range, in priority order */
+	b = usbh_match_any;
+	while ((a < a_end) || (b < usbh_match_count)) {
+		const usbh_matchentry_t *e;
+
+		if ((b >= usbh_match_count)
+				|| ((a < a_end) && (usbh_match_index[a].prio <= usbh_match_index[b].prio)))
+			e = &usbh_match_index[a++];
+		else
+			e = &usbh_match_index[b++];
+
+		/* the entries of a driver are adjacent, try it once */
+		if (e->info == tried)
+			continue;
+		if (!_match_entry(e->match, dev, dtype, dsubclass, dprotocol))
+			continue;
+		tried = e->info;
+
+		udevinfof("Try load driver %s", e->info->name);
+		drv = e->info->vmt->load(dev, descbuff, rem);
 
 		if (drv != NULL)
 			goto success;
@@ -1285,6 +1709,20 @@ success:
 	return HAL_SUCCESS;
 }
 
+static void _update_enum_stats(USBHDriver *host, sysinterval_t latency) {
+	usbh_enum_stats_t *const stats = &host->enum_stats;
+
+	osalSysLock();
+	if (!stats->count || (latency < stats->min))
+		stats->min = latency;
+	if (latency > stats->max)
+		stats->max = latency;
+	stats->last = latency;
+	stats->total += latency;
+	stats->count++;
+	osalSysUnlock();
+}
+
 static void _classdriver_process_device(usbh_device_t *dev) {
 	udevinfo("New device found.");
 	const usbh_device_descriptor_t *const devdesc = &dev->devDesc;
@@ -1304,6 +1742,8 @@ static void _classdriver_process_device(usbh_device_t *dev) {
 		}
 	}
 
+	const systime_t start = osalOsGetSystemTimeX();
+
 	_device_read_full_cfgdesc(dev, dev->bConfiguration);
 	if (dev->fullConfigurationDescriptor == NULL) {
 		udeverr("Couldn't read full configuration descriptor; abort.");
@@ -1313,6 +1753,10 @@ static void _classdriver_process_device(usbh_device_t *dev) {
 	usbhDevicePrintConfiguration(dev, dev->fullConfigurationDescriptor,
 			dev->basicConfigDesc.wTotalLength);
 
+	const uint8_t *const base = dev->fullConfigurationDescriptor;
+	const uint16_t total = dev->basicConfigDesc.wTotalLength;
+	uint8_t i;
+
 #if HAL_USBH_USE_IAD
 	if (dev->devDesc.bDeviceClass == 0xef
 			&& dev->devDesc.bDeviceSubClass == 0x02
@@ -1320,26 +1764,19 @@ static void _classdriver_process_device(usbh_device_t *dev) {
 
 		udevinfo("Load a driver for each IF collection.");
 
-		generic_iterator_t icfg;
-		if_iterator_t iif;
-		const usbh_ia_descriptor_t *last_iad = 0;
+		uint16_t last_iad = 0;
 
-		cfg_iter_init(&icfg, dev->fullConfigurationDescriptor,
-				dev->basicConfigDesc.wTotalLength);
-		if (!icfg.valid) {
-			udeverr("Invalid configuration descriptor.");
-			goto exit;
-		}
-
-		for (if_iter_init(&iif, &icfg); iif.valid; if_iter_next(&iif)) {
-			if (iif.iad && (iif.iad != last_iad)) {
-				last_iad = iif.iad;
-				if (_classdriver_load(dev,
-						(uint8_t *)iif.iad,
-						(uint8_t *)iif.curr - (uint8_t *)iif.iad + iif.rem) != HAL_SUCCESS) {
+		for (i = 0; i < dev->num_ifs; i++) {
+			const usbh_ifinfo_t *const ifi = &dev->ifs[i];
+			if (ifi->iad_offset && (ifi->iad_offset != last_iad)) {
+				const usbh_ia_descriptor_t *const iad =
+						(const usbh_ia_descriptor_t *)(base + ifi->iad_offset);
+				last_iad = ifi->iad_offset;
+				if (_classdriver_load(dev, (uint8_t *)iad,
+						total - ifi->iad_offset) != HAL_SUCCESS) {
 					udevwarnf("No drivers found for IF collection #%d:%d",
-							iif.iad->bFirstInterface,
-							iif.iad->bFirstInterface + iif.iad->bInterfaceCount - 1);
+							iad->bFirstInterface,
+							iad->bFirstInterface + iad->bInterfaceCount - 1);
 				}
 			}
 		}
@@ -1353,23 +1790,15 @@ static void _classdriver_process_device(usbh_device_t *dev) {
 			/* each interface defines its own device class/subclass/protocol */
 			udevinfo("Try load a driver for each IF.");
 
-			generic_iterator_t icfg;
-			if_iterator_t iif;
 			uint8_t last_if = 0xff;
 
-			cfg_iter_init(&icfg, dev->fullConfigurationDescriptor,
-					dev->basicConfigDesc.wTotalLength);
-			if (!icfg.valid) {
-				udeverr("Invalid configuration descriptor.");
-				goto exit;
-			}
-
-			for (if_iter_init(&iif, &icfg); iif.valid; if_iter_next(&iif)) {
-				const usbh_interface_descriptor_t *const ifdesc = if_get(&iif);
-				if (ifdesc->bInterfaceNumber != last_if) {
-					last_if = ifdesc->bInterfaceNumber;
-					if (_classdriver_load(dev, (uint8_t *)ifdesc, iif.rem) != HAL_SUCCESS) {
-						udevwarnf("No drivers found for IF #%d", ifdesc->bInterfaceNumber);
+			for (i = 0; i < dev->num_ifs; i++) {
+				const usbh_ifinfo_t *const ifi = &dev->ifs[i];
+				if (ifi->bInterfaceNumber != last_if) {
+					last_if = ifi->bInterfaceNumber;
+					if (_classdriver_load(dev, (uint8_t *)base + ifi->offset,
+							usbhIfRemaining(dev, ifi)) != HAL_SUCCESS) {
+						udevwarnf("No drivers found for IF #%d", ifi->bInterfaceNumber);
 					}
 				}
 			}
@@ -1378,10 +1807,8 @@ static void _classdriver_process_device(usbh_device_t *dev) {
 		}
 	}
 
-exit:
-	if (dev->keepFullCfgDesc == 0) {
-		_device_free_full_cfgdesc(dev);
-	}
+	/* the descriptor stays in its arena slot until the device is disconnected */
+	_update_enum_stats(dev->host, osalTimeDiffX(start, osalOsGetSystemTimeX()));
 }
 
 void usbhInit(void) {
@@ -1391,6 +1818,7 @@ void usbhInit(void) {
 			usbh_classdrivers_lookup[i]->vmt->init();
 		}
 	}
+	_match_index_build();
 	usbh_lld_init();
 }
 
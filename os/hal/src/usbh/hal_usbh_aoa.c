@@ -105,8 +105,15 @@ static const usbh_classdriver_vmt_t class_driver_vmt = {
 	_aoa_unload
 };
 
+static const usbh_classdriver_match_t class_driver_matches[] = {
+	/* any other device is probed for the accessory mode */
+	USBH_MATCH_INFO(USBH_DT_DEVICE, -1, -1, -1),
+	USBH_MATCH(USBH_DT_INTERFACE, AOA_GOOGLE_VID, -1, 0xff, 0xff, 0x00),
+};
+
 const usbh_classdriverinfo_t usbhaoaClassDriverInfo = {
-	"AOA", &class_driver_vmt
+	"AOA", &class_driver_vmt,
+	class_driver_matches, sizeof_array(class_driver_matches)
 };
 
 #if defined(HAL_USBHAOA_FILTER_CALLBACK)
@@ -230,17 +237,15 @@ alloc_ok:
 	usbhEPSetName(&dev->ctrl, "AOA[CTRL]");
 	aoap->state = USBHAOA_STATE_ACTIVE;
 
-	generic_iterator_t iep;
-	if_iterator_t iif;
-	iif.iad = 0;
-	iif.curr = descriptor;
-	iif.rem = rem;
+	/* endpoints of the pre-parsed interface */
+	const usbh_ifinfo_t *const ifi = usbhDeviceInterfaceOf(dev, descriptor);
+	const uint8_t ep_count = ifi ? ifi->ep_count : 0;
 
 	aoap->channel.epin.status = USBH_EPSTATUS_UNINITIALIZED;
 	aoap->channel.epout.status = USBH_EPSTATUS_UNINITIALIZED;
 
-	for (ep_iter_init(&iep, &iif); iep.valid; ep_iter_next(&iep)) {
-		const usbh_endpoint_descriptor_t *const epdesc = ep_get(&iep);
+	for (i = 0; i < ep_count; i++) {
+		const usbh_endpoint_descriptor_t *const epdesc = usbhIfEndpoint(dev, ifi, i);
 		if ((epdesc->bEndpointAddress & 0x80) && (epdesc->bmAttributes == USBH_EPTYPE_BULK)) {
 			udevinfof("AOA: BULK IN endpoint found: bEndpointAddress=%02x", epdesc->bEndpointAddress);
 			usbhEPObjectInit(&aoap->channel.epin, dev, epdesc);
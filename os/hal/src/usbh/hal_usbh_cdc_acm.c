@@ -0,0 +1,656 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+              Copyright (C) 2015..2019 Diego Ismirlian, (dismirlian(at)google's mail)
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+
+#if HAL_USBH_USE_CDC_ACM
+
+#if !HAL_USE_USBH
+#error "USBHCDCACM needs USBH"
+#endif
+
+#include <string.h>
+#include "usbh/dev/cdc_acm.h"
+#include "usbh/internal.h"
+
+#define _USBH_DEBUG_HELPER_CLASS_DRIVER		container_of(acmcp, USBHCDCACMDriver, channel)
+#define _USBH_DEBUG_HELPER_ENABLE_TRACE		USBHCDCACM_DEBUG_ENABLE_TRACE
+#define _USBH_DEBUG_HELPER_ENABLE_INFO		USBHCDCACM_DEBUG_ENABLE_INFO
+#define _USBH_DEBUG_HELPER_ENABLE_WARNINGS	USBHCDCACM_DEBUG_ENABLE_WARNINGS
+#define _USBH_DEBUG_HELPER_ENABLE_ERRORS	USBHCDCACM_DEBUG_ENABLE_ERRORS
+#include "usbh/debug_helpers.h"
+
+
+static void _acm_object_init(USBHCDCACMDriver *acmp);
+static void _stopS(USBHCDCACMDriver *acmp);
+
+/*===========================================================================*/
+/* USB Class driver loader for CDC-ACM						 		 	 	 */
+/*===========================================================================*/
+USBHCDCACMDriver USBHCDCACMD[HAL_USBHCDCACM_MAX_INSTANCES];
+
+static void _acm_init(void);
+static usbh_baseclassdriver_t *_acm_load(usbh_device_t *dev, const uint8_t *descriptor, uint16_t rem);
+static void _acm_unload(usbh_baseclassdriver_t *drv);
+
+static const usbh_classdriver_vmt_t class_driver_vmt = {
+	_acm_init,
+	_acm_load,
+	_acm_unload
+};
+
+static const usbh_classdriver_match_t class_driver_matches[] = {
+	USBH_MATCH_INFO(USBH_DT_DEVICE, USBH_CDC_CLASS_COMM, -1, -1),
+	USBH_MATCH_INFO(USBH_DT_INTERFACE_ASSOCIATION, USBH_CDC_CLASS_COMM, USBH_CDC_SUBCLASS_ACM, -1),
+	USBH_MATCH_INFO(USBH_DT_INTERFACE, USBH_CDC_CLASS_COMM, USBH_CDC_SUBCLASS_ACM, -1),
+};
+
+const usbh_classdriverinfo_t usbhcdcacmClassDriverInfo = {
+	"CDC-ACM", &class_driver_vmt,
+	class_driver_matches, sizeof_array(class_driver_matches)
+};
+
+static usbh_baseclassdriver_t *_acm_load(usbh_device_t *dev, const uint8_t *descriptor, uint16_t rem) {
+	int i;
+	int16_t target;
+	USBHCDCACMDriver *acmp;
+
+	/* the function may be offered as a whole device, as an IF collection or
+	 * as the Communications interface itself */
+	if (_usbh_match_descriptor(descriptor, rem, USBH_DT_DEVICE,
+			USBH_CDC_CLASS_COMM, -1, -1) == HAL_SUCCESS) {
+		target = -1;
+	} else if (_usbh_match_descriptor(descriptor, rem, USBH_DT_INTERFACE_ASSOCIATION,
+			USBH_CDC_CLASS_COMM, USBH_CDC_SUBCLASS_ACM, -1) == HAL_SUCCESS) {
+		target = ((const usbh_ia_descriptor_t *)descriptor)->bFirstInterface;
+	} else if (_usbh_match_descriptor(descriptor, rem, USBH_DT_INTERFACE,
+			USBH_CDC_CLASS_COMM, USBH_CDC_SUBCLASS_ACM, -1) == HAL_SUCCESS) {
+		target = ((const usbh_interface_descriptor_t *)descriptor)->bInterfaceNumber;
+	} else {
+		return NULL;
+	}
+
+	/* alloc driver */
+	for (i = 0; i < HAL_USBHCDCACM_MAX_INSTANCES; i++) {
+		if (USBHCDCACMD[i].dev == NULL) {
+			acmp = &USBHCDCACMD[i];
+			goto alloc_ok;
+		}
+	}
+
+	udevwarn("CDC-ACM: Can't alloc driver");
+
+	/* can't alloc */
+	return NULL;
+
+alloc_ok:
+	/* initialize the driver's variables */
+	usbhEPSetName(&dev->ctrl, "ACM[CTRL]");
+	acmp->epint.status = USBH_EPSTATUS_UNINITIALIZED;
+	acmp->channel.epin.status = USBH_EPSTATUS_UNINITIALIZED;
+	acmp->channel.epout.status = USBH_EPSTATUS_UNINITIALIZED;
+
+	/* look the Communications interface up in the pre-parsed configuration;
+	 * the data interface is named by the Union functional descriptor, or
+	 * follows the Communications one */
+	const usbh_ifinfo_t *ifi = NULL;
+	while ((ifi = usbhDeviceMatchInterface(dev, ifi, USBH_CDC_CLASS_COMM,
+			USBH_CDC_SUBCLASS_ACM, -1)) != NULL) {
+		if ((target < 0) || (ifi->bInterfaceNumber == target))
+			break;
+	}
+	if (ifi == NULL) {
+		udevwarn("CDC-ACM: Communications Interface not found");
+		return NULL;
+	}
+
+	udevinfof("CDC-ACM: Communications Interface #%d", ifi->bInterfaceNumber);
+	acmp->ifnum = ifi->bInterfaceNumber;
+	uint8_t data_if = ifi->bInterfaceNumber + 1;
+
+	generic_iterator_t ics;
+	for (ifinfo_cs_iter_init(&ics, dev, ifi); ics.valid; cs_iter_next(&ics)) {
+		const usbh_cdc_union_descriptor_t *const un =
+				(const usbh_cdc_union_descriptor_t *)ics.curr;
+		if ((un->bDescriptorType == USBH_CDC_DT_CS_INTERFACE)
+				&& (un->bDescriptorSubtype == USBH_CDC_FD_UNION)
+				&& (un->bFunctionLength >= sizeof(*un))) {
+			data_if = un->bSubordinateInterface0;
+		}
+	}
+
+	for (i = 0; i < ifi->ep_count; i++) {
+		const usbh_endpoint_descriptor_t *const epdesc = usbhIfEndpoint(dev, ifi, i);
+		if ((epdesc->bEndpointAddress & 0x80) && (epdesc->bmAttributes == USBH_EPTYPE_INT)) {
+			udevinfof("CDC-ACM: INT IN endpoint found: bEndpointAddress=%02x", epdesc->bEndpointAddress);
+			usbhEPObjectInit(&acmp->epint, dev, epdesc);
+			usbhEPSetName(&acmp->epint, "ACM[IIN ]");
+		}
+	}
+
+	ifi = usbhDeviceGetInterface(dev, data_if, 0);
+	if (ifi != NULL) {
+		udevinfof("CDC-ACM: Data Interface #%d", ifi->bInterfaceNumber);
+		for (i = 0; i < ifi->ep_count; i++) {
+			const usbh_endpoint_descriptor_t *const epdesc = usbhIfEndpoint(dev, ifi, i);
+			if ((epdesc->bEndpointAddress & 0x80) && (epdesc->bmAttributes == USBH_EPTYPE_BULK)) {
+				udevinfof("CDC-ACM: BULK IN endpoint found: bEndpointAddress=%02x", epdesc->bEndpointAddress);
+				usbhEPObjectInit(&acmp->channel.epin, dev, epdesc);
+				usbhEPSetName(&acmp->channel.epin, "ACM[BIN ]");
+			} else if (((epdesc->bEndpointAddress & 0x80) == 0)
+					&& (epdesc->bmAttributes == USBH_EPTYPE_BULK)) {
+				udevinfof("CDC-ACM: BULK OUT endpoint found: bEndpointAddress=%02x", epdesc->bEndpointAddress);
+				usbhEPObjectInit(&acmp->channel.epout, dev, epdesc);
+				usbhEPSetName(&acmp->channel.epout, "ACM[BOUT]");
+			} else {
+				udevinfof("CDC-ACM: unsupported endpoint found: bEndpointAddress=%02x, bmAttributes=%02x",
+						epdesc->bEndpointAddress, epdesc->bmAttributes);
+			}
+		}
+	}
+
+	if ((acmp->channel.epin.status != USBH_EPSTATUS_CLOSED)
+			|| (acmp->channel.epout.status != USBH_EPSTATUS_CLOSED)) {
+		udevwarn("CDC-ACM: Couldn't find endpoints");
+		return NULL;
+	}
+
+	acmp->state = USBHCDCACM_STATE_ACTIVE;
+	return (usbh_baseclassdriver_t *)acmp;
+}
+
+static void _acm_unload(usbh_baseclassdriver_t *drv) {
+	osalDbgCheck(drv != NULL);
+	USBHCDCACMDriver *const acmp = (USBHCDCACMDriver *)drv;
+
+	osalMutexLock(&acmp->mtx);
+	osalSysLock();
+	_stopS(acmp);
+	osalSysUnlock();
+	osalMutexUnlock(&acmp->mtx);
+
+	osalSysLock();
+	_acm_object_init(acmp);
+	osalSysUnlock();
+}
+
+
+/*===========================================================================*/
+/* Class requests.                                                           */
+/*===========================================================================*/
+
+static usbh_urbstatus_t _set_line_coding(USBHCDCACMDriver *acmp,
+		const USBHCDCACMConfig *config) {
+	USBH_DEFINE_BUFFER(uint8_t coding[7]);
+	coding[0] = (uint8_t)config->speed;
+	coding[1] = (uint8_t)(config->speed >> 8);
+	coding[2] = (uint8_t)(config->speed >> 16);
+	coding[3] = (uint8_t)(config->speed >> 24);
+	coding[4] = config->stop_bits;
+	coding[5] = config->parity;
+	coding[6] = config->data_bits;
+
+	return usbhControlRequest(acmp->dev,
+			USBH_REQTYPE_CLASSOUT(USBH_REQTYPE_RECIP_INTERFACE),
+			USBH_CDC_REQ_SET_LINE_CODING,
+			0, acmp->ifnum, sizeof(coding), coding);
+}
+
+static usbh_urbstatus_t _set_control_line_state(USBHCDCACMDriver *acmp, uint8_t lines) {
+	return usbhControlRequest(acmp->dev,
+			USBH_REQTYPE_CLASSOUT(USBH_REQTYPE_RECIP_INTERFACE),
+			USBH_CDC_REQ_SET_CONTROL_LINE_STATE,
+			lines, acmp->ifnum, 0, NULL);
+}
+
+bool usbhcdcacmSetControlLines(USBHCDCACMDriver *acmp, uint8_t lines) {
+	osalDbgCheck(acmp != NULL);
+	osalDbgCheck((acmp->state == USBHCDCACM_STATE_ACTIVE)
+			|| (acmp->state == USBHCDCACM_STATE_READY));
+
+	osalMutexLock(&acmp->mtx);
+	usbh_urbstatus_t ret = _set_control_line_state(acmp, lines);
+	osalMutexUnlock(&acmp->mtx);
+
+	return (ret == USBH_URBSTATUS_OK) ? HAL_SUCCESS : HAL_FAILED;
+}
+
+/*===========================================================================*/
+/* Notifications.                                                            */
+/*===========================================================================*/
+
+static void _int_cb(usbh_urb_t *urb) {
+	USBHCDCACMDriver *const acmp = (USBHCDCACMDriver *)urb->userData;
+	switch (urb->status) {
+	case USBH_URBSTATUS_OK:
+		if (urb->actualLength >= sizeof(usbh_cdc_notification_t) + 2) {
+			const usbh_cdc_notification_t *const notif =
+					(const usbh_cdc_notification_t *)acmp->int_buff;
+			if (notif->bNotification == USBH_CDC_NOTIFY_SERIAL_STATE) {
+				acmp->serial_state = acmp->int_buff[sizeof(*notif)]
+						| (acmp->int_buff[sizeof(*notif) + 1] << 8);
+				uurbdbgf("CDC-ACM: SERIAL_STATE=%04x", acmp->serial_state);
+			}
+		}
+		break;
+	case USBH_URBSTATUS_DISCONNECTED:
+		uurbwarn("CDC-ACM: URB INT disconnected");
+		return;
+	case USBH_URBSTATUS_TIMEOUT:
+		break;
+	default:
+		uurberrf("CDC-ACM: URB INT status unexpected = %d", urb->status);
+		break;
+	}
+	usbhURBObjectResetI(urb);
+	usbhURBSubmitI(urb);
+}
+
+/*===========================================================================*/
+/* OUT pipeline.                                                             */
+/*===========================================================================*/
+
+static void _submitOutI(USBHCDCACMChannel *acmcp) {
+	usbhcdcacm_out_urb_t *const oq = &acmcp->oq[acmcp->oq_head];
+	uclassdrvdbgf("CDC-ACM: Submit OUT %d", oq->counter);
+	oq->urb.requestedLength = oq->counter;
+	usbhURBObjectResetI(&oq->urb);
+	usbhURBSubmitI(&oq->urb);
+	if (++acmcp->oq_head == HAL_USBHCDCACM_OUT_URBS)
+		acmcp->oq_head = 0;
+}
+
+static void _out_cb(usbh_urb_t *urb) {
+	USBHCDCACMChannel *const acmcp = (USBHCDCACMChannel *)urb->userData;
+	usbhcdcacm_out_urb_t *const oq = container_of(urb, usbhcdcacm_out_urb_t, urb);
+	switch (urb->status) {
+	case USBH_URBSTATUS_OK:
+		oq->counter = 0;
+		chThdDequeueNextI(&acmcp->oq_waiting, Q_OK);
+		return;
+	case USBH_URBSTATUS_DISCONNECTED:
+		uurbwarn("CDC-ACM: URB OUT disconnected");
+		chThdDequeueAllI(&acmcp->oq_waiting, Q_RESET);
+		return;
+	default:
+		uurberrf("CDC-ACM: URB OUT status unexpected = %d", urb->status);
+		break;
+	}
+	usbhURBObjectResetI(urb);
+	usbhURBSubmitI(urb);
+}
+
+/* Waits for the OUT URB being filled to be free, returns with the lock held */
+static msg_t _out_waitS(USBHCDCACMChannel *acmcp, systime_t timeout) {
+	USBHCDCACMDriver *const acmp = container_of(acmcp, USBHCDCACMDriver, channel);
+	while (true) {
+		if (acmp->state != USBHCDCACM_STATE_READY)
+			return Q_RESET;
+		if (!usbhURBIsBusy(&acmcp->oq[acmcp->oq_head].urb))
+			return Q_OK;
+		msg_t msg = chThdEnqueueTimeoutS(&acmcp->oq_waiting, timeout);
+		if (msg < Q_OK)
+			return msg;
+	}
+}
+
+static size_t _write_timeout(USBHCDCACMChannel *acmcp, const uint8_t *bp,
+		size_t n, systime_t timeout) {
+	chDbgCheck(n > 0U);
+
+	size_t w = 0;
+	osalSysLock();
+	while (true) {
+		if (_out_waitS(acmcp, timeout) != Q_OK) {
+			osalSysUnlock();
+			return w;
+		}
+
+		/* the URB is not busy and the flush timer leaves it alone while
+		 * filling, so the copy can be done unlocked */
+		usbhcdcacm_out_urb_t *const oq = &acmcp->oq[acmcp->oq_head];
+		size_t k = HAL_USBHCDCACM_OUT_URB_SIZE - oq->counter;
+		if (k > n)
+			k = n;
+		acmcp->oq_filling = true;
+		osalSysUnlock();
+
+		memcpy(&oq->buff[oq->counter], bp, k);
+
+		osalSysLock();
+		acmcp->oq_filling = false;
+		oq->counter += k;
+		if (oq->counter == HAL_USBHCDCACM_OUT_URB_SIZE) {
+			_submitOutI(acmcp);
+			osalOsRescheduleS();
+		}
+		osalSysUnlock(); /* Gives a preemption chance in a controlled point.*/
+
+		bp += k;
+		w += k;
+		n -= k;
+		if (n == 0U)
+			return w;
+
+		osalSysLock();
+	}
+}
+
+static msg_t _put_timeout(USBHCDCACMChannel *acmcp, uint8_t b, systime_t timeout) {
+
+	osalSysLock();
+	msg_t msg = _out_waitS(acmcp, timeout);
+	if (msg != Q_OK) {
+		osalSysUnlock();
+		return msg;
+	}
+
+	usbhcdcacm_out_urb_t *const oq = &acmcp->oq[acmcp->oq_head];
+	oq->buff[oq->counter++] = b;
+	if (oq->counter == HAL_USBHCDCACM_OUT_URB_SIZE) {
+		_submitOutI(acmcp);
+		osalOsRescheduleS();
+	}
+	osalSysUnlock();
+	return Q_OK;
+}
+
+static size_t _write(USBHCDCACMChannel *acmcp, const uint8_t *bp, size_t n) {
+	return _write_timeout(acmcp, bp, n, TIME_INFINITE);
+}
+
+static msg_t _put(USBHCDCACMChannel *acmcp, uint8_t b) {
+	return _put_timeout(acmcp, b, TIME_INFINITE);
+}
+
+/*===========================================================================*/
+/* IN pipeline.                                                              */
+/*===========================================================================*/
+
+/* Resubmits the consumed URBs in ring order, starting from the head */
+static void _in_refillI(USBHCDCACMChannel *acmcp) {
+	uint8_t i;
+	for (i = 0; i < HAL_USBHCDCACM_IN_URBS; i++) {
+		usbhcdcacm_in_urb_t *const iq = &acmcp->iq[acmcp->iq_head];
+		if (usbhURBIsBusy(&iq->urb) || (iq->counter != 0)
+				|| (iq->urb.status == USBH_URBSTATUS_DISCONNECTED))
+			break;
+		uclassdrvdbgf("CDC-ACM: Submit IN %d", acmcp->iq_head);
+		if (++acmcp->iq_head == HAL_USBHCDCACM_IN_URBS)
+			acmcp->iq_head = 0;
+		usbhURBObjectResetI(&iq->urb);
+		usbhURBSubmitI(&iq->urb);
+	}
+}
+
+static void _in_cb(usbh_urb_t *urb) {
+	USBHCDCACMChannel *const acmcp = (USBHCDCACMChannel *)urb->userData;
+	usbhcdcacm_in_urb_t *const iq = container_of(urb, usbhcdcacm_in_urb_t, urb);
+	switch (urb->status) {
+	case USBH_URBSTATUS_OK:
+		uurbdbgf("CDC-ACM: URB IN len=%d", urb->actualLength);
+		iq->counter = urb->actualLength;
+		iq->ptr = iq->buff;
+		if (iq->counter) {
+			chThdDequeueNextI(&acmcp->iq_waiting, Q_OK);
+			return;
+		}
+		break;
+	case USBH_URBSTATUS_DISCONNECTED:
+		uurbwarn("CDC-ACM: URB IN disconnected");
+		chThdDequeueAllI(&acmcp->iq_waiting, Q_RESET);
+		return;
+	default:
+		uurberrf("CDC-ACM: URB IN status unexpected = %d", urb->status);
+		break;
+	}
+	iq->counter = 0;
+	_in_refillI(acmcp);
+}
+
+/* Waits for data in the head URB, returns with the lock held */
+static msg_t _in_waitS(USBHCDCACMChannel *acmcp, systime_t timeout) {
+	USBHCDCACMDriver *const acmp = container_of(acmcp, USBHCDCACMDriver, channel);
+	while (true) {
+		if (acmp->state != USBHCDCACM_STATE_READY)
+			return Q_RESET;
+		_in_refillI(acmcp);
+		if (acmcp->iq[acmcp->iq_head].counter != 0)
+			return Q_OK;
+		msg_t msg = chThdEnqueueTimeoutS(&acmcp->iq_waiting, timeout);
+		if (msg < Q_OK)
+			return msg;
+	}
+}
+
+static void _in_consumeS(USBHCDCACMChannel *acmcp, usbhcdcacm_in_urb_t *iq,
+		uint32_t n) {
+	iq->ptr += n;
+	iq->counter -= n;
+	if (iq->counter == 0) {
+		_in_refillI(acmcp);
+		osalOsRescheduleS();
+	}
+}
+
+static size_t _read_timeout(USBHCDCACMChannel *acmcp, uint8_t *bp,
+		size_t n, systime_t timeout) {
+	size_t r = 0;
+
+	chDbgCheck(n > 0U);
+
+	osalSysLock();
+	while (true) {
+		if (_in_waitS(acmcp, timeout) != Q_OK) {
+			osalSysUnlock();
+			return r;
+		}
+
+		/* the head URB holds data, nobody else touches it until it is
+		 * consumed, so the copy can be done unlocked */
+		usbhcdcacm_in_urb_t *const iq = &acmcp->iq[acmcp->iq_head];
+		size_t k = iq->counter;
+		if (k > n)
+			k = n;
+		osalSysUnlock();
+
+		memcpy(bp, iq->ptr, k);
+
+		osalSysLock();
+		_in_consumeS(acmcp, iq, k);
+		osalSysUnlock();
+
+		bp += k;
+		r += k;
+		n -= k;
+		if (n == 0U)
+			return r;
+
+		osalSysLock();
+	}
+}
+
+static msg_t _get_timeout(USBHCDCACMChannel *acmcp, systime_t timeout) {
+	uint8_t b;
+
+	osalSysLock();
+	msg_t msg = _in_waitS(acmcp, timeout);
+	if (msg != Q_OK) {
+		osalSysUnlock();
+		return msg;
+	}
+	usbhcdcacm_in_urb_t *const iq = &acmcp->iq[acmcp->iq_head];
+	b = *iq->ptr;
+	_in_consumeS(acmcp, iq, 1);
+	osalSysUnlock();
+
+	return (msg_t)b;
+}
+
+static msg_t _get(USBHCDCACMChannel *acmcp) {
+	return _get_timeout(acmcp, TIME_INFINITE);
+}
+
+static size_t _read(USBHCDCACMChannel *acmcp, uint8_t *bp, size_t n) {
+	return _read_timeout(acmcp, bp, n, TIME_INFINITE);
+}
+
+static msg_t _ctl(USBHCDCACMChannel *acmcp, unsigned int operation, void *arg) {
+	(void)acmcp;
+	(void)operation;
+	(void)arg;
+	return MSG_OK;
+}
+
+/* Sends the partially filled OUT URB and restarts the IN pipeline */
+static void _vt(void *p) {
+	USBHCDCACMChannel *const acmcp = (USBHCDCACMChannel *)p;
+	osalSysLockFromISR();
+	usbhcdcacm_out_urb_t *const oq = &acmcp->oq[acmcp->oq_head];
+	if (oq->counter && !acmcp->oq_filling && !usbhURBIsBusy(&oq->urb)) {
+		_submitOutI(acmcp);
+	}
+	_in_refillI(acmcp);
+	chVTSetI(&acmcp->vt, HAL_USBHCDCACM_FLUSH_INTERVAL, _vt, acmcp);
+	osalSysUnlockFromISR();
+}
+
+static const struct CDCACMDriverVMT async_channel_vmt = {
+	(size_t)0,
+	(size_t (*)(void *, const uint8_t *, size_t))_write,
+	(size_t (*)(void *, uint8_t *, size_t))_read,
+	(msg_t (*)(void *, uint8_t))_put,
+	(msg_t (*)(void *))_get,
+	(msg_t (*)(void *, uint8_t, systime_t))_put_timeout,
+	(msg_t (*)(void *, systime_t))_get_timeout,
+	(size_t (*)(void *, const uint8_t *, size_t, systime_t))_write_timeout,
+	(size_t (*)(void *, uint8_t *, size_t, systime_t))_read_timeout,
+	(msg_t (*)(void *, unsigned int, void *))_ctl
+};
+
+
+static void _stopS(USBHCDCACMDriver *acmp) {
+	USBHCDCACMChannel *const acmcp = &acmp->channel;
+	if (acmp->state != USBHCDCACM_STATE_READY)
+		return;
+	chVTResetI(&acmcp->vt);
+	if (acmp->epint.status != USBH_EPSTATUS_UNINITIALIZED)
+		usbhEPCloseS(&acmp->epint);
+	usbhEPCloseS(&acmcp->epin);
+	usbhEPCloseS(&acmcp->epout);
+	chThdDequeueAllI(&acmcp->iq_waiting, Q_RESET);
+	chThdDequeueAllI(&acmcp->oq_waiting, Q_RESET);
+	acmp->state = USBHCDCACM_STATE_ACTIVE;
+	osalOsRescheduleS();
+}
+
+void usbhcdcacmStop(USBHCDCACMDriver *acmp) {
+	osalDbgCheck((acmp->state == USBHCDCACM_STATE_ACTIVE)
+			|| (acmp->state == USBHCDCACM_STATE_READY));
+
+	osalMutexLock(&acmp->mtx);
+	if (acmp->state == USBHCDCACM_STATE_READY)
+		_set_control_line_state(acmp, 0);
+	osalSysLock();
+	_stopS(acmp);
+	osalSysUnlock();
+	osalMutexUnlock(&acmp->mtx);
+}
+
+void usbhcdcacmStart(USBHCDCACMDriver *acmp, const USBHCDCACMConfig *config) {
+	static const USBHCDCACMConfig default_config = {
+		HAL_USBHCDCACM_DEFAULT_SPEED,
+		USBHCDCACM_STOP_BITS_1,
+		USBHCDCACM_PARITY_NONE,
+		8,
+		USBH_CDC_CONTROL_LINE_DTR | USBH_CDC_CONTROL_LINE_RTS
+	};
+	USBHCDCACMChannel *const acmcp = &acmp->channel;
+
+	osalDbgCheck((acmp->state == USBHCDCACM_STATE_ACTIVE)
+			|| (acmp->state == USBHCDCACM_STATE_READY));
+
+	if (acmp->state == USBHCDCACM_STATE_READY)
+		return;
+
+	osalMutexLock(&acmp->mtx);
+	if (config == NULL)
+		config = &default_config;
+
+	if (_set_line_coding(acmp, config) != USBH_URBSTATUS_OK) {
+		uclassdrvwarn("CDC-ACM: SET_LINE_CODING failed");
+	}
+	if (_set_control_line_state(acmp, config->control_lines) != USBH_URBSTATUS_OK) {
+		uclassdrvwarn("CDC-ACM: SET_CONTROL_LINE_STATE failed");
+	}
+
+	uint8_t i;
+	for (i = 0; i < HAL_USBHCDCACM_OUT_URBS; i++) {
+		usbhURBObjectInit(&acmcp->oq[i].urb, &acmcp->epout, _out_cb, acmcp, acmcp->oq[i].buff, 0);
+		acmcp->oq[i].counter = 0;
+	}
+	chThdQueueObjectInit(&acmcp->oq_waiting);
+	acmcp->oq_head = 0;
+	acmcp->oq_filling = false;
+	usbhEPOpen(&acmcp->epout);
+
+	for (i = 0; i < HAL_USBHCDCACM_IN_URBS; i++) {
+		usbhURBObjectInit(&acmcp->iq[i].urb, &acmcp->epin, _in_cb, acmcp, acmcp->iq[i].buff, HAL_USBHCDCACM_IN_URB_SIZE);
+		acmcp->iq[i].counter = 0;
+		acmcp->iq[i].ptr = acmcp->iq[i].buff;
+	}
+	chThdQueueObjectInit(&acmcp->iq_waiting);
+	acmcp->iq_head = 0;
+	usbhEPOpen(&acmcp->epin);
+
+	if (acmp->epint.status != USBH_EPSTATUS_UNINITIALIZED) {
+		usbhURBObjectInit(&acmp->int_urb, &acmp->epint, _int_cb, acmp,
+				acmp->int_buff, sizeof(acmp->int_buff));
+		usbhEPOpen(&acmp->epint);
+	}
+
+	chVTObjectInit(&acmcp->vt);
+
+	osalSysLock();
+	acmp->state = USBHCDCACM_STATE_READY;
+	if (acmp->epint.status != USBH_EPSTATUS_UNINITIALIZED)
+		usbhURBSubmitI(&acmp->int_urb);
+	_in_refillI(acmcp);
+	chVTSetI(&acmcp->vt, HAL_USBHCDCACM_FLUSH_INTERVAL, _vt, acmcp);
+	osalOsRescheduleS();
+	osalSysUnlock();
+
+	osalMutexUnlock(&acmp->mtx);
+}
+
+static void _acm_object_init(USBHCDCACMDriver *acmp) {
+	osalDbgCheck(acmp != NULL);
+	memset(acmp, 0, sizeof(*acmp));
+	acmp->info = &usbhcdcacmClassDriverInfo;
+	acmp->channel.vmt = &async_channel_vmt;
+	acmp->state = USBHCDCACM_STATE_STOP;
+	osalMutexObjectInit(&acmp->mtx);
+}
+
+static void _acm_init(void) {
+	uint8_t i;
+	for (i = 0; i < HAL_USBHCDCACM_MAX_INSTANCES; i++) {
+		_acm_object_init(&USBHCDCACMD[i]);
+	}
+}
+
+#endif
@@ -0,0 +1,862 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+              Copyright (C) 2015..2019 Diego Ismirlian, (dismirlian(at)google's mail)
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+
+#if HAL_USBH_USE_CDC_NCM
+
+#if !HAL_USE_USBH
+#error "USBHCDCNCM needs USBH"
+#endif
+
+#include <string.h>
+#include "usbh/dev/cdc_ncm.h"
+#include "usbh/internal.h"
+
+#define _USBH_DEBUG_HELPER_CLASS_DRIVER		ncmp
+#define _USBH_DEBUG_HELPER_ENABLE_TRACE		USBHCDCNCM_DEBUG_ENABLE_TRACE
+#define _USBH_DEBUG_HELPER_ENABLE_INFO		USBHCDCNCM_DEBUG_ENABLE_INFO
+#define _USBH_DEBUG_HELPER_ENABLE_WARNINGS	USBHCDCNCM_DEBUG_ENABLE_WARNINGS
+#define _USBH_DEBUG_HELPER_ENABLE_ERRORS	USBHCDCNCM_DEBUG_ENABLE_ERRORS
+#include "usbh/debug_helpers.h"
+
+
+static void _ncm_object_init(USBHCDCNCMDriver *ncmp);
+static void _stopS(USBHCDCNCMDriver *ncmp);
+
+/*===========================================================================*/
+/* USB Class driver loader for CDC-NCM						 		 	 	 */
+/*===========================================================================*/
+USBHCDCNCMDriver USBHCDCNCMD[HAL_USBHCDCNCM_MAX_INSTANCES];
+
+static void _ncm_init(void);
+static usbh_baseclassdriver_t *_ncm_load(usbh_device_t *dev, const uint8_t *descriptor, uint16_t rem);
+static void _ncm_unload(usbh_baseclassdriver_t *drv);
+
+static const usbh_classdriver_vmt_t class_driver_vmt = {
+	_ncm_init,
+	_ncm_load,
+	_ncm_unload
+};
+
+static const usbh_classdriver_match_t class_driver_matches[] = {
+	USBH_MATCH_INFO(USBH_DT_DEVICE, USBH_CDC_CLASS_COMM, -1, -1),
+	USBH_MATCH_INFO(USBH_DT_INTERFACE_ASSOCIATION, USBH_CDC_CLASS_COMM, USBH_CDC_SUBCLASS_NCM, -1),
+	USBH_MATCH_INFO(USBH_DT_INTERFACE, USBH_CDC_CLASS_COMM, USBH_CDC_SUBCLASS_NCM, -1),
+};
+
+const usbh_classdriverinfo_t usbhcdcncmClassDriverInfo = {
+	"CDC-NCM", &class_driver_vmt,
+	class_driver_matches, sizeof_array(class_driver_matches)
+};
+
+static usbh_baseclassdriver_t *_ncm_load(usbh_device_t *dev, const uint8_t *descriptor, uint16_t rem) {
+	int i;
+	int16_t target;
+	USBHCDCNCMDriver *ncmp;
+
+	/* the function may be offered as a whole device, as an IF collection or
+	 * as the Communications interface itself */
+	if (_usbh_match_descriptor(descriptor, rem, USBH_DT_DEVICE,
+			USBH_CDC_CLASS_COMM, -1, -1) == HAL_SUCCESS) {
+		target = -1;
+	} else if (_usbh_match_descriptor(descriptor, rem, USBH_DT_INTERFACE_ASSOCIATION,
+			USBH_CDC_CLASS_COMM, USBH_CDC_SUBCLASS_NCM, -1) == HAL_SUCCESS) {
+		target = ((const usbh_ia_descriptor_t *)descriptor)->bFirstInterface;
+	} else if (_usbh_match_descriptor(descriptor, rem, USBH_DT_INTERFACE,
+			USBH_CDC_CLASS_COMM, USBH_CDC_SUBCLASS_NCM, -1) == HAL_SUCCESS) {
+		target = ((const usbh_interface_descriptor_t *)descriptor)->bInterfaceNumber;
+	} else {
+		return NULL;
+	}
+
+	/* alloc driver */
+	for (i = 0; i < HAL_USBHCDCNCM_MAX_INSTANCES; i++) {
+		if (USBHCDCNCMD[i].dev == NULL) {
+			ncmp = &USBHCDCNCMD[i];
+			goto alloc_ok;
+		}
+	}
+
+	udevwarn("CDC-NCM: Can't alloc driver");
+
+	/* can't alloc */
+	return NULL;
+
+alloc_ok:
+	/* initialize the driver's variables */
+	usbhEPSetName(&dev->ctrl, "NCM[CTRL]");
+	ncmp->epint.status = USBH_EPSTATUS_UNINITIALIZED;
+	ncmp->epin.status = USBH_EPSTATUS_UNINITIALIZED;
+	ncmp->epout.status = USBH_EPSTATUS_UNINITIALIZED;
+	ncmp->mac_index = 0;
+
+	/* look the Communications interface up in the pre-parsed configuration;
+	 * the data interface is named by the Union functional descriptor, or
+	 * follows the Communications one. Its alternate setting 1 holds the bulk
+	 * endpoints */
+	const usbh_ifinfo_t *ifi = NULL;
+	while ((ifi = usbhDeviceMatchInterface(dev, ifi, USBH_CDC_CLASS_COMM,
+			USBH_CDC_SUBCLASS_NCM, -1)) != NULL) {
+		if ((target < 0) || (ifi->bInterfaceNumber == target))
+			break;
+	}
+	if (ifi == NULL) {
+		udevwarn("CDC-NCM: Communications Interface not found");
+		return NULL;
+	}
+
+	udevinfof("CDC-NCM: Communications Interface #%d", ifi->bInterfaceNumber);
+	ncmp->ifnum = ifi->bInterfaceNumber;
+	uint8_t data_if = ifi->bInterfaceNumber + 1;
+
+	generic_iterator_t ics;
+	for (ifinfo_cs_iter_init(&ics, dev, ifi); ics.valid; cs_iter_next(&ics)) {
+		const uint8_t *const fd = ics.curr;
+		if (fd[1] != USBH_CDC_DT_CS_INTERFACE)
+			continue;
+		if ((fd[2] == USBH_CDC_FD_UNION)
+				&& (fd[0] >= sizeof(usbh_cdc_union_descriptor_t))) {
+			data_if = ((const usbh_cdc_union_descriptor_t *)fd)->bSubordinateInterface0;
+		} else if ((fd[2] == USBH_CDC_FD_ETHERNET) && (fd[0] >= 4)) {
+			ncmp->mac_index = fd[3];
+		}
+	}
+
+	for (i = 0; i < ifi->ep_count; i++) {
+		const usbh_endpoint_descriptor_t *const epdesc = usbhIfEndpoint(dev, ifi, i);
+		if ((epdesc->bEndpointAddress & 0x80) && (epdesc->bmAttributes == USBH_EPTYPE_INT)) {
+			udevinfof("CDC-NCM: INT IN endpoint found: bEndpointAddress=%02x", epdesc->bEndpointAddress);
+			usbhEPObjectInit(&ncmp->epint, dev, epdesc);
+			usbhEPSetName(&ncmp->epint, "NCM[IIN ]");
+		}
+	}
+
+	ifi = usbhDeviceGetInterface(dev, data_if, 1);
+	if (ifi != NULL) {
+		udevinfof("CDC-NCM: Data Interface #%d", ifi->bInterfaceNumber);
+		ncmp->data_ifnum = ifi->bInterfaceNumber;
+		for (i = 0; i < ifi->ep_count; i++) {
+			const usbh_endpoint_descriptor_t *const epdesc = usbhIfEndpoint(dev, ifi, i);
+			if ((epdesc->bEndpointAddress & 0x80) && (epdesc->bmAttributes == USBH_EPTYPE_BULK)) {
+				udevinfof("CDC-NCM: BULK IN endpoint found: bEndpointAddress=%02x", epdesc->bEndpointAddress);
+				usbhEPObjectInit(&ncmp->epin, dev, epdesc);
+				usbhEPSetName(&ncmp->epin, "NCM[BIN ]");
+			} else if (((epdesc->bEndpointAddress & 0x80) == 0)
+					&& (epdesc->bmAttributes == USBH_EPTYPE_BULK)) {
+				udevinfof("CDC-NCM: BULK OUT endpoint found: bEndpointAddress=%02x", epdesc->bEndpointAddress);
+				usbhEPObjectInit(&ncmp->epout, dev, epdesc);
+				usbhEPSetName(&ncmp->epout, "NCM[BOUT]");
+			} else {
+				udevinfof("CDC-NCM: unsupported endpoint found: bEndpointAddress=%02x, bmAttributes=%02x",
+						epdesc->bEndpointAddress, epdesc->bmAttributes);
+			}
+		}
+	}
+
+	if ((ncmp->epin.status != USBH_EPSTATUS_CLOSED)
+			|| (ncmp->epout.status != USBH_EPSTATUS_CLOSED)) {
+		udevwarn("CDC-NCM: Couldn't find endpoints");
+		return NULL;
+	}
+
+	ncmp->state = USBHCDCNCM_STATE_ACTIVE;
+	return (usbh_baseclassdriver_t *)ncmp;
+}
+
+static void _ncm_unload(usbh_baseclassdriver_t *drv) {
+	osalDbgCheck(drv != NULL);
+	USBHCDCNCMDriver *const ncmp = (USBHCDCNCMDriver *)drv;
+
+	osalMutexLock(&ncmp->mtx);
+	osalSysLock();
+	_stopS(ncmp);
+	osalSysUnlock();
+	osalMutexUnlock(&ncmp->mtx);
+
+	osalSysLock();
+	_ncm_object_init(ncmp);
+	osalSysUnlock();
+}
+
+
+/*===========================================================================*/
+/* NTB16 format.                                                             */
+/*===========================================================================*/
+
+#define NTH16_SIGNATURE		0x484D434EUL	/* "NCMH" */
+#define NTH16_SIZE			12
+#define NDP16_SIGNATURE		0x304D434EUL	/* "NCM0", no CRC */
+#define NDP16_HEADER_SIZE	8
+#define NDP16_ENTRY_SIZE	4
+
+static inline uint16_t _rd16(const uint8_t *p) {
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t _rd32(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8)
+			| ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void _wr16(uint8_t *p, uint16_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void _wr32(uint8_t *p, uint32_t v) {
+	_wr16(p, (uint16_t)v);
+	_wr16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline uint32_t _align(uint32_t offset, uint32_t alignment) {
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+/* First offset at or after the given one that satisfies the device's
+ * datagram divisor/remainder rule */
+static inline uint32_t _align_payload(const USBHCDCNCMDriver *ncmp, uint32_t offset) {
+	uint32_t m = offset % ncmp->out_divisor;
+	uint32_t r = ncmp->out_remainder;
+	return offset + ((r + ncmp->out_divisor - m) % ncmp->out_divisor);
+}
+
+/* End of the NTB if the NDP for n datagrams followed the given offset */
+static inline uint32_t _ntb_end(const USBHCDCNCMDriver *ncmp, uint32_t offset, uint32_t n) {
+	return _align(offset, ncmp->out_alignment)
+			+ NDP16_HEADER_SIZE + (n + 1) * NDP16_ENTRY_SIZE;
+}
+
+
+/*===========================================================================*/
+/* Class requests.                                                           */
+/*===========================================================================*/
+
+static bool _get_ntb_parameters(USBHCDCNCMDriver *ncmp) {
+	USBH_DEFINE_BUFFER(usbh_cdc_ntb_parameters_t params);
+
+	if (usbhControlRequest(ncmp->dev,
+			USBH_REQTYPE_CLASSIN(USBH_REQTYPE_RECIP_INTERFACE),
+			USBH_CDC_REQ_GET_NTB_PARAMETERS,
+			0, ncmp->ifnum, sizeof(params), (uint8_t *)&params) != USBH_URBSTATUS_OK)
+		return HAL_FAILED;
+
+	if ((params.wLength < sizeof(params)) || !(params.bmNtbFormatsSupported & 1))
+		return HAL_FAILED;
+
+	uint32_t out_max = params.dwNtbOutMaxSize;
+	if ((out_max == 0) || (out_max > HAL_USBHCDCNCM_OUT_NTB_SIZE))
+		out_max = HAL_USBHCDCNCM_OUT_NTB_SIZE;
+	ncmp->out_max = (uint16_t)out_max;
+
+	/* the divisor and the alignment are powers of 2, at least 4 */
+	ncmp->out_divisor = params.wNdpOutDivisor;
+	if ((ncmp->out_divisor < 4) || (ncmp->out_divisor & (ncmp->out_divisor - 1)))
+		ncmp->out_divisor = 4;
+	ncmp->out_remainder = params.wNdpOutPayloadRemainder % ncmp->out_divisor;
+	ncmp->out_alignment = params.wNdpOutAlignment;
+	if ((ncmp->out_alignment < 4) || (ncmp->out_alignment & (ncmp->out_alignment - 1)))
+		ncmp->out_alignment = 4;
+
+	ncmp->out_max_datagrams = HAL_USBHCDCNCM_OUT_MAX_DATAGRAMS;
+	if ((params.wNtbOutMaxDatagrams != 0)
+			&& (params.wNtbOutMaxDatagrams < HAL_USBHCDCNCM_OUT_MAX_DATAGRAMS))
+		ncmp->out_max_datagrams = (uint8_t)params.wNtbOutMaxDatagrams;
+
+	uclassdrvinfof("CDC-NCM: NTB IN max=%d, OUT max=%d div=%d rem=%d align=%d dgrams=%d",
+			params.dwNtbInMaxSize, ncmp->out_max, ncmp->out_divisor,
+			ncmp->out_remainder, ncmp->out_alignment, ncmp->out_max_datagrams);
+
+	/* the IN URBs can't take bigger NTBs than ours */
+	if (params.dwNtbInMaxSize > HAL_USBHCDCNCM_IN_NTB_SIZE) {
+		USBH_DEFINE_BUFFER(uint8_t size[4]);
+		_wr32(size, HAL_USBHCDCNCM_IN_NTB_SIZE);
+		if (usbhControlRequest(ncmp->dev,
+				USBH_REQTYPE_CLASSOUT(USBH_REQTYPE_RECIP_INTERFACE),
+				USBH_CDC_REQ_SET_NTB_INPUT_SIZE,
+				0, ncmp->ifnum, sizeof(size), size) != USBH_URBSTATUS_OK)
+			return HAL_FAILED;
+	}
+
+	return HAL_SUCCESS;
+}
+
+/* iMACAddress is a string of 12 hex digits */
+static void _read_mac_address(USBHCDCNCMDriver *ncmp) {
+	char str[26];
+	uint8_t i;
+
+	if ((ncmp->mac_index == 0)
+			|| usbhDeviceReadString(ncmp->dev, str, sizeof(str), ncmp->mac_index, ncmp->dev->langID0)
+			|| (strlen(str) != 12)) {
+		uclassdrvwarn("CDC-NCM: Couldn't read MAC address");
+		return;
+	}
+
+	for (i = 0; i < 12; i++) {
+		char c = str[i];
+		uint8_t v;
+		if ((c >= '0') && (c <= '9'))
+			v = c - '0';
+		else if ((c >= 'A') && (c <= 'F'))
+			v = c - 'A' + 10;
+		else if ((c >= 'a') && (c <= 'f'))
+			v = c - 'a' + 10;
+		else
+			return;
+		if (i & 1)
+			ncmp->mac_address[i / 2] |= v;
+		else
+			ncmp->mac_address[i / 2] = v << 4;
+	}
+	uclassdrvinfof("CDC-NCM: MAC address %02x:%02x:%02x:%02x:%02x:%02x",
+			ncmp->mac_address[0], ncmp->mac_address[1], ncmp->mac_address[2],
+			ncmp->mac_address[3], ncmp->mac_address[4], ncmp->mac_address[5]);
+}
+
+/*===========================================================================*/
+/* Notifications.                                                            */
+/*===========================================================================*/
+
+static void _int_cb(usbh_urb_t *urb) {
+	USBHCDCNCMDriver *const ncmp = (USBHCDCNCMDriver *)urb->userData;
+	switch (urb->status) {
+	case USBH_URBSTATUS_OK:
+		if (urb->actualLength >= sizeof(usbh_cdc_notification_t)) {
+			const usbh_cdc_notification_t *const notif =
+					(const usbh_cdc_notification_t *)ncmp->int_buff;
+			switch (notif->bNotification) {
+			case USBH_CDC_NOTIFY_NETWORK_CONNECTION:
+				ncmp->link_up = notif->wValue != 0;
+				uurbinfof("CDC-NCM: Link %s", ncmp->link_up ? "up" : "down");
+				break;
+			case USBH_CDC_NOTIFY_SPEED_CHANGE:
+				if (urb->actualLength >= sizeof(*notif) + 8) {
+					ncmp->downlink_speed = _rd32(&ncmp->int_buff[sizeof(*notif)]);
+					ncmp->uplink_speed = _rd32(&ncmp->int_buff[sizeof(*notif) + 4]);
+					uurbinfof("CDC-NCM: Speed DL=%u, UL=%u",
+							ncmp->downlink_speed, ncmp->uplink_speed);
+				}
+				break;
+			default:
+				break;
+			}
+		}
+		break;
+	case USBH_URBSTATUS_DISCONNECTED:
+		uurbwarn("CDC-NCM: URB INT disconnected");
+		return;
+	case USBH_URBSTATUS_TIMEOUT:
+		break;
+	default:
+		uurberrf("CDC-NCM: URB INT status unexpected = %d", urb->status);
+		break;
+	}
+	usbhURBObjectResetI(urb);
+	usbhURBSubmitI(urb);
+}
+
+/*===========================================================================*/
+/* OUT pipeline.                                                             */
+/*===========================================================================*/
+
+/* Writes the NDP after the last datagram, then the NTH, and sends the NTB */
+static void _submitOutI(USBHCDCNCMDriver *ncmp, usbhcdcncm_out_ntb_t *oq) {
+	uint8_t *const buff = oq->buff;
+	uint32_t ndp = _align(oq->counter, ncmp->out_alignment);
+	uint8_t *p = &buff[ndp + NDP16_HEADER_SIZE];
+	uint8_t i, n = 0;
+
+	for (i = 0; i < oq->n; i++) {
+		/* released with zero length */
+		if (oq->dg[i][1] == 0)
+			continue;
+		_wr16(p, oq->dg[i][0]);
+		_wr16(p + 2, oq->dg[i][1]);
+		p += NDP16_ENTRY_SIZE;
+		n++;
+	}
+	_wr32(p, 0);
+	p += NDP16_ENTRY_SIZE;
+
+	uint32_t len = p - buff;
+	_wr32(&buff[ndp], NDP16_SIGNATURE);
+	_wr16(&buff[ndp + 4], NDP16_HEADER_SIZE + (n + 1) * NDP16_ENTRY_SIZE);
+	_wr16(&buff[ndp + 6], 0);
+
+	/* an NTB shorter than the maximum must end with a short packet */
+	if (((len % ncmp->epout.wMaxPacketSize) == 0) && (len < ncmp->out_max))
+		buff[len++] = 0;
+
+	_wr32(&buff[0], NTH16_SIGNATURE);
+	_wr16(&buff[4], NTH16_SIZE);
+	_wr16(&buff[6], ncmp->seq++);
+	_wr16(&buff[8], len);
+	_wr16(&buff[10], ndp);
+
+	uclassdrvdbgf("CDC-NCM: Submit OUT NTB, %d datagrams, %d bytes", n, len);
+	oq->urb.requestedLength = len;
+	usbhURBObjectResetI(&oq->urb);
+	usbhURBSubmitI(&oq->urb);
+}
+
+/* No more datagrams go in the NTB being filled, it is sent as soon as all
+ * its descriptors are released */
+static void _out_closeI(USBHCDCNCMDriver *ncmp) {
+	usbhcdcncm_out_ntb_t *const oq = &ncmp->oq[ncmp->oq_head];
+	oq->closed = true;
+	if (++ncmp->oq_head == HAL_USBHCDCNCM_OUT_NTBS)
+		ncmp->oq_head = 0;
+	if (oq->pending == 0)
+		_submitOutI(ncmp, oq);
+}
+
+static void _out_cb(usbh_urb_t *urb) {
+	USBHCDCNCMDriver *const ncmp = (USBHCDCNCMDriver *)urb->userData;
+	usbhcdcncm_out_ntb_t *const oq = container_of(urb, usbhcdcncm_out_ntb_t, urb);
+	switch (urb->status) {
+	case USBH_URBSTATUS_OK:
+		oq->counter = NTH16_SIZE;
+		oq->n = 0;
+		oq->closed = false;
+		chThdDequeueNextI(&ncmp->oq_waiting, MSG_OK);
+		return;
+	case USBH_URBSTATUS_DISCONNECTED:
+		uurbwarn("CDC-NCM: URB OUT disconnected");
+		chThdDequeueAllI(&ncmp->oq_waiting, MSG_RESET);
+		return;
+	default:
+		uurberrf("CDC-NCM: URB OUT status unexpected = %d", urb->status);
+		break;
+	}
+	usbhURBObjectResetI(urb);
+	usbhURBSubmitI(urb);
+}
+
+/**
+ * @brief   Reserves room for a frame in the NTB being filled.
+ * @details The frame is written in place through @p tdp->buf, frames are
+ *          packed in the same NTB until it is full, until the device's
+ *          datagram limit is reached or until the flush interval expires.
+ *
+ * @return              @p MSG_OK, @p MSG_TIMEOUT, or @p MSG_RESET if the
+ *                      driver is stopped or the frame can't fit an NTB.
+ */
+msg_t usbhcdcncmWaitTransmitDescriptor(USBHCDCNCMDriver *ncmp,
+		usbhcdcncm_tx_descriptor_t *tdp, size_t size, systime_t timeout) {
+	osalDbgCheck((ncmp != NULL) && (tdp != NULL) && (size > 0));
+
+	osalSysLock();
+	while (true) {
+		if (ncmp->state != USBHCDCNCM_STATE_READY) {
+			osalSysUnlock();
+			return MSG_RESET;
+		}
+
+		usbhcdcncm_out_ntb_t *const oq = &ncmp->oq[ncmp->oq_head];
+		if (usbhURBIsBusy(&oq->urb) || oq->closed) {
+			msg_t msg = chThdEnqueueTimeoutS(&ncmp->oq_waiting, timeout);
+			if (msg != MSG_OK) {
+				osalSysUnlock();
+				return msg;
+			}
+			continue;
+		}
+
+		uint32_t offset = _align_payload(ncmp, oq->counter);
+		if (_ntb_end(ncmp, offset + size, oq->n + 1) <= ncmp->out_max) {
+			tdp->ntb = oq;
+			tdp->dg = oq->n;
+			tdp->buf = &oq->buff[offset];
+			tdp->size = size;
+			oq->dg[oq->n][0] = (uint16_t)offset;
+			oq->dg[oq->n][1] = (uint16_t)size;
+			oq->counter = (uint16_t)(offset + size);
+			oq->pending++;
+			if (++oq->n == ncmp->out_max_datagrams)
+				_out_closeI(ncmp);
+			osalSysUnlock();
+			return MSG_OK;
+		}
+
+		if (oq->n == 0) {
+			osalSysUnlock();
+			return MSG_RESET;
+		}
+
+		_out_closeI(ncmp);
+		osalOsRescheduleS();
+	}
+}
+
+/**
+ * @brief   Commits a frame written through a transmit descriptor.
+ *
+ * @param[in] len       frame length, not bigger than the reserved size; zero
+ *                      drops the frame
+ */
+void usbhcdcncmReleaseTransmitDescriptor(USBHCDCNCMDriver *ncmp,
+		usbhcdcncm_tx_descriptor_t *tdp, size_t len) {
+	osalDbgCheck((ncmp != NULL) && (tdp != NULL) && (len <= tdp->size));
+
+	usbhcdcncm_out_ntb_t *const oq = tdp->ntb;
+	osalSysLock();
+	oq->dg[tdp->dg][1] = (uint16_t)len;
+	if ((--oq->pending == 0) && oq->closed
+			&& (ncmp->state == USBHCDCNCM_STATE_READY)) {
+		_submitOutI(ncmp, oq);
+		osalOsRescheduleS();
+	}
+	osalSysUnlock();
+}
+
+msg_t usbhcdcncmSend(USBHCDCNCMDriver *ncmp, const uint8_t *frame,
+		size_t len, systime_t timeout) {
+	usbhcdcncm_tx_descriptor_t td;
+	msg_t msg = usbhcdcncmWaitTransmitDescriptor(ncmp, &td, len, timeout);
+	if (msg != MSG_OK)
+		return msg;
+	memcpy(td.buf, frame, len);
+	usbhcdcncmReleaseTransmitDescriptor(ncmp, &td, len);
+	return MSG_OK;
+}
+
+/*===========================================================================*/
+/* IN pipeline.                                                              */
+/*===========================================================================*/
+
+/* Resubmits the free NTBs in ring order, so that they complete in the order
+ * they are unpacked */
+static void _in_refillI(USBHCDCNCMDriver *ncmp) {
+	uint8_t i;
+	for (i = 0; i < HAL_USBHCDCNCM_IN_NTBS; i++) {
+		usbhcdcncm_in_ntb_t *const iq = &ncmp->iq[ncmp->iq_tail];
+		if ((iq->state != USBHCDCNCM_IN_IDLE)
+				|| (iq->urb.status == USBH_URBSTATUS_DISCONNECTED))
+			break;
+		uclassdrvdbgf("CDC-NCM: Submit IN %d", ncmp->iq_tail);
+		if (++ncmp->iq_tail == HAL_USBHCDCNCM_IN_NTBS)
+			ncmp->iq_tail = 0;
+		iq->state = USBHCDCNCM_IN_BUSY;
+		usbhURBObjectResetI(&iq->urb);
+		usbhURBSubmitI(&iq->urb);
+	}
+}
+
+/* Validates the NTH, the NDPs are checked while they are walked */
+static uint16_t _in_check(const uint8_t *buff, uint32_t len) {
+	if ((len < NTH16_SIZE)
+			|| (_rd32(&buff[0]) != NTH16_SIGNATURE)
+			|| (_rd16(&buff[4]) != NTH16_SIZE))
+		return 0;
+	uint16_t block = _rd16(&buff[8]);
+	if ((block > len) || (block < NTH16_SIZE))
+		return 0;
+	return block;
+}
+
+static void _in_cb(usbh_urb_t *urb) {
+	USBHCDCNCMDriver *const ncmp = (USBHCDCNCMDriver *)urb->userData;
+	usbhcdcncm_in_ntb_t *const iq = container_of(urb, usbhcdcncm_in_ntb_t, urb);
+	iq->len = 0;
+	switch (urb->status) {
+	case USBH_URBSTATUS_OK:
+		iq->len = _in_check(iq->buff, urb->actualLength);
+		if (iq->len) {
+			iq->ndp = _rd16(&iq->buff[10]);
+			iq->dg = 0;
+			uurbdbgf("CDC-NCM: URB IN NTB len=%d", iq->len);
+		} else if (urb->actualLength) {
+			uurbwarnf("CDC-NCM: URB IN invalid NTB, len=%d", urb->actualLength);
+		}
+		break;
+	case USBH_URBSTATUS_DISCONNECTED:
+		uurbwarn("CDC-NCM: URB IN disconnected");
+		iq->state = USBHCDCNCM_IN_IDLE;
+		chThdDequeueAllI(&ncmp->iq_waiting, MSG_RESET);
+		return;
+	default:
+		uurberrf("CDC-NCM: URB IN status unexpected = %d", urb->status);
+		break;
+	}
+	/* even when empty, the NTB keeps its place in the ring */
+	iq->state = USBHCDCNCM_IN_FULL;
+	chThdDequeueNextI(&ncmp->iq_waiting, MSG_OK);
+}
+
+/* Walks the NDPs of an NTB, returns the next datagram or false when the
+ * NTB is exhausted */
+static bool _in_nextI(usbhcdcncm_in_ntb_t *iq, uint16_t *offset, uint16_t *len) {
+	const uint8_t *const buff = iq->buff;
+
+	while (iq->ndp) {
+		const uint32_t ndp = iq->ndp;
+		if ((ndp & 3) || (ndp + NDP16_HEADER_SIZE > iq->len)
+				|| ((_rd32(&buff[ndp]) & 0xFEFFFFFFUL) != NDP16_SIGNATURE))
+			break;
+
+		const uint32_t ndplen = _rd16(&buff[ndp + 4]);
+		const uint32_t entry = NDP16_HEADER_SIZE + iq->dg * NDP16_ENTRY_SIZE;
+		if ((ndp + ndplen <= iq->len) && (entry + NDP16_ENTRY_SIZE <= ndplen)) {
+			const uint16_t index = _rd16(&buff[ndp + entry]);
+			const uint16_t length = _rd16(&buff[ndp + entry + 2]);
+			if (index && length) {
+				iq->dg++;
+				if ((uint32_t)index + length > iq->len)
+					continue;
+				*offset = index;
+				*len = length;
+				return true;
+			}
+		}
+
+		/* next NDP; they are required to move forward to bound the walk */
+		const uint16_t next = _rd16(&buff[ndp + 6]);
+		if (next <= ndp)
+			break;
+		iq->ndp = next;
+		iq->dg = 0;
+	}
+	iq->ndp = 0;
+	return false;
+}
+
+/**
+ * @brief   Waits for a received frame.
+ * @details The frame is read in place from @p rdp->buf, the NTB holding it
+ *          is resubmitted when all its frames are released.
+ *
+ * @return              @p MSG_OK, @p MSG_TIMEOUT, or @p MSG_RESET if the
+ *                      driver is stopped.
+ */
+msg_t usbhcdcncmWaitReceiveDescriptor(USBHCDCNCMDriver *ncmp,
+		usbhcdcncm_rx_descriptor_t *rdp, systime_t timeout) {
+	osalDbgCheck((ncmp != NULL) && (rdp != NULL));
+
+	osalSysLock();
+	while (true) {
+		if (ncmp->state != USBHCDCNCM_STATE_READY) {
+			osalSysUnlock();
+			return MSG_RESET;
+		}
+
+		_in_refillI(ncmp);
+		usbhcdcncm_in_ntb_t *const iq = &ncmp->iq[ncmp->iq_head];
+		if (iq->state != USBHCDCNCM_IN_FULL) {
+			msg_t msg = chThdEnqueueTimeoutS(&ncmp->iq_waiting, timeout);
+			if (msg != MSG_OK) {
+				osalSysUnlock();
+				return msg;
+			}
+			continue;
+		}
+
+		uint16_t offset, len;
+		if (iq->len && _in_nextI(iq, &offset, &len)) {
+			iq->pending++;
+			rdp->ntb = iq;
+			rdp->buf = &iq->buff[offset];
+			rdp->size = len;
+			osalSysUnlock();
+			return MSG_OK;
+		}
+
+		/* exhausted, move to the next NTB */
+		iq->state = iq->pending ? USBHCDCNCM_IN_DONE : USBHCDCNCM_IN_IDLE;
+		if (++ncmp->iq_head == HAL_USBHCDCNCM_IN_NTBS)
+			ncmp->iq_head = 0;
+	}
+}
+
+void usbhcdcncmReleaseReceiveDescriptor(USBHCDCNCMDriver *ncmp,
+		usbhcdcncm_rx_descriptor_t *rdp) {
+	osalDbgCheck((ncmp != NULL) && (rdp != NULL));
+
+	usbhcdcncm_in_ntb_t *const iq = rdp->ntb;
+	osalSysLock();
+	osalDbgAssert(iq->pending > 0, "not pending");
+	if ((--iq->pending == 0) && (iq->state == USBHCDCNCM_IN_DONE)) {
+		iq->state = USBHCDCNCM_IN_IDLE;
+		if (ncmp->state == USBHCDCNCM_STATE_READY) {
+			_in_refillI(ncmp);
+			osalOsRescheduleS();
+		}
+	}
+	osalSysUnlock();
+}
+
+/**
+ * @brief   Receives a frame into a buffer.
+ *
+ * @param[in,out] lenp  size of the buffer on entry, length of the frame on
+ *                      exit; a longer frame is truncated
+ */
+msg_t usbhcdcncmReceive(USBHCDCNCMDriver *ncmp, uint8_t *frame,
+		size_t *lenp, systime_t timeout) {
+	usbhcdcncm_rx_descriptor_t rd;
+	msg_t msg = usbhcdcncmWaitReceiveDescriptor(ncmp, &rd, timeout);
+	if (msg != MSG_OK)
+		return msg;
+	if (*lenp > rd.size)
+		*lenp = rd.size;
+	memcpy(frame, rd.buf, *lenp);
+	usbhcdcncmReleaseReceiveDescriptor(ncmp, &rd);
+	return MSG_OK;
+}
+
+/* Sends the partially filled OUT NTB and restarts the IN pipeline */
+static void _vt(void *p) {
+	USBHCDCNCMDriver *const ncmp = (USBHCDCNCMDriver *)p;
+	osalSysLockFromISR();
+	usbhcdcncm_out_ntb_t *const oq = &ncmp->oq[ncmp->oq_head];
+	if (oq->n && !oq->closed && !usbhURBIsBusy(&oq->urb)) {
+		_out_closeI(ncmp);
+	}
+	_in_refillI(ncmp);
+	chVTSetI(&ncmp->vt, HAL_USBHCDCNCM_FLUSH_INTERVAL, _vt, ncmp);
+	osalSysUnlockFromISR();
+}
+
+
+static void _stopS(USBHCDCNCMDriver *ncmp) {
+	if (ncmp->state != USBHCDCNCM_STATE_READY)
+		return;
+	chVTResetI(&ncmp->vt);
+	if (ncmp->epint.status != USBH_EPSTATUS_UNINITIALIZED)
+		usbhEPCloseS(&ncmp->epint);
+	usbhEPCloseS(&ncmp->epin);
+	usbhEPCloseS(&ncmp->epout);
+	chThdDequeueAllI(&ncmp->iq_waiting, MSG_RESET);
+	chThdDequeueAllI(&ncmp->oq_waiting, MSG_RESET);
+	ncmp->link_up = false;
+	ncmp->state = USBHCDCNCM_STATE_ACTIVE;
+	osalOsRescheduleS();
+}
+
+void usbhcdcncmStop(USBHCDCNCMDriver *ncmp) {
+	osalDbgCheck((ncmp->state == USBHCDCNCM_STATE_ACTIVE)
+			|| (ncmp->state == USBHCDCNCM_STATE_READY));
+
+	osalMutexLock(&ncmp->mtx);
+	bool ready = ncmp->state == USBHCDCNCM_STATE_READY;
+	osalSysLock();
+	_stopS(ncmp);
+	osalSysUnlock();
+	if (ready)
+		usbhStdReqSetInterface(ncmp->dev, ncmp->data_ifnum, 0);
+	osalMutexUnlock(&ncmp->mtx);
+}
+
+void usbhcdcncmStart(USBHCDCNCMDriver *ncmp, const USBHCDCNCMConfig *config) {
+	static const USBHCDCNCMConfig default_config = {
+		USBHCDCNCM_FILTER_DIRECTED | USBHCDCNCM_FILTER_BROADCAST
+			| USBHCDCNCM_FILTER_ALL_MULTICAST
+	};
+
+	osalDbgCheck((ncmp->state == USBHCDCNCM_STATE_ACTIVE)
+			|| (ncmp->state == USBHCDCNCM_STATE_READY));
+
+	if (ncmp->state == USBHCDCNCM_STATE_READY)
+		return;
+
+	osalMutexLock(&ncmp->mtx);
+	if (config == NULL)
+		config = &default_config;
+
+	if (_get_ntb_parameters(ncmp) != HAL_SUCCESS) {
+		uclassdrverr("CDC-NCM: Couldn't set up the NTB parameters");
+		osalMutexUnlock(&ncmp->mtx);
+		return;
+	}
+	_read_mac_address(ncmp);
+
+	if (usbhControlRequest(ncmp->dev,
+			USBH_REQTYPE_CLASSOUT(USBH_REQTYPE_RECIP_INTERFACE),
+			USBH_CDC_REQ_SET_ETHERNET_PACKET_FILTER,
+			config->packet_filter, ncmp->ifnum, 0, NULL) != USBH_URBSTATUS_OK) {
+		uclassdrvwarn("CDC-NCM: SET_ETHERNET_PACKET_FILTER failed");
+	}
+
+	/* the data interface carries traffic on its alternate setting 1 */
+	if (usbhStdReqSetInterface(ncmp->dev, ncmp->data_ifnum, 1) != HAL_SUCCESS) {
+		uclassdrverr("CDC-NCM: Couldn't select the data alternate setting");
+		osalMutexUnlock(&ncmp->mtx);
+		return;
+	}
+
+	uint8_t i;
+	for (i = 0; i < HAL_USBHCDCNCM_OUT_NTBS; i++) {
+		usbhURBObjectInit(&ncmp->oq[i].urb, &ncmp->epout, _out_cb, ncmp, ncmp->oq[i].buff, 0);
+		ncmp->oq[i].counter = NTH16_SIZE;
+		ncmp->oq[i].n = 0;
+		ncmp->oq[i].pending = 0;
+		ncmp->oq[i].closed = false;
+	}
+	chThdQueueObjectInit(&ncmp->oq_waiting);
+	ncmp->oq_head = 0;
+	ncmp->seq = 0;
+	usbhEPOpen(&ncmp->epout);
+
+	for (i = 0; i < HAL_USBHCDCNCM_IN_NTBS; i++) {
+		usbhURBObjectInit(&ncmp->iq[i].urb, &ncmp->epin, _in_cb, ncmp, ncmp->iq[i].buff, HAL_USBHCDCNCM_IN_NTB_SIZE);
+		ncmp->iq[i].state = USBHCDCNCM_IN_IDLE;
+		ncmp->iq[i].len = 0;
+		ncmp->iq[i].pending = 0;
+	}
+	chThdQueueObjectInit(&ncmp->iq_waiting);
+	ncmp->iq_head = 0;
+	ncmp->iq_tail = 0;
+	usbhEPOpen(&ncmp->epin);
+
+	if (ncmp->epint.status != USBH_EPSTATUS_UNINITIALIZED) {
+		usbhURBObjectInit(&ncmp->int_urb, &ncmp->epint, _int_cb, ncmp,
+				ncmp->int_buff, sizeof(ncmp->int_buff));
+		usbhEPOpen(&ncmp->epint);
+	} else {
+		ncmp->link_up = true;
+	}
+
+	chVTObjectInit(&ncmp->vt);
+
+	osalSysLock();
+	ncmp->state = USBHCDCNCM_STATE_READY;
+	if (ncmp->epint.status != USBH_EPSTATUS_UNINITIALIZED)
+		usbhURBSubmitI(&ncmp->int_urb);
+	_in_refillI(ncmp);
+	chVTSetI(&ncmp->vt, HAL_USBHCDCNCM_FLUSH_INTERVAL, _vt, ncmp);
+	osalOsRescheduleS();
+	osalSysUnlock();
+
+	osalMutexUnlock(&ncmp->mtx);
+}
+
+static void _ncm_object_init(USBHCDCNCMDriver *ncmp) {
+	osalDbgCheck(ncmp != NULL);
+	memset(ncmp, 0, sizeof(*ncmp));
+	ncmp->info = &usbhcdcncmClassDriverInfo;
+	ncmp->state = USBHCDCNCM_STATE_STOP;
+	osalMutexObjectInit(&ncmp->mtx);
+}
+
+static void _ncm_init(void) {
+	uint8_t i;
+	for (i = 0; i < HAL_USBHCDCNCM_MAX_INSTANCES; i++) {
+		_ncm_object_init(&USBHCDCNCMD[i]);
+	}
+}
+
+#endif
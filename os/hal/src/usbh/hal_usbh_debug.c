@@ -23,9 +23,18 @@
 #include "usbh/debug.h"
 #include "chprintf.h"
 #include <stdarg.h>
+#include <string.h>
 
 #define TEMP_BUFF_LEN	255
 
+#if USBH_DEBUG_MULTI_HOST
+#define dbg_output(b, len)	USBH_DEBUG_OUTPUT_CALLBACK(host, b, len)
+#else
+#define dbg_output(b, len)	USBH_DEBUG_OUTPUT_CALLBACK(b, len)
+#endif
+
+#if !USBH_DEBUG_BINARY
+
 /* ************************ */
 /* Circular queue structure */
 /* ************************ */
@@ -161,16 +170,6 @@ void usbDbgPuts(const char *s) {
 	dbg_epilogue(debug, sts, len);
 }
 
-#if USBH_DEBUG_MULTI_HOST
-void usbDbgEnable(USBHDriver *host, bool enable) {
-	struct usbh_debug_helper *const debug = &host->debug;
-#else
-void usbDbgEnable(bool enable) {
-	struct usbh_debug_helper *const debug = &usbh_debug;
-#endif
-	debug->on = enable;
-}
-
 static void usb_debug_thread(void *arg) {
 #if USBH_DEBUG_MULTI_HOST
 	USBHDriver *const host = (USBHDriver *)arg;
@@ -192,15 +191,336 @@ static void usb_debug_thread(void *arg) {
 		} else {
 			dq_remove_oldest_string(&debug->dq);
 			chSysUnlock();
+			dbg_output(rdbuff, len);
+		}
+	}
+}
+
+#else
+
+/* ****************** */
+/* Binary trace ring  */
+/* ****************** */
+#define RING_MASK	(USBH_DEBUG_BINARY_ENTRIES - 1)
+
+/* raw record sent with USBH_DEBUG_BINARY_RAW, little endian, followed by
+ * len bytes of arguments (or text); see tools/usbh_trace_decode.py */
+#define RAW_MAGIC		0xa5
+#define RAW_FLAG_LOST	(1 << 7)	/* fmt holds the count of lost entries */
+
+typedef __PACKED_STRUCT {
+	uint8_t magic;
+	uint8_t flags;
+	uint8_t len;
+	uint8_t reserved;
+	uint32_t fmt;
+	uint32_t time;
+	uint32_t hfnum;
+	uint16_t hfir;
+	uint16_t reserved2;
+} usbh_dbg_raw_t;
+
+static usbh_dbg_entry_t *trace_begin(struct usbh_debug_helper *debug,
+		uint32_t hfnum, uint16_t hfir, const char *fmt, uint8_t flags,
+		uint32_t *idx) {
+	/* ISRs and threads race for the slots, the atomic increment gives each
+	 * of them its own one; no lock is taken */
+	*idx = __atomic_fetch_add(&debug->head, 1, __ATOMIC_RELAXED);
+	usbh_dbg_entry_t *const e = &debug->ring[*idx & RING_MASK];
+
+	/* invalidate the slot while it's being written */
+	__atomic_store_n(&e->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	e->fmt = fmt;
+	e->time = osalOsGetSystemTimeX();
+	e->hfnum = hfnum;
+	e->hfir = hfir;
+	e->flags = flags;
+	e->nargs = 0;
+	return e;
+}
+
+static inline void trace_end(usbh_dbg_entry_t *e, uint32_t idx) {
+	__atomic_store_n(&e->seq, idx + 1, __ATOMIC_RELEASE);
+}
+
+static void trace_record(struct usbh_debug_helper *debug,
+		uint32_t hfnum, uint16_t hfir, const char *fmt, unsigned nargs, va_list ap) {
+	uint32_t idx;
+	usbh_dbg_entry_t *const e = trace_begin(debug, hfnum, hfir, fmt, 0, &idx);
+
+	if (nargs > USBH_DEBUG_BINARY_MAX_ARGS)
+		nargs = USBH_DEBUG_BINARY_MAX_ARGS;
+	for (unsigned i = 0; i < nargs; i++)
+		e->u.args[i] = va_arg(ap, uint32_t);
+	e->nargs = nargs;
+
+	trace_end(e, idx);
+}
+
+static void trace_record_string(struct usbh_debug_helper *debug,
+		uint32_t hfnum, uint16_t hfir, const char *fmt, const char *s) {
+	uint32_t idx;
+	usbh_dbg_entry_t *const e = trace_begin(debug, hfnum, hfir, fmt,
+			USBH_DBG_ENTRY_TEXT, &idx);
+
+	size_t len = strnlen(s, sizeof(e->u.text) - 1);
+	memcpy(e->u.text, s, len);
+	e->u.text[len] = 0;
+	e->nargs = len;
+
+	trace_end(e, idx);
+}
+
+/* arguments consumed by a format string, for the callers of usbDbgPrintf */
+static unsigned count_args(const char *fmt) {
+	unsigned n = 0;
+	while (*fmt) {
+		if (*fmt++ != '%')
+			continue;
+		if (*fmt == '%') {
+			fmt++;
+			continue;
+		}
+		while (*fmt && !(((*fmt | 0x20) >= 'a') && ((*fmt | 0x20) <= 'z'))) {
+			if (*fmt++ == '*')
+				n++;
+		}
+		while ((*fmt == 'l') || (*fmt == 'h'))
+			fmt++;
+		if (*fmt) {
+			fmt++;
+			n++;
+		}
+	}
+	return n;
+}
+
+#if USBH_DEBUG_MULTI_HOST
+void usbDbgTrace(USBHDriver *host, const char *fmt, unsigned nargs, ...) {
+	if (!host) return;
+	struct usbh_debug_helper *const debug = &host->debug;
+	uint32_t hfnum = host->otg->HFNUM;
+	uint16_t hfir = host->otg->HFIR;
+#else
+void usbDbgTrace(const char *fmt, unsigned nargs, ...) {
+	struct usbh_debug_helper *const debug = &usbh_debug;
+	uint32_t hfnum = USBH_DEBUG_SINGLE_HOST_SELECTION.otg->HFNUM;
+	uint16_t hfir = USBH_DEBUG_SINGLE_HOST_SELECTION.otg->HFIR;
+#endif
+	va_list ap;
+	va_start(ap, nargs);
+	trace_record(debug, hfnum, hfir, fmt, nargs, ap);
+	va_end(ap);
+}
+
+#if USBH_DEBUG_MULTI_HOST
+void usbDbgTraceString(USBHDriver *host, const char *fmt, const char *s) {
+	if (!host) return;
+	struct usbh_debug_helper *const debug = &host->debug;
+	uint32_t hfnum = host->otg->HFNUM;
+	uint16_t hfir = host->otg->HFIR;
+#else
+void usbDbgTraceString(const char *fmt, const char *s) {
+	struct usbh_debug_helper *const debug = &usbh_debug;
+	uint32_t hfnum = USBH_DEBUG_SINGLE_HOST_SELECTION.otg->HFNUM;
+	uint16_t hfir = USBH_DEBUG_SINGLE_HOST_SELECTION.otg->HFIR;
+#endif
+	trace_record_string(debug, hfnum, hfir, fmt, s);
+}
+
 #if USBH_DEBUG_MULTI_HOST
-			USBH_DEBUG_OUTPUT_CALLBACK(host, rdbuff, len);
+void usbDbgPrintf(USBHDriver *host, const char *fmt, ...) {
+	if (!host) return;
+	struct usbh_debug_helper *const debug = &host->debug;
+	uint32_t hfnum = host->otg->HFNUM;
+	uint16_t hfir = host->otg->HFIR;
 #else
-			USBH_DEBUG_OUTPUT_CALLBACK(rdbuff, len);
+void usbDbgPrintf(const char *fmt, ...) {
+	struct usbh_debug_helper *const debug = &usbh_debug;
+	uint32_t hfnum = USBH_DEBUG_SINGLE_HOST_SELECTION.otg->HFNUM;
+	uint16_t hfir = USBH_DEBUG_SINGLE_HOST_SELECTION.otg->HFIR;
 #endif
+	va_list ap;
+	va_start(ap, fmt);
+	trace_record(debug, hfnum, hfir, fmt, count_args(fmt), ap);
+	va_end(ap);
+}
+
+#if USBH_DEBUG_MULTI_HOST
+void usbDbgPuts(USBHDriver *host, const char *s) {
+	if (!host) return;
+	struct usbh_debug_helper *const debug = &host->debug;
+	uint32_t hfnum = host->otg->HFNUM;
+	uint16_t hfir = host->otg->HFIR;
+#else
+void usbDbgPuts(const char *s) {
+	struct usbh_debug_helper *const debug = &usbh_debug;
+	uint32_t hfnum = USBH_DEBUG_SINGLE_HOST_SELECTION.otg->HFNUM;
+	uint16_t hfir = USBH_DEBUG_SINGLE_HOST_SELECTION.otg->HFIR;
+#endif
+	uint32_t idx;
+	usbh_dbg_entry_t *const e = trace_begin(debug, hfnum, hfir, s,
+			USBH_DBG_ENTRY_PUTS, &idx);
+	trace_end(e, idx);
+}
+
+/* copies the oldest complete entry; entries overwritten before or while
+ * being copied are accounted in debug->lost */
+static bool trace_read(struct usbh_debug_helper *debug, usbh_dbg_entry_t *e) {
+	while (true) {
+		uint32_t head = __atomic_load_n(&debug->head, __ATOMIC_ACQUIRE);
+		uint32_t tail = debug->tail;
+
+		if (head == tail)
+			return false;
+
+		if (head - tail > USBH_DEBUG_BINARY_ENTRIES) {
+			debug->lost += head - USBH_DEBUG_BINARY_ENTRIES - tail;
+			tail = head - USBH_DEBUG_BINARY_ENTRIES;
+		}
+
+		usbh_dbg_entry_t *const s = &debug->ring[tail & RING_MASK];
+		uint32_t seq = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+		if (seq != tail + 1) {
+			if ((seq == 0) || ((int32_t)(seq - (tail + 1)) < 0)) {
+				/* reserved but not yet written, retry later */
+				debug->tail = tail;
+				return false;
+			}
+			debug->lost++;
+			debug->tail = tail + 1;
+			continue;
+		}
+
+		memcpy(e, (const void *)s, sizeof(*e));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		debug->tail = tail + 1;
+		if (__atomic_load_n(&s->seq, __ATOMIC_RELAXED) != seq) {
+			debug->lost++;
+			continue;
 		}
+		return true;
 	}
 }
 
+#if USBH_DEBUG_BINARY_RAW
+static size_t trace_raw(const usbh_dbg_entry_t *e, uint8_t *buff) {
+	usbh_dbg_raw_t *const r = (usbh_dbg_raw_t *)buff;
+	r->magic = RAW_MAGIC;
+	r->flags = e->flags;
+	r->len = (e->flags & USBH_DBG_ENTRY_TEXT) ? e->nargs : e->nargs * 4;
+	r->reserved = 0;
+	r->fmt = (uint32_t)(uintptr_t)e->fmt;
+	r->time = (uint32_t)e->time;
+	r->hfnum = e->hfnum;
+	r->hfir = e->hfir;
+	r->reserved2 = 0;
+	memcpy(buff + sizeof(*r), &e->u, r->len);
+	return sizeof(*r) + r->len;
+}
+
+static size_t trace_raw_lost(uint32_t lost, uint8_t *buff) {
+	usbh_dbg_raw_t *const r = (usbh_dbg_raw_t *)buff;
+	memset(r, 0, sizeof(*r));
+	r->magic = RAW_MAGIC;
+	r->flags = RAW_FLAG_LOST;
+	r->fmt = lost;
+	return sizeof(*r);
+}
+#else
+static size_t trace_format(struct usbh_debug_helper *debug,
+		const usbh_dbg_entry_t *e, char *buff, size_t sz) {
+	size_t len;
+
+	debug->last = e->time;
+	if (debug->ena) {
+		debug->first = debug->last;
+	}
+
+	if (((e->hfnum & 0x3fff) == 0x3fff) && (e->hfir == (e->hfnum >> 16))) {
+		len = chsnprintf(buff, sz, "+%08d ", debug->last - debug->first);
+		debug->ena = FALSE;
+	} else {
+		uint32_t f = e->hfnum & 0xffff;
+		uint32_t p = 1000 - ((e->hfnum >> 16) / (e->hfir / 1000));
+		len = chsnprintf(buff, sz, "%05d.%03d ", f, p);
+		debug->ena = TRUE;
+	}
+	if (len >= sz)
+		return sz - 1;
+
+	if (e->flags & USBH_DBG_ENTRY_PUTS) {
+		len += chsnprintf(buff + len, sz - len, "%s", e->fmt);
+	} else if (e->flags & USBH_DBG_ENTRY_TEXT) {
+		len += chsnprintf(buff + len, sz - len, e->fmt, e->u.text);
+	} else {
+		uint32_t a[8] = {0};
+		memcpy(a, e->u.args, e->nargs * 4);
+		len += chsnprintf(buff + len, sz - len, e->fmt,
+				a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+	}
+	return (len >= sz) ? sz - 1 : len;
+}
+#endif
+
+static void usb_debug_thread(void *arg) {
+#if USBH_DEBUG_MULTI_HOST
+	USBHDriver *const host = (USBHDriver *)arg;
+	struct usbh_debug_helper *const debug = &host->debug;
+#else
+	(void)arg;
+	struct usbh_debug_helper *const debug = &usbh_debug;
+#endif
+
+	usbh_dbg_entry_t e;
+#if USBH_DEBUG_BINARY_RAW
+	uint8_t rdbuff[sizeof(usbh_dbg_raw_t) + sizeof(e.u)];
+#else
+	uint8_t rdbuff[TEMP_BUFF_LEN + 1];
+#endif
+	size_t len;
+
+	chRegSetThreadName("USBH_DBG");
+	while (true) {
+		if (!debug->on || !trace_read(debug, &e)) {
+			chThdSleep(USBH_DEBUG_BINARY_POLL_INTERVAL);
+			continue;
+		}
+
+		if (debug->lost) {
+#if USBH_DEBUG_BINARY_RAW
+			len = trace_raw_lost(debug->lost, rdbuff);
+#else
+			len = chsnprintf((char *)rdbuff, sizeof(rdbuff),
+					"--- %u trace entries lost ---", debug->lost);
+#endif
+			debug->lost = 0;
+			dbg_output(rdbuff, len);
+		}
+
+#if USBH_DEBUG_BINARY_RAW
+		len = trace_raw(&e, rdbuff);
+#else
+		len = trace_format(debug, &e, (char *)rdbuff, sizeof(rdbuff));
+#endif
+		dbg_output(rdbuff, len);
+	}
+}
+
+#endif
+
+#if USBH_DEBUG_MULTI_HOST
+void usbDbgEnable(USBHDriver *host, bool enable) {
+	struct usbh_debug_helper *const debug = &host->debug;
+#else
+void usbDbgEnable(bool enable) {
+	struct usbh_debug_helper *const debug = &usbh_debug;
+#endif
+	debug->on = enable;
+}
+
 #if USBH_DEBUG_MULTI_HOST
 void usbDbgInit(USBHDriver *host) {
 	struct usbh_debug_helper *const debug = &host->debug;
@@ -210,7 +530,11 @@ void usbDbgInit(void) {
 	struct usbh_debug_helper *const debug = &usbh_debug;
 	void *param = NULL;
 #endif
+#if USBH_DEBUG_BINARY
+	debug->head = debug->tail = debug->lost = 0;
+#else
 	dq_init(&debug->dq, debug->buff, sizeof(debug->buff));
+#endif
 	debug->on = true;
 	chThdCreateStatic(debug->thd_wa, sizeof(debug->thd_wa),
 			NORMALPRIO, usb_debug_thread, param);
@@ -52,8 +52,18 @@ static const usbh_classdriver_vmt_t class_driver_vmt = {
 	_ftdi_unload
 };
 
+static const usbh_classdriver_match_t class_driver_matches[] = {
+	USBH_MATCH(USBH_DT_INTERFACE, 0x0403, 0x6001, 0xff, 0xff, 0xff),
+	USBH_MATCH(USBH_DT_INTERFACE, 0x0403, 0x6010, 0xff, 0xff, 0xff),
+	USBH_MATCH(USBH_DT_INTERFACE, 0x0403, 0x6011, 0xff, 0xff, 0xff),
+	USBH_MATCH(USBH_DT_INTERFACE, 0x0403, 0x6014, 0xff, 0xff, 0xff),
+	USBH_MATCH(USBH_DT_INTERFACE, 0x0403, 0x6015, 0xff, 0xff, 0xff),
+	USBH_MATCH(USBH_DT_INTERFACE, 0x0403, 0xE2E6, 0xff, 0xff, 0xff),
+};
+
 const usbh_classdriverinfo_t usbhftdiClassDriverInfo = {
-	"FTDI", &class_driver_vmt
+	"FTDI", &class_driver_vmt,
+	class_driver_matches, sizeof_array(class_driver_matches)
 };
 
 static USBHFTDIPortDriver *_find_port(void) {
@@ -133,13 +143,11 @@ alloc_ok:
 	}
 	usbhEPSetName(&dev->ctrl, "FTD[CTRL]");
 
-	/* parse the configuration descriptor */
-	generic_iterator_t iep, icfg;
-	if_iterator_t iif;
-	cfg_iter_init(&icfg, dev->fullConfigurationDescriptor, dev->basicConfigDesc.wTotalLength);
-	for (if_iter_init(&iif, &icfg); iif.valid; if_iter_next(&iif)) {
-		const usbh_interface_descriptor_t *const ifdesc = if_get(&iif);
-		udevinfof("FTDI: Interface #%d", ifdesc->bInterfaceNumber);
+	/* walk the pre-parsed configuration */
+	uint8_t j;
+	for (i = 0; i < dev->num_ifs; i++) {
+		const usbh_ifinfo_t *const ifi = &dev->ifs[i];
+		udevinfof("FTDI: Interface #%d", ifi->bInterfaceNumber);
 
 		USBHFTDIPortDriver *const prt = _find_port();
 		if (prt == NULL) {
@@ -147,12 +155,12 @@ alloc_ok:
 			break;
 		}
 
-		prt->ifnum = ifdesc->bInterfaceNumber;
+		prt->ifnum = ifi->bInterfaceNumber;
 		prt->epin.status = USBH_EPSTATUS_UNINITIALIZED;
 		prt->epout.status = USBH_EPSTATUS_UNINITIALIZED;
 
-		for (ep_iter_init(&iep, &iif); iep.valid; ep_iter_next(&iep)) {
-			const usbh_endpoint_descriptor_t *const epdesc = ep_get(&iep);
+		for (j = 0; j < ifi->ep_count; j++) {
+			const usbh_endpoint_descriptor_t *const epdesc = usbhIfEndpoint(dev, ifi, j);
 			if ((epdesc->bEndpointAddress & 0x80) && (epdesc->bmAttributes == USBH_EPTYPE_BULK)) {
 				udevinfof("BULK IN endpoint found: bEndpointAddress=%02x", epdesc->bEndpointAddress);
 				usbhEPObjectInit(&prt->epin, dev, epdesc);
@@ -227,12 +235,13 @@ USBHFTDIPortDriver FTDIPD[HAL_USBHFTDI_MAX_PORTS];
 #define FTDI_COMMAND_SETDATA    4
 #define FTDI_SETDATA_BREAK      (0x1 << 14)
 
+#define FTDI_COMMAND_SETLATENCYTIMER      9 /* Set the latency timer */
+
 #if 0
 #define FTDI_COMMAND_MODEMCTRL  	1
 #define FTDI_COMMAND_GETMODEMSTATUS       5 /* Retrieve current value of modem status register */
 #define FTDI_COMMAND_SETEVENTCHAR         6 /* Set the event character */
 #define FTDI_COMMAND_SETERRORCHAR         7 /* Set the error character */
-#define FTDI_COMMAND_SETLATENCYTIMER      9 /* Set the latency timer */
 #define FTDI_COMMAND_GETLATENCYTIMER      10 /* Get the latency timer */
 #endif
 
@@ -375,20 +384,38 @@ static usbh_urbstatus_t _set_baudrate(USBHFTDIPortDriver *ftdipp, uint32_t baudr
 	return usbhControlRequestExtended(ftdipp->ftdip->dev, &req, NULL, NULL, OSAL_MS2I(1000));
 }
 
+static usbh_urbstatus_t _set_latency_timer(USBHFTDIPortDriver *ftdipp, uint8_t ms) {
+	USBH_DEFINE_BUFFER(const usbh_control_request_t req) = {
+		USBH_REQTYPE_TYPE_VENDOR | USBH_REQTYPE_DIR_OUT | USBH_REQTYPE_RECIP_DEVICE,
+		FTDI_COMMAND_SETLATENCYTIMER,
+		ms,
+		ftdipp->ifnum + 1,
+		0
+	};
+	return usbhControlRequestExtended(ftdipp->ftdip->dev, &req, NULL, NULL, OSAL_MS2I(1000));
+}
+
+
+/*===========================================================================*/
+/* OUT pipeline.                                                             */
+/*===========================================================================*/
 
-static void _submitOutI(USBHFTDIPortDriver *ftdipp, uint32_t len) {
-	uclassdrvdbgf("FTDI: Submit OUT %d", len);
-	ftdipp->oq_urb.requestedLength = len;
-	usbhURBObjectResetI(&ftdipp->oq_urb);
-	usbhURBSubmitI(&ftdipp->oq_urb);
+static void _submitOutI(USBHFTDIPortDriver *ftdipp) {
+	usbhftdi_out_urb_t *const oq = &ftdipp->oq[ftdipp->oq_head];
+	uclassdrvdbgf("FTDI: Submit OUT %d", oq->counter);
+	oq->urb.requestedLength = oq->counter;
+	usbhURBObjectResetI(&oq->urb);
+	usbhURBSubmitI(&oq->urb);
+	if (++ftdipp->oq_head == HAL_USBHFTDI_OUT_URBS)
+		ftdipp->oq_head = 0;
 }
 
 static void _out_cb(usbh_urb_t *urb) {
 	USBHFTDIPortDriver *const ftdipp = (USBHFTDIPortDriver *)urb->userData;
+	usbhftdi_out_urb_t *const oq = container_of(urb, usbhftdi_out_urb_t, urb);
 	switch (urb->status) {
 	case USBH_URBSTATUS_OK:
-		ftdipp->oq_ptr = ftdipp->oq_buff;
-		ftdipp->oq_counter = 64;
+		oq->counter = 0;
 		chThdDequeueNextI(&ftdipp->oq_waiting, Q_OK);
 		return;
 	case USBH_URBSTATUS_DISCONNECTED:
@@ -399,8 +426,21 @@ static void _out_cb(usbh_urb_t *urb) {
 		uurberrf("FTDI: URB OUT status unexpected = %d", urb->status);
 		break;
 	}
-	usbhURBObjectResetI(&ftdipp->oq_urb);
-	usbhURBSubmitI(&ftdipp->oq_urb);
+	usbhURBObjectResetI(urb);
+	usbhURBSubmitI(urb);
+}
+
+/* Waits for the OUT URB being filled to be free, returns with the lock held */
+static msg_t _out_waitS(USBHFTDIPortDriver *ftdipp, systime_t timeout) {
+	while (true) {
+		if (ftdipp->state != USBHFTDIP_STATE_READY)
+			return Q_RESET;
+		if (!usbhURBIsBusy(&ftdipp->oq[ftdipp->oq_head].urb))
+			return Q_OK;
+		msg_t msg = chThdEnqueueTimeoutS(&ftdipp->oq_waiting, timeout);
+		if (msg < Q_OK)
+			return msg;
+	}
 }
 
 static size_t _write_timeout(USBHFTDIPortDriver *ftdipp, const uint8_t *bp,
@@ -410,26 +450,35 @@ static size_t _write_timeout(USBHFTDIPortDriver *ftdipp, const uint8_t *bp,
 	size_t w = 0;
 	osalSysLock();
 	while (true) {
-		if (ftdipp->state != USBHFTDIP_STATE_READY) {
+		if (_out_waitS(ftdipp, timeout) != Q_OK) {
 			osalSysUnlock();
 			return w;
 		}
-		while (usbhURBIsBusy(&ftdipp->oq_urb)) {
-			if (chThdEnqueueTimeoutS(&ftdipp->oq_waiting, timeout) != Q_OK) {
-				osalSysUnlock();
-				return w;
-			}
-		}
 
-		*ftdipp->oq_ptr++ = *bp++;
-		if (--ftdipp->oq_counter == 0) {
-			_submitOutI(ftdipp, 64);
+		/* the URB is not busy and the flush timer leaves it alone while
+		 * filling, so the copy can be done unlocked */
+		usbhftdi_out_urb_t *const oq = &ftdipp->oq[ftdipp->oq_head];
+		size_t k = HAL_USBHFTDI_OUT_URB_SIZE - oq->counter;
+		if (k > n)
+			k = n;
+		ftdipp->oq_filling = true;
+		osalSysUnlock();
+
+		memcpy(&oq->buff[oq->counter], bp, k);
+
+		osalSysLock();
+		ftdipp->oq_filling = false;
+		oq->counter += k;
+		if (oq->counter == HAL_USBHFTDI_OUT_URB_SIZE) {
+			_submitOutI(ftdipp);
 			osalOsRescheduleS();
 		}
 		osalSysUnlock(); /* Gives a preemption chance in a controlled point.*/
 
-		w++;
-		if (--n == 0U)
+		bp += k;
+		w += k;
+		n -= k;
+		if (n == 0U)
 			return w;
 
 		osalSysLock();
@@ -439,22 +488,16 @@ static size_t _write_timeout(USBHFTDIPortDriver *ftdipp, const uint8_t *bp,
 static msg_t _put_timeout(USBHFTDIPortDriver *ftdipp, uint8_t b, systime_t timeout) {
 
 	osalSysLock();
-	if (ftdipp->state != USBHFTDIP_STATE_READY) {
+	msg_t msg = _out_waitS(ftdipp, timeout);
+	if (msg != Q_OK) {
 		osalSysUnlock();
-		return Q_RESET;
-	}
-
-	while (usbhURBIsBusy(&ftdipp->oq_urb)) {
-		msg_t msg = chThdEnqueueTimeoutS(&ftdipp->oq_waiting, timeout);
-		if (msg < Q_OK) {
-			osalSysUnlock();
-			return msg;
-		}
+		return msg;
 	}
 
-	*ftdipp->oq_ptr++ = b;
-	if (--ftdipp->oq_counter == 0) {
-		_submitOutI(ftdipp, 64);
+	usbhftdi_out_urb_t *const oq = &ftdipp->oq[ftdipp->oq_head];
+	oq->buff[oq->counter++] = b;
+	if (oq->counter == HAL_USBHFTDI_OUT_URB_SIZE) {
+		_submitOutI(ftdipp);
 		osalOsRescheduleS();
 	}
 	osalSysUnlock();
@@ -469,32 +512,70 @@ static msg_t _put(USBHFTDIPortDriver *ftdipp, uint8_t b) {
 	return _put_timeout(ftdipp, b, TIME_INFINITE);
 }
 
-static void _submitInI(USBHFTDIPortDriver *ftdipp) {
-	uclassdrvdbg("FTDI: Submit IN");
-	usbhURBObjectResetI(&ftdipp->iq_urb);
-	usbhURBSubmitI(&ftdipp->iq_urb);
+/*===========================================================================*/
+/* IN pipeline.                                                              */
+/*===========================================================================*/
+
+static void _submitInI(usbhftdi_in_urb_t *iq) {
+	usbhURBObjectResetI(&iq->urb);
+	usbhURBSubmitI(&iq->urb);
+}
+
+/* Resubmits the consumed URBs in ring order, starting from the head */
+static void _in_refillI(USBHFTDIPortDriver *ftdipp) {
+	uint8_t i;
+	for (i = 0; i < HAL_USBHFTDI_IN_URBS; i++) {
+		usbhftdi_in_urb_t *const iq = &ftdipp->iq[ftdipp->iq_head];
+		if (usbhURBIsBusy(&iq->urb) || (iq->counter != 0)
+				|| (iq->urb.status == USBH_URBSTATUS_DISCONNECTED))
+			break;
+		uclassdrvdbgf("FTDI: Submit IN %d", ftdipp->iq_head);
+		if (++ftdipp->iq_head == HAL_USBHFTDI_IN_URBS)
+			ftdipp->iq_head = 0;
+		_submitInI(iq);
+	}
+}
+
+/* Each packet starts with the two modem status bytes, strips them and
+ * returns the payload size */
+static uint32_t _in_compact(uint8_t *buff, uint32_t len, uint16_t mps) {
+	uint32_t rem = 0;
+	uint32_t offset;
+	for (offset = 0; offset < len; offset += mps) {
+		uint32_t plen = len - offset;
+		if (plen > mps)
+			plen = mps;
+		if (plen > 2) {
+			memmove(&buff[rem], &buff[offset + 2], plen - 2);
+			rem += plen - 2;
+		}
+	}
+	return rem;
 }
 
 static void _in_cb(usbh_urb_t *urb) {
 	USBHFTDIPortDriver *const ftdipp = (USBHFTDIPortDriver *)urb->userData;
+	usbhftdi_in_urb_t *const iq = container_of(urb, usbhftdi_in_urb_t, urb);
 	switch (urb->status) {
 	case USBH_URBSTATUS_OK:
 		if (urb->actualLength < 2) {
 			uurbwarnf("FTDI: URB IN actualLength = %d, < 2", urb->actualLength);
 		} else if (urb->actualLength > 2) {
-			uurbdbgf("FTDI: URB IN data len=%d, status=%02x %02x",
-					urb->actualLength - 2,
+			uurbdbgf("FTDI: URB IN len=%d, status=%02x %02x",
+					urb->actualLength,
 					((uint8_t *)urb->buff)[0],
 					((uint8_t *)urb->buff)[1]);
-			ftdipp->iq_ptr = ftdipp->iq_buff + 2;
-			ftdipp->iq_counter = urb->actualLength - 2;
-			chThdDequeueNextI(&ftdipp->iq_waiting, Q_OK);
-			return;
+			iq->counter = _in_compact(iq->buff, urb->actualLength,
+					ftdipp->epin.wMaxPacketSize);
+			iq->ptr = iq->buff;
+			if (iq->counter) {
+				chThdDequeueNextI(&ftdipp->iq_waiting, Q_OK);
+				return;
+			}
 		} else {
 			uurbdbgf("FTDI: URB IN no data, status=%02x %02x",
 					((uint8_t *)urb->buff)[0],
 					((uint8_t *)urb->buff)[1]);
-		//	return;
 		}
 		break;
 	case USBH_URBSTATUS_DISCONNECTED:
@@ -505,7 +586,32 @@ static void _in_cb(usbh_urb_t *urb) {
 		uurberrf("FTDI: URB IN status unexpected = %d", urb->status);
 		break;
 	}
-	_submitInI(ftdipp);
+	iq->counter = 0;
+	_in_refillI(ftdipp);
+}
+
+/* Waits for data in the head URB, returns with the lock held */
+static msg_t _in_waitS(USBHFTDIPortDriver *ftdipp, systime_t timeout) {
+	while (true) {
+		if (ftdipp->state != USBHFTDIP_STATE_READY)
+			return Q_RESET;
+		_in_refillI(ftdipp);
+		if (ftdipp->iq[ftdipp->iq_head].counter != 0)
+			return Q_OK;
+		msg_t msg = chThdEnqueueTimeoutS(&ftdipp->iq_waiting, timeout);
+		if (msg < Q_OK)
+			return msg;
+	}
+}
+
+static void _in_consumeS(USBHFTDIPortDriver *ftdipp, usbhftdi_in_urb_t *iq,
+		uint32_t n) {
+	iq->ptr += n;
+	iq->counter -= n;
+	if (iq->counter == 0) {
+		_in_refillI(ftdipp);
+		osalOsRescheduleS();
+	}
 }
 
 static size_t _read_timeout(USBHFTDIPortDriver *ftdipp, uint8_t *bp,
@@ -516,27 +622,29 @@ static size_t _read_timeout(USBHFTDIPortDriver *ftdipp, uint8_t *bp,
 
 	osalSysLock();
 	while (true) {
-		if (ftdipp->state != USBHFTDIP_STATE_READY) {
+		if (_in_waitS(ftdipp, timeout) != Q_OK) {
 			osalSysUnlock();
 			return r;
 		}
-		while (ftdipp->iq_counter == 0) {
-			if (!usbhURBIsBusy(&ftdipp->iq_urb))
-				_submitInI(ftdipp);
-			if (chThdEnqueueTimeoutS(&ftdipp->iq_waiting, timeout) != Q_OK) {
-				osalSysUnlock();
-				return r;
-			}
-		}
-		*bp++ = *ftdipp->iq_ptr++;
-		if (--ftdipp->iq_counter == 0) {
-			_submitInI(ftdipp);
-			osalOsRescheduleS();
-		}
+
+		/* the head URB holds data, nobody else touches it until it is
+		 * consumed, so the copy can be done unlocked */
+		usbhftdi_in_urb_t *const iq = &ftdipp->iq[ftdipp->iq_head];
+		size_t k = iq->counter;
+		if (k > n)
+			k = n;
+		osalSysUnlock();
+
+		memcpy(bp, iq->ptr, k);
+
+		osalSysLock();
+		_in_consumeS(ftdipp, iq, k);
 		osalSysUnlock();
 
-		r++;
-		if (--n == 0U)
+		bp += k;
+		r += k;
+		n -= k;
+		if (n == 0U)
 			return r;
 
 		osalSysLock();
@@ -547,24 +655,14 @@ static msg_t _get_timeout(USBHFTDIPortDriver *ftdipp, systime_t timeout) {
 	uint8_t b;
 
 	osalSysLock();
-	if (ftdipp->state != USBHFTDIP_STATE_READY) {
+	msg_t msg = _in_waitS(ftdipp, timeout);
+	if (msg != Q_OK) {
 		osalSysUnlock();
-		return Q_RESET;
-	}
-	while (ftdipp->iq_counter == 0) {
-		if (!usbhURBIsBusy(&ftdipp->iq_urb))
-			_submitInI(ftdipp);
-		msg_t msg = chThdEnqueueTimeoutS(&ftdipp->iq_waiting, timeout);
-		if (msg < Q_OK) {
-			osalSysUnlock();
-			return msg;
-		}
-	}
-	b = *ftdipp->iq_ptr++;
-	if (--ftdipp->iq_counter == 0) {
-		_submitInI(ftdipp);
-		osalOsRescheduleS();
+		return msg;
 	}
+	usbhftdi_in_urb_t *const iq = &ftdipp->iq[ftdipp->iq_head];
+	b = *iq->ptr;
+	_in_consumeS(ftdipp, iq, 1);
 	osalSysUnlock();
 
 	return (msg_t)b;
@@ -585,17 +683,17 @@ static msg_t _ctl(USBHFTDIPortDriver *ftdipp, unsigned int operation, void *arg)
 	return MSG_OK;
 }
 
+/* Sends the partially filled OUT URB and restarts the IN pipeline, with the
+ * period of the chip latency timer */
 static void _vt(void *p) {
 	USBHFTDIPortDriver *const ftdipp = (USBHFTDIPortDriver *)p;
 	osalSysLockFromISR();
-	uint32_t len = ftdipp->oq_ptr - ftdipp->oq_buff;
-	if (len && !usbhURBIsBusy(&ftdipp->oq_urb)) {
-		_submitOutI(ftdipp, len);
-	}
-	if ((ftdipp->iq_counter == 0) && !usbhURBIsBusy(&ftdipp->iq_urb)) {
-		_submitInI(ftdipp);
+	usbhftdi_out_urb_t *const oq = &ftdipp->oq[ftdipp->oq_head];
+	if (oq->counter && !ftdipp->oq_filling && !usbhURBIsBusy(&oq->urb)) {
+		_submitOutI(ftdipp);
 	}
-	chVTSetI(&ftdipp->vt, OSAL_MS2I(16), _vt, ftdipp);
+	_in_refillI(ftdipp);
+	chVTSetI(&ftdipp->vt, ftdipp->flush_interval, _vt, ftdipp);
 	osalSysUnlockFromISR();
 }
 
@@ -642,7 +740,8 @@ void usbhftdipStart(USBHFTDIPortDriver *ftdipp, const USBHFTDIPortConfig *config
 		HAL_USBHFTDI_DEFAULT_FRAMING,
 		HAL_USBHFTDI_DEFAULT_HANDSHAKE,
 		HAL_USBHFTDI_DEFAULT_XON,
-		HAL_USBHFTDI_DEFAULT_XOFF
+		HAL_USBHFTDI_DEFAULT_XOFF,
+		HAL_USBHFTDI_DEFAULT_LATENCY_TIMER
 	};
 
 	osalDbgCheck((ftdipp->state == USBHFTDIP_STATE_ACTIVE)
@@ -662,24 +761,38 @@ void usbhftdipStart(USBHFTDIPortDriver *ftdipp, const USBHFTDIPortConfig *config
 	if (config->handshake & USBHFTDI_HANDSHAKE_XON_XOFF)
 		wValue = (config->xoff_character << 8) | config->xon_character;
 	_ftdi_port_control(ftdipp, FTDI_COMMAND_SETFLOW, wValue, config->handshake, 0, NULL);
+	uint8_t latency = config->latency_timer ? config->latency_timer : HAL_USBHFTDI_DEFAULT_LATENCY_TIMER;
+	_set_latency_timer(ftdipp, latency);
+	ftdipp->flush_interval = OSAL_MS2I(latency);
 
-	usbhURBObjectInit(&ftdipp->oq_urb, &ftdipp->epout, _out_cb, ftdipp, ftdipp->oq_buff, 0);
+	uint8_t i;
+	for (i = 0; i < HAL_USBHFTDI_OUT_URBS; i++) {
+		usbhURBObjectInit(&ftdipp->oq[i].urb, &ftdipp->epout, _out_cb, ftdipp, ftdipp->oq[i].buff, 0);
+		ftdipp->oq[i].counter = 0;
+	}
 	chThdQueueObjectInit(&ftdipp->oq_waiting);
-	ftdipp->oq_counter = 64;
-	ftdipp->oq_ptr = ftdipp->oq_buff;
+	ftdipp->oq_head = 0;
+	ftdipp->oq_filling = false;
 	usbhEPOpen(&ftdipp->epout);
 
-	usbhURBObjectInit(&ftdipp->iq_urb, &ftdipp->epin, _in_cb, ftdipp, ftdipp->iq_buff, 64);
+	for (i = 0; i < HAL_USBHFTDI_IN_URBS; i++) {
+		usbhURBObjectInit(&ftdipp->iq[i].urb, &ftdipp->epin, _in_cb, ftdipp, ftdipp->iq[i].buff, HAL_USBHFTDI_IN_URB_SIZE);
+		ftdipp->iq[i].counter = 0;
+		ftdipp->iq[i].ptr = ftdipp->iq[i].buff;
+	}
 	chThdQueueObjectInit(&ftdipp->iq_waiting);
-	ftdipp->iq_counter = 0;
-	ftdipp->iq_ptr = ftdipp->iq_buff;
+	ftdipp->iq_head = 0;
 	usbhEPOpen(&ftdipp->epin);
-	usbhURBSubmit(&ftdipp->iq_urb);
 
 	chVTObjectInit(&ftdipp->vt);
-	chVTSet(&ftdipp->vt, OSAL_MS2I(16), _vt, ftdipp);
 
+	osalSysLock();
 	ftdipp->state = USBHFTDIP_STATE_READY;
+	_in_refillI(ftdipp);
+	chVTSetI(&ftdipp->vt, ftdipp->flush_interval, _vt, ftdipp);
+	osalOsRescheduleS();
+	osalSysUnlock();
+
 	osalMutexUnlock(&ftdipp->ftdip->mtx);
 }
 
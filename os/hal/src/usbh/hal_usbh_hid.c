@@ -58,8 +58,13 @@ static const usbh_classdriver_vmt_t class_driver_vmt = {
 	_hid_unload
 };
 
+static const usbh_classdriver_match_t class_driver_matches[] = {
+	USBH_MATCH_INFO(USBH_DT_INTERFACE, 0x03, -1, -1),
+};
+
 const usbh_classdriverinfo_t usbhhidClassDriverInfo = {
-	"HID", &class_driver_vmt
+	"HID", &class_driver_vmt,
+	class_driver_matches, sizeof_array(class_driver_matches)
 };
 
 static usbh_baseclassdriver_t *_hid_load(usbh_device_t *dev, const uint8_t *descriptor, uint16_t rem) {
@@ -100,14 +105,11 @@ alloc_ok:
 	hidp->ifnum = ifdesc->bInterfaceNumber;
 	usbhEPSetName(&dev->ctrl, "HID[CTRL]");
 
-	/* parse the configuration descriptor */
-	if_iterator_t iif;
-	generic_iterator_t iep;
-	iif.iad = 0;
-	iif.curr = descriptor;
-	iif.rem = rem;
-	for (ep_iter_init(&iep, &iif); iep.valid; ep_iter_next(&iep)) {
-		const usbh_endpoint_descriptor_t *const epdesc = ep_get(&iep);
+	/* endpoints of the pre-parsed interface */
+	const usbh_ifinfo_t *const ifi = usbhDeviceInterfaceOf(dev, descriptor);
+	const uint8_t ep_count = ifi ? ifi->ep_count : 0;
+	for (i = 0; i < ep_count; i++) {
+		const usbh_endpoint_descriptor_t *const epdesc = usbhIfEndpoint(dev, ifi, i);
 		if ((epdesc->bEndpointAddress & 0x80) && (epdesc->bmAttributes == USBH_EPTYPE_INT)) {
 			udevinfof("INT IN endpoint found: bEndpointAddress=%02x", epdesc->bEndpointAddress);
 			usbhEPObjectInit(&hidp->epin, dev, epdesc);
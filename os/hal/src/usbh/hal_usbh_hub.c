@@ -46,8 +46,13 @@ static const usbh_classdriver_vmt_t usbhhubClassDriverVMT = {
 	_hub_unload
 };
 
+static const usbh_classdriver_match_t class_driver_matches[] = {
+	USBH_MATCH_INFO(USBH_DT_DEVICE, 0x09, 0x00, 0x00),
+};
+
 const usbh_classdriverinfo_t usbhhubClassDriverInfo = {
-	"HUB", &usbhhubClassDriverVMT
+	"HUB", &usbhhubClassDriverVMT,
+	class_driver_matches, sizeof_array(class_driver_matches)
 };
 
 
@@ -101,6 +106,8 @@ static void _urb_complete(usbh_urb_t *urb) {
 			*sc++ |= *r++;
 
 		uurbinfof("HUB: change, %08x", hubdp->statuschange);
+		if (hubdp->statuschange)
+			_usbh_signal_eventI(hubdp->dev->host, USBH_EVENT_HUB);
 	}	break;
 	case USBH_URBSTATUS_DISCONNECTED:
 		uurbwarn("HUB: URB disconnected, aborting poll");
@@ -124,24 +131,17 @@ static usbh_baseclassdriver_t *_hub_load(usbh_device_t *dev,
 			0x09, 0x00, 0x00) != HAL_SUCCESS)
 		return NULL;
 
-	generic_iterator_t iep, icfg;
-	if_iterator_t iif;
-
-	cfg_iter_init(&icfg, dev->fullConfigurationDescriptor,
-			dev->basicConfigDesc.wTotalLength);
-
-	if_iter_init(&iif, &icfg);
-	if (!iif.valid)
+	if (dev->num_ifs == 0)
 		return NULL;
 
-	if (_usbh_match_descriptor(iif.curr, iif.rem, USBH_DT_INTERFACE,
-			0x09, 0x00, 0x00) != HAL_SUCCESS)
+	const usbh_ifinfo_t *const ifi = &dev->ifs[0];
+	if ((ifi->bInterfaceClass != 0x09) || (ifi->bInterfaceSubClass != 0x00)
+			|| (ifi->bInterfaceProtocol != 0x00))
 		return NULL;
 
-	ep_iter_init(&iep, &iif);
-	if (!iep.valid)
+	if (ifi->ep_count == 0)
 		return NULL;
-	const usbh_endpoint_descriptor_t *const epdesc = ep_get(&iep);
+	const usbh_endpoint_descriptor_t *const epdesc = usbhIfEndpoint(dev, ifi, 0);
 	if ((epdesc->bmAttributes & 0x03) != USBH_EPTYPE_INT) {
 		return NULL;
 	}
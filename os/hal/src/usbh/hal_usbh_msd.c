@@ -65,8 +65,13 @@ static const usbh_classdriver_vmt_t class_driver_vmt = {
 	_msd_unload
 };
 
+static const usbh_classdriver_match_t class_driver_matches[] = {
+	USBH_MATCH_INFO(USBH_DT_INTERFACE, 0x08, 0x06, 0x50),
+};
+
 const usbh_classdriverinfo_t usbhmsdClassDriverInfo = {
-	"MSD", &class_driver_vmt
+	"MSD", &class_driver_vmt,
+	class_driver_matches, sizeof_array(class_driver_matches)
 };
 
 #define MSD_REQ_RESET							0xFF
@@ -112,14 +117,11 @@ alloc_ok:
 	msdp->ifnum = ifdesc->bInterfaceNumber;
 	usbhEPSetName(&dev->ctrl, "MSD[CTRL]");
 
-	/* parse the configuration descriptor */
-	if_iterator_t iif;
-	generic_iterator_t iep;
-	iif.iad = 0;
-	iif.curr = descriptor;
-	iif.rem = rem;
-	for (ep_iter_init(&iep, &iif); iep.valid; ep_iter_next(&iep)) {
-		const usbh_endpoint_descriptor_t *const epdesc = ep_get(&iep);
+	/* endpoints of the pre-parsed interface */
+	const usbh_ifinfo_t *const ifi = usbhDeviceInterfaceOf(dev, descriptor);
+	const uint8_t ep_count = ifi ? ifi->ep_count : 0;
+	for (i = 0; i < ep_count; i++) {
+		const usbh_endpoint_descriptor_t *const epdesc = usbhIfEndpoint(dev, ifi, i);
 		if ((epdesc->bEndpointAddress & 0x80) && (epdesc->bmAttributes == USBH_EPTYPE_BULK)) {
 			udevinfof("BULK IN endpoint found: bEndpointAddress=%02x", epdesc->bEndpointAddress);
 			usbhEPObjectInit(&msdp->epin, dev, epdesc);
@@ -50,8 +50,13 @@ static const usbh_classdriver_vmt_t class_driver_vmt = {
 	_uvc_load,
 	_uvc_unload
 };
+static const usbh_classdriver_match_t class_driver_matches[] = {
+	USBH_MATCH_INFO(USBH_DT_INTERFACE_ASSOCIATION, 0x0e, 0x03, 0x00),
+};
+
 const usbh_classdriverinfo_t usbhuvcClassDriverInfo = {
-	"UVC", &class_driver_vmt
+	"UVC", &class_driver_vmt,
+	class_driver_matches, sizeof_array(class_driver_matches)
 };
 
 static bool _request(USBHUVCDriver *uvcdp,
@@ -23,6 +23,20 @@
 #include <avsystem/commons/avs_socket.h>
 #include <avsystem/commons/xcc_wiznet_posix_compat.h>
 
+// poll() event bits taken by xcc_net_socket_poll_single(), with the usual
+// POSIX values when the C library has no <poll.h>
+#ifndef POLLIN
+#define POLLIN  0x0001
+#endif
+
+#ifndef POLLOUT
+#define POLLOUT 0x0004
+#endif
+
+#ifndef POLLHUP
+#define POLLHUP 0x0010
+#endif
+
 // Forward declarations of avs_net APIs that must be implemented
 void _avs_net_cleanup_global_compat_state(void);
 
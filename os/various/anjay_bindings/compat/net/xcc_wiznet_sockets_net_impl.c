@@ -83,9 +83,10 @@ avs_error_t _avs_net_initialize_global_compat_state(void) {
 
 void _avs_net_cleanup_global_compat_state(void) { }
 
+/* The WIZnet bindings return negated WIZCHIP_SOCKETS_ERR_* codes. */
 static avs_errno_t wizchip_sockets_err_to_avs_errno(int err) {
 
-  switch (err) {
+  switch (-err) {
   case WIZCHIP_SOCKETS_ERR_OK:
     return AVS_NO_ERROR;
 
@@ -265,48 +266,30 @@ static int32_t recv_with_timeout(xcc_net_socket_impl_t *sock,
                                  int32_t buffer_length,
                                  int64_t timeout) {
 
-  uint32_t timeout_opt;
+  short revents;
   int32_t res;
 
-  if (timeout == 0) {
-    if (sock->socktype == WIZCHIP_TYPE_DGRAM) {
-      res = wizchipRecvFrom(sock->fd, buffer, buffer_length, WIZCHIP_FLAG_MSG_DONTWAIT,
-                            &sock->remote_host, sock->remote_port);
-    } else {
-      res = wizchipRecv(sock->fd, buffer, buffer_length, WIZCHIP_FLAG_MSG_DONTWAIT);
-    }
-
-    if (res == WIZCHIP_SOCKETS_ERR_GENERAL) {
-      // behavior unique to WIZCHIP_MSG_DONTWAIT
-      res = AVS_ETIMEDOUT;
-    }
+  // sleep on the socket events, the receive below never blocks
+  res = xcc_net_socket_poll_single(sock, timeout, POLLIN, &revents);
 
+  if (res < 0) {
     return res;
   }
 
-  if (timeout < 0) {
-    timeout_opt = TIME_INFINITE;
-  } else {
-    timeout_opt = (uint32_t)timeout;
-
-    if (timeout_opt != timeout) {
-      // accidentally truncated
-      return WIZCHIP_SOCKETS_ERR_GENERAL;
-    }
-  }
-
-  res = wizchipSetSockopt(sock->fd, WIZCHIP_SOL_SOCKET, WIZCHIP_SO_RCVTIMEO,
-                          &timeout_opt, sizeof(timeout_opt));
-
-  if (res) {
-    return res;
+  if (res == 0) {
+    return -WIZCHIP_SOCKETS_ERR_TIMEOUT;
   }
 
   if (sock->socktype == WIZCHIP_TYPE_DGRAM) {
-    res = wizchipRecvFrom(sock->fd, buffer, buffer_length, WIZCHIP_FLAG_MSG_WAIT,
+    res = wizchipRecvFrom(sock->fd, buffer, buffer_length, WIZCHIP_FLAG_MSG_DONTWAIT,
                           &sock->remote_host, sock->remote_port);
   } else {
-    res = wizchipRecv(sock->fd, buffer, buffer_length, WIZCHIP_FLAG_MSG_WAIT);
+    res = wizchipRecv(sock->fd, buffer, buffer_length, WIZCHIP_FLAG_MSG_DONTWAIT);
+  }
+
+  if (res == -WIZCHIP_SOCKETS_ERR_WOULDBLOCK) {
+    // behavior unique to WIZCHIP_MSG_DONTWAIT
+    res = -WIZCHIP_SOCKETS_ERR_TIMEOUT;
   }
 
   return res;
@@ -631,3 +614,52 @@ avs_error_t _avs_net_create_tcp_socket(avs_net_socket_t **socket_ptr,
            socket_ptr, (const avs_net_socket_configuration_t *)configuration,
            WIZCHIP_TYPE_STREAM);
 }
+
+int xcc_net_socket_poll_single(xcc_net_socket_impl_t *socket,
+                               int64_t timeout_ms,
+                               short events,
+                               short *revents) {
+
+  wizchip_pollfd_t fd = {
+    .sock = socket->fd,
+    .events = 0,
+    .revents = 0
+  };
+  sysinterval_t timeout;
+
+  if (events & POLLIN) {
+    fd.events |= WIZCHIP_POLLIN;
+  }
+
+  if (events & POLLOUT) {
+    fd.events |= WIZCHIP_POLLOUT;
+  }
+
+  if (timeout_ms < 0 || timeout_ms > INT32_MAX) {
+    timeout = TIME_INFINITE;
+  } else if (timeout_ms == 0) {
+    timeout = TIME_IMMEDIATE;
+  } else {
+    timeout = TIME_MS2I((uint32_t)timeout_ms);
+  }
+
+  int res = wizchipSelect(&fd, 1, timeout);
+
+  if (res >= 0) {
+    *revents = 0;
+
+    if (fd.revents & WIZCHIP_POLLIN) {
+      *revents |= POLLIN;
+    }
+
+    if (fd.revents & WIZCHIP_POLLOUT) {
+      *revents |= POLLOUT;
+    }
+
+    if (fd.revents & WIZCHIP_POLLHUP) {
+      *revents |= POLLHUP;
+    }
+  }
+
+  return res;
+}
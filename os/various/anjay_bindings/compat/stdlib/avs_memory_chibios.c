@@ -25,16 +25,83 @@
 #include <string.h>
 #include <ch.h>
 
+#include "avs_memory_chibios.h"
+
 VISIBILITY_SOURCE_BEGIN
 
-#ifndef AVS_HEAP_MAX_BUFFER_SIZE
-#define AVS_HEAP_MAX_BUFFER_SIZE  16*1024u
+/*
+ * Small blocks are served from fixed size memory pools, one per size class,
+ * so that the short lived CoAP and stream buffers do not fragment the heap
+ * and are allocated in constant time. A block belongs to a class if its
+ * address falls within the class storage.
+ */
+
+/* Open coded rounding, it is also used in preprocessor expressions.*/
+#define AVS_POOL_OBJ_SIZE(size)                                               \
+  ((((size) + CH_HEAP_ALIGNMENT - 1u) / CH_HEAP_ALIGNMENT) * CH_HEAP_ALIGNMENT)
+#define AVS_POOL_CLASS_SIZE(objsize, n) + (AVS_POOL_OBJ_SIZE(objsize) * (n))
+#define AVS_POOL_CLASS_INIT(objsize, n)                                       \
+  {.size = AVS_POOL_OBJ_SIZE(objsize), .count = (n)},
+
+#define AVS_POOLS_SIZE  (0 AVS_HEAP_POOL_CLASSES(AVS_POOL_CLASS_SIZE))
+
+#if AVS_POOLS_SIZE + 1024u > AVS_HEAP_MAX_BUFFER_SIZE
+#error "AVS_HEAP_POOL_CLASSES leave less than 1kB of heap"
 #endif
 
 static memory_heap_t avs_heap;
-static uint8_t avs_heap_buf[AVS_HEAP_MAX_BUFFER_SIZE];
+static CH_HEAP_AREA(avs_heap_buf, AVS_HEAP_MAX_BUFFER_SIZE - AVS_POOLS_SIZE);
+
+#if AVS_HEAP_NUM_CLASSES > 0
+typedef struct {
+  memory_pool_t pool;
+  /* End of the class storage, the classes are laid out in order. */
+  uint8_t *end;
+} avs_pool_class_t;
+
+static CH_HEAP_AREA(avs_pool_buf, AVS_POOLS_SIZE);
+static avs_pool_class_t avs_pools[AVS_HEAP_NUM_CLASSES];
+#endif
+
+static avs_heap_stats_t avs_stats = {
+#if AVS_HEAP_NUM_CLASSES > 0
+  .classes = {AVS_HEAP_POOL_CLASSES(AVS_POOL_CLASS_INIT)}
+#endif
+};
+
+#if AVS_HEAP_NUM_CLASSES > 0
+/*
+ * Returns the class index of a pool block, -1 for a heap block.
+ */
+static int avs_pool_find(const void *ptr) {
+  const uint8_t *p = ptr;
+  int i;
+
+  if ((p < avs_pool_buf) || (p >= &avs_pool_buf[AVS_POOLS_SIZE]))
+    return -1;
+
+  for (i = 0; p >= avs_pools[i].end; i++)
+    ;
+
+  return i;
+}
+#endif
 
 void avs_heap_init(void) {
+#if AVS_HEAP_NUM_CLASSES > 0
+  uint8_t *p = avs_pool_buf;
+  int i;
+
+  for (i = 0; i < AVS_HEAP_NUM_CLASSES; i++) {
+    avs_heap_class_stats_t *csp = &avs_stats.classes[i];
+
+    chPoolObjectInitAligned(&avs_pools[i].pool, csp->size,
+                            CH_HEAP_ALIGNMENT, NULL);
+    chPoolLoadArray(&avs_pools[i].pool, p, csp->count);
+    p += csp->size * csp->count;
+    avs_pools[i].end = p;
+  }
+#endif
 
   chHeapObjectInit(&avs_heap, avs_heap_buf, sizeof(avs_heap_buf));
 }
@@ -50,9 +117,69 @@ size_t avs_heap_get_free(void) {
   return total_free;
 }
 
+void avs_heap_get_stats(avs_heap_stats_t *stats) {
+  size_t total_free;
+  size_t largest;
+  size_t fragments = chHeapStatus(&avs_heap, &total_free, &largest);
+
+  chSysLock();
+  *stats = avs_stats;
+  chSysUnlock();
+
+  stats->heap_free = total_free;
+  stats->heap_largest = largest;
+  stats->heap_fragments = fragments;
+}
+
 void *avs_malloc(size_t size) {
+  void *ptr;
+
+  chSysLock();
+  if (size > avs_stats.largest_request)
+    avs_stats.largest_request = size;
+  chSysUnlock();
+
+#if AVS_HEAP_NUM_CLASSES > 0
+  {
+    int i, first;
 
-  return chHeapAlloc(&avs_heap, size);
+    for (first = 0; first < AVS_HEAP_NUM_CLASSES; first++) {
+      if (size <= avs_stats.classes[first].size)
+        break;
+    }
+
+    /* Smallest class fitting the request, the next one if exhausted.*/
+    for (i = first; (i < AVS_HEAP_NUM_CLASSES) && (i <= first + 1); i++) {
+      avs_heap_class_stats_t *csp = &avs_stats.classes[i];
+
+      ptr = chPoolAlloc(&avs_pools[i].pool);
+
+      chSysLock();
+      if (ptr != NULL) {
+        if (++csp->used > csp->high_water)
+          csp->high_water = csp->used;
+      }
+      else if (i == first) {
+        csp->failures++;
+      }
+      chSysUnlock();
+
+      if (ptr != NULL)
+        return ptr;
+    }
+  }
+#endif
+
+  ptr = chHeapAlloc(&avs_heap, size);
+
+  chSysLock();
+  if (ptr != NULL)
+    avs_stats.heap_allocs++;
+  else
+    avs_stats.heap_failures++;
+  chSysUnlock();
+
+  return ptr;
 }
 
 void avs_free(void *ptr) {
@@ -60,6 +187,21 @@ void avs_free(void *ptr) {
   if (ptr == NULL)
     return;
 
+#if AVS_HEAP_NUM_CLASSES > 0
+  {
+    int i = avs_pool_find(ptr);
+
+    if (i >= 0) {
+      chPoolFree(&avs_pools[i].pool, ptr);
+
+      chSysLock();
+      avs_stats.classes[i].used--;
+      chSysUnlock();
+      return;
+    }
+  }
+#endif
+
   chHeapFree(ptr);
 }
 
@@ -67,9 +209,12 @@ void *avs_calloc(size_t nmemb, size_t size) {
 
   void *ptr;
 
+  if ((size != 0u) && (nmemb > SIZE_MAX / size))
+    return NULL;
+
   const size_t total = nmemb * size;
 
-  ptr = chHeapAlloc(&avs_heap, total);
+  ptr = avs_malloc(total);
 
   if (!ptr)
     return NULL;
@@ -78,15 +223,44 @@ void *avs_calloc(size_t nmemb, size_t size) {
   return ptr;
 }
 
+/*
+ * Returns the usable size of an allocated block.
+ */
+static size_t avs_block_size(void *ptr) {
+
+#if AVS_HEAP_NUM_CLASSES > 0
+  int i = avs_pool_find(ptr);
+
+  if (i >= 0)
+    return avs_stats.classes[i].size;
+#endif
+
+  return chHeapGetSize(ptr);
+}
+
 void *avs_realloc(void *ptr, size_t size) {
 
+  if (ptr == NULL)
+    return avs_malloc(size);
+
+  if (size == 0u) {
+    avs_free(ptr);
+    return NULL;
+  }
+
+  size_t old_size = avs_block_size(ptr);
+
+  /* The block is kept while it fits.*/
+  if (size <= old_size)
+    return ptr;
+
   void *p = avs_malloc(size);
 
   if (!p)
     return NULL;
 
-  memcpy(p, ptr, size);
-  chHeapFree(ptr);
+  memcpy(p, ptr, old_size);
+  avs_free(ptr);
   return p;
 }
 
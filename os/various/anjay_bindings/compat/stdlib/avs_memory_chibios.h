@@ -17,8 +17,64 @@
 #ifndef AVS_MEMORY_CHIBIOS_H
 #define AVS_MEMORY_CHIBIOS_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+/* Total memory of the allocator, size classes included. */
+#ifndef AVS_HEAP_MAX_BUFFER_SIZE
+#define AVS_HEAP_MAX_BUFFER_SIZE  16*1024u
+#endif
+
+/*
+ * Size classes served from memory pools, as X(object size, objects) in
+ * ascending size order. Requests larger than the biggest class, or finding
+ * both their class and the next one exhausted, go to the heap which gets
+ * the remainder of AVS_HEAP_MAX_BUFFER_SIZE. Define as empty to use the
+ * heap only.
+ */
+#ifndef AVS_HEAP_POOL_CLASSES
+#define AVS_HEAP_POOL_CLASSES(X)                                              \
+  X(16,  48)                                                                  \
+  X(32,  48)                                                                  \
+  X(64,  24)                                                                  \
+  X(128, 12)                                                                  \
+  X(256, 4)
+#endif
+
+#define AVS_HEAP_POOL_COUNT_CLASS(objsize, n) + 1
+#define AVS_HEAP_NUM_CLASSES  (0 AVS_HEAP_POOL_CLASSES(AVS_HEAP_POOL_COUNT_CLASS))
+
+typedef struct {
+  /* Object size and number of objects of the class. */
+  size_t size;
+  size_t count;
+  /* Objects currently allocated and highest number ever allocated. */
+  size_t used;
+  size_t high_water;
+  /* Requests for this class which found it exhausted and went to the next
+     class or to the heap. */
+  uint32_t failures;
+} avs_heap_class_stats_t;
+
+typedef struct {
+#if AVS_HEAP_NUM_CLASSES > 0
+  avs_heap_class_stats_t classes[AVS_HEAP_NUM_CLASSES];
+#endif
+  /* Heap state: free memory, largest free block and free fragments. */
+  size_t heap_free;
+  size_t heap_largest;
+  size_t heap_fragments;
+  /* Largest request seen, to size the classes from traces. */
+  size_t largest_request;
+  /* Blocks allocated from the heap and heap allocations that failed. */
+  uint32_t heap_allocs;
+  uint32_t heap_failures;
+} avs_heap_stats_t;
+
 void avs_heap_init(void);
 
 size_t avs_heap_get_free(void);
 
+void avs_heap_get_stats(avs_heap_stats_t *stats);
+
 #endif /* AVS_MEMORY_CHIBIOS_H */
@@ -134,6 +134,20 @@ struct CRCDriver {
    */
   mutex_t                   mutex;
 #endif /* CRC_USE_MUTUAL_EXCLUSION */
+#if (CRC_USE_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Unit statistics.
+   */
+  crcstats_t                stats;
+  /**
+   * @brief   Start time of the current operation.
+   */
+  crctime_t                 start;
+  /**
+   * @brief   Size of the current operation.
+   */
+  size_t                    size;
+#endif /* CRC_USE_STATISTICS */
   /* End of the mandatory fields.*/
   /**
    * @brief Current value of calculated CRC.
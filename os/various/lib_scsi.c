@@ -545,4 +545,32 @@ uint32_t scsiResidue(const SCSITarget *scsip) {
   return scsip->residue;
 }
 
+/**
+ * @brief   Retrieves the blocks accessed by a command.
+ * @details Lets the transports supporting command queuing order the media
+ *          accesses.
+ *
+ * @param[in] cmd     pointer to SCSI command data
+ * @param[out] lba    first block
+ * @param[out] blocks number of blocks
+ *
+ * @return            The command kind.
+ * @retval true       READ (10) or WRITE (10), @p lba and @p blocks are set.
+ * @retval false      Any other command.
+ *
+ * @api
+ */
+bool scsiGetDataRequest(const uint8_t *cmd, uint32_t *lba, uint32_t *blocks) {
+
+  if ((cmd[0] == SCSI_CMD_READ_10) || (cmd[0] == SCSI_CMD_WRITE_10)) {
+    data_request_t req = decode_data_request(cmd);
+
+    *lba = req.first_lba;
+    *blocks = req.blk_cnt;
+    return true;
+  }
+
+  return false;
+}
+
 /** @} */
@@ -41,6 +41,7 @@
 #define SCSI_CMD_READ_10                        0x28
 #define SCSI_CMD_WRITE_10                       0x2A
 #define SCSI_CMD_VERIFY_10                      0x2F
+#define SCSI_CMD_REPORT_LUNS                    0xA0
 
 #define SCSI_SENSE_KEY_GOOD                     0x00
 #define SCSI_SENSE_KEY_RECOVERED_ERROR          0x01
@@ -284,6 +285,7 @@ extern "C" {
   void scsiStop(SCSITarget *scsip);
   bool scsiExecCmd(SCSITarget *scsip, const uint8_t *cmd);
   uint32_t scsiResidue(const SCSITarget *scsip);
+  bool scsiGetDataRequest(const uint8_t *cmd, uint32_t *lba, uint32_t *blocks);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,33 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * AES context for the MBEDTLS_AES_ALT implementation, the key schedule is
+ * done by the crypto unit so the raw key is kept.
+ */
+
+#ifndef AES_ALT_H
+#define AES_ALT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct mbedtls_aes_context {
+  uint8_t       key[32];
+  size_t        keylen;
+} mbedtls_aes_context;
+
+#endif /* AES_ALT_H */
@@ -0,0 +1,43 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * GCM context for the MBEDTLS_GCM_ALT implementation. One-shot operations
+ * with 96 bits IVs run on the crypto unit, the multi-part API computes
+ * GHASH in software on top of the accelerated AES.
+ */
+
+#ifndef GCM_ALT_H
+#define GCM_ALT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mbedtls/aes.h"
+
+typedef struct mbedtls_gcm_context {
+  mbedtls_aes_context   aes;
+  uint8_t               h[16];
+  uint8_t               ek0[16];
+  uint8_t               y[16];
+  uint8_t               ectr[16];
+  uint8_t               buf[16];
+  uint64_t              add_len;
+  uint64_t              len;
+  int                   mode;
+} mbedtls_gcm_context;
+
+#endif /* GCM_ALT_H */
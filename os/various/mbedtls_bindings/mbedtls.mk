@@ -3,6 +3,10 @@ MBEDTLS = $(CHIBIOS_CONTRIB)/ext/mbedtls-mbedtls-3.5.0
 MBEDBINDSRC = \
         $(CHIBIOS_CONTRIB)/os/various/mbedtls_bindings/mbedtls_rng.c \
         $(CHIBIOS_CONTRIB)/os/various/mbedtls_bindings/mbedtls_timing.c \
+        $(CHIBIOS_CONTRIB)/os/various/mbedtls_bindings/mbedtls_cry.c \
+        $(CHIBIOS_CONTRIB)/os/various/mbedtls_bindings/mbedtls_aes_alt.c \
+        $(CHIBIOS_CONTRIB)/os/various/mbedtls_bindings/mbedtls_gcm_alt.c \
+        $(CHIBIOS_CONTRIB)/os/various/mbedtls_bindings/mbedtls_sha_alt.c \
         $(MBEDTLS)/library/aes.c \
         $(MBEDTLS)/library/aesce.c \
         $(MBEDTLS)/library/aesni.c \
@@ -105,6 +109,7 @@ MBEDBINDSRC = \
         $(MBEDTLS)/library/x509write_csr.c
 
 MBEDBINDINC  = \
+        $(CHIBIOS_CONTRIB)/os/various/mbedtls_bindings \
         $(MBEDTLS)/include
 
 # Shared variables
@@ -110,3 +110,6 @@
 /* If your system does not have a libc equivalent, you will get compile errors as calloc() or free() cannot be found.* */
 //#define MBEDTLS_PLATFORM_NO_STD_FUNCTIONS
 
+/* Hardware acceleration through the ChibiOS HAL crypto driver, set
+ * MBEDTLS_CHIBIOS_USE_CRY to FALSE for the software implementations. */
+#include "mbedtls_alt.h"
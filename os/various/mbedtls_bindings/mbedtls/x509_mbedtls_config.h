@@ -122,3 +122,7 @@
  * (huge code size increase, needed for tests/ssl-opt.sh) */
 //#define MBEDTLS_DEBUG_C
 //#define MBEDTLS_ERROR_C
+
+/* Hardware acceleration through the ChibiOS HAL crypto driver, set
+ * MBEDTLS_CHIBIOS_USE_CRY to FALSE for the software implementations. */
+#include "mbedtls_alt.h"
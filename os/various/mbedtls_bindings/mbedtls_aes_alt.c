@@ -0,0 +1,324 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * MBEDTLS_AES_ALT implementation on the ChibiOS HAL crypto driver. ECB, CBC
+ * and CTR run on the crypto unit when the LLD supports them, the other
+ * modes are built on top of the ECB block operation.
+ */
+
+#include <string.h>
+
+#include "mbedtls/aes.h"
+#include "mbedtls/error.h"
+#include "mbedtls/platform_util.h"
+
+#if defined(MBEDTLS_AES_ALT)
+
+#include "mbedtls_cry.h"
+
+#define AES_BLOCK               16U
+
+/* Runs one crypto unit operation with the context key loaded.*/
+#define AES_RUN(ctx, op)                                                    \
+  do {                                                                      \
+    cryerror_t err;                                                         \
+    (void)mbedtls_chibios_cry_acquire();                                    \
+    err = mbedtls_chibios_cry_load_key((ctx), (ctx)->keylen, (ctx)->key);   \
+    if (err == CRY_NOERROR)                                                 \
+      err = (op);                                                           \
+    mbedtls_chibios_cry_release();                                          \
+    if (err != CRY_NOERROR)                                                 \
+      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;                          \
+  } while (false)
+
+#define CRYP                    (&MBEDTLS_CHIBIOS_CRY_DRIVER)
+#define KEY                     MBEDTLS_CHIBIOS_CRY_KEY
+
+void mbedtls_aes_init(mbedtls_aes_context *ctx) {
+
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_aes_free(mbedtls_aes_context *ctx) {
+
+  if (ctx == NULL)
+    return;
+
+  mbedtls_chibios_cry_forget_key(ctx);
+  mbedtls_platform_zeroize(ctx, sizeof(*ctx));
+}
+
+int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx,
+                           const unsigned char *key, unsigned int keybits) {
+
+  if ((keybits != 128U) && (keybits != 192U) && (keybits != 256U))
+    return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
+
+  mbedtls_chibios_cry_forget_key(ctx);
+  memcpy(ctx->key, key, keybits / 8U);
+  ctx->keylen = keybits / 8U;
+
+  return 0;
+}
+
+int mbedtls_aes_setkey_dec(mbedtls_aes_context *ctx,
+                           const unsigned char *key, unsigned int keybits) {
+
+  /* The crypto unit derives the decryption schedule itself.*/
+  return mbedtls_aes_setkey_enc(ctx, key, keybits);
+}
+
+int mbedtls_internal_aes_encrypt(mbedtls_aes_context *ctx,
+                                 const unsigned char input[16],
+                                 unsigned char output[16]) {
+
+  AES_RUN(ctx, cryEncryptAES_ECB(CRYP, KEY, AES_BLOCK, input, output));
+
+  return 0;
+}
+
+int mbedtls_internal_aes_decrypt(mbedtls_aes_context *ctx,
+                                 const unsigned char input[16],
+                                 unsigned char output[16]) {
+
+  AES_RUN(ctx, cryDecryptAES_ECB(CRYP, KEY, AES_BLOCK, input, output));
+
+  return 0;
+}
+
+int mbedtls_aes_crypt_ecb(mbedtls_aes_context *ctx, int mode,
+                          const unsigned char input[16],
+                          unsigned char output[16]) {
+
+  if (mode == MBEDTLS_AES_ENCRYPT)
+    return mbedtls_internal_aes_encrypt(ctx, input, output);
+
+  return mbedtls_internal_aes_decrypt(ctx, input, output);
+}
+
+#if defined(MBEDTLS_CIPHER_MODE_CBC)
+int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx, int mode, size_t length,
+                          unsigned char iv[16],
+                          const unsigned char *input,
+                          unsigned char *output) {
+  uint8_t next_iv[AES_BLOCK];
+
+  if ((length % AES_BLOCK) != 0U)
+    return MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH;
+  if (length == 0U)
+    return 0;
+
+  if (mode == MBEDTLS_AES_DECRYPT) {
+    /* Saved before a possible in-place operation overwrites it.*/
+    memcpy(next_iv, &input[length - AES_BLOCK], AES_BLOCK);
+#if CRY_LLD_SUPPORTS_AES_CBC == TRUE
+    AES_RUN(ctx, cryDecryptAES_CBC(CRYP, KEY, length, input, output, iv));
+#else
+    {
+      uint8_t prev[AES_BLOCK], blk[AES_BLOCK];
+      size_t i, j;
+
+      memcpy(prev, iv, AES_BLOCK);
+      for (i = 0; i < length; i += AES_BLOCK) {
+        memcpy(blk, &input[i], AES_BLOCK);
+        if (mbedtls_internal_aes_decrypt(ctx, blk, &output[i]) != 0)
+          return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+        for (j = 0; j < AES_BLOCK; j++)
+          output[i + j] ^= prev[j];
+        memcpy(prev, blk, AES_BLOCK);
+      }
+    }
+#endif
+  }
+  else {
+#if CRY_LLD_SUPPORTS_AES_CBC == TRUE
+    AES_RUN(ctx, cryEncryptAES_CBC(CRYP, KEY, length, input, output, iv));
+#else
+    {
+      const uint8_t *prev = iv;
+      size_t i, j;
+
+      for (i = 0; i < length; i += AES_BLOCK) {
+        for (j = 0; j < AES_BLOCK; j++)
+          output[i + j] = input[i + j] ^ prev[j];
+        if (mbedtls_internal_aes_encrypt(ctx, &output[i], &output[i]) != 0)
+          return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+        prev = &output[i];
+      }
+    }
+#endif
+    memcpy(next_iv, &output[length - AES_BLOCK], AES_BLOCK);
+  }
+
+  memcpy(iv, next_iv, AES_BLOCK);
+
+  return 0;
+}
+#endif /* MBEDTLS_CIPHER_MODE_CBC */
+
+#if defined(MBEDTLS_CIPHER_MODE_CFB)
+int mbedtls_aes_crypt_cfb128(mbedtls_aes_context *ctx, int mode,
+                             size_t length, size_t *iv_off,
+                             unsigned char iv[16],
+                             const unsigned char *input,
+                             unsigned char *output) {
+  size_t n = *iv_off;
+
+  if (n > 15U)
+    return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+
+  while (length-- > 0U) {
+    uint8_t c;
+
+    if (n == 0U) {
+      if (mbedtls_internal_aes_encrypt(ctx, iv, iv) != 0)
+        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    }
+
+    c = *input++;
+    *output++ = c ^ iv[n];
+    iv[n] = (mode == MBEDTLS_AES_DECRYPT) ? c : (uint8_t)(c ^ iv[n]);
+    n = (n + 1U) & 0x0FU;
+  }
+
+  *iv_off = n;
+
+  return 0;
+}
+
+int mbedtls_aes_crypt_cfb8(mbedtls_aes_context *ctx, int mode,
+                           size_t length, unsigned char iv[16],
+                           const unsigned char *input,
+                           unsigned char *output) {
+  uint8_t ov[AES_BLOCK + 1U];
+
+  while (length-- > 0U) {
+    uint8_t c;
+
+    memcpy(ov, iv, AES_BLOCK);
+    if (mbedtls_internal_aes_encrypt(ctx, iv, iv) != 0)
+      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+
+    if (mode == MBEDTLS_AES_DECRYPT)
+      ov[AES_BLOCK] = *input;
+
+    c = *output++ = (uint8_t)(iv[0] ^ *input++);
+
+    if (mode == MBEDTLS_AES_ENCRYPT)
+      ov[AES_BLOCK] = c;
+
+    memcpy(iv, &ov[1], AES_BLOCK);
+  }
+
+  return 0;
+}
+#endif /* MBEDTLS_CIPHER_MODE_CFB */
+
+#if defined(MBEDTLS_CIPHER_MODE_OFB)
+int mbedtls_aes_crypt_ofb(mbedtls_aes_context *ctx, size_t length,
+                          size_t *iv_off, unsigned char iv[16],
+                          const unsigned char *input,
+                          unsigned char *output) {
+  size_t n = *iv_off;
+
+  if (n > 15U)
+    return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+
+  while (length-- > 0U) {
+    if (n == 0U) {
+      if (mbedtls_internal_aes_encrypt(ctx, iv, iv) != 0)
+        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    }
+    *output++ = *input++ ^ iv[n];
+    n = (n + 1U) & 0x0FU;
+  }
+
+  *iv_off = n;
+
+  return 0;
+}
+#endif /* MBEDTLS_CIPHER_MODE_OFB */
+
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+/* Adds n to a 128 bits big endian counter.*/
+static void ctr_add(uint8_t ctr[16], uint32_t n) {
+  unsigned i = AES_BLOCK;
+  uint32_t carry = n;
+
+  while ((i > 0U) && (carry != 0U)) {
+    carry += ctr[--i];
+    ctr[i] = (uint8_t)carry;
+    carry >>= 8;
+  }
+}
+
+int mbedtls_aes_crypt_ctr(mbedtls_aes_context *ctx, size_t length,
+                          size_t *nc_off, unsigned char nonce_counter[16],
+                          unsigned char stream_block[16],
+                          const unsigned char *input,
+                          unsigned char *output) {
+  size_t n = *nc_off;
+
+  if (n > 15U)
+    return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+
+  /* Leftover of the previous stream block.*/
+  while ((n != 0U) && (length > 0U)) {
+    *output++ = *input++ ^ stream_block[n];
+    n = (n + 1U) & 0x0FU;
+    length--;
+  }
+
+#if CRY_LLD_SUPPORTS_AES_CTR == TRUE
+  /* Whole blocks on the crypto unit, split where the low counter word
+     wraps because the unit only increments that word.*/
+  while (length >= AES_BLOCK) {
+    uint32_t low = ((uint32_t)nonce_counter[12] << 24) |
+                   ((uint32_t)nonce_counter[13] << 16) |
+                   ((uint32_t)nonce_counter[14] << 8) |
+                   (uint32_t)nonce_counter[15];
+    size_t blocks = length / AES_BLOCK;
+
+    if ((low != 0U) && (blocks > (size_t)(0U - low)))
+      blocks = (size_t)(0U - low);
+
+    AES_RUN(ctx, cryEncryptAES_CTR(CRYP, KEY, blocks * AES_BLOCK,
+                                   input, output, nonce_counter));
+    ctr_add(nonce_counter, (uint32_t)blocks);
+    input  += blocks * AES_BLOCK;
+    output += blocks * AES_BLOCK;
+    length -= blocks * AES_BLOCK;
+  }
+#endif
+
+  while (length-- > 0U) {
+    if (n == 0U) {
+      if (mbedtls_internal_aes_encrypt(ctx, nonce_counter, stream_block) != 0)
+        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      ctr_add(nonce_counter, 1U);
+    }
+    *output++ = *input++ ^ stream_block[n];
+    n = (n + 1U) & 0x0FU;
+  }
+
+  *nc_off = n;
+
+  return 0;
+}
+#endif /* MBEDTLS_CIPHER_MODE_CTR */
+
+#endif /* MBEDTLS_AES_ALT */
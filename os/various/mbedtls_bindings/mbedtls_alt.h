@@ -0,0 +1,87 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Hardware acceleration glue, to be included at the end of the mbedtls
+ * configuration file. With MBEDTLS_CHIBIOS_USE_CRY set to TRUE the
+ * MBEDTLS_*_ALT implementations route the enabled algorithms to the ChibiOS
+ * HAL crypto driver, the mbedtls software implementations are used for all
+ * the others. This file is seen by every mbedtls source so it does not
+ * include the HAL, the driver capabilities are checked in mbedtls_cry.h.
+ */
+
+#ifndef MBEDTLS_ALT_H
+#define MBEDTLS_ALT_H
+
+/* Same values as the ChibiOS ones, the mbedtls sources do not see them. */
+#if !defined(FALSE)
+#define FALSE                                 0
+#endif
+
+#if !defined(TRUE)
+#define TRUE                                  1
+#endif
+
+/* Requires HAL_USE_CRY. */
+#if !defined(MBEDTLS_CHIBIOS_USE_CRY)
+#define MBEDTLS_CHIBIOS_USE_CRY               FALSE
+#endif
+
+/* Algorithms routed to the crypto driver, the ones the LLD does not
+   support need HAL_CRY_USE_FALLBACK or have to be disabled here. */
+#if !defined(MBEDTLS_CHIBIOS_CRY_USE_AES)
+#define MBEDTLS_CHIBIOS_CRY_USE_AES           TRUE
+#endif
+
+#if !defined(MBEDTLS_CHIBIOS_CRY_USE_GCM)
+#define MBEDTLS_CHIBIOS_CRY_USE_GCM           TRUE
+#endif
+
+#if !defined(MBEDTLS_CHIBIOS_CRY_USE_SHA1)
+#define MBEDTLS_CHIBIOS_CRY_USE_SHA1          TRUE
+#endif
+
+#if !defined(MBEDTLS_CHIBIOS_CRY_USE_SHA256)
+#define MBEDTLS_CHIBIOS_CRY_USE_SHA256        TRUE
+#endif
+
+#if MBEDTLS_CHIBIOS_USE_CRY == TRUE
+
+/* XTS is not offered by the HAL and cannot be built on top of the other
+   modes without the software key schedule. */
+#if (MBEDTLS_CHIBIOS_CRY_USE_AES == TRUE) && !defined(MBEDTLS_CIPHER_MODE_XTS)
+#define MBEDTLS_AES_ALT
+#endif
+
+/* The GCM implementation needs the AES one for the non 96 bits IVs and
+   the multi-part API. */
+#if (MBEDTLS_CHIBIOS_CRY_USE_GCM == TRUE) && defined(MBEDTLS_AES_ALT)
+#define MBEDTLS_GCM_ALT
+#endif
+
+#if MBEDTLS_CHIBIOS_CRY_USE_SHA1 == TRUE
+#define MBEDTLS_SHA1_ALT
+#endif
+
+/* SHA-224 shares the mbedtls SHA-256 context, it is not offered by the
+   HAL. */
+#if (MBEDTLS_CHIBIOS_CRY_USE_SHA256 == TRUE) && !defined(MBEDTLS_SHA224_C)
+#define MBEDTLS_SHA256_ALT
+#endif
+
+#endif /* MBEDTLS_CHIBIOS_USE_CRY == TRUE */
+
+#endif /* MBEDTLS_ALT_H */
@@ -0,0 +1,214 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Crypto unit ownership for the MBEDTLS_*_ALT implementations. The unit
+ * has a single transient key and may keep state between the calls of an
+ * operation, so every operation runs with the driver mutex taken. The
+ * transient key is reloaded only when the owning context changes.
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#include "mbedtls/aes.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/sha1.h"
+#include "mbedtls/sha256.h"
+
+#include "mbedtls_cry.h"
+
+#if defined(HAL_USE_CRY) && (HAL_USE_CRY == TRUE)
+
+static MUTEX_DECL(cry_mtx);
+static const void *cry_key_owner;
+
+CRYDriver *mbedtls_chibios_cry_acquire(void) {
+
+  chMtxLock(&cry_mtx);
+
+  /* Started on first use.*/
+  if (MBEDTLS_CHIBIOS_CRY_DRIVER.state == CRY_STOP) {
+    cryStart(&MBEDTLS_CHIBIOS_CRY_DRIVER, MBEDTLS_CHIBIOS_CRY_CONFIG);
+    cry_key_owner = NULL;
+  }
+
+  return &MBEDTLS_CHIBIOS_CRY_DRIVER;
+}
+
+void mbedtls_chibios_cry_release(void) {
+
+  chMtxUnlock(&cry_mtx);
+}
+
+/*
+ * Loads the AES transient key of a context, must be called between
+ * acquire and release.
+ */
+cryerror_t mbedtls_chibios_cry_load_key(const void *owner,
+                                        size_t size, const uint8_t *keyp) {
+  cryerror_t err;
+
+  if (owner == cry_key_owner)
+    return CRY_NOERROR;
+
+  err = cryLoadAESTransientKey(&MBEDTLS_CHIBIOS_CRY_DRIVER, size, keyp);
+  cry_key_owner = (err == CRY_NOERROR) ? owner : NULL;
+
+  return err;
+}
+
+/*
+ * Invalidates the loaded key, called when a context changes its key or is
+ * freed.
+ */
+void mbedtls_chibios_cry_forget_key(const void *owner) {
+
+  chSysLock();
+  if (cry_key_owner == owner)
+    cry_key_owner = NULL;
+  chSysUnlock();
+}
+
+#endif /* HAL_USE_CRY == TRUE */
+
+/*===========================================================================*/
+/* Throughput benchmark.                                                     */
+/*===========================================================================*/
+
+#if MBEDTLS_CHIBIOS_USE_BENCHMARK == TRUE
+
+#include "chprintf.h"
+
+#define BENCH_BUFSIZE           1024U
+#define BENCH_TIME              TIME_MS2I(500)
+
+#if !defined(SHELL_NEWLINE_STR)
+#define SHELL_NEWLINE_STR       "\r\n"
+#endif
+
+static uint8_t bench_buf[BENCH_BUFSIZE];
+
+static void bench_report(BaseSequentialStream *chp, const char *name,
+                         uint32_t bytes, sysinterval_t elapsed) {
+  uint32_t ms = (uint32_t)TIME_I2MS(elapsed);
+
+  if (ms == 0U)
+    ms = 1U;
+  chprintf(chp, "%-16s %8u kB/s" SHELL_NEWLINE_STR, name,
+           (unsigned)((bytes / ms) * 1000U / 1024U));
+}
+
+#define BENCH_RUN(chp, name, op)                                            \
+  do {                                                                      \
+    systime_t start = chVTGetSystemTime();                                  \
+    uint32_t bytes = 0;                                                     \
+    while (chVTTimeElapsedSinceX(start) < BENCH_TIME) {                     \
+      op;                                                                   \
+      bytes += BENCH_BUFSIZE;                                               \
+    }                                                                       \
+    bench_report(chp, name, bytes, chVTTimeElapsedSinceX(start));           \
+  } while (false)
+
+/*
+ * Prints the throughput of each algorithm through the mbedtls API, so that
+ * the locking and key reload overheads are accounted for. Building with
+ * MBEDTLS_CHIBIOS_USE_CRY set to FALSE gives the software figures.
+ */
+void mbedtls_chibios_cry_benchmark(BaseSequentialStream *chp) {
+  static const uint8_t key[32] = {0};
+  uint8_t iv[16], tag[16];
+  uint8_t out[32];
+
+  (void)key;
+  (void)iv;
+  (void)tag;
+  (void)out;
+
+  chprintf(chp, "mbedtls throughput, %u bytes per call, %s" SHELL_NEWLINE_STR,
+           (unsigned)BENCH_BUFSIZE,
+#if defined(MBEDTLS_AES_ALT) || defined(MBEDTLS_SHA256_ALT)
+           "hardware"
+#else
+           "software"
+#endif
+           );
+
+#if defined(MBEDTLS_AES_C)
+  {
+    mbedtls_aes_context aes;
+    size_t i;
+
+    mbedtls_aes_init(&aes);
+    mbedtls_aes_setkey_enc(&aes, key, 128);
+    BENCH_RUN(chp, "AES-128-ECB", {
+      for (i = 0; i < BENCH_BUFSIZE; i += 16U)
+        mbedtls_aes_crypt_ecb(&aes, MBEDTLS_AES_ENCRYPT,
+                              &bench_buf[i], &bench_buf[i]);
+    });
+#if defined(MBEDTLS_CIPHER_MODE_CBC)
+    memset(iv, 0, sizeof(iv));
+    BENCH_RUN(chp, "AES-128-CBC", mbedtls_aes_crypt_cbc(&aes,
+                                                        MBEDTLS_AES_ENCRYPT,
+                                                        BENCH_BUFSIZE, iv,
+                                                        bench_buf,
+                                                        bench_buf));
+#endif
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+    {
+      size_t nc_off = 0;
+
+      memset(iv, 0, sizeof(iv));
+      BENCH_RUN(chp, "AES-128-CTR", mbedtls_aes_crypt_ctr(&aes,
+                                                          BENCH_BUFSIZE,
+                                                          &nc_off, iv, out,
+                                                          bench_buf,
+                                                          bench_buf));
+    }
+#endif
+    mbedtls_aes_free(&aes);
+  }
+#endif
+
+#if defined(MBEDTLS_GCM_C)
+  {
+    mbedtls_gcm_context gcm;
+
+    mbedtls_gcm_init(&gcm);
+    mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, 128);
+    memset(iv, 0, sizeof(iv));
+    BENCH_RUN(chp, "AES-128-GCM", mbedtls_gcm_crypt_and_tag(&gcm,
+                                                            MBEDTLS_GCM_ENCRYPT,
+                                                            BENCH_BUFSIZE,
+                                                            iv, 12, NULL, 0,
+                                                            bench_buf,
+                                                            bench_buf,
+                                                            16, tag));
+    mbedtls_gcm_free(&gcm);
+  }
+#endif
+
+#if defined(MBEDTLS_SHA1_C)
+  BENCH_RUN(chp, "SHA-1", mbedtls_sha1(bench_buf, BENCH_BUFSIZE, out));
+#endif
+
+#if defined(MBEDTLS_SHA256_C)
+  BENCH_RUN(chp, "SHA-256", mbedtls_sha256(bench_buf, BENCH_BUFSIZE, out, 0));
+#endif
+}
+
+#endif /* MBEDTLS_CHIBIOS_USE_BENCHMARK == TRUE */
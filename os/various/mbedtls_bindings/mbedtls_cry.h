@@ -0,0 +1,94 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef MBEDTLS_CRY_H
+#define MBEDTLS_CRY_H
+
+#include "hal.h"
+
+/* Builds mbedtls_chibios_cry_benchmark(), it requires chprintf(). */
+#if !defined(MBEDTLS_CHIBIOS_USE_BENCHMARK)
+#define MBEDTLS_CHIBIOS_USE_BENCHMARK         FALSE
+#endif
+
+#if defined(MBEDTLS_AES_ALT) || defined(MBEDTLS_GCM_ALT) || \
+    defined(MBEDTLS_SHA1_ALT) || defined(MBEDTLS_SHA256_ALT)
+#if !defined(HAL_USE_CRY) || (HAL_USE_CRY == FALSE)
+#error "MBEDTLS_CHIBIOS_USE_CRY requires HAL_USE_CRY"
+#endif
+
+#if !defined(HAL_CRY_USE_FALLBACK) || (HAL_CRY_USE_FALLBACK == FALSE)
+#if defined(MBEDTLS_AES_ALT) && (CRY_LLD_SUPPORTS_AES_ECB == FALSE)
+#error "AES-ECB not supported by the LLD, disable MBEDTLS_CHIBIOS_CRY_USE_AES"
+#endif
+#if defined(MBEDTLS_GCM_ALT) && (CRY_LLD_SUPPORTS_AES_GCM == FALSE)
+#error "AES-GCM not supported by the LLD, disable MBEDTLS_CHIBIOS_CRY_USE_GCM"
+#endif
+#if defined(MBEDTLS_SHA1_ALT) && (CRY_LLD_SUPPORTS_SHA1 == FALSE)
+#error "SHA-1 not supported by the LLD, disable MBEDTLS_CHIBIOS_CRY_USE_SHA1"
+#endif
+#if defined(MBEDTLS_SHA256_ALT) && (CRY_LLD_SUPPORTS_SHA256 == FALSE)
+#error "SHA-256 not supported by the LLD, disable MBEDTLS_CHIBIOS_CRY_USE_SHA256"
+#endif
+#endif /* HAL_CRY_USE_FALLBACK == FALSE */
+#endif /* MBEDTLS_*_ALT */
+
+#if defined(HAL_USE_CRY) && (HAL_USE_CRY == TRUE)
+
+/* Crypto driver used by the MBEDTLS_*_ALT implementations. */
+#if !defined(MBEDTLS_CHIBIOS_CRY_DRIVER)
+#define MBEDTLS_CHIBIOS_CRY_DRIVER            CRYD1
+#endif
+
+/* Configuration passed to cryStart(), NULL if the LLD does not need one. */
+#if !defined(MBEDTLS_CHIBIOS_CRY_CONFIG)
+#define MBEDTLS_CHIBIOS_CRY_CONFIG            NULL
+#endif
+
+/* 32 bits counter value passed in the last word of the 128 bits GCM IV,
+   the value the hardware expects for the first encrypted block. */
+#if !defined(MBEDTLS_CHIBIOS_GCM_IV_COUNTER)
+#define MBEDTLS_CHIBIOS_GCM_IV_COUNTER        2U
+#endif
+
+/* Transient key identifier. */
+#define MBEDTLS_CHIBIOS_CRY_KEY               ((crykey_t)0)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  CRYDriver *mbedtls_chibios_cry_acquire(void);
+  void mbedtls_chibios_cry_release(void);
+  cryerror_t mbedtls_chibios_cry_load_key(const void *owner,
+                                          size_t size, const uint8_t *keyp);
+  void mbedtls_chibios_cry_forget_key(const void *owner);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CRY == TRUE */
+
+#if MBEDTLS_CHIBIOS_USE_BENCHMARK == TRUE
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void mbedtls_chibios_cry_benchmark(BaseSequentialStream *chp);
+#ifdef __cplusplus
+}
+#endif
+#endif /* MBEDTLS_CHIBIOS_USE_BENCHMARK == TRUE */
+
+#endif /* MBEDTLS_CRY_H */
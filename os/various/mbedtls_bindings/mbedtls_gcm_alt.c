@@ -0,0 +1,371 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * MBEDTLS_GCM_ALT implementation on the ChibiOS HAL crypto driver.
+ * One-shot operations with a 96 bits IV, the only ones used by the TLS
+ * record layer, run entirely on the crypto unit. The multi-part API and
+ * other IV sizes use a software GHASH over the accelerated AES.
+ */
+
+#include <string.h>
+
+#include "mbedtls/gcm.h"
+#include "mbedtls/error.h"
+#include "mbedtls/platform_util.h"
+
+#if defined(MBEDTLS_GCM_ALT)
+
+#include "mbedtls_cry.h"
+
+#define GCM_BLOCK               16U
+
+/*
+ * GF(2^128) multiplication of x by the hash subkey, bitwise.
+ */
+static void gcm_mult(const mbedtls_gcm_context *ctx, uint8_t x[16]) {
+  uint8_t z[GCM_BLOCK] = {0};
+  uint8_t v[GCM_BLOCK];
+  unsigned i, j;
+
+  memcpy(v, ctx->h, GCM_BLOCK);
+
+  for (i = 0; i < GCM_BLOCK * 8U; i++) {
+    uint8_t lsb;
+
+    if ((x[i / 8U] & (0x80U >> (i % 8U))) != 0U) {
+      for (j = 0; j < GCM_BLOCK; j++)
+        z[j] ^= v[j];
+    }
+
+    lsb = v[GCM_BLOCK - 1U] & 1U;
+    for (j = GCM_BLOCK - 1U; j > 0U; j--)
+      v[j] = (uint8_t)((v[j] >> 1) | (v[j - 1U] << 7));
+    v[0] >>= 1;
+    if (lsb != 0U)
+      v[0] ^= 0xE1U;
+  }
+
+  memcpy(x, z, GCM_BLOCK);
+}
+
+static void gcm_inc32(uint8_t y[16]) {
+  unsigned i = GCM_BLOCK;
+
+  while ((i > GCM_BLOCK - 4U) && (++y[--i] == 0U))
+    ;
+}
+
+static void gcm_put_be64(uint8_t *p, uint64_t v) {
+  unsigned i;
+
+  for (i = 0; i < 8U; i++)
+    p[i] = (uint8_t)(v >> (56U - (8U * i)));
+}
+
+void mbedtls_gcm_init(mbedtls_gcm_context *ctx) {
+
+  memset(ctx, 0, sizeof(*ctx));
+  mbedtls_aes_init(&ctx->aes);
+}
+
+void mbedtls_gcm_free(mbedtls_gcm_context *ctx) {
+
+  if (ctx == NULL)
+    return;
+
+  mbedtls_aes_free(&ctx->aes);
+  mbedtls_platform_zeroize(ctx, sizeof(*ctx));
+}
+
+int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx, mbedtls_cipher_id_t cipher,
+                       const unsigned char *key, unsigned int keybits) {
+  int ret;
+
+  if (cipher != MBEDTLS_CIPHER_ID_AES)
+    return MBEDTLS_ERR_GCM_BAD_INPUT;
+
+  ret = mbedtls_aes_setkey_enc(&ctx->aes, key, keybits);
+  if (ret != 0)
+    return ret;
+
+  /* Hash subkey.*/
+  memset(ctx->h, 0, GCM_BLOCK);
+  return mbedtls_aes_crypt_ecb(&ctx->aes, MBEDTLS_AES_ENCRYPT,
+                               ctx->h, ctx->h);
+}
+
+int mbedtls_gcm_starts(mbedtls_gcm_context *ctx, int mode,
+                       const unsigned char *iv, size_t iv_len) {
+  int ret;
+
+  if ((iv_len == 0U) || (((uint64_t)iv_len >> 61) != 0U))
+    return MBEDTLS_ERR_GCM_BAD_INPUT;
+
+  memset(ctx->y, 0, GCM_BLOCK);
+  memset(ctx->buf, 0, GCM_BLOCK);
+  ctx->mode    = mode;
+  ctx->len     = 0;
+  ctx->add_len = 0;
+
+  if (iv_len == 12U) {
+    memcpy(ctx->y, iv, 12U);
+    ctx->y[15] = 1U;
+  }
+  else {
+    /* J0 = GHASH(IV || 0^s+64 || [len(IV)]64).*/
+    size_t i;
+
+    while (iv_len > 0U) {
+      size_t n = (iv_len < GCM_BLOCK) ? iv_len : GCM_BLOCK;
+
+      for (i = 0; i < n; i++)
+        ctx->y[i] ^= iv[i];
+      gcm_mult(ctx, ctx->y);
+      ctx->len += n;
+      iv += n;
+      iv_len -= n;
+    }
+    memset(ctx->buf, 0, GCM_BLOCK);
+    gcm_put_be64(&ctx->buf[8], ctx->len * 8U);
+    for (i = 0; i < GCM_BLOCK; i++)
+      ctx->y[i] ^= ctx->buf[i];
+    gcm_mult(ctx, ctx->y);
+    memset(ctx->buf, 0, GCM_BLOCK);
+    ctx->len = 0;
+  }
+
+  ret = mbedtls_aes_crypt_ecb(&ctx->aes, MBEDTLS_AES_ENCRYPT,
+                              ctx->y, ctx->ek0);
+
+  return ret;
+}
+
+int mbedtls_gcm_update_ad(mbedtls_gcm_context *ctx,
+                          const unsigned char *add, size_t add_len) {
+
+  /* Additional data must precede the text.*/
+  if (ctx->len != 0U)
+    return MBEDTLS_ERR_GCM_BAD_INPUT;
+
+  while (add_len-- > 0U) {
+    unsigned off = (unsigned)(ctx->add_len % GCM_BLOCK);
+
+    ctx->buf[off] ^= *add++;
+    ctx->add_len++;
+    if (off == GCM_BLOCK - 1U)
+      gcm_mult(ctx, ctx->buf);
+  }
+
+  return 0;
+}
+
+int mbedtls_gcm_update(mbedtls_gcm_context *ctx,
+                       const unsigned char *input, size_t input_length,
+                       unsigned char *output, size_t output_size,
+                       size_t *output_length) {
+
+  if (output_size < input_length)
+    return MBEDTLS_ERR_GCM_BUFFER_TOO_SMALL;
+  *output_length = input_length;
+
+  /* Closing a partial block of additional data.*/
+  if ((ctx->len == 0U) && (input_length > 0U) &&
+      ((ctx->add_len % GCM_BLOCK) != 0U))
+    gcm_mult(ctx, ctx->buf);
+
+  while (input_length-- > 0U) {
+    unsigned off = (unsigned)(ctx->len % GCM_BLOCK);
+    uint8_t c;
+
+    if (off == 0U) {
+      gcm_inc32(ctx->y);
+      if (mbedtls_aes_crypt_ecb(&ctx->aes, MBEDTLS_AES_ENCRYPT,
+                                ctx->y, ctx->ectr) != 0)
+        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    }
+
+    /* The input byte is read first, the operation can be in-place.*/
+    c = *input++;
+    *output = c ^ ctx->ectr[off];
+    ctx->buf[off] ^= (ctx->mode == MBEDTLS_GCM_DECRYPT) ? c : *output;
+    output++;
+    ctx->len++;
+    if (off == GCM_BLOCK - 1U)
+      gcm_mult(ctx, ctx->buf);
+  }
+
+  return 0;
+}
+
+int mbedtls_gcm_finish(mbedtls_gcm_context *ctx,
+                       unsigned char *output, size_t output_size,
+                       size_t *output_length,
+                       unsigned char *tag, size_t tag_len) {
+  uint8_t lens[GCM_BLOCK];
+  unsigned i;
+
+  (void)output;
+  (void)output_size;
+  *output_length = 0;
+
+  if ((tag_len < 4U) || (tag_len > GCM_BLOCK))
+    return MBEDTLS_ERR_GCM_BAD_INPUT;
+
+  if (((ctx->len % GCM_BLOCK) != 0U) ||
+      ((ctx->len == 0U) && ((ctx->add_len % GCM_BLOCK) != 0U)))
+    gcm_mult(ctx, ctx->buf);
+
+  gcm_put_be64(&lens[0], ctx->add_len * 8U);
+  gcm_put_be64(&lens[8], ctx->len * 8U);
+  for (i = 0; i < GCM_BLOCK; i++)
+    ctx->buf[i] ^= lens[i];
+  gcm_mult(ctx, ctx->buf);
+
+  for (i = 0; i < tag_len; i++)
+    tag[i] = ctx->buf[i] ^ ctx->ek0[i];
+
+  return 0;
+}
+
+/*
+ * Multi-part path used for IVs other than 96 bits.
+ */
+static int gcm_crypt_and_tag_sw(mbedtls_gcm_context *ctx, int mode,
+                                size_t length,
+                                const unsigned char *iv, size_t iv_len,
+                                const unsigned char *add, size_t add_len,
+                                const unsigned char *input,
+                                unsigned char *output,
+                                size_t tag_len, unsigned char *tag) {
+  size_t olen;
+  int ret;
+
+  if ((ret = mbedtls_gcm_starts(ctx, mode, iv, iv_len)) != 0)
+    return ret;
+  if ((ret = mbedtls_gcm_update_ad(ctx, add, add_len)) != 0)
+    return ret;
+  if ((ret = mbedtls_gcm_update(ctx, input, length,
+                                output, length, &olen)) != 0)
+    return ret;
+
+  return mbedtls_gcm_finish(ctx, NULL, 0, &olen, tag, tag_len);
+}
+
+/*
+ * One-shot operation on the crypto unit, 96 bits IV only. On decryption
+ * the unit checks the tag.
+ */
+static int gcm_crypt_hw(mbedtls_gcm_context *ctx, int mode, size_t length,
+                        const unsigned char *iv,
+                        const unsigned char *add, size_t add_len,
+                        const unsigned char *input, unsigned char *output,
+                        size_t tag_len, unsigned char *tag) {
+  uint8_t icb[GCM_BLOCK];
+  cryerror_t err;
+
+  memcpy(icb, iv, 12U);
+  icb[12] = (uint8_t)(MBEDTLS_CHIBIOS_GCM_IV_COUNTER >> 24);
+  icb[13] = (uint8_t)(MBEDTLS_CHIBIOS_GCM_IV_COUNTER >> 16);
+  icb[14] = (uint8_t)(MBEDTLS_CHIBIOS_GCM_IV_COUNTER >> 8);
+  icb[15] = (uint8_t)MBEDTLS_CHIBIOS_GCM_IV_COUNTER;
+
+  (void)mbedtls_chibios_cry_acquire();
+  err = mbedtls_chibios_cry_load_key(&ctx->aes, ctx->aes.keylen, ctx->aes.key);
+  if (err == CRY_NOERROR) {
+    if (mode == MBEDTLS_GCM_ENCRYPT)
+      err = cryEncryptAES_GCM(&MBEDTLS_CHIBIOS_CRY_DRIVER,
+                              MBEDTLS_CHIBIOS_CRY_KEY,
+                              add_len, add, length, input, output,
+                              icb, tag_len, tag);
+    else
+      err = cryDecryptAES_GCM(&MBEDTLS_CHIBIOS_CRY_DRIVER,
+                              MBEDTLS_CHIBIOS_CRY_KEY,
+                              add_len, add, length, input, output,
+                              icb, tag_len, tag);
+  }
+  mbedtls_chibios_cry_release();
+
+  if (err == CRY_ERR_AUTH_FAILED)
+    return MBEDTLS_ERR_GCM_AUTH_FAILED;
+  if (err != CRY_NOERROR)
+    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+
+  return 0;
+}
+
+int mbedtls_gcm_crypt_and_tag(mbedtls_gcm_context *ctx, int mode,
+                              size_t length,
+                              const unsigned char *iv, size_t iv_len,
+                              const unsigned char *add, size_t add_len,
+                              const unsigned char *input,
+                              unsigned char *output,
+                              size_t tag_len, unsigned char *tag) {
+
+  if ((tag_len < 4U) || (tag_len > GCM_BLOCK))
+    return MBEDTLS_ERR_GCM_BAD_INPUT;
+
+  /* Decryption here computes the tag instead of checking it, something
+     the crypto unit does not offer.*/
+  if ((iv_len == 12U) && (mode == MBEDTLS_GCM_ENCRYPT))
+    return gcm_crypt_hw(ctx, mode, length, iv, add, add_len,
+                        input, output, tag_len, tag);
+
+  return gcm_crypt_and_tag_sw(ctx, mode, length, iv, iv_len,
+                              add, add_len, input, output, tag_len, tag);
+}
+
+int mbedtls_gcm_auth_decrypt(mbedtls_gcm_context *ctx, size_t length,
+                             const unsigned char *iv, size_t iv_len,
+                             const unsigned char *add, size_t add_len,
+                             const unsigned char *tag, size_t tag_len,
+                             const unsigned char *input,
+                             unsigned char *output) {
+  uint8_t check_tag[GCM_BLOCK];
+  uint8_t diff = 0;
+  size_t i;
+  int ret;
+
+  if ((tag_len < 4U) || (tag_len > GCM_BLOCK))
+    return MBEDTLS_ERR_GCM_BAD_INPUT;
+
+  if (iv_len == 12U) {
+    memcpy(check_tag, tag, tag_len);
+    ret = gcm_crypt_hw(ctx, MBEDTLS_GCM_DECRYPT, length, iv, add, add_len,
+                       input, output, tag_len, check_tag);
+    if (ret == MBEDTLS_ERR_GCM_AUTH_FAILED)
+      mbedtls_platform_zeroize(output, length);
+    return ret;
+  }
+
+  ret = gcm_crypt_and_tag_sw(ctx, MBEDTLS_GCM_DECRYPT, length, iv, iv_len,
+                             add, add_len, input, output, tag_len, check_tag);
+  if (ret != 0)
+    return ret;
+
+  /* Constant time comparison.*/
+  for (i = 0; i < tag_len; i++)
+    diff |= tag[i] ^ check_tag[i];
+
+  if (diff != 0U) {
+    mbedtls_platform_zeroize(output, length);
+    return MBEDTLS_ERR_GCM_AUTH_FAILED;
+  }
+
+  return 0;
+}
+
+#endif /* MBEDTLS_GCM_ALT */
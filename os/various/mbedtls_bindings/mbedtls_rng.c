@@ -14,12 +14,40 @@
     limitations under the License.
 */
 
+#include <string.h>
+
 #include "ch.h"
 
 #include "mbedtls/platform.h"
 #include "mbedtls/entropy.h"
 #include "mbedtls/ctr_drbg.h"
 
+#include "mbedtls_rng.h"
+
+#if defined(HAL_USE_TRNG) && (HAL_USE_TRNG==TRUE) && \
+    defined(STM32_TRNG_USE_RNG1) && (STM32_TRNG_USE_RNG1==TRUE)
+#if MBEDTLS_CHIBIOS_USE_DRBG == TRUE
+#define RNG_USE_DRBG                          TRUE
+#include "hwdrbg.inc"
+#else
+#include "hwrng.inc"
+#endif
+#else
+#include "swrng.inc"
+#endif
+
+#if !defined(RNG_USE_DRBG)
+#define RNG_USE_DRBG                          FALSE
+#endif
+
+#if (MBEDTLS_CHIBIOS_USE_DRBG == TRUE) && (RNG_USE_DRBG == FALSE)
+/* No hardware TRNG, the DRBG is not built and has nothing to report.*/
+void mbedtls_chibios_drbg_get_stats(mbedtls_chibios_drbg_stats_t *stats) {
+
+  memset(stats, 0, sizeof(*stats));
+}
+#endif
+
 void mbedtls_ctr_drbg_free(mbedtls_ctr_drbg_context *ctx) {
 
   (void)ctx;
@@ -37,7 +65,13 @@ void mbedtls_entropy_init(mbedtls_entropy_context *ctx) {
 
 int mbedtls_entropy_func(void *data, unsigned char *output, size_t len) {
 
+#if RNG_USE_DRBG == TRUE
+  (void)data;
+
+  return drbg_entropy(output, len);
+#else
   return mbedtls_ctr_drbg_random(data, output, len);
+#endif
 }
 
 int mbedtls_ctr_drbg_seed(mbedtls_ctr_drbg_context *ctx,
@@ -49,15 +83,98 @@ int mbedtls_ctr_drbg_seed(mbedtls_ctr_drbg_context *ctx,
   (void)ctx;
   (void)f_entropy;
   (void)p_entropy;
+
+#if RNG_USE_DRBG == TRUE
+  return drbg_seed(custom, len);
+#else
   (void)custom;
   (void)len;
 
   return 0;
+#endif
 }
 
-#if defined(HAL_USE_TRNG) && (HAL_USE_TRNG==TRUE) && \
-    defined(STM32_TRNG_USE_RNG1) && (STM32_TRNG_USE_RNG1==TRUE)
-#include "hwrng.inc"
+/*===========================================================================*/
+/* Handshake latency benchmark.                                              */
+/*===========================================================================*/
+
+#if MBEDTLS_CHIBIOS_USE_BENCHMARK == TRUE
+
+#include "chprintf.h"
+
+#define BENCH_HANDSHAKES        64U
+#define BENCH_GAP               TIME_MS2I(20)
+
+#if !defined(SHELL_NEWLINE_STR)
+#define SHELL_NEWLINE_STR       "\r\n"
+#endif
+
+/* Random draws of a TLS 1.2 ECDHE-ECDSA P-256 handshake: hello random,
+   ephemeral key, scalar and coordinate blinding, then the explicit nonces
+   of the first AES-GCM records.*/
+static const uint8_t bench_draws[] = {32, 32, 32, 32, 32, 8, 8, 8};
+
+#if RNG_USE_DRBG == TRUE
+static int bench_trng(void *p_rng, unsigned char *output, size_t len) {
+
+  (void)p_rng;
+
+  return trngGenerate(&TRNGD1, len, output) ?
+         MBEDTLS_ERR_CTR_DRBG_ENTROPY_SOURCE_FAILED : 0;
+}
+#endif
+
+/*
+ * Runs the handshake draws with some idle time in between, like the
+ * network round trips would give, and reports the time spent in the RNG.
+ */
+static void bench_run(BaseSequentialStream *chp, const char *name,
+                      int (*f_rng)(void *, unsigned char *, size_t)) {
+  uint8_t buf[32];
+  rtcnt_t total = 0, worst = 0;
+  bool ok = true;
+  unsigned i, j;
+
+  for (i = 0; i < BENCH_HANDSHAKES; i++) {
+    rtcnt_t start = chSysGetRealtimeCounterX();
+    rtcnt_t elapsed;
+
+    for (j = 0; j < sizeof(bench_draws); j++) {
+      if (f_rng(NULL, buf, bench_draws[j]) != 0)
+        ok = false;
+    }
+    elapsed = chSysGetRealtimeCounterX() - start;
+    total += elapsed;
+    if (elapsed > worst)
+      worst = elapsed;
+
+    chThdSleep(BENCH_GAP);
+  }
+
+  chprintf(chp, "%-16s %8u avg %8u worst cycles/handshake%s" SHELL_NEWLINE_STR,
+           name, (unsigned)(total / BENCH_HANDSHAKES), (unsigned)worst,
+           ok ? "" : " (failed)");
+}
+
+/*
+ * Compares the RNG cost of a TLS handshake on the DRBG pool against the
+ * direct TRNG path, the DRBG is instantiated beforehand.
+ */
+void mbedtls_chibios_rng_benchmark(BaseSequentialStream *chp) {
+
+  chprintf(chp, "mbedtls RNG, %u handshakes of %u draws" SHELL_NEWLINE_STR,
+           (unsigned)BENCH_HANDSHAKES, (unsigned)sizeof(bench_draws));
+
+#if RNG_USE_DRBG == TRUE
+  if (drbg_seed(NULL, 0) != 0) {
+    chprintf(chp, "DRBG instantiation failed" SHELL_NEWLINE_STR);
+    return;
+  }
+  bench_run(chp, "TRNG direct", bench_trng);
+  bench_run(chp, "DRBG pool", mbedtls_ctr_drbg_random);
 #else
-#include "swrng.inc"
+  bench_run(chp, "current path", mbedtls_ctr_drbg_random);
 #endif
+}
+
+#endif /* MBEDTLS_CHIBIOS_USE_BENCHMARK == TRUE */
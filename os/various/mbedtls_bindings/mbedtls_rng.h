@@ -0,0 +1,108 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef MBEDTLS_RNG_H
+#define MBEDTLS_RNG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "hal.h"
+
+/*
+ * Buffered CTR-DRBG front-end, only used when the hardware TRNG is
+ * available. Random requests are served from a pool which a background
+ * thread refills from an AES-256 CTR-DRBG (NIST SP 800-90A, no derivation
+ * function), the DRBG is periodically reseeded from the TRNG. The raw TRNG
+ * output passes the SP 800-90B repetition count and adaptive proportion
+ * health tests before being used.
+ */
+#if !defined(MBEDTLS_CHIBIOS_USE_DRBG)
+#define MBEDTLS_CHIBIOS_USE_DRBG              FALSE
+#endif
+
+/* Builds mbedtls_chibios_rng_benchmark(), it requires chprintf(). */
+#if !defined(MBEDTLS_CHIBIOS_USE_BENCHMARK)
+#define MBEDTLS_CHIBIOS_USE_BENCHMARK         FALSE
+#endif
+
+/* Size of the pool of pre-generated random bytes. */
+#if !defined(MBEDTLS_CHIBIOS_DRBG_POOL_SIZE)
+#define MBEDTLS_CHIBIOS_DRBG_POOL_SIZE        256
+#endif
+
+/* The background thread refills the pool below this level. */
+#if !defined(MBEDTLS_CHIBIOS_DRBG_POOL_LOW)
+#define MBEDTLS_CHIBIOS_DRBG_POOL_LOW         (MBEDTLS_CHIBIOS_DRBG_POOL_SIZE / 2)
+#endif
+
+/* Number of DRBG generate calls after which the background thread reseeds,
+   a generate call reseeds synchronously after twice as many. */
+#if !defined(MBEDTLS_CHIBIOS_DRBG_RESEED_INTERVAL)
+#define MBEDTLS_CHIBIOS_DRBG_RESEED_INTERVAL  64
+#endif
+
+#if !defined(MBEDTLS_CHIBIOS_DRBG_THREAD_PRIO)
+#define MBEDTLS_CHIBIOS_DRBG_THREAD_PRIO      (NORMALPRIO - 1)
+#endif
+
+#if !defined(MBEDTLS_CHIBIOS_DRBG_THREAD_WA_SIZE)
+#define MBEDTLS_CHIBIOS_DRBG_THREAD_WA_SIZE   512
+#endif
+
+/* Health test cutoffs, the defaults assume 4 bits of min-entropy per TRNG
+   byte and a false positive probability of 2^-20. */
+#if !defined(MBEDTLS_CHIBIOS_DRBG_RCT_CUTOFF)
+#define MBEDTLS_CHIBIOS_DRBG_RCT_CUTOFF       6
+#endif
+
+#if !defined(MBEDTLS_CHIBIOS_DRBG_APT_WINDOW)
+#define MBEDTLS_CHIBIOS_DRBG_APT_WINDOW       512
+#endif
+
+#if !defined(MBEDTLS_CHIBIOS_DRBG_APT_CUTOFF)
+#define MBEDTLS_CHIBIOS_DRBG_APT_CUTOFF       62
+#endif
+
+typedef struct {
+  /* Bytes served from the pool. */
+  uint32_t pooled;
+  /* Bytes generated in the caller thread because the pool was empty. */
+  uint32_t direct;
+  /* Pool refills done by the background thread. */
+  uint32_t refills;
+  /* Reseeds done by the background thread and synchronously. */
+  uint32_t reseeds;
+  uint32_t sync_reseeds;
+  /* Health test failures, the DRBG refuses to generate after one. */
+  uint32_t health_failures;
+} mbedtls_chibios_drbg_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if MBEDTLS_CHIBIOS_USE_DRBG == TRUE
+  void mbedtls_chibios_drbg_get_stats(mbedtls_chibios_drbg_stats_t *stats);
+#endif
+#if MBEDTLS_CHIBIOS_USE_BENCHMARK == TRUE
+  void mbedtls_chibios_rng_benchmark(BaseSequentialStream *chp);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBEDTLS_RNG_H */
@@ -0,0 +1,157 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * MBEDTLS_SHA1_ALT and MBEDTLS_SHA256_ALT implementations on the ChibiOS
+ * HAL crypto driver. The intermediate state is kept in the HAL context so
+ * several hashes may be computed at the same time, each update takes the
+ * crypto unit only for its own duration.
+ */
+
+#include <string.h>
+
+#include "mbedtls/sha1.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/error.h"
+#include "mbedtls/platform_util.h"
+
+#include "mbedtls_cry.h"
+
+#define CRYP                    (&MBEDTLS_CHIBIOS_CRY_DRIVER)
+
+/* Runs one crypto unit operation.*/
+#define SHA_RUN(op)                                                         \
+  do {                                                                      \
+    cryerror_t err;                                                         \
+    (void)mbedtls_chibios_cry_acquire();                                    \
+    err = (op);                                                             \
+    mbedtls_chibios_cry_release();                                          \
+    if (err != CRY_NOERROR)                                                 \
+      return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;                          \
+  } while (false)
+
+#if defined(MBEDTLS_SHA1_ALT)
+
+void mbedtls_sha1_init(mbedtls_sha1_context *ctx) {
+
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_sha1_free(mbedtls_sha1_context *ctx) {
+
+  if (ctx == NULL)
+    return;
+
+  mbedtls_platform_zeroize(ctx, sizeof(*ctx));
+}
+
+void mbedtls_sha1_clone(mbedtls_sha1_context *dst,
+                        const mbedtls_sha1_context *src) {
+
+  *dst = *src;
+}
+
+int mbedtls_sha1_starts(mbedtls_sha1_context *ctx) {
+
+  SHA_RUN(crySHA1Init(CRYP, &ctx->hal));
+
+  return 0;
+}
+
+int mbedtls_sha1_update(mbedtls_sha1_context *ctx,
+                        const unsigned char *input, size_t ilen) {
+
+  if (ilen == 0U)
+    return 0;
+
+  SHA_RUN(crySHA1Update(CRYP, &ctx->hal, ilen, input));
+
+  return 0;
+}
+
+int mbedtls_sha1_finish(mbedtls_sha1_context *ctx, unsigned char output[20]) {
+
+  SHA_RUN(crySHA1Final(CRYP, &ctx->hal, output));
+
+  return 0;
+}
+
+int mbedtls_internal_sha1_process(mbedtls_sha1_context *ctx,
+                                  const unsigned char data[64]) {
+
+  return mbedtls_sha1_update(ctx, data, 64U);
+}
+
+#endif /* MBEDTLS_SHA1_ALT */
+
+#if defined(MBEDTLS_SHA256_ALT)
+
+void mbedtls_sha256_init(mbedtls_sha256_context *ctx) {
+
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_sha256_free(mbedtls_sha256_context *ctx) {
+
+  if (ctx == NULL)
+    return;
+
+  mbedtls_platform_zeroize(ctx, sizeof(*ctx));
+}
+
+void mbedtls_sha256_clone(mbedtls_sha256_context *dst,
+                          const mbedtls_sha256_context *src) {
+
+  *dst = *src;
+}
+
+int mbedtls_sha256_starts(mbedtls_sha256_context *ctx, int is224) {
+
+  /* SHA-224 is not offered by the HAL.*/
+  if (is224 != 0)
+    return MBEDTLS_ERR_SHA256_BAD_INPUT_DATA;
+
+  SHA_RUN(crySHA256Init(CRYP, &ctx->hal));
+
+  return 0;
+}
+
+int mbedtls_sha256_update(mbedtls_sha256_context *ctx,
+                          const unsigned char *input, size_t ilen) {
+
+  if (ilen == 0U)
+    return 0;
+
+  SHA_RUN(crySHA256Update(CRYP, &ctx->hal, ilen, input));
+
+  return 0;
+}
+
+int mbedtls_sha256_finish(mbedtls_sha256_context *ctx,
+                          unsigned char *output) {
+
+  SHA_RUN(crySHA256Final(CRYP, &ctx->hal, output));
+
+  return 0;
+}
+
+int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx,
+                                    const unsigned char data[64]) {
+
+  return mbedtls_sha256_update(ctx, data, 64U);
+}
+
+#endif /* MBEDTLS_SHA256_ALT */
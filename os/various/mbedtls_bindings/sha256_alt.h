@@ -0,0 +1,30 @@
+/*
+    ChibiOS - Copyright (C) 2023 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * SHA-256 context for the MBEDTLS_SHA256_ALT implementation.
+ */
+
+#ifndef SHA256_ALT_H
+#define SHA256_ALT_H
+
+#include "hal.h"
+
+typedef struct mbedtls_sha256_context {
+  SHA256Context hal;
+} mbedtls_sha256_context;
+
+#endif /* SHA256_ALT_H */
@@ -44,6 +44,91 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if RAMDISK_USE_RANGE_LOCKS == TRUE
+/*
+ * Waits until the range does not overlap a write in progress, or any
+ * transfer in progress for a write, then claims it.
+ */
+static ramdisk_range_t *range_lock(RamDisk *rd, uint32_t startblk,
+                                   uint32_t n, bool write) {
+  ramdisk_range_t *rp;
+
+  osalSysLock();
+  while (true) {
+    ramdisk_range_t *freep = NULL;
+    bool busy = false;
+    unsigned i;
+
+    for (i = 0; i < RAMDISK_MAX_RANGES; i++) {
+      rp = &rd->ranges[i];
+      if (rp->n == 0U) {
+        if (freep == NULL) {
+          freep = rp;
+        }
+      }
+      else if ((write || rp->write) &&
+               (startblk < rp->start + rp->n) &&
+               (rp->start < startblk + n)) {
+        busy = true;
+      }
+    }
+
+    if (!busy && (freep != NULL)) {
+      rp = freep;
+      break;
+    }
+
+    (void) osalThreadEnqueueTimeoutS(&rd->rangeq, TIME_INFINITE);
+  }
+  rp->start = startblk;
+  rp->n     = n;
+  rp->write = write;
+  osalSysUnlock();
+
+  return rp;
+}
+
+static void range_unlock(RamDisk *rd, ramdisk_range_t *rp) {
+
+  osalSysLock();
+  rp->n = 0U;
+  osalThreadDequeueAllI(&rd->rangeq, MSG_OK);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+#endif /* RAMDISK_USE_RANGE_LOCKS == TRUE */
+
+/*
+ * Copies through the DMA channel when there is one and it is free, the
+ * CPU copies otherwise.
+ */
+static void ramdisk_copy(RamDisk *rd, void *dst, const void *src, size_t n) {
+
+#if RAMDISK_USE_DMA == TRUE
+  if ((rd->dmachp != NULL) && (n >= RAMDISK_DMA_THRESHOLD)) {
+    uint8_t *dp = dst;
+    const uint8_t *sp = src;
+
+    while (n > 0U) {
+      size_t k = n > RAMDISK_DMA_CHUNK_SIZE ? RAMDISK_DMA_CHUNK_SIZE : n;
+
+      if (dmaMemcpy(rd->dmachp, dp, sp, k) != MSG_OK) {
+        /* The DMA failed, the CPU does the chunk again.*/
+        memcpy(dp, sp, k);
+      }
+      dp += k;
+      sp += k;
+      n  -= k;
+    }
+    return;
+  }
+#else
+  (void)rd;
+#endif
+
+  memcpy(dst, src, n);
+}
+
 /*
  * Interface implementation.
  */
@@ -90,11 +175,17 @@ static bool read(void *instance, uint32_t startblk,
   if (overflow(rd, startblk, n)) {
     return HAL_FAILED;
   }
-  else {
+  else if (n > 0U) {
     const uint32_t bs = rd->blk_size;
-    memcpy(buffer, &rd->storage[startblk * bs], n * bs);
-    return HAL_SUCCESS;
+#if RAMDISK_USE_RANGE_LOCKS == TRUE
+    ramdisk_range_t *rp = range_lock(rd, startblk, n, false);
+#endif
+    ramdisk_copy(rd, buffer, &rd->storage[startblk * bs], n * bs);
+#if RAMDISK_USE_RANGE_LOCKS == TRUE
+    range_unlock(rd, rp);
+#endif
   }
+  return HAL_SUCCESS;
 }
 
 static bool write(void *instance, uint32_t startblk,
@@ -104,11 +195,17 @@ static bool write(void *instance, uint32_t startblk,
   if (overflow(rd, startblk, n)) {
     return HAL_FAILED;
   }
-  else {
+  else if (n > 0U) {
     const uint32_t bs = rd->blk_size;
-    memcpy(&rd->storage[startblk * bs], buffer, n * bs);
-    return HAL_SUCCESS;
+#if RAMDISK_USE_RANGE_LOCKS == TRUE
+    ramdisk_range_t *rp = range_lock(rd, startblk, n, true);
+#endif
+    ramdisk_copy(rd, &rd->storage[startblk * bs], buffer, n * bs);
+#if RAMDISK_USE_RANGE_LOCKS == TRUE
+    range_unlock(rd, rp);
+#endif
   }
+  return HAL_SUCCESS;
 }
 
 static bool sync(void *instance) {
@@ -169,6 +266,19 @@ void ramdiskObjectInit(RamDisk *rdp) {
 
   rdp->vmt = &vmt;
   rdp->state = BLK_STOP;
+#if RAMDISK_USE_RANGE_LOCKS == TRUE
+  {
+    unsigned i;
+
+    for (i = 0; i < RAMDISK_MAX_RANGES; i++) {
+      rdp->ranges[i].n = 0U;
+    }
+    osalThreadQueueObjectInit(&rdp->rangeq);
+  }
+#endif
+#if RAMDISK_USE_DMA == TRUE
+  rdp->dmachp = NULL;
+#endif
 }
 
 /**
@@ -217,4 +327,29 @@ void ramdiskStop(RamDisk *rdp) {
   osalSysUnlock();
 }
 
+#if (RAMDISK_USE_DMA == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Selects the DMA channel performing the copies.
+ * @details Copies of at least @p RAMDISK_DMA_THRESHOLD bytes are done by
+ *          the channel and awaited, a copy finding the channel busy with
+ *          another transfer is done by the CPU.
+ * @note    The channel must be allocated for memory to memory copies, it
+ *          can be shared with other users.
+ *
+ * @param[in] rdp       pointer to @p RamDisk object
+ * @param[in] dchp      pointer to the @p DMAChannel object, @p NULL
+ *                      reverts to CPU copies
+ *
+ * @api
+ */
+void ramdiskSetDMA(RamDisk *rdp, DMAChannel *dchp) {
+
+  osalDbgCheck(rdp != NULL);
+
+  osalSysLock();
+  rdp->dmachp = dchp;
+  osalSysUnlock();
+}
+#endif
+
 /** @} */
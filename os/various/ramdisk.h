@@ -33,16 +33,95 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @name    RAM disk configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the copies through a DMA channel, see @p ramdiskSetDMA().
+ * @note    Requires @p HAL_USE_DMACH and @p DMACH_USE_WAIT.
+ */
+#if !defined(RAMDISK_USE_DMA) || defined(__DOXYGEN__)
+#define RAMDISK_USE_DMA                 FALSE
+#endif
+
+/**
+ * @brief   Copies smaller than this size are done by the CPU.
+ */
+#if !defined(RAMDISK_DMA_THRESHOLD) || defined(__DOXYGEN__)
+#define RAMDISK_DMA_THRESHOLD           256U
+#endif
+
+/**
+ * @brief   Largest copy given at once to the DMA channel.
+ * @note    Must fit in a single @p dmaMemcpy() of the port for byte
+ *          aligned buffers.
+ */
+#if !defined(RAMDISK_DMA_CHUNK_SIZE) || defined(__DOXYGEN__)
+#define RAMDISK_DMA_CHUNK_SIZE          4096U
+#endif
+
+/**
+ * @brief   Enables the range locks.
+ * @details Transfers on overlapping block ranges are serialized unless
+ *          they are both reads, other transfers proceed concurrently.
+ */
+#if !defined(RAMDISK_USE_RANGE_LOCKS) || defined(__DOXYGEN__)
+#define RAMDISK_USE_RANGE_LOCKS         FALSE
+#endif
+
+/**
+ * @brief   Maximum number of transfers in progress on a RAM disk.
+ */
+#if !defined(RAMDISK_MAX_RANGES) || defined(__DOXYGEN__)
+#define RAMDISK_MAX_RANGES              4U
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if RAMDISK_USE_DMA == TRUE
+#if (HAL_USE_DMACH != TRUE) || (DMACH_USE_WAIT != TRUE)
+#error "RAMDISK_USE_DMA requires HAL_USE_DMACH and DMACH_USE_WAIT"
+#endif
+#endif
+
+#if (RAMDISK_USE_RANGE_LOCKS == TRUE) && (RAMDISK_MAX_RANGES < 1U)
+#error "invalid RAMDISK_MAX_RANGES value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
 
 typedef struct RamDisk RamDisk;
 
+#if (RAMDISK_USE_RANGE_LOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Block range of a transfer in progress.
+ */
+typedef struct {
+  uint32_t      start;
+  uint32_t      n;              /**< @brief Zero if the slot is free.      */
+  bool          write;
+} ramdisk_range_t;
+
+#define _ramdisk_range_data                                                 \
+  ramdisk_range_t ranges[RAMDISK_MAX_RANGES];                               \
+  threads_queue_t rangeq;
+#else
+#define _ramdisk_range_data
+#endif
+
+#if (RAMDISK_USE_DMA == TRUE) || defined(__DOXYGEN__)
+#define _ramdisk_dma_data                                                   \
+  DMAChannel    *dmachp;
+#else
+#define _ramdisk_dma_data
+#endif
+
 /**
  *
  */
@@ -51,7 +130,9 @@ typedef struct RamDisk RamDisk;
   uint8_t       *storage;                                                   \
   uint32_t      blk_size;                                                   \
   uint32_t      blk_num;                                                    \
-  bool          readonly;
+  bool          readonly;                                                   \
+  _ramdisk_range_data                                                       \
+  _ramdisk_dma_data
 
 /**
  *
@@ -77,6 +158,9 @@ extern "C" {
   void ramdiskStart(RamDisk *rdp, uint8_t *storage, uint32_t blksize,
                     uint32_t blknum, bool readonly);
   void ramdiskStop(RamDisk *rdp);
+#if RAMDISK_USE_DMA == TRUE
+  void ramdiskSetDMA(RamDisk *rdp, DMAChannel *dchp);
+#endif
 #ifdef __cplusplus
 }
 #endif
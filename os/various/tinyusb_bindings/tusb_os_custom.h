@@ -87,24 +87,42 @@ static inline void osal_semaphore_reset(osal_semaphore_t const sem_hdl)
 //--------------------------------------------------------------------+
 // MUTEX API (priority inheritance)
 //--------------------------------------------------------------------+
-typedef osal_semaphore_def_t osal_mutex_def_t;
-typedef osal_semaphore_t osal_mutex_t;
+#if CH_CFG_USE_MUTEXES == FALSE
+#error "TinyUSB OSAL requires CH_CFG_USE_MUTEXES"
+#endif
+
+typedef mutex_t osal_mutex_def_t;
+typedef mutex_t * osal_mutex_t;
 
 static inline osal_mutex_t osal_mutex_create(osal_mutex_def_t* mdef)
 {
-  chSemObjectInit(&mdef->sem, mdef->size);
+  chMtxObjectInit(mdef);
   return mdef;
 }
 
 static inline bool osal_mutex_lock (osal_mutex_t mutex_hdl, uint32_t msec)
 {
-  uint32_t const ticks = (msec == OSAL_TIMEOUT_WAIT_FOREVER) ? TIME_INFINITE : TIME_MS2I(msec);
-  return chSemWaitTimeout(&mutex_hdl->sem, ticks) == MSG_OK;
+  if ( msec == OSAL_TIMEOUT_WAIT_FOREVER )
+  {
+    chMtxLock(mutex_hdl);
+    return true;
+  }
+
+  // ChibiOS mutexes have no timed lock, polled once per tick
+  systime_t const start = chVTGetSystemTime();
+  sysinterval_t const ticks = TIME_MS2I(msec);
+
+  while ( !chMtxTryLock(mutex_hdl) )
+  {
+    if ( chVTTimeElapsedSinceX(start) >= ticks ) return false;
+    chThdSleep(1);
+  }
+  return true;
 }
 
 static inline bool osal_mutex_unlock(osal_mutex_t mutex_hdl)
 {
-  chSemSignal(&mutex_hdl->sem);
+  chMtxUnlock(mutex_hdl);
   return true;
 }
 
@@ -112,80 +130,134 @@ static inline bool osal_mutex_unlock(osal_mutex_t mutex_hdl)
 // QUEUE API
 //--------------------------------------------------------------------+
 
+// Time osal_queue_receive() waits for an event
+#ifndef OSAL_CHIBIOS_QUEUE_TIMEOUT
+#define OSAL_CHIBIOS_QUEUE_TIMEOUT  TIME_INFINITE
+#endif
+
 // role device/host is used by OS NONE for mutex (disable usb isr) only
 #define OSAL_QUEUE_DEF(_role, _name, _depth, _type) \
-  static _type _name##_##objbuf[_depth];\
-  static msg_t _name##_##msgbuf[_depth];\
-  osal_queue_def_t _name = { .depth = _depth, .obj_sz = sizeof(_type), .objbuf = _name##_##objbuf, .msgbuf = _name##_##msgbuf };
+  static _type _name##_##buf[_depth];\
+  osal_queue_def_t _name = { .depth = _depth, .obj_sz = sizeof(_type), .buf = (uint8_t*) _name##_##buf };
 
-// Use FIFO as queue (mailbox + memory pool)
+// Single producer (the USB ISR, or a thread with the kernel locked) and
+// single consumer (the stack task) ring. The indices run freely, each is
+// written by one side only. The consumer is woken once per batch, when the
+// producer finds the ring empty.
 typedef struct
 {
   uint16_t  depth;
   uint16_t  obj_sz;
-  void*     objbuf;
-  msg_t*    msgbuf;
+  uint8_t*  buf;
+
+  uint32_t  wr_idx;
+  uint32_t  rd_idx;
+  uint32_t  dropped;   // events lost because the ring was full
 
-  objects_fifo_t fifo;
+  binary_semaphore_t sem;
 } osal_queue_def_t;
 typedef osal_queue_def_t * osal_queue_t;
 
 static inline osal_queue_t osal_queue_create(osal_queue_def_t* qdef)
 {
-  chFifoObjectInit(&qdef->fifo, qdef->obj_sz, qdef->depth, qdef->objbuf, qdef->msgbuf);
+  qdef->wr_idx  = 0;
+  qdef->rd_idx  = 0;
+  qdef->dropped = 0;
+  chBSemObjectInit(&qdef->sem, true);
   return qdef;
 }
 
+// Returns the next free slot to construct an event in place, NULL if the
+// ring is full. Producer side only.
+static inline void* osal_queue_send_begin(osal_queue_t qhdl)
+{
+  uint32_t const wr = qhdl->wr_idx;
+  uint32_t const rd = __atomic_load_n(&qhdl->rd_idx, __ATOMIC_ACQUIRE);
+
+  if ( wr - rd >= qhdl->depth )
+  {
+    qhdl->dropped++;
+    return NULL;
+  }
+
+  return &qhdl->buf[(wr % qhdl->depth) * qhdl->obj_sz];
+}
+
+// Publishes the slot returned by osal_queue_send_begin(), returns true if
+// the consumer has to be woken.
+static inline bool osal_queue_send_commit(osal_queue_t qhdl)
+{
+  uint32_t const wr = qhdl->wr_idx;
+
+  __atomic_store_n(&qhdl->wr_idx, wr + 1, __ATOMIC_RELEASE);
+  // Orders the publication before reading the consumer index, pairs with
+  // the fence in osal_queue_receive()
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  return __atomic_load_n(&qhdl->rd_idx, __ATOMIC_ACQUIRE) == wr;
+}
+
 static inline bool osal_queue_receive(osal_queue_t qhdl, void* data)
 {
-  void* objpp; // pointer to the object
+  uint32_t const rd = qhdl->rd_idx;
 
-  bool r = chFifoReceiveObjectTimeout(&qhdl->fifo, &objpp, TIME_MS2I(10000)) != MSG_OK;
-  if (r)
-    return false;
+  while ( true )
+  {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if ( __atomic_load_n(&qhdl->wr_idx, __ATOMIC_ACQUIRE) != rd ) break;
 
-  memcpy(data, objpp, qhdl->obj_sz);
-  chFifoReturnObject(&qhdl->fifo, objpp);
+    if ( chBSemWaitTimeout(&qhdl->sem, OSAL_CHIBIOS_QUEUE_TIMEOUT) != MSG_OK )
+      return false;
+  }
+
+  memcpy(data, &qhdl->buf[(rd % qhdl->depth) * qhdl->obj_sz], qhdl->obj_sz);
+  __atomic_store_n(&qhdl->rd_idx, rd + 1, __ATOMIC_RELEASE);
   return true;
 }
 
 static inline bool osal_queue_send(osal_queue_t qhdl, void const * data, bool in_isr)
 {
   void* obj;
+  bool wakeup;
 
   if ( !in_isr )
   {
-    obj = chFifoTakeObjectTimeout(&qhdl->fifo, TIME_MS2I(10000));
-    if (obj == NULL) // Allocation failed
+    // Excludes the ISR producer
+    chSysLock();
+    obj = osal_queue_send_begin(qhdl);
+    if ( obj == NULL )
+    {
+      chSysUnlock();
       return false;
+    }
     memcpy(obj, data, qhdl->obj_sz);
-    chFifoSendObject(&qhdl->fifo, obj);
+    wakeup = osal_queue_send_commit(qhdl);
+    if ( wakeup ) chBSemSignalI(&qhdl->sem);
+    chSchRescheduleS();
+    chSysUnlock();
     return true;
   }
   else
   {
-    chSysLockFromISR();
-    obj = chFifoTakeObjectI(&qhdl->fifo);
-    chSysUnlockFromISR();
-
-    if (obj == NULL) // Allocation failed
+    obj = osal_queue_send_begin(qhdl);
+    if ( obj == NULL )
       return false;
     memcpy(obj, data, qhdl->obj_sz);
 
-    chSysLockFromISR();
-    chFifoSendObjectI(&qhdl->fifo, obj);
-    chSysUnlockFromISR();
+    if ( osal_queue_send_commit(qhdl) )
+    {
+      chSysLockFromISR();
+      chBSemSignalI(&qhdl->sem);
+      chSysUnlockFromISR();
+    }
     return true;
   }
 }
 
 static inline bool osal_queue_empty(osal_queue_t qhdl)
 {
-  uint16_t cnt;
-  chSysLock();
-  cnt = chMBGetFreeCountI(&qhdl->fifo.mbx);
-  chSysUnlock();
-  return cnt == 0;
+  return __atomic_load_n(&qhdl->wr_idx, __ATOMIC_ACQUIRE) ==
+         __atomic_load_n(&qhdl->rd_idx, __ATOMIC_ACQUIRE);
 }
 
 #ifdef __cplusplus
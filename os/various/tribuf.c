@@ -41,6 +41,76 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (TRIBUF_USE_LOCKFREE == TRUE) || defined(__DOXYGEN__)
+
+/**
+ * @brief   Exchanges two buffer indices of a lock-free state word.
+ *
+ * @param[in] state     State word.
+ * @param[in] pos1      First index position.
+ * @param[in] pos2      Second index position.
+ * @return  The updated state word.
+ *
+ * @notapi
+ */
+static inline uint32_t tribuf_exchange(uint32_t state,
+                                       unsigned pos1, unsigned pos2) {
+
+  uint32_t idx1 = tribuf_index(state, pos1);
+  uint32_t idx2 = tribuf_index(state, pos2);
+
+  state &= ~((TRIBUF_INDEX_MASK << pos1) | (TRIBUF_INDEX_MASK << pos2));
+  return state | (idx2 << pos1) | (idx1 << pos2);
+}
+
+/**
+ * @brief   Swaps the front buffer with the orphan if it holds new data.
+ * @note    The acquire/release ordering publishes the producer writes to the
+ *          consumer and the consumer reads before the buffer is reused.
+ *
+ * @param[in] handler   Pointer to the tribuf handler object.
+ * @return  The swap happened.
+ *
+ * @notapi
+ */
+static bool tribuf_swap_front(tribuf_t *handler) {
+
+  uint32_t state = __atomic_load_n(&handler->state, __ATOMIC_RELAXED);
+  uint32_t next;
+
+  do {
+    if (0U == (state & TRIBUF_FRESH))
+      return false;
+    next = tribuf_exchange(state, TRIBUF_FRONT_POS, TRIBUF_ORPHAN_POS);
+    next &= ~TRIBUF_FRESH;
+  } while (!__atomic_compare_exchange_n(&handler->state, &state, next, true,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+  return true;
+}
+
+/**
+ * @brief   Swaps the back buffer with the orphan and marks it as fresh.
+ *
+ * @param[in] handler   Pointer to the tribuf handler object.
+ * @return  The orphan was already fresh, its data has been dropped.
+ *
+ * @notapi
+ */
+static bool tribuf_swap_back(tribuf_t *handler) {
+
+  uint32_t state = __atomic_load_n(&handler->state, __ATOMIC_RELAXED);
+  uint32_t next;
+
+  do {
+    next = tribuf_exchange(state, TRIBUF_BACK_POS, TRIBUF_ORPHAN_POS);
+    next |= TRIBUF_FRESH;
+  } while (!__atomic_compare_exchange_n(&handler->state, &state, next, true,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+  return (0U != (state & TRIBUF_FRESH));
+}
+
+#endif  /* (TRIBUF_USE_LOCKFREE == TRUE) || defined(__DOXYGEN__) */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -61,6 +131,16 @@
  */
 void tribufObjectInit(tribuf_t *handler, void *front, void *back, void *orphan) {
 
+#if (TRIBUF_USE_LOCKFREE == TRUE)
+  handler->buffers[0] = front;
+  handler->buffers[1] = back;
+  handler->buffers[2] = orphan;
+  handler->state = (0U << TRIBUF_FRONT_POS) | (1U << TRIBUF_BACK_POS) |
+                   (2U << TRIBUF_ORPHAN_POS);
+#if (TRIBUF_USE_WAIT == TRUE)
+  chSemObjectInit(&handler->ready, (cnt_t)0);
+#endif
+#else
   handler->front = front;
   handler->back = back;
   handler->orphan = orphan;
@@ -69,6 +149,7 @@ void tribufObjectInit(tribuf_t *handler, void *front, void *back, void *orphan)
 #else
   handler->ready = false;
 #endif
+#endif
 }
 
 /**
@@ -83,9 +164,14 @@ void *tribufGetFront(tribuf_t *handler) {
 
   void *front;
 
+#if (TRIBUF_USE_LOCKFREE == TRUE)
+  /* Only the consumer changes the front index.*/
+  front = handler->buffers[tribuf_index(handler->state, TRIBUF_FRONT_POS)];
+#else
   osalSysLock();
   front = tribufGetFrontI(handler);
   osalSysUnlock();
+#endif
   return front;
 }
 
@@ -99,6 +185,8 @@ void *tribufGetFront(tribuf_t *handler) {
  * @pre   The orphan buffer holds new data, swapped by the back buffer.
  * @pre   The fron buffer is ready for swap.
  * @post  The orphan buffer can be used as new back buffer in the future.
+ * @note  With @p TRIBUF_USE_LOCKFREE the swap happens only if the orphan
+ *        buffer holds new data, the current front buffer is kept otherwise.
  *
  * @param[in] handler   Pointer to the tribuf handler object.
  *
@@ -106,13 +194,17 @@ void *tribufGetFront(tribuf_t *handler) {
  */
 void tribufSwapFrontI(tribuf_t *handler) {
 
-  void *front;
-
   osalDbgCheckClassI();
 
+#if (TRIBUF_USE_LOCKFREE == TRUE)
+  (void)tribuf_swap_front(handler);
+#else
+  void *front;
+
   front = handler->orphan;
   handler->orphan = handler->front;
   handler->front = front;
+#endif
 }
 
 /**
@@ -125,6 +217,8 @@ void tribufSwapFrontI(tribuf_t *handler) {
  * @pre   The orphan buffer holds new data, swapped by the back buffer.
  * @pre   The fron buffer is ready for swap.
  * @post  The orphan buffer can be used as new back buffer in the future.
+ * @note  With @p TRIBUF_USE_LOCKFREE the swap happens only if the orphan
+ *        buffer holds new data, the current front buffer is kept otherwise.
  *
  * @param[in] handler   Pointer to the tribuf handler object.
  *
@@ -132,9 +226,13 @@ void tribufSwapFrontI(tribuf_t *handler) {
  */
 void tribufSwapFront(tribuf_t *handler) {
 
+#if (TRIBUF_USE_LOCKFREE == TRUE)
+  (void)tribuf_swap_front(handler);
+#else
   osalSysLock();
   tribufSwapFrontI(handler);
   osalSysUnlock();
+#endif
 }
 
 /**
@@ -149,9 +247,14 @@ void *tribufGetBack(tribuf_t *handler) {
 
   void *back;
 
+#if (TRIBUF_USE_LOCKFREE == TRUE)
+  /* Only the producer changes the back index.*/
+  back = handler->buffers[tribuf_index(handler->state, TRIBUF_BACK_POS)];
+#else
   osalSysLock();
   back = tribufGetBackI(handler);
   osalSysUnlock();
+#endif
   return back;
 }
 
@@ -171,10 +274,19 @@ void *tribufGetBack(tribuf_t *handler) {
  */
 void tribufSwapBackI(tribuf_t *handler) {
 
-  void *back;
-
   osalDbgCheckClassI();
 
+#if (TRIBUF_USE_LOCKFREE == TRUE)
+  /* Already signaled if the orphan was still fresh.*/
+  if (!tribuf_swap_back(handler)) {
+#if (TRIBUF_USE_WAIT == TRUE)
+    if (chSemGetCounterI(&handler->ready) < (cnt_t)1)
+      chSemSignalI(&handler->ready);
+#endif
+  }
+#else
+  void *back;
+
   back = handler->orphan;
   handler->orphan = handler->back;
   handler->back = back;
@@ -185,6 +297,7 @@ void tribufSwapBackI(tribuf_t *handler) {
 #else
   handler->ready = true;
 #endif
+#endif
 }
 
 /**
@@ -203,12 +316,25 @@ void tribufSwapBackI(tribuf_t *handler) {
  */
 void tribufSwapBack(tribuf_t *handler) {
 
+#if (TRIBUF_USE_LOCKFREE == TRUE)
+  /* The kernel is locked only to signal a new front buffer.*/
+  if (!tribuf_swap_back(handler)) {
+#if (TRIBUF_USE_WAIT == TRUE)
+    osalSysLock();
+    if (chSemGetCounterI(&handler->ready) < (cnt_t)1)
+      chSemSignalI(&handler->ready);
+    osalOsRescheduleS();
+    osalSysUnlock();
+#endif
+  }
+#else
   osalSysLock();
   tribufSwapBackI(handler);
 #if (TRIBUF_USE_WAIT == TRUE)
   osalOsRescheduleS();
 #endif
   osalSysUnlock();
+#endif
 }
 
 /** @} */
@@ -29,6 +29,17 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Lock-free state word layout
+ * @{
+ */
+#define TRIBUF_INDEX_MASK     3U          /**< @brief Buffer index mask.*/
+#define TRIBUF_FRONT_POS      0U          /**< @brief Front index position.*/
+#define TRIBUF_BACK_POS       2U          /**< @brief Back index position.*/
+#define TRIBUF_ORPHAN_POS     4U          /**< @brief Orphan index position.*/
+#define TRIBUF_FRESH          (1U << 6)   /**< @brief Orphan holds new data.*/
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -45,12 +56,29 @@
 #define TRIBUF_USE_WAIT       TRUE
 #endif
 
+/**
+ * @brief   Triple buffers swap without critical sections.
+ * @details The three buffer indices and the fresh flag are packed into one
+ *          word updated by atomic compare-and-swap, exclusive load/store on
+ *          ARMv7-M. With @p TRIBUF_USE_WAIT the kernel is locked only to
+ *          signal a new front buffer, once per buffer actually consumed.
+ * @note    Requires the GCC atomic builtins and a target with exclusive
+ *          access instructions.
+ */
+#if !defined(TRIBUF_USE_LOCKFREE) || defined(__DOXYGEN__)
+#define TRIBUF_USE_LOCKFREE   FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (TRIBUF_USE_LOCKFREE == TRUE) && defined(__ARM_ARCH_6M__)
+#error "TRIBUF_USE_LOCKFREE requires exclusive access instructions"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -59,6 +87,13 @@
  * @brief   Triple buffer handler object.
  */
 typedef struct {
+#if (TRIBUF_USE_LOCKFREE == TRUE) || defined(__DOXYGEN__)
+  void *buffers[3];           /**< @brief Buffer pointers.*/
+  volatile uint32_t state;    /**< @brief Buffer indices and fresh flag.*/
+#if (TRIBUF_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  semaphore_t ready;          /**< @brief A new front buffer is ready.*/
+#endif
+#else
   void *front;                /**< @brief Current front buffer pointer.*/
   void *back;                 /**< @brief Current back buffer pointer.*/
   void *orphan;               /**< @brief Current orphan buffer pointer.*/
@@ -67,12 +102,27 @@ typedef struct {
 #else
   bool ready;                 /**< @brief A new front buffer is ready.*/
 #endif
+#endif
 } tribuf_t;
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+#if (TRIBUF_USE_LOCKFREE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Extracts a buffer index from a lock-free state word.
+ *
+ * @param[in] state     State word.
+ * @param[in] pos       Index position.
+ * @return  Buffer index.
+ *
+ * @notapi
+ */
+#define tribuf_index(state, pos)                                            \
+  (((state) >> (pos)) & TRIBUF_INDEX_MASK)
+#endif
+
 /**
  * @brief   Checks if a new front buffer is ready.
  *
@@ -86,7 +136,10 @@ bool tribufIsReadyI(tribuf_t *handler)
 {
   osalDbgCheckClassI();
 
-#if (TRIBUF_USE_WAIT == TRUE)
+#if (TRIBUF_USE_LOCKFREE == TRUE)
+  return (0U != (__atomic_load_n(&handler->state, __ATOMIC_ACQUIRE) &
+                 TRIBUF_FRESH));
+#elif (TRIBUF_USE_WAIT == TRUE)
   return (0 != chSemGetCounterI(&handler->ready));
 #else
   return handler->ready;
@@ -184,7 +237,11 @@ void *tribufGetFrontI(tribuf_t *handler) {
 
   osalDbgCheckClassI();
 
+#if (TRIBUF_USE_LOCKFREE == TRUE)
+  return handler->buffers[tribuf_index(handler->state, TRIBUF_FRONT_POS)];
+#else
   return handler->front;
+#endif
 }
 
 /**
@@ -200,7 +257,11 @@ void *tribufGetBackI(tribuf_t *handler) {
 
   osalDbgCheckClassI();
 
+#if (TRIBUF_USE_LOCKFREE == TRUE)
+  return handler->buffers[tribuf_index(handler->state, TRIBUF_BACK_POS)];
+#else
   return handler->back;
+#endif
 }
 
 /*===========================================================================*/
@@ -67,6 +67,256 @@ static void wizchip_write_buffer(uint8_t *pBuf, uint16_t len) {
 }
 
 
+/*
+ * Socket events. The ioLibrary sockets are used in non-blocking mode and
+ * the threads waiting on them sleep until the INTn handler thread, or the
+ * polling period when INTn is not used, reports a change. The RECV, CON and
+ * DISCON socket interrupts are served here, SENDOK and TIMEOUT belong to
+ * the ioLibrary which polls them: they are only unmasked while a thread
+ * waits for transmission and masked again, not cleared, when they fire.
+ */
+
+#define WIZCHIP_SIK_OWNED       (SIK_CONNECTED | SIK_DISCONNECTED | SIK_RECEIVED)
+#define WIZCHIP_SIK_TX          (SIK_SENT | SIK_TIMEOUT)
+
+typedef struct {
+  sysinterval_t rcvtimeo;
+
+  sysinterval_t sndtimeo;
+
+  /* Shadow of Sn_IMR, zero for sockets not opened by the bindings. */
+  uint8_t imr;
+
+  /* A TCP SEND command may still be in progress. */
+  bool sending;
+
+  /* Free TX space a sender waits for. */
+  uint16_t txwant;
+} wizchip_sock_t;
+
+static wizchip_sock_t wiz_socks[_WIZCHIP_SOCK_NUM_];
+
+static event_source_t wiz_es;
+
+static MUTEX_DECL(wiz_imr_mtx);
+
+#if ETH_USE_CALLBACKS == TRUE
+static ioline_t wiz_irq_line = PAL_NOLINE;
+
+static binary_semaphore_t wiz_irq_sem;
+
+static thread_t *wiz_irq_tp;
+
+static THD_WORKING_AREA(waWizchipIrq, WIZCHIP_IRQ_THREAD_WA_SIZE);
+#endif
+
+
+static void wizchip_cris_enter(void) {
+
+#if ETH_USE_MUTUAL_EXCLUSION == TRUE
+  spiAcquireBus(spip);
+#endif
+}
+
+
+static void wizchip_cris_exit(void) {
+
+#if ETH_USE_MUTUAL_EXCLUSION == TRUE
+  spiReleaseBus(spip);
+#endif
+}
+
+
+/* Updates the Sn_IMR shadow and register.*/
+static void wizchip_set_imr(int sn, uint8_t set, uint8_t clr) {
+
+  chMtxLock(&wiz_imr_mtx);
+
+  uint8_t imr = (uint8_t)((wiz_socks[sn].imr | set) & ~clr);
+
+  if (imr != wiz_socks[sn].imr) {
+    wiz_socks[sn].imr = imr;
+    ctlsocket((uint8_t)sn, CS_SET_INTMASK, &imr);
+  }
+
+  chMtxUnlock(&wiz_imr_mtx);
+}
+
+
+/* Enables or disables the socket in the chip interrupt mask.*/
+static void wizchip_enable_sock_irq(int sn, bool enable) {
+
+  intr_kind ik;
+
+  chMtxLock(&wiz_imr_mtx);
+
+  ctlwizchip(CW_GET_INTRMASK, &ik);
+  if (enable)
+    ik = (intr_kind)(ik | (IK_SOCK_0 << sn));
+  else
+    ik = (intr_kind)(ik & ~(IK_SOCK_0 << sn));
+  ctlwizchip(CW_SET_INTRMASK, &ik);
+
+  chMtxUnlock(&wiz_imr_mtx);
+}
+
+
+#if ETH_USE_CALLBACKS == TRUE
+static void wizchip_irq_cb(void *arg) {
+
+  (void)arg;
+
+  chSysLockFromISR();
+  chBSemSignalI(&wiz_irq_sem);
+  chSysUnlockFromISR();
+}
+
+
+/*
+ * Serves the socket interrupts until none the bindings can acknowledge is
+ * pending, INTn is edge triggered. The SIR bit of a socket stays set while
+ * its Sn_IR is not zero, the bits left latched for the ioLibrary and those
+ * of the sockets not opened by the bindings are not waited for.
+ */
+static void wizchip_serve_irq(void) {
+
+  while (true) {
+    intr_kind ik;
+    uint8_t sir;
+    uint8_t owned = 0;
+    bool served = false;
+
+    for (int sn = 0; sn < _WIZCHIP_SOCK_NUM_; sn++) {
+      if (wiz_socks[sn].imr != 0)
+        owned |= (uint8_t)(1u << sn);
+    }
+
+    ctlwizchip(CW_GET_INTERRUPT, &ik);
+    sir = (uint8_t)((uint32_t)ik >> 8) & owned;
+
+    for (int sn = 0; sn < _WIZCHIP_SOCK_NUM_; sn++) {
+      uint8_t ir;
+      uint8_t clr;
+
+      if ((sir & (1u << sn)) == 0)
+        continue;
+
+      ctlsocket((uint8_t)sn, CS_GET_INTERRUPT, &ir);
+      ir &= wiz_socks[sn].imr;
+      if (ir == 0)
+        continue;
+
+      clr = ir & WIZCHIP_SIK_OWNED;
+      if (clr != 0)
+        ctlsocket((uint8_t)sn, CS_CLR_INTERRUPT, &clr);
+
+      if ((ir & WIZCHIP_SIK_TX) != 0)
+        wizchip_set_imr(sn, 0, WIZCHIP_SIK_TX);
+
+      served = true;
+      chEvtBroadcastFlags(&wiz_es, (eventflags_t)1 << sn);
+    }
+
+    if (!served)
+      break;
+  }
+}
+
+
+static THD_FUNCTION(wizchip_irq_thread, arg) {
+
+  (void)arg;
+
+  chRegSetThreadName("wizchip");
+
+  while (true) {
+    chBSemWait(&wiz_irq_sem);
+    wizchip_serve_irq();
+  }
+}
+#endif
+
+
+static sysinterval_t wizchip_poll_interval(void) {
+
+#if ETH_USE_CALLBACKS == TRUE
+  if (wiz_irq_line != PAL_NOLINE)
+    return TIME_MS2I(WIZCHIP_IRQ_GUARD_INTERVAL_MS);
+#endif
+
+  return TIME_MS2I(WIZCHIP_POLL_INTERVAL_MS);
+}
+
+
+/*
+ * Reads the readiness of a socket from the chip.
+ */
+static uint8_t wizchip_poll_sock(int sn, uint8_t events) {
+
+  wizchip_sock_t *sp = &wiz_socks[sn];
+  uint8_t revents = 0;
+  uint8_t sr = getSn_SR(sn);
+
+  if (sr == SOCK_CLOSED || sr == SOCK_CLOSE_WAIT)
+    revents |= WIZCHIP_POLLHUP;
+
+  if ((events & WIZCHIP_POLLIN) && getSn_RX_RSR(sn) > 0)
+    revents |= WIZCHIP_POLLIN;
+
+  if ((events & WIZCHIP_POLLOUT) &&
+      (sr == SOCK_ESTABLISHED || sr == SOCK_CLOSE_WAIT ||
+       sr == SOCK_UDP || sr == SOCK_MACRAW)) {
+    if (sp->sending) {
+      /* Writable once the ioLibrary can complete the previous send.*/
+      if ((getSn_IR(sn) & (Sn_IR_SENDOK | Sn_IR_TIMEOUT)) != 0)
+        revents |= WIZCHIP_POLLOUT;
+    }
+    else if (getSn_TX_FSR(sn) >= (sp->txwant > 0 ? sp->txwant : 1u)) {
+      revents |= WIZCHIP_POLLOUT;
+    }
+  }
+
+  return revents & (events | WIZCHIP_POLLHUP);
+}
+
+
+/*
+ * Converts an ioLibrary error into a negated WIZCHIP_SOCKETS_ERR_* code.
+ */
+static int wizchip_err(int32_t err) {
+
+  switch (err) {
+  case SOCKERR_SOCKNUM:
+    return -WIZCHIP_SOCKETS_ERR_DESCRIPTOR;
+
+  case SOCKERR_SOCKOPT:
+  case SOCKERR_SOCKMODE:
+  case SOCKERR_SOCKFLAG:
+  case SOCKERR_ARG:
+  case SOCKERR_PORTZERO:
+  case SOCKERR_IPINVALID:
+  case SOCKERR_DATALEN:
+    return -WIZCHIP_SOCKETS_ERR_PARAMETER;
+
+  case SOCKERR_SOCKINIT:
+  case SOCKERR_SOCKSTATUS:
+    return -WIZCHIP_SOCKETS_ERR_STATE;
+
+  case SOCKERR_SOCKCLOSED:
+    return -WIZCHIP_SOCKETS_ERR_CLOSING;
+
+  case SOCKERR_TIMEOUT:
+    return -WIZCHIP_SOCKETS_ERR_TIMEOUT;
+
+  case SOCKERR_BUFFER:
+    return -WIZCHIP_SOCKETS_ERR_NOMEMORY;
+
+  default:
+    return -WIZCHIP_SOCKETS_ERR_GENERAL;
+  }
+}
+
+
 static inline void __wizchipHWReset(const WIZCHIP_ETHSPIConfig *config) {
 
   palClearLine(config->reset_line);
@@ -111,6 +361,12 @@ static inline int __wizchipConfigurePHY(const WIZCHIP_ETHPhyConfig *phy_config)
 
 
 void wizchipInit(void) {
+
+  chEvtObjectInit(&wiz_es);
+
+#if ETH_USE_CALLBACKS == TRUE
+  chBSemObjectInit(&wiz_irq_sem, true);
+#endif
 }
 
 
@@ -141,20 +397,44 @@ msg_t wizchipStart(WIZCHIP_MACDriver *wizp, const WIZCHIP_MACConfig *configp) {
   reg_wizchip_cs_cbfunc(wizchip_select, wizchip_deselect);
   reg_wizchip_spi_cbfunc(wizchip_read_byte, wizchip_write_byte);
   reg_wizchip_spiburst_cbfunc(wizchip_read_buffer, wizchip_write_buffer);
+  reg_wizchip_cris_cbfunc(wizchip_cris_enter, wizchip_cris_exit);
 
   msg = spiStart(wizp->spi_config->driver, wizp->spi_config->config);
 
+#if ETH_USE_CALLBACKS == TRUE
+  wiz_irq_line = wizp->spi_config->irq_line;
+
+  if (wiz_irq_line != PAL_NOLINE) {
+    if (wiz_irq_tp == NULL)
+      wiz_irq_tp = chThdCreateStatic(waWizchipIrq, sizeof(waWizchipIrq),
+                                     WIZCHIP_IRQ_THREAD_PRIO,
+                                     wizchip_irq_thread, NULL);
+
+    palSetLineCallback(wiz_irq_line, wizchip_irq_cb, NULL);
+    palEnableLineEvent(wiz_irq_line, PAL_EVENT_MODE_FALLING_EDGE);
+  }
+#endif
+
   return msg;
 }
 
 
 void wizchipStop(WIZCHIP_MACDriver *wizp) {
 
+#if ETH_USE_CALLBACKS == TRUE
+  if (wiz_irq_line != PAL_NOLINE) {
+    palSetLineCallback(wiz_irq_line, NULL, NULL);
+    palDisableLineEvent(wiz_irq_line);
+    wiz_irq_line = PAL_NOLINE;
+  }
+#endif
+
   spiStop(wizp->spi_config->driver);
 
   reg_wizchip_cs_cbfunc(NULL, NULL);
   reg_wizchip_spi_cbfunc(NULL, NULL);
   reg_wizchip_spiburst_cbfunc(NULL, NULL);
+  reg_wizchip_cris_cbfunc(NULL, NULL);
 
   spip = NULL;
 }
@@ -169,6 +449,9 @@ msg_t wizchipReset(WIZCHIP_MACDriver *wizp) {
 
   __wizchipHWReset(wizp->spi_config);
 
+  /* The reset masked all the interrupts.*/
+  memset(wiz_socks, 0, sizeof(wiz_socks));
+
   rc = __wizchipInitSocketBufferSize();
 
   if (rc != 0)
@@ -392,9 +675,110 @@ dns_query_result_t wizchipDNSQuery(WIZCHIP_MACDriver *wizp, uint32_t waittime_se
 }
 
 
+/*
+ * Waits for events on a set of sockets, the readiness is re-read from the
+ * chip each time the socket events or the polling period wake the thread.
+ */
+static int wizchip_wait(wizchip_pollfd_t *fds, size_t nfds,
+                        sysinterval_t timeout) {
+
+  event_listener_t el;
+  eventflags_t mask = 0;
+  const systime_t start = chVTGetSystemTime();
+  int ready;
+
+  for (size_t i = 0; i < nfds; i++)
+    mask |= (eventflags_t)1 << fds[i].sock;
+
+  chEvtRegisterMaskWithFlags(&wiz_es, &el, EVENT_MASK(WIZCHIP_EVENT_ID), mask);
+
+  while (true) {
+    sysinterval_t slice = wizchip_poll_interval();
+
+    ready = 0;
+    for (size_t i = 0; i < nfds; i++) {
+      fds[i].revents = wizchip_poll_sock(fds[i].sock, fds[i].events);
+      if (fds[i].revents != 0)
+        ready++;
+    }
+
+    if (ready > 0 || timeout == TIME_IMMEDIATE)
+      break;
+
+    if (timeout != TIME_INFINITE) {
+      sysinterval_t elapsed = chVTTimeElapsedSinceX(start);
+
+      if (elapsed >= timeout)
+        break;
+      if (timeout - elapsed < slice)
+        slice = timeout - elapsed;
+    }
+
+    for (size_t i = 0; i < nfds; i++) {
+      wizchip_sock_t *sp = &wiz_socks[fds[i].sock];
+
+      if ((fds[i].events & WIZCHIP_POLLOUT) && sp->imr != 0) {
+        if (sp->sending) {
+          /* SENDOK or TIMEOUT wake the thread.*/
+          wizchip_set_imr(fds[i].sock, WIZCHIP_SIK_TX, 0);
+        }
+        else {
+          /* The free space grows with the ACKs, no interrupt for that.*/
+          if (slice > TIME_MS2I(WIZCHIP_POLL_INTERVAL_MS))
+            slice = TIME_MS2I(WIZCHIP_POLL_INTERVAL_MS);
+        }
+      }
+    }
+
+    chEvtWaitAnyTimeout(EVENT_MASK(WIZCHIP_EVENT_ID), slice);
+    (void)chEvtGetAndClearFlags(&el);
+  }
+
+  chEvtUnregister(&wiz_es, &el);
+
+  return ready;
+}
+
+
+static int wizchip_wait_sock(int sock, uint8_t events, sysinterval_t timeout) {
+
+  wizchip_pollfd_t fd = {
+    .sock = sock,
+    .events = events,
+    .revents = 0
+  };
+
+  if (wizchip_wait(&fd, 1, timeout) == 0)
+    return 0;
+
+  return fd.revents;
+}
+
+
+static bool wizchip_sock_valid(int sock) {
+
+  return sock >= 0 && sock < _WIZCHIP_SOCK_NUM_;
+}
+
+
+/* Remaining part of a timeout started at the given time.*/
+static sysinterval_t wizchip_remaining(systime_t start, sysinterval_t timeout) {
+
+  sysinterval_t elapsed;
+
+  if (timeout == TIME_INFINITE || timeout == TIME_IMMEDIATE)
+    return timeout;
+
+  elapsed = chVTTimeElapsedSinceX(start);
+
+  return elapsed >= timeout ? TIME_IMMEDIATE : timeout - elapsed;
+}
+
+
 int wizchipSocket(int domain, int socket_type, int protocol) {
 
   int sock;
+  uint8_t iomode = SOCK_IO_NONBLOCK;
 
   (void)domain;
   (void)protocol;
@@ -417,20 +801,41 @@ int wizchipSocket(int domain, int socket_type, int protocol) {
     break;
 
   default:
-    sock = WIZCHIP_INVALID_SOCKET;
-    break;
+    return WIZCHIP_INVALID_SOCKET;
   }
 
+  if (sock < 0)
+    return wizchip_err(sock);
+
+  /* The waits are done here, the ioLibrary must not spin on SPI.*/
+  ctlsocket((uint8_t)sock, CS_SET_IOMODE, &iomode);
+
+  wiz_socks[sock].rcvtimeo = TIME_INFINITE;
+  wiz_socks[sock].sndtimeo = TIME_INFINITE;
+  wiz_socks[sock].sending = false;
+  wiz_socks[sock].txwant = 0;
+  wizchip_set_imr(sock, WIZCHIP_SIK_OWNED, WIZCHIP_SIK_TX);
+  wizchip_enable_sock_irq(sock, true);
+
   return sock;
 }
 
 
 int wizchipClose(int sock) {
 
+  if (!wizchip_sock_valid(sock))
+    return -WIZCHIP_SOCKETS_ERR_DESCRIPTOR;
+
+  wizchip_enable_sock_irq(sock, false);
+  wizchip_set_imr(sock, 0, 0xFF);
+
   int err = close(sock);
 
+  /* Waking the threads still waiting on the socket.*/
+  chEvtBroadcastFlags(&wiz_es, (eventflags_t)1 << sock);
+
   if (err != SOCK_OK)
-    return -1;
+    return wizchip_err(err);
 
   return 0;
 }
@@ -445,10 +850,27 @@ int wizchipShutdown(int sock) {
 
 int wizchipConnect(int sock, IP_Address_t *addr, uint16_t port) {
 
+  if (!wizchip_sock_valid(sock))
+    return -WIZCHIP_SOCKETS_ERR_DESCRIPTOR;
+
   int err = connect(sock, addr->ip, port);
 
+  if (err == SOCK_BUSY) {
+    /* The chip TCP timeout closes the socket.*/
+    int revents = wizchip_wait_sock(sock, WIZCHIP_POLLOUT,
+                                    wiz_socks[sock].sndtimeo);
+
+    if (revents & WIZCHIP_POLLOUT)
+      return 0;
+
+    if (revents == 0)
+      close(sock);
+
+    return -WIZCHIP_SOCKETS_ERR_TIMEOUT;
+  }
+
   if (err != SOCK_OK)
-    return -1;
+    return wizchip_err(err);
 
   return 0;
 }
@@ -456,74 +878,272 @@ int wizchipConnect(int sock, IP_Address_t *addr, uint16_t port) {
 
 int wizchipDisconnect(int sock) {
 
+  if (!wizchip_sock_valid(sock))
+    return -WIZCHIP_SOCKETS_ERR_DESCRIPTOR;
+
   int err = disconnect(sock);
 
+  if (err == SOCK_BUSY) {
+    if (wizchip_wait_sock(sock, 0, wiz_socks[sock].sndtimeo) == 0) {
+      close(sock);
+      return -WIZCHIP_SOCKETS_ERR_TIMEOUT;
+    }
+
+    return 0;
+  }
+
   if (err != SOCK_OK)
-    return -1;
+    return wizchip_err(err);
 
   return 0;
 }
 
 int wizchipSend(int sock, const void *buf, size_t len, int flag) {
 
-  (void)flag;
+  if (!wizchip_sock_valid(sock))
+    return -WIZCHIP_SOCKETS_ERR_DESCRIPTOR;
+
+  wizchip_sock_t *sp = &wiz_socks[sock];
+  const sysinterval_t timeout = (flag & WIZCHIP_FLAG_MSG_DONTWAIT) ?
+                                TIME_IMMEDIATE : sp->sndtimeo;
+  const systime_t start = chVTGetSystemTime();
+  const uint8_t *p = buf;
+  size_t sent = 0;
+
+  while (sent < len) {
+    uint16_t chunk = (uint16_t)((len - sent) < getSn_TxMAX(sock) ?
+                                (len - sent) : getSn_TxMAX(sock));
+
+    /* A pending SENDOK is consumed by this call.*/
+    if (sp->sending && (getSn_IR(sock) & (Sn_IR_SENDOK | Sn_IR_TIMEOUT)))
+      sp->sending = false;
+
+    int32_t tx_bytes = send(sock, (uint8_t *)&p[sent], chunk);
 
-  int tx_bytes = send(sock, (void *)buf, len);
+    if (tx_bytes > 0) {
+      sp->sending = true;
+      sent += (size_t)tx_bytes;
+      continue;
+    }
+
+    if (tx_bytes < 0) {
+      sp->sending = false;
+      return sent > 0 ? (int)sent : wizchip_err(tx_bytes);
+    }
+
+    sp->txwant = chunk;
+    int revents = wizchip_wait_sock(sock, WIZCHIP_POLLOUT,
+                                    wizchip_remaining(start, timeout));
+    sp->txwant = 0;
+
+    if (revents == 0) {
+      if (sent > 0)
+        break;
+      return (timeout == TIME_IMMEDIATE) ? -WIZCHIP_SOCKETS_ERR_WOULDBLOCK :
+                                           -WIZCHIP_SOCKETS_ERR_TIMEOUT;
+    }
+  }
 
-  return tx_bytes;
+  return (int)sent;
 }
 
 int wizchipRecv(int sock, void *buf, size_t len, int flag) {
 
-  (void)flag;
+  if (!wizchip_sock_valid(sock))
+    return -WIZCHIP_SOCKETS_ERR_DESCRIPTOR;
 
-  int rx_bytes = recv(sock, buf, len);
+  const sysinterval_t timeout = (flag & WIZCHIP_FLAG_MSG_DONTWAIT) ?
+                                TIME_IMMEDIATE : wiz_socks[sock].rcvtimeo;
+  const systime_t start = chVTGetSystemTime();
+
+  if (len > UINT16_MAX)
+    len = UINT16_MAX;
+
+  while (true) {
+    int32_t rx_bytes = recv(sock, buf, (uint16_t)len);
+
+    if (rx_bytes > 0)
+      return rx_bytes;
 
-  return rx_bytes;
+    if (rx_bytes < 0)
+      return wizchip_err(rx_bytes);
+
+    if (wizchip_wait_sock(sock, WIZCHIP_POLLIN,
+                          wizchip_remaining(start, timeout)) == 0)
+      return (timeout == TIME_IMMEDIATE) ? -WIZCHIP_SOCKETS_ERR_WOULDBLOCK :
+                                           -WIZCHIP_SOCKETS_ERR_TIMEOUT;
+  }
 }
 
 
 int wizchipSendTo(int sock, const void *buf, size_t len, int flag,
                   IP_Address_t *dest_addr, uint16_t dest_port) {
 
-  (void)flag;
+  if (!wizchip_sock_valid(sock))
+    return -WIZCHIP_SOCKETS_ERR_DESCRIPTOR;
+
+  wizchip_sock_t *sp = &wiz_socks[sock];
+  const sysinterval_t timeout = (flag & WIZCHIP_FLAG_MSG_DONTWAIT) ?
+                                TIME_IMMEDIATE : sp->sndtimeo;
+  const systime_t start = chVTGetSystemTime();
+
+  if (len > getSn_TxMAX(sock))
+    return -WIZCHIP_SOCKETS_ERR_PARAMETER;
+
+  while (true) {
+    int32_t tx_bytes = sendto(sock, (uint8_t *)buf, (uint16_t)len,
+                              dest_addr->ip, dest_port);
+
+    if (tx_bytes > 0)
+      return tx_bytes;
+
+    if (tx_bytes < 0)
+      return wizchip_err(tx_bytes);
 
-  int tx_bytes = sendto(sock, (void *)buf, len, dest_addr->ip, dest_port);
+    sp->txwant = (uint16_t)len;
+    int revents = wizchip_wait_sock(sock, WIZCHIP_POLLOUT,
+                                    wizchip_remaining(start, timeout));
+    sp->txwant = 0;
 
-  return tx_bytes;
+    if (revents == 0)
+      return (timeout == TIME_IMMEDIATE) ? -WIZCHIP_SOCKETS_ERR_WOULDBLOCK :
+                                           -WIZCHIP_SOCKETS_ERR_TIMEOUT;
+  }
 }
 
 
 int wizchipRecvFrom(int sock, void *buf, size_t len, int flag,
                     IP_Address_t *dest_addr, uint16_t dest_port) {
 
-  (void)flag;
+  if (!wizchip_sock_valid(sock))
+    return -WIZCHIP_SOCKETS_ERR_DESCRIPTOR;
+
+  const sysinterval_t timeout = (flag & WIZCHIP_FLAG_MSG_DONTWAIT) ?
+                                TIME_IMMEDIATE : wiz_socks[sock].rcvtimeo;
+  const systime_t start = chVTGetSystemTime();
+
+  if (len > UINT16_MAX)
+    len = UINT16_MAX;
 
-  int rx_bytes = recvfrom(sock, buf, len, dest_addr->ip, &dest_port);
+  while (true) {
+    int32_t rx_bytes = recvfrom(sock, buf, (uint16_t)len, dest_addr->ip,
+                                &dest_port);
 
-  return rx_bytes;
+    if (rx_bytes > 0)
+      return rx_bytes;
+
+    if (rx_bytes < 0)
+      return wizchip_err(rx_bytes);
+
+    if (wizchip_wait_sock(sock, WIZCHIP_POLLIN,
+                          wizchip_remaining(start, timeout)) == 0)
+      return (timeout == TIME_IMMEDIATE) ? -WIZCHIP_SOCKETS_ERR_WOULDBLOCK :
+                                           -WIZCHIP_SOCKETS_ERR_TIMEOUT;
+  }
 }
 
+/*
+ * The timeouts are uint32_t milliseconds, zero or TIME_INFINITE wait
+ * forever.
+ */
 int wizchipSetSockopt(int sock, int level, int optname,
                       const void *optval, size_t optlen) {
 
-  (void)sock;
-  (void)level;
-  (void)optname;
-  (void)optval;
-  (void)optlen;
+  uint32_t ms;
+  sysinterval_t timeout;
+
+  if (!wizchip_sock_valid(sock))
+    return -WIZCHIP_SOCKETS_ERR_DESCRIPTOR;
+
+  if (level != WIZCHIP_SOL_SOCKET || optval == NULL || optlen != sizeof(ms))
+    return -WIZCHIP_SOCKETS_ERR_PARAMETER;
+
+  memcpy(&ms, optval, sizeof(ms));
+  timeout = (ms == 0 || ms == (uint32_t)TIME_INFINITE) ? TIME_INFINITE :
+                                                         TIME_MS2I(ms);
+
+  switch (optname) {
+  case WIZCHIP_SO_RCVTIMEO:
+    wiz_socks[sock].rcvtimeo = timeout;
+    break;
+
+  case WIZCHIP_SO_SNDTIMEO:
+    wiz_socks[sock].sndtimeo = timeout;
+    break;
+
+  default:
+    return -WIZCHIP_SOCKETS_ERR_UNSUPPORTED;
+  }
 
   return 0;
 }
 
 int wizchipGetSockopt(int sock, int level, int optname,
-                      const void *optval, size_t optlen) {
+                      void *optval, size_t optlen) {
 
-  (void)sock;
-  (void)level;
-  (void)optname;
-  (void)optval;
-  (void)optlen;
+  uint32_t ms;
+  sysinterval_t timeout;
+
+  if (!wizchip_sock_valid(sock))
+    return -WIZCHIP_SOCKETS_ERR_DESCRIPTOR;
+
+  if (level != WIZCHIP_SOL_SOCKET || optval == NULL || optlen != sizeof(ms))
+    return -WIZCHIP_SOCKETS_ERR_PARAMETER;
+
+  switch (optname) {
+  case WIZCHIP_SO_RCVTIMEO:
+    timeout = wiz_socks[sock].rcvtimeo;
+    break;
+
+  case WIZCHIP_SO_SNDTIMEO:
+    timeout = wiz_socks[sock].sndtimeo;
+    break;
+
+  default:
+    return -WIZCHIP_SOCKETS_ERR_UNSUPPORTED;
+  }
+
+  ms = (timeout == TIME_INFINITE) ? 0 : (uint32_t)TIME_I2MS(timeout);
+  memcpy(optval, &ms, sizeof(ms));
 
   return 0;
 }
+
+
+/**
+ * @brief   Waits for events on a set of sockets.
+ * @details The calling thread sleeps until one of the sockets is ready,
+ *          WIZCHIP_POLLHUP is reported whatever the requested events.
+ *
+ * @param[in,out] fds   array of sockets and requested events, the ready
+ *                      events are returned in @p revents
+ * @param[in] nfds      number of entries of @p fds
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      TIME_IMMEDIATE and TIME_INFINITE are allowed
+ * @return              The number of ready sockets, zero on timeout or a
+ *                      negated WIZCHIP_SOCKETS_ERR_* code.
+ * @api
+ */
+int wizchipSelect(wizchip_pollfd_t *fds, size_t nfds, sysinterval_t timeout) {
+
+  osalDbgCheck(fds != NULL || nfds == 0);
+
+  for (size_t i = 0; i < nfds; i++) {
+    if (!wizchip_sock_valid(fds[i].sock))
+      return -WIZCHIP_SOCKETS_ERR_DESCRIPTOR;
+  }
+
+  return wizchip_wait(fds, nfds, timeout);
+}
+
+
+/**
+ * @brief   Returns the socket events source.
+ * @details The source is broadcast with the flag (1 << socket) on each
+ *          interrupt of a socket and when a socket is closed.
+ * @api
+ */
+event_source_t *wizchipGetEventSource(void) {
+
+  return &wiz_es;
+}
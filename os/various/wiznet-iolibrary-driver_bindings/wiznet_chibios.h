@@ -72,6 +72,12 @@ typedef enum {
 #define WIZCHIP_SOL_SOCKET               0
 
 #define WIZCHIP_SO_RCVTIMEO              0
+#define WIZCHIP_SO_SNDTIMEO              1
+
+/* Socket readiness events, see wizchipSelect(). */
+#define WIZCHIP_POLLIN                   (1<<0)
+#define WIZCHIP_POLLOUT                  (1<<1)
+#define WIZCHIP_POLLHUP                  (1<<2)
 
 enum {
   WIZCHIP_SOCKETS_ERR_OK = 0,
@@ -120,6 +126,33 @@ enum {
 #define WIZCHIP_MAX_SOCKET_TX_DATA_SIZE_KB 2u
 #endif
 
+/* Readiness polling period of waiting threads when the INTn line is not
+   used. */
+#ifndef WIZCHIP_POLL_INTERVAL_MS
+#define WIZCHIP_POLL_INTERVAL_MS 10u
+#endif
+
+/* Readiness polling period of waiting threads when the INTn line is used,
+   it only guards against lost interrupts. */
+#ifndef WIZCHIP_IRQ_GUARD_INTERVAL_MS
+#define WIZCHIP_IRQ_GUARD_INTERVAL_MS 500u
+#endif
+
+/* Thread reading the socket interrupt registers on INTn. */
+#ifndef WIZCHIP_IRQ_THREAD_PRIO
+#define WIZCHIP_IRQ_THREAD_PRIO (NORMALPRIO + 1)
+#endif
+
+#ifndef WIZCHIP_IRQ_THREAD_WA_SIZE
+#define WIZCHIP_IRQ_THREAD_WA_SIZE 512u
+#endif
+
+/* Event used by the threads waiting on sockets, must not be used by them
+   for anything else. */
+#ifndef WIZCHIP_EVENT_ID
+#define WIZCHIP_EVENT_ID 30
+#endif
+
 #if HAL_USE_SPI == FALSE
 #error "ETH driver requires HAL_USE_SPI"
 #endif
@@ -177,6 +210,7 @@ typedef struct {
   uint16_t reset_tpl_delay_ms;
 
 #if ETH_USE_CALLBACKS == TRUE
+  /* INTn line, PAL_NOLINE if not connected. */
   ioline_t irq_line;
 #endif
 } WIZCHIP_ETHSPIConfig;
@@ -209,6 +243,17 @@ typedef struct {
   const uint8_t *mac_address;
 } WIZCHIP_MACConfig;
 
+/**
+ * @brief   Entry of the wizchipSelect() sockets array.
+ */
+typedef struct {
+  int sock;
+
+  uint8_t events;
+
+  uint8_t revents;
+} wizchip_pollfd_t;
+
 typedef struct {
   const WIZCHIP_MACConfig *config;
 
@@ -283,7 +328,11 @@ int wizchipSetSockopt(int sock, int level, int optname,
                       const void *optval, size_t optlen);
 
 int wizchipGetSockopt(int sock, int level, int optname,
-                      const void *optval, size_t optlen);
+                      void *optval, size_t optlen);
+
+int wizchipSelect(wizchip_pollfd_t *fds, size_t nfds, sysinterval_t timeout);
+
+event_source_t *wizchipGetEventSource(void);
 
 #ifdef __cplusplus
 }
@@ -22,6 +22,10 @@
  */
 #define NRF5_UART_USE_UART0               TRUE
 #define NRF5_UART_UART0_IRQ_PRIORITY      3
+#define NRF5_UART_USE_RX_STREAM           FALSE
+#define NRF5_UART_RX_STREAM_BUFSIZE       255
+#define NRF5_UART_RX_STREAM_PPI_COUNT     18
+#define NRF5_UART_RX_STREAM_PPI_IDLE      19
 #define NRF5_ST_USE_RTC0                  TRUE
 #define NRF5_ST_USE_RTC1                  FALSE
 #define NRF5_ST_USE_TIMER0                FALSE
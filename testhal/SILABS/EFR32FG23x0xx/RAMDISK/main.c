@@ -0,0 +1,180 @@
+/*
+    ChibiOS - Copyright (C) 2024 Xael South
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <string.h>
+#include "cmsis_os.h"
+#include "hal.h"
+#include "ramdisk.h"
+
+#define RAMDISK_BLOCK_SIZE      512U
+#define RAMDISK_BLOCKS          32U
+#define BENCH_ITERATIONS        64U
+
+static void led_on(void)
+{
+
+  /* PB2 = LED */
+  palSetPadMode(GPIOB, 2, PAL_MODE_OUTPUT_PUSHPULL);
+  palSetPad(GPIOB, 2);
+}
+
+static void led_off(void)
+{
+
+  /* PB2 = LED */
+  palSetPadMode(GPIOB, 2, PAL_MODE_OUTPUT_PUSHPULL);
+  palClearPad(GPIOB, 2);
+}
+
+static uint8_t ramdisk_storage[RAMDISK_BLOCK_SIZE * RAMDISK_BLOCKS] __attribute__((aligned(4)));
+static uint8_t ramdisk_buffer[RAMDISK_BLOCK_SIZE * 8U] __attribute__((aligned(4)));
+static RamDisk ramdisk;
+
+/* Bandwidth in KiB/s, to be inspected with the debugger. */
+typedef struct
+{
+  uint32_t blocks;
+  uint32_t cpu_read;
+  uint32_t cpu_write;
+  uint32_t dma_read;
+  uint32_t dma_write;
+} bench_result_t;
+
+static bench_result_t bench_results[4];
+
+static uint32_t bench_run(bool write, uint32_t blocks)
+{
+
+  systime_t start = osalOsGetSystemTimeX();
+
+  for (unsigned i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    uint32_t startblk = (i * blocks) % (RAMDISK_BLOCKS - blocks + 1U);
+    bool result;
+
+    if (write)
+    {
+      result = blkWrite(&ramdisk, startblk, ramdisk_buffer, blocks);
+    }
+    else
+    {
+      result = blkRead(&ramdisk, startblk, ramdisk_buffer, blocks);
+    }
+    osalDbgCheck(result == HAL_SUCCESS);
+    (void)result;
+  }
+
+  sysinterval_t elapsed = osalTimeDiffX(start, osalOsGetSystemTimeX());
+  if (elapsed == 0)
+  {
+    elapsed = 1;
+  }
+
+  uint64_t bytes = (uint64_t)BENCH_ITERATIONS * blocks * RAMDISK_BLOCK_SIZE;
+  return (uint32_t)((bytes * OSAL_ST_FREQUENCY) / ((uint64_t)elapsed * 1024U));
+}
+
+static void test_ramdisk_check_data_transfer(DMAChannel *dchp)
+{
+  bool result;
+  int cmp;
+
+  /* Check data transfer through the DMA channel. */
+  ramdiskSetDMA(&ramdisk, dchp);
+
+  for (size_t i = 0; i < sizeof(ramdisk_buffer); i++)
+  {
+    ramdisk_buffer[i] = (uint8_t)(i * 7U);
+  }
+  result = blkWrite(&ramdisk, 3, ramdisk_buffer, 8);
+  osalDbgCheck(result == HAL_SUCCESS);
+  cmp = memcmp(&ramdisk_storage[3 * RAMDISK_BLOCK_SIZE], ramdisk_buffer, sizeof(ramdisk_buffer));
+  osalDbgCheck(cmp == 0);
+
+  memset(ramdisk_buffer, 0, sizeof(ramdisk_buffer));
+  result = blkRead(&ramdisk, 3, ramdisk_buffer, 8);
+  osalDbgCheck(result == HAL_SUCCESS);
+  cmp = memcmp(&ramdisk_storage[3 * RAMDISK_BLOCK_SIZE], ramdisk_buffer, sizeof(ramdisk_buffer));
+  osalDbgCheck(cmp == 0);
+
+  (void)result;
+  (void)cmp;
+}
+
+static void test_ramdisk_bandwidth(DMAChannel *dchp)
+{
+
+  /* Compare memcpy and DMA copies for several transfer sizes. */
+  static const uint32_t sizes[4] = { 1, 2, 4, 8 };
+
+  for (unsigned i = 0; i < 4; i++)
+  {
+    bench_results[i].blocks = sizes[i];
+
+    ramdiskSetDMA(&ramdisk, NULL);
+    bench_results[i].cpu_read = bench_run(false, sizes[i]);
+    bench_results[i].cpu_write = bench_run(true, sizes[i]);
+
+    ramdiskSetDMA(&ramdisk, dchp);
+    bench_results[i].dma_read = bench_run(false, sizes[i]);
+    bench_results[i].dma_write = bench_run(true, sizes[i]);
+  }
+
+  ramdiskSetDMA(&ramdisk, NULL);
+}
+
+/*
+ * Application entry point.
+ */
+int main(void)
+{
+
+  /* HAL initialization, this also initializes the configured device drivers
+     and performs the board-specific initializations.*/
+  halInit();
+
+  /* The kernel is initialized but not started yet, this means that
+     main() is executing with absolute priority but interrupts are
+     already enabled.*/
+  osKernelInitialize();
+
+  /* Kernel started, the main() thread has priority osPriorityNormal
+     by default.*/
+  osKernelStart();
+
+  ramdiskObjectInit(&ramdisk);
+  ramdiskStart(&ramdisk, ramdisk_storage, RAMDISK_BLOCK_SIZE, RAMDISK_BLOCKS, false);
+
+  DMAChannel *dchp = dmachAlloc(DMACH_ID_ANY, 0, NULL, NULL);
+  osalDbgCheck(dchp != NULL);
+
+  led_off();
+  test_ramdisk_check_data_transfer(dchp);
+  test_ramdisk_bandwidth(dchp);
+  led_on();
+
+  ramdiskStop(&ramdisk);
+  dmachFree(dchp);
+
+  /*
+   * Normal main() thread activity, in this demo it does nothing except
+   * sleeping in a loop.
+   */
+  while (true)
+  {
+    osDelay(1000);
+  }
+}
@@ -192,6 +192,7 @@
 #define HAL_USBH_PORT_RESET_TIMEOUT                   500
 #define HAL_USBH_DEVICE_ADDRESS_STABILIZATION         20
 #define HAL_USBH_CONTROL_REQUEST_DEFAULT_TIMEOUT	  OSAL_MS2I(1000)
+#define HAL_USBH_USE_SERVICE_THREAD                   FALSE
 
 /* MSD */
 #define HAL_USBH_USE_MSD                              TRUE
@@ -239,6 +240,14 @@
 #define HAL_USBHHID_MAX_INSTANCES                     2
 #define HAL_USBHHID_USE_INTERRUPT_OUT                 FALSE
 
+/* CDC-ACM */
+#define HAL_USBH_USE_CDC_ACM                          TRUE
+#define HAL_USBHCDCACM_MAX_INSTANCES                  1
+
+/* CDC-NCM */
+#define HAL_USBH_USE_CDC_NCM                          TRUE
+#define HAL_USBHCDCNCM_MAX_INSTANCES                  1
+
 /* HUB */
 #define HAL_USBH_USE_HUB                              TRUE
 
@@ -253,6 +262,8 @@
 #define USBH_DEBUG_SINGLE_HOST_SELECTION			  USBHD1
 #define USBH_DEBUG_BUFFER                             25000
 #define USBH_DEBUG_OUTPUT_CALLBACK                    usbh_debug_output
+#define USBH_DEBUG_BINARY                             FALSE
+#define USBH_DEBUG_BINARY_RAW                         FALSE
 
 #define USBH_DEBUG_ENABLE_TRACE                       FALSE
 #define USBH_DEBUG_ENABLE_INFO                        TRUE
@@ -294,6 +305,16 @@
 #define USBHHID_DEBUG_ENABLE_WARNINGS                 TRUE
 #define USBHHID_DEBUG_ENABLE_ERRORS                   TRUE
 
+#define USBHCDCACM_DEBUG_ENABLE_TRACE                 FALSE
+#define USBHCDCACM_DEBUG_ENABLE_INFO                  TRUE
+#define USBHCDCACM_DEBUG_ENABLE_WARNINGS              TRUE
+#define USBHCDCACM_DEBUG_ENABLE_ERRORS                TRUE
+
+#define USBHCDCNCM_DEBUG_ENABLE_TRACE                 FALSE
+#define USBHCDCNCM_DEBUG_ENABLE_INFO                  TRUE
+#define USBHCDCNCM_DEBUG_ENABLE_WARNINGS              TRUE
+#define USBHCDCNCM_DEBUG_ENABLE_ERRORS                TRUE
+
 #endif /* HALCONF_COMMUNITY_H */
 
 /** @} */
@@ -71,8 +71,13 @@ static const usbh_classdriver_vmt_t class_driver_vmt = {
 	_unload
 };
 
+static const usbh_classdriver_match_t class_driver_matches[] = {
+	USBH_MATCH(-1, 0xABCD, 0x0123, -1, -1, -1),
+};
+
 const usbh_classdriverinfo_t usbhCustomClassDriverInfo = {
-	"CUSTOM", &class_driver_vmt
+	"CUSTOM", &class_driver_vmt,
+	class_driver_matches, sizeof_array(class_driver_matches)
 };
 
 static usbh_baseclassdriver_t *_load(usbh_device_t *dev, const uint8_t *descriptor, uint16_t rem) {
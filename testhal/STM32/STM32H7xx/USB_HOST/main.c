@@ -24,7 +24,7 @@
 #define UVC_TO_MSD_PHOTOS_CAPTURE	FALSE
 
 
-#if HAL_USBH_USE_FTDI || HAL_USBH_USE_AOA
+#if HAL_USBH_USE_FTDI || HAL_USBH_USE_AOA || HAL_USBH_USE_CDC_ACM || HAL_USBH_USE_CDC_NCM
 static uint8_t buf[] =
     "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
     "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
@@ -184,7 +184,7 @@ start:
                 }
             }
             et = chVTGetSystemTimeX();
-            _usbh_dbgf(host, "\tRate=%uB/s", (config.speed * 100) / (et - st));
+            _usbh_dbgf(host, "\tRate=%uB/s", (config.speed * 100) / TIME_I2MS(et - st));
         }
     }
 
@@ -276,7 +276,7 @@ start:
                 }
             }
             et = chVTGetSystemTimeX();
-            _usbh_dbgf(host, "\tRate=%uB/s", AOA_WRITE_SPEED_TEST_BYTES / (et - st) * 100);
+            _usbh_dbgf(host, "\tRate=%uB/s", AOA_WRITE_SPEED_TEST_BYTES * 1000 / TIME_I2MS(et - st));
         }
     }
 
@@ -300,6 +300,157 @@ start:
 }
 #endif
 
+#if HAL_USBH_USE_CDC_ACM
+#include "usbh/dev/cdc_acm.h"
+
+static THD_WORKING_AREA(waTestCDCACM, 1024);
+static uint8_t acm_rxbuf[1024];
+
+/* expects a device that echoes back what it receives */
+static void ThreadTestCDCACM(void *p) {
+    (void)p;
+    USBHCDCACMDriver *const acmp = &USBHCDCACMD[0];
+    USBHCDCACMChannel *const acmcp = &acmp->channel;
+    USBHDriver *host = NULL;
+    (void)host;
+
+    chRegSetThreadName("CDC-ACM");
+
+start:
+    while (usbhcdcacmGetState(acmp) != USBHCDCACM_STATE_ACTIVE) {
+        chThdSleepMilliseconds(100);
+    }
+
+    host = usbhcdcacmGetHost(acmp);
+    _usbh_dbg(host, "CDC-ACM: Connected");
+
+    usbhcdcacmStart(acmp, NULL);
+
+#define CDCACM_LOOPBACK_TEST_BYTES    1000000UL
+    //loopback throughput test
+    if (1) {
+        systime_t st, et;
+        int i;
+        for (i = 0; i < 5; i++) {
+            uint32_t times = CDCACM_LOOPBACK_TEST_BYTES / sizeof(acm_rxbuf);
+            st = chVTGetSystemTimeX();
+            while (times--) {
+                if (streamWrite(acmcp, buf, sizeof(acm_rxbuf)) < sizeof(acm_rxbuf)) {
+                    _usbh_dbg(host, "CDC-ACM: Disconnected");
+                    goto start;
+                }
+                if (chnReadTimeout(acmcp, acm_rxbuf, sizeof(acm_rxbuf), TIME_MS2I(1000)) < sizeof(acm_rxbuf)) {
+                    _usbh_dbg(host, "CDC-ACM: Short read");
+                    goto stop;
+                }
+                if (memcmp(acm_rxbuf, buf, sizeof(acm_rxbuf))) {
+                    _usbh_dbg(host, "CDC-ACM: Data mismatch");
+                    goto stop;
+                }
+            }
+            et = chVTGetSystemTimeX();
+            _usbh_dbgf(host, "\tRate=%uB/s", CDCACM_LOOPBACK_TEST_BYTES * 1000 / TIME_I2MS(et - st));
+        }
+    }
+
+stop:
+    usbhcdcacmStop(acmp);
+
+    _usbh_dbg(host, "CDC-ACM: Tests done, restarting in 3s");
+    chThdSleepMilliseconds(3000);
+
+    goto start;
+}
+#endif
+
+#if HAL_USBH_USE_CDC_NCM
+#include "usbh/dev/cdc_ncm.h"
+
+static THD_WORKING_AREA(waTestCDCNCM, 1024);
+
+/* expects a device that echoes back the frames it receives */
+static bool _ncm_loopback(USBHDriver *host, USBHCDCNCMDriver *ncmp,
+        size_t len, uint32_t frames) {
+    systime_t st, et;
+    uint32_t bytes = len * frames;
+
+    st = chVTGetSystemTimeX();
+    while (frames) {
+        /* a burst of frames is packed in the same NTBs */
+        uint32_t i, burst = frames < 8 ? frames : 8;
+        for (i = 0; i < burst; i++) {
+            usbhcdcncm_tx_descriptor_t td;
+            if (usbhcdcncmWaitTransmitDescriptor(ncmp, &td, len, TIME_MS2I(1000)) != MSG_OK) {
+                _usbh_dbg(host, "CDC-NCM: TX failed");
+                return false;
+            }
+            memset(td.buf, 0xff, 6);
+            memcpy(td.buf + 6, buf, len - 6 < sizeof(buf) - 1 ? len - 6 : sizeof(buf) - 1);
+            td.buf[12] = (uint8_t)i;
+            usbhcdcncmReleaseTransmitDescriptor(ncmp, &td, len);
+        }
+        for (i = 0; i < burst; i++) {
+            usbhcdcncm_rx_descriptor_t rd;
+            if (usbhcdcncmWaitReceiveDescriptor(ncmp, &rd, TIME_MS2I(1000)) != MSG_OK) {
+                _usbh_dbg(host, "CDC-NCM: RX failed");
+                return false;
+            }
+            bool ok = (rd.size == len) && (rd.buf[12] == (uint8_t)i);
+            usbhcdcncmReleaseReceiveDescriptor(ncmp, &rd);
+            if (!ok) {
+                _usbh_dbg(host, "CDC-NCM: Frame mismatch");
+                return false;
+            }
+        }
+        frames -= burst;
+    }
+    et = chVTGetSystemTimeX();
+    _usbh_dbgf(host, "\tlen=%u, Rate=%uB/s", len, bytes * 1000 / TIME_I2MS(et - st));
+    return true;
+}
+
+static void ThreadTestCDCNCM(void *p) {
+    (void)p;
+    USBHCDCNCMDriver *const ncmp = &USBHCDCNCMD[0];
+    USBHDriver *host = NULL;
+    (void)host;
+
+    chRegSetThreadName("CDC-NCM");
+
+start:
+    while (usbhcdcncmGetState(ncmp) != USBHCDCNCM_STATE_ACTIVE) {
+        chThdSleepMilliseconds(100);
+    }
+
+    host = usbhcdcncmGetHost(ncmp);
+    _usbh_dbg(host, "CDC-NCM: Connected");
+
+    usbhcdcncmStart(ncmp, NULL);
+    if (usbhcdcncmGetState(ncmp) != USBHCDCNCM_STATE_READY) {
+        _usbh_dbg(host, "CDC-NCM: Start failed");
+        goto done;
+    }
+
+    //loopback throughput test, full size and minimum size frames
+    if (1) {
+        int i;
+        for (i = 0; i < 5; i++) {
+            if (!_ncm_loopback(host, ncmp, 1514, 1000)
+                    || !_ncm_loopback(host, ncmp, 64, 5000))
+                break;
+        }
+    }
+
+    usbhcdcncmStop(ncmp);
+
+done:
+    _usbh_dbg(host, "CDC-NCM: Tests done, restarting in 3s");
+    chThdSleepMilliseconds(3000);
+
+    goto start;
+}
+#endif
+
 #if HAL_USBH_USE_MSD
 #include "usbh/dev/msd.h"
 #include "ff.h"
@@ -888,6 +1039,26 @@ free_data:
 }
 #endif
 
+/* Re-enumeration benchmark: re-plug the device (or power cycle its hub port)
+ * repeatedly, the time from the status change to the drivers loaded and the
+ * statistics of the configuration phase are printed after each enumeration */
+static void _print_enum_stats(USBHDriver *usbh, uint32_t *count) {
+    usbh_enum_stats_t stats;
+
+    usbhGetEnumerationStats(usbh, &stats);
+    if (stats.count == *count)
+        return;
+    *count = stats.count;
+
+    _usbh_dbgf(usbh, "Enumeration #%u: attach %ums, configuration %ums (min %u, avg %u, max %u)",
+            stats.count,
+            (uint32_t)TIME_I2MS(usbhGetAttachLatency(usbh)),
+            (uint32_t)TIME_I2MS(stats.last),
+            (uint32_t)TIME_I2MS(stats.min),
+            (uint32_t)TIME_I2MS(stats.total / stats.count),
+            (uint32_t)TIME_I2MS(stats.max));
+}
+
 #if USBH_DEBUG_MULTI_HOST
 void USBH_DEBUG_OUTPUT_CALLBACK(USBHDriver *host, const uint8_t *buff, size_t len) {
 	(void)host;
@@ -932,6 +1103,14 @@ int main(void) {
     chThdCreateStatic(waTestAOA, sizeof(waTestAOA), NORMALPRIO, ThreadTestAOA, 0);
 #endif
 
+#if HAL_USBH_USE_CDC_ACM
+    chThdCreateStatic(waTestCDCACM, sizeof(waTestCDCACM), NORMALPRIO, ThreadTestCDCACM, 0);
+#endif
+
+#if HAL_USBH_USE_CDC_NCM
+    chThdCreateStatic(waTestCDCNCM, sizeof(waTestCDCNCM), NORMALPRIO, ThreadTestCDCNCM, 0);
+#endif
+
 #if HAL_USBH_USE_HID
     chThdCreateStatic(waTestHID, sizeof(waTestHID), NORMALPRIO, ThreadTestHID, 0);
 #endif
@@ -954,12 +1133,21 @@ int main(void) {
     _usbh_dbgf(&USBHD2, "Started");
 #endif
 
+#if STM32_USBH_USE_OTG1
+    uint32_t enum_count1 = 0;
+#endif
+#if STM32_USBH_USE_OTG2
+    uint32_t enum_count2 = 0;
+#endif
+
     for(;;) {
 #if STM32_USBH_USE_OTG1
         usbhMainLoop(&USBHD1);
+        _print_enum_stats(&USBHD1, &enum_count1);
 #endif
 #if STM32_USBH_USE_OTG2
         usbhMainLoop(&USBHD2);
+        _print_enum_stats(&USBHD2, &enum_count2);
 #endif
         chThdSleepMilliseconds(100);
 
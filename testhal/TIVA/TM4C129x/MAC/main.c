@@ -0,0 +1,167 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "chprintf.h"
+
+/*
+ * Broadcast frames of the maximum size are sent with the local experimental
+ * EtherType, the link partner is expected to drop them.
+ */
+#define BENCH_FRAMES            2048U
+#define BENCH_HEADER_SIZE       14U
+#define BENCH_PAYLOAD_SIZE      1500U
+#define BENCH_FRAME_SIZE        (BENCH_HEADER_SIZE + BENCH_PAYLOAD_SIZE)
+
+static uint8_t macaddr[6] = {0xC2, 0xAF, 0x51, 0x03, 0xCF, 0x46};
+
+static uint8_t header[BENCH_HEADER_SIZE];
+static uint8_t payload[BENCH_PAYLOAD_SIZE] __attribute__((aligned(4)));
+
+static volatile uint32_t released;
+
+typedef struct {
+  uint32_t      frames;
+  uint32_t      ms;
+  uint32_t      kibps;
+  uint32_t      cycles;
+  uint32_t      copied;
+} bench_result_t;
+
+/*
+ * Attached buffers release callback, the payload is static so the buffers
+ * are only counted.
+ */
+static void txrelease(MACDriver *macp, void *ref) {
+
+  (void)macp;
+  (void)ref;
+  released++;
+}
+
+static const MACConfig maccfg = {
+  macaddr,
+  txrelease
+};
+
+/*
+ * Sends BENCH_FRAMES frames, the header is always written in the
+ * descriptor's stream while the payload is either copied after it or
+ * attached to the next descriptor. Only the driver calls are counted in
+ * the cycles figure, the waits for a free descriptor are not.
+ */
+static void bench_run(bench_result_t *rp, bool attach) {
+  MACTransmitDescriptor td;
+  uint64_t cycles = 0;
+  systime_t start;
+  uint32_t n;
+
+  memset(rp, 0, sizeof(*rp));
+
+  start = chVTGetSystemTimeX();
+  for (n = 0; n < BENCH_FRAMES; n++) {
+    rtcnt_t t0;
+
+    if (macWaitTransmitDescriptor(&ETHD1, &td, TIME_MS2I(100)) != MSG_OK)
+      break;
+
+    t0 = chSysGetRealtimeCounterX();
+    macWriteTransmitDescriptor(&td, header, sizeof(header));
+    if (attach) {
+      if (!mac_lld_attach_transmit_buffer(&td, payload, sizeof(payload),
+                                          payload))
+        rp->copied++;
+    }
+    else {
+      macWriteTransmitDescriptor(&td, payload, sizeof(payload));
+    }
+    macReleaseTransmitDescriptor(&td);
+    cycles += chSysGetRealtimeCounterX() - t0;
+  }
+
+  rp->frames = n;
+  rp->ms     = TIME_I2MS(chVTTimeElapsedSinceX(start));
+  if (rp->ms == 0)
+    rp->ms = 1;
+  rp->kibps  = (uint32_t)(((uint64_t)n * BENCH_FRAME_SIZE * 1000U) /
+                          ((uint64_t)rp->ms * 1024U));
+  if (n > 0)
+    rp->cycles = (uint32_t)(cycles / n);
+}
+
+static void bench_print(BaseSequentialStream *chp, const char *name,
+                        const bench_result_t *rp) {
+
+  chprintf(chp, "%-8s %5u frames %6u ms %6u KiB/s %6u cycles/frame",
+           name, rp->frames, rp->ms, rp->kibps, rp->cycles);
+  if (rp->copied > 0)
+    chprintf(chp, " (%u copied)", rp->copied);
+  chprintf(chp, "\r\n");
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+  BaseSequentialStream *chp = (BaseSequentialStream *)&SD1;
+  bench_result_t copy, attached;
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  sdStart(&SD1, NULL);
+  macStart(&ETHD1, &maccfg);
+
+  memset(header, 0xFF, 6);
+  memcpy(&header[6], macaddr, 6);
+  header[12] = 0x88;
+  header[13] = 0xB5;
+  for (i = 0; i < sizeof(payload); i++)
+    payload[i] = (uint8_t)i;
+
+  chprintf(chp, "TIVA MAC transmit, %u bytes frames, %u MHz\r\n",
+           BENCH_FRAME_SIZE, TIVA_SYSCLK / 1000000U);
+
+  /*
+   * Normal main() thread activity, the two transmit paths are compared
+   * every few seconds while the link is up.
+   */
+  while (true) {
+    if (!macPollLinkStatus(&ETHD1)) {
+      chThdSleepMilliseconds(500);
+      continue;
+    }
+
+    bench_run(&copy, false);
+    bench_run(&attached, true);
+    bench_print(chp, "copy", &copy);
+    bench_print(chp, "attached", &attached);
+    chprintf(chp, "released %u\r\n\r\n", released);
+
+    chThdSleepMilliseconds(5000);
+  }
+}
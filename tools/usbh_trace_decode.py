@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Decoder for the raw USBH binary trace (USBH_DEBUG_BINARY and
+USBH_DEBUG_BINARY_RAW set to TRUE in halconf_community.h).
+
+The firmware only sends the address of the format string and the raw
+arguments of each debug message, the strings are looked up in the ELF file
+of the firmware and the messages are printed the same way the debug thread
+prints them in text mode.
+
+usage: usbh_trace_decode.py firmware.elf [trace.bin]
+
+The trace is read from stdin when no file is given, e.g.
+    stty -F /dev/ttyUSB0 raw 115200 && usbh_trace_decode.py ch.elf < /dev/ttyUSB0
+"""
+
+from argparse import ArgumentParser
+import re
+import struct
+import sys
+
+
+RAW_MAGIC = 0xa5
+RAW_FLAG_PUTS = 1 << 0
+RAW_FLAG_TEXT = 1 << 1
+RAW_FLAG_LOST = 1 << 7
+RAW_HEADER = struct.Struct('<BBBBIIIHH')
+RAW_MAX_LEN = 32
+
+
+class ElfImage(object):
+    """Allocated sections of a little endian ELF32 file."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+        if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+            raise ValueError('%s: not a little endian ELF32 file' % path)
+        shoff, = struct.unpack_from('<I', data, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', data, 0x2e)
+        self.sections = []
+        for i in range(shnum):
+            (_, sh_type, flags, addr, offset,
+             size) = struct.unpack_from('<IIIIII', data, shoff + i * shentsize)
+            # SHF_ALLOC sections with contents (not SHT_NOBITS)
+            if (flags & 0x2) and sh_type != 8 and size:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def string(self, addr):
+        for base, data in self.sections:
+            if base <= addr < base + len(data):
+                end = data.find(b'\0', addr - base)
+                if end < 0:
+                    end = len(data)
+                return data[addr - base:end].decode('latin-1')
+        return '<0x%08X?>' % addr
+
+
+# conversions understood by chprintf; the upper case integer ones are the
+# long variants, the same size on the 32-bit targets
+CONVERSION = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?[lh]*([a-zA-Z%])')
+
+
+def format_message(fmt, args, image):
+    args = list(args)
+
+    def next_arg():
+        return args.pop(0) if args else 0
+
+    def convert(m):
+        flags, width, precision, conv = m.groups()
+        if conv == '%':
+            return '%'
+        if width == '*':
+            width = str(next_arg())
+        if precision == '*':
+            precision = str(next_arg())
+        spec = '%' + flags + (width or '') + ('.' + precision if precision else '')
+        value = next_arg()
+        lower = conv.lower()
+        if lower in ('d', 'i'):
+            return (spec + 'd') % struct.unpack('<i', struct.pack('<I', value))[0]
+        if lower == 'u':
+            return (spec + 'd') % value
+        if lower == 'x':
+            return (spec + 'X') % value
+        if lower == 'o':
+            return (spec + 'o') % value
+        if lower == 'p':
+            return (spec + 's') % ('0x%08X' % value)
+        if lower == 'c':
+            return (spec + 'c') % chr(value & 0xff)
+        if lower == 's':
+            return (spec + 's') % (image.string(value) if value else '(null)')
+        return m.group(0)
+
+    return CONVERSION.sub(convert, fmt)
+
+
+class Decoder(object):
+
+    def __init__(self, image, out):
+        self.image = image
+        self.out = out
+        self.buff = b''
+        self.first = 0
+        self.ena = False
+
+    def prefix(self, time, hfnum, hfir):
+        # same as the debug thread in text mode
+        last = time
+        if self.ena:
+            self.first = last
+        if (hfnum & 0x3fff) == 0x3fff and hfir == (hfnum >> 16):
+            self.ena = False
+            return '+%08d ' % ((last - self.first) & 0xffffffff)
+        self.ena = True
+        f = hfnum & 0xffff
+        p = 1000 - ((hfnum >> 16) // (hfir // 1000)) if hfir >= 1000 else 0
+        return '%05d.%03d ' % (f, p)
+
+    def record(self, flags, fmt, time, hfnum, hfir, payload):
+        if flags & RAW_FLAG_LOST:
+            return '--- %u trace entries lost ---' % fmt
+        prefix = self.prefix(time, hfnum, hfir)
+        s = self.image.string(fmt)
+        if flags & RAW_FLAG_PUTS:
+            return prefix + s
+        if flags & RAW_FLAG_TEXT:
+            text = payload.decode('latin-1')
+            return prefix + re.sub(r'%([-+ #0]*\d*(?:\.\d+)?)s',
+                                   lambda m: ('%' + m.group(1) + 's') % text, s, count=1)
+        args = struct.unpack('<%dI' % (len(payload) // 4), payload)
+        return prefix + format_message(s, args, self.image)
+
+    def feed(self, data):
+        self.buff += data
+        while True:
+            start = self.buff.find(bytes([RAW_MAGIC]))
+            if start < 0:
+                self.buff = b''
+                return
+            self.buff = self.buff[start:]
+            if len(self.buff) < RAW_HEADER.size:
+                return
+            (_, flags, length, reserved, fmt, time, hfnum, hfir,
+             reserved2) = RAW_HEADER.unpack_from(self.buff)
+            if (reserved or reserved2 or length > RAW_MAX_LEN or
+                    flags not in (0, RAW_FLAG_PUTS, RAW_FLAG_TEXT, RAW_FLAG_LOST)):
+                # not a record, the output callback may add bytes between them
+                self.buff = self.buff[1:]
+                continue
+            end = RAW_HEADER.size + length
+            if len(self.buff) < end:
+                return
+            payload = self.buff[RAW_HEADER.size:end]
+            self.buff = self.buff[end:]
+            self.out.write(self.record(flags, fmt, time, hfnum, hfir, payload) + '\n')
+            self.out.flush()
+
+
+def main():
+    parser = ArgumentParser(description='USBH binary trace decoder')
+    parser.add_argument('elf', help='ELF file of the firmware')
+    parser.add_argument('trace', nargs='?', help='raw trace, stdin if omitted')
+    args = parser.parse_args()
+
+    decoder = Decoder(ElfImage(args.elf), sys.stdout)
+    src = open(args.trace, 'rb') if args.trace else sys.stdin.buffer
+    try:
+        while True:
+            data = src.read1(4096) if hasattr(src, 'read1') else src.read(4096)
+            if not data:
+                break
+            decoder.feed(data)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if args.trace:
+            src.close()
+
+
+if __name__ == '__main__':
+    main()